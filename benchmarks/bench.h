@@ -0,0 +1,171 @@
+/*
+ * CAUCHY - Benchmark Harness
+ *
+ * Operations are timed in rounds: a round runs a fixed number of
+ * operations between two clock reads, and its average becomes one latency
+ * sample. Rounds keep clock overhead out of nanosecond-scale operations
+ * while still giving a distribution; benchmarks of costly operations
+ * (merges) use rounds of one. Each result prints one line for people
+ * and, with --json, appends one JSON object per line for tooling:
+ *
+ *   {"bench":"gset_add","size":1000,"threads":1,"ops":...,"ops_per_sec":...,
+ *    "p50_ns":...,"p90_ns":...,"p99_ns":...,"max_ns":...,"contention":...}
+ *
+ * Options: --json PATH, --max-size N (largest size swept, default 1e6),
+ * --filter TEXT (run only the benchmark groups whose name contains it).
+ */
+
+#ifndef CAUCHY_BENCH_H
+#define CAUCHY_BENCH_H
+
+#include "cauchy/cauchy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Sizes swept by the per-size benchmarks, capped by --max-size */
+static const u64 bench_sizes[] = { 100, 1000, 10000, 100000, 1000000, 10000000 };
+#define BENCH_SIZE_COUNT (sizeof(bench_sizes) / sizeof(bench_sizes[0]))
+
+/* Benchmarks run with NDEBUG, so checks must not rely on assert */
+#define BENCH_CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        exit(1); \
+    } \
+} while (0)
+
+typedef struct bench_config {
+    FILE*       json;
+    u64         max_size;
+    const char* filter;
+} bench_config_t;
+
+static bench_config_t bench_cfg = { NULL, 1000000, NULL };
+
+/* Latency samples (ns per operation) of one result */
+typedef struct bench_samples {
+    double* ns;
+    usize   count;
+    usize   capacity;
+    u64     ops;
+    u64     total_ns;
+} bench_samples_t;
+
+static inline u64 bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + (u64)ts.tv_nsec;
+}
+
+static inline void bench_init(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            bench_cfg.json = fopen(argv[++i], "a");
+            BENCH_CHECK(bench_cfg.json != NULL);
+        } else if (strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            bench_cfg.max_size = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            bench_cfg.filter = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--json PATH] [--max-size N] [--filter TEXT]\n", argv[0]);
+            exit(2);
+        }
+    }
+    BENCH_CHECK(cauchy_init() == CAUCHY_OK);
+    printf("%-32s %10s %4s %12s %10s %10s %10s %10s %10s\n", "benchmark", "size", "thr",
+           "ops/s", "p50 ns", "p90 ns", "p99 ns", "max ns", "contention");
+}
+
+static inline void bench_finish(void) {
+    if (bench_cfg.json) fclose(bench_cfg.json);
+    cauchy_shutdown();
+}
+
+/* Whether a benchmark is selected by --filter */
+static inline bool bench_enabled(const char* name) {
+    return !bench_cfg.filter || strstr(name, bench_cfg.filter) != NULL;
+}
+
+static inline void bench_samples_reset(bench_samples_t* s) {
+    s->count = 0;
+    s->ops = 0;
+    s->total_ns = 0;
+}
+
+static inline void bench_push(bench_samples_t* s, double ns_per_op) {
+    if (s->count == s->capacity) {
+        s->capacity = s->capacity ? s->capacity * 2 : 1024;
+        s->ns = realloc(s->ns, s->capacity * sizeof(double));
+        BENCH_CHECK(s->ns != NULL);
+    }
+    s->ns[s->count++] = ns_per_op;
+}
+
+/* Record one round of ops operations that took ns */
+static inline void bench_sample(bench_samples_t* s, u64 ops, u64 ns) {
+    bench_push(s, ops ? (double)ns / (double)ops : 0.0);
+    s->ops += ops;
+    s->total_ns += ns;
+}
+
+/* Move a per-thread recorder's samples into dst and release it */
+static inline void bench_absorb(bench_samples_t* dst, bench_samples_t* src) {
+    for (usize i = 0; i < src->count; i++) bench_push(dst, src->ns[i]);
+    dst->ops += src->ops;
+    dst->total_ns += src->total_ns;
+    free(src->ns);
+    memset(src, 0, sizeof(*src));
+}
+
+static int bench_cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static inline double bench_percentile(const bench_samples_t* s, double p) {
+    if (s->count == 0) return 0.0;
+    usize idx = (usize)(p * (double)(s->count - 1) + 0.5);
+    return s->ns[idx];
+}
+
+/* Print and record a result. threads is the number of threads whose
+ * operations were counted; total_ns is wall time, so ops_per_sec is the
+ * aggregate rate. contention is a pool CAS-retry count, 0 if unused. */
+static inline void bench_report(const char* name, u64 size, u32 threads,
+                                bench_samples_t* s, u64 contention) {
+    qsort(s->ns, s->count, sizeof(double), bench_cmp_double);
+    double secs = (double)s->total_ns / 1e9;
+    double rate = secs > 0 ? (double)s->ops / secs : 0.0;
+    double p50 = bench_percentile(s, 0.50);
+    double p90 = bench_percentile(s, 0.90);
+    double p99 = bench_percentile(s, 0.99);
+    double max = s->count ? s->ns[s->count - 1] : 0.0;
+
+    printf("%-32s %10llu %4u %12.0f %10.1f %10.1f %10.1f %10.1f %10llu\n", name,
+           (unsigned long long)size, threads, rate, p50, p90, p99, max,
+           (unsigned long long)contention);
+    fflush(stdout);
+    if (bench_cfg.json) {
+        fprintf(bench_cfg.json,
+                "{\"bench\":\"%s\",\"size\":%llu,\"threads\":%u,\"ops\":%llu,"
+                "\"ops_per_sec\":%.1f,\"p50_ns\":%.1f,\"p90_ns\":%.1f,\"p99_ns\":%.1f,"
+                "\"max_ns\":%.1f,\"contention\":%llu}\n",
+                name, (unsigned long long)size, threads, (unsigned long long)s->ops,
+                rate, p50, p90, p99, max, (unsigned long long)contention);
+        fflush(bench_cfg.json);
+    }
+}
+
+/* Deterministic xorshift64* stream for keys and positions */
+static inline u64 bench_rand(u64* state) {
+    u64 x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+
+#endif /* CAUCHY_BENCH_H */
@@ -0,0 +1,342 @@
+/*
+ * CAUCHY - Core Benchmarks
+ *
+ * Memory pool, hazard pointers, vector clocks, causal delivery, op log
+ * group commit and the sharded object store.
+ */
+
+#include "bench.h"
+#include "cauchy/memory.h"
+#include "cauchy/vclock.h"
+#include "cauchy/wal.h"
+#include "cauchy/causal.h"
+#include "cauchy/crdt/store.h"
+#include <pthread.h>
+#include <unistd.h>
+
+#define POOL_ROUND    256      /* Blocks allocated, then freed, per round */
+#define POOL_ROUNDS   2000     /* Rounds per thread */
+#define HAZARD_ROUND  1024
+#define HAZARD_ROUNDS 1000
+#define WAL_COMMITS   500      /* Synced records per thread */
+#define CAUSAL_ROUND  1024     /* Ops received per sample */
+#define CAUSAL_ORIGINS 8
+#define STORE_ROUND   1024     /* Ops submitted, then applied, per round */
+#define STORE_ROUNDS  500
+#define STORE_NAMES   256      /* Counters per shard */
+
+static const u32 thread_counts[] = { 1, 2, 4, 8 };
+
+/* Threads start together so aggregate rates reflect real overlap */
+typedef struct {
+    pthread_barrier_t* start;
+    bench_samples_t    samples;
+    void*              arg;
+} worker_t;
+
+typedef void* (*worker_fn)(void*);
+
+/* Run fn on threads workers and fold their samples into out; wall time
+ * spans the first start to the last finish */
+static void run_threads(u32 threads, worker_fn fn, void* arg, bench_samples_t* out) {
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, threads + 1);
+    pthread_t tids[8];
+    worker_t workers[8];
+    for (u32 i = 0; i < threads; i++) {
+        workers[i] = (worker_t){ &start, { 0 }, arg };
+        pthread_create(&tids[i], NULL, fn, &workers[i]);
+    }
+    pthread_barrier_wait(&start);
+    u64 t0 = bench_now_ns();
+    for (u32 i = 0; i < threads; i++) pthread_join(tids[i], NULL);
+    u64 wall = bench_now_ns() - t0;
+    pthread_barrier_destroy(&start);
+
+    bench_samples_reset(out);
+    for (u32 i = 0; i < threads; i++) bench_absorb(out, &workers[i].samples);
+    out->total_ns = wall;
+}
+
+/* Pool */
+
+static void* pool_worker(void* arg) {
+    worker_t* w = arg;
+    cauchy_pool_t* pool = w->arg;
+    void* blocks[POOL_ROUND];
+    pthread_barrier_wait(w->start);
+    for (int r = 0; r < POOL_ROUNDS; r++) {
+        u64 t0 = bench_now_ns();
+        for (int i = 0; i < POOL_ROUND; i++) blocks[i] = cauchy_pool_alloc(pool);
+        for (int i = 0; i < POOL_ROUND; i++) cauchy_pool_free(pool, blocks[i]);
+        bench_sample(&w->samples, 2 * POOL_ROUND, bench_now_ns() - t0);
+    }
+    return NULL;
+}
+
+static void bench_pool(void) {
+    if (!bench_enabled("pool_alloc_free")) return;
+    bench_samples_t s = { 0 };
+    for (usize t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        cauchy_pool_config_t cfg = CAUCHY_POOL_CONFIG_DEFAULT;
+        cauchy_pool_t* pool = cauchy_pool_create(&cfg);
+        BENCH_CHECK(pool != NULL);
+        run_threads(thread_counts[t], pool_worker, pool, &s);
+        cauchy_pool_stats_t stats = cauchy_pool_get_stats(pool);
+        bench_report("pool_alloc_free", POOL_ROUND, thread_counts[t], &s, stats.contention);
+        cauchy_pool_destroy(pool);
+    }
+    free(s.ns);
+}
+
+/* Hazard pointers */
+
+typedef struct {
+    cauchy_hazard_domain_t* domain;
+    cauchy_atomic_ptr_t     shared;
+} hazard_ctx_t;
+
+static void* hazard_worker(void* arg) {
+    worker_t* w = arg;
+    hazard_ctx_t* ctx = w->arg;
+    pthread_barrier_wait(w->start);
+    for (int r = 0; r < HAZARD_ROUNDS; r++) {
+        u64 t0 = bench_now_ns();
+        for (int i = 0; i < HAZARD_ROUND; i++) {
+            BENCH_CHECK(cauchy_hazard_protect(ctx->domain, 0, &ctx->shared) != NULL);
+            cauchy_hazard_clear(ctx->domain, 0);
+        }
+        bench_sample(&w->samples, HAZARD_ROUND, bench_now_ns() - t0);
+    }
+    return NULL;
+}
+
+static void free_node(void* node, void* ctx) {
+    (void)ctx;
+    free(node);
+}
+
+static void bench_hazard(void) {
+    bench_samples_t s = { 0 };
+    if (bench_enabled("hazard_protect_clear")) {
+        static u64 target = 42;
+        hazard_ctx_t ctx;
+        ctx.domain = cauchy_hazard_domain_create();
+        BENCH_CHECK(ctx.domain != NULL);
+        atomic_init(&ctx.shared, &target);
+        for (usize t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+            run_threads(thread_counts[t], hazard_worker, &ctx, &s);
+            bench_report("hazard_protect_clear", 1, thread_counts[t], &s, 0);
+        }
+        cauchy_hazard_domain_destroy(ctx.domain);
+    }
+
+    /* Retire cost includes the reclaim scans it triggers */
+    if (bench_enabled("hazard_retire_reclaim")) {
+        cauchy_hazard_domain_t* domain = cauchy_hazard_domain_create();
+        BENCH_CHECK(domain != NULL);
+        bench_samples_reset(&s);
+        for (int r = 0; r < HAZARD_ROUNDS; r++) {
+            void* nodes[HAZARD_ROUND];
+            for (int i = 0; i < HAZARD_ROUND; i++) BENCH_CHECK((nodes[i] = malloc(64)) != NULL);
+            u64 t0 = bench_now_ns();
+            for (int i = 0; i < HAZARD_ROUND; i++) cauchy_hazard_retire(domain, nodes[i], free_node, NULL);
+            cauchy_hazard_reclaim(domain);
+            bench_sample(&s, HAZARD_ROUND, bench_now_ns() - t0);
+        }
+        bench_report("hazard_retire_reclaim", HAZARD_ROUND, 1, &s, 0);
+        cauchy_hazard_domain_destroy(domain);
+    }
+    free(s.ns);
+}
+
+/* Vector clocks: n nodes, half of them ahead on each side */
+
+static void bench_vclock(void) {
+    bench_samples_t s = { 0 };
+    u64 rng = 0x5EED;
+    for (usize i = 0; i < BENCH_SIZE_COUNT && bench_sizes[i] <= bench_cfg.max_size; i++) {
+        u64 n = bench_sizes[i];
+        cauchy_vclock_t a, b;
+        cauchy_vclock_init(&a, (u32)(n < UINT32_MAX ? n : UINT32_MAX));
+        cauchy_vclock_init(&b, (u32)(n < UINT32_MAX ? n : UINT32_MAX));
+        for (u64 node = 0; node < n; node++) {
+            u64 v = bench_rand(&rng) % 1000 + 1;
+            BENCH_CHECK(cauchy_vclock_set(&a, node, v + (node & 1)) == CAUCHY_OK);
+            BENCH_CHECK(cauchy_vclock_set(&b, node, v + !(node & 1)) == CAUCHY_OK);
+        }
+        u64 rounds = 10000000 / n + 3;
+
+        if (bench_enabled("vclock_merge")) {
+            bench_samples_reset(&s);
+            for (u64 r = 0; r < rounds; r++) {
+                cauchy_vclock_t dst;
+                BENCH_CHECK(cauchy_vclock_copy(&dst, &a) == CAUCHY_OK);
+                u64 t0 = bench_now_ns();
+                BENCH_CHECK(cauchy_vclock_merge(&dst, &b) == CAUCHY_OK);
+                bench_sample(&s, 1, bench_now_ns() - t0);
+                cauchy_vclock_fini(&dst);
+            }
+            bench_report("vclock_merge", n, 1, &s, 0);
+        }
+
+        if (bench_enabled("vclock_compare")) {
+            bench_samples_reset(&s);
+            for (u64 r = 0; r < rounds; r++) {
+                u64 t0 = bench_now_ns();
+                BENCH_CHECK(cauchy_vclock_compare(&a, &b) == CAUCHY_CONCURRENT);
+                bench_sample(&s, 1, bench_now_ns() - t0);
+            }
+            bench_report("vclock_compare", n, 1, &s, 0);
+        }
+
+        cauchy_vclock_fini(&a);
+        cauchy_vclock_fini(&b);
+    }
+    free(s.ns);
+}
+
+/* Causal delivery after a partition heals: every origin's ops arrive
+ * newest first, so all but the last wait, and the last to arrive
+ * releases a chain of the whole backlog */
+
+static cauchy_result_t causal_sink(void* arg, const cauchy_causal_op_t* op) {
+    (void)op;
+    (*(u64*)arg)++;
+    return CAUCHY_OK;
+}
+
+static void bench_causal(void) {
+    if (!bench_enabled("causal_reverse")) return;
+    bench_samples_t s = { 0 };
+    for (usize i = 0; i < BENCH_SIZE_COUNT && bench_sizes[i] <= bench_cfg.max_size; i++) {
+        u64 n = bench_sizes[i];
+        u64 applied = 0;
+        cauchy_causal_config_t cfg = { .max_ops = n, .max_bytes = (usize)n * 256 };
+        cauchy_causal_t c;
+        BENCH_CHECK(cauchy_causal_init(&c, &cfg, causal_sink, &applied) == CAUCHY_OK);
+        bench_samples_reset(&s);
+        u64 per = n / CAUSAL_ORIGINS;
+        for (u64 base = 0; base < per * CAUSAL_ORIGINS; base += CAUSAL_ROUND) {
+            u64 m = per * CAUSAL_ORIGINS - base < CAUSAL_ROUND ? per * CAUSAL_ORIGINS - base
+                                                               : CAUSAL_ROUND;
+            u64 t0 = bench_now_ns();
+            for (u64 k = base; k < base + m; k++) {
+                cauchy_causal_op_t op = {
+                    .dot = { .node_id = k % CAUSAL_ORIGINS + 1,
+                             .timestamp = per - k / CAUSAL_ORIGINS },
+                    .data = &k, .size = sizeof(k)
+                };
+                BENCH_CHECK(cauchy_causal_receive(&c, &op, NULL) == CAUCHY_OK);
+            }
+            bench_sample(&s, m, bench_now_ns() - t0);
+        }
+        BENCH_CHECK(applied == per * CAUSAL_ORIGINS);
+        bench_report("causal_reverse", n, 1, &s, 0);
+        cauchy_causal_fini(&c);
+    }
+    free(s.ns);
+}
+
+/* Op log: every thread commits (appends and syncs) its own records, so
+ * the rate shows how far group commit amortizes fdatasync */
+
+static void* wal_worker(void* arg) {
+    worker_t* w = arg;
+    cauchy_wal_t* wal = w->arg;
+    u64 payload[4] = { 0 };
+    cauchy_wal_record_t rec = {
+        .kind = CAUCHY_SNAPSHOT_G_COUNTER, .crdt_id = 1,
+        .uid = { .node_id = cauchy_thread_id() }, .data = payload, .size = sizeof(payload)
+    };
+    pthread_barrier_wait(w->start);
+    for (int i = 0; i < WAL_COMMITS; i++) {
+        rec.uid.timestamp++;
+        u64 t0 = bench_now_ns();
+        BENCH_CHECK(cauchy_wal_commit(wal, &rec) == CAUCHY_OK);
+        bench_sample(&w->samples, 1, bench_now_ns() - t0);
+    }
+    return NULL;
+}
+
+static void bench_wal(void) {
+    if (!bench_enabled("wal_commit")) return;
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/cauchy-bench-%d.log", (int)getpid());
+    bench_samples_t s = { 0 };
+    for (usize t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        unlink(path);
+        cauchy_wal_t* wal = cauchy_wal_open(path, NULL);
+        BENCH_CHECK(wal != NULL);
+        run_threads(thread_counts[t], wal_worker, wal, &s);
+        bench_report("wal_commit", WAL_COMMITS, thread_counts[t], &s, 0);
+        BENCH_CHECK(cauchy_wal_close(wal) == CAUCHY_OK);
+    }
+    unlink(path);
+    free(s.ns);
+}
+
+/* Object store: one shard per thread. Each thread queues increments to
+ * counters of its own shard and applies them, the deployment the store
+ * is built for, so the rate should grow with threads. */
+
+typedef struct {
+    cauchy_store_t*     store;
+    cauchy_atomic_u32_t next;
+} store_bench_t;
+
+static void* store_worker(void* arg) {
+    worker_t* w = arg;
+    store_bench_t* b = w->arg;
+    u32 shard = cauchy_atomic_fetch_add_u32(&b->next, 1);
+    u64 names[STORE_NAMES];
+    for (u64 k = 0, found = 0; found < STORE_NAMES; k++) {
+        if (cauchy_store_shard_of(b->store, &k, sizeof(k)) == shard) names[found++] = k;
+    }
+    pthread_barrier_wait(w->start);
+    for (int r = 0; r < STORE_ROUNDS; r++) {
+        u64 t0 = bench_now_ns();
+        for (u32 i = 0; i < STORE_ROUND; i++) {
+            BENCH_CHECK(cauchy_store_add(b->store, &names[i % STORE_NAMES], sizeof(u64),
+                                         CAUCHY_CRDT_G_COUNTER, 1) == CAUCHY_OK);
+        }
+        BENCH_CHECK(cauchy_store_poll(b->store, shard, 0) == STORE_ROUND);
+        bench_sample(&w->samples, STORE_ROUND, bench_now_ns() - t0);
+    }
+    return NULL;
+}
+
+static void bench_store(void) {
+    if (!bench_enabled("store_add")) return;
+    cauchy_context_t* ctx = cauchy_context_create(1);
+    BENCH_CHECK(ctx != NULL);
+    bench_samples_t s = { 0 };
+    for (usize t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        cauchy_store_config_t cfg = CAUCHY_STORE_CONFIG_DEFAULT;
+        cfg.shards = thread_counts[t];
+        cfg.queue_capacity = STORE_ROUND;
+        store_bench_t b;
+        b.store = cauchy_store_create(ctx, &cfg);
+        BENCH_CHECK(b.store != NULL);
+        atomic_init(&b.next, 0);
+        run_threads(thread_counts[t], store_worker, &b, &s);
+        bench_report("store_add", STORE_ROUND, thread_counts[t], &s, 0);
+        cauchy_store_destroy(b.store);
+    }
+    cauchy_context_destroy(ctx);
+    free(s.ns);
+}
+
+int main(int argc, char** argv) {
+    bench_init(argc, argv);
+
+    bench_pool();
+    bench_hazard();
+    bench_vclock();
+    bench_causal();
+    bench_wal();
+    bench_store();
+
+    bench_finish();
+    return 0;
+}
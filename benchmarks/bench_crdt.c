@@ -0,0 +1,479 @@
+/*
+ * CAUCHY - CRDT Benchmarks
+ *
+ * Per-operation and merge cost of every CRDT, swept over sizes. A size is
+ * the number of elements (sets, maps, sequences) or of nodes (counters).
+ */
+
+#include "bench.h"
+#include "cauchy/crdt/g_counter.h"
+#include "cauchy/crdt/pn_counter.h"
+#include "cauchy/crdt/g_set.h"
+#include "cauchy/crdt/2p_set.h"
+#include "cauchy/crdt/or_set.h"
+#include "cauchy/crdt/orswot.h"
+#include "cauchy/crdt/lww_register.h"
+#include "cauchy/crdt/lww_map.h"
+#include "cauchy/crdt/rga.h"
+
+#define ROUND 1024   /* Operations per latency sample */
+
+/* Element i of every benchmark: distinct 8-byte keys with spread bits */
+static u64* make_keys(u64 n) {
+    u64* keys = malloc(n * sizeof(u64));
+    BENCH_CHECK(keys != NULL);
+    for (u64 i = 0; i < n; i++) keys[i] = (i + 1) * 0x9E3779B97F4A7C15ULL;
+    return keys;
+}
+
+/* Merges rebuild their target every round, so big sizes get few rounds */
+static u64 merge_rounds(u64 n) {
+    u64 r = 1000000 / n;
+    return r < 3 ? 3 : r > 100 ? 100 : r;
+}
+
+static void name_of(char* buf, usize size, const char* type, const char* op) {
+    snprintf(buf, size, "%s_%s", type, op);
+}
+
+/* Counters */
+
+static void bench_counters(u64 n) {
+    bench_samples_t s = { 0 };
+    u64 rng = n;
+
+    if (bench_enabled("gcounter")) {
+        cauchy_gcounter_t a, b;
+        cauchy_gcounter_init(&a, (u32)n);
+        cauchy_gcounter_init(&b, (u32)n);
+        for (u64 node = 0; node < n; node++) {
+            BENCH_CHECK(cauchy_gcounter_add(&a, node, node & 1 ? 2 : 1) == CAUCHY_OK);
+            BENCH_CHECK(cauchy_gcounter_add(&b, node, node & 1 ? 1 : 2) == CAUCHY_OK);
+        }
+
+        bench_samples_reset(&s);
+        for (int r = 0; r < 1000; r++) {
+            u64 t0 = bench_now_ns();
+            for (int i = 0; i < ROUND; i++) cauchy_gcounter_increment(&a, bench_rand(&rng) % n);
+            bench_sample(&s, ROUND, bench_now_ns() - t0);
+        }
+        bench_report("gcounter_increment", n, 1, &s, 0);
+
+        bench_samples_reset(&s);
+        for (u64 r = 0; r < merge_rounds(n); r++) {
+            cauchy_gcounter_t dst;
+            BENCH_CHECK(cauchy_gcounter_copy(&dst, &a) == CAUCHY_OK);
+            u64 t0 = bench_now_ns();
+            BENCH_CHECK(cauchy_gcounter_merge(&dst, &b) == CAUCHY_OK);
+            bench_sample(&s, 1, bench_now_ns() - t0);
+            cauchy_gcounter_fini(&dst);
+        }
+        bench_report("gcounter_merge", n, 1, &s, 0);
+        cauchy_gcounter_fini(&a);
+        cauchy_gcounter_fini(&b);
+    }
+
+    if (bench_enabled("pncounter")) {
+        cauchy_pncounter_t a, b;
+        cauchy_pncounter_init(&a, (u32)n);
+        cauchy_pncounter_init(&b, (u32)n);
+        for (u64 node = 0; node < n; node++) {
+            BENCH_CHECK(cauchy_pncounter_add(&a, node, node & 1 ? 2 : -1) == CAUCHY_OK);
+            BENCH_CHECK(cauchy_pncounter_add(&b, node, node & 1 ? -1 : 2) == CAUCHY_OK);
+        }
+
+        bench_samples_reset(&s);
+        for (int r = 0; r < 1000; r++) {
+            u64 t0 = bench_now_ns();
+            for (int i = 0; i < ROUND; i++) {
+                u64 x = bench_rand(&rng);
+                cauchy_pncounter_add(&a, x % n, x & 1 ? 1 : -1);
+            }
+            bench_sample(&s, ROUND, bench_now_ns() - t0);
+        }
+        bench_report("pncounter_add", n, 1, &s, 0);
+
+        bench_samples_reset(&s);
+        for (u64 r = 0; r < merge_rounds(n); r++) {
+            cauchy_pncounter_t dst;
+            cauchy_pncounter_init(&dst, (u32)n);
+            BENCH_CHECK(cauchy_pncounter_merge(&dst, &a) == CAUCHY_OK);
+            u64 t0 = bench_now_ns();
+            BENCH_CHECK(cauchy_pncounter_merge(&dst, &b) == CAUCHY_OK);
+            bench_sample(&s, 1, bench_now_ns() - t0);
+            cauchy_pncounter_fini(&dst);
+        }
+        bench_report("pncounter_merge", n, 1, &s, 0);
+        cauchy_pncounter_fini(&a);
+        cauchy_pncounter_fini(&b);
+    }
+    free(s.ns);
+}
+
+/* Sets, behind one table of operations */
+
+typedef struct set_ops {
+    const char*     type;
+    void*           (*create)(cauchy_node_id_t node);
+    void            (*destroy)(void* set);
+    cauchy_result_t (*add)(void* set, const void* data, usize size);
+    cauchy_result_t (*remove)(void* set, const void* data, usize size);  /* NULL: grow-only */
+    bool            (*contains)(const void* set, const void* data, usize size);
+    cauchy_result_t (*merge)(void* dst, const void* src);
+} set_ops_t;
+
+static void* gset_new(cauchy_node_id_t node) { (void)node; return cauchy_gset_create(0); }
+static void gset_free(void* s) { cauchy_gset_destroy(s); }
+static cauchy_result_t gset_add(void* s, const void* d, usize n) { return cauchy_gset_add(s, d, n); }
+static bool gset_has(const void* s, const void* d, usize n) { return cauchy_gset_contains(s, d, n); }
+static cauchy_result_t gset_join(void* d, const void* s) { return cauchy_gset_merge(d, s); }
+
+static void* tpset_new(cauchy_node_id_t node) { (void)node; return cauchy_2pset_create(0); }
+static void tpset_free(void* s) { cauchy_2pset_destroy(s); }
+static cauchy_result_t tpset_add(void* s, const void* d, usize n) { return cauchy_2pset_add(s, d, n); }
+static cauchy_result_t tpset_del(void* s, const void* d, usize n) { return cauchy_2pset_remove(s, d, n); }
+static bool tpset_has(const void* s, const void* d, usize n) { return cauchy_2pset_contains(s, d, n); }
+static cauchy_result_t tpset_join(void* d, const void* s) { return cauchy_2pset_merge(d, s); }
+
+static void* orset_new(cauchy_node_id_t node) { return cauchy_orset_create(0, node); }
+static void orset_free(void* s) { cauchy_orset_destroy(s); }
+static cauchy_result_t orset_add(void* s, const void* d, usize n) { return cauchy_orset_add(s, d, n); }
+static cauchy_result_t orset_del(void* s, const void* d, usize n) { return cauchy_orset_remove(s, d, n); }
+static bool orset_has(const void* s, const void* d, usize n) { return cauchy_orset_contains(s, d, n); }
+static cauchy_result_t orset_join(void* d, const void* s) { return cauchy_orset_merge(d, s); }
+
+static void* orswot_new(cauchy_node_id_t node) { return cauchy_orswot_create(0, node); }
+static void orswot_free(void* s) { cauchy_orswot_destroy(s); }
+static cauchy_result_t orswot_add(void* s, const void* d, usize n) { return cauchy_orswot_add(s, d, n); }
+static cauchy_result_t orswot_del(void* s, const void* d, usize n) { return cauchy_orswot_remove(s, d, n); }
+static bool orswot_has(const void* s, const void* d, usize n) { return cauchy_orswot_contains(s, d, n); }
+static cauchy_result_t orswot_join(void* d, const void* s) { return cauchy_orswot_merge(d, s); }
+
+static const set_ops_t set_types[] = {
+    { "gset",   gset_new,   gset_free,   gset_add,   NULL,       gset_has,   gset_join },
+    { "2pset",  tpset_new,  tpset_free,  tpset_add,  tpset_del,  tpset_has,  tpset_join },
+    { "orset",  orset_new,  orset_free,  orset_add,  orset_del,  orset_has,  orset_join },
+    { "orswot", orswot_new, orswot_free, orswot_add, orswot_del, orswot_has, orswot_join },
+};
+
+static void bench_set(const set_ops_t* ops, const u64* keys, u64 n) {
+    if (!bench_enabled(ops->type)) return;
+    bench_samples_t s = { 0 };
+    char name[64];
+    u64 rng = n;
+
+    /* Adds build the set the other benchmarks use */
+    void* set = ops->create(1);
+    BENCH_CHECK(set != NULL);
+    bench_samples_reset(&s);
+    for (u64 base = 0; base < n; base += ROUND) {
+        u64 m = n - base < ROUND ? n - base : ROUND;
+        u64 t0 = bench_now_ns();
+        for (u64 i = base; i < base + m; i++) ops->add(set, &keys[i], sizeof(u64));
+        bench_sample(&s, m, bench_now_ns() - t0);
+    }
+    name_of(name, sizeof(name), ops->type, "add");
+    bench_report(name, n, 1, &s, 0);
+
+    bench_samples_reset(&s);
+    usize hits = 0;
+    for (u64 done = 0; done < n || done < 100 * ROUND; done += ROUND) {
+        u64 t0 = bench_now_ns();
+        for (int i = 0; i < ROUND; i++) {
+            hits += ops->contains(set, &keys[bench_rand(&rng) % n], sizeof(u64));
+        }
+        bench_sample(&s, ROUND, bench_now_ns() - t0);
+    }
+    BENCH_CHECK(hits == s.ops);
+    name_of(name, sizeof(name), ops->type, "contains");
+    bench_report(name, n, 1, &s, 0);
+
+    /* Merge a full replica from another node into one holding half */
+    void* src = ops->create(2);
+    BENCH_CHECK(src != NULL);
+    for (u64 i = 0; i < n; i++) ops->add(src, &keys[i], sizeof(u64));
+    bench_samples_reset(&s);
+    for (u64 r = 0; r < merge_rounds(n); r++) {
+        void* dst = ops->create(1);
+        BENCH_CHECK(dst != NULL);
+        for (u64 i = 0; i < n / 2; i++) ops->add(dst, &keys[i], sizeof(u64));
+        u64 t0 = bench_now_ns();
+        BENCH_CHECK(ops->merge(dst, src) == CAUCHY_OK);
+        bench_sample(&s, 1, bench_now_ns() - t0);
+        ops->destroy(dst);
+    }
+    name_of(name, sizeof(name), ops->type, "merge");
+    bench_report(name, n, 1, &s, 0);
+    ops->destroy(src);
+
+    if (ops->remove) {
+        bench_samples_reset(&s);
+        for (u64 base = 0; base < n; base += ROUND) {
+            u64 m = n - base < ROUND ? n - base : ROUND;
+            u64 t0 = bench_now_ns();
+            for (u64 i = base; i < base + m; i++) ops->remove(set, &keys[i], sizeof(u64));
+            bench_sample(&s, m, bench_now_ns() - t0);
+        }
+        name_of(name, sizeof(name), ops->type, "remove");
+        bench_report(name, n, 1, &s, 0);
+    }
+
+    ops->destroy(set);
+    free(s.ns);
+}
+
+/* Batched lookups against the one-at-a-time numbers above */
+static void bench_gset_batch(const u64* keys, u64 n) {
+    if (!bench_enabled("gset_contains_batch")) return;
+    bench_samples_t s = { 0 };
+    u64 rng = n;
+    cauchy_gset_t* set = cauchy_gset_create(0);
+    BENCH_CHECK(set != NULL);
+    cauchy_bytes_t items[ROUND];
+    for (u64 base = 0; base < n; base += ROUND) {
+        u64 m = n - base < ROUND ? n - base : ROUND;
+        for (u64 i = 0; i < m; i++) items[i] = (cauchy_bytes_t){ &keys[base + i], sizeof(u64) };
+        BENCH_CHECK(cauchy_gset_add_batch(set, items, m, NULL) == CAUCHY_OK);
+    }
+
+    for (u64 done = 0; done < n || done < 100 * ROUND; done += ROUND) {
+        for (int i = 0; i < ROUND; i++) {
+            items[i] = (cauchy_bytes_t){ &keys[bench_rand(&rng) % n], sizeof(u64) };
+        }
+        u64 t0 = bench_now_ns();
+        usize hits = cauchy_gset_contains_batch(set, items, ROUND, NULL);
+        bench_sample(&s, ROUND, bench_now_ns() - t0);
+        BENCH_CHECK(hits == ROUND);
+    }
+    bench_report("gset_contains_batch", n, 1, &s, 0);
+    cauchy_gset_destroy(set);
+    free(s.ns);
+}
+
+/* The merge above split across 1 to 8 parts (1 is the serial merge) */
+static const u32 merge_parts[] = { 1, 2, 4, 8 };
+
+static void bench_merge_parallel(const u64* keys, u64 n) {
+    if (n < CAUCHY_PARALLEL_MIN_ITEMS) return;
+    bench_samples_t s = { 0 };
+    if (bench_enabled("gset_merge_parallel")) {
+        cauchy_gset_t* src = cauchy_gset_create(0);
+        BENCH_CHECK(src != NULL);
+        for (u64 i = 0; i < n; i++) cauchy_gset_add(src, &keys[i], sizeof(u64));
+        for (usize p = 0; p < sizeof(merge_parts) / sizeof(merge_parts[0]); p++) {
+            bench_samples_reset(&s);
+            for (u64 r = 0; r < merge_rounds(n); r++) {
+                cauchy_gset_t* dst = cauchy_gset_create(0);
+                BENCH_CHECK(dst != NULL);
+                for (u64 i = 0; i < n / 2; i++) cauchy_gset_add(dst, &keys[i], sizeof(u64));
+                u64 t0 = bench_now_ns();
+                BENCH_CHECK(cauchy_gset_merge_parallel(dst, src, merge_parts[p], NULL) ==
+                            CAUCHY_OK);
+                bench_sample(&s, 1, bench_now_ns() - t0);
+                cauchy_gset_destroy(dst);
+            }
+            bench_report("gset_merge_parallel", n, merge_parts[p], &s, 0);
+        }
+        cauchy_gset_destroy(src);
+    }
+    if (bench_enabled("orset_merge_parallel")) {
+        cauchy_orset_t* src = cauchy_orset_create(0, 2);
+        BENCH_CHECK(src != NULL);
+        for (u64 i = 0; i < n; i++) cauchy_orset_add(src, &keys[i], sizeof(u64));
+        for (usize p = 0; p < sizeof(merge_parts) / sizeof(merge_parts[0]); p++) {
+            bench_samples_reset(&s);
+            for (u64 r = 0; r < merge_rounds(n); r++) {
+                cauchy_orset_t* dst = cauchy_orset_create(0, 1);
+                BENCH_CHECK(dst != NULL);
+                for (u64 i = 0; i < n / 2; i++) cauchy_orset_add(dst, &keys[i], sizeof(u64));
+                u64 t0 = bench_now_ns();
+                BENCH_CHECK(cauchy_orset_merge_parallel(dst, src, merge_parts[p], NULL) ==
+                            CAUCHY_OK);
+                bench_sample(&s, 1, bench_now_ns() - t0);
+                cauchy_orset_destroy(dst);
+            }
+            bench_report("orset_merge_parallel", n, merge_parts[p], &s, 0);
+        }
+        cauchy_orset_destroy(src);
+    }
+    free(s.ns);
+}
+
+/* LWW-Register: one register, so no size sweep */
+
+static void bench_register(void) {
+    if (!bench_enabled("lww")) return;
+    bench_samples_t s = { 0 };
+    static u8 big[4096];
+    const struct { const char* name; usize size; } values[] = {
+        { "lww_set_inline", 8 }, { "lww_set_blob", sizeof(big) }
+    };
+    for (usize v = 0; v < 2; v++) {
+        cauchy_lww_register_t reg;
+        cauchy_lww_init(&reg);
+        bench_samples_reset(&s);
+        cauchy_timestamp_t ts = 1;
+        for (int r = 0; r < 1000; r++) {
+            u64 t0 = bench_now_ns();
+            for (int i = 0; i < ROUND; i++) cauchy_lww_set(&reg, big, values[v].size, ts++, 1);
+            bench_sample(&s, ROUND, bench_now_ns() - t0);
+        }
+        bench_report(values[v].name, values[v].size, 1, &s, 0);
+
+        /* Every source is newer than the one before it, so each merge
+         * takes the value: a copy inline, a blob retain and release
+         * otherwise. Sources are restamped between samples, untimed. */
+        static cauchy_lww_register_t sources[ROUND];
+        for (int i = 0; i < ROUND; i++) cauchy_lww_init(&sources[i]);
+        bench_samples_reset(&s);
+        for (int r = 0; r < 1000; r++) {
+            for (int i = 0; i < ROUND; i++) {
+                BENCH_CHECK(cauchy_lww_set(&sources[i], big, values[v].size, ts++, 2) == CAUCHY_OK);
+            }
+            u64 t0 = bench_now_ns();
+            for (int i = 0; i < ROUND; i++) cauchy_lww_merge(&reg, &sources[i]);
+            bench_sample(&s, ROUND, bench_now_ns() - t0);
+        }
+        BENCH_CHECK(cauchy_lww_equals(&reg, &sources[ROUND - 1]));
+        bench_report(v ? "lww_merge_blob" : "lww_merge_inline", values[v].size, 1, &s, 0);
+        cauchy_lww_fini(&reg);
+        for (int i = 0; i < ROUND; i++) cauchy_lww_fini(&sources[i]);
+    }
+    free(s.ns);
+}
+
+/* LWW-Map */
+
+static void bench_map(const u64* keys, u64 n) {
+    if (!bench_enabled("lwwmap")) return;
+    bench_samples_t s = { 0 };
+    u64 rng = n;
+    cauchy_lww_map_t* map = cauchy_lww_map_create(0, NULL);
+    BENCH_CHECK(map != NULL);
+    bench_samples_reset(&s);
+    for (u64 base = 0; base < n; base += ROUND) {
+        u64 m = n - base < ROUND ? n - base : ROUND;
+        u64 t0 = bench_now_ns();
+        for (u64 i = base; i < base + m; i++) {
+            cauchy_lww_map_set(map, &keys[i], sizeof(u64), &i, sizeof(i), i + 1, 1);
+        }
+        bench_sample(&s, m, bench_now_ns() - t0);
+    }
+    bench_report("lwwmap_set", n, 1, &s, 0);
+
+    cauchy_lww_register_t reg;
+    cauchy_lww_init(&reg);
+    bench_samples_reset(&s);
+    for (u64 done = 0; done < n || done < 100 * ROUND; done += ROUND) {
+        u64 t0 = bench_now_ns();
+        for (int i = 0; i < ROUND; i++) {
+            cauchy_lww_map_get(map, &keys[bench_rand(&rng) % n], sizeof(u64), &reg);
+        }
+        bench_sample(&s, ROUND, bench_now_ns() - t0);
+    }
+    bench_report("lwwmap_get", n, 1, &s, 0);
+    cauchy_lww_fini(&reg);
+
+    bench_samples_reset(&s);
+    for (u64 r = 0; r < merge_rounds(n); r++) {
+        cauchy_lww_map_t* dst = cauchy_lww_map_create(0, NULL);
+        BENCH_CHECK(dst != NULL);
+        for (u64 i = 0; i < n / 2; i++) {
+            cauchy_lww_map_set(dst, &keys[i], sizeof(u64), &i, sizeof(i), i, 2);
+        }
+        u64 t0 = bench_now_ns();
+        BENCH_CHECK(cauchy_lww_map_merge(dst, map) == CAUCHY_OK);
+        bench_sample(&s, 1, bench_now_ns() - t0);
+        cauchy_lww_map_destroy(dst);
+    }
+    bench_report("lwwmap_merge", n, 1, &s, 0);
+    cauchy_lww_map_destroy(map);
+    free(s.ns);
+}
+
+/* RGA: single-character edits at random positions, then the same ops
+ * applied by a second replica (the op-based stand-in for a merge) */
+
+typedef struct {
+    u8*   buf;
+    usize size;
+    usize capacity;
+} op_log_t;
+
+static void log_op(void* arg, const cauchy_rga_op_t* op) {
+    op_log_t* log = arg;
+    usize need = cauchy_rga_op_encoded_size(op);
+    if (log->size + need > log->capacity) {
+        log->capacity = (log->size + need) * 2;
+        log->buf = realloc(log->buf, log->capacity);
+        BENCH_CHECK(log->buf != NULL);
+    }
+    BENCH_CHECK(cauchy_rga_op_encode(op, log->buf + log->size, need) == need);
+    log->size += need;
+}
+
+static void bench_rga(u64 n) {
+    if (!bench_enabled("rga")) return;
+    bench_samples_t s = { 0 };
+    u64 rng = n;
+    op_log_t log = { 0 };
+    cauchy_rga_t* a = cauchy_rga_create(1);
+    cauchy_rga_t* b = cauchy_rga_create(2);
+    BENCH_CHECK(a && b);
+
+    for (u64 base = 0; base < n; base += ROUND) {
+        u64 m = n - base < ROUND ? n - base : ROUND;
+        u64 t0 = bench_now_ns();
+        for (u64 i = 0; i < m; i++) {
+            u64 x = bench_rand(&rng);
+            char c = (char)('a' + x % 26);
+            cauchy_rga_insert(a, (usize)(x >> 8) % (cauchy_rga_length(a) + 1), &c, 1, log_op, &log);
+        }
+        bench_sample(&s, m, bench_now_ns() - t0);
+    }
+    bench_report("rga_insert", n, 1, &s, 0);
+
+    bench_samples_reset(&s);
+    usize pos = 0;
+    while (pos < log.size) {
+        u64 t0 = bench_now_ns();
+        u64 m = 0;
+        for (; m < ROUND && pos < log.size; m++) {
+            cauchy_rga_op_t op;
+            usize used;
+            BENCH_CHECK(cauchy_rga_op_decode(&op, log.buf + pos, log.size - pos, &used) == CAUCHY_OK);
+            BENCH_CHECK(cauchy_rga_apply(b, &op) == CAUCHY_OK);
+            pos += used;
+        }
+        bench_sample(&s, m, bench_now_ns() - t0);
+    }
+    BENCH_CHECK(cauchy_rga_equals(a, b));
+    bench_report("rga_apply", n, 1, &s, 0);
+
+    cauchy_rga_destroy(a);
+    cauchy_rga_destroy(b);
+    free(log.buf);
+    free(s.ns);
+}
+
+int main(int argc, char** argv) {
+    bench_init(argc, argv);
+
+    bench_register();
+    for (usize i = 0; i < BENCH_SIZE_COUNT && bench_sizes[i] <= bench_cfg.max_size; i++) {
+        u64 n = bench_sizes[i];
+        u64* keys = make_keys(n);
+        bench_counters(n);
+        for (usize t = 0; t < sizeof(set_types) / sizeof(set_types[0]); t++) {
+            bench_set(&set_types[t], keys, n);
+        }
+        bench_gset_batch(keys, n);
+        bench_merge_parallel(keys, n);
+        bench_map(keys, n);
+        bench_rga(n);
+        free(keys);
+    }
+
+    bench_finish();
+    return 0;
+}
@@ -92,6 +92,10 @@ CAUCHY_INLINE u64 cauchy_atomic_fetch_add_u64(cauchy_atomic_u64_t* ptr, u64 val)
 }
 
 /* Fetch-and-sub */
+CAUCHY_INLINE u32 cauchy_atomic_fetch_sub_u32(cauchy_atomic_u32_t* ptr, u32 val) {
+    return atomic_fetch_sub_explicit(ptr, val, memory_order_acq_rel);
+}
+
 CAUCHY_INLINE u64 cauchy_atomic_fetch_sub_u64(cauchy_atomic_u64_t* ptr, u64 val) {
     return atomic_fetch_sub_explicit(ptr, val, memory_order_acq_rel);
 }
@@ -136,6 +140,27 @@ bool cauchy_atomic_cas_u128(cauchy_atomic_u128_t* ptr,
                             
 cauchy_u128_t cauchy_atomic_load_u128(const cauchy_atomic_u128_t* ptr);
 void cauchy_atomic_store_u128(cauchy_atomic_u128_t* ptr, cauchy_u128_t val);
+
+/* Tagged pointer views over a 128-bit atomic (pointer in lo, tag in hi).
+ * Bumping the tag on every successful CAS makes pointer reuse (ABA)
+ * visible to concurrent CAS attempts. */
+CAUCHY_INLINE cauchy_tagged_ptr_t cauchy_atomic_load_tagged(const cauchy_atomic_u128_t* ptr) {
+    cauchy_u128_t raw = cauchy_atomic_load_u128(ptr);
+    return (cauchy_tagged_ptr_t){ .ptr = (void*)(uintptr_t)raw.lo, .tag = raw.hi };
+}
+
+CAUCHY_INLINE bool cauchy_atomic_cas_tagged(cauchy_atomic_u128_t* ptr,
+                                            cauchy_tagged_ptr_t* expected,
+                                            void* desired) {
+    cauchy_u128_t exp = { (u64)(uintptr_t)expected->ptr, expected->tag };
+    cauchy_u128_t des = { (u64)(uintptr_t)desired, expected->tag + 1 };
+    bool result = cauchy_atomic_cas_u128(ptr, &exp, des);
+    if (!result) {
+        expected->ptr = (void*)(uintptr_t)exp.lo;
+        expected->tag = exp.hi;
+    }
+    return result;
+}
 #endif
 
 #ifdef __cplusplus
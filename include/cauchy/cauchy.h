@@ -14,7 +14,14 @@
 #include "types.h"
 #include "atomic.h"
 #include "memory.h"
+#include "numa.h"
 #include "vclock.h"
+#include "stats.h"
+#include "snapshot.h"
+#include "wal.h"
+#include "parallel.h"
+#include "causal.h"
+#include "mvcc.h"
 
 /* CRDT types - will be added as implemented */
 /* #include "crdt/g_counter.h" */
@@ -23,6 +30,7 @@
 /* #include "crdt/g_set.h" */
 /* #include "crdt/2p_set.h" */
 /* #include "crdt/or_set.h" */
+/* #include "crdt/orswot.h" */
 /* #include "crdt/lww_map.h" */
 /* #include "crdt/rga.h" */
 
@@ -47,13 +55,19 @@ typedef struct cauchy_context {
     cauchy_node_id_t    node_id;
     cauchy_vclock_t     local_clock;
     cauchy_pool_t*      mem_pool;
-    cauchy_hazard_domain_t* hazard_domain;
+    cauchy_reclaim_mode_t   reclaim_mode;
+    cauchy_hazard_domain_t* hazard_domain;  /* Set in CAUCHY_RECLAIM_HAZARD mode */
+    cauchy_epoch_domain_t*  epoch_domain;   /* Set in CAUCHY_RECLAIM_EPOCH mode */
     u64                 op_counter;  /* For UID generation */
 } cauchy_context_t;
 
-/* Create a new context for a node */
+/* Create a new context for a node (hazard-pointer reclamation) */
 cauchy_context_t* cauchy_context_create(cauchy_node_id_t node_id);
 
+/* Create a new context with an explicit reclamation scheme */
+cauchy_context_t* cauchy_context_create_ex(cauchy_node_id_t node_id,
+                                           cauchy_reclaim_mode_t mode);
+
 /* Destroy a context */
 void cauchy_context_destroy(cauchy_context_t* ctx);
 
@@ -70,6 +84,37 @@ void cauchy_context_tick(cauchy_context_t* ctx);
 void cauchy_context_merge_clock(cauchy_context_t* ctx, 
                                  const cauchy_vclock_t* remote);
 
+/* Retire a node through whichever domain the context was created with
+ * (see cauchy_epoch_retire for CAUCHY_ERR_NOMEM) */
+cauchy_result_t cauchy_context_retire(cauchy_context_t* ctx, void* node,
+                                      cauchy_retire_fn retire_fn, void* arg);
+
+/* Reclaim retired nodes in the context's domain */
+usize cauchy_context_reclaim(cauchy_context_t* ctx);
+
+/* Everything observable about a context in one snapshot: its own pool
+ * and reclamation backlog, plus the process-wide instrumentation
+ * (all zero unless built with CAUCHY_STATS) */
+typedef struct cauchy_context_stats {
+    cauchy_node_id_t    node_id;
+    u64                 ops;              /* UIDs generated */
+    cauchy_pool_stats_t pool;
+    usize               reclaim_pending;  /* Retired nodes awaiting reclamation */
+    cauchy_stats_t      process;
+} cauchy_context_stats_t;
+
+/* Fill out from the context and the process-wide counters */
+cauchy_result_t cauchy_context_get_stats(const cauchy_context_t* ctx,
+                                         cauchy_context_stats_t* out);
+
+/* Snapshot the context's clock and UID counter into a
+ * CAUCHY_SNAPSHOT_CONTEXT section named by its node id. Loading joins
+ * the saved clock into the local one and resumes UIDs past the saved
+ * counter, so a restarted node never reissues one. */
+cauchy_result_t cauchy_context_snapshot_save(const cauchy_context_t* ctx,
+                                             cauchy_snapshot_writer_t* w);
+cauchy_result_t cauchy_context_snapshot_load(cauchy_context_t* ctx, cauchy_snapshot_t* snap);
+
 #ifdef __cplusplus
 }
 #endif
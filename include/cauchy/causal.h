@@ -0,0 +1,121 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Causal Delivery Buffer
+ *
+ * Holds back remote operations until everything they depend on has been
+ * delivered, then hands them to a callback in causal order. Each op
+ * carries its dot: the origin node and that node's counter, which
+ * starts at 1 and has no gaps. It also carries the clock of ops the
+ * origin had delivered when it made the op. The op is deliverable once
+ * the origin's previous op, and every dependency in that clock, has
+ * been delivered.
+ *
+ * An op that cannot be delivered waits under the first dependency it
+ * still misses, a single (node, counter) key. Delivering the op with
+ * that dot wakes exactly the ops waiting on it. Each woken op either
+ * goes through or waits under its next missing dependency. Arrivals
+ * never rescan the waiting ops. Since the delivered clock only grows, a
+ * dependency that is satisfied stays satisfied. An op therefore checks
+ * each of its dependencies at most twice in total.
+ *
+ * Held ops are copied: the payload, plus only those dependencies that
+ * were still missing on arrival. At most max_ops ops and max_bytes
+ * bytes are held; past either limit an op is refused and must be sent
+ * again later, e.g. by anti-entropy. Not thread-safe; callers
+ * serialize access.
+ */
+
+#ifndef CAUCHY_CAUSAL_H
+#define CAUCHY_CAUSAL_H
+
+#include "types.h"
+#include "vclock.h"
+#include "htable.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct cauchy_causal_config {
+    usize max_ops;      /* Held-back ops */
+    usize max_bytes;    /* Held-back payloads and dependencies */
+} cauchy_causal_config_t;
+
+#define CAUCHY_CAUSAL_CONFIG_DEFAULT { \
+    .max_ops = 1 << 16,                \
+    .max_bytes = 64 << 20              \
+}
+
+/* One remote op. deps may be NULL for an op that only follows its
+ * origin's previous one; the origin's own entry in it is ignored. */
+typedef struct cauchy_causal_op {
+    cauchy_uid_t           dot;     /* Origin node, its counter */
+    const cauchy_vclock_t* deps;    /* Ops the origin had delivered */
+    const void*            data;
+    usize                  size;
+} cauchy_causal_op_t;
+
+/* Delivery callback. deps is NULL for ops that were held back. An error
+ * leaves the op undelivered and discards it, so a resend can deliver it
+ * later. */
+typedef cauchy_result_t (*cauchy_causal_deliver_fn)(void* arg, const cauchy_causal_op_t* op);
+
+typedef struct cauchy_causal_stats {
+    usize held;         /* Ops waiting now */
+    usize held_bytes;
+    u64   delivered;    /* Ops delivered, directly or once woken */
+    u64   deferred;     /* Ops that had to wait */
+    u64   duplicates;   /* Ops already delivered or already held */
+    u64   refused;      /* Ops turned away at the limits */
+} cauchy_causal_stats_t;
+
+typedef struct cauchy_causal {
+    cauchy_causal_config_t   config;
+    cauchy_causal_deliver_fn deliver;
+    void*                    arg;
+    cauchy_vclock_t          delivered;  /* Highest contiguous counter per origin */
+    cauchy_htable_t          by_dot;     /* Held ops by their own dot */
+    cauchy_htable_t          waiting;    /* Held ops by the dot they wait for */
+    cauchy_causal_stats_t    stats;
+} cauchy_causal_t;
+
+/* config may be NULL for the defaults */
+cauchy_result_t cauchy_causal_init(cauchy_causal_t* c, const cauchy_causal_config_t* config,
+                                   cauchy_causal_deliver_fn deliver, void* arg);
+
+/* Release held ops without delivering them */
+void cauchy_causal_fini(cauchy_causal_t* c);
+
+/* Take in a remote op: deliver it (and whatever it unblocks) or hold it
+ * back. Duplicates of delivered or held ops are dropped. *delivered (if
+ * non-NULL) receives the number of ops delivered by this call.
+ * CAUCHY_ERR_FULL if the op would exceed the limits and was not kept;
+ * otherwise the first delivery error, if any. */
+cauchy_result_t cauchy_causal_receive(cauchy_causal_t* c, const cauchy_causal_op_t* op,
+                                      usize* delivered);
+
+/* Dot for a new local op of node self, marked delivered. Send it with
+ * the clock as it was before the call as the op's deps. */
+cauchy_uid_t cauchy_causal_local(cauchy_causal_t* c, cauchy_node_id_t self);
+
+/* Count everything clock covers as delivered, e.g. after loading a
+ * snapshot or merging a full state. This also delivers the held ops it
+ * unblocks and drops the ones it covers. */
+cauchy_result_t cauchy_causal_advance(cauchy_causal_t* c, const cauchy_vclock_t* clock,
+                                      usize* delivered);
+
+/* What has been delivered: merge it into the context with
+ * cauchy_context_merge_clock */
+CAUCHY_INLINE const cauchy_vclock_t* cauchy_causal_clock(const cauchy_causal_t* c) {
+    return &c->delivered;
+}
+
+CAUCHY_INLINE cauchy_causal_stats_t cauchy_causal_get_stats(const cauchy_causal_t* c) {
+    return c->stats;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_CAUSAL_H */
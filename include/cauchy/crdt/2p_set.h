@@ -16,10 +16,16 @@
 extern "C" {
 #endif
 
-/* 2P-Set structure: pair of G-Sets */
+/* 2P-Set structure: pair of G-Sets. An element in removed is never
+ * visible again, so its copy in added is redundant; compaction drops it
+ * and merges do not bring it back. Until then the copies are counted,
+ * so the live count and fingerprint are the added half's minus theirs. */
 typedef struct cauchy_2pset {
     cauchy_gset_t* added;    /* Elements that have been added */
     cauchy_gset_t* removed;  /* Elements that have been removed (tombstones) */
+    usize          gc_cursor; /* Where the next incremental compaction resumes */
+    usize          covered;  /* Elements of added that removed also holds */
+    u64            covered_fingerprint;
 } cauchy_2pset_t;
 
 /* Initialize a 2P-Set */
@@ -37,16 +43,33 @@ cauchy_result_t cauchy_2pset_add(cauchy_2pset_t* set, const void* data, usize si
 /* Remove an element (permanent) */
 cauchy_result_t cauchy_2pset_remove(cauchy_2pset_t* set, const void* data, usize size);
 
+/* Delta-state mutators: update set and record the change in delta, itself
+ * a 2P-Set. Return codes match cauchy_2pset_add and cauchy_2pset_remove. */
+cauchy_result_t cauchy_2pset_add_delta(cauchy_2pset_t* set, const void* data, usize size,
+                                       cauchy_2pset_t* delta);
+cauchy_result_t cauchy_2pset_remove_delta(cauchy_2pset_t* set, const void* data, usize size,
+                                          cauchy_2pset_t* delta);
+
 /* Check if element is in set (added and not removed) */
 bool cauchy_2pset_contains(const cauchy_2pset_t* set, const void* data, usize size);
 
-/* Check if element was ever added */
+/* Check if element was ever added (removal implies it was) */
 bool cauchy_2pset_was_added(const cauchy_2pset_t* set, const void* data, usize size);
 
 /* Check if element was removed (tombstoned) */
 bool cauchy_2pset_was_removed(const cauchy_2pset_t* set, const void* data, usize size);
 
-/* Get count of active elements */
+/* Batch add, remove and lookup over n byte strings; one hash per item
+ * serves both halves (see cauchy_gset_add_batch). Per-item results match
+ * cauchy_2pset_add, cauchy_2pset_remove and cauchy_2pset_contains. */
+cauchy_result_t cauchy_2pset_add_batch(cauchy_2pset_t* set, const cauchy_bytes_t* items, usize n,
+                                       cauchy_result_t* results);
+cauchy_result_t cauchy_2pset_remove_batch(cauchy_2pset_t* set, const cauchy_bytes_t* items,
+                                          usize n, cauchy_result_t* results);
+usize cauchy_2pset_contains_batch(const cauchy_2pset_t* set, const cauchy_bytes_t* items, usize n,
+                                  bool* found);
+
+/* Get count of active elements (O(1)) */
 usize cauchy_2pset_count(const cauchy_2pset_t* set);
 
 /* Check if set is empty */
@@ -55,9 +78,36 @@ bool cauchy_2pset_is_empty(const cauchy_2pset_t* set);
 /* Merge another 2P-Set */
 cauchy_result_t cauchy_2pset_merge(cauchy_2pset_t* dst, const cauchy_2pset_t* src);
 
-/* Check equality */
+/* Join a delta into a replica, or into another delta to form a group */
+cauchy_result_t cauchy_2pset_merge_delta(cauchy_2pset_t* dst, const cauchy_2pset_t* delta);
+
+/* Merge both halves with cauchy_gset_merge_parallel. Unlike the serial
+ * merge, it also copies added elements that dst has already removed;
+ * cauchy_2pset_compact drops them later. The copies are then recounted
+ * with one pass over the tombstones. */
+cauchy_result_t cauchy_2pset_merge_parallel(cauchy_2pset_t* dst, const cauchy_2pset_t* src,
+                                            u32 parts, const cauchy_executor_t* exec);
+
+/* Fingerprint of the live elements and the tombstones, as
+ * cauchy_gset_fingerprint; compaction does not change it */
+u64 cauchy_2pset_fingerprint(const cauchy_2pset_t* set);
+
+/* Check equality: O(1) unless counts and fingerprints both match */
 bool cauchy_2pset_equals(const cauchy_2pset_t* a, const cauchy_2pset_t* b);
 
+/* Drop the added copies of removed elements, examining at most budget
+ * index slots per call and resuming where the last call stopped (0 = a
+ * full pass). The tombstones themselves stay: they are what keeps a
+ * removed element from ever being added again. Returns copies dropped. */
+usize cauchy_2pset_compact(cauchy_2pset_t* set, usize budget);
+
+/* Snapshot both halves into a CAUCHY_SNAPSHOT_2P_SET section, and load
+ * one into an empty set; lookups are then served from the mapping (see
+ * cauchy_gset_snapshot_attach) */
+cauchy_result_t cauchy_2pset_snapshot_save(const cauchy_2pset_t* set,
+                                           cauchy_snapshot_writer_t* w, u64 id);
+cauchy_result_t cauchy_2pset_snapshot_load(cauchy_2pset_t* set, cauchy_snapshot_t* snap, u64 id);
+
 /* Convenience for strings */
 cauchy_result_t cauchy_2pset_add_string(cauchy_2pset_t* set, const char* str);
 cauchy_result_t cauchy_2pset_remove_string(cauchy_2pset_t* set, const char* str);
@@ -13,21 +13,23 @@
 #include "../types.h"
 #include "../memory.h"
 #include "../vclock.h"
+#include "../snapshot.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-/* G-Counter structure - one count per node */
-typedef struct CAUCHY_CACHE_ALIGNED cauchy_gcounter {
-    u64 counts[CAUCHY_MAX_NODES];
-    u32 num_nodes;
-    u32 _padding;
-} cauchy_gcounter_t;
+/* G-Counter structure - one count per node. The per-node counts are
+ * exactly a vector clock, so the two share storage (sparse or dense) and
+ * kernels; see vclock.h for the layout and ownership rules. */
+typedef struct cauchy_vclock cauchy_gcounter_t;
 
 /* Initialize a G-Counter */
 void cauchy_gcounter_init(cauchy_gcounter_t* gc, u32 num_nodes);
 
+/* Release heap storage (for counters set up with init) */
+void cauchy_gcounter_fini(cauchy_gcounter_t* gc);
+
 /* Create a new G-Counter on heap */
 cauchy_gcounter_t* cauchy_gcounter_create(u32 num_nodes);
 
@@ -35,10 +37,18 @@ cauchy_gcounter_t* cauchy_gcounter_create(u32 num_nodes);
 void cauchy_gcounter_destroy(cauchy_gcounter_t* gc);
 
 /* Increment the counter for a specific node */
-void cauchy_gcounter_increment(cauchy_gcounter_t* gc, cauchy_node_id_t node_id);
+cauchy_result_t cauchy_gcounter_increment(cauchy_gcounter_t* gc, cauchy_node_id_t node_id);
 
 /* Increment by a specific amount */
-void cauchy_gcounter_add(cauchy_gcounter_t* gc, cauchy_node_id_t node_id, u64 delta);
+cauchy_result_t cauchy_gcounter_add(cauchy_gcounter_t* gc, cauchy_node_id_t node_id, u64 delta);
+
+/* Delta-state mutators: apply the update to gc and join the node's new
+ * count into delta. A delta is itself a G-Counter holding only the
+ * entries that changed, so shipping it replaces a full-state merge. */
+cauchy_result_t cauchy_gcounter_increment_delta(cauchy_gcounter_t* gc, cauchy_node_id_t node_id,
+                                                cauchy_gcounter_t* delta);
+cauchy_result_t cauchy_gcounter_add_delta(cauchy_gcounter_t* gc, cauchy_node_id_t node_id,
+                                          u64 amount, cauchy_gcounter_t* delta);
 
 /* Get the current value (sum of all node counts) */
 u64 cauchy_gcounter_value(const cauchy_gcounter_t* gc);
@@ -47,7 +57,10 @@ u64 cauchy_gcounter_value(const cauchy_gcounter_t* gc);
 u64 cauchy_gcounter_get(const cauchy_gcounter_t* gc, cauchy_node_id_t node_id);
 
 /* Merge another G-Counter into this one (element-wise maximum) */
-void cauchy_gcounter_merge(cauchy_gcounter_t* dst, const cauchy_gcounter_t* src);
+cauchy_result_t cauchy_gcounter_merge(cauchy_gcounter_t* dst, const cauchy_gcounter_t* src);
+
+/* Join a delta into a replica, or into another delta to form a group */
+cauchy_result_t cauchy_gcounter_merge_delta(cauchy_gcounter_t* dst, const cauchy_gcounter_t* delta);
 
 /* Check if two G-Counters have the same state */
 bool cauchy_gcounter_equals(const cauchy_gcounter_t* a, const cauchy_gcounter_t* b);
@@ -56,8 +69,8 @@ bool cauchy_gcounter_equals(const cauchy_gcounter_t* a, const cauchy_gcounter_t*
 cauchy_causality_t cauchy_gcounter_compare(const cauchy_gcounter_t* a,
                                             const cauchy_gcounter_t* b);
 
-/* Copy G-Counter state */
-void cauchy_gcounter_copy(cauchy_gcounter_t* dst, const cauchy_gcounter_t* src);
+/* Copy G-Counter state (dst is overwritten without being released) */
+cauchy_result_t cauchy_gcounter_copy(cauchy_gcounter_t* dst, const cauchy_gcounter_t* src);
 
 /* Clone a G-Counter */
 cauchy_gcounter_t* cauchy_gcounter_clone(const cauchy_gcounter_t* gc);
@@ -68,6 +81,90 @@ usize cauchy_gcounter_serialize(const cauchy_gcounter_t* gc, u8* buffer, usize s
 cauchy_result_t cauchy_gcounter_deserialize(cauchy_gcounter_t* gc, 
                                              const u8* buffer, usize size);
 
+/* Snapshot into a CAUCHY_SNAPSHOT_G_COUNTER section named id; loading
+ * replaces gc's counts */
+cauchy_result_t cauchy_gcounter_snapshot_save(const cauchy_gcounter_t* gc,
+                                              cauchy_snapshot_writer_t* w, u64 id);
+cauchy_result_t cauchy_gcounter_snapshot_load(cauchy_gcounter_t* gc, cauchy_snapshot_t* snap,
+                                              u64 id);
+
+/* Compact varint encoding, optionally as a delta against base (see vclock.h) */
+usize cauchy_gcounter_encoded_size(const cauchy_gcounter_t* gc, const cauchy_gcounter_t* base);
+usize cauchy_gcounter_encode(const cauchy_gcounter_t* gc, const cauchy_gcounter_t* base,
+                             u8* buffer, usize size);
+cauchy_result_t cauchy_gcounter_decode(cauchy_gcounter_t* gc, const cauchy_gcounter_t* base,
+                                       const u8* buffer, usize size, usize* consumed);
+
+/*
+ * Striped G-Counter: a replica whose local node is bumped from many
+ * threads. Each thread adds into its own cache-line stripe (picked by
+ * cauchy_thread_id) with one relaxed atomic add, so increments neither
+ * lock nor share a line. The stripes are folded into the node's slot of
+ * `counter` only when the count is needed: value, serialize, encode or
+ * merge go through cauchy_gcounter_striped_fold first, and then use the
+ * regular G-Counter functions on `counter`.
+ *
+ * Increments are safe from any thread. Folding and everything done with
+ * `counter` belong to one thread at a time, like a plain G-Counter.
+ */
+
+/* Stripes used when create is given 0 */
+#ifndef CAUCHY_COUNTER_STRIPES
+#define CAUCHY_COUNTER_STRIPES 16
+#endif
+
+typedef struct CAUCHY_CACHE_ALIGNED cauchy_counter_stripe {
+    cauchy_atomic_u64_t added;       /* Total this stripe has counted */
+    cauchy_atomic_u64_t removed;     /* PN-Counter decrements */
+} cauchy_counter_stripe_t;
+
+typedef struct cauchy_counter_stripes {
+    cauchy_counter_stripe_t* stripes;
+    u64*                     folded;        /* Per stripe: added, removed already drained */
+    u64                      pending_added; /* Drained but not yet in the counter */
+    u64                      pending_removed;
+    u32                      mask;          /* Stripe count - 1 */
+    cauchy_node_id_t         node_id;
+} cauchy_counter_stripes_t;
+
+typedef struct cauchy_gcounter_striped {
+    cauchy_gcounter_t        counter;
+    cauchy_counter_stripes_t local;
+} cauchy_gcounter_striped_t;
+
+/* Create a striped counter for local node_id. stripes is rounded up to a
+ * power of two; 0 picks CAUCHY_COUNTER_STRIPES. */
+cauchy_gcounter_striped_t* cauchy_gcounter_striped_create(u32 num_nodes, cauchy_node_id_t node_id,
+                                                          u32 stripes);
+
+/* Destroy a striped counter */
+void cauchy_gcounter_striped_destroy(cauchy_gcounter_striped_t* sc);
+
+/* Count for the local node; lock-free, from any thread */
+void cauchy_gcounter_striped_increment(cauchy_gcounter_striped_t* sc);
+void cauchy_gcounter_striped_add(cauchy_gcounter_striped_t* sc, u64 amount);
+
+/* Move what the stripes counted since the last fold into the local
+ * node's slot of sc->counter. If delta is non-NULL the new count is also
+ * joined into it, as with cauchy_gcounter_add_delta. Increments that race
+ * with a fold are kept for the next one. */
+cauchy_result_t cauchy_gcounter_striped_fold(cauchy_gcounter_striped_t* sc,
+                                             cauchy_gcounter_t* delta);
+
+/* Fold, then return the counter's value */
+u64 cauchy_gcounter_striped_value(cauchy_gcounter_striped_t* sc);
+
+/* Fold, then merge src into the counter */
+cauchy_result_t cauchy_gcounter_striped_merge(cauchy_gcounter_striped_t* sc,
+                                              const cauchy_gcounter_t* src);
+
+/* Internal: stripe set shared with the striped PN-Counter */
+cauchy_result_t cauchy_counter_stripes_init(cauchy_counter_stripes_t* cs, cauchy_node_id_t node_id,
+                                            u32 stripes);
+void cauchy_counter_stripes_fini(cauchy_counter_stripes_t* cs);
+cauchy_counter_stripe_t* cauchy_counter_stripes_local(cauchy_counter_stripes_t* cs);
+void cauchy_counter_stripes_drain(cauchy_counter_stripes_t* cs);
+
 /* Debug output */
 void cauchy_gcounter_debug_print(const cauchy_gcounter_t* gc, const char* label);
 
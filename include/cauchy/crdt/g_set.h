@@ -12,25 +12,44 @@
 
 #include "../types.h"
 #include "../memory.h"
+#include "../htable.h"
+#include "../merkle.h"
+#include "../snapshot.h"
+#include "../parallel.h"
+#include "../mvcc.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Elements up to this size are stored inside the element block */
+#define CAUCHY_GSET_INLINE_SIZE 48
+
 /* Element in the set */
 typedef struct cauchy_gset_elem {
-    u8*    data;
+    u8*    data;  /* Points at inline_data or into the set's arena */
     usize  size;
     u64    hash;  /* For fast comparison */
-    struct cauchy_gset_elem* next;
+    u8     inline_data[];
 } cauchy_gset_elem_t;
 
-/* G-Set structure */
+/* G-Set structure. A set loaded from a snapshot keeps the snapshot's
+ * elements in the mapped index (base) and only new elements on the heap;
+ * lookups consult both. Nothing is copied out of the base, since G-Set
+ * elements never change; prune marks base slots dropped instead. */
 typedef struct cauchy_gset {
-    cauchy_gset_elem_t** buckets;  /* Hash table buckets */
-    usize                num_buckets;
-    usize                count;
-    cauchy_pool_t*       elem_pool;
+    cauchy_htable_t index;      /* Open-addressing element index */
+    cauchy_pool_t*  elem_pool;
+    cauchy_arena_t  payloads;   /* Elements larger than the inline size */
+    cauchy_merkle_t* digest;    /* Anti-entropy digest, NULL until enabled */
+    u64              fingerprint; /* Sum of cauchy_merkle_item(hash), see below */
+    cauchy_snapshot_t*       snapshot;     /* Mapping holding base, or NULL */
+    cauchy_snapshot_index_t  base;         /* Elements served from the snapshot */
+    cauchy_snapshot_shadow_t base_dropped; /* Base slots pruned since loading */
+    usize                    base_count;   /* Base elements not dropped */
+    usize                    base_cursor;  /* Where prune resumes in the base */
+    cauchy_mvcc_t*           views;        /* Version log, NULL until enabled */
+    cauchy_atomic_u64_t*     base_died;    /* Version each base slot was dropped at, 0 if not */
 } cauchy_gset_t;
 
 /* Initialize a G-Set */
@@ -45,9 +64,30 @@ void cauchy_gset_destroy(cauchy_gset_t* set);
 /* Add an element to the set */
 cauchy_result_t cauchy_gset_add(cauchy_gset_t* set, const void* data, usize size);
 
+/* Delta-state add: add to set and, if the element is new, to delta.
+ * A delta is itself a G-Set; ship it instead of the full set. */
+cauchy_result_t cauchy_gset_add_delta(cauchy_gset_t* set, const void* data, usize size,
+                                      cauchy_gset_t* delta);
+
 /* Check if element exists */
 bool cauchy_gset_contains(const cauchy_gset_t* set, const void* data, usize size);
 
+/* Batch add and lookup over n byte strings. Each chunk of
+ * CAUCHY_HTABLE_BATCH items is hashed together and its index slots are
+ * prefetched before any probe, which hides most of the cache misses of
+ * a bulk load. add_batch stores each item's result in results (may be
+ * NULL) and returns the first failure, or CAUCHY_OK. contains_batch sets
+ * found[i] (may be NULL) and returns how many items are present. */
+cauchy_result_t cauchy_gset_add_batch(cauchy_gset_t* set, const cauchy_bytes_t* items, usize n,
+                                      cauchy_result_t* results);
+usize cauchy_gset_contains_batch(const cauchy_gset_t* set, const cauchy_bytes_t* items, usize n,
+                                 bool* found);
+
+/* Add and lookup with a precomputed h = cauchy_hash_bytes(data, size),
+ * for composite sets that hash once for several G-Sets */
+cauchy_result_t cauchy_gset_add_hashed(cauchy_gset_t* set, const void* data, usize size, u64 h);
+bool cauchy_gset_contains_hashed(const cauchy_gset_t* set, const void* data, usize size, u64 h);
+
 /* Get element count */
 usize cauchy_gset_count(const cauchy_gset_t* set);
 
@@ -57,27 +97,122 @@ bool cauchy_gset_is_empty(const cauchy_gset_t* set);
 /* Merge another set (union) */
 cauchy_result_t cauchy_gset_merge(cauchy_gset_t* dst, const cauchy_gset_t* src);
 
-/* Check equality */
+/* Join a delta into a replica, or into another delta to form a group.
+ * Cost is proportional to the delta, not to dst. */
+cauchy_result_t cauchy_gset_merge_delta(cauchy_gset_t* dst, const cauchy_gset_t* delta);
+
+/* Merge on `parts` threads (0 = one per CPU) through exec (NULL = the
+ * built-in executor). The source is split by the dst slot range each
+ * element's home falls in, and every range is merged by one task with
+ * no locks. Elements whose probe chain crosses a range boundary finish
+ * serially afterwards. Small sources take the serial merge. dst and its
+ * pool must not be used by other threads meanwhile. */
+cauchy_result_t cauchy_gset_merge_parallel(cauchy_gset_t* dst, const cauchy_gset_t* src,
+                                           u32 parts, const cauchy_executor_t* exec);
+
+/* Order-independent fingerprint of the elements, updated with every
+ * change: the root a digest of the set would have, enabled or not.
+ * Replicas whose counts and fingerprints match almost surely agree, so
+ * gossip can skip the sync; different fingerprints always mean
+ * different sets. */
+u64 cauchy_gset_fingerprint(const cauchy_gset_t* set);
+
+/* Check equality. Sets with different counts or fingerprints are told
+ * apart in O(1); only a match is confirmed element by element. */
 bool cauchy_gset_equals(const cauchy_gset_t* a, const cauchy_gset_t* b);
 
-/* Check if a is subset of b */
+/* Check if a is subset of b (O(1) when a is larger, or as large but with
+ * another fingerprint) */
 bool cauchy_gset_subset(const cauchy_gset_t* a, const cauchy_gset_t* b);
 
 /* Iterator */
 typedef struct cauchy_gset_iter {
     const cauchy_gset_t* set;
-    usize                bucket_idx;
-    cauchy_gset_elem_t*  current;
+    cauchy_htable_iter_t inner;
+    u64                  base_slot;  /* Next snapshot slot, once inner is done */
 } cauchy_gset_iter_t;
 
 void cauchy_gset_iter_init(cauchy_gset_iter_t* iter, const cauchy_gset_t* set);
 bool cauchy_gset_iter_next(cauchy_gset_iter_t* iter, const void** data, usize* size);
 
-/* Serialization */
+/* Maintain a Merkle digest of the elements from now on (depth 0 picks
+ * CAUCHY_MERKLE_DEFAULT_DEPTH). Existing elements are folded in once. */
+cauchy_result_t cauchy_gset_enable_digest(cauchy_gset_t* set, u32 depth);
+
+/* The maintained digest, or NULL if not enabled */
+const cauchy_merkle_t* cauchy_gset_digest(const cauchy_gset_t* set);
+
+/* Copy every element that falls in one of the given buckets (ascending,
+ * at the given digest depth) into out. Used to answer anti-entropy. */
+cauchy_result_t cauchy_gset_collect_buckets(const cauchy_gset_t* set, u32 depth,
+                                            const u64* buckets, usize count,
+                                            cauchy_gset_t* out);
+
+/* Drop the elements that `covered` also holds, examining at most budget
+ * index slots (version log records once views are enabled) from *cursor
+ * (0 = the rest of the table; *cursor wraps to 0 after a full pass), and
+ * as many slots of a snapshot base, from a cursor the set keeps itself.
+ * Not a G-Set operation: it exists for composite CRDTs whose other half
+ * dominates these elements, such as the removed half of a 2P-Set.
+ * Returns the number of elements dropped; dropped payloads above the
+ * inline size stay in the arena until destroy. */
+usize cauchy_gset_prune(cauchy_gset_t* set, const cauchy_gset_t* covered,
+                        usize* cursor, usize budget);
+
+/* Versioned views. Once enabled, every change is published as a new
+ * version, and a view pins the version current when it was opened: it
+ * iterates, counts, serializes and digests exactly that state on any
+ * thread, while the owner keeps adding, merging and pruning. Pruned
+ * elements are freed when no open view can still see them. Enable after
+ * any snapshot load (attaching to a set with views is CAUCHY_ERR_EXISTS).
+ * At most CAUCHY_MVCC_MAX_VIEWS views are open at once; a view must be
+ * closed before the set is destroyed. */
+typedef struct cauchy_gset_view {
+    cauchy_mvcc_view_t   inner;
+    const cauchy_gset_t* set;
+    u64                  base_slot;  /* Next snapshot slot, once inner is done */
+} cauchy_gset_view_t;
+
+cauchy_result_t cauchy_gset_enable_views(cauchy_gset_t* set);
+
+/* CAUCHY_ERR_INVALID if views are not enabled, CAUCHY_ERR_FULL if too
+ * many are open */
+cauchy_result_t cauchy_gset_view_open(const cauchy_gset_t* set, cauchy_gset_view_t* view);
+void cauchy_gset_view_close(cauchy_gset_view_t* view);
+bool cauchy_gset_view_next(cauchy_gset_view_t* view, const void** data, usize* size);
+void cauchy_gset_view_rewind(cauchy_gset_view_t* view);
+
+/* Count and fingerprint as of the view's version */
+usize cauchy_gset_view_count(const cauchy_gset_view_t* view);
+u64 cauchy_gset_view_fingerprint(const cauchy_gset_view_t* view);
+
+/* Same format as cauchy_gset_serialize; both rewind the view */
+usize cauchy_gset_view_serialized_size(cauchy_gset_view_t* view);
+usize cauchy_gset_view_serialize(cauchy_gset_view_t* view, u8* buffer, usize size);
+
+/* Build in out (uninitialized) the digest of the view's elements; depth
+ * 0 picks CAUCHY_MERKLE_DEFAULT_DEPTH. Rewinds the view. */
+cauchy_result_t cauchy_gset_view_digest(cauchy_gset_view_t* view, u32 depth, cauchy_merkle_t* out);
+
+/* Serialization: a u64 count, then a u64 size and the bytes of each
+ * element. serialize returns bytes written (0 if buffer is too small);
+ * deserialize adds the elements to set. */
 usize cauchy_gset_serialized_size(const cauchy_gset_t* set);
 usize cauchy_gset_serialize(const cauchy_gset_t* set, u8* buffer, usize size);
 cauchy_result_t cauchy_gset_deserialize(cauchy_gset_t* set, const u8* buffer, usize size);
 
+/* Snapshots. _put writes the fingerprint, then the elements as a frozen
+ * index, into the open section of w; _attach makes such an index, at data in snap, the base of
+ * an empty set (CAUCHY_ERR_EXISTS otherwise) and holds a reference to
+ * snap until destroy. _save and _load do the same for a whole
+ * CAUCHY_SNAPSHOT_G_SET section named id. */
+cauchy_result_t cauchy_gset_snapshot_put(const cauchy_gset_t* set, cauchy_snapshot_writer_t* w);
+cauchy_result_t cauchy_gset_snapshot_attach(cauchy_gset_t* set, cauchy_snapshot_t* snap,
+                                            const u8* data, usize size);
+cauchy_result_t cauchy_gset_snapshot_save(const cauchy_gset_t* set, cauchy_snapshot_writer_t* w,
+                                          u64 id);
+cauchy_result_t cauchy_gset_snapshot_load(cauchy_gset_t* set, cauchy_snapshot_t* snap, u64 id);
+
 /* Convenience for string sets */
 cauchy_result_t cauchy_gset_add_string(cauchy_gset_t* set, const char* str);
 bool cauchy_gset_contains_string(const cauchy_gset_t* set, const char* str);
@@ -0,0 +1,176 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * LWW-Map (Last-Write-Wins Map) CRDT
+ *
+ * A map from byte-string keys to LWW-Registers. Each key resolves
+ * conflicts on its own: the write with the higher timestamp wins, the
+ * node id breaks ties. A remove is a write of a tombstone, so it beats
+ * older sets and loses to newer ones, and merging is a per-key join.
+ *
+ * The key index is a split-ordered list (Shalev and Shavit 2006): one
+ * lock-free sorted list holding every key, ordered by the bit-reversed
+ * hash, with a lazily built bucket table of sentinel nodes pointing into
+ * it. Doubling the table never moves a key; new buckets are spliced in
+ * as they are first touched. Keys are never unlinked (a removed key keeps
+ * its tombstone), so list nodes live until the map is destroyed.
+ *
+ * A key's current value is an immutable version behind one atomic
+ * pointer. A winning write publishes a new version with a single CAS and
+ * retires the old one to the hazard pointer domain; readers protect the
+ * version they copy and never block or retry on writers. A large value
+ * is a shared blob, so copying it out only takes a reference. Any number of
+ * threads may read and write concurrently. Every operation holds at most
+ * one hazard, in slot CAUCHY_LWW_MAP_HAZARD_SLOT of the map's domain.
+ */
+
+#ifndef CAUCHY_CRDT_LWW_MAP_H
+#define CAUCHY_CRDT_LWW_MAP_H
+
+#include "../types.h"
+#include "../memory.h"
+#include "../atomic.h"
+#include "lww_register.h"
+#include "../snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Hazard slot used in the map's domain; the registers' by default, so a
+ * shared domain's low slots stay free for their other users */
+#ifndef CAUCHY_LWW_MAP_HAZARD_SLOT
+#define CAUCHY_LWW_MAP_HAZARD_SLOT CAUCHY_LWW_HAZARD_SLOT
+#endif
+
+/* Bucket table segments; segment i holds 2^i buckets */
+#define CAUCHY_LWW_MAP_SEGMENTS 40
+
+/* Average keys per bucket before the table doubles */
+#define CAUCHY_LWW_MAP_LOAD_FACTOR 2
+
+/* Immutable value version, replaced as a whole by winning writes */
+typedef struct cauchy_lww_map_version {
+    cauchy_lww_register_t reg;
+    bool                  removed;  /* Tombstone */
+} cauchy_lww_map_version_t;
+
+/* List node: a bucket sentinel (even order) or a key (odd order) */
+typedef struct cauchy_lww_map_node {
+    u64                 order;      /* Bit-reversed hash, the list's sort key */
+    cauchy_atomic_ptr_t next;
+    cauchy_atomic_ptr_t version;    /* Keys only */
+    u64                 hash;
+    usize               key_size;
+    u8                  key[];
+} cauchy_lww_map_node_t;
+
+typedef struct cauchy_lww_map {
+    cauchy_atomic_ptr_t     segments[CAUCHY_LWW_MAP_SEGMENTS];
+    cauchy_atomic_u64_t     bucket_count;   /* Power of two, only grows */
+    cauchy_atomic_u64_t     key_count;      /* Keys in the index, tombstones included */
+    cauchy_atomic_u64_t     live_count;     /* Keys whose version is not a tombstone */
+    cauchy_lww_map_node_t*  head;           /* Sentinel of bucket 0 */
+    cauchy_hazard_domain_t* domain;
+    bool                    owns_domain;
+} cauchy_lww_map_t;
+
+/* Create a map sized for about initial_capacity keys. Versions are
+ * retired to domain, or to a private domain when it is NULL. */
+cauchy_lww_map_t* cauchy_lww_map_create(usize initial_capacity,
+                                        cauchy_hazard_domain_t* domain);
+
+/* Destroy a map; no other thread may still be using it */
+void cauchy_lww_map_destroy(cauchy_lww_map_t* map);
+
+/* Write a value; a write that loses to the current version is a no-op */
+cauchy_result_t cauchy_lww_map_set(cauchy_lww_map_t* map,
+                                   const void* key, usize key_size,
+                                   const void* value, usize value_size,
+                                   cauchy_timestamp_t timestamp,
+                                   cauchy_node_id_t node_id);
+
+/* Write a tombstone under the same rules */
+cauchy_result_t cauchy_lww_map_remove(cauchy_lww_map_t* map,
+                                      const void* key, usize key_size,
+                                      cauchy_timestamp_t timestamp,
+                                      cauchy_node_id_t node_id);
+
+/* Delta-state mutators: when the write wins it is also joined into
+ * delta, which is itself a map. */
+cauchy_result_t cauchy_lww_map_set_delta(cauchy_lww_map_t* map,
+                                         const void* key, usize key_size,
+                                         const void* value, usize value_size,
+                                         cauchy_timestamp_t timestamp,
+                                         cauchy_node_id_t node_id,
+                                         cauchy_lww_map_t* delta);
+cauchy_result_t cauchy_lww_map_remove_delta(cauchy_lww_map_t* map,
+                                            const void* key, usize key_size,
+                                            cauchy_timestamp_t timestamp,
+                                            cauchy_node_id_t node_id,
+                                            cauchy_lww_map_t* delta);
+
+/* Copy the current value of key into out, an initialized register whose
+ * previous value is released; large values are shared, not copied.
+ * CAUCHY_ERR_NOTFOUND if the key was never written or its latest write
+ * is a remove. */
+cauchy_result_t cauchy_lww_map_get(const cauchy_lww_map_t* map,
+                                   const void* key, usize key_size,
+                                   cauchy_lww_register_t* out);
+
+/* Check if a key has a live value */
+bool cauchy_lww_map_contains(const cauchy_lww_map_t* map, const void* key, usize key_size);
+
+/* Keys with a live value */
+usize cauchy_lww_map_count(const cauchy_lww_map_t* map);
+
+/* Check if map has no live values */
+bool cauchy_lww_map_is_empty(const cauchy_lww_map_t* map);
+
+/* Merge another map (per-key last-write-wins, tombstones included) */
+cauchy_result_t cauchy_lww_map_merge(cauchy_lww_map_t* dst, const cauchy_lww_map_t* src);
+
+/* Join a delta into a replica, or into another delta to form a group */
+cauchy_result_t cauchy_lww_map_merge_delta(cauchy_lww_map_t* dst, const cauchy_lww_map_t* delta);
+
+/* Check equality (same live keys with the same winning writes) */
+bool cauchy_lww_map_equals(const cauchy_lww_map_t* a, const cauchy_lww_map_t* b);
+
+/* Iterator over live entries. Safe against concurrent writers: every key
+ * present when iteration starts is visited, with some value it held
+ * while the iterator passed it. */
+typedef struct cauchy_lww_map_iter {
+    const cauchy_lww_map_t*      map;
+    const cauchy_lww_map_node_t* node;
+} cauchy_lww_map_iter_t;
+
+/* value (may be NULL) is filled as by cauchy_lww_map_get */
+void cauchy_lww_map_iter_init(cauchy_lww_map_iter_t* iter, const cauchy_lww_map_t* map);
+bool cauchy_lww_map_iter_next(cauchy_lww_map_iter_t* iter,
+                              const void** key, usize* key_size,
+                              cauchy_lww_register_t* value);
+
+/* Convenience for strings (the terminator is not stored) */
+cauchy_result_t cauchy_lww_map_set_string(cauchy_lww_map_t* map, const char* key,
+                                          const char* value, cauchy_timestamp_t timestamp,
+                                          cauchy_node_id_t node_id);
+cauchy_result_t cauchy_lww_map_remove_string(cauchy_lww_map_t* map, const char* key,
+                                             cauchy_timestamp_t timestamp,
+                                             cauchy_node_id_t node_id);
+bool cauchy_lww_map_contains_string(const cauchy_lww_map_t* map, const char* key);
+
+/* Snapshot every key, tombstones included, into a CAUCHY_SNAPSHOT_LWW_MAP
+ * section named id; concurrent writers may run during the save. Loading
+ * joins the saved writes into map, as a merge would. */
+cauchy_result_t cauchy_lww_map_snapshot_save(const cauchy_lww_map_t* map,
+                                             cauchy_snapshot_writer_t* w, u64 id);
+cauchy_result_t cauchy_lww_map_snapshot_load(cauchy_lww_map_t* map, cauchy_snapshot_t* snap,
+                                             u64 id);
+
+/* Debug output */
+void cauchy_lww_map_debug_print(const cauchy_lww_map_t* map, const char* label);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_CRDT_LWW_MAP_H */
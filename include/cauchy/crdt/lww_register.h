@@ -4,6 +4,15 @@
  * 
  * Simple register that resolves conflicts by timestamp.
  * Later timestamp always wins. Requires loosely synchronized clocks.
+ *
+ * Small values live inside the register, which then fits one cache line.
+ * Larger ones go to an immutable, reference-counted blob that copies and
+ * merges share instead of duplicating, so a register holding a blob must
+ * be released with cauchy_lww_fini (or cauchy_lww_destroy).
+ *
+ * cauchy_lww_shared_t is the register for many threads: its state is an
+ * immutable register published through one atomic pointer, read under a
+ * hazard pointer and replaced by a single CAS when a write wins.
  */
 
 #ifndef CAUCHY_CRDT_LWW_REGISTER_H
@@ -11,40 +20,72 @@
 
 #include "../types.h"
 #include "../memory.h"
+#include "../atomic.h"
+#include "../snapshot.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Values up to this size are stored inline */
+#define CAUCHY_LWW_INLINE_SIZE 32
+
 /* Maximum value size in bytes */
 #ifndef CAUCHY_LWW_MAX_VALUE_SIZE
-#define CAUCHY_LWW_MAX_VALUE_SIZE 256
+#define CAUCHY_LWW_MAX_VALUE_SIZE (16u << 20)
+#endif
+
+/* Hazard slot shared registers use in their domain */
+#ifndef CAUCHY_LWW_HAZARD_SLOT
+#define CAUCHY_LWW_HAZARD_SLOT (CAUCHY_MAX_HAZARD_POINTERS - 1)
 #endif
 
+/* Out-of-line value, shared by every register holding it */
+typedef struct cauchy_lww_blob cauchy_lww_blob_t;
+
 /* LWW-Register structure */
 typedef struct CAUCHY_CACHE_ALIGNED cauchy_lww_register {
-    u8                  value[CAUCHY_LWW_MAX_VALUE_SIZE];
-    usize               value_size;
     cauchy_timestamp_t  timestamp;
     cauchy_node_id_t    node_id;  /* Tie-breaker when timestamps equal */
+    usize               value_size;
+    cauchy_lww_blob_t*  blob;     /* Set when value_size > CAUCHY_LWW_INLINE_SIZE */
+    u8                  inline_value[CAUCHY_LWW_INLINE_SIZE];
 } cauchy_lww_register_t;
 
 /* Initialize an empty LWW-Register */
 void cauchy_lww_init(cauchy_lww_register_t* reg);
 
+/* Release the value (blob reference included); the register is left empty */
+void cauchy_lww_fini(cauchy_lww_register_t* reg);
+
 /* Create a new LWW-Register on heap */
 cauchy_lww_register_t* cauchy_lww_create(void);
 
 /* Destroy a heap-allocated LWW-Register */
 void cauchy_lww_destroy(cauchy_lww_register_t* reg);
 
-/* Set the value with a timestamp */
+/* Set the value with a timestamp (CAUCHY_ERR_FULL above the maximum size) */
 cauchy_result_t cauchy_lww_set(cauchy_lww_register_t* reg,
                                const void* value,
                                usize value_size,
                                cauchy_timestamp_t timestamp,
                                cauchy_node_id_t node_id);
 
+/* Overwrite the state whatever the timestamps (building a replica's
+ * state, e.g. from a decoded value) */
+cauchy_result_t cauchy_lww_assign(cauchy_lww_register_t* reg,
+                                  const void* value, usize value_size,
+                                  cauchy_timestamp_t timestamp, cauchy_node_id_t node_id);
+
+/* Delta-state set: when the write wins, the register's new state is
+ * joined into delta. A delta is itself a register. */
+cauchy_result_t cauchy_lww_set_delta(cauchy_lww_register_t* reg,
+                                     const void* value,
+                                     usize value_size,
+                                     cauchy_timestamp_t timestamp,
+                                     cauchy_node_id_t node_id,
+                                     cauchy_lww_register_t* delta);
+
 /* Get the current value */
 const void* cauchy_lww_get(const cauchy_lww_register_t* reg, usize* out_size);
 
@@ -57,10 +98,13 @@ bool cauchy_lww_has_value(const cauchy_lww_register_t* reg);
 /* Merge another register (last-write-wins) */
 void cauchy_lww_merge(cauchy_lww_register_t* dst, const cauchy_lww_register_t* src);
 
+/* Join a delta into a replica, or into another delta to form a group */
+void cauchy_lww_merge_delta(cauchy_lww_register_t* dst, const cauchy_lww_register_t* delta);
+
 /* Check equality */
 bool cauchy_lww_equals(const cauchy_lww_register_t* a, const cauchy_lww_register_t* b);
 
-/* Copy state */
+/* Copy state; a blob is shared, not duplicated */
 void cauchy_lww_copy(cauchy_lww_register_t* dst, const cauchy_lww_register_t* src);
 
 /* Clone */
@@ -72,6 +116,13 @@ usize cauchy_lww_serialize(const cauchy_lww_register_t* reg, u8* buffer, usize s
 cauchy_result_t cauchy_lww_deserialize(cauchy_lww_register_t* reg,
                                         const u8* buffer, usize size);
 
+/* Snapshot into a CAUCHY_SNAPSHOT_LWW_REGISTER section named id; loading
+ * assigns the saved write, as cauchy_lww_deserialize does */
+cauchy_result_t cauchy_lww_snapshot_save(const cauchy_lww_register_t* reg,
+                                         cauchy_snapshot_writer_t* w, u64 id);
+cauchy_result_t cauchy_lww_snapshot_load(cauchy_lww_register_t* reg, cauchy_snapshot_t* snap,
+                                         u64 id);
+
 /* Debug output */
 void cauchy_lww_debug_print(const cauchy_lww_register_t* reg, const char* label);
 
@@ -84,6 +135,31 @@ cauchy_result_t cauchy_lww_set_string(cauchy_lww_register_t* reg, const char* va
                                       cauchy_timestamp_t ts, cauchy_node_id_t node);
 const char* cauchy_lww_get_string(const cauchy_lww_register_t* reg);
 
+/* Register shared between threads. Writers and readers may run
+ * concurrently; init and fini may not. */
+typedef struct cauchy_lww_shared {
+    cauchy_atomic_ptr_t     current;  /* Immutable cauchy_lww_register_t */
+    cauchy_hazard_domain_t* domain;
+} cauchy_lww_shared_t;
+
+cauchy_result_t cauchy_lww_shared_init(cauchy_lww_shared_t* shared,
+                                       cauchy_hazard_domain_t* domain);
+void cauchy_lww_shared_fini(cauchy_lww_shared_t* shared);
+
+/* Publish a write if it wins */
+cauchy_result_t cauchy_lww_shared_set(cauchy_lww_shared_t* shared,
+                                      const void* value, usize value_size,
+                                      cauchy_timestamp_t timestamp,
+                                      cauchy_node_id_t node_id);
+
+/* Publish src if it wins */
+cauchy_result_t cauchy_lww_shared_merge(cauchy_lww_shared_t* shared,
+                                        const cauchy_lww_register_t* src);
+
+/* Consistent snapshot of the current state into out (an initialized
+ * register, whose previous value is released) */
+void cauchy_lww_shared_read(const cauchy_lww_shared_t* shared, cauchy_lww_register_t* out);
+
 #ifdef __cplusplus
 }
 #endif
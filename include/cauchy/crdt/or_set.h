@@ -13,30 +13,57 @@
 
 #include "../types.h"
 #include "../memory.h"
+#include "../htable.h"
+#include "../merkle.h"
+#include "../vclock.h"
+#include "../snapshot.h"
+#include "../parallel.h"
+#include "../mvcc.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Elements up to this size are stored inside the entry block */
+#define CAUCHY_ORSET_INLINE_SIZE 48
+
 /* Tagged element in OR-Set */
 typedef struct cauchy_orset_entry {
-    u8*               data;
+    u8*               data;     /* Points at inline_data or into the arena */
     usize             size;
     u64               hash;
     cauchy_uid_t      tag;      /* Unique identifier for this add operation */
+    cauchy_uid_t      removed_by; /* Dot of the remove that tombstoned it */
     bool              removed;  /* Tombstone flag */
-    struct cauchy_orset_entry* next;
+    u32               view_slot; /* Version log record while active, if views are on */
+    u8                inline_data[];
 } cauchy_orset_entry_t;
 
-/* OR-Set structure */
+/* OR-Set structure. A set loaded from a snapshot reads the snapshot's
+ * entries in place from the mapped index (base). The first change to a
+ * base entry, a remove, copies it into the heap index and shadows its
+ * slot; collecting a base tombstone only shadows it. The counts cover
+ * both. */
 typedef struct cauchy_orset {
-    cauchy_orset_entry_t** buckets;
-    usize                  num_buckets;
+    cauchy_htable_t        index;        /* Entries keyed by element hash */
     usize                  entry_count;  /* Total entries including tombstones */
     usize                  active_count; /* Active (non-removed) entries */
     cauchy_pool_t*         entry_pool;
+    cauchy_arena_t         payloads;     /* Elements larger than the inline size */
     cauchy_node_id_t       node_id;
     cauchy_timestamp_t     timestamp;    /* For generating unique tags */
+    cauchy_merkle_t*       digest;       /* Anti-entropy digest, NULL until enabled */
+    u64                    fingerprint;  /* Root the digest would have */
+    u64                    live_fingerprint; /* Of the active entries' elements */
+    cauchy_vclock_t        clock;        /* Highest add/remove dot seen per node */
+    cauchy_vclock_t        stable;       /* Frontier tombstones were collected below */
+    usize                  gc_cursor;    /* Where the next incremental pass resumes */
+    cauchy_snapshot_t*       snapshot;    /* Mapping holding base, or NULL */
+    cauchy_snapshot_index_t  base;        /* Entries served from the snapshot */
+    cauchy_snapshot_shadow_t base_shadow; /* Base slots promoted or collected */
+    usize                    base_cursor; /* Where gc resumes in the base */
+    cauchy_mvcc_t*           views;       /* Version log, NULL until enabled */
+    cauchy_atomic_u64_t*     base_died;   /* Version each base slot went at, 0 if not */
 } cauchy_orset_t;
 
 /* Initialize an OR-Set */
@@ -55,9 +82,30 @@ cauchy_result_t cauchy_orset_add(cauchy_orset_t* set, const void* data, usize si
 /* Remove an element (marks all observed tags as removed) */
 cauchy_result_t cauchy_orset_remove(cauchy_orset_t* set, const void* data, usize size);
 
+/* Delta-state mutators: update set and join the affected tagged entries
+ * into delta, itself an OR-Set. An add contributes its new tag; a remove
+ * contributes a tombstone for every tag it observed. */
+cauchy_result_t cauchy_orset_add_delta(cauchy_orset_t* set, const void* data, usize size,
+                                       cauchy_orset_t* delta);
+cauchy_result_t cauchy_orset_remove_delta(cauchy_orset_t* set, const void* data, usize size,
+                                          cauchy_orset_t* delta);
+
 /* Check if element exists (any active tag) */
 bool cauchy_orset_contains(const cauchy_orset_t* set, const void* data, usize size);
 
+/* Batch add, remove and lookup over n byte strings, hashed and
+ * prefetched a chunk at a time (see cauchy_gset_add_batch). Adds and
+ * removes store each item's result in results (may be NULL; a remove of
+ * an absent item gives CAUCHY_ERR_NOTFOUND) and return the first
+ * failure, or CAUCHY_OK. contains_batch sets found[i] (may be NULL) and
+ * returns how many items are present. */
+cauchy_result_t cauchy_orset_add_batch(cauchy_orset_t* set, const cauchy_bytes_t* items, usize n,
+                                       cauchy_result_t* results);
+cauchy_result_t cauchy_orset_remove_batch(cauchy_orset_t* set, const cauchy_bytes_t* items,
+                                          usize n, cauchy_result_t* results);
+usize cauchy_orset_contains_batch(const cauchy_orset_t* set, const cauchy_bytes_t* items, usize n,
+                                  bool* found);
+
 /* Get count of unique active elements */
 usize cauchy_orset_count(const cauchy_orset_t* set);
 
@@ -67,28 +115,107 @@ bool cauchy_orset_is_empty(const cauchy_orset_t* set);
 /* Merge another OR-Set (add-wins semantics) */
 cauchy_result_t cauchy_orset_merge(cauchy_orset_t* dst, const cauchy_orset_t* src);
 
-/* Check equality */
+/* Join a delta into a replica, or into another delta to form a group.
+ * Cost is proportional to the delta, not to dst. */
+cauchy_result_t cauchy_orset_merge_delta(cauchy_orset_t* dst, const cauchy_orset_t* delta);
+
+/* Merge on `parts` threads (0 = one per CPU) through exec (NULL = the
+ * built-in executor), partitioned as cauchy_gset_merge_parallel. Joins
+ * that would copy a snapshot entry of dst into the heap finish serially
+ * afterwards. */
+cauchy_result_t cauchy_orset_merge_parallel(cauchy_orset_t* dst, const cauchy_orset_t* src,
+                                            u32 parts, const cauchy_executor_t* exec);
+
+/* Order-independent fingerprint of the whole state, updated with every
+ * change: the root a digest of the set would have, so it covers each
+ * entry's element, tag and add/remove state. Replicas with matching
+ * fingerprints almost surely hold the same entries, and a sync between
+ * them can be skipped. */
+u64 cauchy_orset_fingerprint(const cauchy_orset_t* set);
+
+/* Check equality of the active elements. Different counts, or different
+ * fingerprints of the active entries' elements, answer in O(1); only a
+ * match is confirmed element by element. */
 bool cauchy_orset_equals(const cauchy_orset_t* a, const cauchy_orset_t* b);
 
 /* Iterator for unique active elements */
 typedef struct cauchy_orset_iter {
     const cauchy_orset_t*    set;
-    usize                    bucket_idx;
-    cauchy_orset_entry_t*    current;
-    const void*              last_data;  /* To skip duplicate values */
-    usize                    last_size;
+    cauchy_htable_iter_t     inner;
+    u64                      base_slot;  /* Next snapshot slot, once inner is done */
 } cauchy_orset_iter_t;
 
 void cauchy_orset_iter_init(cauchy_orset_iter_t* iter, const cauchy_orset_t* set);
 bool cauchy_orset_iter_next(cauchy_orset_iter_t* iter, const void** data, usize* size);
 
+/* Versioned views of the active elements, as for cauchy_gset_view_t:
+ * a view iterates the elements, count and fingerprint of the state
+ * published when it was opened, on any thread, while the owner keeps
+ * adding, removing, merging and collecting. Every operation publishes
+ * once, so a view never sees half of a remove. Collected tombstones are
+ * freed once no open view is older. Enable after any snapshot load. */
+typedef struct cauchy_orset_view {
+    cauchy_mvcc_view_t    inner;
+    const cauchy_orset_t* set;
+    u64                   base_slot;
+} cauchy_orset_view_t;
+
+cauchy_result_t cauchy_orset_enable_views(cauchy_orset_t* set);
+cauchy_result_t cauchy_orset_view_open(const cauchy_orset_t* set, cauchy_orset_view_t* view);
+void cauchy_orset_view_close(cauchy_orset_view_t* view);
+bool cauchy_orset_view_next(cauchy_orset_view_t* view, const void** data, usize* size);
+void cauchy_orset_view_rewind(cauchy_orset_view_t* view);
+
+/* Active count and fingerprint of the active elements as of the view */
+usize cauchy_orset_view_count(const cauchy_orset_view_t* view);
+u64 cauchy_orset_view_fingerprint(const cauchy_orset_view_t* view);
+
+/* Maintain a Merkle digest over all entries, tombstones included, from
+ * now on (depth 0 picks CAUCHY_MERKLE_DEFAULT_DEPTH). Entries are
+ * bucketed by element hash and digested together with tag and state. */
+cauchy_result_t cauchy_orset_enable_digest(cauchy_orset_t* set, u32 depth);
+
+/* The maintained digest, or NULL if not enabled */
+const cauchy_merkle_t* cauchy_orset_digest(const cauchy_orset_t* set);
+
+/* Join every entry that falls in one of the given buckets (ascending,
+ * at the given digest depth) into out, which can then be applied with
+ * cauchy_orset_merge_delta. Used to answer anti-entropy. */
+cauchy_result_t cauchy_orset_collect_buckets(const cauchy_orset_t* set, u32 depth,
+                                             const u64* buckets, usize count,
+                                             cauchy_orset_t* out);
+
 /* Convenience for strings */
 cauchy_result_t cauchy_orset_add_string(cauchy_orset_t* set, const char* str);
 cauchy_result_t cauchy_orset_remove_string(cauchy_orset_t* set, const char* str);
 bool cauchy_orset_contains_string(const cauchy_orset_t* set, const char* str);
 
-/* Garbage collection: remove entries where all tags are tombstoned */
-usize cauchy_orset_gc(cauchy_orset_t* set);
+/* Adds and removes each take a dot (node id, timestamp) from the set's
+ * counter, and the clock records the highest dot merged from every node.
+ * The element-wise minimum of all replicas' clocks (cauchy_vclock_min) is
+ * a stable frontier once every replica has merged each node's operations
+ * up to it, which holds for full-state merges and causally delivered
+ * deltas but not for partial anti-entropy rounds alone. */
+const cauchy_vclock_t* cauchy_orset_clock(const cauchy_orset_t* set);
+
+/* Physically drop tombstones whose remove is covered by the stable
+ * frontier: every replica holds the tombstone, so none can reintroduce
+ * the tag. Merges afterwards ignore tags at or below the frontier that
+ * the set no longer holds. Examines at most `budget` index slots per
+ * call, resuming where the previous call stopped (0 = one full pass), so
+ * compaction can be interleaved with writes. Returns entries dropped;
+ * payloads above the inline size stay in the arena until destroy. */
+usize cauchy_orset_gc(cauchy_orset_t* set, const cauchy_vclock_t* stable, usize budget);
+
+/* Snapshot the set into a CAUCHY_SNAPSHOT_OR_SET section named id:
+ * counters, clock and stable frontier, then every entry, tombstones
+ * included, in a frozen index. Loading it into an empty set (else
+ * CAUCHY_ERR_EXISTS) maps the entries instead of inserting them and
+ * holds a reference to snap until destroy. The set keeps its node id;
+ * its counter resumes from the larger of the two. */
+cauchy_result_t cauchy_orset_snapshot_save(const cauchy_orset_t* set,
+                                           cauchy_snapshot_writer_t* w, u64 id);
+cauchy_result_t cauchy_orset_snapshot_load(cauchy_orset_t* set, cauchy_snapshot_t* snap, u64 id);
 
 /* Debug output */
 void cauchy_orset_debug_print(const cauchy_orset_t* set, const char* label);
@@ -0,0 +1,146 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * ORSWOT (Observed-Remove Set Without Tombstones) CRDT
+ *
+ * Same add-wins semantics as the OR-Set, with causality compressed into
+ * a dotted version vector. Each element is stored once, with the dots
+ * of the adds that currently support it (normally one). The set keeps a
+ * causal context of every dot it has observed. Re-adding an element
+ * replaces its dots instead of adding an entry, and a remove simply
+ * deletes the element: a replica that still has one of its dots
+ * recognises the removal because the dot is in our context but not in
+ * our set.
+ */
+
+#ifndef CAUCHY_CRDT_ORSWOT_H
+#define CAUCHY_CRDT_ORSWOT_H
+
+#include "../types.h"
+#include "../memory.h"
+#include "../htable.h"
+#include "../vclock.h"
+#include "../merkle.h"
+#include "../snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Elements up to this size are stored inside the entry block */
+#define CAUCHY_ORSWOT_INLINE_SIZE 48
+
+/* Causal context: a version vector for the contiguous prefix of each
+ * node's dots, plus the dots received out of order beyond it. Merged
+ * full states always have an empty cloud; deltas usually do not. */
+typedef struct cauchy_dot_context {
+    cauchy_vclock_t cc;
+    cauchy_uid_t*   cloud;          /* Sorted by node, then timestamp */
+    u32             cloud_count;
+    u32             cloud_capacity;
+} cauchy_dot_context_t;
+
+/* One element and the dots of the adds that support it */
+typedef struct cauchy_orswot_entry {
+    u8*           data;         /* Points at inline_data or into the arena */
+    usize         size;
+    u64           hash;
+    cauchy_uid_t* dots;         /* &first, or a heap array after concurrent adds */
+    u32           dot_count;
+    u32           dot_capacity;
+    cauchy_uid_t  first;
+    u8            inline_data[];
+} cauchy_orswot_entry_t;
+
+typedef struct cauchy_orswot {
+    cauchy_htable_t       index;        /* Entries keyed by element hash */
+    usize                 active_count; /* Entries with at least one dot */
+    u64                   fingerprint;  /* Sum of cauchy_merkle_item(hash) over those */
+    cauchy_pool_t*        entry_pool;
+    cauchy_arena_t        payloads;     /* Elements larger than the inline size */
+    cauchy_node_id_t      node_id;
+    cauchy_dot_context_t  context;
+    bool                  is_delta;     /* Keeps dotless entries as removal hints */
+} cauchy_orswot_t;
+
+/* Initialize an ORSWOT */
+cauchy_result_t cauchy_orswot_init(cauchy_orswot_t* set, usize initial_capacity,
+                                   cauchy_node_id_t node_id);
+
+/* Create a new ORSWOT on heap */
+cauchy_orswot_t* cauchy_orswot_create(usize initial_capacity, cauchy_node_id_t node_id);
+
+/* Destroy an ORSWOT */
+void cauchy_orswot_destroy(cauchy_orswot_t* set);
+
+/* Add an element (supersedes every dot this replica observed for it) */
+cauchy_result_t cauchy_orswot_add(cauchy_orswot_t* set, const void* data, usize size);
+
+/* Remove an element; nothing is left behind */
+cauchy_result_t cauchy_orswot_remove(cauchy_orswot_t* set, const void* data, usize size);
+
+/* Delta-state mutators: update set and join the change into delta, which
+ * becomes a delta (removes travel as dotless entries naming the element
+ * plus the removed dots in the delta's context). */
+cauchy_result_t cauchy_orswot_add_delta(cauchy_orswot_t* set, const void* data, usize size,
+                                        cauchy_orswot_t* delta);
+cauchy_result_t cauchy_orswot_remove_delta(cauchy_orswot_t* set, const void* data, usize size,
+                                           cauchy_orswot_t* delta);
+
+/* Check if element exists */
+bool cauchy_orswot_contains(const cauchy_orswot_t* set, const void* data, usize size);
+
+/* Get count of elements */
+usize cauchy_orswot_count(const cauchy_orswot_t* set);
+
+/* Check if set is empty */
+bool cauchy_orswot_is_empty(const cauchy_orswot_t* set);
+
+/* Merge another ORSWOT: a dot survives if both sides hold it or the side
+ * lacking it has never seen it */
+cauchy_result_t cauchy_orswot_merge(cauchy_orswot_t* dst, const cauchy_orswot_t* src);
+
+/* Join a delta into a replica, or into another delta to form a group.
+ * Cost is proportional to the delta; a full state falls back to merge. */
+cauchy_result_t cauchy_orswot_merge_delta(cauchy_orswot_t* dst, const cauchy_orswot_t* delta);
+
+/* Order-independent fingerprint of the elements, as
+ * cauchy_gset_fingerprint. It ignores dots: replicas that also have the
+ * same clock can skip a sync. */
+u64 cauchy_orswot_fingerprint(const cauchy_orswot_t* set);
+
+/* Check equality (same elements). Different counts or fingerprints
+ * answer in O(1); only a match is confirmed element by element. */
+bool cauchy_orswot_equals(const cauchy_orswot_t* a, const cauchy_orswot_t* b);
+
+/* Contiguous part of the causal context */
+const cauchy_vclock_t* cauchy_orswot_clock(const cauchy_orswot_t* set);
+
+/* Iterator over elements */
+typedef struct cauchy_orswot_iter {
+    const cauchy_orswot_t* set;
+    cauchy_htable_iter_t   inner;
+} cauchy_orswot_iter_t;
+
+void cauchy_orswot_iter_init(cauchy_orswot_iter_t* iter, const cauchy_orswot_t* set);
+bool cauchy_orswot_iter_next(cauchy_orswot_iter_t* iter, const void** data, usize* size);
+
+/* Convenience for strings */
+cauchy_result_t cauchy_orswot_add_string(cauchy_orswot_t* set, const char* str);
+cauchy_result_t cauchy_orswot_remove_string(cauchy_orswot_t* set, const char* str);
+bool cauchy_orswot_contains_string(const cauchy_orswot_t* set, const char* str);
+
+/* Snapshot the set into a CAUCHY_SNAPSHOT_ORSWOT section named id, and
+ * load one into an empty set (else CAUCHY_ERR_EXISTS). Entries are
+ * copied out on load; a failed load leaves the set unchanged. */
+cauchy_result_t cauchy_orswot_snapshot_save(const cauchy_orswot_t* set,
+                                            cauchy_snapshot_writer_t* w, u64 id);
+cauchy_result_t cauchy_orswot_snapshot_load(cauchy_orswot_t* set, cauchy_snapshot_t* snap, u64 id);
+
+/* Debug output */
+void cauchy_orswot_debug_print(const cauchy_orswot_t* set, const char* label);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_CRDT_ORSWOT_H */
@@ -25,20 +25,23 @@ typedef struct CAUCHY_CACHE_ALIGNED cauchy_pncounter {
 /* Initialize a PN-Counter */
 void cauchy_pncounter_init(cauchy_pncounter_t* pn, u32 num_nodes);
 
+/* Release heap storage (for counters set up with init) */
+void cauchy_pncounter_fini(cauchy_pncounter_t* pn);
+
 /* Create a new PN-Counter on heap */
 cauchy_pncounter_t* cauchy_pncounter_create(u32 num_nodes);
 
 /* Destroy a heap-allocated PN-Counter */
 void cauchy_pncounter_destroy(cauchy_pncounter_t* pn);
 
-/* Increment the counter */
-void cauchy_pncounter_increment(cauchy_pncounter_t* pn, cauchy_node_id_t node_id);
+/* Increment the counter (CAUCHY_ERR_NOMEM if a sparse clock cannot grow) */
+cauchy_result_t cauchy_pncounter_increment(cauchy_pncounter_t* pn, cauchy_node_id_t node_id);
 
 /* Decrement the counter */
-void cauchy_pncounter_decrement(cauchy_pncounter_t* pn, cauchy_node_id_t node_id);
+cauchy_result_t cauchy_pncounter_decrement(cauchy_pncounter_t* pn, cauchy_node_id_t node_id);
 
-/* Add a positive delta */
-void cauchy_pncounter_add(cauchy_pncounter_t* pn, cauchy_node_id_t node_id, i64 delta);
+/* Add a delta, negative to decrement */
+cauchy_result_t cauchy_pncounter_add(cauchy_pncounter_t* pn, cauchy_node_id_t node_id, i64 delta);
 
 /* Get the current value (can be negative) */
 i64 cauchy_pncounter_value(const cauchy_pncounter_t* pn);
@@ -49,14 +52,28 @@ u64 cauchy_pncounter_positive(const cauchy_pncounter_t* pn);
 /* Get negative sum */
 u64 cauchy_pncounter_negative(const cauchy_pncounter_t* pn);
 
-/* Merge another PN-Counter */
-void cauchy_pncounter_merge(cauchy_pncounter_t* dst, const cauchy_pncounter_t* src);
+/* Delta-state mutators: update pn and join the changed per-node counts
+ * into delta, itself a PN-Counter (see cauchy_gcounter_add_delta) */
+cauchy_result_t cauchy_pncounter_increment_delta(cauchy_pncounter_t* pn, cauchy_node_id_t node_id,
+                                                 cauchy_pncounter_t* delta);
+cauchy_result_t cauchy_pncounter_decrement_delta(cauchy_pncounter_t* pn, cauchy_node_id_t node_id,
+                                                 cauchy_pncounter_t* delta);
+cauchy_result_t cauchy_pncounter_add_delta(cauchy_pncounter_t* pn, cauchy_node_id_t node_id,
+                                           i64 amount, cauchy_pncounter_t* delta);
+
+/* Join a delta into a replica, or into another delta to form a group */
+cauchy_result_t cauchy_pncounter_merge_delta(cauchy_pncounter_t* dst, const cauchy_pncounter_t* delta);
+
+/* Merge another PN-Counter. On failure (CAUCHY_ERR_NOMEM) dst may hold
+ * part of src; merging again completes it. */
+cauchy_result_t cauchy_pncounter_merge(cauchy_pncounter_t* dst, const cauchy_pncounter_t* src);
 
 /* Check equality */
 bool cauchy_pncounter_equals(const cauchy_pncounter_t* a, const cauchy_pncounter_t* b);
 
-/* Copy state */
-void cauchy_pncounter_copy(cauchy_pncounter_t* dst, const cauchy_pncounter_t* src);
+/* Copy state. dst is overwritten without being released, so call
+ * cauchy_pncounter_fini first on a counter in use. */
+cauchy_result_t cauchy_pncounter_copy(cauchy_pncounter_t* dst, const cauchy_pncounter_t* src);
 
 /* Clone */
 cauchy_pncounter_t* cauchy_pncounter_clone(const cauchy_pncounter_t* pn);
@@ -64,9 +81,55 @@ cauchy_pncounter_t* cauchy_pncounter_clone(const cauchy_pncounter_t* pn);
 /* Serialization */
 usize cauchy_pncounter_serialized_size(const cauchy_pncounter_t* pn);
 usize cauchy_pncounter_serialize(const cauchy_pncounter_t* pn, u8* buffer, usize size);
+/* pn is overwritten only on success, without being released */
 cauchy_result_t cauchy_pncounter_deserialize(cauchy_pncounter_t* pn,
                                               const u8* buffer, usize size);
 
+/* Snapshot into a CAUCHY_SNAPSHOT_PN_COUNTER section named id; loading
+ * replaces pn's counts */
+cauchy_result_t cauchy_pncounter_snapshot_save(const cauchy_pncounter_t* pn,
+                                               cauchy_snapshot_writer_t* w, u64 id);
+cauchy_result_t cauchy_pncounter_snapshot_load(cauchy_pncounter_t* pn, cauchy_snapshot_t* snap,
+                                               u64 id);
+
+/* Compact encoding: positive then negative counter, each as in
+ * cauchy_gcounter_encode. base may be NULL for a full encoding. */
+usize cauchy_pncounter_encoded_size(const cauchy_pncounter_t* pn, const cauchy_pncounter_t* base);
+usize cauchy_pncounter_encode(const cauchy_pncounter_t* pn, const cauchy_pncounter_t* base,
+                              u8* buffer, usize size);
+cauchy_result_t cauchy_pncounter_decode(cauchy_pncounter_t* pn, const cauchy_pncounter_t* base,
+                                        const u8* buffer, usize size, usize* consumed);
+
+/* Striped PN-Counter: as cauchy_gcounter_striped_t, with increments and
+ * decrements kept side by side in each thread's stripe */
+typedef struct cauchy_pncounter_striped {
+    cauchy_pncounter_t       counter;
+    cauchy_counter_stripes_t local;
+} cauchy_pncounter_striped_t;
+
+/* Create a striped PN-Counter for local node_id (stripes as for
+ * cauchy_gcounter_striped_create) */
+cauchy_pncounter_striped_t* cauchy_pncounter_striped_create(u32 num_nodes, cauchy_node_id_t node_id,
+                                                            u32 stripes);
+
+/* Destroy a striped PN-Counter */
+void cauchy_pncounter_striped_destroy(cauchy_pncounter_striped_t* sc);
+
+/* Count for the local node; lock-free, from any thread */
+void cauchy_pncounter_striped_add(cauchy_pncounter_striped_t* sc, i64 amount);
+
+/* Fold the stripes into sc->counter, optionally joining the changed
+ * counts into delta (see cauchy_gcounter_striped_fold) */
+cauchy_result_t cauchy_pncounter_striped_fold(cauchy_pncounter_striped_t* sc,
+                                              cauchy_pncounter_t* delta);
+
+/* Fold, then return the counter's value */
+i64 cauchy_pncounter_striped_value(cauchy_pncounter_striped_t* sc);
+
+/* Fold, then merge src into the counter */
+cauchy_result_t cauchy_pncounter_striped_merge(cauchy_pncounter_striped_t* sc,
+                                               const cauchy_pncounter_t* src);
+
 /* Debug output */
 void cauchy_pncounter_debug_print(const cauchy_pncounter_t* pn, const char* label);
 
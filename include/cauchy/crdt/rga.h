@@ -0,0 +1,156 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * RGA (Replicated Growable Array) CRDT
+ *
+ * A sequence of bytes for collaborative editing (Roh et al. 2011). Every
+ * element has a unique id: a Lamport timestamp plus the inserting node.
+ * An insert names the element it follows; a replica places it right
+ * after that element, past any elements already there with a greater
+ * id (see cauchy_uid_compare). Deleted elements stay as tombstones so
+ * later inserts can still name them.
+ *
+ * Consecutive inserts by one node get consecutive timestamps, so a run
+ * of typing is stored as one block: a range of ids plus their bytes.
+ * Blocks are kept twice over in treaps: in document order, where each
+ * subtree knows its element and visible counts (index <-> block in
+ * O(log n)), and by (node, first timestamp), which finds the block
+ * holding any id in O(log n). Blocks split when an edit lands in their
+ * middle. Typing at the end of one's own block appends in place.
+ *
+ * RGA is operation-based: each local edit yields ops to ship, and
+ * replicas converge once every op is applied in causal order, i.e. an
+ * insert after its reference and a delete after the insert it targets.
+ * Out-of-order ops are refused with CAUCHY_ERR_CAUSAL; re-applying an op
+ * is harmless. Not thread-safe.
+ */
+
+#ifndef CAUCHY_CRDT_RGA_H
+#define CAUCHY_CRDT_RGA_H
+
+#include "../types.h"
+#include "../memory.h"
+#include "../snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Block contents up to this size are stored inside the block */
+#define CAUCHY_RGA_INLINE_SIZE 24
+
+typedef enum cauchy_rga_op_type {
+    CAUCHY_RGA_OP_INSERT = 1,
+    CAUCHY_RGA_OP_DELETE = 2
+} cauchy_rga_op_type_t;
+
+/* A run of len elements with ids (id.node_id, id.timestamp + i). An
+ * insert run follows ref ({0, 0} for the start of the document). */
+typedef struct cauchy_rga_op {
+    cauchy_rga_op_type_t type;
+    cauchy_uid_t         id;
+    cauchy_uid_t         ref;     /* Inserts only */
+    usize                len;
+    const u8*            data;    /* Inserts only: len bytes, not owned */
+} cauchy_rga_op_t;
+
+/* Receives the ops a local edit produced; op->data is valid for the call */
+typedef void (*cauchy_rga_emit_fn)(void* arg, const cauchy_rga_op_t* op);
+
+typedef struct cauchy_rga_block cauchy_rga_block_t;
+
+struct cauchy_rga_block {
+    /* Document order treap */
+    cauchy_rga_block_t* left;
+    cauchy_rga_block_t* right;
+    cauchy_rga_block_t* parent;
+    usize               sub_count;    /* Elements in this subtree, tombstones included */
+    usize               sub_visible;  /* Live elements in this subtree */
+    /* Id treap, keyed by (node_id, timestamp) */
+    cauchy_rga_block_t* id_left;
+    cauchy_rga_block_t* id_right;
+    u64                 priority;     /* Heap key shared by both treaps */
+
+    cauchy_uid_t        id;           /* First element */
+    usize               len;
+    usize               capacity;
+    bool                deleted;
+    u8*                 data;         /* inline_data or heap */
+    u8                  inline_data[CAUCHY_RGA_INLINE_SIZE];
+};
+
+typedef struct cauchy_rga {
+    cauchy_rga_block_t* root;         /* Document order */
+    cauchy_rga_block_t* id_root;
+    cauchy_pool_t*      block_pool;
+    cauchy_node_id_t    node_id;
+    cauchy_timestamp_t  clock;        /* Highest timestamp seen */
+    usize               block_count;
+    u64                 rng;
+    /* Typing cache: visible index just past the last local insert */
+    cauchy_rga_block_t* cursor;
+    usize               cursor_index;
+} cauchy_rga_t;
+
+/* Create an empty sequence for node_id (must not be 0) */
+cauchy_rga_t* cauchy_rga_create(cauchy_node_id_t node_id);
+
+/* Destroy a sequence */
+void cauchy_rga_destroy(cauchy_rga_t* rga);
+
+/* Insert len bytes before visible index (index == length appends) */
+cauchy_result_t cauchy_rga_insert(cauchy_rga_t* rga, usize index,
+                                  const void* data, usize len,
+                                  cauchy_rga_emit_fn emit, void* arg);
+
+/* Delete len visible elements starting at index; one op per id run */
+cauchy_result_t cauchy_rga_delete(cauchy_rga_t* rga, usize index, usize len,
+                                  cauchy_rga_emit_fn emit, void* arg);
+
+/* Apply an op from another replica */
+cauchy_result_t cauchy_rga_apply(cauchy_rga_t* rga, const cauchy_rga_op_t* op);
+
+/* Number of visible elements */
+usize cauchy_rga_length(const cauchy_rga_t* rga);
+
+/* Copy up to size visible bytes starting at index; returns bytes copied */
+usize cauchy_rga_read(const cauchy_rga_t* rga, usize index, void* buffer, usize size);
+
+/* Id of the visible element at index, for cursors that survive edits */
+cauchy_result_t cauchy_rga_id_at(const cauchy_rga_t* rga, usize index, cauchy_uid_t* out);
+
+/* Visible index of an element; a tombstone maps to the index of the next
+ * live element. CAUCHY_ERR_NOTFOUND for unknown ids. */
+cauchy_result_t cauchy_rga_index_of(const cauchy_rga_t* rga, const cauchy_uid_t* id,
+                                    usize* out);
+
+/* Check equality (same visible contents) */
+bool cauchy_rga_equals(const cauchy_rga_t* a, const cauchy_rga_t* b);
+
+/* Op wire format: u8 type, varint node, varint timestamp, varint len,
+ * then for inserts varint ref node, varint ref timestamp and the bytes */
+usize cauchy_rga_op_encoded_size(const cauchy_rga_op_t* op);
+
+/* Returns bytes written, or 0 if the buffer is too small */
+usize cauchy_rga_op_encode(const cauchy_rga_op_t* op, u8* buffer, usize size);
+
+/* op->data points into buffer. On success *consumed (if non-NULL) holds
+ * the bytes read. */
+cauchy_result_t cauchy_rga_op_decode(cauchy_rga_op_t* op, const u8* buffer, usize size,
+                                     usize* consumed);
+
+/* Snapshot the sequence, tombstones included, into a CAUCHY_SNAPSHOT_RGA
+ * section named id, and load one into an empty sequence (else
+ * CAUCHY_ERR_EXISTS). A section with overlapping ids or a clock behind
+ * its elements is CAUCHY_ERR_INVALID; a failed load leaves it empty. */
+cauchy_result_t cauchy_rga_snapshot_save(const cauchy_rga_t* rga, cauchy_snapshot_writer_t* w,
+                                         u64 id);
+cauchy_result_t cauchy_rga_snapshot_load(cauchy_rga_t* rga, cauchy_snapshot_t* snap, u64 id);
+
+/* Debug output */
+void cauchy_rga_debug_print(const cauchy_rga_t* rga, const char* label);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_CRDT_RGA_H */
@@ -0,0 +1,139 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Sharded Object Store
+ *
+ * A keyspace of named CRDT objects (G-Counters, PN-Counters and
+ * LWW-Registers) for one node. Names are hashed to one of a fixed set of
+ * shards. Each shard owns its index, object pool, name arena and
+ * version counter, and nothing in a shard is shared with the others.
+ *
+ * Writers on any thread never touch shard state. An op is copied into
+ * the owning shard's queue, a bounded lock-free ring whose cells hold
+ * the op inline, so submitting allocates nothing unless the op is
+ * larger than a cell. One thread at a time applies a shard's queue
+ * (cauchy_store_poll). A deployment usually pins one worker per shard
+ * or per group of shards, so shards scale with cores.
+ *
+ * Shards are combined only when a node view is needed. The store clock
+ * has one entry per shard: entry s + 1 is the version of shard s, which
+ * grows with every change. cauchy_store_visit walks the objects that
+ * changed since a clock a peer was sent earlier, so gossip ships only
+ * those. cauchy_store_merge joins a peer's object back in.
+ */
+
+#ifndef CAUCHY_CRDT_STORE_H
+#define CAUCHY_CRDT_STORE_H
+
+#include "../cauchy.h"
+#include "../htable.h"
+#include "g_counter.h"
+#include "pn_counter.h"
+#include "lww_register.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CAUCHY_STORE_MAX_SHARDS 1024
+
+/* Bytes of name and value a queue cell holds inline */
+#define CAUCHY_STORE_CELL_INLINE 88
+
+typedef struct cauchy_store_config {
+    u32   shards;            /* 0 = one per online CPU */
+    u32   queue_capacity;    /* Ops queued per shard, rounded up to a power of two */
+    usize initial_objects;   /* Index capacity per shard */
+} cauchy_store_config_t;
+
+#define CAUCHY_STORE_CONFIG_DEFAULT { \
+    .shards = 0,                      \
+    .queue_capacity = 4096,           \
+    .initial_objects = 1024           \
+}
+
+/* One named object. The name is not NUL-terminated. */
+typedef struct cauchy_store_object {
+    union {
+        cauchy_gcounter_t     gcounter;
+        cauchy_pncounter_t    pncounter;
+        cauchy_lww_register_t lww;
+    } as;
+    const u8*          name;
+    usize              name_size;
+    u64                hash;
+    u64                version;   /* Shard version of its last change */
+    cauchy_crdt_type_t type;
+} cauchy_store_object_t;
+
+typedef struct cauchy_store_stats {
+    u64 submitted;    /* Ops queued */
+    u64 applied;      /* Ops applied by polls */
+    u64 rejected;     /* Ops that failed, e.g. a name holding another type */
+    u64 full;         /* Submits refused by a full queue */
+    usize objects;
+} cauchy_store_stats_t;
+
+typedef struct cauchy_store cauchy_store_t;
+
+/* Store for ctx's node (config may be NULL for the defaults). Counter
+ * ops count for ctx->node_id and registers break ties with it. */
+cauchy_store_t* cauchy_store_create(const cauchy_context_t* ctx,
+                                    const cauchy_store_config_t* config);
+
+/* Destroy the store; ops still queued are dropped */
+void cauchy_store_destroy(cauchy_store_t* store);
+
+u32 cauchy_store_shard_count(const cauchy_store_t* store);
+
+/* Shard that owns a name */
+u32 cauchy_store_shard_of(const cauchy_store_t* store, const void* name, usize size);
+
+/* Queue an op from any thread. add applies delta to the counter named
+ * (type G-Counter, delta >= 0, or PN-Counter); set assigns an LWW
+ * register. The object is created on first use. A name holding another
+ * type rejects the op when applied. CAUCHY_ERR_FULL when the queue is
+ * full: poll the shard, or retry later. */
+cauchy_result_t cauchy_store_add(cauchy_store_t* store, const void* name, usize size,
+                                 cauchy_crdt_type_t type, i64 delta);
+cauchy_result_t cauchy_store_set(cauchy_store_t* store, const void* name, usize size,
+                                 const void* value, usize value_size,
+                                 cauchy_timestamp_t timestamp);
+
+/* Apply up to budget queued ops of one shard (0 = all). Returns the ops
+ * applied, or 0 if another thread holds the shard. */
+usize cauchy_store_poll(cauchy_store_t* store, u32 shard, usize budget);
+
+/* Poll every shard until its queue is empty; returns ops applied */
+usize cauchy_store_flush(cauchy_store_t* store);
+
+/* Callback over objects. The object belongs to a held shard and is
+ * valid only during the call; the callback must not call back into the
+ * store. */
+typedef void (*cauchy_store_visit_fn)(void* arg, const cauchy_store_object_t* object);
+
+/* Call fn on the object named, holding its shard (waits for a poll in
+ * progress). Queued ops are not applied first. CAUCHY_ERR_NOTFOUND if
+ * there is no such object. */
+cauchy_result_t cauchy_store_get(cauchy_store_t* store, const void* name, usize size,
+                                 cauchy_store_visit_fn fn, void* arg);
+
+/* Call fn on every object changed after the store clock since (NULL for
+ * all), shard by shard */
+void cauchy_store_visit(cauchy_store_t* store, const cauchy_vclock_t* since,
+                        cauchy_store_visit_fn fn, void* arg);
+
+/* Join a peer's object into the one of the same name, creating it if
+ * needed. CAUCHY_ERR_INVALID if the local object has another type. */
+cauchy_result_t cauchy_store_merge(cauchy_store_t* store, const cauchy_store_object_t* remote);
+
+/* Store clock: entry s + 1 is the version of shard s (out is
+ * overwritten, see cauchy_vclock_init) */
+cauchy_result_t cauchy_store_clock(const cauchy_store_t* store, cauchy_vclock_t* out);
+
+cauchy_store_stats_t cauchy_store_get_stats(const cauchy_store_t* store);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_CRDT_STORE_H */
@@ -0,0 +1,214 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Open-Addressing Hash Index
+ *
+ * Flat linear-probing table shared by the set CRDTs. Each slot keeps the
+ * full 64-bit hash inline next to the item pointer, so a probe touches
+ * contiguous memory and only dereferences items whose hash matches.
+ * Growth is incremental: a resize allocates the new array and every
+ * subsequent mutation migrates a few old slots, so no single operation
+ * pays for a full rehash.
+ */
+
+#ifndef CAUCHY_HTABLE_H
+#define CAUCHY_HTABLE_H
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Minimum old slots migrated per mutating operation during a resize */
+#ifndef CAUCHY_HTABLE_MIGRATE_STEP
+#define CAUCHY_HTABLE_MIGRATE_STEP 16
+#endif
+
+/* Minimum table capacity (power of two) */
+#define CAUCHY_HTABLE_MIN_CAPACITY 16
+
+/* Slot hash values reserved for empty and deleted slots */
+#define CAUCHY_HTABLE_EMPTY     0ULL
+#define CAUCHY_HTABLE_TOMBSTONE 1ULL
+
+/* Items hashed and prefetched ahead of use by the batch set operations */
+#ifndef CAUCHY_HTABLE_BATCH
+#define CAUCHY_HTABLE_BATCH 16
+#endif
+
+/* A byte string, as passed to the batch operations */
+typedef struct cauchy_bytes {
+    const void* data;
+    usize       size;
+} cauchy_bytes_t;
+
+/* One slot: inline hash plus item pointer */
+typedef struct cauchy_htable_slot {
+    u64   hash;
+    void* item;
+} cauchy_htable_slot_t;
+
+/* One flat slot array */
+typedef struct cauchy_htable_array {
+    cauchy_htable_slot_t* slots;
+    usize                 capacity;  /* Power of two (0 when unused) */
+    u32                   shift;     /* 64 - log2(capacity) */
+    usize                 used;      /* Live + tombstone slots */
+    u64                   multiplier; /* Odd; the table's, kept across resizes */
+} cauchy_htable_array_t;
+
+/* Hash index with incremental resizing */
+typedef struct cauchy_htable {
+    cauchy_htable_array_t cur;          /* Receives all inserts */
+    cauchy_htable_array_t old;          /* Being drained into cur (if slots) */
+    usize                 migrate_pos;  /* Next old slot to migrate */
+    usize                 migrate_step; /* Old slots moved per mutation */
+    usize                 count;        /* Live items */
+} cauchy_htable_t;
+
+/* Cursor over the items stored under one hash */
+typedef struct cauchy_htable_probe {
+    const cauchy_htable_t* table;
+    u64                    hash;
+    usize                  idx;
+    usize                  steps;
+    u8                     phase;  /* 0 = cur, 1 = old, 2 = done */
+} cauchy_htable_probe_t;
+
+/* Cursor over every item, or over one slice of the slot arrays */
+typedef struct cauchy_htable_iter {
+    const cauchy_htable_t* table;
+    usize                  idx;
+    usize                  end;    /* Slice end in the current array */
+    u32                    slice;
+    u32                    slices;
+    u8                     phase;  /* 0 = old, 1 = cur, 2 = done */
+} cauchy_htable_iter_t;
+
+/* One of `count` disjoint slot ranges of the current array. Threads that
+ * each own a part may probe and insert concurrently without locking, as
+ * long as nobody else touches the table: a thread only reads and writes
+ * slots inside its range. A probe chain that runs past the range end
+ * cannot be followed, so the probe reports it and the caller finishes
+ * that item with the regular calls once every part is committed. */
+typedef struct cauchy_htable_part {
+    cauchy_htable_t* table;
+    usize            begin;
+    usize            end;
+    usize            added;    /* Items inserted */
+    usize            filled;   /* Empty slots taken */
+} cauchy_htable_part_t;
+
+typedef struct cauchy_htable_part_probe {
+    const cauchy_htable_part_t* part;
+    u64                         hash;
+    usize                       idx;
+    bool                        escaped;  /* Chain left the part */
+} cauchy_htable_part_probe_t;
+
+/* 64-bit FNV-1a: the element hash of the set CRDTs. Digests exchanged
+ * between replicas are built from it, so it must not change. */
+u64 cauchy_hash_bytes(const void* data, usize size);
+
+/* Hash n byte strings into out, equal to cauchy_hash_bytes on each. FNV
+ * is one serial multiply chain per string; running four strings in
+ * lockstep overlaps their latencies. */
+void cauchy_hash_batch(const cauchy_bytes_t* items, usize n, u64* out);
+
+/* Element hashes that collide with the reserved slot values are shifted */
+CAUCHY_INLINE u64 cauchy_htable_slot_hash(u64 hash) {
+    return hash > CAUCHY_HTABLE_TOMBSTONE ? hash : hash + 2;
+}
+
+/* Multiply-shift hashing with a per-table odd multiplier: spreads weak
+ * low bits across the index range, and gives every table its own slot
+ * order. With one shared order, merging a table into a smaller one by
+ * iterating it inserts keys sorted by home slot, which piles them into a
+ * single ever-growing probe run. */
+CAUCHY_INLINE usize cauchy_htable_home_slot(const cauchy_htable_array_t* arr, u64 hash) {
+    return (usize)((hash * arr->multiplier) >> arr->shift);
+}
+
+/* Start loading the slots a probe for hash will look at first */
+CAUCHY_INLINE void cauchy_htable_prefetch(const cauchy_htable_t* table, u64 hash) {
+    u64 h = cauchy_htable_slot_hash(hash);
+    CAUCHY_PREFETCH(&table->cur.slots[cauchy_htable_home_slot(&table->cur, h)]);
+    if (table->old.slots) {
+        CAUCHY_PREFETCH(&table->old.slots[cauchy_htable_home_slot(&table->old, h)]);
+    }
+}
+
+/* Initialize with room for `capacity` items before the first resize */
+cauchy_result_t cauchy_htable_init(cauchy_htable_t* table, usize capacity);
+
+/* Free slot arrays (items are owned by the caller) */
+void cauchy_htable_destroy(cauchy_htable_t* table);
+
+/* Insert an item (caller guarantees it is not already present) */
+cauchy_result_t cauchy_htable_insert(cauchy_htable_t* table, u64 hash, void* item);
+
+/* Remove a specific item; returns false if it was not found */
+bool cauchy_htable_remove(cauchy_htable_t* table, u64 hash, const void* item);
+
+/* Predicate for cauchy_htable_sweep: true drops the item */
+typedef bool (*cauchy_htable_sweep_fn)(void* item, void* arg);
+
+/* Visit up to `budget` slots of the current array starting at *cursor
+ * and remove every item `drop` selects, so pruning a large table can be
+ * spread over many calls. *cursor wraps to 0 once the array has been
+ * covered; items still waiting in an old array are reached by a later
+ * pass after migration. Returns the number of items removed. */
+usize cauchy_htable_sweep(cauchy_htable_t* table, usize* cursor, usize budget,
+                          cauchy_htable_sweep_fn drop, void* arg);
+
+/* Finish any in-progress resize */
+void cauchy_htable_finish_resize(cauchy_htable_t* table);
+
+/* Finish any resize and grow so `extra` more items fit without one */
+cauchy_result_t cauchy_htable_reserve(cauchy_htable_t* table, usize extra);
+
+/* Number of live items */
+CAUCHY_INLINE usize cauchy_htable_count(const cauchy_htable_t* table) {
+    return table->count;
+}
+
+/* Enumerate items stored with exactly `hash`. The table must not be
+ * mutated until the probe is exhausted. */
+void cauchy_htable_probe_init(cauchy_htable_probe_t* probe,
+                              const cauchy_htable_t* table, u64 hash);
+void* cauchy_htable_probe_next(cauchy_htable_probe_t* probe);
+
+/* Enumerate all items (no mutation while iterating) */
+void cauchy_htable_iter_init(cauchy_htable_iter_t* iter, const cauchy_htable_t* table);
+void* cauchy_htable_iter_next(cauchy_htable_iter_t* iter);
+
+/* Enumerate slice `index` of `count`; the slices together visit every
+ * item once, so threads can scan one table side by side */
+void cauchy_htable_iter_init_slice(cauchy_htable_iter_t* iter, const cauchy_htable_t* table,
+                                   u32 index, u32 count);
+
+/* Partitioned filling. Reserve room first: parts never resize. */
+void cauchy_htable_part_init(cauchy_htable_part_t* part, cauchy_htable_t* table,
+                             u32 index, u32 count);
+
+/* Part (of count) that owns hash's home slot */
+u32 cauchy_htable_part_of(const cauchy_htable_t* table, u32 count, u64 hash);
+
+/* Enumerate the items under hash within the part; once it returns NULL,
+ * probe->escaped tells whether the chain was cut short at the part end */
+void cauchy_htable_part_probe_init(cauchy_htable_part_probe_t* probe,
+                                   const cauchy_htable_part_t* part, u64 hash);
+void* cauchy_htable_part_probe_next(cauchy_htable_part_probe_t* probe);
+
+/* Insert into the part; CAUCHY_ERR_FULL if no free slot is left between
+ * the home slot and the part end (never after a probe that did not escape) */
+cauchy_result_t cauchy_htable_part_insert(cauchy_htable_part_t* part, u64 hash, void* item);
+
+/* Fold a part's inserts into the table; once every worker is done */
+void cauchy_htable_part_commit(cauchy_htable_part_t* part);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_HTABLE_H */
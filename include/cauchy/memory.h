@@ -3,7 +3,7 @@
  * Memory Management
  * 
  * Lock-free memory pool allocator with cache-aligned blocks.
- * Implements hazard pointers for safe memory reclamation.
+ * Implements hazard pointers and epochs for safe memory reclamation.
  */
 
 #ifndef CAUCHY_MEMORY_H
@@ -18,6 +18,54 @@ extern "C" {
 /* Forward declarations */
 typedef struct cauchy_pool cauchy_pool_t;
 typedef struct cauchy_hazard_domain cauchy_hazard_domain_t;
+typedef struct cauchy_epoch_domain cauchy_epoch_domain_t;
+
+/* ============================================================
+ * Thread Registry
+ * ============================================================ */
+
+/* Maximum concurrently registered threads (multiple of 64) */
+#ifndef CAUCHY_MAX_THREADS
+#define CAUCHY_MAX_THREADS 128
+#endif
+
+/* Returned when every thread slot is taken */
+#define CAUCHY_THREAD_ID_INVALID UINT32_MAX
+
+/* Dense id of the calling thread in [0, CAUCHY_MAX_THREADS).
+ * Assigned on first call and recycled when the thread exits. */
+u32 cauchy_thread_id(void);
+
+/* Generation of the calling thread's slot (odd, non-zero); a recycled
+ * slot always gets a new generation. 0 if the thread has no slot. */
+u64 cauchy_thread_generation(void);
+
+/* True while the thread that was given `generation` for slot `id` runs */
+bool cauchy_thread_alive(u32 id, u64 generation);
+
+/* ============================================================
+ * Memory Pool
+ * ============================================================ */
+
+/* Default blocks per per-thread magazine */
+#define CAUCHY_POOL_MAGAZINE_SIZE 32
+
+/* Default blocks carved from each slab when the pool grows */
+#define CAUCHY_POOL_SLAB_BLOCKS 256
+
+/* Block placement on NUMA hosts (cauchy/numa.h). With per-node arenas,
+ * each node has its own depot of free magazines and grows its own slabs;
+ * a thread takes magazines from the depot of the node it runs on, and
+ * only takes another node's blocks once max_blocks stops local growth.
+ * Freed blocks go to the freeing thread's magazine, so a block freed on
+ * another node is reused there. On a single-node host every mode is the
+ * same single arena. */
+typedef enum cauchy_pool_numa {
+    CAUCHY_POOL_NUMA_LOCAL = 0,  /* Per-node arenas; slab pages are placed by first touch */
+    CAUCHY_POOL_NUMA_BIND,       /* Per-node arenas; slabs are bound to their node */
+    CAUCHY_POOL_NUMA_NODE,       /* One arena bound to numa_node */
+    CAUCHY_POOL_NUMA_OFF         /* One arena, no placement */
+} cauchy_pool_numa_t;
 
 /* Pool configuration */
 typedef struct cauchy_pool_config {
@@ -25,6 +73,12 @@ typedef struct cauchy_pool_config {
     usize initial_blocks;  /* Number of blocks to pre-allocate */
     usize max_blocks;      /* Maximum blocks (0 = unlimited) */
     usize alignment;       /* Memory alignment (default: cache line) */
+    usize magazine_size;   /* Blocks per thread-local magazine (0 = default) */
+    usize slab_blocks;     /* Blocks per growth slab (0 = default) */
+    cauchy_pool_numa_t numa;
+    u32   numa_node;       /* Node for CAUCHY_POOL_NUMA_NODE */
+    bool  huge_pages;      /* Back slabs of a huge page or more with huge pages,
+                            * growing them to fill whole huge pages */
 } cauchy_pool_config_t;
 
 /* Default configuration */
@@ -32,29 +86,37 @@ typedef struct cauchy_pool_config {
     .block_size = 64,                \
     .initial_blocks = 1024,          \
     .max_blocks = 0,                 \
-    .alignment = CAUCHY_CACHE_LINE_SIZE \
+    .alignment = CAUCHY_CACHE_LINE_SIZE, \
+    .magazine_size = CAUCHY_POOL_MAGAZINE_SIZE, \
+    .slab_blocks = CAUCHY_POOL_SLAB_BLOCKS, \
+    .numa = CAUCHY_POOL_NUMA_LOCAL,  \
+    .numa_node = 0,                  \
+    .huge_pages = false              \
 }
 
-/* Pool statistics */
+/* Pool statistics (per-thread counters summed at snapshot time) */
 typedef struct cauchy_pool_stats {
-    u64 allocated;    /* Total blocks allocated */
+    u64 allocated;    /* Total blocks obtained from the system */
     u64 freed;        /* Total blocks freed */
     u64 in_use;       /* Currently in use */
-    u64 peak_use;     /* Peak concurrent usage */
+    u64 peak_use;     /* Peak concurrent usage (sampled per magazine exchange) */
     u64 total_allocs; /* Total allocation calls */
     u64 contention;   /* CAS retries (contention indicator) */
 } cauchy_pool_stats_t;
 
-/* Create a memory pool */
+/* Create a memory pool. Initial blocks go to the creating thread's node,
+ * or are split evenly across nodes with CAUCHY_POOL_NUMA_BIND. */
 cauchy_pool_t* cauchy_pool_create(const cauchy_pool_config_t* config);
 
 /* Destroy a memory pool (all blocks must be freed) */
 void cauchy_pool_destroy(cauchy_pool_t* pool);
 
-/* Allocate a block from the pool (lock-free) */
+/* Allocate a block from the pool (lock-free, served from a thread-local
+ * magazine; NULL once max_blocks is exhausted, counting the blocks that
+ * exited threads left cached as free) */
 void* cauchy_pool_alloc(cauchy_pool_t* pool);
 
-/* Free a block back to the pool (lock-free) */
+/* Free a block back to the pool (lock-free, into a thread-local magazine) */
 void cauchy_pool_free(cauchy_pool_t* pool, void* block);
 
 /* Get pool statistics */
@@ -67,8 +129,11 @@ cauchy_pool_stats_t cauchy_pool_get_stats(const cauchy_pool_t* pool);
 /* Maximum hazard pointers per thread */
 #define CAUCHY_MAX_HAZARD_POINTERS 4
 
-/* Maximum threads using hazard domain */
-#define CAUCHY_MAX_HAZARD_THREADS 128
+/* Maximum threads using hazard domain (records are indexed by thread id) */
+#define CAUCHY_MAX_HAZARD_THREADS CAUCHY_MAX_THREADS
+
+/* Minimum retired nodes per thread before a reclaim scan is attempted */
+#define CAUCHY_HAZARD_RECLAIM_MIN 64
 
 /* Retired node callback for custom cleanup */
 typedef void (*cauchy_retire_fn)(void* node, void* ctx);
@@ -93,11 +158,96 @@ void cauchy_hazard_retire(cauchy_hazard_domain_t* domain,
                           cauchy_retire_fn retire_fn,
                           void* ctx);
 
-/* Try to reclaim retired nodes */
+/* Try to reclaim retired nodes. Also adopts the retired lists (and clears
+ * stale hazards) of threads that exited since the last scan. */
 usize cauchy_hazard_reclaim(cauchy_hazard_domain_t* domain);
 
+/* Retired nodes not yet reclaimed, summed over threads (approximate
+ * while threads retire concurrently) */
+usize cauchy_hazard_pending(const cauchy_hazard_domain_t* domain);
+
+/* ============================================================
+ * Epoch-Based Reclamation
+ *
+ * Readers bracket accesses with enter/exit instead of protecting each
+ * pointer. Entering is one relaxed store of the global epoch into the
+ * thread's record (the matching full fence is issued by reclaimers via
+ * membarrier(2) where available). Retired nodes are freed two epochs
+ * after retirement, once every active reader has moved on.
+ * ============================================================ */
+
+/* Retired nodes per thread before a reclaim is attempted */
+#define CAUCHY_EPOCH_RECLAIM_THRESHOLD 64
+
+/* Which deferred-reclamation scheme a component uses */
+typedef enum cauchy_reclaim_mode {
+    CAUCHY_RECLAIM_HAZARD,  /* Per-pointer hazard protection */
+    CAUCHY_RECLAIM_EPOCH    /* Epoch-based critical sections */
+} cauchy_reclaim_mode_t;
+
+/* Create epoch domain */
+cauchy_epoch_domain_t* cauchy_epoch_domain_create(void);
+
+/* Destroy epoch domain (runs all pending retire callbacks) */
+void cauchy_epoch_domain_destroy(cauchy_epoch_domain_t* domain);
+
+/* Enter a read-side critical section (nestable) */
+void cauchy_epoch_enter(cauchy_epoch_domain_t* domain);
+
+/* Leave a read-side critical section */
+void cauchy_epoch_exit(cauchy_epoch_domain_t* domain);
+
+/* Retire a node (freed once no reader can still hold it).
+ * CAUCHY_ERR_NOMEM if it cannot be queued; the caller still owns it. */
+cauchy_result_t cauchy_epoch_retire(cauchy_epoch_domain_t* domain,
+                                    void* node,
+                                    cauchy_retire_fn retire_fn,
+                                    void* ctx);
+
+/* Try to advance the epoch and free expired nodes */
+usize cauchy_epoch_reclaim(cauchy_epoch_domain_t* domain);
+
+/* Retired nodes not yet freed, summed over threads with a record */
+usize cauchy_epoch_pending(const cauchy_epoch_domain_t* domain);
+
+/* ============================================================
+ * Bump Arena
+ *
+ * Single-owner region allocator for payloads that live as long as the
+ * owning structure. Allocation is a pointer bump inside the current
+ * chunk; nothing is freed individually, everything goes at destroy.
+ * ============================================================ */
+
+/* Default arena chunk size */
+#define CAUCHY_ARENA_CHUNK_SIZE 4096
+
+typedef struct cauchy_arena_chunk cauchy_arena_chunk_t;
+
+typedef struct cauchy_arena {
+    cauchy_arena_chunk_t* chunks;      /* All chunks (current first) */
+    u8*                   cursor;      /* Next free byte in current chunk */
+    u8*                   limit;       /* End of current chunk */
+    usize                 chunk_size;
+    usize                 reserved;    /* Bytes obtained from the system */
+} cauchy_arena_t;
+
+/* Initialize an arena (chunk_size 0 = default); no memory is taken yet */
+void cauchy_arena_init(cauchy_arena_t* arena, usize chunk_size);
+
+/* Release every chunk */
+void cauchy_arena_destroy(cauchy_arena_t* arena);
+
+/* Allocate `size` bytes aligned to a pointer (NULL on OOM). Requests
+ * larger than a quarter chunk get a dedicated chunk so they never waste
+ * the tail of the current one. */
+void* cauchy_arena_alloc(cauchy_arena_t* arena, usize size);
+
+/* Move every chunk of other into arena, leaving other empty. Lets
+ * threads fill private arenas that one structure then owns. */
+void cauchy_arena_absorb(cauchy_arena_t* arena, cauchy_arena_t* other);
+
 /* ============================================================
- * General Memory Utilities  
+ * General Memory Utilities
  * ============================================================ */
 
 /* Allocate cache-aligned memory */
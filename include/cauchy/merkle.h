@@ -0,0 +1,89 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Incremental Merkle Digest
+ *
+ * Fixed-shape binary hash tree over 2^depth buckets. Items are placed in
+ * a bucket by the top bits of their (mixed) key hash, so two replicas
+ * agree on bucket boundaries regardless of how their tables are sized.
+ * Every node holds the wrapping sum of the item digests beneath it:
+ * sums commute, so the tree depends only on the set of items, and an
+ * insert or removal touches one root-to-leaf path.
+ */
+
+#ifndef CAUCHY_MERKLE_H
+#define CAUCHY_MERKLE_H
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Default depth: 65536 buckets, 1 MiB of node digests */
+#ifndef CAUCHY_MERKLE_DEFAULT_DEPTH
+#define CAUCHY_MERKLE_DEFAULT_DEPTH 16
+#endif
+
+#define CAUCHY_MERKLE_MAX_DEPTH 24
+
+/* Nodes in heap order: level L holds 2^L nodes starting at 2^L - 1 */
+typedef struct cauchy_merkle {
+    u64*  nodes;
+    u32   depth;
+    u64   items;
+} cauchy_merkle_t;
+
+/* Finalizer applied to key hashes before bucketing and to item digests */
+CAUCHY_INLINE u64 cauchy_merkle_mix(u64 x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/* What an item digest adds to every node above it. Digests are mixed
+ * with their bits inverted so an item whose digest is its key hash does
+ * not contribute the value that picked its bucket. A CRDT's fingerprint
+ * is the wrapping sum of these over its items, i.e. the root of its
+ * digest, kept without the tree. */
+CAUCHY_INLINE u64 cauchy_merkle_item(u64 digest) {
+    return cauchy_merkle_mix(~digest);
+}
+
+/* Bucket (leaf index) of a key hash */
+CAUCHY_INLINE u64 cauchy_merkle_bucket(u32 depth, u64 key_hash) {
+    return depth ? cauchy_merkle_mix(key_hash) >> (64 - depth) : 0;
+}
+
+/* Membership test against an ascending bucket list */
+CAUCHY_INLINE bool cauchy_merkle_bucket_listed(const u64* buckets, usize count, u64 bucket) {
+    usize lo = 0, hi = count;
+    while (lo < hi) {
+        usize mid = lo + (hi - lo) / 2;
+        if (buckets[mid] < bucket) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < count && buckets[lo] == bucket;
+}
+
+cauchy_result_t cauchy_merkle_init(cauchy_merkle_t* tree, u32 depth);
+void cauchy_merkle_destroy(cauchy_merkle_t* tree);
+
+/* Add or remove one item; removal must mirror an earlier add exactly */
+void cauchy_merkle_add(cauchy_merkle_t* tree, u64 key_hash, u64 digest);
+void cauchy_merkle_remove(cauchy_merkle_t* tree, u64 key_hash, u64 digest);
+
+/* Digest of node index at level (0 = root, depth = buckets) */
+u64 cauchy_merkle_node(const cauchy_merkle_t* tree, u32 level, u64 index);
+
+CAUCHY_INLINE u64 cauchy_merkle_root(const cauchy_merkle_t* tree) {
+    return tree->nodes[0];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_MERKLE_H */
@@ -0,0 +1,159 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Versioned Views
+ *
+ * Point-in-time views of a single-writer structure that other threads
+ * can iterate while the owner keeps writing. The owner keeps a version
+ * log: one record per visible item, stamped with the versions it is
+ * visible in, [born, died). Changes are staged at the next version and
+ * made visible together by cauchy_mvcc_publish, which also publishes
+ * two caller-defined words (a count and a fingerprint, say) under a
+ * seqlock.
+ *
+ * Records are appended to segments that never move, so a view walks
+ * them without locks and skips everything born after or dead at its
+ * version. Opening a view pins its version in one of a fixed set of
+ * slots. Items the owner takes out are retired rather than freed, and
+ * go once no pinned view is older than the retirement. When most
+ * records are dead, publish copies the live ones into a new generation
+ * and retires the old one the same way.
+ *
+ * Writer functions are called by the owner only. Views may be opened,
+ * iterated and closed on any thread, and must be closed before
+ * cauchy_mvcc_fini.
+ */
+
+#ifndef CAUCHY_MVCC_H
+#define CAUCHY_MVCC_H
+
+#include "types.h"
+#include "memory.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Views open at once on one log */
+#ifndef CAUCHY_MVCC_MAX_VIEWS
+#define CAUCHY_MVCC_MAX_VIEWS 64
+#endif
+
+/* Segment k holds CAUCHY_MVCC_SEGMENT_BASE << k records */
+#define CAUCHY_MVCC_SEGMENT_BASE 64
+#define CAUCHY_MVCC_SEGMENTS     26
+
+/* Record slot that names no record */
+#define CAUCHY_MVCC_NONE UINT32_MAX
+
+/* died of a record still visible */
+#define CAUCHY_MVCC_LIVE UINT64_MAX
+
+typedef struct cauchy_mvcc_record {
+    void*               item;
+    u64                 born;
+    cauchy_atomic_u64_t died;
+} cauchy_mvcc_record_t;
+
+/* One generation of the log; replaced whole by compaction */
+typedef struct cauchy_mvcc_log {
+    cauchy_mvcc_record_t* segments[CAUCHY_MVCC_SEGMENTS];
+    usize                 length;   /* Owner's count; readers use the published one */
+} cauchy_mvcc_log_t;
+
+/* Called while compacting for every live record that moved */
+typedef void (*cauchy_mvcc_relocate_fn)(void* arg, void* item, u32 slot);
+
+typedef struct cauchy_mvcc_retired {
+    void*            item;
+    u64              version;   /* Free once every view is at least this new */
+    cauchy_retire_fn fn;
+    void*            ctx;
+} cauchy_mvcc_retired_t;
+
+typedef struct cauchy_mvcc {
+    /* Published under seq: odd while the owner writes */
+    cauchy_atomic_u64_t     seq;
+    cauchy_atomic_u64_t     version;
+    cauchy_atomic_ptr_t     log;
+    cauchy_atomic_u64_t     length;
+    cauchy_atomic_u64_t     meta[2];
+    cauchy_atomic_u64_t     pins[CAUCHY_MVCC_MAX_VIEWS];  /* 0 = free */
+    /* Owner only */
+    cauchy_mvcc_log_t*      current;
+    u64                     next;       /* Version changes are staged at */
+    usize                   dead;       /* Records of current that ended */
+    cauchy_mvcc_retired_t*  retired;
+    usize                   retired_count;
+    usize                   retired_capacity;
+    cauchy_mvcc_relocate_fn relocate;
+    void*                   relocate_arg;
+} cauchy_mvcc_t;
+
+/* A pinned point-in-time view and its cursor */
+typedef struct cauchy_mvcc_view {
+    cauchy_mvcc_t*           mvcc;
+    const cauchy_mvcc_log_t* log;
+    u64                      version;
+    usize                    length;
+    u64                      meta[2];
+    usize                    cursor;
+    u32                      pin;
+} cauchy_mvcc_view_t;
+
+/* relocate may be NULL if the owner does not store record slots */
+cauchy_result_t cauchy_mvcc_init(cauchy_mvcc_t* m, cauchy_mvcc_relocate_fn relocate, void* arg);
+
+/* Free the log and run every pending retirement; no view may be open */
+void cauchy_mvcc_fini(cauchy_mvcc_t* m);
+
+/* Stage a new visible item; *slot receives its record */
+cauchy_result_t cauchy_mvcc_append(cauchy_mvcc_t* m, void* item, u32* slot);
+
+/* Stage the end of a record's visibility */
+void cauchy_mvcc_end(cauchy_mvcc_t* m, u32 slot);
+
+/* Free item with fn(item, ctx) once no view can reach it. If the
+ * retirement cannot be recorded the item is leaked, never freed early. */
+void cauchy_mvcc_retire(cauchy_mvcc_t* m, void* item, cauchy_retire_fn fn, void* ctx);
+
+/* Make staged changes visible together with meta, then reclaim and
+ * compact when due */
+void cauchy_mvcc_publish(cauchy_mvcc_t* m, u64 meta0, u64 meta1);
+
+/* Version staged changes are stamped with (for stamps kept outside the
+ * log, such as those of a snapshot base) */
+CAUCHY_INLINE u64 cauchy_mvcc_next(const cauchy_mvcc_t* m) {
+    return m->next;
+}
+
+/* Owner's view of the current generation: records, live or not */
+CAUCHY_INLINE usize cauchy_mvcc_length(const cauchy_mvcc_t* m) {
+    return m->current->length;
+}
+cauchy_mvcc_record_t* cauchy_mvcc_record(const cauchy_mvcc_log_t* log, usize slot);
+
+/* Open a view of the last published version (from any thread).
+ * CAUCHY_ERR_FULL when CAUCHY_MVCC_MAX_VIEWS views are open. */
+cauchy_result_t cauchy_mvcc_view_open(cauchy_mvcc_t* m, cauchy_mvcc_view_t* view);
+
+/* Unpin; the view must not be used afterwards */
+void cauchy_mvcc_view_close(cauchy_mvcc_view_t* view);
+
+/* Next item visible in the view, NULL at the end */
+void* cauchy_mvcc_view_next(cauchy_mvcc_view_t* view);
+
+CAUCHY_INLINE void cauchy_mvcc_view_rewind(cauchy_mvcc_view_t* view) {
+    view->cursor = 0;
+}
+
+/* Whether a stamp pair kept outside the log is visible in the view;
+ * died 0 means not ended */
+CAUCHY_INLINE bool cauchy_mvcc_view_sees(const cauchy_mvcc_view_t* view, u64 born, u64 died) {
+    return born <= view->version && (died == 0 || died > view->version);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_MVCC_H */
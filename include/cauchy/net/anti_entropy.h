@@ -0,0 +1,73 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Anti-Entropy Reconciliation
+ *
+ * Finds the buckets in which two replicas' Merkle digests disagree by
+ * descending only into differing subtrees, one level per round trip:
+ *
+ *   initiator                          peer
+ *   ae_start(root, depth)   <-------   root digest, depth
+ *   ae_pending()            ------->   ae_answer(level, nodes)
+ *   ae_descend(children)    <-------   2 digests per node
+ *   ... until ae_done(); pending() then lists differing buckets,
+ *   which either side turns into a delta with *_collect_buckets.
+ *
+ * Traffic is two digests per differing node per level, so it scales with
+ * the number of differences rather than with the size of the sets. The
+ * session is transport-agnostic; digests travel as plain u64 arrays.
+ */
+
+#ifndef CAUCHY_NET_ANTI_ENTROPY_H
+#define CAUCHY_NET_ANTI_ENTROPY_H
+
+#include "../types.h"
+#include "../merkle.h"
+#include "../crdt/g_set.h"
+#include "../crdt/or_set.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Initiator state for one reconciliation */
+typedef struct cauchy_ae_session {
+    const cauchy_merkle_t* local;
+    u32    level;      /* Level of the nodes in pending */
+    bool   started;
+    u64*   pending;    /* Differing node indices at level, ascending */
+    usize  count;
+    usize  capacity;
+    u64    digests_in; /* Digests received so far, for accounting */
+} cauchy_ae_session_t;
+
+cauchy_result_t cauchy_ae_session_init(cauchy_ae_session_t* s, const cauchy_merkle_t* local);
+void cauchy_ae_session_destroy(cauchy_ae_session_t* s);
+
+/* Compare the peer's root. CAUCHY_ERR_INVALID if the depths differ. */
+cauchy_result_t cauchy_ae_start(cauchy_ae_session_t* s, u64 remote_root, u32 remote_depth);
+
+/* Nodes whose children the peer must send next, or once done the
+ * differing buckets (empty when the replicas agree) */
+const u64* cauchy_ae_pending(const cauchy_ae_session_t* s, usize* count);
+
+/* True once pending refers to buckets rather than inner nodes */
+bool cauchy_ae_done(const cauchy_ae_session_t* s);
+
+/* Peer side: write the two child digests of each node at level to out */
+cauchy_result_t cauchy_ae_answer(const cauchy_merkle_t* tree, u32 level,
+                                 const u64* nodes, usize count, u64* out);
+
+/* Feed the peer's answer for the current pending nodes (2 * count digests) */
+cauchy_result_t cauchy_ae_descend(cauchy_ae_session_t* s, const u64* children, usize count);
+
+/* In-process convenience: reconcile src into dst through their digests,
+ * shipping only the differing buckets. Both digests must be enabled with
+ * the same depth. */
+cauchy_result_t cauchy_ae_sync_gset(cauchy_gset_t* dst, const cauchy_gset_t* src);
+cauchy_result_t cauchy_ae_sync_orset(cauchy_orset_t* dst, const cauchy_orset_t* src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_NET_ANTI_ENTROPY_H */
@@ -0,0 +1,127 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Gossip Transport
+ *
+ * Non-blocking UDP dissemination driven by an event loop (epoll plus a
+ * timerfd on Linux, poll(2) elsewhere). Updates are coalesced into
+ * preallocated datagram buffers: callers reserve space for a record and
+ * serialize straight into it with any of the *_serialize or *_encode
+ * functions, so a record is written exactly once. When a batch fills or
+ * its interval expires it is sent to `fanout` random peers with one
+ * gather write per peer (shared header + batch body, no copies), using
+ * sendmmsg(2) where available. Once every buffer holds an unsent batch,
+ * reservations fail with CAUCHY_ERR_FULL until the socket drains.
+ *
+ * Datagram layout (little-endian):
+ *   u32 magic, u8 version, u8 flags, u64 sender node id,
+ *   [vclock encoding of the sender's clock if flags & CLOCK],
+ *   records: varint key, u8 type, u16 length, length bytes.
+ *
+ * A transport belongs to one context and must be driven from the thread
+ * that owns it: the node id and the clock stamped on outgoing batches
+ * come from the context, and received clocks are merged into it.
+ */
+
+#ifndef CAUCHY_NET_GOSSIP_H
+#define CAUCHY_NET_GOSSIP_H
+
+#include "../cauchy.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CAUCHY_GOSSIP_MAGIC       0x50534743u  /* "CGSP" */
+#define CAUCHY_GOSSIP_VERSION     1
+#define CAUCHY_GOSSIP_FLAG_CLOCK  0x01
+
+/* Bytes kept in front of each batch for the header and sender clock */
+#define CAUCHY_GOSSIP_HEADER_MAX  256
+
+/* Largest UDP payload, and the most peers one batch goes to */
+#define CAUCHY_GOSSIP_MAX_DATAGRAM 65507
+#define CAUCHY_GOSSIP_MAX_FANOUT   16
+
+typedef struct cauchy_gossip cauchy_gossip_t;
+
+typedef struct cauchy_gossip_config {
+    const char* bind_addr;    /* IPv4 literal; NULL binds all interfaces */
+    u16   port;               /* 0 picks an ephemeral port */
+    u32   fanout;             /* Peers each batch is sent to */
+    u32   interval_us;        /* Longest a record waits in an open batch */
+    u32   max_datagram;       /* Datagram size including the header */
+    u32   queue_depth;        /* Preallocated batch buffers */
+} cauchy_gossip_config_t;
+
+#define CAUCHY_GOSSIP_CONFIG_DEFAULT { \
+    .bind_addr = NULL,                  \
+    .port = 0,                          \
+    .fanout = 3,                        \
+    .interval_us = 500,                 \
+    .max_datagram = 1400,               \
+    .queue_depth = 64                   \
+}
+
+/* Called from cauchy_gossip_poll for every received record */
+typedef void (*cauchy_gossip_deliver_fn)(void* arg, cauchy_node_id_t from,
+                                         u64 key, u8 type,
+                                         const u8* data, usize size);
+
+typedef struct cauchy_gossip_stats {
+    u64 records_sent;        /* Records in batches handed to the socket */
+    u64 datagrams_sent;
+    u64 bytes_sent;
+    u64 records_received;
+    u64 datagrams_received;
+    u64 datagrams_dropped;   /* Malformed or foreign datagrams */
+    u64 backpressure;        /* Reservations refused with CAUCHY_ERR_FULL */
+} cauchy_gossip_stats_t;
+
+/* Bind a transport for ctx (cfg NULL uses the defaults) */
+cauchy_gossip_t* cauchy_gossip_create(cauchy_context_t* ctx,
+                                      const cauchy_gossip_config_t* cfg,
+                                      cauchy_gossip_deliver_fn deliver, void* arg);
+
+void cauchy_gossip_destroy(cauchy_gossip_t* g);
+
+/* Bound UDP port, and a descriptor to wait on from an outer event loop */
+u16 cauchy_gossip_port(const cauchy_gossip_t* g);
+int cauchy_gossip_fd(const cauchy_gossip_t* g);
+
+/* Peer management (host is an IPv4 literal) */
+cauchy_result_t cauchy_gossip_add_peer(cauchy_gossip_t* g, cauchy_node_id_t node_id,
+                                       const char* host, u16 port);
+cauchy_result_t cauchy_gossip_remove_peer(cauchy_gossip_t* g, cauchy_node_id_t node_id);
+usize cauchy_gossip_peer_count(const cauchy_gossip_t* g);
+
+/* Reserve up to max_size bytes for one record in the open batch and
+ * return where to serialize it; finish with cauchy_gossip_commit.
+ * CAUCHY_ERR_INVALID if max_size can never fit a datagram,
+ * CAUCHY_ERR_FULL when every batch buffer is waiting to be sent. */
+cauchy_result_t cauchy_gossip_reserve(cauchy_gossip_t* g, u64 key, u8 type,
+                                      usize max_size, u8** out);
+
+/* Complete the reservation with the bytes actually written (may be 0 to
+ * abandon it) */
+cauchy_result_t cauchy_gossip_commit(cauchy_gossip_t* g, usize size);
+
+/* Copying convenience over reserve/commit */
+cauchy_result_t cauchy_gossip_publish(cauchy_gossip_t* g, u64 key, u8 type,
+                                      const void* data, usize size);
+
+/* Seal the open batch and send everything queued without waiting */
+cauchy_result_t cauchy_gossip_flush(cauchy_gossip_t* g);
+
+/* One loop iteration: wait up to timeout_ms (0 = don't block) for traffic
+ * or the batch deadline, deliver received records, send due batches.
+ * During a reservation it does not block and leaves the open batch
+ * unsealed until the commit. */
+cauchy_result_t cauchy_gossip_poll(cauchy_gossip_t* g, int timeout_ms);
+
+void cauchy_gossip_get_stats(const cauchy_gossip_t* g, cauchy_gossip_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_NET_GOSSIP_H */
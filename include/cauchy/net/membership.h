@@ -0,0 +1,135 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * SWIM Membership and Causal Stability
+ *
+ * Failure detection after SWIM (Das, Gupta, Motivala 2002). Each probe
+ * period one member is pinged. If no ack arrives within the probe
+ * timeout, k other members are asked to ping it on our behalf. A member
+ * still silent at the end of the period becomes SUSPECT, and DEAD once
+ * the suspicion timeout passes without a refutation. Membership changes
+ * are piggybacked on probe traffic and retransmitted about
+ * retransmit_mult * log2(n) times, so no separate broadcast is needed.
+ *
+ * Every message also carries the sender's causal clock (its context's
+ * local clock). At the end of each period the service computes the
+ * stable frontier: the element-wise minimum over the clocks of every
+ * live member, ourselves included. Events at or below the frontier have
+ * been seen everywhere. The frontier, restricted to departed members,
+ * prunes the tracked clocks (the context's clock by default) and is
+ * handed to the on_stable hook for tombstone collection.
+ *
+ * The service is transport-agnostic and clock-driven: the caller supplies
+ * a send function, feeds received datagrams to cauchy_membership_receive
+ * and calls cauchy_membership_tick with a monotonic time in milliseconds.
+ * Like the context it reads, it must be driven from a single thread.
+ */
+
+#ifndef CAUCHY_NET_MEMBERSHIP_H
+#define CAUCHY_NET_MEMBERSHIP_H
+
+#include "../cauchy.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CAUCHY_MEMBERSHIP_MAX_PIGGYBACK 8
+
+typedef enum cauchy_member_state {
+    CAUCHY_MEMBER_ALIVE   = 0,
+    CAUCHY_MEMBER_SUSPECT = 1,
+    CAUCHY_MEMBER_DEAD    = 2,
+    CAUCHY_MEMBER_LEFT    = 3,  /* Announced its own departure */
+    CAUCHY_MEMBER_UNKNOWN = 4
+} cauchy_member_state_t;
+
+typedef struct cauchy_membership cauchy_membership_t;
+
+/* Transmit one datagram to a member */
+typedef void (*cauchy_membership_send_fn)(void* arg, cauchy_node_id_t to,
+                                          const u8* data, usize size);
+
+/* A member changed state (including new members becoming ALIVE) */
+typedef void (*cauchy_membership_event_fn)(void* arg, cauchy_node_id_t node,
+                                           cauchy_member_state_t state);
+
+/* A new stable frontier was computed. departed holds the frontier's
+ * entries for departed members only; both clocks are valid for the
+ * duration of the call. */
+typedef void (*cauchy_membership_stable_fn)(void* arg, const cauchy_vclock_t* frontier,
+                                            const cauchy_vclock_t* departed);
+
+typedef struct cauchy_membership_config {
+    u32   probe_interval_ms;
+    u32   probe_timeout_ms;     /* Before falling back to indirect probes */
+    u32   suspect_timeout_ms;   /* SUSPECT -> DEAD without a refutation */
+    u32   dead_retention_ms;    /* How long departed members are remembered */
+    u32   indirect_probes;      /* k in SWIM */
+    u32   retransmit_mult;      /* lambda in SWIM */
+
+    cauchy_membership_send_fn   send;
+    cauchy_membership_event_fn  on_event;
+    cauchy_membership_stable_fn on_stable;
+    void*                       arg;
+} cauchy_membership_config_t;
+
+#define CAUCHY_MEMBERSHIP_CONFIG_DEFAULT { \
+    .probe_interval_ms = 1000,              \
+    .probe_timeout_ms = 300,                \
+    .suspect_timeout_ms = 5000,             \
+    .dead_retention_ms = 60000,             \
+    .indirect_probes = 3,                   \
+    .retransmit_mult = 3,                   \
+    .send = NULL,                           \
+    .on_event = NULL,                       \
+    .on_stable = NULL,                      \
+    .arg = NULL                             \
+}
+
+typedef struct cauchy_membership_stats {
+    u64 probes;
+    u64 indirect_probes;
+    u64 suspicions;
+    u64 refutations;
+    u64 deaths;
+    u64 frontiers;        /* Frontier computations */
+    u64 pruned_entries;   /* Clock entries dropped by pruning */
+} cauchy_membership_stats_t;
+
+/* cfg->send is required */
+cauchy_membership_t* cauchy_membership_create(cauchy_context_t* ctx,
+                                              const cauchy_membership_config_t* cfg);
+void cauchy_membership_destroy(cauchy_membership_t* m);
+
+/* Introduce a seed member (treated as ALIVE until probes say otherwise) */
+cauchy_result_t cauchy_membership_add(cauchy_membership_t* m, cauchy_node_id_t node);
+
+/* Announce a graceful departure to the members we know of */
+void cauchy_membership_leave(cauchy_membership_t* m);
+
+/* Feed one received datagram */
+cauchy_result_t cauchy_membership_receive(cauchy_membership_t* m, const u8* data,
+                                          usize size, u64 now_ms);
+
+/* Drive probing, timeouts and frontier computation */
+void cauchy_membership_tick(cauchy_membership_t* m, u64 now_ms);
+
+/* Prune clock (in addition to the context's) whenever the frontier moves.
+ * Do not track G-Counters; see cauchy_vclock_prune. */
+cauchy_result_t cauchy_membership_track_clock(cauchy_membership_t* m, cauchy_vclock_t* clock);
+void cauchy_membership_untrack_clock(cauchy_membership_t* m, cauchy_vclock_t* clock);
+
+/* Queries */
+cauchy_member_state_t cauchy_membership_state(const cauchy_membership_t* m, cauchy_node_id_t node);
+usize cauchy_membership_alive_count(const cauchy_membership_t* m);
+
+/* Most recent stable frontier (empty until every live member reported) */
+const cauchy_vclock_t* cauchy_membership_frontier(const cauchy_membership_t* m);
+
+void cauchy_membership_get_stats(const cauchy_membership_t* m, cauchy_membership_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_NET_MEMBERSHIP_H */
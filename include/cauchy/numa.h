@@ -0,0 +1,68 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * NUMA Topology and Placement
+ *
+ * Node discovery, thread placement and node-bound page mappings for the
+ * memory pools. Linux reads the topology from sysfs and uses getcpu(2),
+ * mbind(2) and sched_setaffinity(2) directly, so libnuma is not needed.
+ * Elsewhere, and on hosts without NUMA support, there is a single node 0
+ * and placement requests are accepted as no-ops.
+ */
+
+#ifndef CAUCHY_NUMA_H
+#define CAUCHY_NUMA_H
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Nodes beyond this are folded onto the last one */
+#define CAUCHY_NUMA_MAX_NODES 64
+
+/* Huge page size assumed for CAUCHY_NUMA_HUGE mappings */
+#ifndef CAUCHY_HUGE_PAGE_SIZE
+#define CAUCHY_HUGE_PAGE_SIZE (2u << 20)
+#endif
+
+/* No binding: pages land on the node of the thread that first touches them */
+#define CAUCHY_NUMA_ANY (-1)
+
+/* Mapping flags */
+#define CAUCHY_NUMA_HUGE 1u    /* Back with huge pages when size allows */
+
+/* Online nodes (at least 1, read once) */
+u32 cauchy_numa_node_count(void);
+
+/* Node of the CPU the calling thread runs on (0 if unknown) */
+u32 cauchy_numa_current_node(void);
+
+/* Restrict the calling thread to the CPUs of one node, so it stays next
+ * to the memory it allocates. CAUCHY_ERR_INVALID for a node that does
+ * not exist, CAUCHY_ERR_IO if the affinity cannot be set. */
+cauchy_result_t cauchy_numa_bind_thread(u32 node);
+
+/* Node holding the page at addr, or -1 if it is not resident or the
+ * host cannot tell */
+i32 cauchy_numa_node_of(const void* addr);
+
+/* Map size bytes of zeroed, page-aligned memory, preferring node (or
+ * CAUCHY_NUMA_ANY). The preference is set before any page is touched
+ * and falls back to other nodes when the node is full. With
+ * CAUCHY_NUMA_HUGE, a mapping of at least one huge page is rounded up to
+ * whole huge pages and uses reserved huge pages if there are any, and
+ * transparent huge pages otherwise. NULL on failure. */
+void* cauchy_numa_map(usize size, i32 node, u32 flags);
+
+/* Unmap memory from cauchy_numa_map, with the same size and flags */
+void cauchy_numa_unmap(void* ptr, usize size, u32 flags);
+
+/* Bytes cauchy_numa_map actually maps for size and flags */
+usize cauchy_numa_map_size(usize size, u32 flags);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_NUMA_H */
@@ -0,0 +1,83 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Parallel Execution
+ *
+ * Bulk operations that split into independent tasks (the partitioned
+ * merges) run them through an executor. The built-in one starts a thread
+ * per task for the duration of the call. Callers with their own worker
+ * pool plug it in by supplying `run`.
+ *
+ * A scatter routes items to partitions in two passes without sharing a
+ * write between tasks. In the first pass, producer i appends
+ * (hash, ref) pairs to its own row of bins, one bin per partition. In
+ * the second, partition p reads column p of every row.
+ */
+
+#ifndef CAUCHY_PARALLEL_H
+#define CAUCHY_PARALLEL_H
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Smallest source a parallel merge splits; below it the serial merge
+ * is faster than starting threads */
+#ifndef CAUCHY_PARALLEL_MIN_ITEMS
+#define CAUCHY_PARALLEL_MIN_ITEMS 16384
+#endif
+
+/* Upper bound on the partitions of one call */
+#define CAUCHY_PARALLEL_MAX_PARTS 256
+
+typedef void (*cauchy_task_fn)(void* arg, u32 index);
+
+/* Run task(arg, i) for every i < count, on any threads and in any order,
+ * and return once all have finished */
+typedef struct cauchy_executor {
+    void  (*run)(void* ctx, u32 count, cauchy_task_fn task, void* arg);
+    void*   ctx;
+} cauchy_executor_t;
+
+/* Run through exec, or the built-in executor if exec is NULL. The
+ * built-in one runs task 0 on the caller, and runs on the caller any
+ * task whose thread cannot be started. */
+void cauchy_executor_run(const cauchy_executor_t* exec, u32 count,
+                         cauchy_task_fn task, void* arg);
+
+/* Partitions to use when a caller passes 0: the online CPUs, capped */
+u32 cauchy_parallel_default_parts(void);
+
+typedef struct cauchy_scatter_item {
+    u64       hash;
+    u64       ref;      /* Caller-defined: a pointer, a tagged index or a value */
+} cauchy_scatter_item_t;
+
+typedef struct cauchy_scatter_bin {
+    cauchy_scatter_item_t* items;
+    usize                  count;
+    usize                  capacity;
+} cauchy_scatter_bin_t;
+
+typedef struct cauchy_scatter {
+    cauchy_scatter_bin_t* bins;    /* parts x parts, row = producer */
+    u32                   parts;
+} cauchy_scatter_t;
+
+cauchy_result_t cauchy_scatter_init(cauchy_scatter_t* s, u32 parts);
+void cauchy_scatter_fini(cauchy_scatter_t* s);
+
+CAUCHY_INLINE cauchy_scatter_bin_t* cauchy_scatter_bin(const cauchy_scatter_t* s,
+                                                       u32 producer, u32 part) {
+    return &s->bins[(usize)producer * s->parts + part];
+}
+
+/* Append to a bin (false if out of memory) */
+bool cauchy_scatter_push(cauchy_scatter_bin_t* bin, u64 hash, u64 ref);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_PARALLEL_H */
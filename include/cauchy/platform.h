@@ -23,8 +23,11 @@ extern "C" {
     #define CAUCHY_CACHE_LINE_SIZE 64
     #if defined(__ARM_FEATURE_ATOMICS)
         #define CAUCHY_HAS_LSE 1  /* Large System Extensions */
+        #define CAUCHY_DWCAS_LLSC 0  /* Single CASPAL instruction */
+    #else
+        #define CAUCHY_DWCAS_LLSC 1  /* LDAXP/STLXP retry loop */
     #endif
-    #define CAUCHY_HAS_DWCAS 1  /* LDXP/STXP pair */
+    #define CAUCHY_HAS_DWCAS 1
 #elif defined(__arm__) || defined(_M_ARM)
     #define CAUCHY_ARCH_ARM32 1
     #define CAUCHY_CACHE_LINE_SIZE 32
@@ -48,6 +51,17 @@ extern "C" {
     #define CAUCHY_COMPILER_UNKNOWN 1
 #endif
 
+/* SIMD kernels (define CAUCHY_NO_SIMD to build scalar-only). On x86-64
+ * the AVX2/AVX-512 variants are compiled per function and picked at
+ * runtime; NEON is part of the ARM64 baseline. */
+#if !defined(CAUCHY_NO_SIMD)
+    #if defined(CAUCHY_ARCH_X86_64) && (defined(CAUCHY_COMPILER_GCC) || defined(CAUCHY_COMPILER_CLANG))
+        #define CAUCHY_SIMD_X86 1
+    #elif defined(CAUCHY_ARCH_ARM64) && defined(__ARM_NEON)
+        #define CAUCHY_SIMD_NEON 1
+    #endif
+#endif
+
 /* OS detection */
 #if defined(__linux__)
     #define CAUCHY_OS_LINUX 1
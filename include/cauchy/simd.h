@@ -0,0 +1,58 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Vectorized u64 Array Kernels
+ *
+ * Element-wise max/min, dominance comparison and horizontal sum over the
+ * u64 arrays backing vector clocks and counters. The best implementation
+ * for the running CPU (AVX-512, AVX2, NEON or scalar) is selected on
+ * first use.
+ */
+
+#ifndef CAUCHY_SIMD_H
+#define CAUCHY_SIMD_H
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Instruction set backing the kernels */
+typedef enum cauchy_simd_level {
+    CAUCHY_SIMD_SCALAR,
+    CAUCHY_SIMD_NEON,
+    CAUCHY_SIMD_AVX2,
+    CAUCHY_SIMD_AVX512
+} cauchy_simd_level_t;
+
+/* Bits returned by cauchy_simd_cmp_u64 */
+#define CAUCHY_SIMD_LESS    1u  /* Some a[i] < b[i] */
+#define CAUCHY_SIMD_GREATER 2u  /* Some a[i] > b[i] */
+
+/* Currently selected implementation */
+cauchy_simd_level_t cauchy_simd_level(void);
+
+/* Select the best supported implementation not above `level` and return
+ * it (mainly for tests and benchmarks; not meant to race with kernels) */
+cauchy_simd_level_t cauchy_simd_select(cauchy_simd_level_t level);
+
+/* Human-readable name of a level */
+const char* cauchy_simd_level_name(cauchy_simd_level_t level);
+
+/* dst[i] = max(dst[i], src[i]) */
+void cauchy_simd_max_u64(u64* CAUCHY_RESTRICT dst, const u64* CAUCHY_RESTRICT src, usize n);
+
+/* dst[i] = min(dst[i], src[i]) */
+void cauchy_simd_min_u64(u64* CAUCHY_RESTRICT dst, const u64* CAUCHY_RESTRICT src, usize n);
+
+/* Combination of CAUCHY_SIMD_LESS / CAUCHY_SIMD_GREATER (0 = equal) */
+u32 cauchy_simd_cmp_u64(const u64* a, const u64* b, usize n);
+
+/* Sum of all elements (wrapping) */
+u64 cauchy_simd_sum_u64(const u64* a, usize n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_SIMD_H */
@@ -0,0 +1,238 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Memory-Mapped Snapshots
+ *
+ * A snapshot file holds any number of sections. Each section is one
+ * CRDT's state, or the context's clock, and is named by (kind, id). The
+ * layout, all integers in the writer's byte order:
+ *
+ *   header   magic "CAUCHYSN", version, byte-order mark, file size,
+ *            section count, table offset
+ *   sections each starts 8-byte aligned
+ *   table    one {kind, id, offset, size} entry per section
+ *
+ * Offsets inside a section are relative to the section, never absolute
+ * addresses, so the file is used in place at whatever address it is
+ * mapped. Sets keep their elements in a frozen index: an open-addressing
+ * slot array of {hash, record offset} laid out like cauchy_htable, so
+ * lookups probe the mapped pages directly and loading touches only the
+ * pages queries reach. Small CRDTs are simply deserialized on load.
+ *
+ * Files are written to "<path>.tmp" and renamed over path on commit, so
+ * a reader never sees a half-written snapshot. A mapping must not
+ * outlive its file being truncated in place. Replacing it by rename is
+ * safe, because the old inode stays mapped.
+ */
+
+#ifndef CAUCHY_SNAPSHOT_H
+#define CAUCHY_SNAPSHOT_H
+
+#include "types.h"
+#include "atomic.h"
+#include "vclock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CAUCHY_SNAPSHOT_VERSION 2
+
+/* Section kinds; the values are part of the file format */
+typedef enum cauchy_snapshot_kind {
+    CAUCHY_SNAPSHOT_CONTEXT      = 1,
+    CAUCHY_SNAPSHOT_G_COUNTER    = 2,
+    CAUCHY_SNAPSHOT_PN_COUNTER   = 3,
+    CAUCHY_SNAPSHOT_LWW_REGISTER = 4,
+    CAUCHY_SNAPSHOT_G_SET        = 5,
+    CAUCHY_SNAPSHOT_2P_SET       = 6,
+    CAUCHY_SNAPSHOT_OR_SET       = 7,
+    CAUCHY_SNAPSHOT_ORSWOT       = 8,
+    CAUCHY_SNAPSHOT_LWW_MAP      = 9,
+    CAUCHY_SNAPSHOT_RGA          = 10
+} cauchy_snapshot_kind_t;
+
+/* An open, mapped snapshot file (reference counted) */
+typedef struct cauchy_snapshot cauchy_snapshot_t;
+
+/* A snapshot being written */
+typedef struct cauchy_snapshot_writer cauchy_snapshot_writer_t;
+
+/* ============================================================
+ * Writing
+ * ============================================================ */
+
+/* Start writing path (through "<path>.tmp"); NULL if it cannot be created */
+cauchy_snapshot_writer_t* cauchy_snapshot_writer_create(const char* path);
+
+/* Open section (kind, id) for writing; CAUCHY_ERR_EXISTS if the file
+ * already has it. Sections are written one at a time. */
+cauchy_result_t cauchy_snapshot_writer_begin(cauchy_snapshot_writer_t* w,
+                                             cauchy_snapshot_kind_t kind, u64 id);
+
+/* Append bytes to the open section */
+cauchy_result_t cauchy_snapshot_writer_put(cauchy_snapshot_writer_t* w,
+                                           const void* data, usize size);
+
+/* Append one u64 */
+cauchy_result_t cauchy_snapshot_writer_put_u64(cauchy_snapshot_writer_t* w, u64 v);
+
+/* Append a u64 length, the bytes, and padding to 8 */
+cauchy_result_t cauchy_snapshot_writer_put_blob(cauchy_snapshot_writer_t* w,
+                                                const void* data, usize size);
+
+/* Append a vector clock as a blob of its serialized form */
+cauchy_result_t cauchy_snapshot_writer_put_vclock(cauchy_snapshot_writer_t* w,
+                                                  const cauchy_vclock_t* vc);
+
+/* Zero-pad the open section to a multiple of 8 bytes */
+cauchy_result_t cauchy_snapshot_writer_align(cauchy_snapshot_writer_t* w);
+
+/* Bytes written to the open section so far */
+u64 cauchy_snapshot_writer_offset(const cauchy_snapshot_writer_t* w);
+
+/* Close the open section */
+cauchy_result_t cauchy_snapshot_writer_end(cauchy_snapshot_writer_t* w);
+
+/* Write the table and header, flush to disk and rename into place. The
+ * writer is freed whatever the outcome. */
+cauchy_result_t cauchy_snapshot_writer_commit(cauchy_snapshot_writer_t* w);
+
+/* Drop the temporary file and free the writer */
+void cauchy_snapshot_writer_abort(cauchy_snapshot_writer_t* w);
+
+/* ============================================================
+ * Reading
+ * ============================================================ */
+
+/* Map path read-only and validate its header and section table.
+ * CAUCHY_ERR_IO if it cannot be opened or mapped, CAUCHY_ERR_INVALID
+ * if it is not a snapshot of this version and byte order. */
+cauchy_result_t cauchy_snapshot_open(const char* path, cauchy_snapshot_t** out);
+
+/* Take another reference; CRDTs loaded lazily hold one */
+cauchy_snapshot_t* cauchy_snapshot_retain(cauchy_snapshot_t* snap);
+
+/* Drop a reference; the file is unmapped with the last one */
+void cauchy_snapshot_release(cauchy_snapshot_t* snap);
+
+/* Locate section (kind, id); data is 8-byte aligned */
+cauchy_result_t cauchy_snapshot_find(const cauchy_snapshot_t* snap,
+                                     cauchy_snapshot_kind_t kind, u64 id,
+                                     const u8** data, usize* size);
+
+/* Number of sections, and the kind and id of the i-th */
+usize cauchy_snapshot_section_count(const cauchy_snapshot_t* snap);
+cauchy_result_t cauchy_snapshot_section_at(const cauchy_snapshot_t* snap, usize i,
+                                           cauchy_snapshot_kind_t* kind, u64* id);
+
+/* Sequential reads of what the writer put into a section. Each read
+ * fails (false) without advancing if the section is too short. */
+typedef struct cauchy_snapshot_cursor {
+    const u8* pos;
+    usize     left;
+} cauchy_snapshot_cursor_t;
+
+CAUCHY_INLINE void cauchy_snapshot_cursor_init(cauchy_snapshot_cursor_t* cur,
+                                               const u8* data, usize size) {
+    cur->pos = data;
+    cur->left = size;
+}
+
+bool cauchy_snapshot_get_u64(cauchy_snapshot_cursor_t* cur, u64* v);
+bool cauchy_snapshot_get_blob(cauchy_snapshot_cursor_t* cur, const u8** data, usize* size);
+
+/* Read a clock put with _put_vclock (vc is overwritten, as by
+ * cauchy_vclock_deserialize) */
+bool cauchy_snapshot_get_vclock(cauchy_snapshot_cursor_t* cur, cauchy_vclock_t* vc);
+
+/* ============================================================
+ * Frozen Index
+ *
+ * Stored as {capacity, count, multiplier, shift} followed by capacity
+ * {hash, offset} slots and then the records the offsets point to
+ * (relative to the index start). Hashes are slot hashes (see
+ * cauchy_htable_slot_hash), with CAUCHY_HTABLE_EMPTY marking free slots.
+ * ============================================================ */
+
+typedef struct cauchy_snapshot_index {
+    const u8*  base;        /* Index start; record offsets are relative to it */
+    usize      size;        /* Bytes from base to the end of the records */
+    const u64* slots;       /* capacity {hash, offset} pairs */
+    u64        capacity;    /* Power of two */
+    u64        count;
+    u64        multiplier;
+    u32        shift;
+} cauchy_snapshot_index_t;
+
+/* Cursor over the records stored under one hash */
+typedef struct cauchy_snapshot_probe {
+    const cauchy_snapshot_index_t* index;
+    u64 hash;
+    u64 slot;
+    u64 steps;
+} cauchy_snapshot_probe_t;
+
+/* Parse the index at data; CAUCHY_ERR_INVALID if it does not fit */
+cauchy_result_t cauchy_snapshot_index_parse(cauchy_snapshot_index_t* index,
+                                            const u8* data, usize size);
+
+/* Record in slot, or NULL for a free (or corrupt) slot */
+const u8* cauchy_snapshot_index_at(const cauchy_snapshot_index_t* index, u64 slot);
+
+/* Bytes from a record to the end of the index, for bounds checks */
+CAUCHY_INLINE usize cauchy_snapshot_index_room(const cauchy_snapshot_index_t* index,
+                                               const u8* record) {
+    return (usize)(index->base + index->size - record);
+}
+
+/* Enumerate records stored with element hash `hash`; *slot (if
+ * non-NULL) receives each record's slot number */
+void cauchy_snapshot_probe_init(cauchy_snapshot_probe_t* probe,
+                                const cauchy_snapshot_index_t* index, u64 hash);
+const u8* cauchy_snapshot_probe_next(cauchy_snapshot_probe_t* probe, u64* slot);
+
+/* Builds an index while its records are written. Records are written
+ * in two passes: the first passes each record's length to _place to
+ * learn its offset, the second writes the slots (_write) and then the
+ * records themselves, in the same order, each padded to 8 bytes. */
+typedef struct cauchy_snapshot_index_builder {
+    u64* slots;
+    u64  capacity;
+    u64  count;
+    u64  multiplier;
+    u32  shift;
+    u64  next_offset;
+} cauchy_snapshot_index_builder_t;
+
+cauchy_result_t cauchy_snapshot_index_builder_init(cauchy_snapshot_index_builder_t* b,
+                                                   usize count);
+void cauchy_snapshot_index_builder_fini(cauchy_snapshot_index_builder_t* b);
+
+/* Reserve room for a record of record_size bytes (padded to 8) filed
+ * under element hash `hash` */
+void cauchy_snapshot_index_builder_place(cauchy_snapshot_index_builder_t* b,
+                                         u64 hash, usize record_size);
+
+/* Write the index header and slots; records must follow, padded to 8 */
+cauchy_result_t cauchy_snapshot_index_builder_write(const cauchy_snapshot_index_builder_t* b,
+                                                    cauchy_snapshot_writer_t* w);
+
+/* One bit per slot of a frozen index: set once the record is superseded
+ * by a heap copy, or dropped. Allocated on first use. */
+typedef struct cauchy_snapshot_shadow {
+    u64* bits;
+    u64  capacity;
+} cauchy_snapshot_shadow_t;
+
+CAUCHY_INLINE bool cauchy_snapshot_shadowed(const cauchy_snapshot_shadow_t* s, u64 slot) {
+    return s->bits && (s->bits[slot / 64] >> (slot % 64)) & 1;
+}
+
+cauchy_result_t cauchy_snapshot_shadow_set(cauchy_snapshot_shadow_t* s, u64 slot);
+void cauchy_snapshot_shadow_fini(cauchy_snapshot_shadow_t* s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_SNAPSHOT_H */
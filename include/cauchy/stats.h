@@ -0,0 +1,131 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Instrumentation
+ *
+ * Hot-path counters and log2-bucketed histograms, compiled in only when
+ * CAUCHY_STATS is defined (make STATS=1; debug builds default to it).
+ * Without it every CAUCHY_STAT_* macro expands to nothing and snapshots
+ * read as zero.
+ *
+ * Each thread writes its own cache-aligned slot, indexed by
+ * cauchy_thread_id(), with relaxed load/store pairs; a snapshot sums the
+ * slots. Threads without an id share one overflow slot updated with
+ * RMWs. Counters only grow: take two snapshots and subtract them to get
+ * rates over an interval.
+ */
+
+#ifndef CAUCHY_STATS_H
+#define CAUCHY_STATS_H
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Histogram buckets: bucket 0 holds 0, bucket b holds [2^(b-1), 2^b),
+ * and the last one everything above */
+#define CAUCHY_STATS_BUCKETS 40
+
+typedef enum cauchy_stat {
+    CAUCHY_STAT_POOL_CAS_RETRIES,    /* Failed CAS attempts on pool depots */
+    CAUCHY_STAT_HAZARD_RETIRED,
+    CAUCHY_STAT_HAZARD_RECLAIMED,
+    CAUCHY_STAT_EPOCH_RETIRED,
+    CAUCHY_STAT_EPOCH_RECLAIMED,
+    CAUCHY_STAT_COUNT
+} cauchy_stat_t;
+
+typedef enum cauchy_stat_hist {
+    CAUCHY_HIST_HAZARD_RECLAIM_NS,   /* Duration of hazard reclaim scans */
+    CAUCHY_HIST_HAZARD_BACKLOG,      /* Retired nodes pending at each scan */
+    CAUCHY_HIST_EPOCH_RECLAIM_NS,
+    CAUCHY_HIST_EPOCH_BACKLOG,
+    CAUCHY_HIST_HTABLE_CHAIN,        /* Slots walked past home by each insert */
+    CAUCHY_HIST_MERGE_ITEMS,         /* Entries visited per merge */
+    CAUCHY_HIST_MERGE_NS,            /* Duration of each merge */
+    CAUCHY_HIST_COUNT
+} cauchy_stat_hist_t;
+
+/* CRDTs whose merges are accounted separately */
+typedef enum cauchy_stat_crdt {
+    CAUCHY_STAT_CRDT_GSET,
+    CAUCHY_STAT_CRDT_2PSET,
+    CAUCHY_STAT_CRDT_ORSET,
+    CAUCHY_STAT_CRDT_ORSWOT,
+    CAUCHY_STAT_CRDT_LWW_MAP,
+    CAUCHY_STAT_CRDT_COUNT
+} cauchy_stat_crdt_t;
+
+typedef struct cauchy_histogram {
+    u64 count;
+    u64 sum;
+    u64 max;
+    u64 buckets[CAUCHY_STATS_BUCKETS];
+} cauchy_histogram_t;
+
+/* Merge totals of one CRDT type. entries and tombstones describe the
+ * destination after each merge, so tombstones / entries is the average
+ * share of dead state merges had to carry. */
+typedef struct cauchy_merge_stats {
+    u64 merges;
+    u64 items;       /* Entries visited */
+    u64 ns;          /* Time spent merging */
+    u64 entries;
+    u64 tombstones;
+} cauchy_merge_stats_t;
+
+/* Process-wide snapshot */
+typedef struct cauchy_stats {
+    bool                 enabled;  /* Built with CAUCHY_STATS */
+    u64                  counters[CAUCHY_STAT_COUNT];
+    cauchy_histogram_t   hist[CAUCHY_HIST_COUNT];
+    cauchy_merge_stats_t merge[CAUCHY_STAT_CRDT_COUNT];
+} cauchy_stats_t;
+
+/* Sum every thread's slot into out */
+void cauchy_stats_snapshot(cauchy_stats_t* out);
+
+/* Upper bound of the bucket holding quantile p (0..1) */
+u64 cauchy_stats_percentile(const cauchy_histogram_t* hist, double p);
+
+/* Tombstone share of merged states in [0, 1] (0 if none merged) */
+double cauchy_stats_tombstone_ratio(const cauchy_merge_stats_t* merge);
+
+/* Write the snapshot as "name value" lines in the Prometheus text
+ * format. Returns the length the full text needs (as snprintf does); at
+ * most size - 1 bytes are written, always NUL-terminated. */
+usize cauchy_stats_format(const cauchy_stats_t* stats, char* buf, usize size);
+
+const char* cauchy_stat_name(cauchy_stat_t stat);
+const char* cauchy_stat_hist_name(cauchy_stat_hist_t hist);
+const char* cauchy_stat_crdt_name(cauchy_stat_crdt_t crdt);
+
+/* Recording entry points behind the macros below */
+void cauchy_stats_add(cauchy_stat_t stat, u64 n);
+void cauchy_stats_record(cauchy_stat_hist_t hist, u64 value);
+void cauchy_stats_merge(cauchy_stat_crdt_t crdt, u64 items, u64 ns,
+                        u64 entries, u64 tombstones);
+u64 cauchy_stats_now_ns(void);
+
+#ifdef CAUCHY_STATS
+#define CAUCHY_STAT_ADD(stat, n)        cauchy_stats_add((stat), (n))
+#define CAUCHY_STAT_RECORD(hist, value) cauchy_stats_record((hist), (value))
+#define CAUCHY_STAT_MERGE(crdt, items, ns, entries, tombstones) \
+    cauchy_stats_merge((crdt), (items), (ns), (entries), (tombstones))
+#define CAUCHY_STAT_NOW()               cauchy_stats_now_ns()
+#else
+/* Arguments stay referenced (unevaluated) so locals kept only for
+ * instrumentation do not trigger unused warnings */
+#define CAUCHY_STAT_ADD(stat, n)        ((void)sizeof(n))
+#define CAUCHY_STAT_RECORD(hist, value) ((void)sizeof(value))
+#define CAUCHY_STAT_MERGE(crdt, items, ns, entries, tombstones) \
+    ((void)sizeof(items), (void)sizeof(ns), (void)sizeof(entries), (void)sizeof(tombstones))
+#define CAUCHY_STAT_NOW()               ((u64)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_STATS_H */
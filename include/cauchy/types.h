@@ -58,7 +58,8 @@ typedef enum cauchy_result {
     CAUCHY_ERR_CONCURRENT  = -8,  /* CAS failure due to concurrent modification */
     CAUCHY_ERR_CAUSAL      = -9,  /* Causal dependency not satisfied */
     CAUCHY_ERR_NETWORK     = -10,
-    CAUCHY_ERR_INTERNAL    = -11
+    CAUCHY_ERR_INTERNAL    = -11,
+    CAUCHY_ERR_IO          = -12  /* File or system call failure */
 } cauchy_result_t;
 
 /* Causality relationship between two events */
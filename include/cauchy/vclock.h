@@ -16,44 +16,80 @@
 extern "C" {
 #endif
 
-/* Maximum nodes in a cluster (can be configured at compile time) */
+/* Default cluster size hint. Clocks accept any 64-bit node id; this only
+ * sizes the initial id range reported in num_nodes. */
 #ifndef CAUCHY_MAX_NODES
 #define CAUCHY_MAX_NODES 64
 #endif
 
-/* Vector clock structure - fixed size for efficiency */
-typedef struct CAUCHY_CACHE_ALIGNED cauchy_vclock {
-    u64 entries[CAUCHY_MAX_NODES];
-    u32 num_nodes;    /* Active node count */
-    u32 _padding;
+/* Node ids below this may use the dense layout */
+#ifndef CAUCHY_VCLOCK_DENSE_LIMIT
+#define CAUCHY_VCLOCK_DENSE_LIMIT 65536
+#endif
+
+/* Sparse pairs stored inside the struct before anything is allocated */
+#define CAUCHY_VCLOCK_INLINE_PAIRS 4
+
+/* One sparse entry */
+typedef struct cauchy_vclock_pair {
+    cauchy_node_id_t node_id;
+    u64              value;
+} cauchy_vclock_pair_t;
+
+/* Vector clock with two layouts behind one API:
+ *  - sparse: non-zero entries as pairs sorted by node id, held inline up
+ *    to CAUCHY_VCLOCK_INLINE_PAIRS and on the heap beyond that;
+ *  - dense: a u64 array indexed by node id, chosen automatically when
+ *    the sparse pairs fill up and at least half of the id range is in
+ *    use (ids must be below CAUCHY_VCLOCK_DENSE_LIMIT).
+ * init, copy and deserialize overwrite the target without releasing it,
+ * so call cauchy_vclock_fini first on a clock that may own heap storage. */
+typedef struct cauchy_vclock {
+    void* heap;       /* Dense array, or sparse pairs once past the inline ones */
+    u32   num_nodes;  /* Node-id span: init hint, grown as higher ids appear */
+    u32   count;      /* Sparse pairs in use */
+    u32   capacity;   /* Dense slots or sparse pair capacity */
+    u8    dense;
+    u8    _padding[3];
+    cauchy_vclock_pair_t inline_pairs[CAUCHY_VCLOCK_INLINE_PAIRS];
 } cauchy_vclock_t;
 
-/* Initialize a vector clock (all zeros) */
+/* Cursor over the non-zero entries in ascending node-id order */
+typedef struct cauchy_vclock_iter {
+    const cauchy_vclock_t* vc;
+    usize                  pos;
+} cauchy_vclock_iter_t;
+
+/* Initialize a vector clock (all zeros, sparse) */
 void cauchy_vclock_init(cauchy_vclock_t* vc, u32 num_nodes);
 
+/* Release heap storage; the clock is left empty and reusable */
+void cauchy_vclock_fini(cauchy_vclock_t* vc);
+
 /* Create a new vector clock on heap */
 cauchy_vclock_t* cauchy_vclock_create(u32 num_nodes);
 
 /* Destroy a heap-allocated vector clock */
 void cauchy_vclock_destroy(cauchy_vclock_t* vc);
 
-/* Copy a vector clock */
-void cauchy_vclock_copy(cauchy_vclock_t* dst, const cauchy_vclock_t* src);
+/* Copy a vector clock. dst is overwritten without being released, so
+ * cauchy_vclock_fini a clock that may own heap storage first. */
+cauchy_result_t cauchy_vclock_copy(cauchy_vclock_t* dst, const cauchy_vclock_t* src);
 
 /* Clone a vector clock (allocates new) */
 cauchy_vclock_t* cauchy_vclock_clone(const cauchy_vclock_t* vc);
 
 /* Increment the clock for a specific node (local event) */
-void cauchy_vclock_increment(cauchy_vclock_t* vc, cauchy_node_id_t node_id);
+cauchy_result_t cauchy_vclock_increment(cauchy_vclock_t* vc, cauchy_node_id_t node_id);
 
 /* Get the timestamp for a specific node */
 u64 cauchy_vclock_get(const cauchy_vclock_t* vc, cauchy_node_id_t node_id);
 
 /* Set the timestamp for a specific node */
-void cauchy_vclock_set(cauchy_vclock_t* vc, cauchy_node_id_t node_id, u64 value);
+cauchy_result_t cauchy_vclock_set(cauchy_vclock_t* vc, cauchy_node_id_t node_id, u64 value);
 
 /* Merge two vector clocks (element-wise maximum) */
-void cauchy_vclock_merge(cauchy_vclock_t* dst, const cauchy_vclock_t* src);
+cauchy_result_t cauchy_vclock_merge(cauchy_vclock_t* dst, const cauchy_vclock_t* src);
 
 /* Compare two vector clocks for causality */
 cauchy_causality_t cauchy_vclock_compare(const cauchy_vclock_t* a,
@@ -74,21 +110,38 @@ bool cauchy_vclock_equals(const cauchy_vclock_t* a,
 /* Check if vector clock is empty (all zeros) */
 bool cauchy_vclock_is_empty(const cauchy_vclock_t* vc);
 
+/* True while the clock uses the dense layout */
+bool cauchy_vclock_is_dense(const cauchy_vclock_t* vc);
+
 /* Get sum of all entries (useful for debugging) */
 u64 cauchy_vclock_sum(const cauchy_vclock_t* vc);
 
-/* Calculate minimum vector clock across all entries */
+/* Element-wise minimum (entries missing from src count as zero) */
 void cauchy_vclock_min(cauchy_vclock_t* dst, const cauchy_vclock_t* src);
 
-/* Prune entries below threshold (garbage collection) */
+/* Drop every entry that min_vc covers (value <= min_vc's entry for the
+ * same node) and return how many were dropped. Meant for a causally
+ * stable frontier restricted to departed nodes: once every live replica
+ * has reached a departed node's final count, its entry carries no
+ * ordering information and can go. Clocks compared with one another must
+ * be pruned against the same frontier. Never prune a G-Counter with this:
+ * its entries are the counts themselves. */
 u32 cauchy_vclock_prune(cauchy_vclock_t* vc, const cauchy_vclock_t* min_vc);
 
-/* Serialize vector clock to buffer */
+/* Iterate non-zero entries (no mutation while iterating) */
+void cauchy_vclock_iter_init(cauchy_vclock_iter_t* iter, const cauchy_vclock_t* vc);
+bool cauchy_vclock_iter_next(cauchy_vclock_iter_t* iter,
+                             cauchy_node_id_t* node_id, u64* value);
+
+/* Raw fixed-width encoding, kept as the fallback for peers that predate
+ * cauchy_vclock_encode. Uses host byte order. Serialize writes whichever of the dense
+ * (u32 span, span x u64) or sparse (u32 0x80000000|count, u32 num_nodes,
+ * count x {u64 node, u64 value}) encodings is smaller. */
 usize cauchy_vclock_serialize(const cauchy_vclock_t* vc, 
                                u8* buffer, 
                                usize buffer_size);
 
-/* Deserialize vector clock from buffer */
+/* Deserialize vector clock from buffer (vc is overwritten, see above) */
 cauchy_result_t cauchy_vclock_deserialize(cauchy_vclock_t* vc,
                                            const u8* buffer,
                                            usize buffer_size);
@@ -96,6 +149,36 @@ cauchy_result_t cauchy_vclock_deserialize(cauchy_vclock_t* vc,
 /* Get serialized size */
 usize cauchy_vclock_serialized_size(const cauchy_vclock_t* vc);
 
+/* Length of the encoded clock at the start of buffer (0 if truncated) */
+usize cauchy_vclock_peek_serialized_size(const u8* buffer, usize buffer_size);
+
+/* Compact encoding, version CAUCHY_VCLOCK_WIRE_VERSION:
+ *   u8 version, u8 flags, [u32 LE base fingerprint if DELTA],
+ *   varint num_nodes, varint entry count,
+ *   per entry: varint id gap (absolute for the first entry, then
+ *   id - previous id - 1) and varint value.
+ * Zero entries are never written. With a base the clock is sent as a
+ * delta: only entries that differ from base appear, each carrying the
+ * zigzag-encoded difference. Varints are LEB128, so the bytes do not
+ * depend on host endianness. */
+#define CAUCHY_VCLOCK_WIRE_VERSION 1
+#define CAUCHY_VCLOCK_WIRE_DELTA   0x01
+
+/* Exact size cauchy_vclock_encode will need (base may be NULL) */
+usize cauchy_vclock_encoded_size(const cauchy_vclock_t* vc, const cauchy_vclock_t* base);
+
+/* Encode vc, as a delta against base when base is non-NULL.
+ * Returns bytes written, or 0 if the buffer is too small. */
+usize cauchy_vclock_encode(const cauchy_vclock_t* vc, const cauchy_vclock_t* base,
+                           u8* buffer, usize buffer_size);
+
+/* Decode into vc (overwritten, see above; vc may be base itself, which is
+ * then released and replaced). Delta input needs the base it was encoded
+ * against: CAUCHY_ERR_CAUSAL if base is NULL or does not match.
+ * On success *consumed (if non-NULL) holds the bytes read. */
+cauchy_result_t cauchy_vclock_decode(cauchy_vclock_t* vc, const cauchy_vclock_t* base,
+                                     const u8* buffer, usize buffer_size, usize* consumed);
+
 /* Debug: print vector clock to stderr */
 void cauchy_vclock_debug_print(const cauchy_vclock_t* vc, const char* label);
 
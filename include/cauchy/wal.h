@@ -0,0 +1,131 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Write-Ahead Op Log
+ *
+ * An append-only file of CRDT operations, each tagged with the uid the
+ * context generated for it (cauchy_context_gen_uid). A node applies an
+ * op, appends it, and calls cauchy_wal_sync before it acknowledges the
+ * op. On restart it loads its last snapshot and replays the log on top.
+ *
+ * Group commit: appends only copy the record into a shared buffer. The
+ * first thread to sync becomes the leader. It writes everything pending
+ * and makes one fdatasync, and every record in that batch becomes
+ * durable together. Threads that sync while the leader is in fdatasync
+ * wait, and the next leader takes their records as one batch. This
+ * gives one disk flush per batch, not per op. max_delay_us makes a
+ * leader wait for more records first, trading commit latency for
+ * larger batches. The lock is held only to copy records and to hand a
+ * batch over, never during I/O.
+ *
+ * Record layout, in the writer's byte order, each padded to 8 bytes:
+ *
+ *   checksum  u64, cauchy_hash_bytes of the rest of the record
+ *   size      u32 payload bytes
+ *   kind, op  u16 each: a cauchy_snapshot_kind_t and a caller-defined code
+ *   crdt id   u64, the id the CRDT's snapshot section uses
+ *   uid       u64 node, u64 timestamp
+ *   payload
+ *
+ * A crash can leave a torn record at the tail. Replay stops at the
+ * first record that is short or fails its checksum, and opening the log
+ * truncates such a tail before appending.
+ *
+ * Replay is idempotent over the snapshot. A record is skipped when its
+ * uid is covered by the clock the snapshot restored (see
+ * cauchy_context_snapshot_load), because the op is already in the saved
+ * state. Logging delta states (the *_delta mutators) instead of raw ops
+ * makes every record an idempotent join as well.
+ */
+
+#ifndef CAUCHY_WAL_H
+#define CAUCHY_WAL_H
+
+#include "types.h"
+#include "vclock.h"
+#include "snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CAUCHY_WAL_VERSION 1
+
+typedef struct cauchy_wal_config {
+    u32   max_delay_us;      /* Leader wait for more records; 0 syncs at once */
+    usize max_batch_bytes;   /* Stop waiting once this much is pending */
+    bool  sync;              /* fdatasync batches (false: write only) */
+} cauchy_wal_config_t;
+
+#define CAUCHY_WAL_CONFIG_DEFAULT { \
+    .max_delay_us = 0,              \
+    .max_batch_bytes = 1 << 20,     \
+    .sync = true                    \
+}
+
+/* An open log (thread-safe) */
+typedef struct cauchy_wal cauchy_wal_t;
+
+/* One logged op. On replay, data points into the log and is valid only
+ * during the callback. */
+typedef struct cauchy_wal_record {
+    cauchy_snapshot_kind_t kind;
+    u16                    op;
+    u64                    crdt_id;
+    cauchy_uid_t           uid;
+    const void*            data;
+    usize                  size;
+} cauchy_wal_record_t;
+
+typedef struct cauchy_wal_stats {
+    u64 appended;    /* Records appended since open */
+    u64 durable;     /* Of those, how many are on disk */
+    u64 batches;     /* Write (and fdatasync) calls */
+    u64 bytes;       /* Bytes written */
+} cauchy_wal_stats_t;
+
+/* Open or create the log at path for appending (config may be NULL for
+ * the defaults). A torn tail left by a crash is cut off and a torn
+ * header is rewritten. NULL if the file cannot be opened or is not a
+ * log of this version. */
+cauchy_wal_t* cauchy_wal_open(const char* path, const cauchy_wal_config_t* config);
+
+/* Sync whatever is pending and close */
+cauchy_result_t cauchy_wal_close(cauchy_wal_t* wal);
+
+/* Queue a record; *lsn (if non-NULL) receives its sequence number for
+ * cauchy_wal_sync. The record is not durable until synced. */
+cauchy_result_t cauchy_wal_append(cauchy_wal_t* wal, const cauchy_wal_record_t* rec,
+                                  u64* lsn);
+
+/* Block until record lsn and every one before it is on disk (0 for all
+ * appended so far). CAUCHY_ERR_IO once a write has failed; the log
+ * accepts no more records after that. */
+cauchy_result_t cauchy_wal_sync(cauchy_wal_t* wal, u64 lsn);
+
+/* Append and sync one record */
+cauchy_result_t cauchy_wal_commit(cauchy_wal_t* wal, const cauchy_wal_record_t* rec);
+
+/* Empty the log once a snapshot covering every record has been
+ * committed. No thread may append concurrently. */
+cauchy_result_t cauchy_wal_reset(cauchy_wal_t* wal);
+
+void cauchy_wal_get_stats(cauchy_wal_t* wal, cauchy_wal_stats_t* out);
+
+/* Replay callback; an error stops the replay and is returned */
+typedef cauchy_result_t (*cauchy_wal_apply_fn)(void* arg, const cauchy_wal_record_t* rec);
+
+/* Call fn on each intact record of the log at path, in log order, except
+ * those whose uid the clock `applied` already covers. Afterwards applied
+ * also covers every replayed uid. Merge it into the context with
+ * cauchy_context_merge_clock so new uids do not repeat replayed ones.
+ * A missing file, or one whose header write was torn, is an empty log.
+ * *replayed (if non-NULL) receives the
+ * number of records applied. */
+cauchy_result_t cauchy_wal_replay(const char* path, cauchy_vclock_t* applied,
+                                  cauchy_wal_apply_fn fn, void* arg, usize* replayed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_WAL_H */
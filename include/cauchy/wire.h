@@ -0,0 +1,92 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Portable Wire Encoding Helpers
+ *
+ * Byte-order independent primitives shared by the compact encoders:
+ * unsigned LEB128 varints, zigzag mapping for signed deltas, and fixed
+ * little-endian integers.
+ */
+
+#ifndef CAUCHY_WIRE_H
+#define CAUCHY_WIRE_H
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Longest LEB128 encoding of a u64 */
+#define CAUCHY_VARINT_MAX 10
+
+/* Bytes needed to encode v as a varint */
+CAUCHY_INLINE usize cauchy_varint_size(u64 v) {
+    usize n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+/* Append v at buf[*pos]; false (nothing written) if it does not fit */
+CAUCHY_INLINE bool cauchy_varint_put(u8* buf, usize size, usize* pos, u64 v) {
+    if (*pos > size || size - *pos < cauchy_varint_size(v)) return false;
+    while (v >= 0x80) {
+        buf[(*pos)++] = (u8)(v | 0x80);
+        v >>= 7;
+    }
+    buf[(*pos)++] = (u8)v;
+    return true;
+}
+
+/* Read a varint at buf[*pos]; false on truncation or overlong input */
+CAUCHY_INLINE bool cauchy_varint_get(const u8* buf, usize size, usize* pos, u64* v) {
+    u64 result = 0;
+    for (u32 shift = 0; shift < 64 && *pos < size; shift += 7) {
+        u8 byte = buf[(*pos)++];
+        if (shift == 63 && byte > 1) return false;
+        result |= (u64)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *v = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Signed <-> unsigned so small magnitudes stay short */
+CAUCHY_INLINE u64 cauchy_zigzag_encode(i64 v) {
+    return ((u64)v << 1) ^ (u64)(v >> 63);
+}
+
+CAUCHY_INLINE i64 cauchy_zigzag_decode(u64 v) {
+    return (i64)(v >> 1) ^ -(i64)(v & 1);
+}
+
+/* Fixed-width little-endian integers */
+CAUCHY_INLINE void cauchy_wire_put_u32(u8* p, u32 v) {
+    for (int i = 0; i < 4; i++) p[i] = (u8)(v >> (8 * i));
+}
+
+CAUCHY_INLINE u32 cauchy_wire_get_u32(const u8* p) {
+    u32 v = 0;
+    for (int i = 0; i < 4; i++) v |= (u32)p[i] << (8 * i);
+    return v;
+}
+
+CAUCHY_INLINE void cauchy_wire_put_u64(u8* p, u64 v) {
+    for (int i = 0; i < 8; i++) p[i] = (u8)(v >> (8 * i));
+}
+
+CAUCHY_INLINE u64 cauchy_wire_get_u64(const u8* p) {
+    u64 v = 0;
+    for (int i = 0; i < 8; i++) v |= (u64)p[i] << (8 * i);
+    return v;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAUCHY_WIRE_H */
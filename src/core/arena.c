@@ -0,0 +1,97 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Bump Arena Implementation
+ */
+
+#include "cauchy/memory.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_ALIGN sizeof(void*)
+
+struct cauchy_arena_chunk {
+    struct cauchy_arena_chunk* next;
+    usize                      size;  /* Usable bytes after the header */
+};
+
+/* Chunk header rounded so the payload starts aligned */
+#define ARENA_HEADER \
+    ((sizeof(cauchy_arena_chunk_t) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+static cauchy_arena_chunk_t* chunk_alloc(cauchy_arena_t* arena, usize size) {
+    cauchy_arena_chunk_t* chunk = malloc(ARENA_HEADER + size);
+    if (!chunk) return NULL;
+    chunk->size = size;
+    arena->reserved += ARENA_HEADER + size;
+    return chunk;
+}
+
+void cauchy_arena_init(cauchy_arena_t* arena, usize chunk_size) {
+    if (!arena) return;
+    memset(arena, 0, sizeof(cauchy_arena_t));
+    arena->chunk_size = chunk_size ? chunk_size : CAUCHY_ARENA_CHUNK_SIZE;
+}
+
+void cauchy_arena_destroy(cauchy_arena_t* arena) {
+    if (!arena) return;
+    cauchy_arena_chunk_t* chunk = arena->chunks;
+    while (chunk) {
+        cauchy_arena_chunk_t* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    memset(arena, 0, sizeof(cauchy_arena_t));
+}
+
+void* cauchy_arena_alloc(cauchy_arena_t* arena, usize size) {
+    if (!arena || size == 0) return NULL;
+    size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+    if (CAUCHY_LIKELY((usize)(arena->limit - arena->cursor) >= size)) {
+        void* p = arena->cursor;
+        arena->cursor += size;
+        return p;
+    }
+
+    if (size > arena->chunk_size / 4) {
+        /* Dedicated chunk, linked behind the current one */
+        cauchy_arena_chunk_t* chunk = chunk_alloc(arena, size);
+        if (!chunk) return NULL;
+        if (arena->chunks) {
+            chunk->next = arena->chunks->next;
+            arena->chunks->next = chunk;
+        } else {
+            chunk->next = NULL;
+            arena->chunks = chunk;
+        }
+        return (u8*)chunk + ARENA_HEADER;
+    }
+
+    cauchy_arena_chunk_t* chunk = chunk_alloc(arena, arena->chunk_size);
+    if (!chunk) return NULL;
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+
+    u8* base = (u8*)chunk + ARENA_HEADER;
+    arena->cursor = base + size;
+    arena->limit = base + chunk->size;
+    return base;
+}
+
+void cauchy_arena_absorb(cauchy_arena_t* arena, cauchy_arena_t* other) {
+    if (!arena || !other || arena == other || !other->chunks) return;
+
+    /* Behind arena's current chunk, so its bump cursor stays valid */
+    cauchy_arena_chunk_t* last = other->chunks;
+    while (last->next) last = last->next;
+    if (arena->chunks) {
+        last->next = arena->chunks->next;
+        arena->chunks->next = other->chunks;
+    } else {
+        arena->chunks = other->chunks;
+        arena->cursor = other->cursor;
+        arena->limit = other->limit;
+    }
+    arena->reserved += other->reserved;
+    cauchy_arena_init(other, other->chunk_size);
+}
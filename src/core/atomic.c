@@ -29,7 +29,7 @@ bool cauchy_atomic_cas_u128(cauchy_atomic_u128_t* ptr,
 cauchy_u128_t cauchy_atomic_load_u128(const cauchy_atomic_u128_t* ptr) {
     cauchy_u128_t result = {0, 0};
     __asm__ __volatile__(
-        "lock cmpxchg16b %1"
+        "lock cmpxchg16b %2"
         : "+a" (result.lo),
           "+d" (result.hi)
         : "m" (*ptr),
@@ -47,8 +47,52 @@ void cauchy_atomic_store_u128(cauchy_atomic_u128_t* ptr, cauchy_u128_t val) {
     }
 }
 
+#elif defined(CAUCHY_ARCH_ARM64) && !CAUCHY_DWCAS_LLSC
+
+/* ARMv8.1 LSE: CASPAL compares and swaps an even/odd register pair */
+bool cauchy_atomic_cas_u128(cauchy_atomic_u128_t* ptr,
+                            cauchy_u128_t* expected,
+                            cauchy_u128_t desired) {
+    u64 old_lo = expected->lo;
+    u64 old_hi = expected->hi;
+    register u64 x0 __asm__("x0") = old_lo;
+    register u64 x1 __asm__("x1") = old_hi;
+    register u64 x2 __asm__("x2") = desired.lo;
+    register u64 x3 __asm__("x3") = desired.hi;
+
+    __asm__ __volatile__(
+        "caspal %[lo], %[hi], %[new_lo], %[new_hi], %[ptr]"
+        : [lo] "+r" (x0),
+          [hi] "+r" (x1),
+          [ptr] "+Q" (*ptr)
+        : [new_lo] "r" (x2),
+          [new_hi] "r" (x3)
+        : "memory"
+    );
+
+    bool result = (x0 == old_lo && x1 == old_hi);
+    expected->lo = x0;
+    expected->hi = x1;
+    return result;
+}
+
+cauchy_u128_t cauchy_atomic_load_u128(const cauchy_atomic_u128_t* ptr) {
+    /* A CAS of zero against zero returns the current value atomically */
+    cauchy_u128_t result = {0, 0};
+    cauchy_atomic_cas_u128((cauchy_atomic_u128_t*)ptr, &result, result);
+    return result;
+}
+
+void cauchy_atomic_store_u128(cauchy_atomic_u128_t* ptr, cauchy_u128_t val) {
+    cauchy_u128_t expected = cauchy_atomic_load_u128(ptr);
+    while (!cauchy_atomic_cas_u128(ptr, &expected, val)) {
+        CAUCHY_CPU_PAUSE();
+    }
+}
+
 #elif defined(CAUCHY_ARCH_ARM64)
 
+/* ARMv8.0 LL/SC: LDAXP/STLXP retry loop */
 bool cauchy_atomic_cas_u128(cauchy_atomic_u128_t* ptr,
                             cauchy_u128_t* expected,
                             cauchy_u128_t desired) {
@@ -66,7 +110,8 @@ bool cauchy_atomic_cas_u128(cauchy_atomic_u128_t* ptr,
         "   cbnz %w[res], 1b\n"
         "   mov %w[res], #1\n"
         "   b 3f\n"
-        "2: mov %w[res], #0\n"
+        "2: clrex\n"
+        "   mov %w[res], #0\n"
         "3:\n"
         : [lo] "=&r" (new_lo),
           [hi] "=&r" (new_hi),
@@ -87,11 +132,19 @@ bool cauchy_atomic_cas_u128(cauchy_atomic_u128_t* ptr,
 }
 
 cauchy_u128_t cauchy_atomic_load_u128(const cauchy_atomic_u128_t* ptr) {
+    /* LDAXP alone is not single-copy atomic for the pair; the value is only
+     * known consistent once a store-exclusive of it succeeds. */
     cauchy_u128_t result;
+    u32 failed;
     __asm__ __volatile__(
-        "ldaxp %0, %1, %2"
-        : "=&r" (result.lo), "=&r" (result.hi)
-        : "Q" (*ptr)
+        "1: ldaxp %[lo], %[hi], %[ptr]\n"
+        "   stlxp %w[res], %[lo], %[hi], %[ptr]\n"
+        "   cbnz %w[res], 1b\n"
+        : [lo] "=&r" (result.lo),
+          [hi] "=&r" (result.hi),
+          [res] "=&r" (failed),
+          [ptr] "+Q" (*(cauchy_atomic_u128_t*)ptr)
+        :
         : "memory"
     );
     return result;
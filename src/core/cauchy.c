@@ -34,6 +34,11 @@ void cauchy_version_info(int* major, int* minor, int* patch) {
 }
 
 cauchy_context_t* cauchy_context_create(cauchy_node_id_t node_id) {
+    return cauchy_context_create_ex(node_id, CAUCHY_RECLAIM_HAZARD);
+}
+
+cauchy_context_t* cauchy_context_create_ex(cauchy_node_id_t node_id,
+                                           cauchy_reclaim_mode_t mode) {
     cauchy_context_t* ctx = cauchy_aligned_alloc(
         sizeof(cauchy_context_t), CAUCHY_CACHE_LINE_SIZE);
     if (!ctx) return NULL;
@@ -51,8 +56,13 @@ cauchy_context_t* cauchy_context_create(cauchy_node_id_t node_id) {
         return NULL;
     }
 
-    ctx->hazard_domain = cauchy_hazard_domain_create();
-    if (!ctx->hazard_domain) {
+    ctx->reclaim_mode = mode;
+    if (mode == CAUCHY_RECLAIM_EPOCH) {
+        ctx->epoch_domain = cauchy_epoch_domain_create();
+    } else {
+        ctx->hazard_domain = cauchy_hazard_domain_create();
+    }
+    if (!ctx->hazard_domain && !ctx->epoch_domain) {
         cauchy_pool_destroy(ctx->mem_pool);
         cauchy_aligned_free(ctx);
         return NULL;
@@ -68,9 +78,13 @@ void cauchy_context_destroy(cauchy_context_t* ctx) {
     if (ctx->hazard_domain) {
         cauchy_hazard_domain_destroy(ctx->hazard_domain);
     }
+    if (ctx->epoch_domain) {
+        cauchy_epoch_domain_destroy(ctx->epoch_domain);
+    }
     if (ctx->mem_pool) {
         cauchy_pool_destroy(ctx->mem_pool);
     }
+    cauchy_vclock_fini(&ctx->local_clock);
     cauchy_aligned_free(ctx);
 }
 
@@ -104,3 +118,67 @@ void cauchy_context_merge_clock(cauchy_context_t* ctx, const cauchy_vclock_t* re
     cauchy_vclock_increment(&ctx->local_clock, ctx->node_id);
 }
 
+
+cauchy_result_t cauchy_context_retire(cauchy_context_t* ctx, void* node,
+                                      cauchy_retire_fn retire_fn, void* arg) {
+    if (!ctx || !node) return CAUCHY_ERR_INVALID;
+    if (ctx->reclaim_mode == CAUCHY_RECLAIM_EPOCH) {
+        return cauchy_epoch_retire(ctx->epoch_domain, node, retire_fn, arg);
+    }
+    cauchy_hazard_retire(ctx->hazard_domain, node, retire_fn, arg);
+    return CAUCHY_OK;
+}
+
+usize cauchy_context_reclaim(cauchy_context_t* ctx) {
+    if (!ctx) return 0;
+    if (ctx->reclaim_mode == CAUCHY_RECLAIM_EPOCH) {
+        return cauchy_epoch_reclaim(ctx->epoch_domain);
+    }
+    return cauchy_hazard_reclaim(ctx->hazard_domain);
+}
+
+cauchy_result_t cauchy_context_get_stats(const cauchy_context_t* ctx,
+                                         cauchy_context_stats_t* out) {
+    if (!ctx || !out) return CAUCHY_ERR_INVALID;
+    out->node_id = ctx->node_id;
+    out->ops = ctx->op_counter;
+    out->pool = cauchy_pool_get_stats(ctx->mem_pool);
+    out->reclaim_pending = ctx->reclaim_mode == CAUCHY_RECLAIM_EPOCH
+        ? cauchy_epoch_pending(ctx->epoch_domain)
+        : cauchy_hazard_pending(ctx->hazard_domain);
+    cauchy_stats_snapshot(&out->process);
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_context_snapshot_save(const cauchy_context_t* ctx,
+                                             cauchy_snapshot_writer_t* w) {
+    if (!ctx || !w) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_snapshot_writer_begin(w, CAUCHY_SNAPSHOT_CONTEXT, ctx->node_id);
+    if (res != CAUCHY_OK) return res;
+    res = cauchy_snapshot_writer_put_u64(w, ctx->op_counter);
+    if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put_vclock(w, &ctx->local_clock);
+    cauchy_result_t end = cauchy_snapshot_writer_end(w);
+    return res != CAUCHY_OK ? res : end;
+}
+
+cauchy_result_t cauchy_context_snapshot_load(cauchy_context_t* ctx, cauchy_snapshot_t* snap) {
+    if (!ctx) return CAUCHY_ERR_INVALID;
+    const u8* data;
+    usize size;
+    cauchy_result_t res = cauchy_snapshot_find(snap, CAUCHY_SNAPSHOT_CONTEXT, ctx->node_id,
+                                               &data, &size);
+    if (res != CAUCHY_OK) return res;
+
+    cauchy_snapshot_cursor_t cur;
+    cauchy_vclock_t clock;
+    u64 ops;
+    cauchy_snapshot_cursor_init(&cur, data, size);
+    if (!cauchy_snapshot_get_u64(&cur, &ops) || !cauchy_snapshot_get_vclock(&cur, &clock)) {
+        return CAUCHY_ERR_INVALID;
+    }
+    res = cauchy_vclock_merge(&ctx->local_clock, &clock);
+    cauchy_vclock_fini(&clock);
+    if (res != CAUCHY_OK) return res;
+    if (ops > ctx->op_counter) ctx->op_counter = ops;
+    return CAUCHY_OK;
+}
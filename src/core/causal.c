@@ -0,0 +1,267 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Causal Delivery Buffer Implementation
+ */
+
+#include "cauchy/causal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* A held op: the dependencies still missing on arrival, then the payload */
+typedef struct held {
+    cauchy_uid_t         dot;
+    cauchy_uid_t         wait;     /* Dependency it is waiting under */
+    struct held*         next;     /* Wake list */
+    usize                size;
+    u32                  deps;
+    u32                  cursor;   /* Pairs before it are satisfied */
+    cauchy_vclock_pair_t pairs[];
+} held_t;
+
+CAUCHY_INLINE u64 dot_hash(const cauchy_uid_t* dot) {
+    u64 key[2] = { dot->node_id, dot->timestamp };
+    return cauchy_hash_bytes(key, sizeof(key));
+}
+
+CAUCHY_INLINE u8* held_data(held_t* h) {
+    return (u8*)(h->pairs + h->deps);
+}
+
+CAUCHY_INLINE usize held_bytes(const held_t* h) {
+    return sizeof(held_t) + h->deps * sizeof(cauchy_vclock_pair_t) + h->size;
+}
+
+CAUCHY_INLINE bool covered(const cauchy_causal_t* c, cauchy_node_id_t node, u64 counter) {
+    return counter <= cauchy_vclock_get(&c->delivered, node);
+}
+
+cauchy_result_t cauchy_causal_init(cauchy_causal_t* c, const cauchy_causal_config_t* config,
+                                   cauchy_causal_deliver_fn deliver, void* arg) {
+    if (!c || !deliver) return CAUCHY_ERR_INVALID;
+    cauchy_causal_config_t defaults = CAUCHY_CAUSAL_CONFIG_DEFAULT;
+    c->config = config ? *config : defaults;
+    c->deliver = deliver;
+    c->arg = arg;
+    cauchy_result_t res = cauchy_htable_init(&c->by_dot, 16);
+    if (res != CAUCHY_OK) return res;
+    res = cauchy_htable_init(&c->waiting, 16);
+    if (res != CAUCHY_OK) {
+        cauchy_htable_destroy(&c->by_dot);
+        return res;
+    }
+    cauchy_vclock_init(&c->delivered, 0);
+    memset(&c->stats, 0, sizeof(c->stats));
+    return CAUCHY_OK;
+}
+
+void cauchy_causal_fini(cauchy_causal_t* c) {
+    if (!c) return;
+    cauchy_htable_iter_t iter;
+    cauchy_htable_iter_init(&iter, &c->by_dot);
+    held_t* h;
+    while ((h = cauchy_htable_iter_next(&iter)) != NULL) free(h);
+    cauchy_htable_destroy(&c->by_dot);
+    cauchy_htable_destroy(&c->waiting);
+    cauchy_vclock_fini(&c->delivered);
+    c->stats.held = 0;
+    c->stats.held_bytes = 0;
+}
+
+static bool is_held(const cauchy_causal_t* c, const cauchy_uid_t* dot) {
+    cauchy_htable_probe_t probe;
+    cauchy_htable_probe_init(&probe, &c->by_dot, dot_hash(dot));
+    const held_t* h;
+    while ((h = cauchy_htable_probe_next(&probe)) != NULL) {
+        if (cauchy_uid_equals(&h->dot, dot)) return true;
+    }
+    return false;
+}
+
+/* Skip satisfied dependencies; false, with wait set, at a missing one */
+static bool held_ready(const cauchy_causal_t* c, held_t* h) {
+    while (h->cursor < h->deps) {
+        const cauchy_vclock_pair_t* p = &h->pairs[h->cursor];
+        if (!covered(c, p->node_id, p->value)) {
+            h->wait = cauchy_uid_create(p->node_id, p->value);
+            return false;
+        }
+        h->cursor++;
+    }
+    return true;
+}
+
+static void drop(cauchy_causal_t* c, held_t* h) {
+    cauchy_htable_remove(&c->by_dot, dot_hash(&h->dot), h);
+    c->stats.held--;
+    c->stats.held_bytes -= held_bytes(h);
+    free(h);
+}
+
+/* Move the ops waiting for dot onto the wake list */
+static void wake(cauchy_causal_t* c, const cauchy_uid_t* dot, held_t** list) {
+    u64 hash = dot_hash(dot);
+    held_t* woken = NULL;
+    cauchy_htable_probe_t probe;
+    cauchy_htable_probe_init(&probe, &c->waiting, hash);
+    held_t* h;
+    while ((h = cauchy_htable_probe_next(&probe)) != NULL) {
+        if (!cauchy_uid_equals(&h->wait, dot)) continue;
+        h->next = woken;
+        woken = h;
+    }
+    while (woken) {
+        h = woken;
+        woken = h->next;
+        cauchy_htable_remove(&c->waiting, hash, h);
+        h->next = *list;
+        *list = h;
+    }
+}
+
+/* Record a delivery and wake what waited for it */
+static cauchy_result_t delivered(cauchy_causal_t* c, const cauchy_uid_t* dot, held_t** list,
+                                 usize* count) {
+    cauchy_result_t res = cauchy_vclock_set(&c->delivered, dot->node_id, dot->timestamp);
+    if (res != CAUCHY_OK) return res;
+    c->stats.delivered++;
+    (*count)++;
+    wake(c, dot, list);
+    return CAUCHY_OK;
+}
+
+/* Deliver or re-park every woken op, and whatever each delivery wakes */
+static cauchy_result_t release(cauchy_causal_t* c, held_t* list, usize* count) {
+    cauchy_result_t first = CAUCHY_OK;
+    while (list) {
+        held_t* h = list;
+        list = h->next;
+        if (covered(c, h->dot.node_id, h->dot.timestamp)) {
+            c->stats.duplicates++;
+            drop(c, h);
+            continue;
+        }
+        if (!held_ready(c, h)) {
+            cauchy_result_t res = cauchy_htable_insert(&c->waiting, dot_hash(&h->wait), h);
+            if (res != CAUCHY_OK) {
+                if (first == CAUCHY_OK) first = res;
+                drop(c, h);
+            }
+            continue;
+        }
+        cauchy_causal_op_t op = { h->dot, NULL, held_data(h), h->size };
+        cauchy_result_t res = c->deliver(c->arg, &op);
+        if (res == CAUCHY_OK) res = delivered(c, &h->dot, &list, count);
+        if (res != CAUCHY_OK && first == CAUCHY_OK) first = res;
+        drop(c, h);
+    }
+    return first;
+}
+
+cauchy_result_t cauchy_causal_receive(cauchy_causal_t* c, const cauchy_causal_op_t* op,
+                                      usize* delivered_count) {
+    usize count = 0;
+    if (delivered_count) *delivered_count = 0;
+    if (!c || !op || op->dot.timestamp == 0 || (op->size && !op->data)) {
+        return CAUCHY_ERR_INVALID;
+    }
+    cauchy_node_id_t origin = op->dot.node_id;
+    if (covered(c, origin, op->dot.timestamp) || is_held(c, &op->dot)) {
+        c->stats.duplicates++;
+        return CAUCHY_OK;
+    }
+
+    /* Dependencies not yet delivered, the origin's previous op first */
+    u32 missing = !covered(c, origin, op->dot.timestamp - 1);
+    cauchy_vclock_iter_t iter;
+    cauchy_node_id_t node;
+    u64 value;
+    if (op->deps) {
+        cauchy_vclock_iter_init(&iter, op->deps);
+        while (cauchy_vclock_iter_next(&iter, &node, &value)) {
+            missing += node != origin && !covered(c, node, value);
+        }
+    }
+
+    if (missing == 0) {
+        cauchy_result_t res = c->deliver(c->arg, op);
+        held_t* list = NULL;
+        if (res == CAUCHY_OK) res = delivered(c, &op->dot, &list, &count);
+        cauchy_result_t woken = release(c, list, &count);
+        if (delivered_count) *delivered_count = count;
+        return res != CAUCHY_OK ? res : woken;
+    }
+
+    usize bytes = sizeof(held_t) + missing * sizeof(cauchy_vclock_pair_t) + op->size;
+    if (c->stats.held >= c->config.max_ops ||
+        c->stats.held_bytes + bytes > c->config.max_bytes) {
+        c->stats.refused++;
+        return CAUCHY_ERR_FULL;
+    }
+    held_t* h = malloc(bytes);
+    if (!h) return CAUCHY_ERR_NOMEM;
+    h->dot = op->dot;
+    h->next = NULL;
+    h->size = op->size;
+    h->deps = 0;
+    h->cursor = 0;
+    if (!covered(c, origin, op->dot.timestamp - 1)) {
+        h->pairs[h->deps++] = (cauchy_vclock_pair_t){ origin, op->dot.timestamp - 1 };
+    }
+    if (op->deps) {
+        cauchy_vclock_iter_init(&iter, op->deps);
+        while (cauchy_vclock_iter_next(&iter, &node, &value)) {
+            if (node != origin && !covered(c, node, value)) {
+                h->pairs[h->deps++] = (cauchy_vclock_pair_t){ node, value };
+            }
+        }
+    }
+    if (op->size) memcpy(held_data(h), op->data, op->size);
+    held_ready(c, h);
+
+    cauchy_result_t res = cauchy_htable_insert(&c->by_dot, dot_hash(&h->dot), h);
+    if (res == CAUCHY_OK) {
+        res = cauchy_htable_insert(&c->waiting, dot_hash(&h->wait), h);
+        if (res != CAUCHY_OK) cauchy_htable_remove(&c->by_dot, dot_hash(&h->dot), h);
+    }
+    if (res != CAUCHY_OK) {
+        free(h);
+        return res;
+    }
+    c->stats.held++;
+    c->stats.held_bytes += bytes;
+    c->stats.deferred++;
+    return CAUCHY_OK;
+}
+
+cauchy_uid_t cauchy_causal_local(cauchy_causal_t* c, cauchy_node_id_t self) {
+    cauchy_uid_t dot = cauchy_uid_create(self, cauchy_vclock_get(&c->delivered, self) + 1);
+    cauchy_vclock_set(&c->delivered, self, dot.timestamp);
+    return dot;
+}
+
+cauchy_result_t cauchy_causal_advance(cauchy_causal_t* c, const cauchy_vclock_t* clock,
+                                      usize* delivered_count) {
+    usize count = 0;
+    if (delivered_count) *delivered_count = 0;
+    if (!c || !clock) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_vclock_merge(&c->delivered, clock);
+    if (res != CAUCHY_OK) return res;
+
+    /* A jump can satisfy any number of waits at once: one pass over the
+     * held ops instead of a probe per counter skipped */
+    held_t* list = NULL;
+    cauchy_htable_iter_t iter;
+    cauchy_htable_iter_init(&iter, &c->waiting);
+    held_t* h;
+    while ((h = cauchy_htable_iter_next(&iter)) != NULL) {
+        if (covered(c, h->dot.node_id, h->dot.timestamp) ||
+            covered(c, h->wait.node_id, h->wait.timestamp)) {
+            h->next = list;
+            list = h;
+        }
+    }
+    for (h = list; h; h = h->next) cauchy_htable_remove(&c->waiting, dot_hash(&h->wait), h);
+    res = release(c, list, &count);
+    if (delivered_count) *delivered_count = count;
+    return res;
+}
@@ -0,0 +1,373 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Epoch-Based Reclamation Implementation
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE  /* syscall(2) */
+#endif
+
+#include "cauchy/memory.h"
+#include "cauchy/stats.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(CAUCHY_OS_LINUX)
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+/* Low bit of a record's local epoch: set while inside a critical section */
+#define EPOCH_ACTIVE 1ULL
+
+/* Owner value while an exited thread's record is being adopted */
+#define EPOCH_OWNER_ADOPTING UINT64_MAX
+
+/* membarrier(2) commands, spelled out so <linux/membarrier.h> is optional */
+#define EPOCH_MEMBARRIER_PRIVATE_EXPEDITED          (1 << 3)
+#define EPOCH_MEMBARRIER_REGISTER_PRIVATE_EXPEDITED (1 << 4)
+
+/* Retired node tagged with the global epoch at retirement */
+typedef struct epoch_retired {
+    void*            ptr;
+    cauchy_retire_fn retire_fn;
+    void*            ctx;
+    u64              epoch;
+    struct epoch_retired* next;
+} epoch_retired_t;
+
+/* Per-thread epoch record, indexed by cauchy_thread_id() */
+typedef struct CAUCHY_CACHE_ALIGNED epoch_record {
+    cauchy_atomic_u64_t local;  /* (epoch << 1) | EPOCH_ACTIVE while inside */
+    cauchy_atomic_u64_t owner;  /* Owner's thread generation, 0 = unowned */
+    u32 nesting;
+    cauchy_atomic_u32_t retired_count;  /* Owner-written, summed by cauchy_epoch_pending */
+    epoch_retired_t* retired_list;
+} epoch_record_t;
+
+/* Epoch domain */
+struct cauchy_epoch_domain {
+    CAUCHY_CACHE_ALIGNED cauchy_atomic_u64_t global;
+    CAUCHY_CACHE_ALIGNED cauchy_atomic_ptr_t records[CAUCHY_MAX_THREADS];
+    cauchy_atomic_u32_t record_count;  /* High-water mark of thread ids + 1 */
+    cauchy_atomic_u64_t overflow;      /* Readers without a record */
+    cauchy_atomic_ptr_t orphans;       /* Retired by threads without a record */
+    cauchy_pool_t*      retired_pool;
+};
+
+/* Relaxed accessors: only the owner (or an adopter) writes the count */
+CAUCHY_INLINE u32 retired_count(const epoch_record_t* rec) {
+    return atomic_load_explicit(&rec->retired_count, memory_order_relaxed);
+}
+
+CAUCHY_INLINE void set_retired_count(epoch_record_t* rec, u32 count) {
+    atomic_store_explicit(&rec->retired_count, count, memory_order_relaxed);
+}
+
+/* 1 once membarrier(2) is registered: readers then need no CPU fence */
+static cauchy_atomic_bool_t epoch_asymmetric = false;
+
+static void epoch_register_membarrier(void) {
+#if defined(CAUCHY_OS_LINUX) && defined(__NR_membarrier)
+    if (atomic_load_explicit(&epoch_asymmetric, memory_order_relaxed)) return;
+    if (syscall(__NR_membarrier, EPOCH_MEMBARRIER_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0) {
+        atomic_store(&epoch_asymmetric, true);
+    }
+#endif
+}
+
+/* Reader-side half of the fence pair */
+CAUCHY_INLINE void epoch_light_fence(void) {
+    if (CAUCHY_LIKELY(atomic_load_explicit(&epoch_asymmetric, memory_order_relaxed))) {
+        CAUCHY_COMPILER_BARRIER();
+    } else {
+        cauchy_atomic_fence_seq_cst();
+    }
+}
+
+/* Reclaimer-side half: a full fence on every running thread */
+static void epoch_heavy_fence(void) {
+#if defined(CAUCHY_OS_LINUX) && defined(__NR_membarrier)
+    if (atomic_load_explicit(&epoch_asymmetric, memory_order_relaxed) &&
+        syscall(__NR_membarrier, EPOCH_MEMBARRIER_PRIVATE_EXPEDITED, 0, 0) == 0) {
+        return;
+    }
+#endif
+    cauchy_atomic_fence_seq_cst();
+}
+
+static epoch_record_t* claim_epoch_record(cauchy_epoch_domain_t* domain,
+                                          u32 tid, u64 gen,
+                                          epoch_record_t* rec) {
+    if (!rec) {
+        rec = cauchy_aligned_alloc(sizeof(epoch_record_t), CAUCHY_CACHE_LINE_SIZE);
+        if (!rec) return NULL;
+        memset(rec, 0, sizeof(epoch_record_t));
+        atomic_init(&rec->owner, gen);
+        cauchy_atomic_store_ptr(&domain->records[tid], rec);
+
+        u32 count = cauchy_atomic_load_u32(&domain->record_count);
+        while (count < tid + 1 &&
+               !cauchy_atomic_cas_u32(&domain->record_count, &count, tid + 1)) {
+        }
+        return rec;
+    }
+
+    u64 owner = cauchy_atomic_load_u64(&rec->owner);
+    for (;;) {
+        if (owner == EPOCH_OWNER_ADOPTING) {
+            CAUCHY_CPU_PAUSE();
+            owner = cauchy_atomic_load_u64(&rec->owner);
+            continue;
+        }
+        if (cauchy_atomic_cas_u64(&rec->owner, &owner, gen)) break;
+    }
+    rec->nesting = 0;
+    cauchy_atomic_store_u64(&rec->local, 0);
+    return rec;
+}
+
+static epoch_record_t* get_epoch_record(cauchy_epoch_domain_t* domain) {
+    u32 tid = cauchy_thread_id();
+    if (CAUCHY_UNLIKELY(tid == CAUCHY_THREAD_ID_INVALID)) return NULL;
+
+    u64 gen = cauchy_thread_generation();
+    epoch_record_t* rec = cauchy_atomic_load_ptr(&domain->records[tid]);
+    if (CAUCHY_LIKELY(rec != NULL) &&
+        atomic_load_explicit(&rec->owner, memory_order_relaxed) == gen) {
+        return rec;
+    }
+    return claim_epoch_record(domain, tid, gen, rec);
+}
+
+cauchy_epoch_domain_t* cauchy_epoch_domain_create(void) {
+    cauchy_epoch_domain_t* domain = cauchy_aligned_alloc(
+        sizeof(cauchy_epoch_domain_t), CAUCHY_CACHE_LINE_SIZE);
+    if (!domain) return NULL;
+
+    memset(domain, 0, sizeof(cauchy_epoch_domain_t));
+    atomic_init(&domain->global, 2);  /* So epoch - 2 never underflows */
+
+    cauchy_pool_config_t cfg = {
+        .block_size = sizeof(epoch_retired_t),
+        .initial_blocks = 256,
+        .max_blocks = 0,
+        .alignment = sizeof(void*)
+    };
+    domain->retired_pool = cauchy_pool_create(&cfg);
+    if (!domain->retired_pool) {
+        cauchy_aligned_free(domain);
+        return NULL;
+    }
+
+    epoch_register_membarrier();
+    return domain;
+}
+
+static void run_retired_list(epoch_retired_t* node) {
+    while (node) {
+        epoch_retired_t* next = node->next;
+        if (node->retire_fn) node->retire_fn(node->ptr, node->ctx);
+        node = next;
+    }
+}
+
+void cauchy_epoch_domain_destroy(cauchy_epoch_domain_t* domain) {
+    if (!domain) return;
+
+    for (u32 i = 0; i < CAUCHY_MAX_THREADS; i++) {
+        epoch_record_t* rec = cauchy_atomic_load_ptr(&domain->records[i]);
+        if (!rec) continue;
+        run_retired_list(rec->retired_list);
+        cauchy_aligned_free(rec);
+    }
+    run_retired_list(cauchy_atomic_load_ptr(&domain->orphans));
+
+    cauchy_pool_destroy(domain->retired_pool);
+    cauchy_aligned_free(domain);
+}
+
+void cauchy_epoch_enter(cauchy_epoch_domain_t* domain) {
+    if (!domain) return;
+
+    epoch_record_t* rec = get_epoch_record(domain);
+    if (CAUCHY_UNLIKELY(!rec)) {
+        cauchy_atomic_fetch_add_u64(&domain->overflow, 1);
+        return;
+    }
+    if (rec->nesting++ > 0) return;
+
+    u64 epoch = atomic_load_explicit(&domain->global, memory_order_relaxed);
+    atomic_store_explicit(&rec->local, (epoch << 1) | EPOCH_ACTIVE, memory_order_relaxed);
+    epoch_light_fence();
+}
+
+void cauchy_epoch_exit(cauchy_epoch_domain_t* domain) {
+    if (!domain) return;
+
+    epoch_record_t* rec = get_epoch_record(domain);
+    if (CAUCHY_UNLIKELY(!rec)) {
+        cauchy_atomic_fetch_sub_u64(&domain->overflow, 1);
+        return;
+    }
+    if (rec->nesting == 0 || --rec->nesting > 0) return;
+
+    atomic_store_explicit(&rec->local, 0, memory_order_release);
+}
+
+cauchy_result_t cauchy_epoch_retire(cauchy_epoch_domain_t* domain, void* node,
+                                    cauchy_retire_fn retire_fn, void* ctx) {
+    if (!domain || !node) return CAUCHY_ERR_INVALID;
+
+    epoch_retired_t* rn = cauchy_pool_alloc(domain->retired_pool);
+    if (!rn) {
+        /* Freeing immediately is never safe under EBR, and waiting is
+         * not either: a caller inside a critical section holds back the
+         * epoch it would wait for. Reclaim once, then give up. */
+        cauchy_epoch_reclaim(domain);
+        rn = cauchy_pool_alloc(domain->retired_pool);
+        if (!rn) return CAUCHY_ERR_NOMEM;
+    }
+
+    rn->ptr = node;
+    rn->retire_fn = retire_fn;
+    rn->ctx = ctx;
+    rn->epoch = cauchy_atomic_load_u64(&domain->global);
+
+    epoch_record_t* rec = get_epoch_record(domain);
+    if (CAUCHY_UNLIKELY(!rec)) {
+        epoch_retired_t* head = cauchy_atomic_load_ptr(&domain->orphans);
+        do {
+            rn->next = head;
+        } while (!cauchy_atomic_cas_ptr(&domain->orphans, (void**)&head, rn));
+        return CAUCHY_OK;
+    }
+
+    rn->next = rec->retired_list;
+    rec->retired_list = rn;
+    u32 pending = retired_count(rec) + 1;
+    set_retired_count(rec, pending);
+    CAUCHY_STAT_ADD(CAUCHY_STAT_EPOCH_RETIRED, 1);
+
+    if (pending >= CAUCHY_EPOCH_RECLAIM_THRESHOLD) {
+        cauchy_epoch_reclaim(domain);
+    }
+    return CAUCHY_OK;
+}
+
+static void splice_retired(epoch_record_t* self, epoch_retired_t* list) {
+    u32 count = retired_count(self);
+    while (list) {
+        epoch_retired_t* next = list->next;
+        list->next = self->retired_list;
+        self->retired_list = list;
+        count++;
+        list = next;
+    }
+    set_retired_count(self, count);
+}
+
+/* Take over the retired lists of exited threads and of record-less
+ * threads so their memory is freed by someone. */
+static void adopt_orphans(cauchy_epoch_domain_t* domain, epoch_record_t* self, u32 count) {
+    for (u32 i = 0; i < count; i++) {
+        epoch_record_t* rec = cauchy_atomic_load_ptr(&domain->records[i]);
+        if (!rec || rec == self) continue;
+
+        u64 owner = cauchy_atomic_load_u64(&rec->owner);
+        if (owner == 0 || owner == EPOCH_OWNER_ADOPTING ||
+            cauchy_thread_alive(i, owner)) {
+            continue;
+        }
+        if (!cauchy_atomic_cas_u64(&rec->owner, &owner, EPOCH_OWNER_ADOPTING)) continue;
+
+        splice_retired(self, rec->retired_list);
+        rec->retired_list = NULL;
+        set_retired_count(rec, 0);
+        rec->nesting = 0;
+        cauchy_atomic_store_u64(&rec->local, 0);
+        cauchy_atomic_store_u64(&rec->owner, 0);
+    }
+
+    if (cauchy_atomic_load_ptr(&domain->orphans)) {
+        splice_retired(self, cauchy_atomic_exchange_ptr(&domain->orphans, NULL));
+    }
+}
+
+/* Advance the global epoch if every active reader has observed it */
+static void try_advance(cauchy_epoch_domain_t* domain, u32 count) {
+    u64 epoch = cauchy_atomic_load_u64(&domain->global);
+    if (cauchy_atomic_load_u64(&domain->overflow) > 0) return;
+
+    epoch_heavy_fence();
+    for (u32 i = 0; i < count; i++) {
+        epoch_record_t* rec = cauchy_atomic_load_ptr(&domain->records[i]);
+        if (!rec) continue;
+
+        u64 owner = cauchy_atomic_load_u64(&rec->owner);
+        if (owner == 0 || owner == EPOCH_OWNER_ADOPTING ||
+            !cauchy_thread_alive(i, owner)) {
+            continue;
+        }
+        u64 local = cauchy_atomic_load_u64(&rec->local);
+        if ((local & EPOCH_ACTIVE) && (local >> 1) != epoch) return;
+    }
+    cauchy_atomic_cas_u64(&domain->global, &epoch, epoch + 1);
+}
+
+usize cauchy_epoch_reclaim(cauchy_epoch_domain_t* domain) {
+    if (!domain) return 0;
+
+    epoch_record_t* rec = get_epoch_record(domain);
+    u32 count = cauchy_atomic_load_u32(&domain->record_count);
+    try_advance(domain, count);
+    if (!rec) return 0;
+
+    adopt_orphans(domain, rec, count);
+    if (!rec->retired_list) return 0;
+
+    u64 start = CAUCHY_STAT_NOW();
+    CAUCHY_STAT_RECORD(CAUCHY_HIST_EPOCH_BACKLOG, retired_count(rec));
+
+    /* Nodes retired in epoch e are unreachable to readers of epoch >= e + 1,
+     * and no reader of epoch e remains once the global epoch reaches e + 2. */
+    u64 safe = cauchy_atomic_load_u64(&domain->global) - 2;
+    usize reclaimed = 0;
+    epoch_retired_t* prev = NULL;
+    epoch_retired_t* curr = rec->retired_list;
+
+    while (curr) {
+        epoch_retired_t* next = curr->next;
+
+        if (curr->epoch <= safe) {
+            if (curr->retire_fn) {
+                curr->retire_fn(curr->ptr, curr->ctx);
+            }
+
+            if (prev) prev->next = next;
+            else rec->retired_list = next;
+
+            cauchy_pool_free(domain->retired_pool, curr);
+            reclaimed++;
+        } else {
+            prev = curr;
+        }
+        curr = next;
+    }
+
+    set_retired_count(rec, retired_count(rec) - (u32)reclaimed);
+    CAUCHY_STAT_ADD(CAUCHY_STAT_EPOCH_RECLAIMED, reclaimed);
+    CAUCHY_STAT_RECORD(CAUCHY_HIST_EPOCH_RECLAIM_NS, CAUCHY_STAT_NOW() - start);
+    return reclaimed;
+}
+
+usize cauchy_epoch_pending(const cauchy_epoch_domain_t* domain) {
+    if (!domain) return 0;
+    usize pending = 0;
+    u32 count = cauchy_atomic_load_u32(&domain->record_count);
+    for (u32 i = 0; i < count; i++) {
+        const epoch_record_t* rec = cauchy_atomic_load_ptr(&domain->records[i]);
+        if (rec) pending += retired_count(rec);
+    }
+    return pending;
+}
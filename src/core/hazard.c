@@ -4,9 +4,13 @@
  */
 
 #include "cauchy/memory.h"
+#include "cauchy/stats.h"
 #include <stdlib.h>
 #include <string.h>
 
+/* Owner value while a record's orphaned state is being adopted */
+#define HAZARD_OWNER_ADOPTING UINT64_MAX
+
 /* Retired node awaiting reclamation */
 typedef struct retired_node {
     void*            ptr;
@@ -15,60 +19,77 @@ typedef struct retired_node {
     struct retired_node* next;
 } retired_node_t;
 
-/* Per-thread hazard record */
-typedef struct hazard_record {
+/* Per-thread hazard record, indexed by cauchy_thread_id() */
+typedef struct CAUCHY_CACHE_ALIGNED hazard_record {
     cauchy_atomic_ptr_t hazards[CAUCHY_MAX_HAZARD_POINTERS];
-    cauchy_atomic_bool_t active;
+    cauchy_atomic_u64_t owner;  /* Owner's thread generation, 0 = unowned */
     retired_node_t* retired_list;
-    u32 retired_count;
-    struct hazard_record* next;
+    cauchy_atomic_u32_t retired_count;  /* Owner-written, summed by cauchy_hazard_pending */
 } hazard_record_t;
 
 /* Hazard pointer domain */
 struct cauchy_hazard_domain {
-    cauchy_atomic_ptr_t head;         /* List of hazard records */
-    cauchy_atomic_u32_t record_count;
-    cauchy_pool_t*      retired_pool; /* Pool for retired nodes */
+    cauchy_atomic_ptr_t records[CAUCHY_MAX_HAZARD_THREADS];
+    cauchy_atomic_u32_t record_count;  /* High-water mark of thread ids + 1 */
+    cauchy_pool_t*      retired_pool;  /* Pool for retired nodes */
 };
 
-/* Thread-local hazard record */
-static _Thread_local hazard_record_t* tls_hazard_record = NULL;
-static _Thread_local cauchy_hazard_domain_t* tls_domain = NULL;
+/* Relaxed accessors: only the owner (or an adopter) writes the count */
+CAUCHY_INLINE u32 retired_count(const hazard_record_t* rec) {
+    return atomic_load_explicit(&rec->retired_count, memory_order_relaxed);
+}
 
-static hazard_record_t* get_hazard_record(cauchy_hazard_domain_t* domain) {
-    if (tls_domain == domain && tls_hazard_record) {
-        return tls_hazard_record;
-    }
+CAUCHY_INLINE void set_retired_count(hazard_record_t* rec, u32 count) {
+    atomic_store_explicit(&rec->retired_count, count, memory_order_relaxed);
+}
 
-    hazard_record_t* rec = cauchy_atomic_load_ptr(&domain->head);
-    while (rec) {
-        bool expected = false;
-        if (atomic_compare_exchange_strong(&rec->active, &expected, true)) {
-            tls_hazard_record = rec;
-            tls_domain = domain;
-            return rec;
+static hazard_record_t* claim_hazard_record(cauchy_hazard_domain_t* domain,
+                                            u32 tid, u64 gen,
+                                            hazard_record_t* rec) {
+    if (!rec) {
+        rec = cauchy_aligned_alloc(sizeof(hazard_record_t), CAUCHY_CACHE_LINE_SIZE);
+        if (!rec) return NULL;
+        memset(rec, 0, sizeof(hazard_record_t));
+        atomic_init(&rec->owner, gen);
+        cauchy_atomic_store_ptr(&domain->records[tid], rec);
+
+        u32 count = cauchy_atomic_load_u32(&domain->record_count);
+        while (count < tid + 1 &&
+               !cauchy_atomic_cas_u32(&domain->record_count, &count, tid + 1)) {
         }
-        rec = rec->next;
+        return rec;
     }
 
-    rec = cauchy_aligned_alloc(sizeof(hazard_record_t), CAUCHY_CACHE_LINE_SIZE);
-    if (!rec) return NULL;
-
-    memset(rec, 0, sizeof(hazard_record_t));
-    atomic_init(&rec->active, true);
-
-    hazard_record_t* head;
-    do {
-        head = cauchy_atomic_load_ptr(&domain->head);
-        rec->next = head;
-    } while (!cauchy_atomic_cas_ptr(&domain->head, (void**)&head, rec));
-
-    cauchy_atomic_fetch_add_u32(&domain->record_count, 1);
-    tls_hazard_record = rec;
-    tls_domain = domain;
+    /* Slot recycled from an exited thread: inherit whatever it left behind
+     * unless a reclaimer is adopting it right now. */
+    u64 owner = cauchy_atomic_load_u64(&rec->owner);
+    for (;;) {
+        if (owner == HAZARD_OWNER_ADOPTING) {
+            CAUCHY_CPU_PAUSE();
+            owner = cauchy_atomic_load_u64(&rec->owner);
+            continue;
+        }
+        if (cauchy_atomic_cas_u64(&rec->owner, &owner, gen)) break;
+    }
+    for (int i = 0; i < CAUCHY_MAX_HAZARD_POINTERS; i++) {
+        cauchy_atomic_store_ptr(&rec->hazards[i], NULL);
+    }
     return rec;
 }
 
+static hazard_record_t* get_hazard_record(cauchy_hazard_domain_t* domain) {
+    u32 tid = cauchy_thread_id();
+    if (CAUCHY_UNLIKELY(tid >= CAUCHY_MAX_HAZARD_THREADS)) return NULL;
+
+    u64 gen = cauchy_thread_generation();
+    hazard_record_t* rec = cauchy_atomic_load_ptr(&domain->records[tid]);
+    if (CAUCHY_LIKELY(rec != NULL) &&
+        atomic_load_explicit(&rec->owner, memory_order_relaxed) == gen) {
+        return rec;
+    }
+    return claim_hazard_record(domain, tid, gen, rec);
+}
+
 cauchy_hazard_domain_t* cauchy_hazard_domain_create(void) {
     cauchy_hazard_domain_t* domain = cauchy_aligned_alloc(
         sizeof(cauchy_hazard_domain_t), CAUCHY_CACHE_LINE_SIZE);
@@ -90,9 +111,9 @@ cauchy_hazard_domain_t* cauchy_hazard_domain_create(void) {
 void cauchy_hazard_domain_destroy(cauchy_hazard_domain_t* domain) {
     if (!domain) return;
 
-    hazard_record_t* rec = cauchy_atomic_load_ptr(&domain->head);
-    while (rec) {
-        hazard_record_t* next = rec->next;
+    for (u32 i = 0; i < CAUCHY_MAX_HAZARD_THREADS; i++) {
+        hazard_record_t* rec = cauchy_atomic_load_ptr(&domain->records[i]);
+        if (!rec) continue;
         retired_node_t* retired = rec->retired_list;
         while (retired) {
             retired_node_t* rn = retired;
@@ -100,7 +121,6 @@ void cauchy_hazard_domain_destroy(cauchy_hazard_domain_t* domain) {
             if (rn->retire_fn) rn->retire_fn(rn->ptr, rn->ctx);
         }
         cauchy_aligned_free(rec);
-        rec = next;
     }
 
     if (domain->retired_pool) cauchy_pool_destroy(domain->retired_pool);
@@ -130,19 +150,11 @@ void cauchy_hazard_clear(cauchy_hazard_domain_t* domain, int hp_index) {
     if (rec) cauchy_atomic_store_ptr(&rec->hazards[hp_index], NULL);
 }
 
-static bool is_hazardous(cauchy_hazard_domain_t* domain, void* ptr) {
-    hazard_record_t* rec = cauchy_atomic_load_ptr(&domain->head);
-    while (rec) {
-        if (atomic_load(&rec->active)) {
-            for (int i = 0; i < CAUCHY_MAX_HAZARD_POINTERS; i++) {
-                if (cauchy_atomic_load_ptr(&rec->hazards[i]) == ptr) {
-                    return true;
-                }
-            }
-        }
-        rec = rec->next;
-    }
-    return false;
+/* Scan only once this many nodes are pending: proportional to the number
+ * of hazard slots, so each scan frees a constant fraction of its cost. */
+static u32 reclaim_threshold(cauchy_hazard_domain_t* domain) {
+    u32 slots = cauchy_atomic_load_u32(&domain->record_count) * CAUCHY_MAX_HAZARD_POINTERS;
+    return (2 * slots > CAUCHY_HAZARD_RECLAIM_MIN) ? 2 * slots : CAUCHY_HAZARD_RECLAIM_MIN;
 }
 
 void cauchy_hazard_retire(cauchy_hazard_domain_t* domain, void* node,
@@ -166,19 +178,88 @@ void cauchy_hazard_retire(cauchy_hazard_domain_t* domain, void* node,
     rn->ctx = ctx;
     rn->next = rec->retired_list;
     rec->retired_list = rn;
-    rec->retired_count++;
+    u32 pending = retired_count(rec) + 1;
+    set_retired_count(rec, pending);
+    CAUCHY_STAT_ADD(CAUCHY_STAT_HAZARD_RETIRED, 1);
 
-    if (rec->retired_count >= CAUCHY_MAX_HAZARD_THREADS * CAUCHY_MAX_HAZARD_POINTERS * 2) {
+    if (pending >= reclaim_threshold(domain)) {
         cauchy_hazard_reclaim(domain);
     }
 }
 
+/* Take over records whose owning thread has exited: splice their retired
+ * lists onto ours and drop the hazards they can no longer be using. */
+static void adopt_orphans(cauchy_hazard_domain_t* domain, hazard_record_t* self, u32 count) {
+    for (u32 i = 0; i < count; i++) {
+        hazard_record_t* rec = cauchy_atomic_load_ptr(&domain->records[i]);
+        if (!rec || rec == self) continue;
+
+        u64 owner = cauchy_atomic_load_u64(&rec->owner);
+        if (owner == 0 || owner == HAZARD_OWNER_ADOPTING ||
+            cauchy_thread_alive(i, owner)) {
+            continue;
+        }
+        if (!cauchy_atomic_cas_u64(&rec->owner, &owner, HAZARD_OWNER_ADOPTING)) continue;
+
+        if (rec->retired_list) {
+            retired_node_t* tail = rec->retired_list;
+            while (tail->next) tail = tail->next;
+            tail->next = self->retired_list;
+            self->retired_list = rec->retired_list;
+            set_retired_count(self, retired_count(self) + retired_count(rec));
+            rec->retired_list = NULL;
+            set_retired_count(rec, 0);
+        }
+        for (int j = 0; j < CAUCHY_MAX_HAZARD_POINTERS; j++) {
+            cauchy_atomic_store_ptr(&rec->hazards[j], NULL);
+        }
+        cauchy_atomic_store_u64(&rec->owner, 0);
+    }
+}
+
+static int compare_ptr(const void* a, const void* b) {
+    uintptr_t pa = (uintptr_t)*(void* const*)a;
+    uintptr_t pb = (uintptr_t)*(void* const*)b;
+    return (pa > pb) - (pa < pb);
+}
+
+static bool snapshot_contains(void* const* snapshot, usize n, void* ptr) {
+    usize lo = 0, hi = n;
+    while (lo < hi) {
+        usize mid = lo + (hi - lo) / 2;
+        if ((uintptr_t)snapshot[mid] < (uintptr_t)ptr) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < n && snapshot[lo] == ptr;
+}
+
 usize cauchy_hazard_reclaim(cauchy_hazard_domain_t* domain) {
     if (!domain) return 0;
 
     hazard_record_t* rec = get_hazard_record(domain);
     if (!rec) return 0;
 
+    u32 count = cauchy_atomic_load_u32(&domain->record_count);
+    adopt_orphans(domain, rec, count);
+    if (!rec->retired_list) return 0;
+
+    u64 start = CAUCHY_STAT_NOW();
+    CAUCHY_STAT_RECORD(CAUCHY_HIST_HAZARD_BACKLOG, retired_count(rec));
+
+    /* One pass over every hazard slot, then O(log H) per retired node */
+    void* snapshot[CAUCHY_MAX_HAZARD_THREADS * CAUCHY_MAX_HAZARD_POINTERS];
+    usize n = 0;
+    cauchy_atomic_fence_seq_cst();
+    for (u32 i = 0; i < count; i++) {
+        hazard_record_t* r = cauchy_atomic_load_ptr(&domain->records[i]);
+        if (!r) continue;
+        for (int j = 0; j < CAUCHY_MAX_HAZARD_POINTERS; j++) {
+            void* p = cauchy_atomic_load_ptr(&r->hazards[j]);
+            if (p) snapshot[n++] = p;
+        }
+    }
+    if (n > 1) qsort(snapshot, n, sizeof(void*), compare_ptr);
+
     usize reclaimed = 0;
     retired_node_t* prev = NULL;
     retired_node_t* curr = rec->retired_list;
@@ -186,7 +267,7 @@ usize cauchy_hazard_reclaim(cauchy_hazard_domain_t* domain) {
     while (curr) {
         retired_node_t* next = curr->next;
 
-        if (!is_hazardous(domain, curr->ptr)) {
+        if (!snapshot_contains(snapshot, n, curr->ptr)) {
             if (curr->retire_fn) {
                 curr->retire_fn(curr->ptr, curr->ctx);
             }
@@ -195,7 +276,6 @@ usize cauchy_hazard_reclaim(cauchy_hazard_domain_t* domain) {
             else rec->retired_list = next;
 
             cauchy_pool_free(domain->retired_pool, curr);
-            rec->retired_count--;
             reclaimed++;
         } else {
             prev = curr;
@@ -203,5 +283,19 @@ usize cauchy_hazard_reclaim(cauchy_hazard_domain_t* domain) {
         curr = next;
     }
 
+    set_retired_count(rec, retired_count(rec) - (u32)reclaimed);
+    CAUCHY_STAT_ADD(CAUCHY_STAT_HAZARD_RECLAIMED, reclaimed);
+    CAUCHY_STAT_RECORD(CAUCHY_HIST_HAZARD_RECLAIM_NS, CAUCHY_STAT_NOW() - start);
     return reclaimed;
 }
+
+usize cauchy_hazard_pending(const cauchy_hazard_domain_t* domain) {
+    if (!domain) return 0;
+    usize pending = 0;
+    u32 count = cauchy_atomic_load_u32(&domain->record_count);
+    for (u32 i = 0; i < count; i++) {
+        const hazard_record_t* rec = cauchy_atomic_load_ptr(&domain->records[i]);
+        if (rec) pending += retired_count(rec);
+    }
+    return pending;
+}
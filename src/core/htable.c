@@ -0,0 +1,391 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Open-Addressing Hash Index Implementation
+ */
+
+#include "cauchy/htable.h"
+#include "cauchy/atomic.h"
+#include "cauchy/stats.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME  1099511628211ULL
+
+CAUCHY_INLINE u64 fnv_extend(u64 hash, const u8* bytes, usize size) {
+    for (usize i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+u64 cauchy_hash_bytes(const void* data, usize size) {
+    return fnv_extend(FNV_OFFSET, (const u8*)data, size);
+}
+
+void cauchy_hash_batch(const cauchy_bytes_t* items, usize n, u64* out) {
+    usize i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const u8* p0 = items[i].data;
+        const u8* p1 = items[i + 1].data;
+        const u8* p2 = items[i + 2].data;
+        const u8* p3 = items[i + 3].data;
+        usize common = items[i].size;
+        for (usize k = 1; k < 4; k++) {
+            if (items[i + k].size < common) common = items[i + k].size;
+        }
+
+        u64 h0 = FNV_OFFSET, h1 = FNV_OFFSET, h2 = FNV_OFFSET, h3 = FNV_OFFSET;
+        for (usize k = 0; k < common; k++) {
+            h0 = (h0 ^ p0[k]) * FNV_PRIME;
+            h1 = (h1 ^ p1[k]) * FNV_PRIME;
+            h2 = (h2 ^ p2[k]) * FNV_PRIME;
+            h3 = (h3 ^ p3[k]) * FNV_PRIME;
+        }
+        out[i]     = fnv_extend(h0, p0 + common, items[i].size - common);
+        out[i + 1] = fnv_extend(h1, p1 + common, items[i + 1].size - common);
+        out[i + 2] = fnv_extend(h2, p2 + common, items[i + 2].size - common);
+        out[i + 3] = fnv_extend(h3, p3 + common, items[i + 3].size - common);
+    }
+    for (; i < n; i++) out[i] = cauchy_hash_bytes(items[i].data, items[i].size);
+}
+
+static usize capacity_for(usize items) {
+    usize cap = CAUCHY_HTABLE_MIN_CAPACITY;
+    while (cap < items * 2) cap <<= 1;
+    return cap;
+}
+
+/* Distinct odd multipliers for successive tables (splitmix64 steps) */
+static u64 next_multiplier(void) {
+    static cauchy_atomic_u64_t state;
+    u64 z = atomic_fetch_add_explicit(&state, 0x9E3779B97F4A7C15ULL, memory_order_relaxed);
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (z ^ (z >> 31)) | 1;
+}
+
+static cauchy_result_t array_alloc(cauchy_htable_array_t* arr, usize capacity, u64 multiplier) {
+    arr->slots = calloc(capacity, sizeof(cauchy_htable_slot_t));
+    if (!arr->slots) return CAUCHY_ERR_NOMEM;
+    arr->capacity = capacity;
+    arr->shift = 64 - (u32)__builtin_ctzll((u64)capacity);
+    arr->used = 0;
+    arr->multiplier = multiplier;
+    return CAUCHY_OK;
+}
+
+static void array_put(cauchy_htable_array_t* arr, u64 hash, void* item) {
+    usize mask = arr->capacity - 1;
+    usize idx = cauchy_htable_home_slot(arr, hash);
+    usize steps = 0;
+    while (arr->slots[idx].hash > CAUCHY_HTABLE_TOMBSTONE) {
+        idx = (idx + 1) & mask;
+        steps++;
+    }
+    CAUCHY_STAT_RECORD(CAUCHY_HIST_HTABLE_CHAIN, steps);
+    if (arr->slots[idx].hash == CAUCHY_HTABLE_EMPTY) arr->used++;
+    arr->slots[idx].hash = hash;
+    arr->slots[idx].item = item;
+}
+
+static bool array_remove(cauchy_htable_array_t* arr, u64 hash, const void* item) {
+    if (!arr->slots) return false;
+    usize mask = arr->capacity - 1;
+    usize idx = cauchy_htable_home_slot(arr, hash);
+    for (usize n = 0; n < arr->capacity; n++) {
+        cauchy_htable_slot_t* slot = &arr->slots[idx];
+        if (slot->hash == CAUCHY_HTABLE_EMPTY) return false;
+        if (slot->hash == hash && slot->item == item) {
+            slot->hash = CAUCHY_HTABLE_TOMBSTONE;
+            slot->item = NULL;
+            return true;
+        }
+        idx = (idx + 1) & mask;
+    }
+    return false;
+}
+
+/* Move up to `n` old slots into cur; migrated slots become tombstones so
+ * probes through the old array still walk past them. */
+static void migrate(cauchy_htable_t* table, usize n) {
+    if (!table->old.slots) return;
+
+    usize end = table->migrate_pos + n;
+    if (end > table->old.capacity) end = table->old.capacity;
+    for (usize i = table->migrate_pos; i < end; i++) {
+        cauchy_htable_slot_t* slot = &table->old.slots[i];
+        if (slot->hash > CAUCHY_HTABLE_TOMBSTONE) {
+            array_put(&table->cur, slot->hash, slot->item);
+            slot->hash = CAUCHY_HTABLE_TOMBSTONE;
+            slot->item = NULL;
+        }
+    }
+    table->migrate_pos = end;
+
+    if (table->migrate_pos == table->old.capacity) {
+        free(table->old.slots);
+        memset(&table->old, 0, sizeof(table->old));
+        table->migrate_pos = 0;
+    }
+}
+
+static cauchy_result_t start_resize(cauchy_htable_t* table) {
+    cauchy_htable_finish_resize(table);
+
+    cauchy_htable_array_t next;
+    cauchy_result_t res = array_alloc(&next, capacity_for(table->count + 1),
+                                      table->cur.multiplier);
+    if (res != CAUCHY_OK) return res;
+
+    table->old = table->cur;
+    table->cur = next;
+    table->migrate_pos = 0;
+
+    /* Every live old item fits in half of cur. Draining the old array
+     * within capacity/4 mutations keeps cur under the load limit, so a
+     * resize never has to start while another one is still running. */
+    usize budget = table->cur.capacity / 4;
+    usize step = (table->old.capacity + budget - 1) / budget;
+    table->migrate_step = step > CAUCHY_HTABLE_MIGRATE_STEP ? step : CAUCHY_HTABLE_MIGRATE_STEP;
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_htable_init(cauchy_htable_t* table, usize capacity) {
+    if (!table) return CAUCHY_ERR_INVALID;
+    memset(table, 0, sizeof(cauchy_htable_t));
+    return array_alloc(&table->cur, capacity_for(capacity), next_multiplier());
+}
+
+void cauchy_htable_destroy(cauchy_htable_t* table) {
+    if (!table) return;
+    free(table->cur.slots);
+    free(table->old.slots);
+    memset(table, 0, sizeof(cauchy_htable_t));
+}
+
+void cauchy_htable_finish_resize(cauchy_htable_t* table) {
+    if (!table || !table->old.slots) return;
+    migrate(table, table->old.capacity);
+}
+
+cauchy_result_t cauchy_htable_insert(cauchy_htable_t* table, u64 hash, void* item) {
+    if (!table) return CAUCHY_ERR_INVALID;
+
+    migrate(table, table->migrate_step);
+
+    /* Grow at 3/4 occupancy (tombstones included) */
+    if ((table->cur.used + 1) * 4 > table->cur.capacity * 3) {
+        cauchy_result_t res = start_resize(table);
+        if (res != CAUCHY_OK && table->cur.used + 1 >= table->cur.capacity) return res;
+        migrate(table, table->migrate_step);
+    }
+
+    array_put(&table->cur, cauchy_htable_slot_hash(hash), item);
+    table->count++;
+    return CAUCHY_OK;
+}
+
+bool cauchy_htable_remove(cauchy_htable_t* table, u64 hash, const void* item) {
+    if (!table) return false;
+
+    migrate(table, table->migrate_step);
+
+    u64 h = cauchy_htable_slot_hash(hash);
+    if (array_remove(&table->cur, h, item) || array_remove(&table->old, h, item)) {
+        table->count--;
+        return true;
+    }
+    return false;
+}
+
+usize cauchy_htable_sweep(cauchy_htable_t* table, usize* cursor, usize budget,
+                          cauchy_htable_sweep_fn drop, void* arg) {
+    if (!table || !cursor || !drop) return 0;
+
+    migrate(table, table->migrate_step);
+
+    cauchy_htable_array_t* arr = &table->cur;
+    usize mask = arr->capacity - 1;
+    usize removed = 0;
+    usize idx = *cursor < arr->capacity ? *cursor : 0;
+    usize end = budget < arr->capacity - idx ? idx + budget : arr->capacity;
+    for (; idx < end; idx++) {
+        cauchy_htable_slot_t* slot = &arr->slots[idx];
+        if (slot->hash <= CAUCHY_HTABLE_TOMBSTONE || !drop(slot->item, arg)) continue;
+        slot->hash = CAUCHY_HTABLE_TOMBSTONE;
+        slot->item = NULL;
+        table->count--;
+        removed++;
+
+        /* A tombstone run that ends at an empty slot terminates no probe
+         * chain, so it can be emptied and stop counting towards growth */
+        if (arr->slots[(idx + 1) & mask].hash == CAUCHY_HTABLE_EMPTY) {
+            usize j = idx;
+            while (arr->slots[j].hash == CAUCHY_HTABLE_TOMBSTONE) {
+                arr->slots[j].hash = CAUCHY_HTABLE_EMPTY;
+                arr->used--;
+                j = (j - 1) & mask;
+            }
+        }
+    }
+    *cursor = end == arr->capacity ? 0 : end;
+    return removed;
+}
+
+void cauchy_htable_probe_init(cauchy_htable_probe_t* probe,
+                              const cauchy_htable_t* table, u64 hash) {
+    probe->table = table;
+    probe->hash = cauchy_htable_slot_hash(hash);
+    probe->steps = 0;
+    probe->phase = 0;
+    probe->idx = cauchy_htable_home_slot(&table->cur, probe->hash);
+}
+
+void* cauchy_htable_probe_next(cauchy_htable_probe_t* probe) {
+    while (probe->phase < 2) {
+        const cauchy_htable_array_t* arr =
+            probe->phase == 0 ? &probe->table->cur : &probe->table->old;
+        usize mask = arr->capacity - 1;
+
+        while (arr->slots && probe->steps < arr->capacity) {
+            const cauchy_htable_slot_t* slot = &arr->slots[probe->idx];
+            if (slot->hash == CAUCHY_HTABLE_EMPTY) break;
+            probe->idx = (probe->idx + 1) & mask;
+            probe->steps++;
+            if (slot->hash == probe->hash) return slot->item;
+        }
+
+        probe->phase++;
+        probe->steps = 0;
+        if (probe->phase == 1 && probe->table->old.slots) {
+            probe->idx = cauchy_htable_home_slot(&probe->table->old, probe->hash);
+        }
+    }
+    return NULL;
+}
+
+/* Position the iterator at its slice of the array for its phase */
+static void iter_enter(cauchy_htable_iter_t* iter) {
+    const cauchy_htable_array_t* arr =
+        iter->phase == 0 ? &iter->table->old : &iter->table->cur;
+    usize span = (arr->capacity + iter->slices - 1) / iter->slices;
+    usize begin = span * iter->slice;
+    iter->idx = begin < arr->capacity ? begin : arr->capacity;
+    iter->end = arr->capacity - iter->idx > span ? iter->idx + span : arr->capacity;
+}
+
+void cauchy_htable_iter_init(cauchy_htable_iter_t* iter, const cauchy_htable_t* table) {
+    cauchy_htable_iter_init_slice(iter, table, 0, 1);
+}
+
+void cauchy_htable_iter_init_slice(cauchy_htable_iter_t* iter, const cauchy_htable_t* table,
+                                   u32 index, u32 count) {
+    iter->table = table;
+    iter->slices = count ? count : 1;
+    iter->slice = index < iter->slices ? index : iter->slices;
+    iter->phase = 0;
+    if (table) iter_enter(iter);
+}
+
+void* cauchy_htable_iter_next(cauchy_htable_iter_t* iter) {
+    if (!iter->table) return NULL;
+    while (iter->phase < 2) {
+        const cauchy_htable_array_t* arr =
+            iter->phase == 0 ? &iter->table->old : &iter->table->cur;
+        while (iter->idx < iter->end) {
+            const cauchy_htable_slot_t* slot = &arr->slots[iter->idx++];
+            if (slot->hash > CAUCHY_HTABLE_TOMBSTONE) return slot->item;
+        }
+        if (++iter->phase < 2) iter_enter(iter);
+    }
+    return NULL;
+}
+
+/* Partitioned filling */
+
+cauchy_result_t cauchy_htable_reserve(cauchy_htable_t* table, usize extra) {
+    if (!table) return CAUCHY_ERR_INVALID;
+    cauchy_htable_finish_resize(table);
+    if ((table->cur.used + extra) * 4 <= table->cur.capacity * 3) return CAUCHY_OK;
+
+    cauchy_htable_array_t next;
+    cauchy_result_t res = array_alloc(&next, capacity_for(table->count + extra),
+                                      table->cur.multiplier);
+    if (res != CAUCHY_OK) return res;
+    for (usize i = 0; i < table->cur.capacity; i++) {
+        const cauchy_htable_slot_t* slot = &table->cur.slots[i];
+        if (slot->hash > CAUCHY_HTABLE_TOMBSTONE) array_put(&next, slot->hash, slot->item);
+    }
+    free(table->cur.slots);
+    table->cur = next;
+    return CAUCHY_OK;
+}
+
+/* Parts split the array into equal spans; the last may be shorter */
+CAUCHY_INLINE usize part_span(const cauchy_htable_array_t* arr, u32 count) {
+    return (arr->capacity + count - 1) / count;
+}
+
+void cauchy_htable_part_init(cauchy_htable_part_t* part, cauchy_htable_t* table,
+                             u32 index, u32 count) {
+    usize span = part_span(&table->cur, count ? count : 1);
+    usize begin = span * index;
+    part->table = table;
+    part->begin = begin < table->cur.capacity ? begin : table->cur.capacity;
+    part->end = table->cur.capacity - part->begin > span ? part->begin + span
+                                                         : table->cur.capacity;
+    part->added = 0;
+    part->filled = 0;
+}
+
+u32 cauchy_htable_part_of(const cauchy_htable_t* table, u32 count, u64 hash) {
+    if (count <= 1) return 0;
+    usize home = cauchy_htable_home_slot(&table->cur, cauchy_htable_slot_hash(hash));
+    return (u32)(home / part_span(&table->cur, count));
+}
+
+void cauchy_htable_part_probe_init(cauchy_htable_part_probe_t* probe,
+                                   const cauchy_htable_part_t* part, u64 hash) {
+    probe->part = part;
+    probe->hash = cauchy_htable_slot_hash(hash);
+    probe->idx = cauchy_htable_home_slot(&part->table->cur, probe->hash);
+    probe->escaped = false;
+}
+
+void* cauchy_htable_part_probe_next(cauchy_htable_part_probe_t* probe) {
+    const cauchy_htable_slot_t* slots = probe->part->table->cur.slots;
+    while (probe->idx < probe->part->end) {
+        const cauchy_htable_slot_t* slot = &slots[probe->idx];
+        if (slot->hash == CAUCHY_HTABLE_EMPTY) return NULL;
+        probe->idx++;
+        if (slot->hash == probe->hash) return slot->item;
+    }
+    probe->escaped = true;
+    return NULL;
+}
+
+cauchy_result_t cauchy_htable_part_insert(cauchy_htable_part_t* part, u64 hash, void* item) {
+    cauchy_htable_slot_t* slots = part->table->cur.slots;
+    u64 h = cauchy_htable_slot_hash(hash);
+    usize idx = cauchy_htable_home_slot(&part->table->cur, h);
+    usize home = idx;
+    while (idx < part->end && slots[idx].hash > CAUCHY_HTABLE_TOMBSTONE) idx++;
+    if (idx == part->end) return CAUCHY_ERR_FULL;
+
+    CAUCHY_STAT_RECORD(CAUCHY_HIST_HTABLE_CHAIN, idx - home);
+    if (slots[idx].hash == CAUCHY_HTABLE_EMPTY) part->filled++;
+    slots[idx].hash = h;
+    slots[idx].item = item;
+    part->added++;
+    return CAUCHY_OK;
+}
+
+void cauchy_htable_part_commit(cauchy_htable_part_t* part) {
+    part->table->cur.used += part->filled;
+    part->table->count += part->added;
+    part->filled = 0;
+    part->added = 0;
+}
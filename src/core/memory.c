@@ -4,27 +4,76 @@
  */
 
 #include "cauchy/memory.h"
+#include "cauchy/numa.h"
+#include "cauchy/stats.h"
 #include <stdlib.h>
 #include <string.h>
 
-/* Lock-free stack node for free list */
+#define POOL_OWNER_ADOPTING UINT64_MAX
+
+/* Free block header. A magazine is a chain of blocks linked through
+ * `next`; only the head block of a magazine carries the depot link and
+ * the chain length. */
 typedef struct pool_node {
     struct pool_node* next;
+    struct pool_node* mag_next;   /* Next magazine in the depot */
+    usize             mag_count;  /* Blocks in this magazine */
 } pool_node_t;
 
+/* Header placed in front of every slab so destroy can release them */
+typedef struct pool_slab {
+    struct pool_slab* next;
+    usize             bytes;   /* Mapped size, 0 for heap slabs */
+} pool_slab_t;
+
+/* Free magazines of one NUMA node's arena */
+typedef struct CAUCHY_CACHE_ALIGNED pool_depot {
+#if CAUCHY_HAS_DWCAS
+    cauchy_atomic_u128_t head;         /* Tagged Treiber stack {magazine, version} */
+#else
+    cauchy_atomic_ptr_t  head;         /* Stack of magazines, guarded by lock */
+    atomic_flag          lock;
+#endif
+} pool_depot_t;
+
+/* Per-thread magazine cache (Bonwick-style loaded/previous pair).
+ * Only the owning thread touches the magazines; the counters are written
+ * with relaxed stores by the owner and summed by cauchy_pool_get_stats. */
+typedef struct CAUCHY_CACHE_ALIGNED pool_cache {
+    pool_node_t*         loaded;
+    usize                loaded_count;
+    pool_node_t*         previous;
+    usize                previous_count;
+    i64                  unpublished;  /* Net allocs not yet in pool->in_use */
+    cauchy_atomic_u64_t  owner;        /* Thread generation, 0 once flushed */
+    u32                  node;         /* Arena it refills from */
+    cauchy_atomic_u64_t  allocs;
+    cauchy_atomic_u64_t  frees;
+    cauchy_atomic_u64_t  contention;
+} pool_cache_t;
+
 /* Memory pool structure */
 struct cauchy_pool {
-    cauchy_atomic_ptr_t  free_list;    /* Lock-free stack of free blocks */
-    cauchy_atomic_u64_t  allocated;
-    cauchy_atomic_u64_t  freed;
+    pool_depot_t*        depots;       /* One per arena */
+    u32                  arenas;
+    cauchy_pool_numa_t   numa;
+    u32                  numa_node;
+    u32                  map_flags;    /* CAUCHY_NUMA_* for mapped slabs */
+    cauchy_atomic_ptr_t  slabs;        /* All slabs, for bulk deallocation */
+    cauchy_atomic_u64_t  allocated;    /* Blocks obtained from the system */
+    cauchy_atomic_u64_t  in_use;       /* Published at magazine granularity */
     cauchy_atomic_u64_t  peak_use;
-    cauchy_atomic_u64_t  total_allocs;
-    cauchy_atomic_u64_t  contention;
+    /* Counters for threads beyond CAUCHY_MAX_THREADS (no cache) */
+    cauchy_atomic_u64_t  shared_allocs;
+    cauchy_atomic_u64_t  shared_frees;
+    cauchy_atomic_u64_t  shared_contention;
     usize                block_size;
     usize                alignment;
     usize                max_blocks;
-    void*                base_memory;  /* For bulk deallocation */
-    usize                base_size;
+    usize                magazine_size;
+    usize                slab_blocks;
+    usize                slab_header;  /* pool_slab_t rounded up to alignment */
+    cauchy_atomic_ptr_t  caches[CAUCHY_MAX_THREADS];
 };
 
 void* cauchy_aligned_alloc(usize size, usize alignment) {
@@ -63,79 +112,413 @@ void cauchy_secure_zero(void* ptr, usize size) {
     }
 }
 
+/* Owner-only counter bump: a relaxed load/store pair, never an RMW */
+CAUCHY_INLINE void stat_add(cauchy_atomic_u64_t* counter, u64 n) {
+    atomic_store_explicit(counter,
+        atomic_load_explicit(counter, memory_order_relaxed) + n,
+        memory_order_relaxed);
+}
+
+#if CAUCHY_HAS_DWCAS
+
+/* The depot head carries a version tag bumped by every successful CAS, so
+ * a pop that read `mag_next` from a magazine which was popped and pushed
+ * back in between fails instead of installing a stale link. Reading the
+ * link of a concurrently popped magazine is safe because slab memory is
+ * only returned to the system in cauchy_pool_destroy. */
+static void depot_push(pool_depot_t* depot, pool_node_t* mag, usize count,
+                       cauchy_atomic_u64_t* contention) {
+    mag->mag_count = count;
+    cauchy_tagged_ptr_t head = cauchy_atomic_load_tagged(&depot->head);
+    u64 retries = 0;
+    for (;;) {
+        mag->mag_next = head.ptr;
+        if (cauchy_atomic_cas_tagged(&depot->head, &head, mag)) break;
+        retries++;
+    }
+    if (retries) {
+        cauchy_atomic_fetch_add_u64(contention, retries);
+        CAUCHY_STAT_ADD(CAUCHY_STAT_POOL_CAS_RETRIES, retries);
+    }
+}
+
+static pool_node_t* depot_pop(pool_depot_t* depot, usize* count,
+                              cauchy_atomic_u64_t* contention) {
+    cauchy_tagged_ptr_t head = cauchy_atomic_load_tagged(&depot->head);
+    u64 retries = 0;
+    while (head.ptr) {
+        pool_node_t* next = ((pool_node_t*)head.ptr)->mag_next;
+        if (cauchy_atomic_cas_tagged(&depot->head, &head, next)) break;
+        retries++;
+    }
+    if (retries) {
+        cauchy_atomic_fetch_add_u64(contention, retries);
+        CAUCHY_STAT_ADD(CAUCHY_STAT_POOL_CAS_RETRIES, retries);
+    }
+    if (head.ptr) *count = ((pool_node_t*)head.ptr)->mag_count;
+    return head.ptr;
+}
+
+#else
+
+/* No double-width CAS: a short spinlock is the only ABA-safe option */
+static void depot_lock(pool_depot_t* depot, cauchy_atomic_u64_t* contention) {
+    u64 retries = 0;
+    while (atomic_flag_test_and_set_explicit(&depot->lock, memory_order_acquire)) {
+        CAUCHY_CPU_PAUSE();
+        retries++;
+    }
+    if (retries) {
+        cauchy_atomic_fetch_add_u64(contention, retries);
+        CAUCHY_STAT_ADD(CAUCHY_STAT_POOL_CAS_RETRIES, retries);
+    }
+}
+
+static void depot_unlock(pool_depot_t* depot) {
+    atomic_flag_clear_explicit(&depot->lock, memory_order_release);
+}
+
+static void depot_push(pool_depot_t* depot, pool_node_t* mag, usize count,
+                       cauchy_atomic_u64_t* contention) {
+    mag->mag_count = count;
+    depot_lock(depot, contention);
+    mag->mag_next = atomic_load_explicit(&depot->head, memory_order_relaxed);
+    atomic_store_explicit(&depot->head, mag, memory_order_relaxed);
+    depot_unlock(depot);
+}
+
+static pool_node_t* depot_pop(pool_depot_t* depot, usize* count,
+                              cauchy_atomic_u64_t* contention) {
+    depot_lock(depot, contention);
+    pool_node_t* head = atomic_load_explicit(&depot->head, memory_order_relaxed);
+    if (head) {
+        atomic_store_explicit(&depot->head, head->mag_next, memory_order_relaxed);
+        *count = head->mag_count;
+    }
+    depot_unlock(depot);
+    return head;
+}
+
+#endif /* CAUCHY_HAS_DWCAS */
+
+/* Fold a thread's net allocation delta into the shared in-use count and
+ * sample the peak. Called only when a thread touches the depot, so the
+ * shared counter is written once per magazine rather than per block. */
+static void pool_publish(cauchy_pool_t* pool, i64 delta) {
+    u64 in_use = cauchy_atomic_fetch_add_u64(&pool->in_use, (u64)delta) + (u64)delta;
+    u64 peak = cauchy_atomic_load_u64(&pool->peak_use);
+    while ((i64)in_use > 0 && in_use > peak) {
+        if (cauchy_atomic_cas_u64(&pool->peak_use, &peak, in_use)) break;
+    }
+}
+
+/* Arena of the calling thread's node */
+CAUCHY_INLINE u32 pool_local_arena(const cauchy_pool_t* pool) {
+    if (pool->arenas == 1) return 0;
+    u32 node = cauchy_numa_current_node();
+    return node < pool->arenas ? node : pool->arenas - 1;
+}
+
+/* Slab memory for an arena: mapped when it must be bound or backed by
+ * huge pages, from the heap otherwise */
+static pool_slab_t* slab_alloc(cauchy_pool_t* pool, u32 arena, usize bytes) {
+    i32 node = CAUCHY_NUMA_ANY;
+    if (pool->numa == CAUCHY_POOL_NUMA_BIND) node = (i32)arena;
+    if (pool->numa == CAUCHY_POOL_NUMA_NODE) node = (i32)pool->numa_node;
+    bool bound = node != CAUCHY_NUMA_ANY && cauchy_numa_node_count() > 1;
+    bool huge = (pool->map_flags & CAUCHY_NUMA_HUGE) && bytes >= CAUCHY_HUGE_PAGE_SIZE;
+    if ((bound || huge) && pool->alignment <= 4096) {
+        pool_slab_t* slab = cauchy_numa_map(bytes, node, pool->map_flags);
+        if (slab) slab->bytes = bytes;
+        return slab;
+    }
+    pool_slab_t* slab = cauchy_aligned_alloc(bytes, pool->alignment);
+    if (slab) slab->bytes = 0;
+    return slab;
+}
+
+static void slab_free(cauchy_pool_t* pool, pool_slab_t* slab) {
+    if (slab->bytes) {
+        cauchy_numa_unmap(slab, slab->bytes, pool->map_flags);
+    } else {
+        cauchy_aligned_free(slab);
+    }
+}
+
+/* Blocks in a slab of about `blocks`: with huge pages, a slab of a huge
+ * page or more is grown to fill whole huge pages */
+static usize slab_fill(const cauchy_pool_t* pool, usize blocks) {
+    usize bytes = pool->slab_header + blocks * pool->block_size;
+    if (!(pool->map_flags & CAUCHY_NUMA_HUGE) || bytes < CAUCHY_HUGE_PAGE_SIZE) return blocks;
+    return (cauchy_numa_map_size(bytes, pool->map_flags) - pool->slab_header) / pool->block_size;
+}
+
+/* Carve a new slab of up to `blocks` blocks for an arena into magazines.
+ * The first magazine is handed back to the caller (if `first` is
+ * non-NULL), the rest go to the arena's depot. Honors max_blocks. */
+static bool pool_grow(cauchy_pool_t* pool, u32 arena, usize blocks,
+                      pool_node_t** first, usize* first_count,
+                      cauchy_atomic_u64_t* contention) {
+    blocks = slab_fill(pool, blocks);
+    u64 current = cauchy_atomic_load_u64(&pool->allocated);
+    usize n;
+    do {
+        n = blocks;
+        if (pool->max_blocks) {
+            if (current >= pool->max_blocks) return false;
+            if (n > pool->max_blocks - current) n = (usize)(pool->max_blocks - current);
+        }
+    } while (!cauchy_atomic_cas_u64(&pool->allocated, &current, current + n));
+
+    pool_slab_t* slab = slab_alloc(pool, arena, pool->slab_header + n * pool->block_size);
+    if (!slab) {
+        cauchy_atomic_fetch_sub_u64(&pool->allocated, n);
+        return false;
+    }
+
+    pool_slab_t* head = cauchy_atomic_load_ptr(&pool->slabs);
+    do {
+        slab->next = head;
+    } while (!cauchy_atomic_cas_ptr(&pool->slabs, (void**)&head, slab));
+
+    u8* block = (u8*)slab + pool->slab_header;
+    usize remaining = n;
+    bool handed_out = (first == NULL);
+    while (remaining > 0) {
+        usize count = remaining < pool->magazine_size ? remaining : pool->magazine_size;
+        pool_node_t* mag = (pool_node_t*)block;
+        for (usize i = 0; i < count; i++) {
+            pool_node_t* node = (pool_node_t*)block;
+            block += pool->block_size;
+            node->next = (i + 1 < count) ? (pool_node_t*)block : NULL;
+        }
+        if (!handed_out) {
+            *first = mag;
+            *first_count = count;
+            handed_out = true;
+        } else {
+            depot_push(&pool->depots[arena], mag, count, contention);
+        }
+        remaining -= count;
+    }
+    return true;
+}
+
+/* Return a cache's magazines to the depot of the arena they came from and
+ * publish its allocation delta. The counters are kept for stats. */
+static void pool_cache_flush(cauchy_pool_t* pool, pool_cache_t* cache,
+                             cauchy_atomic_u64_t* contention) {
+    pool_depot_t* depot = &pool->depots[cache->node];
+    if (cache->loaded_count > 0) {
+        depot_push(depot, cache->loaded, cache->loaded_count, contention);
+    }
+    if (cache->previous_count > 0) {
+        depot_push(depot, cache->previous, cache->previous_count, contention);
+    }
+    pool_publish(pool, cache->unpublished);
+    cache->loaded = NULL;
+    cache->loaded_count = 0;
+    cache->previous = NULL;
+    cache->previous_count = 0;
+    cache->unpublished = 0;
+}
+
+/* Flush the caches of exited threads so max_blocks does not count blocks
+ * no thread can reach. Returns true if any blocks were returned. */
+static bool pool_adopt_orphans(cauchy_pool_t* pool, cauchy_atomic_u64_t* contention) {
+    bool returned = false;
+    for (u32 i = 0; i < CAUCHY_MAX_THREADS; i++) {
+        pool_cache_t* cache = cauchy_atomic_load_ptr(&pool->caches[i]);
+        if (!cache) continue;
+
+        u64 owner = cauchy_atomic_load_u64(&cache->owner);
+        if (owner == 0 || owner == POOL_OWNER_ADOPTING || cauchy_thread_alive(i, owner)) {
+            continue;
+        }
+        if (!cauchy_atomic_cas_u64(&cache->owner, &owner, POOL_OWNER_ADOPTING)) continue;
+        returned |= cache->loaded_count + cache->previous_count > 0;
+        pool_cache_flush(pool, cache, contention);
+        cauchy_atomic_store_u64(&cache->owner, 0);
+    }
+    return returned;
+}
+
+/* A magazine for an arena: its depot, then a new slab, and once
+ * max_blocks stops growth, the free blocks of the other arenas and of
+ * exited threads' caches */
+static pool_node_t* pool_refill(cauchy_pool_t* pool, u32 arena, usize* count,
+                                cauchy_atomic_u64_t* contention) {
+    pool_node_t* mag = depot_pop(&pool->depots[arena], count, contention);
+    if (mag || pool_grow(pool, arena, pool->slab_blocks, &mag, count, contention)) return mag;
+    do {
+        for (u32 i = 0; i < pool->arenas; i++) {
+            mag = depot_pop(&pool->depots[(arena + i) % pool->arenas], count, contention);
+            if (mag) return mag;
+        }
+    } while (pool_adopt_orphans(pool, contention));
+    return NULL;
+}
+
+/* Slot recycled from an exited thread: flush whatever it left behind
+ * (waiting out an adopter) and refill from this thread's node. */
+static pool_cache_t* pool_claim_cache(cauchy_pool_t* pool, pool_cache_t* cache, u64 gen) {
+    u64 owner = cauchy_atomic_load_u64(&cache->owner);
+    for (;;) {
+        if (owner == POOL_OWNER_ADOPTING) {
+            CAUCHY_CPU_PAUSE();
+            owner = cauchy_atomic_load_u64(&cache->owner);
+            continue;
+        }
+        if (cauchy_atomic_cas_u64(&cache->owner, &owner, gen)) break;
+    }
+    pool_cache_flush(pool, cache, &cache->contention);
+    cache->node = pool_local_arena(pool);
+    return cache;
+}
+
+static pool_cache_t* pool_get_cache(cauchy_pool_t* pool) {
+    u32 tid = cauchy_thread_id();
+    if (CAUCHY_UNLIKELY(tid == CAUCHY_THREAD_ID_INVALID)) return NULL;
+
+    u64 gen = cauchy_thread_generation();
+    pool_cache_t* cache = cauchy_atomic_load_ptr(&pool->caches[tid]);
+    if (CAUCHY_LIKELY(cache != NULL)) {
+        if (CAUCHY_LIKELY(atomic_load_explicit(&cache->owner, memory_order_relaxed) == gen)) {
+            return cache;
+        }
+        return pool_claim_cache(pool, cache, gen);
+    }
+
+    cache = cauchy_aligned_alloc(sizeof(pool_cache_t), CAUCHY_CACHE_LINE_SIZE);
+    if (!cache) return NULL;
+    memset(cache, 0, sizeof(pool_cache_t));
+    atomic_init(&cache->owner, gen);
+    cache->node = pool_local_arena(pool);
+    cauchy_atomic_store_ptr(&pool->caches[tid], cache);
+    return cache;
+}
+
 cauchy_pool_t* cauchy_pool_create(const cauchy_pool_config_t* config) {
     cauchy_pool_config_t cfg = config ? *config : (cauchy_pool_config_t)CAUCHY_POOL_CONFIG_DEFAULT;
     
     if (cfg.alignment == 0) cfg.alignment = CAUCHY_CACHE_LINE_SIZE;
+    if (cfg.alignment < sizeof(void*)) cfg.alignment = sizeof(void*);
+    if (cfg.magazine_size == 0) cfg.magazine_size = CAUCHY_POOL_MAGAZINE_SIZE;
+    if (cfg.slab_blocks == 0) cfg.slab_blocks = CAUCHY_POOL_SLAB_BLOCKS;
+    if (cfg.slab_blocks < cfg.magazine_size) cfg.slab_blocks = cfg.magazine_size;
+
+    usize min_block = (sizeof(pool_node_t) + cfg.alignment - 1) & ~(cfg.alignment - 1);
     usize actual_block_size = (cfg.block_size + cfg.alignment - 1) & ~(cfg.alignment - 1);
-    if (actual_block_size < sizeof(pool_node_t)) {
-        actual_block_size = sizeof(pool_node_t);
+    if (actual_block_size < min_block) {
+        actual_block_size = min_block;
     }
     
     cauchy_pool_t* pool = cauchy_aligned_alloc(sizeof(cauchy_pool_t), CAUCHY_CACHE_LINE_SIZE);
     if (!pool) return NULL;
     
     memset(pool, 0, sizeof(cauchy_pool_t));
+    pool->numa = cfg.numa;
+    pool->numa_node = cfg.numa_node;
+    pool->map_flags = cfg.huge_pages ? CAUCHY_NUMA_HUGE : 0;
+    pool->arenas = 1;
+    if (cfg.numa == CAUCHY_POOL_NUMA_LOCAL || cfg.numa == CAUCHY_POOL_NUMA_BIND) {
+        pool->arenas = cauchy_numa_node_count();
+    }
+    pool->depots = cauchy_aligned_alloc(pool->arenas * sizeof(pool_depot_t), CAUCHY_CACHE_LINE_SIZE);
+    if (!pool->depots) {
+        cauchy_aligned_free(pool);
+        return NULL;
+    }
+    memset(pool->depots, 0, pool->arenas * sizeof(pool_depot_t));
     pool->block_size = actual_block_size;
     pool->alignment = cfg.alignment;
     pool->max_blocks = cfg.max_blocks;
-    atomic_init(&pool->free_list, NULL);
-    
+    pool->magazine_size = cfg.magazine_size;
+    pool->slab_blocks = cfg.slab_blocks;
+    pool->slab_header = (sizeof(pool_slab_t) + cfg.alignment - 1) & ~(cfg.alignment - 1);
+#if !CAUCHY_HAS_DWCAS
+    for (u32 i = 0; i < pool->arenas; i++) {
+        atomic_init(&pool->depots[i].head, NULL);
+        atomic_flag_clear(&pool->depots[i].lock);
+    }
+#endif
+    atomic_init(&pool->slabs, NULL);
+
     if (cfg.initial_blocks > 0) {
-        usize total_size = actual_block_size * cfg.initial_blocks;
-        pool->base_memory = cauchy_aligned_alloc(total_size, cfg.alignment);
-        if (!pool->base_memory) {
-            cauchy_aligned_free(pool);
-            return NULL;
-        }
-        pool->base_size = total_size;
-        
-        u8* block = (u8*)pool->base_memory;
-        for (usize i = 0; i < cfg.initial_blocks; i++) {
-            pool_node_t* node = (pool_node_t*)block;
-            node->next = cauchy_atomic_load_ptr(&pool->free_list);
-            cauchy_atomic_store_ptr(&pool->free_list, node);
-            block += actual_block_size;
+        u32 first = pool_local_arena(pool);
+        u32 spread = pool->numa == CAUCHY_POOL_NUMA_BIND ? pool->arenas : 1;
+        for (u32 i = 0; i < spread; i++) {
+            usize blocks = cfg.initial_blocks / spread + (i < cfg.initial_blocks % spread);
+            if (blocks > 0 && !pool_grow(pool, (first + i) % pool->arenas, blocks, NULL, NULL,
+                                         &pool->shared_contention)) {
+                cauchy_pool_destroy(pool);
+                return NULL;
+            }
         }
-        atomic_store(&pool->allocated, cfg.initial_blocks);
     }
-    
+
     return pool;
 }
 
 void cauchy_pool_destroy(cauchy_pool_t* pool) {
     if (!pool) return;
-    if (pool->base_memory) {
-        cauchy_aligned_free(pool->base_memory);
+    for (u32 i = 0; i < CAUCHY_MAX_THREADS; i++) {
+        cauchy_aligned_free(cauchy_atomic_load_ptr(&pool->caches[i]));
+    }
+    pool_slab_t* slab = cauchy_atomic_load_ptr(&pool->slabs);
+    while (slab) {
+        pool_slab_t* next = slab->next;
+        slab_free(pool, slab);
+        slab = next;
     }
+    cauchy_aligned_free(pool->depots);
     cauchy_aligned_free(pool);
 }
 
+/* Slow path for threads without a cache: take one block off a depot
+ * magazine and return the remainder. */
+static void* pool_alloc_shared(cauchy_pool_t* pool) {
+    usize count;
+    u32 arena = pool_local_arena(pool);
+    pool_node_t* mag = pool_refill(pool, arena, &count, &pool->shared_contention);
+    if (!mag) return NULL;
+    if (count > 1) {
+        depot_push(&pool->depots[arena], mag->next, count - 1, &pool->shared_contention);
+    }
+    cauchy_atomic_fetch_add_u64(&pool->shared_allocs, 1);
+    pool_publish(pool, 1);
+    return mag;
+}
+
 void* cauchy_pool_alloc(cauchy_pool_t* pool) {
     if (!pool) return NULL;
     
-    cauchy_atomic_fetch_add_u64(&pool->total_allocs, 1);
-    
-    pool_node_t* node;
-    pool_node_t* next;
-    do {
-        node = cauchy_atomic_load_ptr(&pool->free_list);
-        if (!node) {
-            void* new_block = cauchy_aligned_alloc(pool->block_size, pool->alignment);
-            if (new_block) {
-                cauchy_atomic_fetch_add_u64(&pool->allocated, 1);
-            }
-            return new_block;
+    pool_cache_t* cache = pool_get_cache(pool);
+    if (CAUCHY_UNLIKELY(!cache)) return pool_alloc_shared(pool);
+
+    if (CAUCHY_UNLIKELY(cache->loaded_count == 0)) {
+        if (cache->previous_count > 0) {
+            cache->loaded = cache->previous;
+            cache->loaded_count = cache->previous_count;
+            cache->previous = NULL;
+            cache->previous_count = 0;
+        } else {
+            pool_publish(pool, cache->unpublished);
+            cache->unpublished = 0;
+            /* Follow the thread if it moved to another node */
+            cache->node = pool_local_arena(pool);
+            pool_node_t* mag = pool_refill(pool, cache->node, &cache->loaded_count,
+                                           &cache->contention);
+            if (!mag) return NULL;
+            cache->loaded = mag;
         }
-        next = node->next;
-    } while (!cauchy_atomic_cas_ptr(&pool->free_list, (void**)&node, next));
-    
-    u64 in_use = cauchy_atomic_load_u64(&pool->allocated) - cauchy_atomic_load_u64(&pool->freed);
-    u64 peak = cauchy_atomic_load_u64(&pool->peak_use);
-    while (in_use > peak) {
-        if (cauchy_atomic_cas_u64(&pool->peak_use, &peak, in_use)) break;
     }
-    
+
+    pool_node_t* node = cache->loaded;
+    cache->loaded = node->next;
+    cache->loaded_count--;
+    cache->unpublished++;
+    stat_add(&cache->allocs, 1);
     return node;
 }
 
@@ -143,13 +526,33 @@ void cauchy_pool_free(cauchy_pool_t* pool, void* block) {
     if (!pool || !block) return;
     
     pool_node_t* node = (pool_node_t*)block;
-    pool_node_t* head;
-    do {
-        head = cauchy_atomic_load_ptr(&pool->free_list);
-        node->next = head;
-    } while (!cauchy_atomic_cas_ptr(&pool->free_list, (void**)&head, node));
-    
-    cauchy_atomic_fetch_add_u64(&pool->freed, 1);
+    pool_cache_t* cache = pool_get_cache(pool);
+    if (CAUCHY_UNLIKELY(!cache)) {
+        node->next = NULL;
+        depot_push(&pool->depots[pool_local_arena(pool)], node, 1, &pool->shared_contention);
+        cauchy_atomic_fetch_add_u64(&pool->shared_frees, 1);
+        pool_publish(pool, -1);
+        return;
+    }
+
+    if (CAUCHY_UNLIKELY(cache->loaded_count >= pool->magazine_size)) {
+        if (cache->previous_count > 0) {
+            pool_publish(pool, cache->unpublished);
+            cache->unpublished = 0;
+            depot_push(&pool->depots[cache->node], cache->previous, cache->previous_count,
+                       &cache->contention);
+        }
+        cache->previous = cache->loaded;
+        cache->previous_count = cache->loaded_count;
+        cache->loaded = NULL;
+        cache->loaded_count = 0;
+    }
+
+    node->next = cache->loaded;
+    cache->loaded = node;
+    cache->loaded_count++;
+    cache->unpublished--;
+    stat_add(&cache->frees, 1);
 }
 
 cauchy_pool_stats_t cauchy_pool_get_stats(const cauchy_pool_t* pool) {
@@ -157,11 +560,18 @@ cauchy_pool_stats_t cauchy_pool_get_stats(const cauchy_pool_t* pool) {
     if (!pool) return stats;
     
     stats.allocated = cauchy_atomic_load_u64(&pool->allocated);
-    stats.freed = cauchy_atomic_load_u64(&pool->freed);
-    stats.in_use = stats.allocated - stats.freed;
+    stats.contention = cauchy_atomic_load_u64(&pool->shared_contention);
+    stats.freed = cauchy_atomic_load_u64(&pool->shared_frees);
+    stats.total_allocs = cauchy_atomic_load_u64(&pool->shared_allocs);
+    for (u32 i = 0; i < CAUCHY_MAX_THREADS; i++) {
+        pool_cache_t* cache = cauchy_atomic_load_ptr(&pool->caches[i]);
+        if (!cache) continue;
+        stats.freed += atomic_load_explicit(&cache->frees, memory_order_relaxed);
+        stats.total_allocs += atomic_load_explicit(&cache->allocs, memory_order_relaxed);
+        stats.contention += atomic_load_explicit(&cache->contention, memory_order_relaxed);
+    }
+    stats.in_use = stats.total_allocs > stats.freed ? stats.total_allocs - stats.freed : 0;
     stats.peak_use = cauchy_atomic_load_u64(&pool->peak_use);
-    stats.total_allocs = cauchy_atomic_load_u64(&pool->total_allocs);
-    stats.contention = cauchy_atomic_load_u64(&pool->contention);
+    if (stats.in_use > stats.peak_use) stats.peak_use = stats.in_use;
     return stats;
 }
-
@@ -0,0 +1,48 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Incremental Merkle Digest Implementation
+ */
+
+#include "cauchy/merkle.h"
+#include <stdlib.h>
+
+cauchy_result_t cauchy_merkle_init(cauchy_merkle_t* tree, u32 depth) {
+    if (!tree || depth > CAUCHY_MERKLE_MAX_DEPTH) return CAUCHY_ERR_INVALID;
+    tree->nodes = calloc(((usize)2 << depth) - 1, sizeof(u64));
+    if (!tree->nodes) return CAUCHY_ERR_NOMEM;
+    tree->depth = depth;
+    tree->items = 0;
+    return CAUCHY_OK;
+}
+
+void cauchy_merkle_destroy(cauchy_merkle_t* tree) {
+    if (!tree) return;
+    free(tree->nodes);
+    tree->nodes = NULL;
+    tree->items = 0;
+}
+
+/* Walk from the leaf to the root adding delta (wrapping) at each node */
+static void apply(cauchy_merkle_t* tree, u64 key_hash, u64 delta) {
+    usize idx = ((usize)1 << tree->depth) - 1 + cauchy_merkle_bucket(tree->depth, key_hash);
+    for (;;) {
+        tree->nodes[idx] += delta;
+        if (idx == 0) break;
+        idx = (idx - 1) / 2;
+    }
+}
+
+void cauchy_merkle_add(cauchy_merkle_t* tree, u64 key_hash, u64 digest) {
+    apply(tree, key_hash, cauchy_merkle_item(digest));
+    tree->items++;
+}
+
+void cauchy_merkle_remove(cauchy_merkle_t* tree, u64 key_hash, u64 digest) {
+    apply(tree, key_hash, -cauchy_merkle_item(digest));
+    tree->items--;
+}
+
+u64 cauchy_merkle_node(const cauchy_merkle_t* tree, u32 level, u64 index) {
+    if (!tree || level > tree->depth || index >> level) return 0;
+    return tree->nodes[((usize)1 << level) - 1 + index];
+}
@@ -0,0 +1,250 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Versioned Views Implementation
+ */
+
+#include "cauchy/mvcc.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Pending retirements before a reclaim pass, at least */
+#define MVCC_RECLAIM_MIN 64
+
+/* Dead records a generation may hold before it is compacted */
+#define MVCC_COMPACT_MIN 1024
+
+CAUCHY_INLINE u32 segment_of(usize slot, usize* offset) {
+    usize j = slot / CAUCHY_MVCC_SEGMENT_BASE + 1;
+    u32 k = 63 - (u32)__builtin_clzll((unsigned long long)j);
+    *offset = slot - CAUCHY_MVCC_SEGMENT_BASE * ((1ULL << k) - 1);
+    return k;
+}
+
+cauchy_mvcc_record_t* cauchy_mvcc_record(const cauchy_mvcc_log_t* log, usize slot) {
+    usize offset;
+    u32 k = segment_of(slot, &offset);
+    return &log->segments[k][offset];
+}
+
+static cauchy_mvcc_log_t* log_new(void) {
+    return calloc(1, sizeof(cauchy_mvcc_log_t));
+}
+
+static void log_free(void* item, void* ctx) {
+    (void)ctx;
+    cauchy_mvcc_log_t* log = item;
+    for (u32 k = 0; k < CAUCHY_MVCC_SEGMENTS; k++) free(log->segments[k]);
+    free(log);
+}
+
+/* Place a record at the end of log; false if out of memory or slots */
+static bool log_push(cauchy_mvcc_log_t* log, void* item, u64 born, u64 died) {
+    if (log->length >= CAUCHY_MVCC_NONE) return false;
+    usize offset;
+    u32 k = segment_of(log->length, &offset);
+    if (k >= CAUCHY_MVCC_SEGMENTS) return false;
+    if (!log->segments[k]) {
+        log->segments[k] = malloc(((usize)CAUCHY_MVCC_SEGMENT_BASE << k) *
+                                  sizeof(cauchy_mvcc_record_t));
+        if (!log->segments[k]) return false;
+    }
+    cauchy_mvcc_record_t* rec = &log->segments[k][offset];
+    rec->item = item;
+    rec->born = born;
+    atomic_store_explicit(&rec->died, died, memory_order_relaxed);
+    log->length++;
+    return true;
+}
+
+cauchy_result_t cauchy_mvcc_init(cauchy_mvcc_t* m, cauchy_mvcc_relocate_fn relocate, void* arg) {
+    if (!m) return CAUCHY_ERR_INVALID;
+    memset(m, 0, sizeof(*m));
+    m->current = log_new();
+    if (!m->current) return CAUCHY_ERR_NOMEM;
+    m->next = 2;
+    m->relocate = relocate;
+    m->relocate_arg = arg;
+    atomic_init(&m->seq, 0);
+    atomic_init(&m->version, 1);
+    atomic_init(&m->log, m->current);
+    atomic_init(&m->length, 0);
+    atomic_init(&m->meta[0], 0);
+    atomic_init(&m->meta[1], 0);
+    for (u32 i = 0; i < CAUCHY_MVCC_MAX_VIEWS; i++) atomic_init(&m->pins[i], 0);
+    return CAUCHY_OK;
+}
+
+void cauchy_mvcc_fini(cauchy_mvcc_t* m) {
+    if (!m || !m->current) return;
+    for (usize i = 0; i < m->retired_count; i++) {
+        m->retired[i].fn(m->retired[i].item, m->retired[i].ctx);
+    }
+    free(m->retired);
+    log_free(m->current, NULL);
+    m->current = NULL;
+    m->retired = NULL;
+    m->retired_count = m->retired_capacity = 0;
+}
+
+cauchy_result_t cauchy_mvcc_append(cauchy_mvcc_t* m, void* item, u32* slot) {
+    if (!log_push(m->current, item, m->next, CAUCHY_MVCC_LIVE)) return CAUCHY_ERR_NOMEM;
+    *slot = (u32)(m->current->length - 1);
+    return CAUCHY_OK;
+}
+
+void cauchy_mvcc_end(cauchy_mvcc_t* m, u32 slot) {
+    if (slot == CAUCHY_MVCC_NONE || slot >= m->current->length) return;
+    cauchy_mvcc_record_t* rec = cauchy_mvcc_record(m->current, slot);
+    if (atomic_load_explicit(&rec->died, memory_order_relaxed) != CAUCHY_MVCC_LIVE) return;
+    atomic_store_explicit(&rec->died, m->next, memory_order_relaxed);
+    m->dead++;
+}
+
+static bool retire_push(cauchy_mvcc_t* m, void* item, cauchy_retire_fn fn, void* ctx) {
+    if (m->retired_count == m->retired_capacity) {
+        usize capacity = m->retired_capacity ? m->retired_capacity * 2 : MVCC_RECLAIM_MIN;
+        cauchy_mvcc_retired_t* grown = realloc(m->retired, capacity * sizeof(*grown));
+        if (!grown) return false;
+        m->retired = grown;
+        m->retired_capacity = capacity;
+    }
+    m->retired[m->retired_count++] = (cauchy_mvcc_retired_t){ item, m->next, fn, ctx };
+    return true;
+}
+
+void cauchy_mvcc_retire(cauchy_mvcc_t* m, void* item, cauchy_retire_fn fn, void* ctx) {
+    retire_push(m, item, fn, ctx);
+}
+
+/* Oldest version a view may still be reading */
+static u64 oldest_pin(const cauchy_mvcc_t* m) {
+    u64 oldest = atomic_load_explicit(&m->version, memory_order_relaxed);
+    for (u32 i = 0; i < CAUCHY_MVCC_MAX_VIEWS; i++) {
+        u64 pin = atomic_load_explicit(&m->pins[i], memory_order_acquire);
+        if (pin && pin < oldest) oldest = pin;
+    }
+    return oldest;
+}
+
+static void reclaim(cauchy_mvcc_t* m) {
+    u64 oldest = oldest_pin(m);
+    usize kept = 0;
+    for (usize i = 0; i < m->retired_count; i++) {
+        cauchy_mvcc_retired_t* r = &m->retired[i];
+        if (r->version <= oldest) {
+            r->fn(r->item, r->ctx);
+        } else {
+            m->retired[kept++] = *r;
+        }
+    }
+    m->retired_count = kept;
+}
+
+static void publish(cauchy_mvcc_t* m, u64 meta0, u64 meta1) {
+    u64 seq = atomic_load_explicit(&m->seq, memory_order_relaxed);
+    atomic_store_explicit(&m->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&m->version, m->next, memory_order_relaxed);
+    atomic_store_explicit(&m->log, m->current, memory_order_relaxed);
+    atomic_store_explicit(&m->length, m->current->length, memory_order_relaxed);
+    atomic_store_explicit(&m->meta[0], meta0, memory_order_relaxed);
+    atomic_store_explicit(&m->meta[1], meta1, memory_order_relaxed);
+    atomic_store_explicit(&m->seq, seq + 2, memory_order_release);
+}
+
+/* Copy the live records into a new generation. Views reading the old
+ * one keep it until they close. */
+static void compact(cauchy_mvcc_t* m, u64 meta0, u64 meta1) {
+    cauchy_mvcc_log_t* old = m->current;
+    cauchy_mvcc_log_t* log = log_new();
+    if (!log) return;
+    for (usize i = 0; i < old->length; i++) {
+        cauchy_mvcc_record_t* rec = cauchy_mvcc_record(old, i);
+        if (atomic_load_explicit(&rec->died, memory_order_relaxed) != CAUCHY_MVCC_LIVE) continue;
+        if (!log_push(log, rec->item, rec->born, CAUCHY_MVCC_LIVE)) {
+            log_free(log, NULL);
+            return;
+        }
+    }
+    if (!retire_push(m, old, log_free, NULL)) {
+        log_free(log, NULL);
+        return;
+    }
+    if (m->relocate) {
+        for (usize i = 0; i < log->length; i++) {
+            m->relocate(m->relocate_arg, cauchy_mvcc_record(log, i)->item, (u32)i);
+        }
+    }
+    m->current = log;
+    m->dead = 0;
+    publish(m, meta0, meta1);
+    m->next++;
+}
+
+void cauchy_mvcc_publish(cauchy_mvcc_t* m, u64 meta0, u64 meta1) {
+    publish(m, meta0, meta1);
+    m->next++;
+    /* Pairs with the fence in view_open: a retirement is freed only if
+     * the view pinning it is seen, or the view sees the newer state */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (m->retired_count >= MVCC_RECLAIM_MIN) reclaim(m);
+    if (m->dead >= MVCC_COMPACT_MIN && m->dead * 2 > m->current->length) {
+        compact(m, meta0, meta1);
+    }
+}
+
+cauchy_result_t cauchy_mvcc_view_open(cauchy_mvcc_t* m, cauchy_mvcc_view_t* view) {
+    if (!m || !view) return CAUCHY_ERR_INVALID;
+
+    /* Pin a version no newer than the one the view will read. Anything
+     * retired after it stays; anything retired before it is invisible
+     * at the version read below, which can only be newer. */
+    u64 floor = atomic_load_explicit(&m->version, memory_order_acquire);
+    u32 pin = CAUCHY_MVCC_MAX_VIEWS;
+    for (u32 i = 0; i < CAUCHY_MVCC_MAX_VIEWS && pin == CAUCHY_MVCC_MAX_VIEWS; i++) {
+        u64 expected = 0;
+        if (atomic_load_explicit(&m->pins[i], memory_order_relaxed) == 0 &&
+            atomic_compare_exchange_strong(&m->pins[i], &expected, floor)) {
+            pin = i;
+        }
+    }
+    if (pin == CAUCHY_MVCC_MAX_VIEWS) return CAUCHY_ERR_FULL;
+    atomic_thread_fence(memory_order_seq_cst);
+
+    u64 seq;
+    do {
+        seq = atomic_load_explicit(&m->seq, memory_order_acquire);
+        if (seq & 1) {
+            CAUCHY_CPU_PAUSE();
+            continue;
+        }
+        view->version = atomic_load_explicit(&m->version, memory_order_relaxed);
+        view->log = atomic_load_explicit(&m->log, memory_order_relaxed);
+        view->length = (usize)atomic_load_explicit(&m->length, memory_order_relaxed);
+        view->meta[0] = atomic_load_explicit(&m->meta[0], memory_order_relaxed);
+        view->meta[1] = atomic_load_explicit(&m->meta[1], memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+    } while ((seq & 1) || atomic_load_explicit(&m->seq, memory_order_relaxed) != seq);
+
+    atomic_store_explicit(&m->pins[pin], view->version, memory_order_release);
+    view->mvcc = m;
+    view->pin = pin;
+    view->cursor = 0;
+    return CAUCHY_OK;
+}
+
+void cauchy_mvcc_view_close(cauchy_mvcc_view_t* view) {
+    if (!view || !view->mvcc) return;
+    atomic_store_explicit(&view->mvcc->pins[view->pin], 0, memory_order_release);
+    view->mvcc = NULL;
+}
+
+void* cauchy_mvcc_view_next(cauchy_mvcc_view_t* view) {
+    while (view->cursor < view->length) {
+        cauchy_mvcc_record_t* rec = cauchy_mvcc_record(view->log, view->cursor++);
+        if (rec->born > view->version) continue;
+        if (atomic_load_explicit(&rec->died, memory_order_relaxed) <= view->version) continue;
+        return rec->item;
+    }
+    return NULL;
+}
@@ -0,0 +1,172 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * NUMA Topology and Placement Implementation
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE  /* syscall(2), sched_setaffinity(2), MAP_HUGETLB */
+#endif
+
+#include "cauchy/numa.h"
+#include "cauchy/memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(CAUCHY_OS_LINUX)
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+/* mbind(2) and get_mempolicy(2) constants, spelled out so <numaif.h> is
+ * optional */
+#define NUMA_MPOL_PREFERRED 1
+#define NUMA_MPOL_F_NODE    (1 << 0)
+#define NUMA_MPOL_F_ADDR    (1 << 1)
+
+static cauchy_atomic_u32_t numa_nodes;  /* 0 until read */
+
+#if defined(CAUCHY_OS_LINUX)
+
+/* Parse a sysfs list such as "0-3,8-11", calling fn for every member */
+static bool parse_list(const char* path, void (*fn)(void* arg, u32 value), void* arg) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char buf[4096];
+    bool ok = fgets(buf, sizeof(buf), f) != NULL;
+    fclose(f);
+    if (!ok) return false;
+
+    const char* p = buf;
+    while (*p >= '0' && *p <= '9') {
+        char* end;
+        unsigned long lo = strtoul(p, &end, 10);
+        unsigned long hi = lo;
+        if (*end == '-') hi = strtoul(end + 1, &end, 10);
+        for (unsigned long v = lo; v <= hi && v < UINT32_MAX; v++) fn(arg, (u32)v);
+        p = *end == ',' ? end + 1 : end;
+    }
+    return true;
+}
+
+static void note_max(void* arg, u32 value) {
+    u32* max = arg;
+    if (value + 1 > *max) *max = value + 1;
+}
+
+static void add_cpu(void* arg, u32 cpu) {
+    if (cpu < CPU_SETSIZE) CPU_SET(cpu, (cpu_set_t*)arg);
+}
+
+#endif
+
+u32 cauchy_numa_node_count(void) {
+    u32 count = cauchy_atomic_load_u32(&numa_nodes);
+    if (CAUCHY_LIKELY(count)) return count;
+#if defined(CAUCHY_OS_LINUX)
+    parse_list("/sys/devices/system/node/online", note_max, &count);
+#endif
+    if (count == 0) count = 1;
+    if (count > CAUCHY_NUMA_MAX_NODES) count = CAUCHY_NUMA_MAX_NODES;
+    cauchy_atomic_store_u32(&numa_nodes, count);
+    return count;
+}
+
+u32 cauchy_numa_current_node(void) {
+#if defined(CAUCHY_OS_LINUX) && defined(__NR_getcpu)
+    unsigned cpu, node;
+    if (syscall(__NR_getcpu, &cpu, &node, NULL) == 0) {
+        u32 count = cauchy_numa_node_count();
+        return node < count ? node : count - 1;
+    }
+#endif
+    return 0;
+}
+
+cauchy_result_t cauchy_numa_bind_thread(u32 node) {
+    if (node >= cauchy_numa_node_count()) return CAUCHY_ERR_INVALID;
+#if defined(CAUCHY_OS_LINUX)
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    /* No topology means a single node: every CPU is already local */
+    if (!parse_list(path, add_cpu, &cpus)) return CAUCHY_OK;
+    if (CPU_COUNT(&cpus) == 0) return CAUCHY_ERR_INVALID;
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) return CAUCHY_ERR_IO;
+#endif
+    return CAUCHY_OK;
+}
+
+i32 cauchy_numa_node_of(const void* addr) {
+#if defined(CAUCHY_OS_LINUX) && defined(__NR_get_mempolicy)
+    int node = -1;
+    if (addr && syscall(__NR_get_mempolicy, &node, NULL, 0UL, addr,
+                        NUMA_MPOL_F_NODE | NUMA_MPOL_F_ADDR) == 0) {
+        return node;
+    }
+#else
+    (void)addr;
+#endif
+    return -1;
+}
+
+usize cauchy_numa_map_size(usize size, u32 flags) {
+    if ((flags & CAUCHY_NUMA_HUGE) && size >= CAUCHY_HUGE_PAGE_SIZE) {
+        return (size + CAUCHY_HUGE_PAGE_SIZE - 1) & ~(usize)(CAUCHY_HUGE_PAGE_SIZE - 1);
+    }
+    return size;
+}
+
+void* cauchy_numa_map(usize size, i32 node, u32 flags) {
+    if (size == 0) return NULL;
+#if defined(CAUCHY_OS_LINUX)
+    usize length = cauchy_numa_map_size(size, flags);
+    bool huge = (flags & CAUCHY_NUMA_HUGE) && size >= CAUCHY_HUGE_PAGE_SIZE;
+    void* ptr = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+    if (huge) {
+        ptr = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+#endif
+    if (ptr == MAP_FAILED) {
+        ptr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) return NULL;
+#if defined(MADV_HUGEPAGE)
+        if (huge) madvise(ptr, length, MADV_HUGEPAGE);
+#endif
+    }
+#if defined(__NR_mbind)
+    /* Without NUMA support in the kernel this fails and first touch
+     * places the pages, which is all there is to do anyway */
+    if (node >= 0 && (u32)node < cauchy_numa_node_count() && cauchy_numa_node_count() > 1) {
+        const u32 bits = 8 * sizeof(unsigned long);
+        unsigned long mask[CAUCHY_NUMA_MAX_NODES / (8 * sizeof(unsigned long))] = {0};
+        mask[(u32)node / bits] = 1UL << ((u32)node % bits);
+        syscall(__NR_mbind, ptr, length, NUMA_MPOL_PREFERRED, mask,
+                (unsigned long)CAUCHY_NUMA_MAX_NODES + 1, 0U);
+    }
+#endif
+    return ptr;
+#else
+    (void)node;
+    usize length = cauchy_numa_map_size(size, flags);
+    void* ptr = cauchy_aligned_alloc(length, 4096);
+    if (ptr) memset(ptr, 0, length);
+    return ptr;
+#endif
+}
+
+void cauchy_numa_unmap(void* ptr, usize size, u32 flags) {
+    if (!ptr) return;
+#if defined(CAUCHY_OS_LINUX)
+    munmap(ptr, cauchy_numa_map_size(size, flags));
+#else
+    (void)size;
+    (void)flags;
+    cauchy_aligned_free(ptr);
+#endif
+}
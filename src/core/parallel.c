@@ -0,0 +1,88 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Parallel Execution Implementation
+ */
+
+#include "cauchy/parallel.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct thread_task {
+    cauchy_task_fn task;
+    void*          arg;
+    u32            index;
+} thread_task_t;
+
+static void* thread_main(void* arg) {
+    thread_task_t* t = arg;
+    t->task(t->arg, t->index);
+    return NULL;
+}
+
+static void run_threads(u32 count, cauchy_task_fn task, void* arg) {
+    pthread_t* threads = count > 1 ? malloc((count - 1) * sizeof(pthread_t)) : NULL;
+    thread_task_t* tasks = count > 1 ? malloc((count - 1) * sizeof(thread_task_t)) : NULL;
+    bool* started = count > 1 ? calloc(count - 1, sizeof(bool)) : NULL;
+    bool spawn = threads && tasks && started;
+
+    for (u32 i = 1; spawn && i < count; i++) {
+        tasks[i - 1] = (thread_task_t){ task, arg, i };
+        started[i - 1] = pthread_create(&threads[i - 1], NULL, thread_main, &tasks[i - 1]) == 0;
+    }
+    task(arg, 0);
+    for (u32 i = 1; i < count; i++) {
+        if (spawn && started[i - 1]) {
+            pthread_join(threads[i - 1], NULL);
+        } else {
+            task(arg, i);
+        }
+    }
+    free(threads);
+    free(tasks);
+    free(started);
+}
+
+void cauchy_executor_run(const cauchy_executor_t* exec, u32 count,
+                         cauchy_task_fn task, void* arg) {
+    if (!task || count == 0) return;
+    if (exec && exec->run) {
+        exec->run(exec->ctx, count, task, arg);
+    } else {
+        run_threads(count, task, arg);
+    }
+}
+
+u32 cauchy_parallel_default_parts(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) return 1;
+    return cpus > CAUCHY_PARALLEL_MAX_PARTS ? CAUCHY_PARALLEL_MAX_PARTS : (u32)cpus;
+}
+
+cauchy_result_t cauchy_scatter_init(cauchy_scatter_t* s, u32 parts) {
+    if (!s || parts == 0) return CAUCHY_ERR_INVALID;
+    s->bins = calloc((usize)parts * parts, sizeof(cauchy_scatter_bin_t));
+    if (!s->bins) return CAUCHY_ERR_NOMEM;
+    s->parts = parts;
+    return CAUCHY_OK;
+}
+
+void cauchy_scatter_fini(cauchy_scatter_t* s) {
+    if (!s || !s->bins) return;
+    for (usize i = 0; i < (usize)s->parts * s->parts; i++) free(s->bins[i].items);
+    free(s->bins);
+    s->bins = NULL;
+    s->parts = 0;
+}
+
+bool cauchy_scatter_push(cauchy_scatter_bin_t* bin, u64 hash, u64 ref) {
+    if (bin->count == bin->capacity) {
+        usize capacity = bin->capacity ? bin->capacity * 2 : 256;
+        cauchy_scatter_item_t* items = realloc(bin->items, capacity * sizeof(*items));
+        if (!items) return false;
+        bin->items = items;
+        bin->capacity = capacity;
+    }
+    bin->items[bin->count++] = (cauchy_scatter_item_t){ hash, ref };
+    return true;
+}
@@ -0,0 +1,292 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Vectorized u64 Array Kernels Implementation
+ */
+
+#include "cauchy/simd.h"
+#include "cauchy/atomic.h"
+
+#if defined(CAUCHY_SIMD_X86)
+    #include <immintrin.h>
+    #define TARGET_AVX2   __attribute__((target("avx2")))
+    #define TARGET_AVX512 __attribute__((target("avx512f")))
+#elif defined(CAUCHY_SIMD_NEON)
+    #include <arm_neon.h>
+#endif
+
+typedef struct simd_ops {
+    cauchy_simd_level_t level;
+    void (*max)(u64* CAUCHY_RESTRICT, const u64* CAUCHY_RESTRICT, usize);
+    void (*min)(u64* CAUCHY_RESTRICT, const u64* CAUCHY_RESTRICT, usize);
+    u32  (*cmp)(const u64*, const u64*, usize);
+    u64  (*sum)(const u64*, usize);
+} simd_ops_t;
+
+/* ============================================================
+ * Scalar
+ * ============================================================ */
+
+static void scalar_max(u64* CAUCHY_RESTRICT dst, const u64* CAUCHY_RESTRICT src, usize n) {
+    for (usize i = 0; i < n; i++) {
+        if (src[i] > dst[i]) dst[i] = src[i];
+    }
+}
+
+static void scalar_min(u64* CAUCHY_RESTRICT dst, const u64* CAUCHY_RESTRICT src, usize n) {
+    for (usize i = 0; i < n; i++) {
+        if (src[i] < dst[i]) dst[i] = src[i];
+    }
+}
+
+static u32 scalar_cmp(const u64* a, const u64* b, usize n) {
+    u32 r = 0;
+    for (usize i = 0; i < n; i++) {
+        if (a[i] < b[i]) r |= CAUCHY_SIMD_LESS;
+        if (a[i] > b[i]) r |= CAUCHY_SIMD_GREATER;
+    }
+    return r;
+}
+
+static u64 scalar_sum(const u64* a, usize n) {
+    u64 sum = 0;
+    for (usize i = 0; i < n; i++) sum += a[i];
+    return sum;
+}
+
+static const simd_ops_t scalar_ops = {
+    CAUCHY_SIMD_SCALAR, scalar_max, scalar_min, scalar_cmp, scalar_sum
+};
+
+/* ============================================================
+ * x86-64: AVX2 (4 lanes) and AVX-512F (8 lanes)
+ * ============================================================ */
+
+#if defined(CAUCHY_SIMD_X86)
+
+/* AVX2 only has signed 64-bit compares: flip the sign bit first */
+#define AVX2_BIAS() _mm256_set1_epi64x((long long)0x8000000000000000ULL)
+
+TARGET_AVX2 static void avx2_max(u64* CAUCHY_RESTRICT dst, const u64* CAUCHY_RESTRICT src, usize n) {
+    const __m256i bias = AVX2_BIAS();
+    usize i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i gt = _mm256_cmpgt_epi64(_mm256_xor_si256(s, bias), _mm256_xor_si256(d, bias));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(d, s, gt));
+    }
+    scalar_max(dst + i, src + i, n - i);
+}
+
+TARGET_AVX2 static void avx2_min(u64* CAUCHY_RESTRICT dst, const u64* CAUCHY_RESTRICT src, usize n) {
+    const __m256i bias = AVX2_BIAS();
+    usize i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i lt = _mm256_cmpgt_epi64(_mm256_xor_si256(d, bias), _mm256_xor_si256(s, bias));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(d, s, lt));
+    }
+    scalar_min(dst + i, src + i, n - i);
+}
+
+TARGET_AVX2 static u32 avx2_cmp(const u64* a, const u64* b, usize n) {
+    const __m256i bias = AVX2_BIAS();
+    __m256i lt = _mm256_setzero_si256();
+    __m256i gt = _mm256_setzero_si256();
+    usize i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i)), bias);
+        __m256i vb = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(b + i)), bias);
+        lt = _mm256_or_si256(lt, _mm256_cmpgt_epi64(vb, va));
+        gt = _mm256_or_si256(gt, _mm256_cmpgt_epi64(va, vb));
+    }
+    u32 r = scalar_cmp(a + i, b + i, n - i);
+    if (!_mm256_testz_si256(lt, lt)) r |= CAUCHY_SIMD_LESS;
+    if (!_mm256_testz_si256(gt, gt)) r |= CAUCHY_SIMD_GREATER;
+    return r;
+}
+
+TARGET_AVX2 static u64 avx2_sum(const u64* a, usize n) {
+    __m256i acc = _mm256_setzero_si256();
+    usize i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm256_add_epi64(acc, _mm256_loadu_si256((const __m256i*)(a + i)));
+    }
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    u64 sum = (u64)_mm_cvtsi128_si64(half) + (u64)_mm_extract_epi64(half, 1);
+    return sum + scalar_sum(a + i, n - i);
+}
+
+static const simd_ops_t avx2_ops = {
+    CAUCHY_SIMD_AVX2, avx2_max, avx2_min, avx2_cmp, avx2_sum
+};
+
+/* Tails are handled with lane masks instead of a scalar loop */
+#define AVX512_TAIL(n, i) ((__mmask8)((n) - (i) >= 8 ? 0xFF : ((1u << ((n) - (i))) - 1)))
+
+TARGET_AVX512 static void avx512_max(u64* CAUCHY_RESTRICT dst, const u64* CAUCHY_RESTRICT src, usize n) {
+    for (usize i = 0; i < n; i += 8) {
+        __mmask8 m = AVX512_TAIL(n, i);
+        __m512i d = _mm512_maskz_loadu_epi64(m, dst + i);
+        __m512i s = _mm512_maskz_loadu_epi64(m, src + i);
+        _mm512_mask_storeu_epi64(dst + i, m, _mm512_max_epu64(d, s));
+    }
+}
+
+TARGET_AVX512 static void avx512_min(u64* CAUCHY_RESTRICT dst, const u64* CAUCHY_RESTRICT src, usize n) {
+    for (usize i = 0; i < n; i += 8) {
+        __mmask8 m = AVX512_TAIL(n, i);
+        __m512i d = _mm512_maskz_loadu_epi64(m, dst + i);
+        __m512i s = _mm512_maskz_loadu_epi64(m, src + i);
+        _mm512_mask_storeu_epi64(dst + i, m, _mm512_min_epu64(d, s));
+    }
+}
+
+TARGET_AVX512 static u32 avx512_cmp(const u64* a, const u64* b, usize n) {
+    __mmask8 lt = 0, gt = 0;
+    for (usize i = 0; i < n; i += 8) {
+        __mmask8 m = AVX512_TAIL(n, i);
+        __m512i va = _mm512_maskz_loadu_epi64(m, a + i);
+        __m512i vb = _mm512_maskz_loadu_epi64(m, b + i);
+        lt |= _mm512_cmplt_epu64_mask(va, vb);
+        gt |= _mm512_cmpgt_epu64_mask(va, vb);
+    }
+    return (lt ? CAUCHY_SIMD_LESS : 0) | (gt ? CAUCHY_SIMD_GREATER : 0);
+}
+
+TARGET_AVX512 static u64 avx512_sum(const u64* a, usize n) {
+    __m512i acc = _mm512_setzero_si512();
+    for (usize i = 0; i < n; i += 8) {
+        acc = _mm512_add_epi64(acc, _mm512_maskz_loadu_epi64(AVX512_TAIL(n, i), a + i));
+    }
+    /* _mm512_reduce_add_epi64 folds with signed scalar adds; stay unsigned */
+    u64 lanes[8];
+    _mm512_storeu_si512(lanes, acc);
+    return scalar_sum(lanes, 8);
+}
+
+static const simd_ops_t avx512_ops = {
+    CAUCHY_SIMD_AVX512, avx512_max, avx512_min, avx512_cmp, avx512_sum
+};
+
+#endif /* CAUCHY_SIMD_X86 */
+
+/* ============================================================
+ * ARM64: NEON (2 lanes)
+ * ============================================================ */
+
+#if defined(CAUCHY_SIMD_NEON)
+
+static void neon_max(u64* CAUCHY_RESTRICT dst, const u64* CAUCHY_RESTRICT src, usize n) {
+    usize i = 0;
+    for (; i + 2 <= n; i += 2) {
+        uint64x2_t d = vld1q_u64(dst + i);
+        uint64x2_t s = vld1q_u64(src + i);
+        vst1q_u64(dst + i, vbslq_u64(vcgtq_u64(s, d), s, d));
+    }
+    scalar_max(dst + i, src + i, n - i);
+}
+
+static void neon_min(u64* CAUCHY_RESTRICT dst, const u64* CAUCHY_RESTRICT src, usize n) {
+    usize i = 0;
+    for (; i + 2 <= n; i += 2) {
+        uint64x2_t d = vld1q_u64(dst + i);
+        uint64x2_t s = vld1q_u64(src + i);
+        vst1q_u64(dst + i, vbslq_u64(vcltq_u64(s, d), s, d));
+    }
+    scalar_min(dst + i, src + i, n - i);
+}
+
+static u32 neon_cmp(const u64* a, const u64* b, usize n) {
+    uint64x2_t lt = vdupq_n_u64(0);
+    uint64x2_t gt = vdupq_n_u64(0);
+    usize i = 0;
+    for (; i + 2 <= n; i += 2) {
+        uint64x2_t va = vld1q_u64(a + i);
+        uint64x2_t vb = vld1q_u64(b + i);
+        lt = vorrq_u64(lt, vcltq_u64(va, vb));
+        gt = vorrq_u64(gt, vcgtq_u64(va, vb));
+    }
+    u32 r = scalar_cmp(a + i, b + i, n - i);
+    if (vgetq_lane_u64(lt, 0) | vgetq_lane_u64(lt, 1)) r |= CAUCHY_SIMD_LESS;
+    if (vgetq_lane_u64(gt, 0) | vgetq_lane_u64(gt, 1)) r |= CAUCHY_SIMD_GREATER;
+    return r;
+}
+
+static u64 neon_sum(const u64* a, usize n) {
+    uint64x2_t acc = vdupq_n_u64(0);
+    usize i = 0;
+    for (; i + 2 <= n; i += 2) acc = vaddq_u64(acc, vld1q_u64(a + i));
+    return vaddvq_u64(acc) + scalar_sum(a + i, n - i);
+}
+
+static const simd_ops_t neon_ops = {
+    CAUCHY_SIMD_NEON, neon_max, neon_min, neon_cmp, neon_sum
+};
+
+#endif /* CAUCHY_SIMD_NEON */
+
+/* ============================================================
+ * Dispatch
+ * ============================================================ */
+
+static cauchy_atomic_ptr_t active_ops;
+
+static const simd_ops_t* best_ops(cauchy_simd_level_t limit) {
+#if defined(CAUCHY_SIMD_X86)
+    __builtin_cpu_init();
+    if (limit >= CAUCHY_SIMD_AVX512 && __builtin_cpu_supports("avx512f")) return &avx512_ops;
+    if (limit >= CAUCHY_SIMD_AVX2 && __builtin_cpu_supports("avx2")) return &avx2_ops;
+#elif defined(CAUCHY_SIMD_NEON)
+    if (limit >= CAUCHY_SIMD_NEON) return &neon_ops;
+#endif
+    (void)limit;
+    return &scalar_ops;
+}
+
+CAUCHY_INLINE const simd_ops_t* get_ops(void) {
+    const simd_ops_t* ops = atomic_load_explicit(&active_ops, memory_order_acquire);
+    if (CAUCHY_UNLIKELY(!ops)) {
+        /* Racing first calls all resolve to the same table */
+        ops = best_ops(CAUCHY_SIMD_AVX512);
+        atomic_store_explicit(&active_ops, (void*)ops, memory_order_release);
+    }
+    return ops;
+}
+
+cauchy_simd_level_t cauchy_simd_level(void) {
+    return get_ops()->level;
+}
+
+cauchy_simd_level_t cauchy_simd_select(cauchy_simd_level_t level) {
+    const simd_ops_t* ops = best_ops(level);
+    atomic_store_explicit(&active_ops, (void*)ops, memory_order_release);
+    return ops->level;
+}
+
+const char* cauchy_simd_level_name(cauchy_simd_level_t level) {
+    switch (level) {
+        case CAUCHY_SIMD_SCALAR: return "scalar";
+        case CAUCHY_SIMD_NEON:   return "neon";
+        case CAUCHY_SIMD_AVX2:   return "avx2";
+        case CAUCHY_SIMD_AVX512: return "avx512";
+        default:                 return "unknown";
+    }
+}
+
+void cauchy_simd_max_u64(u64* CAUCHY_RESTRICT dst, const u64* CAUCHY_RESTRICT src, usize n) {
+    get_ops()->max(dst, src, n);
+}
+
+void cauchy_simd_min_u64(u64* CAUCHY_RESTRICT dst, const u64* CAUCHY_RESTRICT src, usize n) {
+    get_ops()->min(dst, src, n);
+}
+
+u32 cauchy_simd_cmp_u64(const u64* a, const u64* b, usize n) {
+    return get_ops()->cmp(a, b, n);
+}
+
+u64 cauchy_simd_sum_u64(const u64* a, usize n) {
+    return get_ops()->sum(a, n);
+}
@@ -0,0 +1,505 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Memory-Mapped Snapshot Implementation
+ */
+
+#include "cauchy/snapshot.h"
+#include "cauchy/htable.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SNAPSHOT_MAGIC      "CAUCHYSN"
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+typedef struct snapshot_header {
+    char magic[8];
+    u32  version;
+    u32  byte_order;     /* Reads back swapped on a host of the other order */
+    u64  file_size;
+    u64  section_count;
+    u64  table_offset;
+    u64  reserved[3];
+} snapshot_header_t;
+
+typedef struct snapshot_section {
+    u32 kind;
+    u32 flags;
+    u64 id;
+    u64 offset;
+    u64 size;
+} snapshot_section_t;
+
+_Static_assert(sizeof(snapshot_header_t) == 64, "snapshot header layout");
+_Static_assert(sizeof(snapshot_section_t) == 32, "snapshot section layout");
+
+#define INDEX_HEADER_SIZE (4 * sizeof(u64))
+
+CAUCHY_INLINE u64 align8(u64 n) {
+    return (n + 7) & ~(u64)7;
+}
+
+/* ============================================================
+ * Writer
+ * ============================================================ */
+
+struct cauchy_snapshot_writer {
+    FILE*               file;
+    char*               path;
+    char*               tmp_path;
+    u64                 offset;         /* File position */
+    snapshot_section_t* sections;
+    usize               count;
+    usize               capacity;
+    bool                open;           /* A section is being written */
+    cauchy_result_t     error;          /* First failure; sticky */
+};
+
+static cauchy_result_t write_raw(cauchy_snapshot_writer_t* w, const void* data, usize size) {
+    if (w->error != CAUCHY_OK) return w->error;
+    if (size && fwrite(data, 1, size, w->file) != size) {
+        w->error = CAUCHY_ERR_IO;
+        return w->error;
+    }
+    w->offset += size;
+    return CAUCHY_OK;
+}
+
+static cauchy_result_t pad_raw(cauchy_snapshot_writer_t* w) {
+    static const u8 zeros[8];
+    return write_raw(w, zeros, align8(w->offset) - w->offset);
+}
+
+cauchy_snapshot_writer_t* cauchy_snapshot_writer_create(const char* path) {
+    if (!path) return NULL;
+    cauchy_snapshot_writer_t* w = calloc(1, sizeof(*w));
+    if (!w) return NULL;
+
+    usize len = strlen(path);
+    w->path = malloc(len + 1);
+    w->tmp_path = malloc(len + 5);
+    if (!w->path || !w->tmp_path) goto fail;
+    memcpy(w->path, path, len + 1);
+    memcpy(w->tmp_path, path, len);
+    memcpy(w->tmp_path + len, ".tmp", 5);
+
+    w->file = fopen(w->tmp_path, "wb");
+    if (!w->file) goto fail;
+
+    /* The real header goes in on commit */
+    snapshot_header_t blank;
+    memset(&blank, 0, sizeof(blank));
+    if (write_raw(w, &blank, sizeof(blank)) != CAUCHY_OK) {
+        cauchy_snapshot_writer_abort(w);
+        return NULL;
+    }
+    return w;
+
+fail:
+    free(w->path);
+    free(w->tmp_path);
+    free(w);
+    return NULL;
+}
+
+cauchy_result_t cauchy_snapshot_writer_begin(cauchy_snapshot_writer_t* w,
+                                             cauchy_snapshot_kind_t kind, u64 id) {
+    if (!w || w->open) return CAUCHY_ERR_INVALID;
+    if (w->error != CAUCHY_OK) return w->error;
+    for (usize i = 0; i < w->count; i++) {
+        if (w->sections[i].kind == (u32)kind && w->sections[i].id == id) return CAUCHY_ERR_EXISTS;
+    }
+    if (w->count == w->capacity) {
+        usize cap = w->capacity ? w->capacity * 2 : 16;
+        snapshot_section_t* grown = realloc(w->sections, cap * sizeof(*grown));
+        if (!grown) return CAUCHY_ERR_NOMEM;
+        w->sections = grown;
+        w->capacity = cap;
+    }
+    cauchy_result_t res = pad_raw(w);
+    if (res != CAUCHY_OK) return res;
+
+    snapshot_section_t* s = &w->sections[w->count++];
+    memset(s, 0, sizeof(*s));
+    s->kind = (u32)kind;
+    s->id = id;
+    s->offset = w->offset;
+    w->open = true;
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_snapshot_writer_put(cauchy_snapshot_writer_t* w,
+                                           const void* data, usize size) {
+    if (!w || !w->open || (size && !data)) return CAUCHY_ERR_INVALID;
+    return write_raw(w, data, size);
+}
+
+cauchy_result_t cauchy_snapshot_writer_put_u64(cauchy_snapshot_writer_t* w, u64 v) {
+    return cauchy_snapshot_writer_put(w, &v, sizeof(v));
+}
+
+cauchy_result_t cauchy_snapshot_writer_put_blob(cauchy_snapshot_writer_t* w,
+                                                const void* data, usize size) {
+    cauchy_result_t res = cauchy_snapshot_writer_put_u64(w, size);
+    if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put(w, data, size);
+    if (res == CAUCHY_OK) res = cauchy_snapshot_writer_align(w);
+    return res;
+}
+
+cauchy_result_t cauchy_snapshot_writer_put_vclock(cauchy_snapshot_writer_t* w,
+                                                  const cauchy_vclock_t* vc) {
+    if (!w || !vc) return CAUCHY_ERR_INVALID;
+    usize size = cauchy_vclock_serialized_size(vc);
+    u8* buf = malloc(size ? size : 1);
+    if (!buf) return CAUCHY_ERR_NOMEM;
+    cauchy_result_t res = cauchy_vclock_serialize(vc, buf, size) == size
+        ? cauchy_snapshot_writer_put_blob(w, buf, size) : CAUCHY_ERR_INTERNAL;
+    free(buf);
+    return res;
+}
+
+cauchy_result_t cauchy_snapshot_writer_align(cauchy_snapshot_writer_t* w) {
+    if (!w || !w->open) return CAUCHY_ERR_INVALID;
+    return pad_raw(w);
+}
+
+u64 cauchy_snapshot_writer_offset(const cauchy_snapshot_writer_t* w) {
+    if (!w || !w->open) return 0;
+    return w->offset - w->sections[w->count - 1].offset;
+}
+
+cauchy_result_t cauchy_snapshot_writer_end(cauchy_snapshot_writer_t* w) {
+    if (!w || !w->open) return CAUCHY_ERR_INVALID;
+    snapshot_section_t* s = &w->sections[w->count - 1];
+    s->size = w->offset - s->offset;
+    w->open = false;
+    return w->error;
+}
+
+cauchy_result_t cauchy_snapshot_writer_commit(cauchy_snapshot_writer_t* w) {
+    if (!w) return CAUCHY_ERR_INVALID;
+    if (w->open) {
+        cauchy_snapshot_writer_abort(w);
+        return CAUCHY_ERR_INVALID;
+    }
+
+    pad_raw(w);
+    snapshot_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = CAUCHY_SNAPSHOT_VERSION;
+    header.byte_order = SNAPSHOT_BYTE_ORDER;
+    header.section_count = w->count;
+    header.table_offset = w->offset;
+    write_raw(w, w->sections, w->count * sizeof(snapshot_section_t));
+    header.file_size = w->offset;
+
+    if (w->error == CAUCHY_OK &&
+        (fseek(w->file, 0, SEEK_SET) != 0 ||
+         fwrite(&header, sizeof(header), 1, w->file) != 1 ||
+         fflush(w->file) != 0 || fsync(fileno(w->file)) != 0)) {
+        w->error = CAUCHY_ERR_IO;
+    }
+    if (w->error != CAUCHY_OK) {
+        cauchy_result_t res = w->error;
+        cauchy_snapshot_writer_abort(w);
+        return res;
+    }
+
+    cauchy_result_t res = CAUCHY_OK;
+    if (fclose(w->file) != 0) res = CAUCHY_ERR_IO;
+    w->file = NULL;
+    if (res == CAUCHY_OK && rename(w->tmp_path, w->path) != 0) res = CAUCHY_ERR_IO;
+    if (res != CAUCHY_OK) remove(w->tmp_path);
+    free(w->sections);
+    free(w->path);
+    free(w->tmp_path);
+    free(w);
+    return res;
+}
+
+void cauchy_snapshot_writer_abort(cauchy_snapshot_writer_t* w) {
+    if (!w) return;
+    if (w->file) fclose(w->file);
+    remove(w->tmp_path);
+    free(w->sections);
+    free(w->path);
+    free(w->tmp_path);
+    free(w);
+}
+
+/* ============================================================
+ * Reader
+ * ============================================================ */
+
+struct cauchy_snapshot {
+    const u8*                 map;
+    usize                     size;
+    const snapshot_section_t* table;
+    usize                     count;
+    cauchy_atomic_u32_t       refs;
+};
+
+static bool header_valid(const u8* map, usize size) {
+    if (size < sizeof(snapshot_header_t)) return false;
+    const snapshot_header_t* h = (const snapshot_header_t*)map;
+    if (memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(h->magic)) != 0) return false;
+    if (h->byte_order != SNAPSHOT_BYTE_ORDER || h->version != CAUCHY_SNAPSHOT_VERSION) return false;
+    if (h->file_size != size || h->table_offset % 8 != 0) return false;
+    if (h->table_offset < sizeof(*h) || h->table_offset > size) return false;
+    if (h->section_count > (size - h->table_offset) / sizeof(snapshot_section_t)) return false;
+
+    const snapshot_section_t* table = (const snapshot_section_t*)(map + h->table_offset);
+    for (u64 i = 0; i < h->section_count; i++) {
+        const snapshot_section_t* s = &table[i];
+        if (s->offset % 8 != 0 || s->offset < sizeof(*h)) return false;
+        if (s->offset > h->table_offset || s->size > h->table_offset - s->offset) return false;
+    }
+    return true;
+}
+
+cauchy_result_t cauchy_snapshot_open(const char* path, cauchy_snapshot_t** out) {
+    if (!path || !out) return CAUCHY_ERR_INVALID;
+    *out = NULL;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return CAUCHY_ERR_IO;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return CAUCHY_ERR_IO;
+    }
+    usize size = (usize)st.st_size;
+    if (size < sizeof(snapshot_header_t)) {
+        close(fd);
+        return CAUCHY_ERR_INVALID;
+    }
+
+    /* Private and read-only: pages are shared with the page cache and
+     * faulted in by the queries that reach them */
+    void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return CAUCHY_ERR_IO;
+
+    if (!header_valid(map, size)) {
+        munmap(map, size);
+        return CAUCHY_ERR_INVALID;
+    }
+    cauchy_snapshot_t* snap = malloc(sizeof(*snap));
+    if (!snap) {
+        munmap(map, size);
+        return CAUCHY_ERR_NOMEM;
+    }
+    const snapshot_header_t* h = map;
+    snap->map = map;
+    snap->size = size;
+    snap->table = (const snapshot_section_t*)((const u8*)map + h->table_offset);
+    snap->count = (usize)h->section_count;
+    atomic_init(&snap->refs, 1);
+    *out = snap;
+    return CAUCHY_OK;
+}
+
+cauchy_snapshot_t* cauchy_snapshot_retain(cauchy_snapshot_t* snap) {
+    if (snap) cauchy_atomic_fetch_add_u32(&snap->refs, 1);
+    return snap;
+}
+
+void cauchy_snapshot_release(cauchy_snapshot_t* snap) {
+    if (!snap || cauchy_atomic_fetch_sub_u32(&snap->refs, 1) != 1) return;
+    munmap((void*)snap->map, snap->size);
+    free(snap);
+}
+
+cauchy_result_t cauchy_snapshot_find(const cauchy_snapshot_t* snap,
+                                     cauchy_snapshot_kind_t kind, u64 id,
+                                     const u8** data, usize* size) {
+    if (!snap || !data || !size) return CAUCHY_ERR_INVALID;
+    for (usize i = 0; i < snap->count; i++) {
+        const snapshot_section_t* s = &snap->table[i];
+        if (s->kind == (u32)kind && s->id == id) {
+            *data = snap->map + s->offset;
+            *size = (usize)s->size;
+            return CAUCHY_OK;
+        }
+    }
+    return CAUCHY_ERR_NOTFOUND;
+}
+
+usize cauchy_snapshot_section_count(const cauchy_snapshot_t* snap) {
+    return snap ? snap->count : 0;
+}
+
+cauchy_result_t cauchy_snapshot_section_at(const cauchy_snapshot_t* snap, usize i,
+                                           cauchy_snapshot_kind_t* kind, u64* id) {
+    if (!snap || i >= snap->count) return CAUCHY_ERR_INVALID;
+    if (kind) *kind = (cauchy_snapshot_kind_t)snap->table[i].kind;
+    if (id) *id = snap->table[i].id;
+    return CAUCHY_OK;
+}
+
+bool cauchy_snapshot_get_u64(cauchy_snapshot_cursor_t* cur, u64* v) {
+    if (!cur || cur->left < sizeof(u64)) return false;
+    memcpy(v, cur->pos, sizeof(u64));
+    cur->pos += sizeof(u64);
+    cur->left -= sizeof(u64);
+    return true;
+}
+
+bool cauchy_snapshot_get_blob(cauchy_snapshot_cursor_t* cur, const u8** data, usize* size) {
+    if (!cur || cur->left < sizeof(u64)) return false;
+    u64 n;
+    memcpy(&n, cur->pos, sizeof(u64));
+    if (n > cur->left - sizeof(u64)) return false;
+    u64 padded = align8(n);
+    if (padded > cur->left - sizeof(u64)) padded = cur->left - sizeof(u64);
+    *data = cur->pos + sizeof(u64);
+    *size = (usize)n;
+    cur->pos += sizeof(u64) + padded;
+    cur->left -= sizeof(u64) + (usize)padded;
+    return true;
+}
+
+bool cauchy_snapshot_get_vclock(cauchy_snapshot_cursor_t* cur, cauchy_vclock_t* vc) {
+    cauchy_snapshot_cursor_t save = *cur;
+    const u8* data;
+    usize size;
+    if (!cauchy_snapshot_get_blob(cur, &data, &size) ||
+        cauchy_vclock_peek_serialized_size(data, size) != size ||
+        cauchy_vclock_deserialize(vc, data, size) != CAUCHY_OK) {
+        *cur = save;
+        return false;
+    }
+    return true;
+}
+
+/* ============================================================
+ * Frozen Index
+ * ============================================================ */
+
+cauchy_result_t cauchy_snapshot_index_parse(cauchy_snapshot_index_t* index,
+                                            const u8* data, usize size) {
+    if (!index || !data || size < INDEX_HEADER_SIZE || (uintptr_t)data % 8 != 0) {
+        return CAUCHY_ERR_INVALID;
+    }
+    const u64* h = (const u64*)data;
+    u64 capacity = h[0];
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) return CAUCHY_ERR_INVALID;
+    if (capacity > (size - INDEX_HEADER_SIZE) / (2 * sizeof(u64))) return CAUCHY_ERR_INVALID;
+    if (h[1] > capacity || (h[2] & 1) == 0) return CAUCHY_ERR_INVALID;
+    if (h[3] != 64 - (u64)__builtin_ctzll(capacity)) return CAUCHY_ERR_INVALID;
+
+    index->base = data;
+    index->size = size;
+    index->slots = h + 4;
+    index->capacity = capacity;
+    index->count = h[1];
+    index->multiplier = h[2];
+    index->shift = (u32)h[3];
+    return CAUCHY_OK;
+}
+
+const u8* cauchy_snapshot_index_at(const cauchy_snapshot_index_t* index, u64 slot) {
+    if (!index || slot >= index->capacity) return NULL;
+    if (index->slots[2 * slot] == CAUCHY_HTABLE_EMPTY) return NULL;
+    u64 off = index->slots[2 * slot + 1];
+    u64 records = INDEX_HEADER_SIZE + index->capacity * 2 * sizeof(u64);
+    if (off < records || off >= index->size || off % 8 != 0) return NULL;
+    return index->base + off;
+}
+
+void cauchy_snapshot_probe_init(cauchy_snapshot_probe_t* probe,
+                                const cauchy_snapshot_index_t* index, u64 hash) {
+    probe->index = index;
+    probe->hash = cauchy_htable_slot_hash(hash);
+    probe->steps = 0;
+    probe->slot = index && index->capacity
+        ? (probe->hash * index->multiplier) >> index->shift : 0;
+}
+
+const u8* cauchy_snapshot_probe_next(cauchy_snapshot_probe_t* probe, u64* slot) {
+    const cauchy_snapshot_index_t* index = probe->index;
+    if (!index) return NULL;
+    while (probe->steps < index->capacity) {
+        u64 i = probe->slot;
+        u64 hash = index->slots[2 * i];
+        if (hash == CAUCHY_HTABLE_EMPTY) break;
+        probe->slot = (i + 1) & (index->capacity - 1);
+        probe->steps++;
+        if (hash != probe->hash) continue;
+        const u8* rec = cauchy_snapshot_index_at(index, i);
+        if (!rec) continue;
+        if (slot) *slot = i;
+        return rec;
+    }
+    probe->steps = index->capacity;
+    return NULL;
+}
+
+/* Fixed odd multiplier: the file carries it, so any value works */
+#define INDEX_MULTIPLIER 0x9E3779B97F4A7C15ULL
+
+cauchy_result_t cauchy_snapshot_index_builder_init(cauchy_snapshot_index_builder_t* b,
+                                                   usize count) {
+    if (!b) return CAUCHY_ERR_INVALID;
+    u64 capacity = 8;
+    while (capacity < (u64)count * 2) capacity <<= 1;
+    b->slots = calloc(capacity * 2, sizeof(u64));
+    if (!b->slots) return CAUCHY_ERR_NOMEM;
+    b->capacity = capacity;
+    b->count = 0;
+    b->multiplier = INDEX_MULTIPLIER;
+    b->shift = 64 - (u32)__builtin_ctzll(capacity);
+    b->next_offset = INDEX_HEADER_SIZE + capacity * 2 * sizeof(u64);
+    return CAUCHY_OK;
+}
+
+void cauchy_snapshot_index_builder_fini(cauchy_snapshot_index_builder_t* b) {
+    if (!b) return;
+    free(b->slots);
+    b->slots = NULL;
+}
+
+void cauchy_snapshot_index_builder_place(cauchy_snapshot_index_builder_t* b,
+                                         u64 hash, usize record_size) {
+    u64 h = cauchy_htable_slot_hash(hash);
+    u64 i = (h * b->multiplier) >> b->shift;
+    while (b->slots[2 * i] != CAUCHY_HTABLE_EMPTY) i = (i + 1) & (b->capacity - 1);
+    b->slots[2 * i] = h;
+    b->slots[2 * i + 1] = b->next_offset;
+    b->next_offset += align8(record_size);
+    b->count++;
+}
+
+cauchy_result_t cauchy_snapshot_index_builder_write(const cauchy_snapshot_index_builder_t* b,
+                                                    cauchy_snapshot_writer_t* w) {
+    if (!b || !w) return CAUCHY_ERR_INVALID;
+    u64 header[4] = { b->capacity, b->count, b->multiplier, b->shift };
+    cauchy_result_t res = cauchy_snapshot_writer_put(w, header, sizeof(header));
+    if (res != CAUCHY_OK) return res;
+    return cauchy_snapshot_writer_put(w, b->slots, b->capacity * 2 * sizeof(u64));
+}
+
+/* ============================================================
+ * Shadow Bits
+ * ============================================================ */
+
+cauchy_result_t cauchy_snapshot_shadow_set(cauchy_snapshot_shadow_t* s, u64 slot) {
+    if (!s || slot >= s->capacity) return CAUCHY_ERR_INVALID;
+    if (!s->bits) {
+        s->bits = calloc((s->capacity + 63) / 64, sizeof(u64));
+        if (!s->bits) return CAUCHY_ERR_NOMEM;
+    }
+    s->bits[slot / 64] |= 1ULL << (slot % 64);
+    return CAUCHY_OK;
+}
+
+void cauchy_snapshot_shadow_fini(cauchy_snapshot_shadow_t* s) {
+    if (!s) return;
+    free(s->bits);
+    s->bits = NULL;
+}
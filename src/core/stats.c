@@ -0,0 +1,275 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Instrumentation Implementation
+ */
+
+#include "cauchy/stats.h"
+#include "cauchy/memory.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static const char* const stat_names[CAUCHY_STAT_COUNT] = {
+    "pool_cas_retries",
+    "hazard_retired",
+    "hazard_reclaimed",
+    "epoch_retired",
+    "epoch_reclaimed",
+};
+
+static const char* const hist_names[CAUCHY_HIST_COUNT] = {
+    "hazard_reclaim_ns",
+    "hazard_backlog",
+    "epoch_reclaim_ns",
+    "epoch_backlog",
+    "htable_chain",
+    "merge_items",
+    "merge_ns",
+};
+
+static const char* const crdt_names[CAUCHY_STAT_CRDT_COUNT] = {
+    "gset",
+    "2pset",
+    "orset",
+    "orswot",
+    "lww_map",
+};
+
+const char* cauchy_stat_name(cauchy_stat_t stat) {
+    return (unsigned)stat < CAUCHY_STAT_COUNT ? stat_names[stat] : "unknown";
+}
+
+const char* cauchy_stat_hist_name(cauchy_stat_hist_t hist) {
+    return (unsigned)hist < CAUCHY_HIST_COUNT ? hist_names[hist] : "unknown";
+}
+
+const char* cauchy_stat_crdt_name(cauchy_stat_crdt_t crdt) {
+    return (unsigned)crdt < CAUCHY_STAT_CRDT_COUNT ? crdt_names[crdt] : "unknown";
+}
+
+u64 cauchy_stats_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + (u64)ts.tv_nsec;
+}
+
+#ifdef CAUCHY_STATS
+
+typedef struct stats_hist {
+    cauchy_atomic_u64_t count;
+    cauchy_atomic_u64_t sum;
+    cauchy_atomic_u64_t max;
+    cauchy_atomic_u64_t buckets[CAUCHY_STATS_BUCKETS];
+} stats_hist_t;
+
+typedef struct stats_merge {
+    cauchy_atomic_u64_t merges;
+    cauchy_atomic_u64_t items;
+    cauchy_atomic_u64_t ns;
+    cauchy_atomic_u64_t entries;
+    cauchy_atomic_u64_t tombstones;
+} stats_merge_t;
+
+typedef struct CAUCHY_CACHE_ALIGNED stats_slot {
+    cauchy_atomic_u64_t counters[CAUCHY_STAT_COUNT];
+    stats_hist_t        hist[CAUCHY_HIST_COUNT];
+    stats_merge_t       merge[CAUCHY_STAT_CRDT_COUNT];
+} stats_slot_t;
+
+/* One slot per thread id, plus the shared overflow slot at the end */
+static stats_slot_t stats_slots[CAUCHY_MAX_THREADS + 1];
+
+#define OVERFLOW_SLOT (&stats_slots[CAUCHY_MAX_THREADS])
+
+static stats_slot_t* stats_slot(void) {
+    u32 tid = cauchy_thread_id();
+    return CAUCHY_LIKELY(tid < CAUCHY_MAX_THREADS) ? &stats_slots[tid] : OVERFLOW_SLOT;
+}
+
+/* Owner-only slots skip the RMW; the overflow slot cannot */
+static void slot_add(stats_slot_t* slot, cauchy_atomic_u64_t* counter, u64 n) {
+    if (CAUCHY_UNLIKELY(slot == OVERFLOW_SLOT)) {
+        atomic_fetch_add_explicit(counter, n, memory_order_relaxed);
+        return;
+    }
+    atomic_store_explicit(counter,
+        atomic_load_explicit(counter, memory_order_relaxed) + n,
+        memory_order_relaxed);
+}
+
+static void slot_max(stats_slot_t* slot, cauchy_atomic_u64_t* counter, u64 value) {
+    u64 cur = atomic_load_explicit(counter, memory_order_relaxed);
+    if (CAUCHY_UNLIKELY(slot == OVERFLOW_SLOT)) {
+        while (value > cur &&
+               !atomic_compare_exchange_weak_explicit(counter, &cur, value,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+        }
+        return;
+    }
+    if (value > cur) atomic_store_explicit(counter, value, memory_order_relaxed);
+}
+
+static u32 bucket_of(u64 value) {
+    u32 b = value ? 64 - (u32)__builtin_clzll(value) : 0;
+    return b < CAUCHY_STATS_BUCKETS ? b : CAUCHY_STATS_BUCKETS - 1;
+}
+
+void cauchy_stats_add(cauchy_stat_t stat, u64 n) {
+    if ((unsigned)stat >= CAUCHY_STAT_COUNT || n == 0) return;
+    stats_slot_t* slot = stats_slot();
+    slot_add(slot, &slot->counters[stat], n);
+}
+
+void cauchy_stats_record(cauchy_stat_hist_t hist, u64 value) {
+    if ((unsigned)hist >= CAUCHY_HIST_COUNT) return;
+    stats_slot_t* slot = stats_slot();
+    stats_hist_t* h = &slot->hist[hist];
+    slot_add(slot, &h->count, 1);
+    slot_add(slot, &h->sum, value);
+    slot_add(slot, &h->buckets[bucket_of(value)], 1);
+    slot_max(slot, &h->max, value);
+}
+
+void cauchy_stats_merge(cauchy_stat_crdt_t crdt, u64 items, u64 ns,
+                        u64 entries, u64 tombstones) {
+    if ((unsigned)crdt >= CAUCHY_STAT_CRDT_COUNT) return;
+    stats_slot_t* slot = stats_slot();
+    stats_merge_t* m = &slot->merge[crdt];
+    slot_add(slot, &m->merges, 1);
+    slot_add(slot, &m->items, items);
+    slot_add(slot, &m->ns, ns);
+    slot_add(slot, &m->entries, entries);
+    slot_add(slot, &m->tombstones, tombstones);
+    cauchy_stats_record(CAUCHY_HIST_MERGE_ITEMS, items);
+    cauchy_stats_record(CAUCHY_HIST_MERGE_NS, ns);
+}
+
+static u64 load(const cauchy_atomic_u64_t* counter) {
+    return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+void cauchy_stats_snapshot(cauchy_stats_t* out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    out->enabled = true;
+    for (u32 t = 0; t <= CAUCHY_MAX_THREADS; t++) {
+        const stats_slot_t* slot = &stats_slots[t];
+        for (u32 i = 0; i < CAUCHY_STAT_COUNT; i++) {
+            out->counters[i] += load(&slot->counters[i]);
+        }
+        for (u32 i = 0; i < CAUCHY_HIST_COUNT; i++) {
+            const stats_hist_t* h = &slot->hist[i];
+            cauchy_histogram_t* o = &out->hist[i];
+            o->count += load(&h->count);
+            o->sum += load(&h->sum);
+            u64 max = load(&h->max);
+            if (max > o->max) o->max = max;
+            for (u32 b = 0; b < CAUCHY_STATS_BUCKETS; b++) o->buckets[b] += load(&h->buckets[b]);
+        }
+        for (u32 i = 0; i < CAUCHY_STAT_CRDT_COUNT; i++) {
+            const stats_merge_t* m = &slot->merge[i];
+            cauchy_merge_stats_t* o = &out->merge[i];
+            o->merges += load(&m->merges);
+            o->items += load(&m->items);
+            o->ns += load(&m->ns);
+            o->entries += load(&m->entries);
+            o->tombstones += load(&m->tombstones);
+        }
+    }
+}
+
+#else /* !CAUCHY_STATS */
+
+void cauchy_stats_add(cauchy_stat_t stat, u64 n) {
+    (void)stat;
+    (void)n;
+}
+
+void cauchy_stats_record(cauchy_stat_hist_t hist, u64 value) {
+    (void)hist;
+    (void)value;
+}
+
+void cauchy_stats_merge(cauchy_stat_crdt_t crdt, u64 items, u64 ns,
+                        u64 entries, u64 tombstones) {
+    (void)crdt;
+    (void)items;
+    (void)ns;
+    (void)entries;
+    (void)tombstones;
+}
+
+void cauchy_stats_snapshot(cauchy_stats_t* out) {
+    if (out) memset(out, 0, sizeof(*out));
+}
+
+#endif /* CAUCHY_STATS */
+
+u64 cauchy_stats_percentile(const cauchy_histogram_t* hist, double p) {
+    if (!hist || hist->count == 0) return 0;
+    if (p < 0.0) p = 0.0;
+    if (p > 1.0) p = 1.0;
+    u64 rank = (u64)(p * (double)(hist->count - 1)) + 1;
+    u64 seen = 0;
+    for (u32 b = 0; b < CAUCHY_STATS_BUCKETS; b++) {
+        seen += hist->buckets[b];
+        if (seen >= rank) {
+            if (b == CAUCHY_STATS_BUCKETS - 1) return hist->max;
+            u64 upper = b ? (1ULL << b) - 1 : 0;
+            return upper < hist->max ? upper : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+double cauchy_stats_tombstone_ratio(const cauchy_merge_stats_t* merge) {
+    if (!merge || merge->entries == 0) return 0.0;
+    return (double)merge->tombstones / (double)merge->entries;
+}
+
+/* Append to buf, tracking the length the full text needs */
+static void emit(char* buf, usize size, usize* len, const char* fmt, ...) {
+    usize room = *len < size ? size - *len : 0;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(room ? buf + *len : NULL, room, fmt, ap);
+    va_end(ap);
+    if (n > 0) *len += (usize)n;
+}
+
+usize cauchy_stats_format(const cauchy_stats_t* stats, char* buf, usize size) {
+    if (!stats) return 0;
+    if (!buf) size = 0;
+    if (size) buf[0] = '\0';
+
+    usize len = 0;
+    for (u32 i = 0; i < CAUCHY_STAT_COUNT; i++) {
+        emit(buf, size, &len, "cauchy_%s %llu\n", stat_names[i],
+             (unsigned long long)stats->counters[i]);
+    }
+    for (u32 i = 0; i < CAUCHY_HIST_COUNT; i++) {
+        const cauchy_histogram_t* h = &stats->hist[i];
+        emit(buf, size, &len, "cauchy_%s_count %llu\ncauchy_%s_sum %llu\n"
+             "cauchy_%s_max %llu\ncauchy_%s_p50 %llu\ncauchy_%s_p99 %llu\n",
+             hist_names[i], (unsigned long long)h->count,
+             hist_names[i], (unsigned long long)h->sum,
+             hist_names[i], (unsigned long long)h->max,
+             hist_names[i], (unsigned long long)cauchy_stats_percentile(h, 0.50),
+             hist_names[i], (unsigned long long)cauchy_stats_percentile(h, 0.99));
+    }
+    for (u32 i = 0; i < CAUCHY_STAT_CRDT_COUNT; i++) {
+        const cauchy_merge_stats_t* m = &stats->merge[i];
+        const char* c = crdt_names[i];
+        emit(buf, size, &len, "cauchy_crdt_merges{crdt=\"%s\"} %llu\n"
+             "cauchy_crdt_merge_items{crdt=\"%s\"} %llu\n"
+             "cauchy_crdt_merge_ns{crdt=\"%s\"} %llu\n"
+             "cauchy_crdt_entries{crdt=\"%s\"} %llu\n"
+             "cauchy_crdt_tombstones{crdt=\"%s\"} %llu\n",
+             c, (unsigned long long)m->merges, c, (unsigned long long)m->items,
+             c, (unsigned long long)m->ns, c, (unsigned long long)m->entries,
+             c, (unsigned long long)m->tombstones);
+    }
+    return len;
+}
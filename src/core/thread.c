@@ -0,0 +1,73 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Thread Registry Implementation
+ *
+ * Hands out dense thread ids so per-thread state can live in flat arrays
+ * indexed by id instead of behind a shared cache line.
+ */
+
+#include "cauchy/memory.h"
+#include <pthread.h>
+
+#define THREAD_SLOT_WORDS (CAUCHY_MAX_THREADS / 64)
+
+_Static_assert(CAUCHY_MAX_THREADS % 64 == 0,
+               "CAUCHY_MAX_THREADS must be a multiple of 64");
+
+static cauchy_atomic_u64_t thread_slots[THREAD_SLOT_WORDS];
+static cauchy_atomic_u64_t thread_generation[CAUCHY_MAX_THREADS];  /* Odd while live */
+static pthread_key_t thread_key;
+static pthread_once_t thread_key_once = PTHREAD_ONCE_INIT;
+static _Thread_local u32 tls_thread_id = CAUCHY_THREAD_ID_INVALID;
+static _Thread_local u64 tls_thread_generation = 0;
+
+static void thread_slot_release(void* value) {
+    u32 id = (u32)((uintptr_t)value - 1);
+    tls_thread_id = CAUCHY_THREAD_ID_INVALID;
+    cauchy_atomic_fetch_add_u64(&thread_generation[id], 1);
+    cauchy_atomic_fetch_and_u64(&thread_slots[id / 64], ~(1ULL << (id % 64)));
+}
+
+static void thread_key_create(void) {
+    pthread_key_create(&thread_key, thread_slot_release);
+}
+
+static u32 thread_slot_acquire(void) {
+    for (u32 w = 0; w < THREAD_SLOT_WORDS; w++) {
+        u64 bits = cauchy_atomic_load_u64(&thread_slots[w]);
+        while (~bits) {
+            u32 bit = (u32)__builtin_ctzll(~bits);
+            if (cauchy_atomic_cas_u64(&thread_slots[w], &bits, bits | (1ULL << bit))) {
+                return w * 64 + bit;
+            }
+        }
+    }
+    return CAUCHY_THREAD_ID_INVALID;
+}
+
+u32 cauchy_thread_id(void) {
+    if (CAUCHY_LIKELY(tls_thread_id != CAUCHY_THREAD_ID_INVALID)) {
+        return tls_thread_id;
+    }
+
+    pthread_once(&thread_key_once, thread_key_create);
+
+    u32 id = thread_slot_acquire();
+    if (id == CAUCHY_THREAD_ID_INVALID) return id;
+
+    /* Destructor only runs for non-NULL values, hence the +1 bias */
+    pthread_setspecific(thread_key, (void*)((uintptr_t)id + 1));
+    tls_thread_generation = cauchy_atomic_fetch_add_u64(&thread_generation[id], 1) + 1;
+    tls_thread_id = id;
+    return id;
+}
+
+u64 cauchy_thread_generation(void) {
+    if (CAUCHY_UNLIKELY(cauchy_thread_id() == CAUCHY_THREAD_ID_INVALID)) return 0;
+    return tls_thread_generation;
+}
+
+bool cauchy_thread_alive(u32 id, u64 generation) {
+    if (id >= CAUCHY_MAX_THREADS) return false;
+    return cauchy_atomic_load_u64(&thread_generation[id]) == generation;
+}
@@ -19,6 +19,7 @@ const char* cauchy_result_str(cauchy_result_t result) {
         case CAUCHY_ERR_CAUSAL:     return "Causal dependency not satisfied";
         case CAUCHY_ERR_NETWORK:    return "Network error";
         case CAUCHY_ERR_INTERNAL:   return "Internal error";
+        case CAUCHY_ERR_IO:         return "I/O error";
         default:                    return "Unknown error";
     }
 }
@@ -4,14 +4,146 @@
  */
 
 #include "cauchy/vclock.h"
+#include "cauchy/simd.h"
+#include "cauchy/wire.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+/* Header bit marking the sparse wire encoding */
+#define VCLOCK_WIRE_SPARSE 0x80000000u
+
+/* Smallest dense array allocated */
+#define VCLOCK_DENSE_MIN 8
+
+static usize next_pow2(usize n) {
+    usize p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+CAUCHY_INLINE cauchy_vclock_pair_t* pairs_of(cauchy_vclock_t* vc) {
+    return vc->heap ? (cauchy_vclock_pair_t*)vc->heap : vc->inline_pairs;
+}
+
+CAUCHY_INLINE const cauchy_vclock_pair_t* cpairs_of(const cauchy_vclock_t* vc) {
+    return vc->heap ? (const cauchy_vclock_pair_t*)vc->heap : vc->inline_pairs;
+}
+
+CAUCHY_INLINE void note_node(cauchy_vclock_t* vc, cauchy_node_id_t node_id) {
+    if (node_id < UINT32_MAX && node_id + 1 > vc->num_nodes) {
+        vc->num_nodes = (u32)(node_id + 1);
+    }
+}
+
+/* First pair with node_id >= id */
+static u32 lower_bound(const cauchy_vclock_pair_t* pairs, u32 count, cauchy_node_id_t id) {
+    u32 lo = 0, hi = count;
+    while (lo < hi) {
+        u32 mid = lo + (hi - lo) / 2;
+        if (pairs[mid].node_id < id) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* Sparse clocks whose pairs fill at least half of their id range are
+ * cheaper dense: 8 bytes per slot against 16 per pair. */
+static bool worth_dense(cauchy_node_id_t max_id, usize nonzero) {
+    return max_id < CAUCHY_VCLOCK_DENSE_LIMIT && max_id + 1 <= 2 * nonzero;
+}
+
+static cauchy_result_t to_dense(cauchy_vclock_t* vc, usize min_slots) {
+    usize cap = next_pow2(min_slots < VCLOCK_DENSE_MIN ? VCLOCK_DENSE_MIN : min_slots);
+    u64* arr = cauchy_aligned_alloc(cap * sizeof(u64), CAUCHY_CACHE_LINE_SIZE);
+    if (!arr) return CAUCHY_ERR_NOMEM;
+    memset(arr, 0, cap * sizeof(u64));
+
+    const cauchy_vclock_pair_t* pairs = cpairs_of(vc);
+    for (u32 i = 0; i < vc->count; i++) arr[pairs[i].node_id] = pairs[i].value;
+
+    cauchy_aligned_free(vc->heap);
+    vc->heap = arr;
+    vc->dense = 1;
+    vc->count = 0;
+    vc->capacity = (u32)cap;
+    return CAUCHY_OK;
+}
+
+static cauchy_result_t dense_grow(cauchy_vclock_t* vc, usize min_slots) {
+    usize cap = next_pow2(min_slots);
+    u64* arr = cauchy_aligned_alloc(cap * sizeof(u64), CAUCHY_CACHE_LINE_SIZE);
+    if (!arr) return CAUCHY_ERR_NOMEM;
+    memcpy(arr, vc->heap, vc->capacity * sizeof(u64));
+    memset(arr + vc->capacity, 0, (cap - vc->capacity) * sizeof(u64));
+
+    cauchy_aligned_free(vc->heap);
+    vc->heap = arr;
+    vc->capacity = (u32)cap;
+    return CAUCHY_OK;
+}
+
+/* Make room for `need` sparse pairs */
+static cauchy_result_t sparse_reserve(cauchy_vclock_t* vc, usize need) {
+    if (need <= vc->capacity) return CAUCHY_OK;
+    usize cap = need > 2 * (usize)vc->capacity ? need : 2 * (usize)vc->capacity;
+    cauchy_vclock_pair_t* pairs = cauchy_aligned_alloc(
+        cap * sizeof(cauchy_vclock_pair_t), CAUCHY_CACHE_LINE_SIZE);
+    if (!pairs) return CAUCHY_ERR_NOMEM;
+    memcpy(pairs, pairs_of(vc), vc->count * sizeof(cauchy_vclock_pair_t));
+
+    cauchy_aligned_free(vc->heap);
+    vc->heap = pairs;
+    vc->capacity = (u32)cap;
+    return CAUCHY_OK;
+}
+
+/* Install a freshly built pair array (ownership moves to vc) */
+static void sparse_install(cauchy_vclock_t* vc, cauchy_vclock_pair_t* pairs,
+                           u32 count, u32 capacity) {
+    cauchy_aligned_free(vc->heap);
+    vc->dense = 0;
+    if (count <= CAUCHY_VCLOCK_INLINE_PAIRS) {
+        memcpy(vc->inline_pairs, pairs, count * sizeof(cauchy_vclock_pair_t));
+        cauchy_aligned_free(pairs);
+        vc->heap = NULL;
+        vc->capacity = CAUCHY_VCLOCK_INLINE_PAIRS;
+    } else {
+        vc->heap = pairs;
+        vc->capacity = capacity;
+    }
+    vc->count = count;
+}
+
+static cauchy_result_t to_sparse(cauchy_vclock_t* vc, usize extra) {
+    const u64* arr = vc->heap;
+    usize n = 0;
+    for (u32 i = 0; i < vc->capacity; i++) n += arr[i] != 0;
+
+    usize cap = next_pow2(n + extra);
+    cauchy_vclock_pair_t* pairs = cauchy_aligned_alloc(
+        cap * sizeof(cauchy_vclock_pair_t), CAUCHY_CACHE_LINE_SIZE);
+    if (!pairs) return CAUCHY_ERR_NOMEM;
+
+    u32 k = 0;
+    for (u32 i = 0; i < vc->capacity; i++) {
+        if (arr[i]) pairs[k++] = (cauchy_vclock_pair_t){ i, arr[i] };
+    }
+    sparse_install(vc, pairs, k, (u32)cap);
+    return CAUCHY_OK;
+}
+
 void cauchy_vclock_init(cauchy_vclock_t* vc, u32 num_nodes) {
     if (!vc) return;
-    memset(vc->entries, 0, sizeof(vc->entries));
-    vc->num_nodes = (num_nodes <= CAUCHY_MAX_NODES) ? num_nodes : CAUCHY_MAX_NODES;
+    memset(vc, 0, sizeof(cauchy_vclock_t));
+    vc->num_nodes = num_nodes;
+    vc->capacity = CAUCHY_VCLOCK_INLINE_PAIRS;
+}
+
+void cauchy_vclock_fini(cauchy_vclock_t* vc) {
+    if (!vc) return;
+    cauchy_aligned_free(vc->heap);
+    cauchy_vclock_init(vc, vc->num_nodes);
 }
 
 cauchy_vclock_t* cauchy_vclock_create(u32 num_nodes) {
@@ -23,68 +155,259 @@ cauchy_vclock_t* cauchy_vclock_create(u32 num_nodes) {
 }
 
 void cauchy_vclock_destroy(cauchy_vclock_t* vc) {
+    if (!vc) return;
+    cauchy_aligned_free(vc->heap);
     cauchy_aligned_free(vc);
 }
 
-void cauchy_vclock_copy(cauchy_vclock_t* dst, const cauchy_vclock_t* src) {
-    if (!dst || !src) return;
+cauchy_result_t cauchy_vclock_copy(cauchy_vclock_t* dst, const cauchy_vclock_t* src) {
+    if (!dst || !src) return CAUCHY_ERR_INVALID;
+    if (dst == src) return CAUCHY_OK;
     memcpy(dst, src, sizeof(cauchy_vclock_t));
+    if (!src->heap) return CAUCHY_OK;
+
+    usize bytes = src->dense ? src->capacity * sizeof(u64)
+                             : src->capacity * sizeof(cauchy_vclock_pair_t);
+    dst->heap = cauchy_aligned_alloc(bytes, CAUCHY_CACHE_LINE_SIZE);
+    if (!dst->heap) {
+        cauchy_vclock_init(dst, src->num_nodes);
+        return CAUCHY_ERR_NOMEM;
+    }
+    memcpy(dst->heap, src->heap, bytes);
+    return CAUCHY_OK;
 }
 
 cauchy_vclock_t* cauchy_vclock_clone(const cauchy_vclock_t* vc) {
     if (!vc) return NULL;
     cauchy_vclock_t* clone = cauchy_vclock_create(vc->num_nodes);
-    if (clone) {
-        cauchy_vclock_copy(clone, vc);
+    if (clone && cauchy_vclock_copy(clone, vc) != CAUCHY_OK) {
+        cauchy_vclock_destroy(clone);
+        clone = NULL;
     }
     return clone;
 }
 
-void cauchy_vclock_increment(cauchy_vclock_t* vc, cauchy_node_id_t node_id) {
-    if (!vc || node_id >= vc->num_nodes) return;
-    vc->entries[node_id]++;
+cauchy_result_t cauchy_vclock_set(cauchy_vclock_t* vc, cauchy_node_id_t node_id, u64 value) {
+    if (!vc) return CAUCHY_ERR_INVALID;
+
+    if (vc->dense) {
+        if (node_id < vc->capacity) {
+            ((u64*)vc->heap)[node_id] = value;
+            note_node(vc, node_id);
+            return CAUCHY_OK;
+        }
+        if (value == 0) return CAUCHY_OK;
+        cauchy_result_t res = (node_id < CAUCHY_VCLOCK_DENSE_LIMIT && node_id < 2 * (u64)vc->capacity)
+            ? dense_grow(vc, node_id + 1)
+            : to_sparse(vc, 1);
+        if (res != CAUCHY_OK) return res;
+        return cauchy_vclock_set(vc, node_id, value);
+    }
+
+    cauchy_vclock_pair_t* pairs = pairs_of(vc);
+    u32 pos = lower_bound(pairs, vc->count, node_id);
+    if (pos < vc->count && pairs[pos].node_id == node_id) {
+        if (value != 0) {
+            pairs[pos].value = value;
+        } else {
+            memmove(&pairs[pos], &pairs[pos + 1],
+                    (vc->count - pos - 1) * sizeof(cauchy_vclock_pair_t));
+            vc->count--;
+        }
+        return CAUCHY_OK;
+    }
+    if (value == 0) return CAUCHY_OK;
+
+    if (vc->count == vc->capacity) {
+        cauchy_node_id_t max_id = vc->count ? pairs[vc->count - 1].node_id : 0;
+        if (node_id > max_id) max_id = node_id;
+        if (worth_dense(max_id, vc->count + 1)) {
+            cauchy_result_t res = to_dense(vc, max_id + 1);
+            if (res != CAUCHY_OK) return res;
+            ((u64*)vc->heap)[node_id] = value;
+            note_node(vc, node_id);
+            return CAUCHY_OK;
+        }
+        cauchy_result_t res = sparse_reserve(vc, vc->count + 1);
+        if (res != CAUCHY_OK) return res;
+        pairs = pairs_of(vc);
+    }
+
+    memmove(&pairs[pos + 1], &pairs[pos], (vc->count - pos) * sizeof(cauchy_vclock_pair_t));
+    pairs[pos].node_id = node_id;
+    pairs[pos].value = value;
+    vc->count++;
+    note_node(vc, node_id);
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_vclock_increment(cauchy_vclock_t* vc, cauchy_node_id_t node_id) {
+    if (!vc) return CAUCHY_ERR_INVALID;
+    if (CAUCHY_LIKELY(vc->dense && node_id < vc->capacity)) {
+        ((u64*)vc->heap)[node_id]++;
+        note_node(vc, node_id);
+        return CAUCHY_OK;
+    }
+    return cauchy_vclock_set(vc, node_id, cauchy_vclock_get(vc, node_id) + 1);
 }
 
 u64 cauchy_vclock_get(const cauchy_vclock_t* vc, cauchy_node_id_t node_id) {
-    if (!vc || node_id >= vc->num_nodes) return 0;
-    return vc->entries[node_id];
+    if (!vc) return 0;
+    if (vc->dense) {
+        return node_id < vc->capacity ? ((const u64*)vc->heap)[node_id] : 0;
+    }
+    const cauchy_vclock_pair_t* pairs = cpairs_of(vc);
+    u32 pos = lower_bound(pairs, vc->count, node_id);
+    return (pos < vc->count && pairs[pos].node_id == node_id) ? pairs[pos].value : 0;
 }
 
-void cauchy_vclock_set(cauchy_vclock_t* vc, cauchy_node_id_t node_id, u64 value) {
-    if (!vc || node_id >= vc->num_nodes) return;
-    vc->entries[node_id] = value;
+void cauchy_vclock_iter_init(cauchy_vclock_iter_t* iter, const cauchy_vclock_t* vc) {
+    if (!iter) return;
+    iter->vc = vc;
+    iter->pos = 0;
 }
 
-void cauchy_vclock_merge(cauchy_vclock_t* dst, const cauchy_vclock_t* src) {
-    if (!dst || !src) return;
-    u32 max_nodes = (dst->num_nodes > src->num_nodes) ? dst->num_nodes : src->num_nodes;
-    for (u32 i = 0; i < max_nodes; i++) {
-        if (src->entries[i] > dst->entries[i]) {
-            dst->entries[i] = src->entries[i];
+bool cauchy_vclock_iter_next(cauchy_vclock_iter_t* iter,
+                             cauchy_node_id_t* node_id, u64* value) {
+    if (!iter || !iter->vc) return false;
+    const cauchy_vclock_t* vc = iter->vc;
+
+    if (vc->dense) {
+        const u64* arr = vc->heap;
+        while (iter->pos < vc->capacity) {
+            usize i = iter->pos++;
+            if (arr[i]) {
+                if (node_id) *node_id = i;
+                if (value) *value = arr[i];
+                return true;
+            }
         }
+        return false;
     }
-    if (src->num_nodes > dst->num_nodes) {
-        dst->num_nodes = src->num_nodes;
+
+    if (iter->pos >= vc->count) return false;
+    const cauchy_vclock_pair_t* p = &cpairs_of(vc)[iter->pos++];
+    if (node_id) *node_id = p->node_id;
+    if (value) *value = p->value;
+    return true;
+}
+
+static bool any_nonzero(const u64* arr, usize from, usize to) {
+    for (usize i = from; i < to; i++) {
+        if (arr[i]) return true;
     }
+    return false;
+}
+
+/* Merge of two sorted pair lists into a new array */
+static cauchy_result_t sparse_union(cauchy_vclock_t* dst, const cauchy_vclock_t* src) {
+    usize cap = next_pow2(dst->count + src->count);
+    cauchy_vclock_pair_t* out = cauchy_aligned_alloc(
+        cap * sizeof(cauchy_vclock_pair_t), CAUCHY_CACHE_LINE_SIZE);
+    if (!out) return CAUCHY_ERR_NOMEM;
+
+    const cauchy_vclock_pair_t* a = cpairs_of(dst);
+    const cauchy_vclock_pair_t* b = cpairs_of(src);
+    u32 i = 0, j = 0, k = 0;
+    while (i < dst->count && j < src->count) {
+        if (a[i].node_id < b[j].node_id) {
+            out[k++] = a[i++];
+        } else if (a[i].node_id > b[j].node_id) {
+            out[k++] = b[j++];
+        } else {
+            out[k] = a[i++];
+            if (b[j].value > out[k].value) out[k].value = b[j].value;
+            k++; j++;
+        }
+    }
+    while (i < dst->count) out[k++] = a[i++];
+    while (j < src->count) out[k++] = b[j++];
+
+    sparse_install(dst, out, k, (u32)cap);
+    if (k > CAUCHY_VCLOCK_INLINE_PAIRS && worth_dense(out[k - 1].node_id, k)) {
+        return to_dense(dst, out[k - 1].node_id + 1);
+    }
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_vclock_merge(cauchy_vclock_t* dst, const cauchy_vclock_t* src) {
+    if (!dst || !src) return CAUCHY_ERR_INVALID;
+    if (dst == src) return CAUCHY_OK;
+    if (src->num_nodes > dst->num_nodes) dst->num_nodes = src->num_nodes;
+
+    if (src->dense && !dst->dense) {
+        cauchy_node_id_t max_id = dst->count ? cpairs_of(dst)[dst->count - 1].node_id : 0;
+        if (max_id < CAUCHY_VCLOCK_DENSE_LIMIT) {
+            cauchy_result_t res = to_dense(dst, max_id + 1 > src->capacity ? max_id + 1 : src->capacity);
+            if (res != CAUCHY_OK) return res;
+        }
+    }
+
+    if (src->dense && dst->dense) {
+        if (dst->capacity < src->capacity) {
+            cauchy_result_t res = dense_grow(dst, src->capacity);
+            if (res != CAUCHY_OK) return res;
+        }
+        cauchy_simd_max_u64(dst->heap, src->heap, src->capacity);
+        return CAUCHY_OK;
+    }
+
+    if (!src->dense && !dst->dense) return sparse_union(dst, src);
+
+    /* One side dense, the other sparse: apply entry by entry */
+    cauchy_vclock_iter_t iter;
+    cauchy_vclock_iter_init(&iter, src);
+    cauchy_node_id_t id;
+    u64 v;
+    while (cauchy_vclock_iter_next(&iter, &id, &v)) {
+        if (v > cauchy_vclock_get(dst, id)) {
+            cauchy_result_t res = cauchy_vclock_set(dst, id, v);
+            if (res != CAUCHY_OK) return res;
+        }
+    }
+    return CAUCHY_OK;
 }
 
 cauchy_causality_t cauchy_vclock_compare(const cauchy_vclock_t* a, const cauchy_vclock_t* b) {
     if (!a || !b) return CAUCHY_CONCURRENT;
-    
-    bool a_less = false, a_greater = false;
-    u32 max_nodes = (a->num_nodes > b->num_nodes) ? a->num_nodes : b->num_nodes;
-    
-    for (u32 i = 0; i < max_nodes; i++) {
-        u64 av = (i < a->num_nodes) ? a->entries[i] : 0;
-        u64 bv = (i < b->num_nodes) ? b->entries[i] : 0;
-        if (av < bv) a_less = true;
-        if (av > bv) a_greater = true;
-    }
-    
-    if (!a_less && !a_greater) return CAUCHY_EQUAL;
-    if (a_less && !a_greater) return CAUCHY_HAPPENS_BEFORE;
-    if (!a_less && a_greater) return CAUCHY_HAPPENS_AFTER;
-    return CAUCHY_CONCURRENT;
+
+    u32 r = 0;
+    if (a->dense && b->dense) {
+        usize n = a->capacity < b->capacity ? a->capacity : b->capacity;
+        r = cauchy_simd_cmp_u64(a->heap, b->heap, n);
+        if (any_nonzero(a->heap, n, a->capacity)) r |= CAUCHY_SIMD_GREATER;
+        if (any_nonzero(b->heap, n, b->capacity)) r |= CAUCHY_SIMD_LESS;
+    } else {
+        /* Merge-join over the non-zero entries of both sides */
+        cauchy_vclock_iter_t ia, ib;
+        cauchy_vclock_iter_init(&ia, a);
+        cauchy_vclock_iter_init(&ib, b);
+        cauchy_node_id_t ida = 0, idb = 0;
+        u64 va = 0, vb = 0;
+        bool ha = cauchy_vclock_iter_next(&ia, &ida, &va);
+        bool hb = cauchy_vclock_iter_next(&ib, &idb, &vb);
+        while ((ha || hb) && r != (CAUCHY_SIMD_LESS | CAUCHY_SIMD_GREATER)) {
+            if (hb && (!ha || idb < ida)) {
+                r |= CAUCHY_SIMD_LESS;
+                hb = cauchy_vclock_iter_next(&ib, &idb, &vb);
+            } else if (ha && (!hb || ida < idb)) {
+                r |= CAUCHY_SIMD_GREATER;
+                ha = cauchy_vclock_iter_next(&ia, &ida, &va);
+            } else {
+                if (va < vb) r |= CAUCHY_SIMD_LESS;
+                if (va > vb) r |= CAUCHY_SIMD_GREATER;
+                ha = cauchy_vclock_iter_next(&ia, &ida, &va);
+                hb = cauchy_vclock_iter_next(&ib, &idb, &vb);
+            }
+        }
+    }
+
+    switch (r) {
+        case 0:                   return CAUCHY_EQUAL;
+        case CAUCHY_SIMD_LESS:    return CAUCHY_HAPPENS_BEFORE;
+        case CAUCHY_SIMD_GREATER: return CAUCHY_HAPPENS_AFTER;
+        default:                  return CAUCHY_CONCURRENT;
+    }
 }
 
 bool cauchy_vclock_happens_before(const cauchy_vclock_t* a, const cauchy_vclock_t* b) {
@@ -101,64 +424,421 @@ bool cauchy_vclock_equals(const cauchy_vclock_t* a, const cauchy_vclock_t* b) {
 
 bool cauchy_vclock_is_empty(const cauchy_vclock_t* vc) {
     if (!vc) return true;
-    for (u32 i = 0; i < vc->num_nodes; i++) {
-        if (vc->entries[i] != 0) return false;
-    }
-    return true;
+    if (vc->dense) return !any_nonzero(vc->heap, 0, vc->capacity);
+    return vc->count == 0;
+}
+
+bool cauchy_vclock_is_dense(const cauchy_vclock_t* vc) {
+    return vc && vc->dense;
 }
 
 u64 cauchy_vclock_sum(const cauchy_vclock_t* vc) {
     if (!vc) return 0;
+    if (vc->dense) return cauchy_simd_sum_u64(vc->heap, vc->capacity);
+
     u64 sum = 0;
-    for (u32 i = 0; i < vc->num_nodes; i++) {
-        sum += vc->entries[i];
-    }
+    const cauchy_vclock_pair_t* pairs = cpairs_of(vc);
+    for (u32 i = 0; i < vc->count; i++) sum += pairs[i].value;
     return sum;
 }
 
 void cauchy_vclock_min(cauchy_vclock_t* dst, const cauchy_vclock_t* src) {
-    if (!dst || !src) return;
-    for (u32 i = 0; i < dst->num_nodes && i < src->num_nodes; i++) {
-        if (src->entries[i] < dst->entries[i]) {
-            dst->entries[i] = src->entries[i];
+    if (!dst || !src || dst == src) return;
+
+    if (dst->dense) {
+        u64* arr = dst->heap;
+        if (src->dense) {
+            usize n = dst->capacity < src->capacity ? dst->capacity : src->capacity;
+            cauchy_simd_min_u64(arr, src->heap, n);
+            memset(arr + n, 0, (dst->capacity - n) * sizeof(u64));
+        } else {
+            for (u32 i = 0; i < dst->capacity; i++) {
+                if (arr[i]) {
+                    u64 w = cauchy_vclock_get(src, i);
+                    if (w < arr[i]) arr[i] = w;
+                }
+            }
         }
+        return;
+    }
+
+    /* Sparse: entries only survive where both sides are non-zero */
+    cauchy_vclock_pair_t* pairs = pairs_of(dst);
+    u32 k = 0;
+    for (u32 i = 0; i < dst->count; i++) {
+        u64 w = cauchy_vclock_get(src, pairs[i].node_id);
+        if (w == 0) continue;
+        pairs[k].node_id = pairs[i].node_id;
+        pairs[k].value = w < pairs[i].value ? w : pairs[i].value;
+        k++;
     }
+    dst->count = k;
+}
+
+u32 cauchy_vclock_prune(cauchy_vclock_t* vc, const cauchy_vclock_t* min_vc) {
+    if (!vc || !min_vc || vc == min_vc) return 0;
+    u32 pruned = 0;
+
+    if (vc->dense) {
+        u64* arr = vc->heap;
+        usize live = 0, max_id = 0;
+        for (u32 i = 0; i < vc->capacity; i++) {
+            if (!arr[i]) continue;
+            if (arr[i] <= cauchy_vclock_get(min_vc, i)) {
+                arr[i] = 0;
+                pruned++;
+            } else {
+                live++;
+                max_id = i;
+            }
+        }
+        /* Give the memory back once the survivors no longer justify slots;
+         * if that allocation fails the clock simply stays dense */
+        if (pruned && !worth_dense(max_id, live)) to_sparse(vc, 0);
+        return pruned;
+    }
+
+    cauchy_vclock_pair_t* pairs = pairs_of(vc);
+    u32 k = 0;
+    for (u32 i = 0; i < vc->count; i++) {
+        if (pairs[i].value <= cauchy_vclock_get(min_vc, pairs[i].node_id)) {
+            pruned++;
+            continue;
+        }
+        pairs[k++] = pairs[i];
+    }
+    vc->count = k;
+    return pruned;
+}
+
+/* Both encodings are computed from the entries alone, so equal clocks
+ * always produce identical bytes whatever their in-memory layout. */
+static usize dense_wire_size(const cauchy_vclock_t* vc, usize* span, usize* nonzero) {
+    cauchy_vclock_iter_t iter;
+    cauchy_vclock_iter_init(&iter, vc);
+    cauchy_node_id_t id, max_id = 0;
+    usize n = 0;
+    while (cauchy_vclock_iter_next(&iter, &id, NULL)) {
+        max_id = id;
+        n++;
+    }
+    *nonzero = n;
+    *span = n ? max_id + 1 : 0;
+    if (n && max_id >= CAUCHY_VCLOCK_DENSE_LIMIT) return SIZE_MAX;
+    return sizeof(u32) + *span * sizeof(u64);
+}
+
+CAUCHY_INLINE usize sparse_wire_size(usize nonzero) {
+    return 2 * sizeof(u32) + nonzero * 2 * sizeof(u64);
 }
 
 usize cauchy_vclock_serialized_size(const cauchy_vclock_t* vc) {
     if (!vc) return 0;
-    return sizeof(u32) + (vc->num_nodes * sizeof(u64));
+    usize span, n;
+    usize dense = dense_wire_size(vc, &span, &n);
+    usize sparse = sparse_wire_size(n);
+    return dense <= sparse ? dense : sparse;
 }
 
 usize cauchy_vclock_serialize(const cauchy_vclock_t* vc, u8* buffer, usize buffer_size) {
     if (!vc || !buffer) return 0;
-    usize needed = cauchy_vclock_serialized_size(vc);
+    usize span, n;
+    usize dense = dense_wire_size(vc, &span, &n);
+    usize sparse = sparse_wire_size(n);
+    usize needed = dense <= sparse ? dense : sparse;
     if (buffer_size < needed) return 0;
-    
-    memcpy(buffer, &vc->num_nodes, sizeof(u32));
-    memcpy(buffer + sizeof(u32), vc->entries, vc->num_nodes * sizeof(u64));
+
+    cauchy_vclock_iter_t iter;
+    cauchy_vclock_iter_init(&iter, vc);
+    cauchy_node_id_t id;
+    u64 v;
+
+    if (dense <= sparse) {
+        u32 hdr = (u32)span;
+        memcpy(buffer, &hdr, sizeof(u32));
+        memset(buffer + sizeof(u32), 0, span * sizeof(u64));
+        while (cauchy_vclock_iter_next(&iter, &id, &v)) {
+            memcpy(buffer + sizeof(u32) + id * sizeof(u64), &v, sizeof(u64));
+        }
+        return needed;
+    }
+
+    u32 hdr[2] = { VCLOCK_WIRE_SPARSE | (u32)n, vc->num_nodes };
+    memcpy(buffer, hdr, sizeof(hdr));
+    u8* p = buffer + sizeof(hdr);
+    while (cauchy_vclock_iter_next(&iter, &id, &v)) {
+        memcpy(p, &id, sizeof(u64));
+        memcpy(p + sizeof(u64), &v, sizeof(u64));
+        p += 2 * sizeof(u64);
+    }
     return needed;
 }
 
+usize cauchy_vclock_peek_serialized_size(const u8* buffer, usize buffer_size) {
+    if (!buffer || buffer_size < sizeof(u32)) return 0;
+    u32 hdr;
+    memcpy(&hdr, buffer, sizeof(u32));
+    usize needed = (hdr & VCLOCK_WIRE_SPARSE)
+        ? sparse_wire_size(hdr & ~VCLOCK_WIRE_SPARSE)
+        : sizeof(u32) + (usize)hdr * sizeof(u64);
+    return needed <= buffer_size ? needed : 0;
+}
+
 cauchy_result_t cauchy_vclock_deserialize(cauchy_vclock_t* vc, const u8* buffer, usize buffer_size) {
-    if (!vc || !buffer || buffer_size < sizeof(u32)) return CAUCHY_ERR_INVALID;
-    
+    if (!vc || !buffer) return CAUCHY_ERR_INVALID;
+    usize needed = cauchy_vclock_peek_serialized_size(buffer, buffer_size);
+    if (needed == 0) return CAUCHY_ERR_INVALID;
+
+    u32 hdr;
+    memcpy(&hdr, buffer, sizeof(u32));
+
+    if (!(hdr & VCLOCK_WIRE_SPARSE)) {
+        if (hdr > CAUCHY_VCLOCK_DENSE_LIMIT) return CAUCHY_ERR_INVALID;
+        cauchy_vclock_init(vc, hdr);
+        const u8* p = buffer + sizeof(u32);
+        for (u32 i = 0; i < hdr; i++) {
+            u64 v;
+            memcpy(&v, p + i * sizeof(u64), sizeof(u64));
+            if (v && cauchy_vclock_set(vc, i, v) != CAUCHY_OK) {
+                cauchy_vclock_fini(vc);
+                return CAUCHY_ERR_NOMEM;
+            }
+        }
+        vc->num_nodes = hdr;
+        return CAUCHY_OK;
+    }
+
+    u32 n = hdr & ~VCLOCK_WIRE_SPARSE;
     u32 num_nodes;
-    memcpy(&num_nodes, buffer, sizeof(u32));
-    if (num_nodes > CAUCHY_MAX_NODES) return CAUCHY_ERR_INVALID;
-    if (buffer_size < sizeof(u32) + num_nodes * sizeof(u64)) return CAUCHY_ERR_INVALID;
-    
+    memcpy(&num_nodes, buffer + sizeof(u32), sizeof(u32));
+
+    usize cap = n <= CAUCHY_VCLOCK_INLINE_PAIRS ? CAUCHY_VCLOCK_INLINE_PAIRS : next_pow2(n);
+    cauchy_vclock_pair_t* pairs = cauchy_aligned_alloc(
+        cap * sizeof(cauchy_vclock_pair_t), CAUCHY_CACHE_LINE_SIZE);
+    if (!pairs) return CAUCHY_ERR_NOMEM;
+
+    const u8* p = buffer + 2 * sizeof(u32);
+    for (u32 i = 0; i < n; i++, p += 2 * sizeof(u64)) {
+        memcpy(&pairs[i].node_id, p, sizeof(u64));
+        memcpy(&pairs[i].value, p + sizeof(u64), sizeof(u64));
+        if (pairs[i].value == 0 || (i > 0 && pairs[i].node_id <= pairs[i - 1].node_id)) {
+            cauchy_aligned_free(pairs);
+            return CAUCHY_ERR_INVALID;
+        }
+    }
+
     cauchy_vclock_init(vc, num_nodes);
-    memcpy(vc->entries, buffer + sizeof(u32), num_nodes * sizeof(u64));
+    sparse_install(vc, pairs, n, (u32)cap);
+    if (n > 0) note_node(vc, cpairs_of(vc)[n - 1].node_id);
+    if (n > CAUCHY_VCLOCK_INLINE_PAIRS && worth_dense(cpairs_of(vc)[n - 1].node_id, n)) {
+        cauchy_result_t res = to_dense(vc, cpairs_of(vc)[n - 1].node_id + 1);
+        if (res != CAUCHY_OK) {
+            cauchy_vclock_fini(vc);
+            return res;
+        }
+    }
+    return CAUCHY_OK;
+}
+
+/* Compact encoding: walk the union of vc and base in id order so each
+ * differing entry is visited once. Without a base every non-zero entry
+ * of vc is emitted. */
+typedef struct vclock_diff {
+    cauchy_vclock_iter_t cur, base;
+    bool has_cur, has_base;
+    cauchy_node_id_t cur_id, base_id;
+    u64 cur_v, base_v;
+} vclock_diff_t;
+
+static void diff_init(vclock_diff_t* d, const cauchy_vclock_t* vc, const cauchy_vclock_t* base) {
+    memset(d, 0, sizeof(*d));
+    cauchy_vclock_iter_init(&d->cur, vc);
+    d->has_cur = cauchy_vclock_iter_next(&d->cur, &d->cur_id, &d->cur_v);
+    d->has_base = false;
+    if (base) {
+        cauchy_vclock_iter_init(&d->base, base);
+        d->has_base = cauchy_vclock_iter_next(&d->base, &d->base_id, &d->base_v);
+    }
+}
+
+/* Next id whose value differs between vc and base */
+static bool diff_next(vclock_diff_t* d, cauchy_node_id_t* id, u64* cur, u64* base) {
+    while (d->has_cur || d->has_base) {
+        if (d->has_base && (!d->has_cur || d->base_id < d->cur_id)) {
+            *id = d->base_id;
+            *cur = 0;
+            *base = d->base_v;
+            d->has_base = cauchy_vclock_iter_next(&d->base, &d->base_id, &d->base_v);
+            return true;
+        }
+        *id = d->cur_id;
+        *cur = d->cur_v;
+        *base = 0;
+        if (d->has_base && d->base_id == d->cur_id) {
+            *base = d->base_v;
+            d->has_base = cauchy_vclock_iter_next(&d->base, &d->base_id, &d->base_v);
+        }
+        d->has_cur = cauchy_vclock_iter_next(&d->cur, &d->cur_id, &d->cur_v);
+        if (*cur != *base) return true;
+    }
+    return false;
+}
+
+/* Identifies the base a delta was taken against */
+static u32 vclock_fingerprint(const cauchy_vclock_t* vc) {
+    cauchy_vclock_iter_t iter;
+    cauchy_vclock_iter_init(&iter, vc);
+    cauchy_node_id_t id;
+    u64 v, h = 0xCBF29CE484222325ULL;
+    while (cauchy_vclock_iter_next(&iter, &id, &v)) {
+        h = (h ^ id) * 0x100000001B3ULL;
+        h = (h ^ v) * 0x100000001B3ULL;
+        h ^= h >> 29;
+    }
+    return (u32)(h ^ (h >> 32));
+}
+
+/* One pass of the encoder; with buffer == NULL it only measures. The
+ * caller has already checked that buffer_size covers the measured size. */
+static usize vclock_encode_pass(const cauchy_vclock_t* vc, const cauchy_vclock_t* base,
+                                u8* buffer, usize buffer_size, usize count) {
+    usize pos = 2 + (base ? sizeof(u32) : 0);
+    if (buffer) {
+        buffer[0] = CAUCHY_VCLOCK_WIRE_VERSION;
+        buffer[1] = base ? CAUCHY_VCLOCK_WIRE_DELTA : 0;
+        if (base) cauchy_wire_put_u32(buffer + 2, vclock_fingerprint(base));
+    }
+
+    u64 header[2] = { vc->num_nodes, count };
+    for (int i = 0; i < 2; i++) {
+        if (buffer) cauchy_varint_put(buffer, buffer_size, &pos, header[i]);
+        else pos += cauchy_varint_size(header[i]);
+    }
+
+    vclock_diff_t d;
+    diff_init(&d, vc, base);
+    cauchy_node_id_t id, prev = 0;
+    u64 cur, old;
+    bool first = true;
+    while (diff_next(&d, &id, &cur, &old)) {
+        u64 gap = first ? id : id - prev - 1;
+        u64 val = base ? cauchy_zigzag_encode((i64)(cur - old)) : cur;
+        if (buffer) {
+            cauchy_varint_put(buffer, buffer_size, &pos, gap);
+            cauchy_varint_put(buffer, buffer_size, &pos, val);
+        } else {
+            pos += cauchy_varint_size(gap) + cauchy_varint_size(val);
+        }
+        prev = id;
+        first = false;
+    }
+    return pos;
+}
+
+static usize vclock_diff_count(const cauchy_vclock_t* vc, const cauchy_vclock_t* base) {
+    vclock_diff_t d;
+    diff_init(&d, vc, base);
+    cauchy_node_id_t id;
+    u64 cur, old;
+    usize n = 0;
+    while (diff_next(&d, &id, &cur, &old)) n++;
+    return n;
+}
+
+usize cauchy_vclock_encoded_size(const cauchy_vclock_t* vc, const cauchy_vclock_t* base) {
+    if (!vc) return 0;
+    return vclock_encode_pass(vc, base, NULL, 0, vclock_diff_count(vc, base));
+}
+
+usize cauchy_vclock_encode(const cauchy_vclock_t* vc, const cauchy_vclock_t* base,
+                           u8* buffer, usize buffer_size) {
+    if (!vc || !buffer) return 0;
+    usize count = vclock_diff_count(vc, base);
+    usize needed = vclock_encode_pass(vc, base, NULL, 0, count);
+    if (buffer_size < needed) return 0;
+    return vclock_encode_pass(vc, base, buffer, buffer_size, count);
+}
+
+cauchy_result_t cauchy_vclock_decode(cauchy_vclock_t* vc, const cauchy_vclock_t* base,
+                                     const u8* buffer, usize buffer_size, usize* consumed) {
+    if (!vc || !buffer || buffer_size < 2) return CAUCHY_ERR_INVALID;
+    if (buffer[0] != CAUCHY_VCLOCK_WIRE_VERSION) return CAUCHY_ERR_INVALID;
+    u8 flags = buffer[1];
+    if (flags & ~CAUCHY_VCLOCK_WIRE_DELTA) return CAUCHY_ERR_INVALID;
+    bool delta = flags & CAUCHY_VCLOCK_WIRE_DELTA;
+
+    usize pos = 2;
+    if (delta) {
+        if (buffer_size < pos + sizeof(u32)) return CAUCHY_ERR_INVALID;
+        if (!base || cauchy_wire_get_u32(buffer + pos) != vclock_fingerprint(base)) {
+            return CAUCHY_ERR_CAUSAL;
+        }
+        pos += sizeof(u32);
+    }
+
+    u64 num_nodes, count;
+    if (!cauchy_varint_get(buffer, buffer_size, &pos, &num_nodes) ||
+        !cauchy_varint_get(buffer, buffer_size, &pos, &count) ||
+        num_nodes > UINT32_MAX) {
+        return CAUCHY_ERR_INVALID;
+    }
+
+    /* Decode into a scratch clock so vc may alias base */
+    cauchy_vclock_t out;
+    cauchy_result_t res = CAUCHY_OK;
+    if (delta) {
+        res = cauchy_vclock_copy(&out, base);
+        if (res != CAUCHY_OK) return res;
+    } else {
+        cauchy_vclock_init(&out, (u32)num_nodes);
+    }
+
+    cauchy_node_id_t id = 0;
+    for (u64 i = 0; i < count && res == CAUCHY_OK; i++) {
+        u64 gap, val;
+        if (!cauchy_varint_get(buffer, buffer_size, &pos, &gap) ||
+            !cauchy_varint_get(buffer, buffer_size, &pos, &val)) {
+            res = CAUCHY_ERR_INVALID;
+            break;
+        }
+        cauchy_node_id_t next = i == 0 ? gap : id + gap + 1;
+        if (i > 0 && next <= id) {
+            res = CAUCHY_ERR_INVALID;  /* Wrapped past the id space */
+            break;
+        }
+        id = next;
+        if (delta) {
+            val = cauchy_vclock_get(&out, id) + (u64)cauchy_zigzag_decode(val);
+        } else if (val == 0) {
+            res = CAUCHY_ERR_INVALID;  /* Zero entries are never encoded */
+            break;
+        }
+        res = cauchy_vclock_set(&out, id, val);
+    }
+    if (res != CAUCHY_OK) {
+        cauchy_vclock_fini(&out);
+        return res;
+    }
+
+    if (out.num_nodes < num_nodes) out.num_nodes = (u32)num_nodes;
+    if (vc == base) cauchy_vclock_fini(vc);
+    *vc = out;
+    if (consumed) *consumed = pos;
     return CAUCHY_OK;
 }
 
 void cauchy_vclock_debug_print(const cauchy_vclock_t* vc, const char* label) {
     if (!vc) { fprintf(stderr, "%s: (null)\n", label ? label : "vclock"); return; }
-    fprintf(stderr, "%s: [", label ? label : "vclock");
-    for (u32 i = 0; i < vc->num_nodes; i++) {
-        fprintf(stderr, "%llu%s", (unsigned long long)vc->entries[i], (i < vc->num_nodes - 1) ? "," : "");
+    fprintf(stderr, "%s: %s [", label ? label : "vclock", vc->dense ? "dense" : "sparse");
+    cauchy_vclock_iter_t iter;
+    cauchy_vclock_iter_init(&iter, vc);
+    cauchy_node_id_t id;
+    u64 v;
+    bool first = true;
+    while (cauchy_vclock_iter_next(&iter, &id, &v)) {
+        fprintf(stderr, "%s%llu:%llu", first ? "" : ",",
+                (unsigned long long)id, (unsigned long long)v);
+        first = false;
     }
     fprintf(stderr, "]\n");
 }
-
@@ -0,0 +1,450 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Write-Ahead Op Log Implementation
+ */
+
+#include "cauchy/wal.h"
+#include "cauchy/htable.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define WAL_MAGIC      "CAUCHYWL"
+#define WAL_BYTE_ORDER 0x01020304u
+
+typedef struct wal_header {
+    char magic[8];
+    u32  version;
+    u32  byte_order;
+} wal_header_t;
+
+typedef struct wal_record_header {
+    u64 checksum;
+    u32 size;
+    u16 kind;
+    u16 op;
+    u64 crdt_id;
+    u64 node;
+    u64 timestamp;
+} wal_record_header_t;
+
+_Static_assert(sizeof(wal_header_t) == 16, "wal header layout");
+_Static_assert(sizeof(wal_record_header_t) == 40, "wal record layout");
+
+/* The checksum covers everything after itself, up to the padding */
+#define CHECKSUM_SKIP sizeof(u64)
+
+CAUCHY_INLINE u64 align8(u64 n) {
+    return (n + 7) & ~(u64)7;
+}
+
+typedef struct wal_buffer {
+    u8*   data;
+    usize len;
+    usize capacity;
+} wal_buffer_t;
+
+struct cauchy_wal {
+    int                 fd;
+    cauchy_wal_config_t config;
+    pthread_mutex_t     lock;
+    pthread_cond_t      flushed;     /* A batch finished */
+    pthread_cond_t      filled;      /* pending reached max_batch_bytes */
+    wal_buffer_t        pending;     /* Appended, not yet handed to a leader */
+    wal_buffer_t        spare;       /* Swapped in when a leader takes pending */
+    u64                 end;         /* File offset of the next batch */
+    u64                 appended;
+    u64                 durable;
+    u64                 batches;
+    u64                 bytes;
+    bool                leader;      /* A thread is writing a batch */
+    cauchy_result_t     error;       /* First write failure; sticky */
+};
+
+static bool header_valid(const wal_header_t* h) {
+    return memcmp(h->magic, WAL_MAGIC, sizeof(h->magic)) == 0 &&
+           h->version == CAUCHY_WAL_VERSION && h->byte_order == WAL_BYTE_ORDER;
+}
+
+/* Length of the intact record at offset, 0 if it is torn or corrupt */
+static usize record_at(const u8* map, usize size, usize offset, wal_record_header_t* hdr) {
+    if (size - offset < sizeof(*hdr)) return 0;
+    memcpy(hdr, map + offset, sizeof(*hdr));
+    u64 len = align8(sizeof(*hdr) + (u64)hdr->size);
+    if (len > size - offset) return 0;
+    u64 sum = cauchy_hash_bytes(map + offset + CHECKSUM_SKIP,
+                                sizeof(*hdr) - CHECKSUM_SKIP + hdr->size);
+    return sum == hdr->checksum ? (usize)len : 0;
+}
+
+/* End of the last intact record */
+static usize valid_end(const u8* map, usize size) {
+    usize offset = sizeof(wal_header_t);
+    wal_record_header_t hdr;
+    usize len;
+    while ((len = record_at(map, size, offset, &hdr)) != 0) offset += len;
+    return offset;
+}
+
+static cauchy_result_t write_all(int fd, u64 offset, const u8* data, usize size) {
+    while (size) {
+        ssize_t n = pwrite(fd, data, size, (off_t)offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return CAUCHY_ERR_IO;
+        }
+        data += n;
+        size -= (usize)n;
+        offset += (u64)n;
+    }
+    return CAUCHY_OK;
+}
+
+static void header_init(wal_header_t* h) {
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, WAL_MAGIC, sizeof(h->magic));
+    h->version = CAUCHY_WAL_VERSION;
+    h->byte_order = WAL_BYTE_ORDER;
+}
+
+/* True if a file shorter than a header holds a prefix of one, i.e. the
+ * header write that created it was torn */
+static bool header_torn(int fd, usize size) {
+    wal_header_t h;
+    u8 buf[sizeof(h)];
+    header_init(&h);
+    usize got = 0;
+    while (got < size) {
+        ssize_t n = pread(fd, buf + got, size - got, (off_t)got);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        got += (usize)n;
+    }
+    return memcmp(buf, &h, size) == 0;
+}
+
+/* Make a newly created log's directory entry durable */
+static cauchy_result_t sync_parent(const char* path) {
+    const char* slash = strrchr(path, '/');
+    char* dir = slash ? strndup(path, slash == path ? 1 : (usize)(slash - path)) : strdup(".");
+    if (!dir) return CAUCHY_ERR_NOMEM;
+    int fd = open(dir, O_RDONLY | O_DIRECTORY);
+    free(dir);
+    if (fd < 0) return CAUCHY_ERR_IO;
+    cauchy_result_t res = fsync(fd) == 0 ? CAUCHY_OK : CAUCHY_ERR_IO;
+    close(fd);
+    return res;
+}
+
+/* Validate an existing log, or write the header of a new one (or of one
+ * whose header write was torn), and return the offset appends continue
+ * from. `created` is set when the header was written. */
+static cauchy_result_t prepare(int fd, u64* end, bool* created) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) return CAUCHY_ERR_IO;
+    usize size = (usize)st.st_size;
+    *created = false;
+
+    if (size < sizeof(wal_header_t)) {
+        if (size > 0 && !header_torn(fd, size)) return CAUCHY_ERR_INVALID;
+        wal_header_t h;
+        header_init(&h);
+        if (write_all(fd, 0, (const u8*)&h, sizeof(h)) != CAUCHY_OK ||
+            fdatasync(fd) != 0) {
+            return CAUCHY_ERR_IO;
+        }
+        *end = sizeof(h);
+        *created = true;
+        return CAUCHY_OK;
+    }
+
+    void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) return CAUCHY_ERR_IO;
+    cauchy_result_t res = CAUCHY_OK;
+    if (!header_valid(map)) {
+        res = CAUCHY_ERR_INVALID;
+    } else {
+        *end = valid_end(map, size);
+    }
+    munmap(map, size);
+    /* Drop a torn tail durably, or a later append could land past it */
+    if (res == CAUCHY_OK && *end < size &&
+        (ftruncate(fd, (off_t)*end) != 0 || fdatasync(fd) != 0)) {
+        res = CAUCHY_ERR_IO;
+    }
+    return res;
+}
+
+cauchy_wal_t* cauchy_wal_open(const char* path, const cauchy_wal_config_t* config) {
+    if (!path) return NULL;
+    cauchy_wal_t* wal = calloc(1, sizeof(*wal));
+    if (!wal) return NULL;
+
+    cauchy_wal_config_t defaults = CAUCHY_WAL_CONFIG_DEFAULT;
+    wal->config = config ? *config : defaults;
+    wal->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (wal->fd < 0) {
+        free(wal);
+        return NULL;
+    }
+    bool created;
+    if (prepare(wal->fd, &wal->end, &created) != CAUCHY_OK ||
+        (created && sync_parent(path) != CAUCHY_OK)) {
+        close(wal->fd);
+        free(wal);
+        return NULL;
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&wal->lock, NULL);
+    pthread_cond_init(&wal->flushed, NULL);
+    pthread_cond_init(&wal->filled, &attr);
+    pthread_condattr_destroy(&attr);
+    wal->error = CAUCHY_OK;
+    return wal;
+}
+
+cauchy_result_t cauchy_wal_close(cauchy_wal_t* wal) {
+    if (!wal) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_wal_sync(wal, 0);
+    if (close(wal->fd) != 0 && res == CAUCHY_OK) res = CAUCHY_ERR_IO;
+    pthread_mutex_destroy(&wal->lock);
+    pthread_cond_destroy(&wal->flushed);
+    pthread_cond_destroy(&wal->filled);
+    free(wal->pending.data);
+    free(wal->spare.data);
+    free(wal);
+    return res;
+}
+
+static bool buffer_reserve(wal_buffer_t* b, usize size) {
+    if (b->capacity - b->len >= size) return true;
+    usize capacity = b->capacity ? b->capacity : 4096;
+    while (capacity - b->len < size) capacity *= 2;
+    u8* data = realloc(b->data, capacity);
+    if (!data) return false;
+    b->data = data;
+    b->capacity = capacity;
+    return true;
+}
+
+cauchy_result_t cauchy_wal_append(cauchy_wal_t* wal, const cauchy_wal_record_t* rec,
+                                  u64* lsn) {
+    if (!wal || !rec) return CAUCHY_ERR_INVALID;
+    if ((!rec->data && rec->size) || rec->size > UINT32_MAX || (u32)rec->kind > UINT16_MAX) {
+        return CAUCHY_ERR_INVALID;
+    }
+
+    wal_record_header_t hdr = {
+        .size = (u32)rec->size,
+        .kind = (u16)rec->kind,
+        .op = rec->op,
+        .crdt_id = rec->crdt_id,
+        .node = rec->uid.node_id,
+        .timestamp = rec->uid.timestamp
+    };
+    usize len = (usize)align8(sizeof(hdr) + rec->size);
+
+    pthread_mutex_lock(&wal->lock);
+    cauchy_result_t res = wal->error;
+    if (res == CAUCHY_OK && !buffer_reserve(&wal->pending, len)) res = CAUCHY_ERR_NOMEM;
+    if (res != CAUCHY_OK) {
+        pthread_mutex_unlock(&wal->lock);
+        return res;
+    }
+
+    u8* out = wal->pending.data + wal->pending.len;
+    memcpy(out, &hdr, sizeof(hdr));
+    if (rec->size) memcpy(out + sizeof(hdr), rec->data, rec->size);
+    memset(out + sizeof(hdr) + rec->size, 0, len - sizeof(hdr) - rec->size);
+    hdr.checksum = cauchy_hash_bytes(out + CHECKSUM_SKIP, sizeof(hdr) - CHECKSUM_SKIP + rec->size);
+    memcpy(out, &hdr.checksum, sizeof(hdr.checksum));
+    wal->pending.len += len;
+
+    u64 seq = ++wal->appended;
+    if (wal->leader && wal->pending.len >= wal->config.max_batch_bytes) {
+        pthread_cond_signal(&wal->filled);
+    }
+    pthread_mutex_unlock(&wal->lock);
+
+    if (lsn) *lsn = seq;
+    return CAUCHY_OK;
+}
+
+/* Leader only: let more records join the batch, up to the configured
+ * delay or size */
+static void wait_for_batch(cauchy_wal_t* wal) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    u64 ns = (u64)deadline.tv_nsec + (u64)wal->config.max_delay_us * 1000;
+    deadline.tv_sec += (time_t)(ns / 1000000000ULL);
+    deadline.tv_nsec = (long)(ns % 1000000000ULL);
+
+    while (wal->pending.len < wal->config.max_batch_bytes) {
+        if (pthread_cond_timedwait(&wal->filled, &wal->lock, &deadline) == ETIMEDOUT) break;
+    }
+}
+
+cauchy_result_t cauchy_wal_sync(cauchy_wal_t* wal, u64 lsn) {
+    if (!wal) return CAUCHY_ERR_INVALID;
+
+    pthread_mutex_lock(&wal->lock);
+    if (lsn == 0 || lsn > wal->appended) lsn = wal->appended;
+
+    while (wal->durable < lsn && wal->error == CAUCHY_OK) {
+        if (wal->leader) {
+            pthread_cond_wait(&wal->flushed, &wal->lock);
+            continue;
+        }
+
+        wal->leader = true;
+        if (wal->config.max_delay_us) wait_for_batch(wal);
+
+        /* Take the batch; appends continue into the spare buffer */
+        wal_buffer_t batch = wal->pending;
+        wal->pending = wal->spare;
+        wal->spare = (wal_buffer_t){ 0 };
+        u64 target = wal->appended;
+        u64 offset = wal->end;
+        pthread_mutex_unlock(&wal->lock);
+
+        cauchy_result_t res = write_all(wal->fd, offset, batch.data, batch.len);
+        if (res == CAUCHY_OK && wal->config.sync && fdatasync(wal->fd) != 0) {
+            res = CAUCHY_ERR_IO;
+        }
+
+        pthread_mutex_lock(&wal->lock);
+        if (res == CAUCHY_OK) {
+            wal->end += batch.len;
+            wal->durable = target;
+            wal->batches++;
+            wal->bytes += batch.len;
+        } else {
+            wal->error = res;
+        }
+        batch.len = 0;
+        wal->spare = batch;
+        wal->leader = false;
+        pthread_cond_broadcast(&wal->flushed);
+    }
+
+    cauchy_result_t res = wal->durable >= lsn ? CAUCHY_OK : wal->error;
+    pthread_mutex_unlock(&wal->lock);
+    return res;
+}
+
+cauchy_result_t cauchy_wal_commit(cauchy_wal_t* wal, const cauchy_wal_record_t* rec) {
+    u64 lsn;
+    cauchy_result_t res = cauchy_wal_append(wal, rec, &lsn);
+    return res == CAUCHY_OK ? cauchy_wal_sync(wal, lsn) : res;
+}
+
+cauchy_result_t cauchy_wal_reset(cauchy_wal_t* wal) {
+    cauchy_result_t res = cauchy_wal_sync(wal, 0);
+    if (res != CAUCHY_OK) return res;
+
+    pthread_mutex_lock(&wal->lock);
+    if (ftruncate(wal->fd, (off_t)sizeof(wal_header_t)) != 0 || fdatasync(wal->fd) != 0) {
+        wal->error = CAUCHY_ERR_IO;
+        res = wal->error;
+    } else {
+        wal->end = sizeof(wal_header_t);
+    }
+    pthread_mutex_unlock(&wal->lock);
+    return res;
+}
+
+void cauchy_wal_get_stats(cauchy_wal_t* wal, cauchy_wal_stats_t* out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!wal) return;
+    pthread_mutex_lock(&wal->lock);
+    out->appended = wal->appended;
+    out->durable = wal->durable;
+    out->batches = wal->batches;
+    out->bytes = wal->bytes;
+    pthread_mutex_unlock(&wal->lock);
+}
+
+/* ============================================================
+ * Replay
+ * ============================================================ */
+
+static cauchy_result_t replay_map(const u8* map, usize size, cauchy_vclock_t* applied,
+                                  cauchy_wal_apply_fn fn, void* arg, usize* replayed) {
+    /* Skip against the restored clock only: records of one node may be
+     * logged out of uid order when several threads append */
+    cauchy_vclock_t base;
+    if (applied) {
+        cauchy_result_t res = cauchy_vclock_copy(&base, applied);
+        if (res != CAUCHY_OK) return res;
+    } else {
+        cauchy_vclock_init(&base, 0);
+    }
+
+    cauchy_result_t res = CAUCHY_OK;
+    usize offset = sizeof(wal_header_t);
+    wal_record_header_t hdr;
+    usize len;
+    while ((len = record_at(map, size, offset, &hdr)) != 0) {
+        const u8* payload = map + offset + sizeof(hdr);
+        offset += len;
+        if (hdr.timestamp <= cauchy_vclock_get(&base, hdr.node)) continue;
+
+        cauchy_wal_record_t rec = {
+            .kind = (cauchy_snapshot_kind_t)hdr.kind,
+            .op = hdr.op,
+            .crdt_id = hdr.crdt_id,
+            .uid = { .node_id = hdr.node, .timestamp = hdr.timestamp },
+            .data = payload,
+            .size = hdr.size
+        };
+        res = fn(arg, &rec);
+        if (res != CAUCHY_OK) break;
+        if (replayed) (*replayed)++;
+        if (applied && hdr.timestamp > cauchy_vclock_get(applied, hdr.node)) {
+            res = cauchy_vclock_set(applied, hdr.node, hdr.timestamp);
+            if (res != CAUCHY_OK) break;
+        }
+    }
+    cauchy_vclock_fini(&base);
+    return res;
+}
+
+cauchy_result_t cauchy_wal_replay(const char* path, cauchy_vclock_t* applied,
+                                  cauchy_wal_apply_fn fn, void* arg, usize* replayed) {
+    if (!path || !fn) return CAUCHY_ERR_INVALID;
+    if (replayed) *replayed = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return errno == ENOENT ? CAUCHY_OK : CAUCHY_ERR_IO;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return CAUCHY_ERR_IO;
+    }
+    usize size = (usize)st.st_size;
+    if (size < sizeof(wal_header_t)) {
+        bool torn = size == 0 || header_torn(fd, size);
+        close(fd);
+        return torn ? CAUCHY_OK : CAUCHY_ERR_INVALID;
+    }
+
+    void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return CAUCHY_ERR_IO;
+
+    cauchy_result_t res = header_valid(map)
+        ? replay_map(map, size, applied, fn, arg, replayed)
+        : CAUCHY_ERR_INVALID;
+    munmap(map, size);
+    return res;
+}
@@ -4,6 +4,7 @@
  */
 
 #include "cauchy/crdt/2p_set.h"
+#include "cauchy/stats.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -19,6 +20,9 @@ cauchy_result_t cauchy_2pset_init(cauchy_2pset_t* set, usize initial_capacity) {
         cauchy_gset_destroy(set->added);
         return CAUCHY_ERR_NOMEM;
     }
+    set->gc_cursor = 0;
+    set->covered = 0;
+    set->covered_fingerprint = 0;
     return CAUCHY_OK;
 }
 
@@ -39,6 +43,18 @@ void cauchy_2pset_destroy(cauchy_2pset_t* set) {
     free(set);
 }
 
+/* Add a tombstone. A new one covers the element's added copy, if any,
+ * until compaction drops it. */
+static cauchy_result_t tombstone(cauchy_2pset_t* set, const void* data, usize size, u64 h) {
+    if (cauchy_gset_contains_hashed(set->removed, data, size, h)) return CAUCHY_OK;
+    cauchy_result_t res = cauchy_gset_add_hashed(set->removed, data, size, h);
+    if (res == CAUCHY_OK && cauchy_gset_contains_hashed(set->added, data, size, h)) {
+        set->covered++;
+        set->covered_fingerprint += cauchy_merkle_item(h);
+    }
+    return res;
+}
+
 cauchy_result_t cauchy_2pset_add(cauchy_2pset_t* set, const void* data, usize size) {
     if (!set) return CAUCHY_ERR_INVALID;
     if (cauchy_gset_contains(set->removed, data, size)) {
@@ -49,10 +65,33 @@ cauchy_result_t cauchy_2pset_add(cauchy_2pset_t* set, const void* data, usize si
 
 cauchy_result_t cauchy_2pset_remove(cauchy_2pset_t* set, const void* data, usize size) {
     if (!set) return CAUCHY_ERR_INVALID;
-    if (!cauchy_gset_contains(set->added, data, size)) {
+    if (!cauchy_2pset_was_added(set, data, size)) {
         return CAUCHY_ERR_NOTFOUND;  /* Can only remove if added */
     }
-    return cauchy_gset_add(set->removed, data, size);
+    return tombstone(set, data, size, cauchy_hash_bytes(data, size));
+}
+
+cauchy_result_t cauchy_2pset_add_delta(cauchy_2pset_t* set, const void* data, usize size,
+                                       cauchy_2pset_t* delta) {
+    if (!set || !delta) return CAUCHY_ERR_INVALID;
+    if (cauchy_gset_contains(set->removed, data, size)) {
+        return CAUCHY_OK;  /* Can't re-add removed element */
+    }
+    return cauchy_gset_add_delta(set->added, data, size, delta->added);
+}
+
+cauchy_result_t cauchy_2pset_remove_delta(cauchy_2pset_t* set, const void* data, usize size,
+                                          cauchy_2pset_t* delta) {
+    if (!set || !delta) return CAUCHY_ERR_INVALID;
+    if (!cauchy_2pset_was_added(set, data, size)) {
+        return CAUCHY_ERR_NOTFOUND;  /* Can only remove if added */
+    }
+    /* The tombstone alone suffices: receivers keep it even without the add */
+    u64 h = cauchy_hash_bytes(data, size);
+    if (cauchy_gset_contains_hashed(set->removed, data, size, h)) return CAUCHY_OK;
+    cauchy_result_t res = tombstone(set, data, size, h);
+    if (res != CAUCHY_OK) return res;
+    return tombstone(delta, data, size, h);
 }
 
 bool cauchy_2pset_contains(const cauchy_2pset_t* set, const void* data, usize size) {
@@ -63,7 +102,8 @@ bool cauchy_2pset_contains(const cauchy_2pset_t* set, const void* data, usize si
 
 bool cauchy_2pset_was_added(const cauchy_2pset_t* set, const void* data, usize size) {
     if (!set) return false;
-    return cauchy_gset_contains(set->added, data, size);
+    return cauchy_gset_contains(set->added, data, size) ||
+           cauchy_gset_contains(set->removed, data, size);
 }
 
 bool cauchy_2pset_was_removed(const cauchy_2pset_t* set, const void* data, usize size) {
@@ -71,38 +111,257 @@ bool cauchy_2pset_was_removed(const cauchy_2pset_t* set, const void* data, usize
     return cauchy_gset_contains(set->removed, data, size);
 }
 
+/* Hash one chunk of a batch and start loading its slots in both halves */
+static usize batch_chunk(const cauchy_2pset_t* set, const cauchy_bytes_t* items, usize n,
+                         usize base, u64* hashes) {
+    usize m = n - base < CAUCHY_HTABLE_BATCH ? n - base : CAUCHY_HTABLE_BATCH;
+    cauchy_hash_batch(items + base, m, hashes);
+    for (usize i = 0; i < m; i++) {
+        cauchy_htable_prefetch(&set->added->index, hashes[i]);
+        cauchy_htable_prefetch(&set->removed->index, hashes[i]);
+    }
+    return m;
+}
+
+cauchy_result_t cauchy_2pset_add_batch(cauchy_2pset_t* set, const cauchy_bytes_t* items, usize n,
+                                       cauchy_result_t* results) {
+    if (!set || (n && !items)) return CAUCHY_ERR_INVALID;
+    cauchy_result_t first = CAUCHY_OK;
+    u64 hashes[CAUCHY_HTABLE_BATCH];
+    for (usize base = 0; base < n; base += CAUCHY_HTABLE_BATCH) {
+        usize m = batch_chunk(set, items, n, base, hashes);
+        for (usize i = 0; i < m; i++) {
+            const cauchy_bytes_t* it = &items[base + i];
+            cauchy_result_t res = CAUCHY_OK;
+            if (!cauchy_gset_contains_hashed(set->removed, it->data, it->size, hashes[i])) {
+                res = cauchy_gset_add_hashed(set->added, it->data, it->size, hashes[i]);
+            }
+            if (results) results[base + i] = res;
+            if (res != CAUCHY_OK && first == CAUCHY_OK) first = res;
+        }
+    }
+    return first;
+}
+
+cauchy_result_t cauchy_2pset_remove_batch(cauchy_2pset_t* set, const cauchy_bytes_t* items,
+                                          usize n, cauchy_result_t* results) {
+    if (!set || (n && !items)) return CAUCHY_ERR_INVALID;
+    cauchy_result_t first = CAUCHY_OK;
+    u64 hashes[CAUCHY_HTABLE_BATCH];
+    for (usize base = 0; base < n; base += CAUCHY_HTABLE_BATCH) {
+        usize m = batch_chunk(set, items, n, base, hashes);
+        for (usize i = 0; i < m; i++) {
+            const cauchy_bytes_t* it = &items[base + i];
+            cauchy_result_t res;
+            if (cauchy_gset_contains_hashed(set->added, it->data, it->size, hashes[i]) ||
+                cauchy_gset_contains_hashed(set->removed, it->data, it->size, hashes[i])) {
+                res = tombstone(set, it->data, it->size, hashes[i]);
+            } else {
+                res = it->data && it->size ? CAUCHY_ERR_NOTFOUND : CAUCHY_ERR_INVALID;
+            }
+            if (results) results[base + i] = res;
+            if (res != CAUCHY_OK && first == CAUCHY_OK) first = res;
+        }
+    }
+    return first;
+}
+
+usize cauchy_2pset_contains_batch(const cauchy_2pset_t* set, const cauchy_bytes_t* items, usize n,
+                                  bool* found) {
+    if (!set || (n && !items)) return 0;
+    usize hits = 0;
+    u64 hashes[CAUCHY_HTABLE_BATCH];
+    for (usize base = 0; base < n; base += CAUCHY_HTABLE_BATCH) {
+        usize m = batch_chunk(set, items, n, base, hashes);
+        for (usize i = 0; i < m; i++) {
+            const cauchy_bytes_t* it = &items[base + i];
+            bool hit = cauchy_gset_contains_hashed(set->added, it->data, it->size, hashes[i]) &&
+                       !cauchy_gset_contains_hashed(set->removed, it->data, it->size, hashes[i]);
+            if (found) found[base + i] = hit;
+            hits += hit;
+        }
+    }
+    return hits;
+}
+
 usize cauchy_2pset_count(const cauchy_2pset_t* set) {
-    if (!set) return 0;
-    usize count = 0;
+    return set ? cauchy_gset_count(set->added) - set->covered : 0;
+}
+
+bool cauchy_2pset_is_empty(const cauchy_2pset_t* set) {
+    return cauchy_2pset_count(set) == 0;
+}
+
+/* Tombstones first, so added copies they cover are never created. Both
+ * halves are copied directly rather than through cauchy_gset_merge so the
+ * join is accounted as one 2P-Set merge. */
+static cauchy_result_t join(cauchy_2pset_t* dst, const cauchy_2pset_t* src) {
+    u64 start = CAUCHY_STAT_NOW();
     cauchy_gset_iter_t iter;
-    cauchy_gset_iter_init(&iter, set->added);
+    cauchy_gset_iter_init(&iter, src->removed);
     const void* data;
     usize size;
     while (cauchy_gset_iter_next(&iter, &data, &size)) {
-        if (!cauchy_gset_contains(set->removed, data, size)) {
-            count++;
-        }
+        cauchy_result_t res = tombstone(dst, data, size, cauchy_hash_bytes(data, size));
+        if (res != CAUCHY_OK) return res;
     }
-    return count;
-}
 
-bool cauchy_2pset_is_empty(const cauchy_2pset_t* set) {
-    return cauchy_2pset_count(set) == 0;
+    cauchy_gset_iter_init(&iter, src->added);
+    while (cauchy_gset_iter_next(&iter, &data, &size)) {
+        if (cauchy_gset_contains(dst->removed, data, size)) continue;
+        cauchy_result_t res = cauchy_gset_add(dst->added, data, size);
+        if (res != CAUCHY_OK) return res;
+    }
+    CAUCHY_STAT_MERGE(CAUCHY_STAT_CRDT_2PSET,
+                      cauchy_gset_count(src->added) + cauchy_gset_count(src->removed),
+                      CAUCHY_STAT_NOW() - start,
+                      cauchy_gset_count(dst->added) + cauchy_gset_count(dst->removed),
+                      cauchy_gset_count(dst->removed));
+    return CAUCHY_OK;
 }
 
 cauchy_result_t cauchy_2pset_merge(cauchy_2pset_t* dst, const cauchy_2pset_t* src) {
     if (!dst || !src) return CAUCHY_ERR_INVALID;
-    
-    cauchy_result_t res = cauchy_gset_merge(dst->added, src->added);
-    if (res != CAUCHY_OK) return res;
-    
-    return cauchy_gset_merge(dst->removed, src->removed);
+    if (dst == src) return CAUCHY_OK;
+    return join(dst, src);
 }
 
+cauchy_result_t cauchy_2pset_merge_delta(cauchy_2pset_t* dst, const cauchy_2pset_t* delta) {
+    if (!dst || !delta) return CAUCHY_ERR_INVALID;
+    if (dst == delta) return CAUCHY_OK;
+    return join(dst, delta);
+}
+
+cauchy_result_t cauchy_2pset_merge_parallel(cauchy_2pset_t* dst, const cauchy_2pset_t* src,
+                                            u32 parts, const cauchy_executor_t* exec) {
+    if (!dst || !src) return CAUCHY_ERR_INVALID;
+    if (dst == src) return CAUCHY_OK;
+    cauchy_result_t res = cauchy_gset_merge_parallel(dst->removed, src->removed, parts, exec);
+    if (res == CAUCHY_OK) res = cauchy_gset_merge_parallel(dst->added, src->added, parts, exec);
+
+    /* Even after a failure, whatever was merged is counted */
+    dst->covered = 0;
+    dst->covered_fingerprint = 0;
+    cauchy_gset_iter_t iter;
+    cauchy_gset_iter_init(&iter, dst->removed);
+    const void* data;
+    usize size;
+    while (cauchy_gset_iter_next(&iter, &data, &size)) {
+        u64 h = cauchy_hash_bytes(data, size);
+        if (!cauchy_gset_contains_hashed(dst->added, data, size, h)) continue;
+        dst->covered++;
+        dst->covered_fingerprint += cauchy_merkle_item(h);
+    }
+    return res;
+}
+
+/* Symmetric check over one replica's live elements */
+static bool live_subset(const cauchy_2pset_t* a, const cauchy_2pset_t* b) {
+    cauchy_gset_iter_t iter;
+    cauchy_gset_iter_init(&iter, a->added);
+    const void* data;
+    usize size;
+    while (cauchy_gset_iter_next(&iter, &data, &size)) {
+        if (!cauchy_gset_contains(a->removed, data, size) &&
+            !cauchy_2pset_contains(b, data, size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+CAUCHY_INLINE u64 live_fingerprint(const cauchy_2pset_t* set) {
+    return cauchy_gset_fingerprint(set->added) - set->covered_fingerprint;
+}
+
+u64 cauchy_2pset_fingerprint(const cauchy_2pset_t* set) {
+    if (!set) return 0;
+    return live_fingerprint(set) ^ cauchy_merkle_mix(cauchy_gset_fingerprint(set->removed));
+}
+
+/* Equal tombstones and equal live elements; compaction may leave the
+ * added halves different */
 bool cauchy_2pset_equals(const cauchy_2pset_t* a, const cauchy_2pset_t* b) {
     if (!a || !b) return a == b;
-    return cauchy_gset_equals(a->added, b->added) &&
-           cauchy_gset_equals(a->removed, b->removed);
+    if (cauchy_2pset_count(a) != cauchy_2pset_count(b) ||
+        live_fingerprint(a) != live_fingerprint(b)) {
+        return false;
+    }
+    return cauchy_gset_equals(a->removed, b->removed) &&
+           live_subset(a, b) && live_subset(b, a);
+}
+
+usize cauchy_2pset_compact(cauchy_2pset_t* set, usize budget) {
+    if (!set) return 0;
+    if (budget == 0) set->gc_cursor = 0;
+    u64 before = cauchy_gset_fingerprint(set->added);
+    usize dropped = cauchy_gset_prune(set->added, set->removed, &set->gc_cursor, budget);
+    set->covered -= dropped;
+    set->covered_fingerprint -= before - cauchy_gset_fingerprint(set->added);
+    return dropped;
+}
+
+/* Section body: the added index, the removed index, the covered count
+ * and fingerprint, then the offset the removed index starts at */
+cauchy_result_t cauchy_2pset_snapshot_save(const cauchy_2pset_t* set,
+                                           cauchy_snapshot_writer_t* w, u64 id) {
+    if (!set || !w) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_snapshot_writer_begin(w, CAUCHY_SNAPSHOT_2P_SET, id);
+    if (res != CAUCHY_OK) return res;
+    res = cauchy_gset_snapshot_put(set->added, w);
+    u64 removed_at = cauchy_snapshot_writer_offset(w);
+    if (res == CAUCHY_OK) res = cauchy_gset_snapshot_put(set->removed, w);
+    if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put_u64(w, set->covered);
+    if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put_u64(w, set->covered_fingerprint);
+    if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put_u64(w, removed_at);
+    cauchy_result_t end = cauchy_snapshot_writer_end(w);
+    return res != CAUCHY_OK ? res : end;
+}
+
+/* The checks cauchy_gset_snapshot_attach makes, so that neither half is
+ * attached unless both will be. *count (if non-NULL) receives the
+ * elements indexed. */
+static cauchy_result_t half_check(const cauchy_gset_t* half, const u8* data, usize size,
+                                  u64* count) {
+    if (half->snapshot || half->views || cauchy_htable_count(&half->index)) {
+        return CAUCHY_ERR_EXISTS;
+    }
+    if (size < sizeof(u64)) return CAUCHY_ERR_INVALID;
+    cauchy_snapshot_index_t index;
+    cauchy_result_t res = cauchy_snapshot_index_parse(&index, data + sizeof(u64),
+                                                      size - sizeof(u64));
+    if (res == CAUCHY_OK && count) *count = index.count;
+    return res;
+}
+
+cauchy_result_t cauchy_2pset_snapshot_load(cauchy_2pset_t* set, cauchy_snapshot_t* snap, u64 id) {
+    if (!set) return CAUCHY_ERR_INVALID;
+    const u8* data;
+    usize size;
+    cauchy_result_t res = cauchy_snapshot_find(snap, CAUCHY_SNAPSHOT_2P_SET, id, &data, &size);
+    if (res != CAUCHY_OK) return res;
+    if (size < sizeof(u64) * 3) return CAUCHY_ERR_INVALID;
+
+    u64 tail[3];
+    memcpy(tail, data + size - sizeof(tail), sizeof(tail));
+    u64 removed_at = tail[2];
+    if (removed_at > size - sizeof(tail)) return CAUCHY_ERR_INVALID;
+    usize added_size = (usize)removed_at;
+    usize removed_size = size - sizeof(tail) - added_size;
+
+    u64 added_count;
+    res = half_check(set->added, data, added_size, &added_count);
+    if (res == CAUCHY_OK) res = half_check(set->removed, data + added_size, removed_size, NULL);
+    if (res != CAUCHY_OK) return res;
+    if (tail[0] > added_count) return CAUCHY_ERR_INVALID;
+
+    res = cauchy_gset_snapshot_attach(set->added, snap, data, added_size);
+    if (res == CAUCHY_OK) res = cauchy_gset_snapshot_attach(set->removed, snap,
+                                                             data + added_size, removed_size);
+    if (res != CAUCHY_OK) return res;
+    set->covered = (usize)tail[0];
+    set->covered_fingerprint = tail[1];
+    return CAUCHY_OK;
 }
 
 cauchy_result_t cauchy_2pset_add_string(cauchy_2pset_t* set, const char* str) {
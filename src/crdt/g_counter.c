@@ -4,140 +4,266 @@
  */
 
 #include "cauchy/crdt/g_counter.h"
-#include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 void cauchy_gcounter_init(cauchy_gcounter_t* gc, u32 num_nodes) {
-    if (!gc) return;
-    memset(gc->counts, 0, sizeof(gc->counts));
-    gc->num_nodes = (num_nodes <= CAUCHY_MAX_NODES) ? num_nodes : CAUCHY_MAX_NODES;
+    cauchy_vclock_init(gc, num_nodes);
+}
+
+void cauchy_gcounter_fini(cauchy_gcounter_t* gc) {
+    cauchy_vclock_fini(gc);
 }
 
 cauchy_gcounter_t* cauchy_gcounter_create(u32 num_nodes) {
-    cauchy_gcounter_t* gc = cauchy_aligned_alloc(
-        sizeof(cauchy_gcounter_t), CAUCHY_CACHE_LINE_SIZE);
-    if (gc) {
-        cauchy_gcounter_init(gc, num_nodes);
-    }
-    return gc;
+    return cauchy_vclock_create(num_nodes);
 }
 
 void cauchy_gcounter_destroy(cauchy_gcounter_t* gc) {
-    cauchy_aligned_free(gc);
+    cauchy_vclock_destroy(gc);
+}
+
+cauchy_result_t cauchy_gcounter_increment(cauchy_gcounter_t* gc, cauchy_node_id_t node_id) {
+    return cauchy_vclock_increment(gc, node_id);
+}
+
+cauchy_result_t cauchy_gcounter_add(cauchy_gcounter_t* gc, cauchy_node_id_t node_id, u64 delta) {
+    if (!gc) return CAUCHY_ERR_INVALID;
+    if (delta == 0) return CAUCHY_OK;
+    return cauchy_vclock_set(gc, node_id, cauchy_vclock_get(gc, node_id) + delta);
 }
 
-void cauchy_gcounter_increment(cauchy_gcounter_t* gc, cauchy_node_id_t node_id) {
-    if (!gc || node_id >= gc->num_nodes) return;
-    gc->counts[node_id]++;
+cauchy_result_t cauchy_gcounter_increment_delta(cauchy_gcounter_t* gc, cauchy_node_id_t node_id,
+                                                cauchy_gcounter_t* delta) {
+    return cauchy_gcounter_add_delta(gc, node_id, 1, delta);
 }
 
-void cauchy_gcounter_add(cauchy_gcounter_t* gc, cauchy_node_id_t node_id, u64 delta) {
-    if (!gc || node_id >= gc->num_nodes) return;
-    gc->counts[node_id] += delta;
+cauchy_result_t cauchy_gcounter_add_delta(cauchy_gcounter_t* gc, cauchy_node_id_t node_id,
+                                          u64 amount, cauchy_gcounter_t* delta) {
+    if (!gc || !delta) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_gcounter_add(gc, node_id, amount);
+    if (res != CAUCHY_OK || amount == 0) return res;
+    /* Per-node counts only grow, so the replica's entry is the join */
+    return cauchy_vclock_set(delta, node_id, cauchy_vclock_get(gc, node_id));
 }
 
 u64 cauchy_gcounter_value(const cauchy_gcounter_t* gc) {
-    if (!gc) return 0;
-    u64 sum = 0;
-    for (u32 i = 0; i < gc->num_nodes; i++) {
-        sum += gc->counts[i];
-    }
-    return sum;
+    return cauchy_vclock_sum(gc);
 }
 
 u64 cauchy_gcounter_get(const cauchy_gcounter_t* gc, cauchy_node_id_t node_id) {
-    if (!gc || node_id >= gc->num_nodes) return 0;
-    return gc->counts[node_id];
+    return cauchy_vclock_get(gc, node_id);
 }
 
-void cauchy_gcounter_merge(cauchy_gcounter_t* dst, const cauchy_gcounter_t* src) {
-    if (!dst || !src) return;
-    u32 max_nodes = (dst->num_nodes > src->num_nodes) ? dst->num_nodes : src->num_nodes;
-    for (u32 i = 0; i < max_nodes; i++) {
-        if (i < src->num_nodes && src->counts[i] > dst->counts[i]) {
-            dst->counts[i] = src->counts[i];
-        }
-    }
-    if (src->num_nodes > dst->num_nodes) {
-        dst->num_nodes = src->num_nodes;
-    }
+cauchy_result_t cauchy_gcounter_merge(cauchy_gcounter_t* dst, const cauchy_gcounter_t* src) {
+    return cauchy_vclock_merge(dst, src);
+}
+
+cauchy_result_t cauchy_gcounter_merge_delta(cauchy_gcounter_t* dst, const cauchy_gcounter_t* delta) {
+    return cauchy_vclock_merge(dst, delta);
 }
 
 bool cauchy_gcounter_equals(const cauchy_gcounter_t* a, const cauchy_gcounter_t* b) {
     if (!a || !b) return a == b;
-    if (a->num_nodes != b->num_nodes) return false;
-    for (u32 i = 0; i < a->num_nodes; i++) {
-        if (a->counts[i] != b->counts[i]) return false;
-    }
-    return true;
+    return cauchy_vclock_compare(a, b) == CAUCHY_EQUAL;
 }
 
 cauchy_causality_t cauchy_gcounter_compare(const cauchy_gcounter_t* a,
                                             const cauchy_gcounter_t* b) {
-    if (!a || !b) return CAUCHY_CONCURRENT;
-    
-    bool a_less = false, a_greater = false;
-    u32 max_nodes = (a->num_nodes > b->num_nodes) ? a->num_nodes : b->num_nodes;
-    
-    for (u32 i = 0; i < max_nodes; i++) {
-        u64 av = (i < a->num_nodes) ? a->counts[i] : 0;
-        u64 bv = (i < b->num_nodes) ? b->counts[i] : 0;
-        if (av < bv) a_less = true;
-        if (av > bv) a_greater = true;
-    }
-    
-    if (!a_less && !a_greater) return CAUCHY_EQUAL;
-    if (a_less && !a_greater) return CAUCHY_HAPPENS_BEFORE;
-    if (!a_less && a_greater) return CAUCHY_HAPPENS_AFTER;
-    return CAUCHY_CONCURRENT;
+    return cauchy_vclock_compare(a, b);
 }
 
-void cauchy_gcounter_copy(cauchy_gcounter_t* dst, const cauchy_gcounter_t* src) {
-    if (!dst || !src) return;
-    memcpy(dst, src, sizeof(cauchy_gcounter_t));
+cauchy_result_t cauchy_gcounter_copy(cauchy_gcounter_t* dst, const cauchy_gcounter_t* src) {
+    return cauchy_vclock_copy(dst, src);
 }
 
 cauchy_gcounter_t* cauchy_gcounter_clone(const cauchy_gcounter_t* gc) {
-    if (!gc) return NULL;
-    cauchy_gcounter_t* clone = cauchy_gcounter_create(gc->num_nodes);
-    if (clone) cauchy_gcounter_copy(clone, gc);
-    return clone;
+    return cauchy_vclock_clone(gc);
 }
 
 usize cauchy_gcounter_serialized_size(const cauchy_gcounter_t* gc) {
-    if (!gc) return 0;
-    return sizeof(u32) + (gc->num_nodes * sizeof(u64));
+    return cauchy_vclock_serialized_size(gc);
 }
 
 usize cauchy_gcounter_serialize(const cauchy_gcounter_t* gc, u8* buffer, usize size) {
-    if (!gc || !buffer) return 0;
-    usize needed = cauchy_gcounter_serialized_size(gc);
-    if (size < needed) return 0;
-    memcpy(buffer, &gc->num_nodes, sizeof(u32));
-    memcpy(buffer + sizeof(u32), gc->counts, gc->num_nodes * sizeof(u64));
-    return needed;
+    return cauchy_vclock_serialize(gc, buffer, size);
 }
 
 cauchy_result_t cauchy_gcounter_deserialize(cauchy_gcounter_t* gc,
                                              const u8* buffer, usize size) {
-    if (!gc || !buffer || size < sizeof(u32)) return CAUCHY_ERR_INVALID;
-    u32 num_nodes;
-    memcpy(&num_nodes, buffer, sizeof(u32));
-    if (num_nodes > CAUCHY_MAX_NODES) return CAUCHY_ERR_INVALID;
-    if (size < sizeof(u32) + num_nodes * sizeof(u64)) return CAUCHY_ERR_INVALID;
-    cauchy_gcounter_init(gc, num_nodes);
-    memcpy(gc->counts, buffer + sizeof(u32), num_nodes * sizeof(u64));
+    return cauchy_vclock_deserialize(gc, buffer, size);
+}
+
+cauchy_result_t cauchy_gcounter_snapshot_save(const cauchy_gcounter_t* gc,
+                                              cauchy_snapshot_writer_t* w, u64 id) {
+    if (!gc || !w) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_snapshot_writer_begin(w, CAUCHY_SNAPSHOT_G_COUNTER, id);
+    if (res != CAUCHY_OK) return res;
+    res = cauchy_snapshot_writer_put_vclock(w, gc);
+    cauchy_result_t end = cauchy_snapshot_writer_end(w);
+    return res != CAUCHY_OK ? res : end;
+}
+
+cauchy_result_t cauchy_gcounter_snapshot_load(cauchy_gcounter_t* gc, cauchy_snapshot_t* snap,
+                                              u64 id) {
+    if (!gc) return CAUCHY_ERR_INVALID;
+    const u8* data;
+    usize size;
+    cauchy_result_t res = cauchy_snapshot_find(snap, CAUCHY_SNAPSHOT_G_COUNTER, id, &data, &size);
+    if (res != CAUCHY_OK) return res;
+
+    cauchy_snapshot_cursor_t cur;
+    cauchy_gcounter_t loaded;
+    cauchy_snapshot_cursor_init(&cur, data, size);
+    if (!cauchy_snapshot_get_vclock(&cur, &loaded)) return CAUCHY_ERR_INVALID;
+    cauchy_gcounter_fini(gc);
+    *gc = loaded;
     return CAUCHY_OK;
 }
 
+usize cauchy_gcounter_encoded_size(const cauchy_gcounter_t* gc, const cauchy_gcounter_t* base) {
+    return cauchy_vclock_encoded_size(gc, base);
+}
+
+usize cauchy_gcounter_encode(const cauchy_gcounter_t* gc, const cauchy_gcounter_t* base,
+                             u8* buffer, usize size) {
+    return cauchy_vclock_encode(gc, base, buffer, size);
+}
+
+cauchy_result_t cauchy_gcounter_decode(cauchy_gcounter_t* gc, const cauchy_gcounter_t* base,
+                                       const u8* buffer, usize size, usize* consumed) {
+    return cauchy_vclock_decode(gc, base, buffer, size, consumed);
+}
+
+/* Striped counters */
+
+cauchy_result_t cauchy_counter_stripes_init(cauchy_counter_stripes_t* cs, cauchy_node_id_t node_id,
+                                            u32 stripes) {
+    if (!cs) return CAUCHY_ERR_INVALID;
+    if (stripes == 0) stripes = CAUCHY_COUNTER_STRIPES;
+    if (stripes > CAUCHY_MAX_THREADS) stripes = CAUCHY_MAX_THREADS;
+    u32 n = 1;
+    while (n < stripes) n <<= 1;
+
+    cs->stripes = cauchy_aligned_alloc(n * sizeof(cauchy_counter_stripe_t), CAUCHY_CACHE_LINE_SIZE);
+    cs->folded = calloc(2 * (usize)n, sizeof(u64));
+    if (!cs->stripes || !cs->folded) {
+        cauchy_aligned_free(cs->stripes);
+        free(cs->folded);
+        return CAUCHY_ERR_NOMEM;
+    }
+    for (u32 i = 0; i < n; i++) {
+        atomic_init(&cs->stripes[i].added, 0);
+        atomic_init(&cs->stripes[i].removed, 0);
+    }
+    cs->pending_added = 0;
+    cs->pending_removed = 0;
+    cs->mask = n - 1;
+    cs->node_id = node_id;
+    return CAUCHY_OK;
+}
+
+void cauchy_counter_stripes_fini(cauchy_counter_stripes_t* cs) {
+    if (!cs) return;
+    cauchy_aligned_free(cs->stripes);
+    free(cs->folded);
+    cs->stripes = NULL;
+    cs->folded = NULL;
+}
+
+cauchy_counter_stripe_t* cauchy_counter_stripes_local(cauchy_counter_stripes_t* cs) {
+    /* Threads without an id (all slots taken) share the last stripe */
+    u32 tid = cauchy_thread_id();
+    return &cs->stripes[tid == CAUCHY_THREAD_ID_INVALID ? cs->mask : tid & cs->mask];
+}
+
+/* Stripe totals only grow, so what is new since the last drain is the
+ * difference to the folded copy. Only reads the stripes: the owner never
+ * pulls the lines away from the threads writing them. The result waits
+ * in pending until the caller has applied it, so a failed fold loses
+ * nothing. */
+void cauchy_counter_stripes_drain(cauchy_counter_stripes_t* cs) {
+    u64 a = 0, r = 0;
+    for (u32 i = 0; i <= cs->mask; i++) {
+        u64 sa = atomic_load_explicit(&cs->stripes[i].added, memory_order_relaxed);
+        u64 sr = atomic_load_explicit(&cs->stripes[i].removed, memory_order_relaxed);
+        a += sa - cs->folded[2 * i];
+        r += sr - cs->folded[2 * i + 1];
+        cs->folded[2 * i] = sa;
+        cs->folded[2 * i + 1] = sr;
+    }
+    cs->pending_added += a;
+    cs->pending_removed += r;
+}
+
+cauchy_gcounter_striped_t* cauchy_gcounter_striped_create(u32 num_nodes, cauchy_node_id_t node_id,
+                                                          u32 stripes) {
+    cauchy_gcounter_striped_t* sc = calloc(1, sizeof(cauchy_gcounter_striped_t));
+    if (!sc) return NULL;
+    if (cauchy_counter_stripes_init(&sc->local, node_id, stripes) != CAUCHY_OK) {
+        free(sc);
+        return NULL;
+    }
+    cauchy_gcounter_init(&sc->counter, num_nodes);
+    return sc;
+}
+
+void cauchy_gcounter_striped_destroy(cauchy_gcounter_striped_t* sc) {
+    if (!sc) return;
+    cauchy_gcounter_fini(&sc->counter);
+    cauchy_counter_stripes_fini(&sc->local);
+    free(sc);
+}
+
+void cauchy_gcounter_striped_increment(cauchy_gcounter_striped_t* sc) {
+    cauchy_gcounter_striped_add(sc, 1);
+}
+
+void cauchy_gcounter_striped_add(cauchy_gcounter_striped_t* sc, u64 amount) {
+    if (!sc) return;
+    atomic_fetch_add_explicit(&cauchy_counter_stripes_local(&sc->local)->added, amount,
+                              memory_order_relaxed);
+}
+
+cauchy_result_t cauchy_gcounter_striped_fold(cauchy_gcounter_striped_t* sc,
+                                             cauchy_gcounter_t* delta) {
+    if (!sc) return CAUCHY_ERR_INVALID;
+    cauchy_counter_stripes_drain(&sc->local);
+    u64 added = sc->local.pending_added;
+    cauchy_result_t res = delta
+        ? cauchy_gcounter_add_delta(&sc->counter, sc->local.node_id, added, delta)
+        : cauchy_gcounter_add(&sc->counter, sc->local.node_id, added);
+    if (res == CAUCHY_OK) sc->local.pending_added = 0;
+    return res;
+}
+
+u64 cauchy_gcounter_striped_value(cauchy_gcounter_striped_t* sc) {
+    if (!sc) return 0;
+    cauchy_gcounter_striped_fold(sc, NULL);
+    return cauchy_gcounter_value(&sc->counter);
+}
+
+cauchy_result_t cauchy_gcounter_striped_merge(cauchy_gcounter_striped_t* sc,
+                                              const cauchy_gcounter_t* src) {
+    if (!sc || !src) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_gcounter_striped_fold(sc, NULL);
+    if (res != CAUCHY_OK) return res;
+    return cauchy_gcounter_merge(&sc->counter, src);
+}
+
 void cauchy_gcounter_debug_print(const cauchy_gcounter_t* gc, const char* label) {
     if (!gc) { fprintf(stderr, "%s: (null)\n", label ? label : "gcounter"); return; }
-    fprintf(stderr, "%s: value=%llu [", label ? label : "gcounter", 
+    fprintf(stderr, "%s: value=%llu [", label ? label : "gcounter",
             (unsigned long long)cauchy_gcounter_value(gc));
-    for (u32 i = 0; i < gc->num_nodes; i++) {
-        fprintf(stderr, "%llu%s", (unsigned long long)gc->counts[i], 
-                (i < gc->num_nodes - 1) ? "," : "");
+    cauchy_vclock_iter_t iter;
+    cauchy_vclock_iter_init(&iter, gc);
+    cauchy_node_id_t id;
+    u64 count;
+    bool first = true;
+    while (cauchy_vclock_iter_next(&iter, &id, &count)) {
+        fprintf(stderr, "%s%llu:%llu", first ? "" : ",",
+                (unsigned long long)id, (unsigned long long)count);
+        first = false;
     }
     fprintf(stderr, "]\n");
 }
-
@@ -4,41 +4,110 @@
  */
 
 #include "cauchy/crdt/g_set.h"
+#include "cauchy/stats.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-static u64 hash_data(const void* data, usize size) {
-    const u8* bytes = (const u8*)data;
-    u64 hash = 14695981039346656037ULL;  /* FNV-1a offset basis */
-    for (usize i = 0; i < size; i++) {
-        hash ^= bytes[i];
-        hash *= 1099511628211ULL;  /* FNV prime */
+static cauchy_gset_elem_t* find_elem(const cauchy_gset_t* set, u64 h,
+                                     const void* data, usize size) {
+    cauchy_htable_probe_t probe;
+    cauchy_htable_probe_init(&probe, &set->index, h);
+
+    cauchy_gset_elem_t* elem;
+    while ((elem = cauchy_htable_probe_next(&probe)) != NULL) {
+        if (elem->hash == h && elem->size == size &&
+            memcmp(elem->data, data, size) == 0) {
+            return elem;
+        }
+    }
+    return NULL;
+}
+
+/* Base records: u64 hash, u64 size, then the bytes */
+static bool base_record(const cauchy_gset_t* set, const u8* rec,
+                        u64* hash, const u8** data, usize* size) {
+    if (!rec) return false;
+    usize room = cauchy_snapshot_index_room(&set->base, rec);
+    if (room < 2 * sizeof(u64)) return false;
+    const u64* r = (const u64*)rec;
+    if (r[1] == 0 || r[1] > room - 2 * sizeof(u64)) return false;
+    *hash = r[0];
+    *size = (usize)r[1];
+    *data = rec + 2 * sizeof(u64);
+    return true;
+}
+
+static bool find_base(const cauchy_gset_t* set, u64 h, const void* data, usize size) {
+    if (set->base_count == 0) return false;
+    cauchy_snapshot_probe_t probe;
+    cauchy_snapshot_probe_init(&probe, &set->base, h);
+    const u8* rec;
+    u64 slot;
+    while ((rec = cauchy_snapshot_probe_next(&probe, &slot)) != NULL) {
+        u64 rh;
+        const u8* rd;
+        usize rs;
+        if (base_record(set, rec, &rh, &rd, &rs) && rh == h && rs == size &&
+            memcmp(rd, data, size) == 0) {
+            return !cauchy_snapshot_shadowed(&set->base_dropped, slot);
+        }
+    }
+    return false;
+}
+
+static bool has_elem(const cauchy_gset_t* set, u64 h, const void* data, usize size) {
+    return find_elem(set, h, data, size) || find_base(set, h, data, size);
+}
+
+/* Next element of the heap, then of the base */
+static bool iter_item(cauchy_gset_iter_t* iter, const u8** data, usize* size, u64* hash) {
+    const cauchy_gset_elem_t* elem = cauchy_htable_iter_next(&iter->inner);
+    if (elem) {
+        *data = elem->data;
+        *size = elem->size;
+        *hash = elem->hash;
+        return true;
+    }
+    const cauchy_gset_t* set = iter->set;
+    while (iter->base_slot < set->base.capacity) {
+        u64 slot = iter->base_slot++;
+        if (cauchy_snapshot_shadowed(&set->base_dropped, slot)) continue;
+        if (base_record(set, cauchy_snapshot_index_at(&set->base, slot), hash, data, size)) {
+            return true;
+        }
     }
-    return hash;
+    return false;
 }
 
 cauchy_result_t cauchy_gset_init(cauchy_gset_t* set, usize initial_capacity) {
     if (!set) return CAUCHY_ERR_INVALID;
     if (initial_capacity == 0) initial_capacity = 16;
 
-    set->buckets = calloc(initial_capacity, sizeof(cauchy_gset_elem_t*));
-    if (!set->buckets) return CAUCHY_ERR_NOMEM;
-
-    set->num_buckets = initial_capacity;
-    set->count = 0;
+    cauchy_result_t res = cauchy_htable_init(&set->index, initial_capacity);
+    if (res != CAUCHY_OK) return res;
 
     cauchy_pool_config_t cfg = {
-        .block_size = sizeof(cauchy_gset_elem_t) + 64,
+        .block_size = sizeof(cauchy_gset_elem_t) + CAUCHY_GSET_INLINE_SIZE,
         .initial_blocks = 128,
         .max_blocks = 0,
         .alignment = sizeof(void*)
     };
     set->elem_pool = cauchy_pool_create(&cfg);
     if (!set->elem_pool) {
-        free(set->buckets);
+        cauchy_htable_destroy(&set->index);
         return CAUCHY_ERR_NOMEM;
     }
+    cauchy_arena_init(&set->payloads, 0);
+    set->digest = NULL;
+    set->fingerprint = 0;
+    set->snapshot = NULL;
+    memset(&set->base, 0, sizeof(set->base));
+    memset(&set->base_dropped, 0, sizeof(set->base_dropped));
+    set->base_count = 0;
+    set->base_cursor = 0;
+    set->views = NULL;
+    set->base_died = NULL;
     return CAUCHY_OK;
 }
 
@@ -54,135 +123,841 @@ cauchy_gset_t* cauchy_gset_create(usize initial_capacity) {
 
 void cauchy_gset_destroy(cauchy_gset_t* set) {
     if (!set) return;
-    for (usize i = 0; i < set->num_buckets; i++) {
-        cauchy_gset_elem_t* elem = set->buckets[i];
-        while (elem) {
-            cauchy_gset_elem_t* next = elem->next;
-            if (elem->data) free(elem->data);
-            elem = next;
-        }
+    if (set->views) {
+        cauchy_mvcc_fini(set->views);  /* Frees pruned elements still pending */
+        free(set->views);
+        free(set->base_died);
     }
-    free(set->buckets);
+    cauchy_htable_destroy(&set->index);
     if (set->elem_pool) cauchy_pool_destroy(set->elem_pool);
+    cauchy_arena_destroy(&set->payloads);
+    if (set->digest) {
+        cauchy_merkle_destroy(set->digest);
+        free(set->digest);
+    }
+    cauchy_snapshot_shadow_fini(&set->base_dropped);
+    cauchy_snapshot_release(set->snapshot);
     free(set);
 }
 
 cauchy_result_t cauchy_gset_add(cauchy_gset_t* set, const void* data, usize size) {
     if (!set || !data || size == 0) return CAUCHY_ERR_INVALID;
+    return cauchy_gset_add_hashed(set, data, size, cauchy_hash_bytes(data, size));
+}
 
-    u64 h = hash_data(data, size);
-    usize idx = h % set->num_buckets;
+/* Allocate and fill an element, taking large payloads from `payloads` */
+static cauchy_gset_elem_t* elem_new(cauchy_gset_t* set, cauchy_arena_t* payloads,
+                                    const void* data, usize size, u64 h) {
+    cauchy_gset_elem_t* elem = cauchy_pool_alloc(set->elem_pool);
+    if (!elem) return NULL;
 
-    cauchy_gset_elem_t* elem = set->buckets[idx];
-    while (elem) {
-        if (elem->hash == h && elem->size == size &&
-            memcmp(elem->data, data, size) == 0) {
-            return CAUCHY_OK;  /* Already exists */
-        }
-        elem = elem->next;
+    elem->data = size <= CAUCHY_GSET_INLINE_SIZE
+        ? elem->inline_data
+        : cauchy_arena_alloc(payloads, size);
+    if (!elem->data) {
+        cauchy_pool_free(set->elem_pool, elem);
+        return NULL;
     }
 
-    cauchy_gset_elem_t* new_elem = cauchy_pool_alloc(set->elem_pool);
-    if (!new_elem) new_elem = malloc(sizeof(cauchy_gset_elem_t));
+    memcpy(elem->data, data, size);
+    elem->size = size;
+    elem->hash = h;
+    return elem;
+}
+
+static void publish(cauchy_gset_t* set) {
+    if (set->views) cauchy_mvcc_publish(set->views, cauchy_gset_count(set), set->fingerprint);
+}
+
+static void elem_retire(void* item, void* ctx) {
+    cauchy_pool_free(ctx, item);
+}
+
+/* Add without publishing, so a merge becomes visible as one version */
+static cauchy_result_t insert_hashed(cauchy_gset_t* set, const void* data, usize size, u64 h) {
+    if (has_elem(set, h, data, size)) return CAUCHY_OK;  /* Already exists */
+
+    cauchy_gset_elem_t* new_elem = elem_new(set, &set->payloads, data, size, h);
     if (!new_elem) return CAUCHY_ERR_NOMEM;
 
-    new_elem->data = malloc(size);
-    if (!new_elem->data) {
+    /* On failure an arena payload stays reserved until destroy. A record
+     * ended in the version it was staged in is never visible, so the
+     * element can go at once. */
+    u32 slot = CAUCHY_MVCC_NONE;
+    cauchy_result_t res = set->views ? cauchy_mvcc_append(set->views, new_elem, &slot) : CAUCHY_OK;
+    if (res == CAUCHY_OK) res = cauchy_htable_insert(&set->index, h, new_elem);
+    if (res != CAUCHY_OK) {
+        if (set->views) cauchy_mvcc_end(set->views, slot);
         cauchy_pool_free(set->elem_pool, new_elem);
-        return CAUCHY_ERR_NOMEM;
+        return res;
     }
-
-    memcpy(new_elem->data, data, size);
-    new_elem->size = size;
-    new_elem->hash = h;
-    new_elem->next = set->buckets[idx];
-    set->buckets[idx] = new_elem;
-    set->count++;
+    set->fingerprint += cauchy_merkle_item(h);
+    if (set->digest) cauchy_merkle_add(set->digest, h, h);
     return CAUCHY_OK;
 }
 
+cauchy_result_t cauchy_gset_add_hashed(cauchy_gset_t* set, const void* data, usize size, u64 h) {
+    if (!set || !data || size == 0) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = insert_hashed(set, data, size, h);
+    if (res == CAUCHY_OK) publish(set);
+    return res;
+}
+
+cauchy_result_t cauchy_gset_add_delta(cauchy_gset_t* set, const void* data, usize size,
+                                      cauchy_gset_t* delta) {
+    if (!set || !delta || !data || size == 0) return CAUCHY_ERR_INVALID;
+    u64 h = cauchy_hash_bytes(data, size);
+    if (has_elem(set, h, data, size)) return CAUCHY_OK;
+
+    cauchy_result_t res = cauchy_gset_add_hashed(set, data, size, h);
+    if (res != CAUCHY_OK) return res;
+    return cauchy_gset_add_hashed(delta, data, size, h);
+}
+
 bool cauchy_gset_contains(const cauchy_gset_t* set, const void* data, usize size) {
     if (!set || !data || size == 0) return false;
+    return has_elem(set, cauchy_hash_bytes(data, size), data, size);
+}
 
-    u64 h = hash_data(data, size);
-    usize idx = h % set->num_buckets;
+bool cauchy_gset_contains_hashed(const cauchy_gset_t* set, const void* data, usize size, u64 h) {
+    if (!set || !data || size == 0) return false;
+    return has_elem(set, h, data, size);
+}
 
-    cauchy_gset_elem_t* elem = set->buckets[idx];
-    while (elem) {
-        if (elem->hash == h && elem->size == size &&
-            memcmp(elem->data, data, size) == 0) {
-            return true;
+/* Batches go in chunks: hash the chunk, touch every home slot, then
+ * probe, so the slot misses of one chunk are in flight together */
+cauchy_result_t cauchy_gset_add_batch(cauchy_gset_t* set, const cauchy_bytes_t* items, usize n,
+                                      cauchy_result_t* results) {
+    if (!set || (n && !items)) return CAUCHY_ERR_INVALID;
+    cauchy_result_t first = CAUCHY_OK;
+    u64 hashes[CAUCHY_HTABLE_BATCH];
+    for (usize base = 0; base < n; base += CAUCHY_HTABLE_BATCH) {
+        usize m = n - base < CAUCHY_HTABLE_BATCH ? n - base : CAUCHY_HTABLE_BATCH;
+        cauchy_hash_batch(items + base, m, hashes);
+        for (usize i = 0; i < m; i++) cauchy_htable_prefetch(&set->index, hashes[i]);
+        for (usize i = 0; i < m; i++) {
+            const cauchy_bytes_t* it = &items[base + i];
+            cauchy_result_t res = cauchy_gset_add_hashed(set, it->data, it->size, hashes[i]);
+            if (results) results[base + i] = res;
+            if (res != CAUCHY_OK && first == CAUCHY_OK) first = res;
         }
-        elem = elem->next;
     }
-    return false;
+    return first;
+}
+
+usize cauchy_gset_contains_batch(const cauchy_gset_t* set, const cauchy_bytes_t* items, usize n,
+                                 bool* found) {
+    if (!set || (n && !items)) return 0;
+    usize hits = 0;
+    u64 hashes[CAUCHY_HTABLE_BATCH];
+    for (usize base = 0; base < n; base += CAUCHY_HTABLE_BATCH) {
+        usize m = n - base < CAUCHY_HTABLE_BATCH ? n - base : CAUCHY_HTABLE_BATCH;
+        cauchy_hash_batch(items + base, m, hashes);
+        for (usize i = 0; i < m; i++) cauchy_htable_prefetch(&set->index, hashes[i]);
+        for (usize i = 0; i < m; i++) {
+            const cauchy_bytes_t* it = &items[base + i];
+            bool hit = cauchy_gset_contains_hashed(set, it->data, it->size, hashes[i]);
+            if (found) found[base + i] = hit;
+            hits += hit;
+        }
+    }
+    return hits;
 }
 
 usize cauchy_gset_count(const cauchy_gset_t* set) {
-    return set ? set->count : 0;
+    return set ? cauchy_htable_count(&set->index) + set->base_count : 0;
 }
 
 bool cauchy_gset_is_empty(const cauchy_gset_t* set) {
-    return !set || set->count == 0;
+    return cauchy_gset_count(set) == 0;
 }
 
 cauchy_result_t cauchy_gset_merge(cauchy_gset_t* dst, const cauchy_gset_t* src) {
     if (!dst || !src) return CAUCHY_ERR_INVALID;
+    if (dst == src) return CAUCHY_OK;
 
-    for (usize i = 0; i < src->num_buckets; i++) {
-        cauchy_gset_elem_t* elem = src->buckets[i];
-        while (elem) {
-            cauchy_result_t res = cauchy_gset_add(dst, elem->data, elem->size);
-            if (res != CAUCHY_OK) return res;
-            elem = elem->next;
+    u64 start = CAUCHY_STAT_NOW();
+    cauchy_gset_iter_t iter;
+    cauchy_gset_iter_init(&iter, src);
+    const u8* data;
+    usize size;
+    u64 h;
+    while (iter_item(&iter, &data, &size, &h)) {
+        cauchy_result_t res = insert_hashed(dst, data, size, h);
+        if (res != CAUCHY_OK) {
+            publish(dst);
+            return res;
         }
     }
+    publish(dst);
+    CAUCHY_STAT_MERGE(CAUCHY_STAT_CRDT_GSET, cauchy_gset_count(src),
+                      CAUCHY_STAT_NOW() - start, cauchy_gset_count(dst), 0);
     return CAUCHY_OK;
 }
 
+cauchy_result_t cauchy_gset_merge_delta(cauchy_gset_t* dst, const cauchy_gset_t* delta) {
+    return cauchy_gset_merge(dst, delta);
+}
+
+/* Parallel merge. Pass one scatters the source's elements by the dst
+ * part that owns their home slot. Pass two merges each part's elements
+ * into its slot range, with a private arena and no shared writes. Refs
+ * are element pointers, or base slot << 1 | 1. */
+
+typedef struct gset_merge_part {
+    cauchy_htable_part_t index;
+    cauchy_arena_t       payloads;
+    cauchy_scatter_bin_t deferred;   /* Probe chains that left the part */
+    cauchy_scatter_bin_t added;      /* New elements, for the digest and views */
+    u64                  fingerprint; /* Of the new elements */
+    cauchy_result_t      res;
+} gset_merge_part_t;
+
+typedef struct gset_merge_job {
+    cauchy_gset_t*       dst;
+    const cauchy_gset_t* src;
+    cauchy_scatter_t     scatter;
+    gset_merge_part_t*   parts;
+    u32                  count;
+} gset_merge_job_t;
+
+static bool ref_item(const cauchy_gset_t* set, u64 ref, const u8** data, usize* size) {
+    if (ref & 1) {
+        u64 h;
+        return base_record(set, cauchy_snapshot_index_at(&set->base, ref >> 1), &h, data, size);
+    }
+    const cauchy_gset_elem_t* elem = (const cauchy_gset_elem_t*)(uintptr_t)ref;
+    *data = elem->data;
+    *size = elem->size;
+    return true;
+}
+
+static void gset_scatter_task(void* arg, u32 i) {
+    gset_merge_job_t* job = arg;
+    const cauchy_gset_t* src = job->src;
+    const cauchy_htable_t* to = &job->dst->index;
+
+    cauchy_htable_iter_t iter;
+    cauchy_htable_iter_init_slice(&iter, &src->index, i, job->count);
+    const cauchy_gset_elem_t* elem;
+    while ((elem = cauchy_htable_iter_next(&iter)) != NULL) {
+        u32 p = cauchy_htable_part_of(to, job->count, elem->hash);
+        if (!cauchy_scatter_push(cauchy_scatter_bin(&job->scatter, i, p),
+                                 elem->hash, (u64)(uintptr_t)elem)) {
+            job->parts[i].res = CAUCHY_ERR_NOMEM;
+            return;
+        }
+    }
+
+    u64 span = (src->base.capacity + job->count - 1) / job->count;
+    u64 end = span * (i + 1) < src->base.capacity ? span * (i + 1) : src->base.capacity;
+    for (u64 slot = span * i; slot < end; slot++) {
+        if (cauchy_snapshot_shadowed(&src->base_dropped, slot)) continue;
+        u64 h;
+        const u8* data;
+        usize size;
+        if (!base_record(src, cauchy_snapshot_index_at(&src->base, slot), &h, &data, &size)) {
+            continue;
+        }
+        u32 p = cauchy_htable_part_of(to, job->count, h);
+        if (!cauchy_scatter_push(cauchy_scatter_bin(&job->scatter, i, p), h,
+                                 slot << 1 | 1)) {
+            job->parts[i].res = CAUCHY_ERR_NOMEM;
+            return;
+        }
+    }
+}
+
+/* Add within the part; CAUCHY_ERR_FULL defers the element */
+static cauchy_result_t part_add(cauchy_gset_t* dst, gset_merge_part_t* part, u64 h,
+                                const u8* data, usize size) {
+    cauchy_htable_part_probe_t probe;
+    cauchy_htable_part_probe_init(&probe, &part->index, h);
+    const cauchy_gset_elem_t* elem;
+    while ((elem = cauchy_htable_part_probe_next(&probe)) != NULL) {
+        if (elem->hash == h && elem->size == size && memcmp(elem->data, data, size) == 0) {
+            return CAUCHY_OK;
+        }
+    }
+    if (probe.escaped) return CAUCHY_ERR_FULL;
+    if (find_base(dst, h, data, size)) return CAUCHY_OK;
+
+    cauchy_gset_elem_t* new_elem = elem_new(dst, &part->payloads, data, size, h);
+    if (!new_elem) return CAUCHY_ERR_NOMEM;
+    bool track = dst->digest || dst->views;
+    if (track && !cauchy_scatter_push(&part->added, h, (u64)(uintptr_t)new_elem)) {
+        cauchy_pool_free(dst->elem_pool, new_elem);
+        return CAUCHY_ERR_NOMEM;
+    }
+    cauchy_result_t res = cauchy_htable_part_insert(&part->index, h, new_elem);
+    if (res != CAUCHY_OK) {
+        if (track) part->added.count--;
+        cauchy_pool_free(dst->elem_pool, new_elem);
+        return res;
+    }
+    part->fingerprint += cauchy_merkle_item(h);
+    return CAUCHY_OK;
+}
+
+static void gset_merge_task(void* arg, u32 p) {
+    gset_merge_job_t* job = arg;
+    gset_merge_part_t* part = &job->parts[p];
+    for (u32 i = 0; i < job->count; i++) {
+        const cauchy_scatter_bin_t* bin = cauchy_scatter_bin(&job->scatter, i, p);
+        for (usize k = 0; k < bin->count; k++) {
+            const cauchy_scatter_item_t* item = &bin->items[k];
+            const u8* data;
+            usize size;
+            if (!ref_item(job->src, item->ref, &data, &size)) continue;
+            cauchy_result_t res = part_add(job->dst, part, item->hash, data, size);
+            if (res == CAUCHY_ERR_FULL) {
+                res = cauchy_scatter_push(&part->deferred, item->hash, item->ref)
+                    ? CAUCHY_OK : CAUCHY_ERR_NOMEM;
+            }
+            if (res != CAUCHY_OK) {
+                part->res = res;
+                return;
+            }
+        }
+    }
+}
+
+cauchy_result_t cauchy_gset_merge_parallel(cauchy_gset_t* dst, const cauchy_gset_t* src,
+                                           u32 parts, const cauchy_executor_t* exec) {
+    if (!dst || !src) return CAUCHY_ERR_INVALID;
+    if (dst == src) return CAUCHY_OK;
+    if (parts == 0) parts = cauchy_parallel_default_parts();
+    if (parts > CAUCHY_PARALLEL_MAX_PARTS) parts = CAUCHY_PARALLEL_MAX_PARTS;
+    usize n = cauchy_gset_count(src);
+    if (parts <= 1 || n < CAUCHY_PARALLEL_MIN_ITEMS) return cauchy_gset_merge(dst, src);
+
+    u64 start = CAUCHY_STAT_NOW();
+    cauchy_result_t res = cauchy_htable_reserve(&dst->index, n);
+    if (res != CAUCHY_OK) return res;
+
+    gset_merge_job_t job = { .dst = dst, .src = src, .count = parts };
+    job.parts = calloc(parts, sizeof(gset_merge_part_t));
+    if (!job.parts) return CAUCHY_ERR_NOMEM;
+    res = cauchy_scatter_init(&job.scatter, parts);
+    if (res != CAUCHY_OK) {
+        free(job.parts);
+        return res;
+    }
+    for (u32 p = 0; p < parts; p++) {
+        cauchy_htable_part_init(&job.parts[p].index, &dst->index, p, parts);
+        cauchy_arena_init(&job.parts[p].payloads, 0);
+        job.parts[p].res = CAUCHY_OK;
+    }
+
+    cauchy_executor_run(exec, parts, gset_scatter_task, &job);
+    for (u32 p = 0; p < parts && res == CAUCHY_OK; p++) res = job.parts[p].res;
+    if (res == CAUCHY_OK) cauchy_executor_run(exec, parts, gset_merge_task, &job);
+
+    /* Whatever the parts inserted is committed, even after a failure */
+    for (u32 p = 0; p < parts; p++) {
+        gset_merge_part_t* part = &job.parts[p];
+        cauchy_htable_part_commit(&part->index);
+        cauchy_arena_absorb(&dst->payloads, &part->payloads);
+        dst->fingerprint += part->fingerprint;
+        for (usize k = 0; k < part->added.count; k++) {
+            const cauchy_scatter_item_t* item = &part->added.items[k];
+            if (dst->digest) cauchy_merkle_add(dst->digest, item->hash, item->hash);
+            u32 slot;
+            if (dst->views && cauchy_mvcc_append(dst->views, (void*)(uintptr_t)item->ref,
+                                                 &slot) != CAUCHY_OK && res == CAUCHY_OK) {
+                res = CAUCHY_ERR_NOMEM;
+            }
+        }
+        if (res == CAUCHY_OK) res = part->res;
+    }
+    for (u32 p = 0; p < parts && res == CAUCHY_OK; p++) {
+        const cauchy_scatter_bin_t* bin = &job.parts[p].deferred;
+        for (usize k = 0; k < bin->count && res == CAUCHY_OK; k++) {
+            const u8* data;
+            usize size;
+            if (ref_item(src, bin->items[k].ref, &data, &size)) {
+                res = insert_hashed(dst, data, size, bin->items[k].hash);
+            }
+        }
+    }
+
+    for (u32 p = 0; p < parts; p++) {
+        free(job.parts[p].deferred.items);
+        free(job.parts[p].added.items);
+    }
+    free(job.parts);
+    cauchy_scatter_fini(&job.scatter);
+    publish(dst);
+    CAUCHY_STAT_MERGE(CAUCHY_STAT_CRDT_GSET, n, CAUCHY_STAT_NOW() - start,
+                      cauchy_gset_count(dst), 0);
+    return res;
+}
+
+u64 cauchy_gset_fingerprint(const cauchy_gset_t* set) {
+    return set ? set->fingerprint : 0;
+}
+
 bool cauchy_gset_equals(const cauchy_gset_t* a, const cauchy_gset_t* b) {
     if (!a || !b) return a == b;
-    if (a->count != b->count) return false;
-    return cauchy_gset_subset(a, b) && cauchy_gset_subset(b, a);
+    if (cauchy_gset_count(a) != cauchy_gset_count(b)) return false;
+    return cauchy_gset_subset(a, b);
 }
 
 bool cauchy_gset_subset(const cauchy_gset_t* a, const cauchy_gset_t* b) {
     if (!a || !b) return false;
-    for (usize i = 0; i < a->num_buckets; i++) {
-        cauchy_gset_elem_t* elem = a->buckets[i];
-        while (elem) {
-            if (!cauchy_gset_contains(b, elem->data, elem->size)) return false;
-            elem = elem->next;
+    if (cauchy_gset_count(a) > cauchy_gset_count(b)) return false;
+    /* Equal sizes: a subset only if the sets are equal */
+    if (cauchy_gset_count(a) == cauchy_gset_count(b) && a->fingerprint != b->fingerprint) {
+        return false;
+    }
+
+    cauchy_gset_iter_t iter;
+    cauchy_gset_iter_init(&iter, a);
+    const u8* data;
+    usize size;
+    u64 h;
+    while (iter_item(&iter, &data, &size, &h)) {
+        if (!has_elem(b, h, data, size)) return false;
+    }
+    return true;
+}
+
+cauchy_result_t cauchy_gset_enable_digest(cauchy_gset_t* set, u32 depth) {
+    if (!set) return CAUCHY_ERR_INVALID;
+    if (set->digest) return CAUCHY_ERR_EXISTS;
+    if (depth == 0) depth = CAUCHY_MERKLE_DEFAULT_DEPTH;
+
+    cauchy_merkle_t* tree = malloc(sizeof(cauchy_merkle_t));
+    if (!tree) return CAUCHY_ERR_NOMEM;
+    cauchy_result_t res = cauchy_merkle_init(tree, depth);
+    if (res != CAUCHY_OK) {
+        free(tree);
+        return res;
+    }
+
+    cauchy_gset_iter_t iter;
+    cauchy_gset_iter_init(&iter, set);
+    const u8* data;
+    usize size;
+    u64 h;
+    while (iter_item(&iter, &data, &size, &h)) cauchy_merkle_add(tree, h, h);
+    set->digest = tree;
+    return CAUCHY_OK;
+}
+
+const cauchy_merkle_t* cauchy_gset_digest(const cauchy_gset_t* set) {
+    return set ? set->digest : NULL;
+}
+
+cauchy_result_t cauchy_gset_collect_buckets(const cauchy_gset_t* set, u32 depth,
+                                            const u64* buckets, usize count,
+                                            cauchy_gset_t* out) {
+    if (!set || !out || (count && !buckets)) return CAUCHY_ERR_INVALID;
+    if (count == 0) return CAUCHY_OK;
+
+    cauchy_gset_iter_t iter;
+    cauchy_gset_iter_init(&iter, set);
+    const u8* data;
+    usize size;
+    u64 h;
+    while (iter_item(&iter, &data, &size, &h)) {
+        u64 bucket = cauchy_merkle_bucket(depth, h);
+        if (!cauchy_merkle_bucket_listed(buckets, count, bucket)) continue;
+        cauchy_result_t res = insert_hashed(out, data, size, h);
+        if (res != CAUCHY_OK) {
+            publish(out);
+            return res;
         }
     }
+    publish(out);
+    return CAUCHY_OK;
+}
+
+typedef struct prune_sweep {
+    cauchy_gset_t*       set;
+    const cauchy_gset_t* covered;
+} prune_sweep_t;
+
+static bool drop_covered(void* item, void* arg) {
+    cauchy_gset_elem_t* elem = item;
+    prune_sweep_t* sweep = arg;
+    if (!has_elem(sweep->covered, elem->hash, elem->data, elem->size)) return false;
+    sweep->set->fingerprint -= cauchy_merkle_item(elem->hash);
+    if (sweep->set->digest) cauchy_merkle_remove(sweep->set->digest, elem->hash, elem->hash);
+    cauchy_pool_free(sweep->set->elem_pool, elem);
     return true;
 }
 
+/* Base elements are never freed, only marked dropped */
+static usize prune_base(cauchy_gset_t* set, const cauchy_gset_t* covered, usize budget) {
+    u64 capacity = set->base.capacity;
+    if (set->base_count == 0 || capacity == 0) return 0;
+    if (budget == 0 || budget > capacity) budget = (usize)capacity;
+
+    usize dropped = 0;
+    for (usize n = 0; n < budget; n++) {
+        u64 slot = set->base_cursor;
+        set->base_cursor = (usize)((slot + 1) & (capacity - 1));
+        if (cauchy_snapshot_shadowed(&set->base_dropped, slot)) continue;
+        const u8* data;
+        usize size;
+        u64 h;
+        if (!base_record(set, cauchy_snapshot_index_at(&set->base, slot), &h, &data, &size)) continue;
+        if (!has_elem(covered, h, data, size)) continue;
+        if (cauchy_snapshot_shadow_set(&set->base_dropped, slot) != CAUCHY_OK) break;
+        if (set->base_died) {
+            atomic_store_explicit(&set->base_died[slot], cauchy_mvcc_next(set->views),
+                                  memory_order_relaxed);
+        }
+        set->fingerprint -= cauchy_merkle_item(h);
+        if (set->digest) cauchy_merkle_remove(set->digest, h, h);
+        set->base_count--;
+        dropped++;
+    }
+    return dropped;
+}
+
+/* With views, walk the version log instead of the index: its records
+ * say which element to end, and the element is retired, not freed */
+static usize prune_log(cauchy_gset_t* set, const cauchy_gset_t* covered,
+                       usize* cursor, usize budget) {
+    cauchy_mvcc_t* m = set->views;
+    usize length = cauchy_mvcc_length(m);
+    if (*cursor >= length) *cursor = 0;
+    if (budget == 0 || budget > length - *cursor) budget = length - *cursor;
+
+    usize dropped = 0;
+    for (usize n = 0; n < budget; n++) {
+        u32 slot = (u32)(*cursor)++;
+        cauchy_mvcc_record_t* rec = cauchy_mvcc_record(m->current, slot);
+        if (atomic_load_explicit(&rec->died, memory_order_relaxed) != CAUCHY_MVCC_LIVE) continue;
+        cauchy_gset_elem_t* elem = rec->item;
+        if (!has_elem(covered, elem->hash, elem->data, elem->size)) continue;
+        cauchy_htable_remove(&set->index, elem->hash, elem);
+        cauchy_mvcc_end(m, slot);
+        set->fingerprint -= cauchy_merkle_item(elem->hash);
+        if (set->digest) cauchy_merkle_remove(set->digest, elem->hash, elem->hash);
+        cauchy_mvcc_retire(m, elem, elem_retire, set->elem_pool);
+        dropped++;
+    }
+    if (*cursor >= length) *cursor = 0;
+    return dropped;
+}
+
+usize cauchy_gset_prune(cauchy_gset_t* set, const cauchy_gset_t* covered,
+                        usize* cursor, usize budget) {
+    if (!set || !covered || !cursor || set == covered) return 0;
+    usize dropped;
+    if (set->views) {
+        dropped = prune_log(set, covered, cursor, budget);
+    } else {
+        prune_sweep_t sweep = { .set = set, .covered = covered };
+        dropped = cauchy_htable_sweep(&set->index, cursor, budget ? budget : SIZE_MAX,
+                                      drop_covered, &sweep);
+    }
+    dropped += prune_base(set, covered, budget);
+    if (dropped) publish(set);
+    return dropped;
+}
+
 void cauchy_gset_iter_init(cauchy_gset_iter_t* iter, const cauchy_gset_t* set) {
     if (!iter) return;
     iter->set = set;
-    iter->bucket_idx = 0;
-    iter->current = set ? set->buckets[0] : NULL;
-    while (set && !iter->current && iter->bucket_idx < set->num_buckets - 1) {
-        iter->bucket_idx++;
-        iter->current = set->buckets[iter->bucket_idx];
-    }
+    iter->base_slot = 0;
+    cauchy_htable_iter_init(&iter->inner, set ? &set->index : NULL);
 }
 
 bool cauchy_gset_iter_next(cauchy_gset_iter_t* iter, const void** data, usize* size) {
-    if (!iter || !iter->set || !iter->current) return false;
+    if (!iter || !iter->set) return false;
+
+    const u8* d;
+    usize n;
+    u64 h;
+    if (!iter_item(iter, &d, &n, &h)) return false;
 
-    if (data) *data = iter->current->data;
-    if (size) *size = iter->current->size;
+    if (data) *data = d;
+    if (size) *size = n;
+    return true;
+}
 
-    iter->current = iter->current->next;
-    while (!iter->current && iter->bucket_idx < iter->set->num_buckets - 1) {
-        iter->bucket_idx++;
-        iter->current = iter->set->buckets[iter->bucket_idx];
+cauchy_result_t cauchy_gset_enable_views(cauchy_gset_t* set) {
+    if (!set) return CAUCHY_ERR_INVALID;
+    if (set->views) return CAUCHY_ERR_EXISTS;
+
+    cauchy_mvcc_t* m = malloc(sizeof(cauchy_mvcc_t));
+    if (!m) return CAUCHY_ERR_NOMEM;
+    cauchy_result_t res = cauchy_mvcc_init(m, NULL, NULL);
+    if (res != CAUCHY_OK) {
+        free(m);
+        return res;
+    }
+
+    /* Base slots live from the first version; dropped ones never were */
+    cauchy_atomic_u64_t* died = NULL;
+    if (set->base.capacity) {
+        died = malloc((usize)set->base.capacity * sizeof(cauchy_atomic_u64_t));
+        if (!died) res = CAUCHY_ERR_NOMEM;
+        for (u64 slot = 0; died && slot < set->base.capacity; slot++) {
+            atomic_init(&died[slot], cauchy_snapshot_shadowed(&set->base_dropped, slot) ? 1 : 0);
+        }
+    }
+    cauchy_htable_iter_t iter;
+    cauchy_htable_iter_init(&iter, &set->index);
+    cauchy_gset_elem_t* elem;
+    u32 slot;
+    while (res == CAUCHY_OK && (elem = cauchy_htable_iter_next(&iter)) != NULL) {
+        res = cauchy_mvcc_append(m, elem, &slot);
+    }
+    if (res != CAUCHY_OK) {
+        cauchy_mvcc_fini(m);
+        free(m);
+        free(died);
+        return res;
     }
+    set->views = m;
+    set->base_died = died;
+    publish(set);
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_gset_view_open(const cauchy_gset_t* set, cauchy_gset_view_t* view) {
+    if (!set || !view || !set->views) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_mvcc_view_open(set->views, &view->inner);
+    if (res != CAUCHY_OK) return res;
+    view->set = set;
+    view->base_slot = 0;
+    return CAUCHY_OK;
+}
+
+void cauchy_gset_view_close(cauchy_gset_view_t* view) {
+    if (!view || !view->set) return;
+    cauchy_mvcc_view_close(&view->inner);
+    view->set = NULL;
+}
+
+void cauchy_gset_view_rewind(cauchy_gset_view_t* view) {
+    if (!view) return;
+    cauchy_mvcc_view_rewind(&view->inner);
+    view->base_slot = 0;
+}
+
+/* Next element of the log, then of the base, as of the view's version */
+static bool view_item(cauchy_gset_view_t* view, const u8** data, usize* size, u64* hash) {
+    const cauchy_gset_elem_t* elem = cauchy_mvcc_view_next(&view->inner);
+    if (elem) {
+        *data = elem->data;
+        *size = elem->size;
+        *hash = elem->hash;
+        return true;
+    }
+    const cauchy_gset_t* set = view->set;
+    while (view->base_slot < set->base.capacity) {
+        u64 slot = view->base_slot++;
+        u64 died = atomic_load_explicit(&set->base_died[slot], memory_order_relaxed);
+        if (!cauchy_mvcc_view_sees(&view->inner, 1, died)) continue;
+        if (base_record(set, cauchy_snapshot_index_at(&set->base, slot), hash, data, size)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool cauchy_gset_view_next(cauchy_gset_view_t* view, const void** data, usize* size) {
+    if (!view || !view->set) return false;
+    const u8* d;
+    usize n;
+    u64 h;
+    if (!view_item(view, &d, &n, &h)) return false;
+    if (data) *data = d;
+    if (size) *size = n;
     return true;
 }
 
+usize cauchy_gset_view_count(const cauchy_gset_view_t* view) {
+    return view && view->set ? (usize)view->inner.meta[0] : 0;
+}
+
+u64 cauchy_gset_view_fingerprint(const cauchy_gset_view_t* view) {
+    return view && view->set ? view->inner.meta[1] : 0;
+}
+
+usize cauchy_gset_view_serialized_size(cauchy_gset_view_t* view) {
+    if (!view || !view->set) return 0;
+    usize total = sizeof(u64);
+    const u8* data;
+    usize size;
+    u64 h;
+    cauchy_gset_view_rewind(view);
+    while (view_item(view, &data, &size, &h)) total += sizeof(u64) + size;
+    cauchy_gset_view_rewind(view);
+    return total;
+}
+
+usize cauchy_gset_view_serialize(cauchy_gset_view_t* view, u8* buffer, usize size) {
+    if (!view || !view->set || !buffer) return 0;
+    usize needed = cauchy_gset_view_serialized_size(view);
+    if (size < needed) return 0;
+
+    u64 count = cauchy_gset_view_count(view);
+    memcpy(buffer, &count, sizeof(u64));
+    u8* p = buffer + sizeof(u64);
+    const u8* data;
+    usize n;
+    u64 h;
+    while (view_item(view, &data, &n, &h)) {
+        u64 len = n;
+        memcpy(p, &len, sizeof(u64));
+        memcpy(p + sizeof(u64), data, n);
+        p += sizeof(u64) + n;
+    }
+    cauchy_gset_view_rewind(view);
+    return needed;
+}
+
+cauchy_result_t cauchy_gset_view_digest(cauchy_gset_view_t* view, u32 depth, cauchy_merkle_t* out) {
+    if (!view || !view->set || !out) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_merkle_init(out, depth ? depth : CAUCHY_MERKLE_DEFAULT_DEPTH);
+    if (res != CAUCHY_OK) return res;
+    const u8* data;
+    usize size;
+    u64 h;
+    cauchy_gset_view_rewind(view);
+    while (view_item(view, &data, &size, &h)) cauchy_merkle_add(out, h, h);
+    cauchy_gset_view_rewind(view);
+    return CAUCHY_OK;
+}
+
+usize cauchy_gset_serialized_size(const cauchy_gset_t* set) {
+    if (!set) return 0;
+    usize total = sizeof(u64);
+    cauchy_gset_iter_t iter;
+    cauchy_gset_iter_init(&iter, set);
+    const u8* data;
+    usize size;
+    u64 h;
+    while (iter_item(&iter, &data, &size, &h)) total += sizeof(u64) + size;
+    return total;
+}
+
+usize cauchy_gset_serialize(const cauchy_gset_t* set, u8* buffer, usize size) {
+    if (!set || !buffer) return 0;
+    usize needed = cauchy_gset_serialized_size(set);
+    if (size < needed) return 0;
+
+    u64 count = cauchy_gset_count(set);
+    memcpy(buffer, &count, sizeof(u64));
+    u8* p = buffer + sizeof(u64);
+    cauchy_gset_iter_t iter;
+    cauchy_gset_iter_init(&iter, set);
+    const u8* data;
+    usize n;
+    u64 h;
+    while (iter_item(&iter, &data, &n, &h)) {
+        u64 len = n;
+        memcpy(p, &len, sizeof(u64));
+        memcpy(p + sizeof(u64), data, n);
+        p += sizeof(u64) + n;
+    }
+    return needed;
+}
+
+cauchy_result_t cauchy_gset_deserialize(cauchy_gset_t* set, const u8* buffer, usize size) {
+    if (!set || !buffer || size < sizeof(u64)) return CAUCHY_ERR_INVALID;
+    u64 count;
+    memcpy(&count, buffer, sizeof(u64));
+    const u8* p = buffer + sizeof(u64);
+    usize left = size - sizeof(u64);
+    for (u64 i = 0; i < count; i++) {
+        u64 len;
+        if (left < sizeof(u64)) return CAUCHY_ERR_INVALID;
+        memcpy(&len, p, sizeof(u64));
+        if (len == 0 || len > left - sizeof(u64)) return CAUCHY_ERR_INVALID;
+        cauchy_result_t res = cauchy_gset_add(set, p + sizeof(u64), (usize)len);
+        if (res != CAUCHY_OK) return res;
+        p += sizeof(u64) + len;
+        left -= sizeof(u64) + (usize)len;
+    }
+    return CAUCHY_OK;
+}
+
+/* Two passes over the elements: place every record, then write the
+ * slots followed by the records in the same order */
+cauchy_result_t cauchy_gset_snapshot_put(const cauchy_gset_t* set, cauchy_snapshot_writer_t* w) {
+    if (!set || !w) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_snapshot_writer_align(w);
+    if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put_u64(w, set->fingerprint);
+    if (res != CAUCHY_OK) return res;
+
+    cauchy_snapshot_index_builder_t b;
+    res = cauchy_snapshot_index_builder_init(&b, cauchy_gset_count(set));
+    if (res != CAUCHY_OK) return res;
+
+    cauchy_gset_iter_t iter;
+    const u8* data;
+    usize size;
+    u64 h;
+    cauchy_gset_iter_init(&iter, set);
+    while (iter_item(&iter, &data, &size, &h)) {
+        cauchy_snapshot_index_builder_place(&b, h, 2 * sizeof(u64) + size);
+    }
+    res = cauchy_snapshot_index_builder_write(&b, w);
+    cauchy_gset_iter_init(&iter, set);
+    while (res == CAUCHY_OK && iter_item(&iter, &data, &size, &h)) {
+        u64 head[2] = { h, size };
+        res = cauchy_snapshot_writer_put(w, head, sizeof(head));
+        if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put(w, data, size);
+        if (res == CAUCHY_OK) res = cauchy_snapshot_writer_align(w);
+    }
+    cauchy_snapshot_index_builder_fini(&b);
+    return res;
+}
+
+cauchy_result_t cauchy_gset_snapshot_attach(cauchy_gset_t* set, cauchy_snapshot_t* snap,
+                                            const u8* data, usize size) {
+    if (!set || !snap || !data) return CAUCHY_ERR_INVALID;
+    if (set->snapshot || set->views || cauchy_htable_count(&set->index)) return CAUCHY_ERR_EXISTS;
+    if (size < sizeof(u64)) return CAUCHY_ERR_INVALID;
+
+    cauchy_snapshot_index_t base;
+    cauchy_result_t res = cauchy_snapshot_index_parse(&base, data + sizeof(u64),
+                                                      size - sizeof(u64));
+    if (res != CAUCHY_OK) return res;
+
+    memcpy(&set->fingerprint, data, sizeof(u64));
+    set->base = base;
+    set->base_count = (usize)base.count;
+    set->base_cursor = 0;
+    set->base_dropped.capacity = base.capacity;
+    set->snapshot = cauchy_snapshot_retain(snap);
+    if (set->digest) {
+        cauchy_gset_iter_t iter;
+        const u8* d;
+        usize n;
+        u64 h;
+        cauchy_gset_iter_init(&iter, set);
+        while (iter_item(&iter, &d, &n, &h)) cauchy_merkle_add(set->digest, h, h);
+    }
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_gset_snapshot_save(const cauchy_gset_t* set, cauchy_snapshot_writer_t* w,
+                                          u64 id) {
+    if (!set || !w) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_snapshot_writer_begin(w, CAUCHY_SNAPSHOT_G_SET, id);
+    if (res != CAUCHY_OK) return res;
+    res = cauchy_gset_snapshot_put(set, w);
+    cauchy_result_t end = cauchy_snapshot_writer_end(w);
+    return res != CAUCHY_OK ? res : end;
+}
+
+cauchy_result_t cauchy_gset_snapshot_load(cauchy_gset_t* set, cauchy_snapshot_t* snap, u64 id) {
+    const u8* data;
+    usize size;
+    cauchy_result_t res = cauchy_snapshot_find(snap, CAUCHY_SNAPSHOT_G_SET, id, &data, &size);
+    if (res != CAUCHY_OK) return res;
+    return cauchy_gset_snapshot_attach(set, snap, data, size);
+}
+
 cauchy_result_t cauchy_gset_add_string(cauchy_gset_t* set, const char* str) {
     if (!str) return CAUCHY_ERR_INVALID;
     return cauchy_gset_add(set, str, strlen(str) + 1);
@@ -195,6 +970,8 @@ bool cauchy_gset_contains_string(const cauchy_gset_t* set, const char* str) {
 
 void cauchy_gset_debug_print(const cauchy_gset_t* set, const char* label) {
     if (!set) { fprintf(stderr, "%s: (null)\n", label ? label : "gset"); return; }
-    fprintf(stderr, "%s: count=%zu\n", label ? label : "gset", set->count);
+    fprintf(stderr, "%s: count=%zu capacity=%zu mapped=%zu%s\n", label ? label : "gset",
+            cauchy_htable_count(&set->index), set->index.cur.capacity, set->base_count,
+            set->index.old.slots ? " (resizing)" : "");
 }
 
@@ -0,0 +1,601 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * LWW-Map Implementation
+ */
+
+#include "cauchy/crdt/lww_map.h"
+#include "cauchy/stats.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* Largest bucket table the segments can address */
+#define LWW_MAP_MAX_BUCKETS (1ULL << (CAUCHY_LWW_MAP_SEGMENTS - 1))
+
+typedef cauchy_lww_map_node_t    map_node_t;
+typedef cauchy_lww_map_version_t map_version_t;
+
+#define HP CAUCHY_LWW_MAP_HAZARD_SLOT
+
+static u64 hash_key(const void* data, usize size) {
+    const u8* bytes = (const u8*)data;
+    u64 hash = 14695981039346656037ULL;
+    for (usize i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    /* Buckets are the low bits: finish with a full avalanche */
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+CAUCHY_INLINE u64 reverse_bits(u64 x) {
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return __builtin_bswap64(x);
+}
+
+/* Keys sort after the sentinel of every bucket they can fall into: the
+ * set top bit reverses into the low bit, which sentinels leave clear. */
+CAUCHY_INLINE u64 key_order(u64 hash) { return reverse_bits(hash | (1ULL << 63)); }
+CAUCHY_INLINE u64 sentinel_order(u64 bucket) { return reverse_bits(bucket); }
+CAUCHY_INLINE bool is_sentinel(const map_node_t* n) { return (n->order & 1) == 0; }
+
+CAUCHY_INLINE map_node_t* node_next(const map_node_t* n) {
+    return cauchy_atomic_load_ptr(&n->next);
+}
+
+/* Later timestamp wins, higher node id on a tie */
+CAUCHY_INLINE bool version_wins(const map_version_t* a, const map_version_t* b) {
+    return a->reg.timestamp > b->reg.timestamp ||
+           (a->reg.timestamp == b->reg.timestamp && a->reg.node_id > b->reg.node_id);
+}
+
+static map_version_t* version_alloc(void) {
+    map_version_t* v = cauchy_aligned_alloc(sizeof(map_version_t), CAUCHY_CACHE_LINE_SIZE);
+    if (v) {
+        cauchy_lww_init(&v->reg);
+        v->removed = false;
+    }
+    return v;
+}
+
+static void version_free(map_version_t* v) {
+    if (!v) return;
+    cauchy_lww_fini(&v->reg);
+    cauchy_aligned_free(v);
+}
+
+static void retire_version(void* node, void* ctx) {
+    (void)ctx;
+    version_free(node);
+}
+
+static map_version_t* version_create(const void* value, usize size, bool removed,
+                                     cauchy_timestamp_t timestamp, cauchy_node_id_t node_id) {
+    map_version_t* v = version_alloc();
+    if (!v) return NULL;
+    if (cauchy_lww_assign(&v->reg, value, size, timestamp, node_id) != CAUCHY_OK) {
+        version_free(v);
+        return NULL;
+    }
+    v->removed = removed;
+    return v;
+}
+
+/* Shares the value's blob with src */
+static map_version_t* version_clone(const map_version_t* src) {
+    map_version_t* v = version_alloc();
+    if (!v) return NULL;
+    cauchy_lww_copy(&v->reg, &src->reg);
+    v->removed = src->removed;
+    return v;
+}
+
+static map_node_t* node_create(u64 order, u64 hash, const void* key, usize key_size) {
+    map_node_t* n = malloc(sizeof(map_node_t) + key_size);
+    if (!n) return NULL;
+    n->order = order;
+    atomic_init(&n->next, NULL);
+    atomic_init(&n->version, NULL);
+    n->hash = hash;
+    n->key_size = key_size;
+    if (key_size) memcpy(n->key, key, key_size);
+    return n;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Split-ordered list                                                        */
+
+/* Scan from start for the node with this order (and key, unless looking
+ * for a sentinel). On a miss, *pred and *succ bracket where it belongs:
+ * at the end of its run of equal orders, so two racing inserts of the
+ * same key always contend for the same link. */
+static map_node_t* list_find(map_node_t* start, u64 order, u64 hash,
+                             const void* key, usize key_size,
+                             map_node_t** pred, map_node_t** succ) {
+    map_node_t* prev = start;
+    map_node_t* curr = node_next(prev);
+    while (curr && curr->order < order) {
+        prev = curr;
+        curr = node_next(curr);
+    }
+    while (curr && curr->order == order) {
+        if (is_sentinel(curr)) return curr;
+        if (curr->hash == hash && curr->key_size == key_size &&
+            memcmp(curr->key, key, key_size) == 0) {
+            return curr;
+        }
+        prev = curr;
+        curr = node_next(curr);
+    }
+    *pred = prev;
+    *succ = curr;
+    return NULL;
+}
+
+/* Link node after start unless an equal node is already there, which is
+ * returned instead */
+static map_node_t* list_insert(map_node_t* start, map_node_t* node) {
+    for (;;) {
+        map_node_t* pred;
+        map_node_t* succ;
+        map_node_t* found = list_find(start, node->order, node->hash,
+                                      node->key, node->key_size, &pred, &succ);
+        if (found) return found;
+        cauchy_atomic_store_ptr(&node->next, succ);
+        void* expected = succ;
+        if (cauchy_atomic_cas_ptr(&pred->next, &expected, node)) return node;
+    }
+}
+
+/* Bucket b lives in segment floor(log2(b + 1)) */
+static cauchy_atomic_ptr_t* bucket_slot(const cauchy_lww_map_t* map, u64 bucket) {
+    u64 idx = bucket + 1;
+    u32 seg = 63 - (u32)__builtin_clzll(idx);
+    cauchy_atomic_ptr_t* segment = cauchy_atomic_load_ptr(&map->segments[seg]);
+    if (CAUCHY_UNLIKELY(!segment)) {
+        cauchy_atomic_ptr_t* fresh = calloc((usize)1 << seg, sizeof(cauchy_atomic_ptr_t));
+        if (!fresh) return NULL;
+        void* expected = NULL;
+        cauchy_lww_map_t* m = (cauchy_lww_map_t*)map;
+        if (cauchy_atomic_cas_ptr(&m->segments[seg], &expected, fresh)) {
+            segment = fresh;
+        } else {
+            free(fresh);
+            segment = expected;
+        }
+    }
+    return &segment[idx - (1ULL << seg)];
+}
+
+/* Sentinel to start a search for bucket from, splicing it into the list
+ * on first use. If memory runs out the parent's sentinel still precedes
+ * every key of the bucket, so lookups only get longer. */
+static map_node_t* get_bucket(const cauchy_lww_map_t* map, u64 bucket) {
+    if (bucket == 0) return map->head;
+
+    cauchy_atomic_ptr_t* slot = bucket_slot(map, bucket);
+    map_node_t* sentinel = slot ? cauchy_atomic_load_ptr(slot) : NULL;
+    if (CAUCHY_LIKELY(sentinel != NULL)) return sentinel;
+
+    u64 parent = bucket & ~(1ULL << (63 - __builtin_clzll(bucket)));
+    map_node_t* start = get_bucket(map, parent);
+    if (!slot) return start;
+
+    map_node_t* fresh = node_create(sentinel_order(bucket), 0, NULL, 0);
+    if (!fresh) return start;
+    sentinel = list_insert(start, fresh);
+    if (sentinel != fresh) free(fresh);
+    cauchy_atomic_store_ptr(slot, sentinel);
+    return sentinel;
+}
+
+static map_node_t* lookup(const cauchy_lww_map_t* map, const void* key, usize key_size) {
+    u64 hash = hash_key(key, key_size);
+    u64 buckets = cauchy_atomic_load_u64(&map->bucket_count);
+    map_node_t* pred;
+    map_node_t* succ;
+    return list_find(get_bucket(map, hash & (buckets - 1)), key_order(hash), hash,
+                     key, key_size, &pred, &succ);
+}
+
+static void maybe_grow(cauchy_lww_map_t* map, u64 keys) {
+    u64 buckets = cauchy_atomic_load_u64(&map->bucket_count);
+    if (keys > buckets * CAUCHY_LWW_MAP_LOAD_FACTOR && buckets < LWW_MAP_MAX_BUCKETS) {
+        cauchy_atomic_cas_u64(&map->bucket_count, &buckets, buckets * 2);
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+/* Writes                                                                    */
+
+/* Install v as the version of node if it wins: one CAS, retried only when
+ * another write got in first. Consumes v: once published it may be
+ * replaced and reclaimed at any moment. */
+static void swap_version(cauchy_lww_map_t* map, map_node_t* node,
+                         map_version_t* v, bool* won) {
+    bool removed = v->removed;
+    for (;;) {
+        map_version_t* cur = cauchy_hazard_protect(map->domain, HP,
+                                                   &node->version);
+        if (cur && !version_wins(v, cur)) {
+            cauchy_hazard_clear(map->domain, HP);
+            version_free(v);
+            *won = false;
+            return;
+        }
+        void* expected = cur;
+        if (cauchy_atomic_cas_ptr(&node->version, &expected, v)) {
+            cauchy_hazard_clear(map->domain, HP);
+            bool was_live = cur && !cur->removed;
+            if (was_live && removed) {
+                cauchy_atomic_fetch_sub_u64(&map->live_count, 1);
+            } else if (!was_live && !removed) {
+                cauchy_atomic_fetch_add_u64(&map->live_count, 1);
+            }
+            if (cur) cauchy_hazard_retire(map->domain, cur, retire_version, NULL);
+            *won = true;
+            return;
+        }
+    }
+}
+
+/* Apply one write (consumes v). A new key is linked with its first
+ * version already in place, so that is a single CAS as well. */
+static cauchy_result_t apply(cauchy_lww_map_t* map, const void* key, usize key_size,
+                             map_version_t* v, bool* won) {
+    u64 hash = hash_key(key, key_size);
+    u64 order = key_order(hash);
+    u64 buckets = cauchy_atomic_load_u64(&map->bucket_count);
+    map_node_t* start = get_bucket(map, hash & (buckets - 1));
+    map_node_t* fresh = NULL;
+    bool removed = v->removed;
+
+    for (;;) {
+        map_node_t* pred;
+        map_node_t* succ;
+        map_node_t* found = list_find(start, order, hash, key, key_size, &pred, &succ);
+        if (found) {
+            free(fresh);
+            swap_version(map, found, v, won);
+            return CAUCHY_OK;
+        }
+        if (!fresh) {
+            fresh = node_create(order, hash, key, key_size);
+            if (!fresh) {
+                version_free(v);
+                return CAUCHY_ERR_NOMEM;
+            }
+            cauchy_atomic_store_ptr(&fresh->version, v);
+        }
+        cauchy_atomic_store_ptr(&fresh->next, succ);
+        void* expected = succ;
+        if (cauchy_atomic_cas_ptr(&pred->next, &expected, fresh)) {
+            if (!removed) cauchy_atomic_fetch_add_u64(&map->live_count, 1);
+            maybe_grow(map, cauchy_atomic_fetch_add_u64(&map->key_count, 1) + 1);
+            *won = true;
+            return CAUCHY_OK;
+        }
+    }
+}
+
+static cauchy_result_t map_write(cauchy_lww_map_t* map, const void* key, usize key_size,
+                             const void* value, usize value_size, bool removed,
+                             cauchy_timestamp_t timestamp, cauchy_node_id_t node_id,
+                             cauchy_lww_map_t* delta) {
+    if (!map || (!key && key_size) || (!value && value_size)) return CAUCHY_ERR_INVALID;
+    if (value_size > CAUCHY_LWW_MAX_VALUE_SIZE) return CAUCHY_ERR_FULL;
+
+    map_version_t* v = version_create(value, value_size, removed, timestamp, node_id);
+    if (!v) return CAUCHY_ERR_NOMEM;
+    map_version_t* copy = NULL;
+    if (delta) {
+        copy = version_clone(v);
+        if (!copy) {
+            version_free(v);
+            return CAUCHY_ERR_NOMEM;
+        }
+    }
+
+    bool won = false;
+    cauchy_result_t res = apply(map, key, key_size, v, &won);
+    if (!copy) return res;
+    if (res != CAUCHY_OK || !won) {
+        version_free(copy);
+        return res;
+    }
+    return apply(delta, key, key_size, copy, &won);
+}
+
+cauchy_lww_map_t* cauchy_lww_map_create(usize initial_capacity,
+                                        cauchy_hazard_domain_t* domain) {
+    cauchy_lww_map_t* map = cauchy_aligned_alloc(sizeof(cauchy_lww_map_t),
+                                                 CAUCHY_CACHE_LINE_SIZE);
+    if (!map) return NULL;
+    memset(map, 0, sizeof(cauchy_lww_map_t));
+
+    u64 buckets = 2;
+    while (buckets * CAUCHY_LWW_MAP_LOAD_FACTOR < initial_capacity &&
+           buckets < LWW_MAP_MAX_BUCKETS) {
+        buckets *= 2;
+    }
+    atomic_init(&map->bucket_count, buckets);
+    atomic_init(&map->key_count, 0);
+    atomic_init(&map->live_count, 0);
+
+    map->head = node_create(sentinel_order(0), 0, NULL, 0);
+    cauchy_atomic_ptr_t* slot = map->head ? bucket_slot(map, 0) : NULL;
+    if (!slot) goto fail;
+    cauchy_atomic_store_ptr(slot, map->head);
+
+    map->domain = domain;
+    if (!domain) {
+        map->domain = cauchy_hazard_domain_create();
+        if (!map->domain) goto fail;
+        map->owns_domain = true;
+    }
+    return map;
+
+fail:
+    free(map->head);
+    free(cauchy_atomic_load_ptr(&map->segments[0]));
+    cauchy_aligned_free(map);
+    return NULL;
+}
+
+void cauchy_lww_map_destroy(cauchy_lww_map_t* map) {
+    if (!map) return;
+
+    map_node_t* n = map->head;
+    while (n) {
+        map_node_t* next = node_next(n);
+        version_free(cauchy_atomic_load_ptr(&n->version));
+        free(n);
+        n = next;
+    }
+    for (u32 i = 0; i < CAUCHY_LWW_MAP_SEGMENTS; i++) {
+        free(cauchy_atomic_load_ptr(&map->segments[i]));
+    }
+    if (map->owns_domain) cauchy_hazard_domain_destroy(map->domain);
+    cauchy_aligned_free(map);
+}
+
+cauchy_result_t cauchy_lww_map_set(cauchy_lww_map_t* map,
+                                   const void* key, usize key_size,
+                                   const void* value, usize value_size,
+                                   cauchy_timestamp_t timestamp,
+                                   cauchy_node_id_t node_id) {
+    return map_write(map, key, key_size, value, value_size, false, timestamp, node_id, NULL);
+}
+
+cauchy_result_t cauchy_lww_map_remove(cauchy_lww_map_t* map,
+                                      const void* key, usize key_size,
+                                      cauchy_timestamp_t timestamp,
+                                      cauchy_node_id_t node_id) {
+    return map_write(map, key, key_size, NULL, 0, true, timestamp, node_id, NULL);
+}
+
+cauchy_result_t cauchy_lww_map_set_delta(cauchy_lww_map_t* map,
+                                         const void* key, usize key_size,
+                                         const void* value, usize value_size,
+                                         cauchy_timestamp_t timestamp,
+                                         cauchy_node_id_t node_id,
+                                         cauchy_lww_map_t* delta) {
+    if (!delta) return CAUCHY_ERR_INVALID;
+    return map_write(map, key, key_size, value, value_size, false, timestamp, node_id, delta);
+}
+
+cauchy_result_t cauchy_lww_map_remove_delta(cauchy_lww_map_t* map,
+                                            const void* key, usize key_size,
+                                            cauchy_timestamp_t timestamp,
+                                            cauchy_node_id_t node_id,
+                                            cauchy_lww_map_t* delta) {
+    if (!delta) return CAUCHY_ERR_INVALID;
+    return map_write(map, key, key_size, NULL, 0, true, timestamp, node_id, delta);
+}
+
+/* ------------------------------------------------------------------------ */
+/* Reads                                                                     */
+
+/* Copy a live version of node into out (if given); false for a tombstone.
+ * The version's blob reference keeps the value alive while out takes its
+ * own. */
+static bool read_version(const cauchy_lww_map_t* map, const map_node_t* node,
+                         cauchy_lww_register_t* out) {
+    map_version_t* v = cauchy_hazard_protect(map->domain, HP,
+                                             (cauchy_atomic_ptr_t*)&node->version);
+    bool live = v && !v->removed;
+    if (live && out) cauchy_lww_copy(out, &v->reg);
+    cauchy_hazard_clear(map->domain, HP);
+    return live;
+}
+
+cauchy_result_t cauchy_lww_map_get(const cauchy_lww_map_t* map,
+                                   const void* key, usize key_size,
+                                   cauchy_lww_register_t* out) {
+    if (!map || !out || (!key && key_size)) return CAUCHY_ERR_INVALID;
+    const map_node_t* node = lookup(map, key, key_size);
+    if (!node || !read_version(map, node, out)) {
+        return CAUCHY_ERR_NOTFOUND;
+    }
+    return CAUCHY_OK;
+}
+
+bool cauchy_lww_map_contains(const cauchy_lww_map_t* map, const void* key, usize key_size) {
+    if (!map || (!key && key_size)) return false;
+    const map_node_t* node = lookup(map, key, key_size);
+    return node && read_version(map, node, NULL);
+}
+
+usize cauchy_lww_map_count(const cauchy_lww_map_t* map) {
+    return map ? (usize)cauchy_atomic_load_u64(&map->live_count) : 0;
+}
+
+bool cauchy_lww_map_is_empty(const cauchy_lww_map_t* map) {
+    return cauchy_lww_map_count(map) == 0;
+}
+
+/* Next key node after n, in list order */
+static const map_node_t* next_key(const map_node_t* n) {
+    do {
+        n = node_next(n);
+    } while (n && is_sentinel(n));
+    return n;
+}
+
+cauchy_result_t cauchy_lww_map_merge(cauchy_lww_map_t* dst, const cauchy_lww_map_t* src) {
+    if (!dst || !src) return CAUCHY_ERR_INVALID;
+    if (dst == src) return CAUCHY_OK;
+
+    u64 start = CAUCHY_STAT_NOW();
+    u64 visited = 0;
+    for (const map_node_t* n = next_key(src->head); n; n = next_key(n)) {
+        visited++;
+        /* Copy out first: apply needs the hazard slot for dst */
+        map_version_t* v = NULL;
+        map_version_t* cur = cauchy_hazard_protect(src->domain, HP,
+                                                   (cauchy_atomic_ptr_t*)&n->version);
+        if (cur) v = version_clone(cur);
+        cauchy_hazard_clear(src->domain, HP);
+        if (!cur) continue;
+        if (!v) return CAUCHY_ERR_NOMEM;
+
+        bool won;
+        cauchy_result_t res = apply(dst, n->key, n->key_size, v, &won);
+        if (res != CAUCHY_OK) return res;
+    }
+    u64 keys = cauchy_atomic_load_u64(&dst->key_count);
+    CAUCHY_STAT_MERGE(CAUCHY_STAT_CRDT_LWW_MAP, visited, CAUCHY_STAT_NOW() - start,
+                      keys, keys - cauchy_atomic_load_u64(&dst->live_count));
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_lww_map_merge_delta(cauchy_lww_map_t* dst, const cauchy_lww_map_t* delta) {
+    return cauchy_lww_map_merge(dst, delta);
+}
+
+bool cauchy_lww_map_equals(const cauchy_lww_map_t* a, const cauchy_lww_map_t* b) {
+    if (!a || !b) return a == b;
+    if (cauchy_lww_map_count(a) != cauchy_lww_map_count(b)) return false;
+
+    bool equal = true;
+    cauchy_lww_register_t va, vb;
+    cauchy_lww_init(&va);
+    cauchy_lww_init(&vb);
+    for (const map_node_t* n = next_key(a->head); n && equal; n = next_key(n)) {
+        if (!read_version(a, n, &va)) continue;
+        const map_node_t* m = lookup(b, n->key, n->key_size);
+        equal = m && read_version(b, m, &vb) && cauchy_lww_equals(&va, &vb);
+    }
+    cauchy_lww_fini(&va);
+    cauchy_lww_fini(&vb);
+    return equal;
+}
+
+void cauchy_lww_map_iter_init(cauchy_lww_map_iter_t* iter, const cauchy_lww_map_t* map) {
+    if (!iter) return;
+    iter->map = map;
+    iter->node = map ? map->head : NULL;
+}
+
+bool cauchy_lww_map_iter_next(cauchy_lww_map_iter_t* iter,
+                              const void** key, usize* key_size,
+                              cauchy_lww_register_t* value) {
+    if (!iter || !iter->node) return false;
+    for (const map_node_t* n = next_key(iter->node); n; n = next_key(n)) {
+        iter->node = n;
+        if (!read_version(iter->map, n, value)) continue;
+        if (key) *key = n->key;
+        if (key_size) *key_size = n->key_size;
+        return true;
+    }
+    iter->node = NULL;
+    return false;
+}
+
+cauchy_result_t cauchy_lww_map_set_string(cauchy_lww_map_t* map, const char* key,
+                                          const char* value, cauchy_timestamp_t timestamp,
+                                          cauchy_node_id_t node_id) {
+    if (!key || !value) return CAUCHY_ERR_INVALID;
+    return cauchy_lww_map_set(map, key, strlen(key), value, strlen(value), timestamp, node_id);
+}
+
+cauchy_result_t cauchy_lww_map_remove_string(cauchy_lww_map_t* map, const char* key,
+                                             cauchy_timestamp_t timestamp,
+                                             cauchy_node_id_t node_id) {
+    if (!key) return CAUCHY_ERR_INVALID;
+    return cauchy_lww_map_remove(map, key, strlen(key), timestamp, node_id);
+}
+
+bool cauchy_lww_map_contains_string(const cauchy_lww_map_t* map, const char* key) {
+    return key && cauchy_lww_map_contains(map, key, strlen(key));
+}
+
+/* Section body: one record per key, tombstones included: key, then
+ * timestamp, node id and tombstone flag, then value. Records are written
+ * while the version is protected, so a concurrent writer only decides
+ * whether the old or the new version lands in the file. */
+cauchy_result_t cauchy_lww_map_snapshot_save(const cauchy_lww_map_t* map,
+                                             cauchy_snapshot_writer_t* w, u64 id) {
+    if (!map || !w) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_snapshot_writer_begin(w, CAUCHY_SNAPSHOT_LWW_MAP, id);
+    if (res != CAUCHY_OK) return res;
+
+    for (const map_node_t* n = next_key(map->head); n && res == CAUCHY_OK; n = next_key(n)) {
+        map_version_t* v = cauchy_hazard_protect(map->domain, HP,
+                                                 (cauchy_atomic_ptr_t*)&n->version);
+        if (v) {
+            usize size;
+            const void* value = cauchy_lww_get(&v->reg, &size);
+            u64 meta[3] = { v->reg.timestamp, v->reg.node_id, v->removed };
+            res = cauchy_snapshot_writer_put_blob(w, n->key, n->key_size);
+            if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put(w, meta, sizeof(meta));
+            if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put_blob(w, value, value ? size : 0);
+        }
+        cauchy_hazard_clear(map->domain, HP);
+    }
+    cauchy_result_t end = cauchy_snapshot_writer_end(w);
+    return res != CAUCHY_OK ? res : end;
+}
+
+cauchy_result_t cauchy_lww_map_snapshot_load(cauchy_lww_map_t* map, cauchy_snapshot_t* snap,
+                                             u64 id) {
+    if (!map) return CAUCHY_ERR_INVALID;
+    const u8* data;
+    usize size;
+    cauchy_result_t res = cauchy_snapshot_find(snap, CAUCHY_SNAPSHOT_LWW_MAP, id, &data, &size);
+    if (res != CAUCHY_OK) return res;
+
+    cauchy_snapshot_cursor_t cur;
+    cauchy_snapshot_cursor_init(&cur, data, size);
+    while (cur.left && res == CAUCHY_OK) {
+        const u8* key;
+        const u8* value;
+        usize key_size, value_size;
+        u64 ts, node, removed;
+        if (!cauchy_snapshot_get_blob(&cur, &key, &key_size) ||
+            !cauchy_snapshot_get_u64(&cur, &ts) || !cauchy_snapshot_get_u64(&cur, &node) ||
+            !cauchy_snapshot_get_u64(&cur, &removed) ||
+            !cauchy_snapshot_get_blob(&cur, &value, &value_size)) {
+            return CAUCHY_ERR_INVALID;
+        }
+        res = removed
+            ? cauchy_lww_map_remove(map, key, key_size, ts, node)
+            : cauchy_lww_map_set(map, key, key_size, value, value_size, ts, node);
+    }
+    return res;
+}
+
+void cauchy_lww_map_debug_print(const cauchy_lww_map_t* map, const char* label) {
+    if (!map) { fprintf(stderr, "%s: (null)\n", label ? label : "lww_map"); return; }
+    fprintf(stderr, "%s: live=%zu keys=%llu buckets=%llu\n",
+            label ? label : "lww_map", cauchy_lww_map_count(map),
+            (unsigned long long)cauchy_atomic_load_u64(&map->key_count),
+            (unsigned long long)cauchy_atomic_load_u64(&map->bucket_count));
+}
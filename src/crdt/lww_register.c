@@ -4,14 +4,71 @@
  */
 
 #include "cauchy/crdt/lww_register.h"
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+struct cauchy_lww_blob {
+    cauchy_atomic_u32_t refs;
+    usize               size;
+    u8                  data[];
+};
+
+static cauchy_lww_blob_t* blob_create(const void* data, usize size) {
+    cauchy_lww_blob_t* blob = malloc(sizeof(cauchy_lww_blob_t) + size);
+    if (!blob) return NULL;
+    atomic_init(&blob->refs, 1);
+    blob->size = size;
+    memcpy(blob->data, data, size);
+    return blob;
+}
+
+CAUCHY_INLINE void blob_retain(cauchy_lww_blob_t* blob) {
+    if (blob) cauchy_atomic_fetch_add_u32(&blob->refs, 1);
+}
+
+CAUCHY_INLINE void blob_release(cauchy_lww_blob_t* blob) {
+    if (blob && cauchy_atomic_fetch_sub_u32(&blob->refs, 1) == 1) free(blob);
+}
+
+CAUCHY_INLINE bool write_wins(const cauchy_lww_register_t* reg,
+                              cauchy_timestamp_t timestamp, cauchy_node_id_t node_id) {
+    return timestamp > reg->timestamp ||
+           (timestamp == reg->timestamp && node_id > reg->node_id);
+}
+
+cauchy_result_t cauchy_lww_assign(cauchy_lww_register_t* reg,
+                                  const void* value, usize value_size,
+                                  cauchy_timestamp_t timestamp, cauchy_node_id_t node_id) {
+    if (!reg || (!value && value_size)) return CAUCHY_ERR_INVALID;
+    if (value_size > CAUCHY_LWW_MAX_VALUE_SIZE) return CAUCHY_ERR_FULL;
+
+    cauchy_lww_blob_t* blob = NULL;
+    if (value_size > CAUCHY_LWW_INLINE_SIZE) {
+        blob = blob_create(value, value_size);
+        if (!blob) return CAUCHY_ERR_NOMEM;
+    } else if (value_size > 0) {
+        memcpy(reg->inline_value, value, value_size);
+    }
+    blob_release(reg->blob);
+    reg->blob = blob;
+    reg->value_size = value_size;
+    reg->timestamp = timestamp;
+    reg->node_id = node_id;
+    return CAUCHY_OK;
+}
+
 void cauchy_lww_init(cauchy_lww_register_t* reg) {
     if (!reg) return;
     memset(reg, 0, sizeof(cauchy_lww_register_t));
 }
 
+void cauchy_lww_fini(cauchy_lww_register_t* reg) {
+    if (!reg) return;
+    blob_release(reg->blob);
+    cauchy_lww_init(reg);
+}
+
 cauchy_lww_register_t* cauchy_lww_create(void) {
     cauchy_lww_register_t* reg = cauchy_aligned_alloc(
         sizeof(cauchy_lww_register_t), CAUCHY_CACHE_LINE_SIZE);
@@ -20,6 +77,8 @@ cauchy_lww_register_t* cauchy_lww_create(void) {
 }
 
 void cauchy_lww_destroy(cauchy_lww_register_t* reg) {
+    if (!reg) return;
+    blob_release(reg->blob);
     cauchy_aligned_free(reg);
 }
 
@@ -28,28 +87,36 @@ cauchy_result_t cauchy_lww_set(cauchy_lww_register_t* reg,
                                usize value_size,
                                cauchy_timestamp_t timestamp,
                                cauchy_node_id_t node_id) {
-    if (!reg) return CAUCHY_ERR_INVALID;
+    if (!reg || (!value && value_size)) return CAUCHY_ERR_INVALID;
     if (value_size > CAUCHY_LWW_MAX_VALUE_SIZE) return CAUCHY_ERR_FULL;
     
-    if (timestamp > reg->timestamp ||
-        (timestamp == reg->timestamp && node_id > reg->node_id)) {
-        if (value && value_size > 0) {
-            memcpy(reg->value, value, value_size);
-        }
-        reg->value_size = value_size;
-        reg->timestamp = timestamp;
-        reg->node_id = node_id;
+    if (write_wins(reg, timestamp, node_id)) {
+        return cauchy_lww_assign(reg, value, value_size, timestamp, node_id);
     }
     return CAUCHY_OK;
 }
 
+cauchy_result_t cauchy_lww_set_delta(cauchy_lww_register_t* reg,
+                                     const void* value,
+                                     usize value_size,
+                                     cauchy_timestamp_t timestamp,
+                                     cauchy_node_id_t node_id,
+                                     cauchy_lww_register_t* delta) {
+    if (!reg || !delta) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_lww_set(reg, value, value_size, timestamp, node_id);
+    if (res == CAUCHY_OK && reg->timestamp == timestamp && reg->node_id == node_id) {
+        cauchy_lww_merge(delta, reg);
+    }
+    return res;
+}
+
 const void* cauchy_lww_get(const cauchy_lww_register_t* reg, usize* out_size) {
     if (!reg || reg->value_size == 0) {
         if (out_size) *out_size = 0;
         return NULL;
     }
     if (out_size) *out_size = reg->value_size;
-    return reg->value;
+    return reg->blob ? reg->blob->data : reg->inline_value;
 }
 
 cauchy_timestamp_t cauchy_lww_timestamp(const cauchy_lww_register_t* reg) {
@@ -62,22 +129,29 @@ bool cauchy_lww_has_value(const cauchy_lww_register_t* reg) {
 
 void cauchy_lww_merge(cauchy_lww_register_t* dst, const cauchy_lww_register_t* src) {
     if (!dst || !src) return;
-    if (src->timestamp > dst->timestamp ||
-        (src->timestamp == dst->timestamp && src->node_id > dst->node_id)) {
+    if (write_wins(dst, src->timestamp, src->node_id)) {
         cauchy_lww_copy(dst, src);
     }
 }
 
+void cauchy_lww_merge_delta(cauchy_lww_register_t* dst, const cauchy_lww_register_t* delta) {
+    cauchy_lww_merge(dst, delta);
+}
+
 bool cauchy_lww_equals(const cauchy_lww_register_t* a, const cauchy_lww_register_t* b) {
     if (!a || !b) return a == b;
     if (a->timestamp != b->timestamp) return false;
     if (a->node_id != b->node_id) return false;
     if (a->value_size != b->value_size) return false;
-    return memcmp(a->value, b->value, a->value_size) == 0;
+    if (a->value_size == 0) return true;
+    if (a->blob == b->blob && a->blob) return true;
+    return memcmp(cauchy_lww_get(a, NULL), cauchy_lww_get(b, NULL), a->value_size) == 0;
 }
 
 void cauchy_lww_copy(cauchy_lww_register_t* dst, const cauchy_lww_register_t* src) {
-    if (!dst || !src) return;
+    if (!dst || !src || dst == src) return;
+    blob_retain(src->blob);
+    blob_release(dst->blob);
     memcpy(dst, src, sizeof(cauchy_lww_register_t));
 }
 
@@ -104,7 +178,7 @@ usize cauchy_lww_serialize(const cauchy_lww_register_t* reg, u8* buffer, usize s
     memcpy(buffer + offset, &reg->node_id, sizeof(reg->node_id)); offset += sizeof(reg->node_id);
     memcpy(buffer + offset, &reg->value_size, sizeof(reg->value_size)); offset += sizeof(reg->value_size);
     if (reg->value_size > 0) {
-        memcpy(buffer + offset, reg->value, reg->value_size);
+        memcpy(buffer + offset, cauchy_lww_get(reg, NULL), reg->value_size);
     }
     return needed;
 }
@@ -115,17 +189,51 @@ cauchy_result_t cauchy_lww_deserialize(cauchy_lww_register_t* reg,
     usize min_size = sizeof(cauchy_timestamp_t) + sizeof(cauchy_node_id_t) + sizeof(usize);
     if (size < min_size) return CAUCHY_ERR_INVALID;
     
+    cauchy_timestamp_t timestamp;
+    cauchy_node_id_t node_id;
+    usize value_size;
     usize offset = 0;
-    memcpy(&reg->timestamp, buffer + offset, sizeof(reg->timestamp)); offset += sizeof(reg->timestamp);
-    memcpy(&reg->node_id, buffer + offset, sizeof(reg->node_id)); offset += sizeof(reg->node_id);
-    memcpy(&reg->value_size, buffer + offset, sizeof(reg->value_size)); offset += sizeof(reg->value_size);
+    memcpy(&timestamp, buffer + offset, sizeof(timestamp)); offset += sizeof(timestamp);
+    memcpy(&node_id, buffer + offset, sizeof(node_id)); offset += sizeof(node_id);
+    memcpy(&value_size, buffer + offset, sizeof(value_size)); offset += sizeof(value_size);
     
-    if (reg->value_size > CAUCHY_LWW_MAX_VALUE_SIZE) return CAUCHY_ERR_INVALID;
-    if (size < offset + reg->value_size) return CAUCHY_ERR_INVALID;
-    if (reg->value_size > 0) {
-        memcpy(reg->value, buffer + offset, reg->value_size);
+    if (value_size > CAUCHY_LWW_MAX_VALUE_SIZE) return CAUCHY_ERR_INVALID;
+    if (size - offset < value_size) return CAUCHY_ERR_INVALID;
+    return cauchy_lww_assign(reg, buffer + offset, value_size, timestamp, node_id);
+}
+
+cauchy_result_t cauchy_lww_snapshot_save(const cauchy_lww_register_t* reg,
+                                         cauchy_snapshot_writer_t* w, u64 id) {
+    if (!reg || !w) return CAUCHY_ERR_INVALID;
+    usize size = cauchy_lww_serialized_size(reg);
+    u8* buf = malloc(size);
+    if (!buf) return CAUCHY_ERR_NOMEM;
+    cauchy_lww_serialize(reg, buf, size);
+
+    cauchy_result_t res = cauchy_snapshot_writer_begin(w, CAUCHY_SNAPSHOT_LWW_REGISTER, id);
+    if (res == CAUCHY_OK) {
+        res = cauchy_snapshot_writer_put_blob(w, buf, size);
+        cauchy_result_t end = cauchy_snapshot_writer_end(w);
+        if (res == CAUCHY_OK) res = end;
     }
-    return CAUCHY_OK;
+    free(buf);
+    return res;
+}
+
+cauchy_result_t cauchy_lww_snapshot_load(cauchy_lww_register_t* reg, cauchy_snapshot_t* snap,
+                                         u64 id) {
+    if (!reg) return CAUCHY_ERR_INVALID;
+    const u8* data;
+    usize size;
+    cauchy_result_t res = cauchy_snapshot_find(snap, CAUCHY_SNAPSHOT_LWW_REGISTER, id, &data, &size);
+    if (res != CAUCHY_OK) return res;
+
+    cauchy_snapshot_cursor_t cur;
+    const u8* blob;
+    usize len;
+    cauchy_snapshot_cursor_init(&cur, data, size);
+    if (!cauchy_snapshot_get_blob(&cur, &blob, &len)) return CAUCHY_ERR_INVALID;
+    return cauchy_lww_deserialize(reg, blob, len);
 }
 
 cauchy_result_t cauchy_lww_set_u64(cauchy_lww_register_t* reg, u64 value,
@@ -162,3 +270,86 @@ void cauchy_lww_debug_print(const cauchy_lww_register_t* reg, const char* label)
             reg->value_size);
 }
 
+
+/* ------------------------------------------------------------------------ */
+/* Shared register                                                           */
+
+static void retire_snapshot(void* node, void* ctx) {
+    (void)ctx;
+    cauchy_lww_destroy(node);
+}
+
+cauchy_result_t cauchy_lww_shared_init(cauchy_lww_shared_t* shared,
+                                       cauchy_hazard_domain_t* domain) {
+    if (!shared || !domain) return CAUCHY_ERR_INVALID;
+    cauchy_lww_register_t* empty = cauchy_lww_create();
+    if (!empty) return CAUCHY_ERR_NOMEM;
+    atomic_init(&shared->current, empty);
+    shared->domain = domain;
+    return CAUCHY_OK;
+}
+
+void cauchy_lww_shared_fini(cauchy_lww_shared_t* shared) {
+    if (!shared) return;
+    cauchy_lww_destroy(cauchy_atomic_load_ptr(&shared->current));
+    cauchy_atomic_store_ptr(&shared->current, NULL);
+}
+
+/* Swap in next while it beats the published state: one CAS unless
+ * another writer got in between. Consumes next. */
+static void publish(cauchy_lww_shared_t* shared, cauchy_lww_register_t* next) {
+    for (;;) {
+        cauchy_lww_register_t* cur = cauchy_hazard_protect(shared->domain,
+                                                           CAUCHY_LWW_HAZARD_SLOT,
+                                                           &shared->current);
+        if (!write_wins(cur, next->timestamp, next->node_id)) {
+            cauchy_hazard_clear(shared->domain, CAUCHY_LWW_HAZARD_SLOT);
+            cauchy_lww_destroy(next);
+            return;
+        }
+        void* expected = cur;
+        bool swapped = cauchy_atomic_cas_ptr(&shared->current, &expected, next);
+        cauchy_hazard_clear(shared->domain, CAUCHY_LWW_HAZARD_SLOT);
+        if (swapped) {
+            cauchy_hazard_retire(shared->domain, cur, retire_snapshot, NULL);
+            return;
+        }
+    }
+}
+
+cauchy_result_t cauchy_lww_shared_set(cauchy_lww_shared_t* shared,
+                                      const void* value, usize value_size,
+                                      cauchy_timestamp_t timestamp,
+                                      cauchy_node_id_t node_id) {
+    if (!shared || (!value && value_size)) return CAUCHY_ERR_INVALID;
+    if (value_size > CAUCHY_LWW_MAX_VALUE_SIZE) return CAUCHY_ERR_FULL;
+
+    cauchy_lww_register_t* next = cauchy_lww_create();
+    if (!next) return CAUCHY_ERR_NOMEM;
+    cauchy_result_t res = cauchy_lww_assign(next, value, value_size, timestamp, node_id);
+    if (res != CAUCHY_OK) {
+        cauchy_lww_destroy(next);
+        return res;
+    }
+    publish(shared, next);
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_lww_shared_merge(cauchy_lww_shared_t* shared,
+                                        const cauchy_lww_register_t* src) {
+    if (!shared || !src) return CAUCHY_ERR_INVALID;
+    cauchy_lww_register_t* next = cauchy_lww_clone(src);
+    if (!next) return CAUCHY_ERR_NOMEM;
+    publish(shared, next);
+    return CAUCHY_OK;
+}
+
+void cauchy_lww_shared_read(const cauchy_lww_shared_t* shared, cauchy_lww_register_t* out) {
+    if (!shared || !out) return;
+    /* The snapshot's own blob reference keeps the blob alive while we
+     * take ours */
+    cauchy_lww_register_t* cur = cauchy_hazard_protect(shared->domain, CAUCHY_LWW_HAZARD_SLOT,
+                                                       (cauchy_atomic_ptr_t*)&shared->current);
+    cauchy_lww_copy(out, cur);
+    cauchy_hazard_clear(shared->domain, CAUCHY_LWW_HAZARD_SLOT);
+}
@@ -4,45 +4,48 @@
  */
 
 #include "cauchy/crdt/or_set.h"
+#include "cauchy/stats.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-static u64 hash_data(const void* data, usize size) {
-    const u8* bytes = (const u8*)data;
-    u64 hash = 14695981039346656037ULL;
-    for (usize i = 0; i < size; i++) {
-        hash ^= bytes[i];
-        hash *= 1099511628211ULL;
-    }
-    return hash;
-}
-
 cauchy_result_t cauchy_orset_init(cauchy_orset_t* set, usize initial_capacity,
                                    cauchy_node_id_t node_id) {
     if (!set) return CAUCHY_ERR_INVALID;
     if (initial_capacity == 0) initial_capacity = 16;
 
-    set->buckets = calloc(initial_capacity, sizeof(cauchy_orset_entry_t*));
-    if (!set->buckets) return CAUCHY_ERR_NOMEM;
+    cauchy_result_t res = cauchy_htable_init(&set->index, initial_capacity);
+    if (res != CAUCHY_OK) return res;
 
-    set->num_buckets = initial_capacity;
     set->entry_count = 0;
     set->active_count = 0;
     set->node_id = node_id;
     set->timestamp = 0;
 
     cauchy_pool_config_t cfg = {
-        .block_size = sizeof(cauchy_orset_entry_t) + 64,
+        .block_size = sizeof(cauchy_orset_entry_t) + CAUCHY_ORSET_INLINE_SIZE,
         .initial_blocks = 128,
         .max_blocks = 0,
         .alignment = sizeof(void*)
     };
     set->entry_pool = cauchy_pool_create(&cfg);
     if (!set->entry_pool) {
-        free(set->buckets);
+        cauchy_htable_destroy(&set->index);
         return CAUCHY_ERR_NOMEM;
     }
+    cauchy_arena_init(&set->payloads, 0);
+    set->digest = NULL;
+    set->fingerprint = 0;
+    set->live_fingerprint = 0;
+    cauchy_vclock_init(&set->clock, 0);
+    cauchy_vclock_init(&set->stable, 0);
+    set->gc_cursor = 0;
+    set->snapshot = NULL;
+    memset(&set->base, 0, sizeof(set->base));
+    memset(&set->base_shadow, 0, sizeof(set->base_shadow));
+    set->base_cursor = 0;
+    set->views = NULL;
+    set->base_died = NULL;
     return CAUCHY_OK;
 }
 
@@ -58,84 +61,337 @@ cauchy_orset_t* cauchy_orset_create(usize initial_capacity, cauchy_node_id_t nod
 
 void cauchy_orset_destroy(cauchy_orset_t* set) {
     if (!set) return;
-    for (usize i = 0; i < set->num_buckets; i++) {
-        cauchy_orset_entry_t* entry = set->buckets[i];
-        while (entry) {
-            cauchy_orset_entry_t* next = entry->next;
-            if (entry->data) free(entry->data);
-            entry = next;
-        }
+    if (set->views) {
+        cauchy_mvcc_fini(set->views);  /* Frees collected entries still pending */
+        free(set->views);
+        free(set->base_died);
     }
-    free(set->buckets);
+    cauchy_htable_destroy(&set->index);
     if (set->entry_pool) cauchy_pool_destroy(set->entry_pool);
+    cauchy_arena_destroy(&set->payloads);
+    if (set->digest) {
+        cauchy_merkle_destroy(set->digest);
+        free(set->digest);
+    }
+    cauchy_vclock_fini(&set->clock);
+    cauchy_vclock_fini(&set->stable);
+    cauchy_snapshot_shadow_fini(&set->base_shadow);
+    cauchy_snapshot_release(set->snapshot);
     free(set);
 }
 
-cauchy_result_t cauchy_orset_add(cauchy_orset_t* set, const void* data, usize size) {
-    if (!set || !data || size == 0) return CAUCHY_ERR_INVALID;
+/* Digest of one entry: replicas agree on a bucket only when they hold the
+ * same tags in the same add/remove state */
+static u64 entry_digest(const cauchy_orset_entry_t* entry) {
+    u64 tag = cauchy_merkle_mix(entry->tag.node_id ^ cauchy_merkle_mix(entry->tag.timestamp));
+    return entry->hash ^ tag ^ (entry->removed ? 0xA5A5A5A5A5A5A5A5ULL : 0);
+}
+
+/* Fingerprints and digest follow every entry that appears or goes */
+static void entry_in(cauchy_orset_t* set, const cauchy_orset_entry_t* entry) {
+    u64 digest = entry_digest(entry);
+    set->fingerprint += cauchy_merkle_item(digest);
+    if (!entry->removed) set->live_fingerprint += cauchy_merkle_item(entry->hash);
+    if (set->digest) cauchy_merkle_add(set->digest, entry->hash, digest);
+}
 
-    u64 h = hash_data(data, size);
-    usize idx = h % set->num_buckets;
+static void entry_out(cauchy_orset_t* set, const cauchy_orset_entry_t* entry) {
+    u64 digest = entry_digest(entry);
+    set->fingerprint -= cauchy_merkle_item(digest);
+    if (!entry->removed) set->live_fingerprint -= cauchy_merkle_item(entry->hash);
+    if (set->digest) cauchy_merkle_remove(set->digest, entry->hash, digest);
+}
 
+/* Views: a log record spans each entry's active life; base slots are
+ * stamped when they are promoted. Entries are freed through the log. */
+static void publish(cauchy_orset_t* set) {
+    if (set->views) cauchy_mvcc_publish(set->views, set->active_count, set->live_fingerprint);
+}
+
+static void entry_relocate(void* arg, void* item, u32 slot) {
+    (void)arg;
+    ((cauchy_orset_entry_t*)item)->view_slot = slot;
+}
+
+static void entry_retire(void* item, void* ctx) {
+    cauchy_pool_free(ctx, item);
+}
+
+static void note_dot(cauchy_orset_t* set, const cauchy_uid_t* dot) {
+    if (dot->timestamp > cauchy_vclock_get(&set->clock, dot->node_id)) {
+        cauchy_vclock_set(&set->clock, dot->node_id, dot->timestamp);
+    }
+}
+
+CAUCHY_INLINE bool dot_stable(const cauchy_vclock_t* stable, const cauchy_uid_t* dot) {
+    return dot->timestamp <= cauchy_vclock_get(stable, dot->node_id);
+}
+
+/* Base records: hash, tag, removed_by, size << 1 | removed, then the
+ * bytes. A view is a stack entry whose data points into the mapping. */
+#define BASE_RECORD_HEADER (6 * sizeof(u64))
+
+static bool base_view(const cauchy_orset_t* set, const u8* rec, cauchy_orset_entry_t* view) {
+    if (!rec) return false;
+    usize room = cauchy_snapshot_index_room(&set->base, rec);
+    if (room < BASE_RECORD_HEADER) return false;
+    const u64* r = (const u64*)rec;
+    u64 size = r[5] >> 1;
+    if (size == 0 || size > room - BASE_RECORD_HEADER) return false;
+    view->hash = r[0];
+    view->tag = cauchy_uid_create(r[1], r[2]);
+    view->removed_by = cauchy_uid_create(r[3], r[4]);
+    view->removed = r[5] & 1;
+    view->view_slot = CAUCHY_MVCC_NONE;
+    view->size = (usize)size;
+    view->data = (u8*)(rec + BASE_RECORD_HEADER);
+    return true;
+}
+
+/* Live base entry in slot, if any */
+static bool base_at(const cauchy_orset_t* set, u64 slot, cauchy_orset_entry_t* view) {
+    if (cauchy_snapshot_shadowed(&set->base_shadow, slot)) return false;
+    return base_view(set, cauchy_snapshot_index_at(&set->base, slot), view);
+}
+
+/* Next base entry stored under hash h, from a probe over the base */
+static bool base_probe_next(const cauchy_orset_t* set, cauchy_snapshot_probe_t* probe,
+                            u64 h, u64* slot, cauchy_orset_entry_t* view) {
+    const u8* rec;
+    while ((rec = cauchy_snapshot_probe_next(probe, slot)) != NULL) {
+        if (cauchy_snapshot_shadowed(&set->base_shadow, *slot)) continue;
+        if (base_view(set, rec, view) && view->hash == h) return true;
+    }
+    return false;
+}
+
+/* Copy a base entry into the heap before it changes. Counts, clock,
+ * fingerprints and digest already include it. Payloads above the inline size stay in the
+ * mapping, which lives as long as the set. */
+static cauchy_orset_entry_t* promote(cauchy_orset_t* set, u64 slot,
+                                     const cauchy_orset_entry_t* view) {
     cauchy_orset_entry_t* entry = cauchy_pool_alloc(set->entry_pool);
-    if (!entry) entry = malloc(sizeof(cauchy_orset_entry_t));
-    if (!entry) return CAUCHY_ERR_NOMEM;
+    if (!entry) return NULL;
+    *entry = *view;
+    if (view->size <= CAUCHY_ORSET_INLINE_SIZE) {
+        memcpy(entry->inline_data, view->data, view->size);
+        entry->data = entry->inline_data;
+    }
+    if (cauchy_htable_insert(&set->index, entry->hash, entry) != CAUCHY_OK) {
+        cauchy_pool_free(set->entry_pool, entry);
+        return NULL;
+    }
+    if (cauchy_snapshot_shadow_set(&set->base_shadow, slot) != CAUCHY_OK) {
+        cauchy_htable_remove(&set->index, entry->hash, entry);
+        cauchy_pool_free(set->entry_pool, entry);
+        return NULL;
+    }
+    if (set->base_died) {
+        atomic_store_explicit(&set->base_died[slot], cauchy_mvcc_next(set->views),
+                              memory_order_relaxed);
+    }
+    return entry;
+}
+
+static void mark_removed(cauchy_orset_t* set, cauchy_orset_entry_t* entry, cauchy_uid_t dot) {
+    entry_out(set, entry);
+    note_dot(set, &dot);
+    entry->removed_by = dot;
+    entry->removed = true;
+    set->active_count--;
+    entry_in(set, entry);
+    if (set->views) cauchy_mvcc_end(set->views, entry->view_slot);
+}
 
-    entry->data = malloc(size);
+/* Allocate and fill an entry, taking large payloads from `payloads` */
+static cauchy_orset_entry_t* entry_new(cauchy_orset_t* set, cauchy_arena_t* payloads,
+                                       const void* data, usize size, u64 h, cauchy_uid_t tag,
+                                       bool removed, cauchy_uid_t removed_by) {
+    cauchy_orset_entry_t* entry = cauchy_pool_alloc(set->entry_pool);
+    if (!entry) return NULL;
+
+    entry->data = size <= CAUCHY_ORSET_INLINE_SIZE
+        ? entry->inline_data
+        : cauchy_arena_alloc(payloads, size);
     if (!entry->data) {
         cauchy_pool_free(set->entry_pool, entry);
-        return CAUCHY_ERR_NOMEM;
+        return NULL;
     }
 
     memcpy(entry->data, data, size);
     entry->size = size;
     entry->hash = h;
-    entry->tag = cauchy_uid_create(set->node_id, ++set->timestamp);
-    entry->removed = false;
-    entry->next = set->buckets[idx];
-    set->buckets[idx] = entry;
+    entry->tag = tag;
+    entry->removed_by = removed_by;
+    entry->removed = removed;
+    entry->view_slot = CAUCHY_MVCC_NONE;
+    return entry;
+}
+
+static cauchy_result_t insert_entry(cauchy_orset_t* set, const void* data, usize size,
+                                    u64 h, cauchy_uid_t tag, bool removed,
+                                    cauchy_uid_t removed_by) {
+    cauchy_orset_entry_t* entry = entry_new(set, &set->payloads, data, size, h, tag,
+                                            removed, removed_by);
+    if (!entry) return CAUCHY_ERR_NOMEM;
+
+    /* On failure an arena payload stays reserved until destroy */
+    cauchy_result_t res = CAUCHY_OK;
+    if (set->views && !removed) res = cauchy_mvcc_append(set->views, entry, &entry->view_slot);
+    if (res == CAUCHY_OK) res = cauchy_htable_insert(&set->index, h, entry);
+    if (res != CAUCHY_OK) {
+        if (set->views) cauchy_mvcc_end(set->views, entry->view_slot);
+        cauchy_pool_free(set->entry_pool, entry);
+        return res;
+    }
     set->entry_count++;
-    set->active_count++;
+    if (!removed) set->active_count++;
+    note_dot(set, &tag);
+    if (removed) note_dot(set, &removed_by);
+    entry_in(set, entry);
     return CAUCHY_OK;
 }
 
-cauchy_result_t cauchy_orset_remove(cauchy_orset_t* set, const void* data, usize size) {
+cauchy_result_t cauchy_orset_add(cauchy_orset_t* set, const void* data, usize size) {
     if (!set || !data || size == 0) return CAUCHY_ERR_INVALID;
 
-    u64 h = hash_data(data, size);
-    usize idx = h % set->num_buckets;
+    cauchy_uid_t tag = cauchy_uid_create(set->node_id, set->timestamp + 1);
+    cauchy_result_t res = insert_entry(set, data, size, cauchy_hash_bytes(data, size), tag, false, tag);
+    if (res != CAUCHY_OK) return res;
+    set->timestamp++;
+    publish(set);
+    return CAUCHY_OK;
+}
+
+static cauchy_result_t remove_hashed(cauchy_orset_t* set, const void* data, usize size, u64 h) {
+    cauchy_uid_t dot = cauchy_uid_create(set->node_id, set->timestamp + 1);
     bool found = false;
 
-    cauchy_orset_entry_t* entry = set->buckets[idx];
-    while (entry) {
+    cauchy_htable_probe_t probe;
+    cauchy_htable_probe_init(&probe, &set->index, h);
+    cauchy_orset_entry_t* entry;
+    while ((entry = cauchy_htable_probe_next(&probe)) != NULL) {
         if (!entry->removed && entry->hash == h && entry->size == size &&
             memcmp(entry->data, data, size) == 0) {
-            entry->removed = true;
-            set->active_count--;
+            mark_removed(set, entry, dot);
             found = true;
         }
-        entry = entry->next;
     }
-    return found ? CAUCHY_OK : CAUCHY_ERR_NOTFOUND;
-}
 
-bool cauchy_orset_contains(const cauchy_orset_t* set, const void* data, usize size) {
-    if (!set || !data || size == 0) return false;
+    cauchy_snapshot_probe_t base;
+    cauchy_snapshot_probe_init(&base, &set->base, h);
+    cauchy_orset_entry_t view;
+    u64 slot;
+    while (base_probe_next(set, &base, h, &slot, &view)) {
+        if (view.removed || view.size != size || memcmp(view.data, data, size) != 0) continue;
+        if (!(entry = promote(set, slot, &view))) {
+            publish(set);
+            return CAUCHY_ERR_NOMEM;
+        }
+        mark_removed(set, entry, dot);
+        found = true;
+    }
+    if (!found) return CAUCHY_ERR_NOTFOUND;
+    set->timestamp++;
+    publish(set);
+    return CAUCHY_OK;
+}
 
-    u64 h = hash_data(data, size);
-    usize idx = h % set->num_buckets;
+cauchy_result_t cauchy_orset_remove(cauchy_orset_t* set, const void* data, usize size) {
+    if (!set || !data || size == 0) return CAUCHY_ERR_INVALID;
+    return remove_hashed(set, data, size, cauchy_hash_bytes(data, size));
+}
 
-    cauchy_orset_entry_t* entry = set->buckets[idx];
-    while (entry) {
+static bool contains_hashed(const cauchy_orset_t* set, u64 h, const void* data, usize size) {
+    cauchy_htable_probe_t probe;
+    cauchy_htable_probe_init(&probe, &set->index, h);
+    const cauchy_orset_entry_t* entry;
+    while ((entry = cauchy_htable_probe_next(&probe)) != NULL) {
         if (!entry->removed && entry->hash == h && entry->size == size &&
             memcmp(entry->data, data, size) == 0) {
             return true;
         }
-        entry = entry->next;
+    }
+
+    cauchy_snapshot_probe_t base;
+    cauchy_snapshot_probe_init(&base, &set->base, h);
+    cauchy_orset_entry_t view;
+    u64 slot;
+    while (base_probe_next(set, &base, h, &slot, &view)) {
+        if (!view.removed && view.size == size && memcmp(view.data, data, size) == 0) return true;
     }
     return false;
 }
 
+bool cauchy_orset_contains(const cauchy_orset_t* set, const void* data, usize size) {
+    if (!set || !data || size == 0) return false;
+    return contains_hashed(set, cauchy_hash_bytes(data, size), data, size);
+}
+
+/* One batch mutation on a hashed item */
+static cauchy_result_t batch_apply(cauchy_orset_t* set, bool remove,
+                                   const cauchy_bytes_t* it, u64 h) {
+    if (!it->data || it->size == 0) return CAUCHY_ERR_INVALID;
+    if (remove) return remove_hashed(set, it->data, it->size, h);
+
+    cauchy_uid_t tag = cauchy_uid_create(set->node_id, set->timestamp + 1);
+    cauchy_result_t res = insert_entry(set, it->data, it->size, h, tag, false, tag);
+    if (res != CAUCHY_OK) return res;
+    set->timestamp++;
+    publish(set);
+    return CAUCHY_OK;
+}
+
+/* Hash a chunk, prefetch its home slots, then apply: the slot misses of
+ * one chunk overlap instead of stalling every item in turn */
+static cauchy_result_t batch_run(cauchy_orset_t* set, bool remove, const cauchy_bytes_t* items,
+                                 usize n, cauchy_result_t* results) {
+    cauchy_result_t first = CAUCHY_OK;
+    u64 hashes[CAUCHY_HTABLE_BATCH];
+    for (usize base = 0; base < n; base += CAUCHY_HTABLE_BATCH) {
+        usize m = n - base < CAUCHY_HTABLE_BATCH ? n - base : CAUCHY_HTABLE_BATCH;
+        cauchy_hash_batch(items + base, m, hashes);
+        for (usize i = 0; i < m; i++) cauchy_htable_prefetch(&set->index, hashes[i]);
+        for (usize i = 0; i < m; i++) {
+            cauchy_result_t res = batch_apply(set, remove, &items[base + i], hashes[i]);
+            if (results) results[base + i] = res;
+            if (res != CAUCHY_OK && first == CAUCHY_OK) first = res;
+        }
+    }
+    return first;
+}
+
+cauchy_result_t cauchy_orset_add_batch(cauchy_orset_t* set, const cauchy_bytes_t* items, usize n,
+                                       cauchy_result_t* results) {
+    if (!set || (n && !items)) return CAUCHY_ERR_INVALID;
+    return batch_run(set, false, items, n, results);
+}
+
+cauchy_result_t cauchy_orset_remove_batch(cauchy_orset_t* set, const cauchy_bytes_t* items,
+                                          usize n, cauchy_result_t* results) {
+    if (!set || (n && !items)) return CAUCHY_ERR_INVALID;
+    return batch_run(set, true, items, n, results);
+}
+
+usize cauchy_orset_contains_batch(const cauchy_orset_t* set, const cauchy_bytes_t* items, usize n,
+                                  bool* found) {
+    if (!set || (n && !items)) return 0;
+    usize hits = 0;
+    u64 hashes[CAUCHY_HTABLE_BATCH];
+    for (usize base = 0; base < n; base += CAUCHY_HTABLE_BATCH) {
+        usize m = n - base < CAUCHY_HTABLE_BATCH ? n - base : CAUCHY_HTABLE_BATCH;
+        cauchy_hash_batch(items + base, m, hashes);
+        for (usize i = 0; i < m; i++) cauchy_htable_prefetch(&set->index, hashes[i]);
+        for (usize i = 0; i < m; i++) {
+            const cauchy_bytes_t* it = &items[base + i];
+            bool hit = it->data && it->size && contains_hashed(set, hashes[i], it->data, it->size);
+            if (found) found[base + i] = hit;
+            hits += hit;
+        }
+    }
+    return hits;
+}
+
 usize cauchy_orset_count(const cauchy_orset_t* set) {
     return set ? set->active_count : 0;
 }
@@ -147,122 +403,687 @@ bool cauchy_orset_is_empty(const cauchy_orset_t* set) {
 static cauchy_orset_entry_t* find_entry_by_tag(cauchy_orset_t* set,
                                                 u64 hash,
                                                 const cauchy_uid_t* tag) {
-    usize idx = hash % set->num_buckets;
-    cauchy_orset_entry_t* entry = set->buckets[idx];
-    while (entry) {
+    cauchy_htable_probe_t probe;
+    cauchy_htable_probe_init(&probe, &set->index, hash);
+    cauchy_orset_entry_t* entry;
+    while ((entry = cauchy_htable_probe_next(&probe)) != NULL) {
         if (entry->hash == hash && cauchy_uid_equals(&entry->tag, tag)) {
             return entry;
         }
-        entry = entry->next;
+    }
+    return NULL;
+}
+
+/* Join one tagged entry into dst: tombstones win over live copies, and
+ * concurrent removes of one tag settle on the greater dot */
+static bool find_base_by_tag(const cauchy_orset_t* set, u64 hash, const cauchy_uid_t* tag,
+                             u64* slot, cauchy_orset_entry_t* view) {
+    cauchy_snapshot_probe_t probe;
+    cauchy_snapshot_probe_init(&probe, &set->base, hash);
+    while (base_probe_next(set, &probe, hash, slot, view)) {
+        if (cauchy_uid_equals(&view->tag, tag)) return true;
+    }
+    return false;
+}
+
+static cauchy_result_t join_entry(cauchy_orset_t* dst, const cauchy_orset_entry_t* src_entry) {
+    cauchy_orset_entry_t* existing = find_entry_by_tag(dst, src_entry->hash, &src_entry->tag);
+    cauchy_orset_entry_t view;
+    u64 slot = 0;
+    bool mapped = false;
+    if (!existing && find_base_by_tag(dst, src_entry->hash, &src_entry->tag, &slot, &view)) {
+        existing = &view;
+        mapped = true;
+    }
+    if (!existing) {
+        /* Below the frontier and absent: its tombstone was collected */
+        if (dot_stable(&dst->stable, &src_entry->tag)) return CAUCHY_OK;
+        return insert_entry(dst, src_entry->data, src_entry->size, src_entry->hash,
+                            src_entry->tag, src_entry->removed, src_entry->removed_by);
+    }
+    if (!src_entry->removed ||
+        (existing->removed &&
+         cauchy_uid_compare(&src_entry->removed_by, &existing->removed_by) <= 0)) {
+        return CAUCHY_OK;
+    }
+    if (mapped && !(existing = promote(dst, slot, &view))) return CAUCHY_ERR_NOMEM;
+    if (src_entry->removed && !existing->removed) {
+        mark_removed(dst, existing, src_entry->removed_by);
+    } else if (src_entry->removed &&
+               cauchy_uid_compare(&src_entry->removed_by, &existing->removed_by) > 0) {
+        existing->removed_by = src_entry->removed_by;
+        note_dot(dst, &existing->removed_by);
+    }
+    return CAUCHY_OK;
+}
+
+/* Next entry, tombstones included: the heap's, then the base's as views */
+static const cauchy_orset_entry_t* iter_entry(cauchy_orset_iter_t* iter,
+                                              cauchy_orset_entry_t* view) {
+    const cauchy_orset_entry_t* entry = cauchy_htable_iter_next(&iter->inner);
+    if (entry) return entry;
+    const cauchy_orset_t* set = iter->set;
+    while (iter->base_slot < set->base.capacity) {
+        if (base_at(set, iter->base_slot++, view)) return view;
     }
     return NULL;
 }
 
 cauchy_result_t cauchy_orset_merge(cauchy_orset_t* dst, const cauchy_orset_t* src) {
     if (!dst || !src) return CAUCHY_ERR_INVALID;
+    if (dst == src) return CAUCHY_OK;
+
+    u64 start = CAUCHY_STAT_NOW();
+    cauchy_orset_iter_t iter;
+    cauchy_orset_iter_init(&iter, src);
+    cauchy_orset_entry_t view;
+    const cauchy_orset_entry_t* src_entry;
+    while ((src_entry = iter_entry(&iter, &view)) != NULL) {
+        cauchy_result_t res = join_entry(dst, src_entry);
+        if (res != CAUCHY_OK) {
+            publish(dst);
+            return res;
+        }
+    }
+    publish(dst);
+    CAUCHY_STAT_MERGE(CAUCHY_STAT_CRDT_ORSET, src->entry_count, CAUCHY_STAT_NOW() - start,
+                      dst->entry_count, dst->entry_count - dst->active_count);
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_orset_merge_delta(cauchy_orset_t* dst, const cauchy_orset_t* delta) {
+    return cauchy_orset_merge(dst, delta);
+}
+
+/* Parallel merge, partitioned as cauchy_gset_merge_parallel. Each part
+ * keeps its own counts, clock, fingerprint and digest changes for the
+ * serial tail to
+ * fold in. Promoting a base entry writes the shared shadow bitmap, so
+ * joins that would promote are deferred with the escaped chains. */
+
+typedef struct orset_merge_part {
+    cauchy_htable_part_t index;
+    cauchy_arena_t       payloads;
+    cauchy_vclock_t      clock;
+    usize                entries;        /* Entries inserted */
+    usize                activated;      /* Of those, live ones */
+    usize                deactivated;    /* Existing entries tombstoned */
+    cauchy_scatter_bin_t digest_in;      /* (hash, entry digest) to add */
+    cauchy_scatter_bin_t digest_out;     /* (hash, entry digest) to remove */
+    cauchy_scatter_bin_t view_in;        /* Entries that became active, for views */
+    cauchy_scatter_bin_t view_out;       /* Entries tombstoned, for views */
+    u64                  fingerprint;    /* Wrapping deltas of the set's */
+    u64                  live_fingerprint;
+    cauchy_scatter_bin_t deferred;
+    cauchy_result_t      res;
+} orset_merge_part_t;
+
+typedef struct orset_merge_job {
+    cauchy_orset_t*       dst;
+    const cauchy_orset_t* src;
+    cauchy_scatter_t      scatter;
+    orset_merge_part_t*   parts;
+    u32                   count;
+} orset_merge_job_t;
+
+/* Source entry behind a ref: heap entries are pointers, base entries
+ * slot << 1 | 1 viewed into view */
+static const cauchy_orset_entry_t* ref_entry(const cauchy_orset_t* set, u64 ref,
+                                             cauchy_orset_entry_t* view) {
+    if (!(ref & 1)) return (const cauchy_orset_entry_t*)(uintptr_t)ref;
+    return base_at(set, ref >> 1, view) ? view : NULL;
+}
+
+static void orset_scatter_task(void* arg, u32 i) {
+    orset_merge_job_t* job = arg;
+    const cauchy_orset_t* src = job->src;
+    const cauchy_htable_t* to = &job->dst->index;
+    cauchy_scatter_bin_t* row = cauchy_scatter_bin(&job->scatter, i, 0);
+
+    cauchy_htable_iter_t iter;
+    cauchy_htable_iter_init_slice(&iter, &src->index, i, job->count);
+    const cauchy_orset_entry_t* entry;
+    while ((entry = cauchy_htable_iter_next(&iter)) != NULL) {
+        u32 p = cauchy_htable_part_of(to, job->count, entry->hash);
+        if (!cauchy_scatter_push(&row[p], entry->hash, (u64)(uintptr_t)entry)) {
+            job->parts[i].res = CAUCHY_ERR_NOMEM;
+            return;
+        }
+    }
+
+    u64 span = (src->base.capacity + job->count - 1) / job->count;
+    u64 end = span * (i + 1) < src->base.capacity ? span * (i + 1) : src->base.capacity;
+    cauchy_orset_entry_t view;
+    for (u64 slot = span * i; slot < end; slot++) {
+        if (!base_at(src, slot, &view)) continue;
+        u32 p = cauchy_htable_part_of(to, job->count, view.hash);
+        if (!cauchy_scatter_push(&row[p], view.hash, slot << 1 | 1)) {
+            job->parts[i].res = CAUCHY_ERR_NOMEM;
+            return;
+        }
+    }
+}
+
+static void part_note_dot(orset_merge_part_t* part, const cauchy_uid_t* dot) {
+    if (dot->timestamp > cauchy_vclock_get(&part->clock, dot->node_id)) {
+        cauchy_vclock_set(&part->clock, dot->node_id, dot->timestamp);
+    }
+}
 
-    for (usize i = 0; i < src->num_buckets; i++) {
-        cauchy_orset_entry_t* src_entry = src->buckets[i];
-        while (src_entry) {
-            cauchy_orset_entry_t* existing = find_entry_by_tag(dst, src_entry->hash, &src_entry->tag);
-
-            if (existing) {
-                if (src_entry->removed && !existing->removed) {
-                    existing->removed = true;
-                    dst->active_count--;
-                }
-            } else {
-                usize idx = src_entry->hash % dst->num_buckets;
-                cauchy_orset_entry_t* new_entry = cauchy_pool_alloc(dst->entry_pool);
-                if (!new_entry) new_entry = malloc(sizeof(cauchy_orset_entry_t));
-                if (!new_entry) return CAUCHY_ERR_NOMEM;
-
-                new_entry->data = malloc(src_entry->size);
-                if (!new_entry->data) {
-                    cauchy_pool_free(dst->entry_pool, new_entry);
-                    return CAUCHY_ERR_NOMEM;
-                }
-
-                memcpy(new_entry->data, src_entry->data, src_entry->size);
-                new_entry->size = src_entry->size;
-                new_entry->hash = src_entry->hash;
-                new_entry->tag = src_entry->tag;
-                new_entry->removed = src_entry->removed;
-                new_entry->next = dst->buckets[idx];
-                dst->buckets[idx] = new_entry;
-                dst->entry_count++;
-                if (!new_entry->removed) dst->active_count++;
+/* join_entry within one part; CAUCHY_ERR_FULL defers the entry */
+static cauchy_result_t part_join(cauchy_orset_t* dst, orset_merge_part_t* part,
+                                 const cauchy_orset_entry_t* src_entry) {
+    cauchy_htable_part_probe_t probe;
+    cauchy_htable_part_probe_init(&probe, &part->index, src_entry->hash);
+    cauchy_orset_entry_t* existing;
+    while ((existing = cauchy_htable_part_probe_next(&probe)) != NULL) {
+        if (existing->hash == src_entry->hash &&
+            cauchy_uid_equals(&existing->tag, &src_entry->tag)) {
+            break;
+        }
+    }
+    if (!existing && probe.escaped) return CAUCHY_ERR_FULL;
+
+    cauchy_orset_entry_t view;
+    u64 slot;
+    if (!existing && find_base_by_tag(dst, src_entry->hash, &src_entry->tag, &slot, &view)) {
+        bool changes = src_entry->removed &&
+            (!view.removed || cauchy_uid_compare(&src_entry->removed_by, &view.removed_by) > 0);
+        return changes ? CAUCHY_ERR_FULL : CAUCHY_OK;
+    }
+
+    if (!existing) {
+        if (dot_stable(&dst->stable, &src_entry->tag)) return CAUCHY_OK;
+        cauchy_orset_entry_t* entry = entry_new(dst, &part->payloads, src_entry->data,
+                                                src_entry->size, src_entry->hash,
+                                                src_entry->tag, src_entry->removed,
+                                                src_entry->removed_by);
+        if (!entry) return CAUCHY_ERR_NOMEM;
+        if (dst->digest && !cauchy_scatter_push(&part->digest_in, entry->hash,
+                                                entry_digest(entry))) {
+            cauchy_pool_free(dst->entry_pool, entry);
+            return CAUCHY_ERR_NOMEM;
+        }
+        bool track = dst->views && !entry->removed;
+        if (track && !cauchy_scatter_push(&part->view_in, entry->hash, (u64)(uintptr_t)entry)) {
+            if (dst->digest) part->digest_in.count--;
+            cauchy_pool_free(dst->entry_pool, entry);
+            return CAUCHY_ERR_NOMEM;
+        }
+        cauchy_result_t res = cauchy_htable_part_insert(&part->index, entry->hash, entry);
+        if (res != CAUCHY_OK) {
+            if (dst->digest) part->digest_in.count--;
+            if (track) part->view_in.count--;
+            cauchy_pool_free(dst->entry_pool, entry);
+            return res;
+        }
+        part->entries++;
+        part->fingerprint += cauchy_merkle_item(entry_digest(entry));
+        if (!entry->removed) {
+            part->activated++;
+            part->live_fingerprint += cauchy_merkle_item(entry->hash);
+        }
+        part_note_dot(part, &entry->tag);
+        if (entry->removed) part_note_dot(part, &entry->removed_by);
+        return CAUCHY_OK;
+    }
+
+    if (!src_entry->removed) return CAUCHY_OK;
+    if (!existing->removed) {
+        if (dst->views && !cauchy_scatter_push(&part->view_out, existing->hash,
+                                               (u64)(uintptr_t)existing)) {
+            return CAUCHY_ERR_NOMEM;
+        }
+        if (dst->digest) {
+            if (!cauchy_scatter_push(&part->digest_out, existing->hash, entry_digest(existing))) {
+                if (dst->views) part->view_out.count--;
+                return CAUCHY_ERR_NOMEM;
+            }
+            existing->removed = true;
+            if (!cauchy_scatter_push(&part->digest_in, existing->hash, entry_digest(existing))) {
+                existing->removed = false;
+                part->digest_out.count--;
+                if (dst->views) part->view_out.count--;
+                return CAUCHY_ERR_NOMEM;
+            }
+        }
+        part->fingerprint -= cauchy_merkle_item(entry_digest(existing));
+        existing->removed = true;
+        existing->removed_by = src_entry->removed_by;
+        part->fingerprint += cauchy_merkle_item(entry_digest(existing));
+        part->live_fingerprint -= cauchy_merkle_item(existing->hash);
+        part->deactivated++;
+        part_note_dot(part, &existing->removed_by);
+    } else if (cauchy_uid_compare(&src_entry->removed_by, &existing->removed_by) > 0) {
+        existing->removed_by = src_entry->removed_by;
+        part_note_dot(part, &existing->removed_by);
+    }
+    return CAUCHY_OK;
+}
+
+static void orset_merge_task(void* arg, u32 p) {
+    orset_merge_job_t* job = arg;
+    orset_merge_part_t* part = &job->parts[p];
+    for (u32 i = 0; i < job->count; i++) {
+        const cauchy_scatter_bin_t* bin = cauchy_scatter_bin(&job->scatter, i, p);
+        for (usize k = 0; k < bin->count; k++) {
+            cauchy_orset_entry_t view;
+            const cauchy_orset_entry_t* src_entry = ref_entry(job->src, bin->items[k].ref, &view);
+            if (!src_entry) continue;
+            cauchy_result_t res = part_join(job->dst, part, src_entry);
+            if (res == CAUCHY_ERR_FULL) {
+                res = cauchy_scatter_push(&part->deferred, bin->items[k].hash, bin->items[k].ref)
+                    ? CAUCHY_OK : CAUCHY_ERR_NOMEM;
+            }
+            if (res != CAUCHY_OK) {
+                part->res = res;
+                return;
+            }
+        }
+    }
+}
+
+cauchy_result_t cauchy_orset_merge_parallel(cauchy_orset_t* dst, const cauchy_orset_t* src,
+                                            u32 parts, const cauchy_executor_t* exec) {
+    if (!dst || !src) return CAUCHY_ERR_INVALID;
+    if (dst == src) return CAUCHY_OK;
+    if (parts == 0) parts = cauchy_parallel_default_parts();
+    if (parts > CAUCHY_PARALLEL_MAX_PARTS) parts = CAUCHY_PARALLEL_MAX_PARTS;
+    if (parts <= 1 || src->entry_count < CAUCHY_PARALLEL_MIN_ITEMS) {
+        return cauchy_orset_merge(dst, src);
+    }
+
+    u64 start = CAUCHY_STAT_NOW();
+    cauchy_result_t res = cauchy_htable_reserve(&dst->index, src->entry_count);
+    if (res != CAUCHY_OK) return res;
+
+    orset_merge_job_t job = { .dst = dst, .src = src, .count = parts };
+    job.parts = calloc(parts, sizeof(orset_merge_part_t));
+    if (!job.parts) return CAUCHY_ERR_NOMEM;
+    res = cauchy_scatter_init(&job.scatter, parts);
+    if (res != CAUCHY_OK) {
+        free(job.parts);
+        return res;
+    }
+    for (u32 p = 0; p < parts; p++) {
+        cauchy_htable_part_init(&job.parts[p].index, &dst->index, p, parts);
+        cauchy_arena_init(&job.parts[p].payloads, 0);
+        cauchy_vclock_init(&job.parts[p].clock, 0);
+        job.parts[p].res = CAUCHY_OK;
+    }
+
+    cauchy_executor_run(exec, parts, orset_scatter_task, &job);
+    for (u32 p = 0; p < parts && res == CAUCHY_OK; p++) res = job.parts[p].res;
+    if (res == CAUCHY_OK) cauchy_executor_run(exec, parts, orset_merge_task, &job);
+
+    /* Fold in whatever the parts changed, even after a failure */
+    for (u32 p = 0; p < parts; p++) {
+        orset_merge_part_t* part = &job.parts[p];
+        cauchy_htable_part_commit(&part->index);
+        cauchy_arena_absorb(&dst->payloads, &part->payloads);
+        dst->entry_count += part->entries;
+        dst->active_count += part->activated;
+        dst->active_count -= part->deactivated;
+        dst->fingerprint += part->fingerprint;
+        dst->live_fingerprint += part->live_fingerprint;
+        cauchy_vclock_merge(&dst->clock, &part->clock);
+        for (usize k = 0; k < part->digest_out.count; k++) {
+            const cauchy_scatter_item_t* it = &part->digest_out.items[k];
+            cauchy_merkle_remove(dst->digest, it->hash, it->ref);
+        }
+        for (usize k = 0; k < part->digest_in.count; k++) {
+            const cauchy_scatter_item_t* it = &part->digest_in.items[k];
+            cauchy_merkle_add(dst->digest, it->hash, it->ref);
+        }
+        for (usize k = 0; k < part->view_out.count; k++) {
+            const cauchy_orset_entry_t* entry = (void*)(uintptr_t)part->view_out.items[k].ref;
+            cauchy_mvcc_end(dst->views, entry->view_slot);
+        }
+        for (usize k = 0; k < part->view_in.count; k++) {
+            cauchy_orset_entry_t* entry = (void*)(uintptr_t)part->view_in.items[k].ref;
+            if (cauchy_mvcc_append(dst->views, entry, &entry->view_slot) != CAUCHY_OK &&
+                res == CAUCHY_OK) {
+                res = CAUCHY_ERR_NOMEM;
+            }
+        }
+        if (res == CAUCHY_OK) res = part->res;
+    }
+    for (u32 p = 0; p < parts && res == CAUCHY_OK; p++) {
+        const cauchy_scatter_bin_t* bin = &job.parts[p].deferred;
+        for (usize k = 0; k < bin->count && res == CAUCHY_OK; k++) {
+            cauchy_orset_entry_t view;
+            const cauchy_orset_entry_t* src_entry = ref_entry(src, bin->items[k].ref, &view);
+            if (src_entry) res = join_entry(dst, src_entry);
+        }
+    }
+
+    for (u32 p = 0; p < parts; p++) {
+        cauchy_vclock_fini(&job.parts[p].clock);
+        free(job.parts[p].digest_in.items);
+        free(job.parts[p].digest_out.items);
+        free(job.parts[p].deferred.items);
+        free(job.parts[p].view_in.items);
+        free(job.parts[p].view_out.items);
+    }
+    free(job.parts);
+    cauchy_scatter_fini(&job.scatter);
+    publish(dst);
+    CAUCHY_STAT_MERGE(CAUCHY_STAT_CRDT_ORSET, src->entry_count, CAUCHY_STAT_NOW() - start,
+                      dst->entry_count, dst->entry_count - dst->active_count);
+    return res;
+}
+
+cauchy_result_t cauchy_orset_add_delta(cauchy_orset_t* set, const void* data, usize size,
+                                       cauchy_orset_t* delta) {
+    if (!set || !delta || !data || size == 0) return CAUCHY_ERR_INVALID;
+
+    u64 h = cauchy_hash_bytes(data, size);
+    cauchy_uid_t tag = cauchy_uid_create(set->node_id, set->timestamp + 1);
+    cauchy_result_t res = insert_entry(set, data, size, h, tag, false, tag);
+    if (res != CAUCHY_OK) return res;
+    set->timestamp++;
+    publish(set);
+    res = insert_entry(delta, data, size, h, tag, false, tag);
+    if (res == CAUCHY_OK) publish(delta);
+    return res;
+}
+
+cauchy_result_t cauchy_orset_remove_delta(cauchy_orset_t* set, const void* data, usize size,
+                                          cauchy_orset_t* delta) {
+    if (!set || !delta || !data || size == 0) return CAUCHY_ERR_INVALID;
+
+    u64 h = cauchy_hash_bytes(data, size);
+    cauchy_uid_t dot = cauchy_uid_create(set->node_id, set->timestamp + 1);
+    bool found = false;
+
+    /* Each observed tag travels as a tombstone so receivers that never
+     * saw the add still suppress it when the add arrives later */
+    cauchy_htable_probe_t probe;
+    cauchy_htable_probe_init(&probe, &set->index, h);
+    cauchy_orset_entry_t* entry;
+    while ((entry = cauchy_htable_probe_next(&probe)) != NULL) {
+        if (!entry->removed && entry->hash == h && entry->size == size &&
+            memcmp(entry->data, data, size) == 0) {
+            mark_removed(set, entry, dot);
+            found = true;
+            cauchy_result_t res = join_entry(delta, entry);
+            if (res != CAUCHY_OK) {
+                publish(set);
+                publish(delta);
+                return res;
             }
-            src_entry = src_entry->next;
         }
     }
+
+    cauchy_snapshot_probe_t base;
+    cauchy_snapshot_probe_init(&base, &set->base, h);
+    cauchy_orset_entry_t view;
+    u64 slot;
+    while (base_probe_next(set, &base, h, &slot, &view)) {
+        if (view.removed || view.size != size || memcmp(view.data, data, size) != 0) continue;
+        if (!(entry = promote(set, slot, &view))) {
+            publish(set);
+            publish(delta);
+            return CAUCHY_ERR_NOMEM;
+        }
+        mark_removed(set, entry, dot);
+        found = true;
+        cauchy_result_t res = join_entry(delta, entry);
+        if (res != CAUCHY_OK) {
+            publish(set);
+            publish(delta);
+            return res;
+        }
+    }
+    if (!found) return CAUCHY_ERR_NOTFOUND;
+    set->timestamp++;
+    publish(set);
+    publish(delta);
     return CAUCHY_OK;
 }
 
+u64 cauchy_orset_fingerprint(const cauchy_orset_t* set) {
+    return set ? set->fingerprint : 0;
+}
+
 bool cauchy_orset_equals(const cauchy_orset_t* a, const cauchy_orset_t* b) {
     if (!a || !b) return a == b;
     if (a->active_count != b->active_count) return false;
+    if (a->live_fingerprint != b->live_fingerprint) return false;
 
-    for (usize i = 0; i < a->num_buckets; i++) {
-        cauchy_orset_entry_t* entry = a->buckets[i];
-        while (entry) {
-            if (!entry->removed && !cauchy_orset_contains(b, entry->data, entry->size)) {
-                return false;
-            }
-            entry = entry->next;
+    cauchy_orset_iter_t iter;
+    cauchy_orset_iter_init(&iter, a);
+    cauchy_orset_entry_t view;
+    const cauchy_orset_entry_t* entry;
+    while ((entry = iter_entry(&iter, &view)) != NULL) {
+        if (!entry->removed && !contains_hashed(b, entry->hash, entry->data, entry->size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+cauchy_result_t cauchy_orset_enable_digest(cauchy_orset_t* set, u32 depth) {
+    if (!set) return CAUCHY_ERR_INVALID;
+    if (set->digest) return CAUCHY_ERR_EXISTS;
+    if (depth == 0) depth = CAUCHY_MERKLE_DEFAULT_DEPTH;
+
+    cauchy_merkle_t* tree = malloc(sizeof(cauchy_merkle_t));
+    if (!tree) return CAUCHY_ERR_NOMEM;
+    cauchy_result_t res = cauchy_merkle_init(tree, depth);
+    if (res != CAUCHY_OK) {
+        free(tree);
+        return res;
+    }
+
+    cauchy_orset_iter_t iter;
+    cauchy_orset_iter_init(&iter, set);
+    cauchy_orset_entry_t view;
+    const cauchy_orset_entry_t* entry;
+    while ((entry = iter_entry(&iter, &view)) != NULL) {
+        cauchy_merkle_add(tree, entry->hash, entry_digest(entry));
+    }
+    set->digest = tree;
+    return CAUCHY_OK;
+}
+
+const cauchy_merkle_t* cauchy_orset_digest(const cauchy_orset_t* set) {
+    return set ? set->digest : NULL;
+}
+
+cauchy_result_t cauchy_orset_collect_buckets(const cauchy_orset_t* set, u32 depth,
+                                             const u64* buckets, usize count,
+                                             cauchy_orset_t* out) {
+    if (!set || !out || (count && !buckets)) return CAUCHY_ERR_INVALID;
+    if (count == 0) return CAUCHY_OK;
+
+    cauchy_orset_iter_t iter;
+    cauchy_orset_iter_init(&iter, set);
+    cauchy_orset_entry_t view;
+    const cauchy_orset_entry_t* entry;
+    while ((entry = iter_entry(&iter, &view)) != NULL) {
+        u64 bucket = cauchy_merkle_bucket(depth, entry->hash);
+        if (!cauchy_merkle_bucket_listed(buckets, count, bucket)) continue;
+        cauchy_result_t res = join_entry(out, entry);
+        if (res != CAUCHY_OK) {
+            publish(out);
+            return res;
         }
     }
+    publish(out);
+    return CAUCHY_OK;
+}
+
+const cauchy_vclock_t* cauchy_orset_clock(const cauchy_orset_t* set) {
+    return set ? &set->clock : NULL;
+}
+
+typedef struct gc_sweep {
+    cauchy_orset_t*        set;
+    const cauchy_vclock_t* stable;
+} gc_sweep_t;
+
+static bool collect_tombstone(void* item, void* arg) {
+    cauchy_orset_entry_t* entry = item;
+    gc_sweep_t* gc = arg;
+    if (!entry->removed || !dot_stable(gc->stable, &entry->removed_by)) return false;
+    entry_out(gc->set, entry);
+    if (gc->set->views) {
+        cauchy_mvcc_retire(gc->set->views, entry, entry_retire, gc->set->entry_pool);
+    } else {
+        cauchy_pool_free(gc->set->entry_pool, entry);
+    }
     return true;
 }
 
+/* Base tombstones are shadowed, not freed; the same budget applies */
+static usize collect_base(cauchy_orset_t* set, usize budget) {
+    u64 capacity = set->base.capacity;
+    if (capacity == 0) return 0;
+    if (budget > capacity) budget = (usize)capacity;
+    if (budget == capacity) set->base_cursor = 0;
+
+    usize dropped = 0;
+    for (usize n = 0; n < budget; n++) {
+        u64 slot = set->base_cursor;
+        set->base_cursor = (usize)((slot + 1) & (capacity - 1));
+        cauchy_orset_entry_t view;
+        if (!base_at(set, slot, &view)) continue;
+        if (!view.removed || !dot_stable(&set->stable, &view.removed_by)) continue;
+        if (cauchy_snapshot_shadow_set(&set->base_shadow, slot) != CAUCHY_OK) break;
+        entry_out(set, &view);
+        dropped++;
+    }
+    return dropped;
+}
+
+usize cauchy_orset_gc(cauchy_orset_t* set, const cauchy_vclock_t* stable, usize budget) {
+    if (!set || !stable) return 0;
+
+    /* Remember the frontier before anything below it disappears */
+    if (cauchy_vclock_merge(&set->stable, stable) != CAUCHY_OK) return 0;
+
+    if (budget == 0) {
+        set->gc_cursor = 0;
+        budget = SIZE_MAX;
+    }
+    gc_sweep_t gc = { .set = set, .stable = &set->stable };
+    usize dropped = cauchy_htable_sweep(&set->index, &set->gc_cursor, budget,
+                                        collect_tombstone, &gc);
+    dropped += collect_base(set, budget);
+    set->entry_count -= dropped;
+    if (dropped) publish(set);
+    return dropped;
+}
+
 void cauchy_orset_iter_init(cauchy_orset_iter_t* iter, const cauchy_orset_t* set) {
     if (!iter) return;
     iter->set = set;
-    iter->bucket_idx = 0;
-    iter->current = set ? set->buckets[0] : NULL;
-    iter->last_data = NULL;
-    iter->last_size = 0;
-
-    while (set && iter->bucket_idx < set->num_buckets) {
-        while (iter->current && iter->current->removed) {
-            iter->current = iter->current->next;
-        }
-        if (iter->current) break;
-        iter->bucket_idx++;
-        if (iter->bucket_idx < set->num_buckets) {
-            iter->current = set->buckets[iter->bucket_idx];
-        }
-    }
+    iter->base_slot = 0;
+    cauchy_htable_iter_init(&iter->inner, set ? &set->index : NULL);
 }
 
 bool cauchy_orset_iter_next(cauchy_orset_iter_t* iter, const void** data, usize* size) {
     if (!iter || !iter->set) return false;
 
-    while (iter->current || iter->bucket_idx < iter->set->num_buckets - 1) {
-        if (iter->current && !iter->current->removed) {
-            if (data) *data = iter->current->data;
-            if (size) *size = iter->current->size;
-
-            do {
-                iter->current = iter->current->next;
-            } while (iter->current && iter->current->removed);
-
-            if (!iter->current) {
-                while (++iter->bucket_idx < iter->set->num_buckets) {
-                    iter->current = iter->set->buckets[iter->bucket_idx];
-                    while (iter->current && iter->current->removed) {
-                        iter->current = iter->current->next;
-                    }
-                    if (iter->current) break;
-                }
-            }
-            return true;
+    cauchy_orset_entry_t view;
+    const cauchy_orset_entry_t* entry;
+    while ((entry = iter_entry(iter, &view)) != NULL) {
+        if (entry->removed) continue;
+        if (data) *data = entry->data;
+        if (size) *size = entry->size;
+        return true;
+    }
+    return false;
+}
+
+cauchy_result_t cauchy_orset_enable_views(cauchy_orset_t* set) {
+    if (!set) return CAUCHY_ERR_INVALID;
+    if (set->views) return CAUCHY_ERR_EXISTS;
+
+    cauchy_mvcc_t* m = malloc(sizeof(cauchy_mvcc_t));
+    if (!m) return CAUCHY_ERR_NOMEM;
+    cauchy_result_t res = cauchy_mvcc_init(m, entry_relocate, NULL);
+    if (res != CAUCHY_OK) {
+        free(m);
+        return res;
+    }
+
+    cauchy_atomic_u64_t* died = NULL;
+    if (set->base.capacity) {
+        died = malloc((usize)set->base.capacity * sizeof(cauchy_atomic_u64_t));
+        if (!died) res = CAUCHY_ERR_NOMEM;
+        for (u64 slot = 0; died && slot < set->base.capacity; slot++) {
+            atomic_init(&died[slot], cauchy_snapshot_shadowed(&set->base_shadow, slot) ? 1 : 0);
         }
-        if (++iter->bucket_idx < iter->set->num_buckets) {
-            iter->current = iter->set->buckets[iter->bucket_idx];
+    }
+    cauchy_htable_iter_t iter;
+    cauchy_htable_iter_init(&iter, &set->index);
+    cauchy_orset_entry_t* entry;
+    while (res == CAUCHY_OK && (entry = cauchy_htable_iter_next(&iter)) != NULL) {
+        entry->view_slot = CAUCHY_MVCC_NONE;
+        if (!entry->removed) res = cauchy_mvcc_append(m, entry, &entry->view_slot);
+    }
+    if (res != CAUCHY_OK) {
+        cauchy_mvcc_fini(m);
+        free(m);
+        free(died);
+        return res;
+    }
+    set->views = m;
+    set->base_died = died;
+    publish(set);
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_orset_view_open(const cauchy_orset_t* set, cauchy_orset_view_t* view) {
+    if (!set || !view || !set->views) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_mvcc_view_open(set->views, &view->inner);
+    if (res != CAUCHY_OK) return res;
+    view->set = set;
+    view->base_slot = 0;
+    return CAUCHY_OK;
+}
+
+void cauchy_orset_view_close(cauchy_orset_view_t* view) {
+    if (!view || !view->set) return;
+    cauchy_mvcc_view_close(&view->inner);
+    view->set = NULL;
+}
+
+void cauchy_orset_view_rewind(cauchy_orset_view_t* view) {
+    if (!view) return;
+    cauchy_mvcc_view_rewind(&view->inner);
+    view->base_slot = 0;
+}
+
+/* Entries change in place, so only what never changes is read: the
+ * element, and the removed flag of a base record */
+bool cauchy_orset_view_next(cauchy_orset_view_t* view, const void** data, usize* size) {
+    if (!view || !view->set) return false;
+    const cauchy_orset_entry_t* entry = cauchy_mvcc_view_next(&view->inner);
+    cauchy_orset_entry_t base;
+    const cauchy_orset_t* set = view->set;
+    while (!entry && view->base_slot < set->base.capacity) {
+        u64 slot = view->base_slot++;
+        u64 died = atomic_load_explicit(&set->base_died[slot], memory_order_relaxed);
+        if (!cauchy_mvcc_view_sees(&view->inner, 1, died)) continue;
+        if (base_view(set, cauchy_snapshot_index_at(&set->base, slot), &base) && !base.removed) {
+            entry = &base;
         }
     }
-    return false;
+    if (!entry) return false;
+    if (data) *data = entry->data;
+    if (size) *size = entry->size;
+    return true;
+}
+
+usize cauchy_orset_view_count(const cauchy_orset_view_t* view) {
+    return view && view->set ? (usize)view->inner.meta[0] : 0;
+}
+
+u64 cauchy_orset_view_fingerprint(const cauchy_orset_view_t* view) {
+    return view && view->set ? view->inner.meta[1] : 0;
 }
 
 cauchy_result_t cauchy_orset_add_string(cauchy_orset_t* set, const char* str) {
@@ -280,8 +1101,107 @@ bool cauchy_orset_contains_string(const cauchy_orset_t* set, const char* str) {
     return cauchy_orset_contains(set, str, strlen(str) + 1);
 }
 
+/* Section body: timestamp, active count, the two fingerprints, clock,
+ * stable frontier, then the frozen index of all entries */
+cauchy_result_t cauchy_orset_snapshot_save(const cauchy_orset_t* set,
+                                           cauchy_snapshot_writer_t* w, u64 id) {
+    if (!set || !w) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_snapshot_writer_begin(w, CAUCHY_SNAPSHOT_OR_SET, id);
+    if (res != CAUCHY_OK) return res;
+
+    u64 meta[4] = { set->timestamp, set->active_count, set->fingerprint,
+                    set->live_fingerprint };
+    res = cauchy_snapshot_writer_put(w, meta, sizeof(meta));
+    if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put_vclock(w, &set->clock);
+    if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put_vclock(w, &set->stable);
+
+    cauchy_snapshot_index_builder_t b;
+    if (res == CAUCHY_OK) res = cauchy_snapshot_index_builder_init(&b, set->entry_count);
+    if (res != CAUCHY_OK) {
+        cauchy_snapshot_writer_end(w);
+        return res;
+    }
+
+    cauchy_orset_iter_t iter;
+    cauchy_orset_entry_t view;
+    const cauchy_orset_entry_t* e;
+    cauchy_orset_iter_init(&iter, set);
+    while ((e = iter_entry(&iter, &view)) != NULL) {
+        cauchy_snapshot_index_builder_place(&b, e->hash, BASE_RECORD_HEADER + e->size);
+    }
+    res = cauchy_snapshot_index_builder_write(&b, w);
+    cauchy_orset_iter_init(&iter, set);
+    while (res == CAUCHY_OK && (e = iter_entry(&iter, &view)) != NULL) {
+        u64 head[6] = { e->hash, e->tag.node_id, e->tag.timestamp,
+                        e->removed_by.node_id, e->removed_by.timestamp,
+                        (u64)e->size << 1 | (e->removed ? 1 : 0) };
+        res = cauchy_snapshot_writer_put(w, head, sizeof(head));
+        if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put(w, e->data, e->size);
+        if (res == CAUCHY_OK) res = cauchy_snapshot_writer_align(w);
+    }
+    cauchy_snapshot_index_builder_fini(&b);
+    cauchy_result_t end = cauchy_snapshot_writer_end(w);
+    return res != CAUCHY_OK ? res : end;
+}
+
+cauchy_result_t cauchy_orset_snapshot_load(cauchy_orset_t* set, cauchy_snapshot_t* snap, u64 id) {
+    if (!set) return CAUCHY_ERR_INVALID;
+    if (set->snapshot || set->views || set->entry_count) return CAUCHY_ERR_EXISTS;
+    const u8* data;
+    usize size;
+    cauchy_result_t res = cauchy_snapshot_find(snap, CAUCHY_SNAPSHOT_OR_SET, id, &data, &size);
+    if (res != CAUCHY_OK) return res;
+
+    cauchy_snapshot_cursor_t cur;
+    cauchy_snapshot_cursor_init(&cur, data, size);
+    u64 timestamp, active, fingerprint, live;
+    if (!cauchy_snapshot_get_u64(&cur, &timestamp) || !cauchy_snapshot_get_u64(&cur, &active) ||
+        !cauchy_snapshot_get_u64(&cur, &fingerprint) || !cauchy_snapshot_get_u64(&cur, &live)) {
+        return CAUCHY_ERR_INVALID;
+    }
+    cauchy_vclock_t clock, stable;
+    if (!cauchy_snapshot_get_vclock(&cur, &clock)) return CAUCHY_ERR_INVALID;
+    if (!cauchy_snapshot_get_vclock(&cur, &stable)) {
+        cauchy_vclock_fini(&clock);
+        return CAUCHY_ERR_INVALID;
+    }
+    cauchy_snapshot_index_t base;
+    res = cauchy_snapshot_index_parse(&base, cur.pos, cur.left);
+    if (res == CAUCHY_OK && active > base.count) res = CAUCHY_ERR_INVALID;
+    if (res != CAUCHY_OK) {
+        cauchy_vclock_fini(&clock);
+        cauchy_vclock_fini(&stable);
+        return res;
+    }
+
+    cauchy_vclock_fini(&set->clock);
+    cauchy_vclock_fini(&set->stable);
+    set->clock = clock;
+    set->stable = stable;
+    if (timestamp > set->timestamp) set->timestamp = timestamp;
+    set->base = base;
+    set->base_shadow.capacity = base.capacity;
+    set->base_cursor = 0;
+    set->entry_count = (usize)base.count;
+    set->active_count = (usize)active;
+    set->fingerprint = fingerprint;
+    set->live_fingerprint = live;
+    set->snapshot = cauchy_snapshot_retain(snap);
+    if (set->digest) {
+        cauchy_orset_iter_t iter;
+        cauchy_orset_entry_t view;
+        const cauchy_orset_entry_t* e;
+        cauchy_orset_iter_init(&iter, set);
+        while ((e = iter_entry(&iter, &view)) != NULL) {
+            cauchy_merkle_add(set->digest, e->hash, entry_digest(e));
+        }
+    }
+    return CAUCHY_OK;
+}
+
 void cauchy_orset_debug_print(const cauchy_orset_t* set, const char* label) {
     if (!set) { fprintf(stderr, "%s: (null)\n", label ? label : "orset"); return; }
-    fprintf(stderr, "%s: entries=%zu active=%zu\n",
-            label ? label : "orset", set->entry_count, set->active_count);
+    fprintf(stderr, "%s: entries=%zu active=%zu capacity=%zu%s\n",
+            label ? label : "orset", set->entry_count, set->active_count,
+            set->index.cur.capacity, set->index.old.slots ? " (resizing)" : "");
 }
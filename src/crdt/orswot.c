@@ -0,0 +1,658 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * ORSWOT Implementation
+ */
+
+#include "cauchy/crdt/orswot.h"
+#include "cauchy/stats.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* Dots judged per element in one join before the buffer goes to the heap */
+#define ORSWOT_STACK_DOTS 8
+
+/* Node-major order, so each node's cloud dots form an ascending run */
+CAUCHY_INLINE int dot_compare(const cauchy_uid_t* a, const cauchy_uid_t* b) {
+    if (a->node_id != b->node_id) return a->node_id < b->node_id ? -1 : 1;
+    if (a->timestamp != b->timestamp) return a->timestamp < b->timestamp ? -1 : 1;
+    return 0;
+}
+
+static void sort_dots(cauchy_uid_t* dots, u32 n) {
+    for (u32 i = 1; i < n; i++) {
+        cauchy_uid_t d = dots[i];
+        u32 j = i;
+        for (; j > 0 && dot_compare(&dots[j - 1], &d) > 0; j--) dots[j] = dots[j - 1];
+        dots[j] = d;
+    }
+}
+
+static bool dot_listed(const cauchy_uid_t* dots, u32 n, const cauchy_uid_t* d) {
+    for (u32 i = 0; i < n; i++) {
+        if (cauchy_uid_equals(&dots[i], d)) return true;
+    }
+    return false;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Causal context                                                            */
+
+static void ctx_init(cauchy_dot_context_t* c) {
+    cauchy_vclock_init(&c->cc, 0);
+    c->cloud = NULL;
+    c->cloud_count = 0;
+    c->cloud_capacity = 0;
+}
+
+static void ctx_fini(cauchy_dot_context_t* c) {
+    cauchy_vclock_fini(&c->cc);
+    free(c->cloud);
+    c->cloud = NULL;
+    c->cloud_count = 0;
+    c->cloud_capacity = 0;
+}
+
+static bool ctx_covers(const cauchy_dot_context_t* c, const cauchy_uid_t* d) {
+    if (d->timestamp <= cauchy_vclock_get(&c->cc, d->node_id)) return true;
+    u32 lo = 0, hi = c->cloud_count;
+    while (lo < hi) {
+        u32 mid = lo + (hi - lo) / 2;
+        int cmp = dot_compare(&c->cloud[mid], d);
+        if (cmp == 0) return true;
+        if (cmp < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return false;
+}
+
+/* Fold cloud dots that became contiguous into the vector */
+static void ctx_compact(cauchy_dot_context_t* c) {
+    u32 k = 0;
+    for (u32 i = 0; i < c->cloud_count; i++) {
+        const cauchy_uid_t* d = &c->cloud[i];
+        u64 top = cauchy_vclock_get(&c->cc, d->node_id);
+        if (d->timestamp <= top) continue;
+        if (d->timestamp == top + 1) {
+            cauchy_vclock_set(&c->cc, d->node_id, d->timestamp);
+            continue;
+        }
+        c->cloud[k++] = *d;
+    }
+    c->cloud_count = k;
+}
+
+static cauchy_result_t ctx_add(cauchy_dot_context_t* c, const cauchy_uid_t* d) {
+    if (ctx_covers(c, d)) return CAUCHY_OK;
+    if (d->timestamp == cauchy_vclock_get(&c->cc, d->node_id) + 1) {
+        cauchy_result_t res = cauchy_vclock_set(&c->cc, d->node_id, d->timestamp);
+        if (res == CAUCHY_OK && c->cloud_count) ctx_compact(c);
+        return res;
+    }
+
+    if (c->cloud_count == c->cloud_capacity) {
+        u32 cap = c->cloud_capacity ? c->cloud_capacity * 2 : 8;
+        cauchy_uid_t* grown = realloc(c->cloud, cap * sizeof(cauchy_uid_t));
+        if (!grown) return CAUCHY_ERR_NOMEM;
+        c->cloud = grown;
+        c->cloud_capacity = cap;
+    }
+    u32 pos = c->cloud_count;
+    while (pos > 0 && dot_compare(&c->cloud[pos - 1], d) > 0) {
+        c->cloud[pos] = c->cloud[pos - 1];
+        pos--;
+    }
+    c->cloud[pos] = *d;
+    c->cloud_count++;
+    return CAUCHY_OK;
+}
+
+static cauchy_result_t ctx_join(cauchy_dot_context_t* dst, const cauchy_dot_context_t* src) {
+    cauchy_result_t res = cauchy_vclock_merge(&dst->cc, &src->cc);
+    if (res != CAUCHY_OK) return res;
+    for (u32 i = 0; i < src->cloud_count && res == CAUCHY_OK; i++) {
+        res = ctx_add(dst, &src->cloud[i]);
+    }
+    ctx_compact(dst);
+    return res;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Entries                                                                   */
+
+static cauchy_result_t entry_set_dots(cauchy_orswot_entry_t* entry, const cauchy_uid_t* dots,
+                                      u32 n) {
+    if (n <= 1) {
+        if (entry->dots != &entry->first) free(entry->dots);
+        entry->dots = &entry->first;
+        entry->dot_capacity = 1;
+        if (n) entry->first = dots[0];
+    } else if (entry->dots == &entry->first || entry->dot_capacity < n) {
+        cauchy_uid_t* arr = malloc(n * sizeof(cauchy_uid_t));
+        if (!arr) return CAUCHY_ERR_NOMEM;
+        if (entry->dots != &entry->first) free(entry->dots);
+        entry->dots = arr;
+        entry->dot_capacity = n;
+    }
+    if (n > 1) memcpy(entry->dots, dots, n * sizeof(cauchy_uid_t));
+    entry->dot_count = n;
+    return CAUCHY_OK;
+}
+
+/* An entry gained its first dot, or lost its last */
+static void set_active(cauchy_orswot_t* set, const cauchy_orswot_entry_t* entry, bool active) {
+    if (active) {
+        set->active_count++;
+        set->fingerprint += cauchy_merkle_item(entry->hash);
+    } else {
+        set->active_count--;
+        set->fingerprint -= cauchy_merkle_item(entry->hash);
+    }
+}
+
+static void free_entry(cauchy_orswot_t* set, cauchy_orswot_entry_t* entry) {
+    if (entry->dots != &entry->first) free(entry->dots);
+    cauchy_pool_free(set->entry_pool, entry);
+}
+
+static cauchy_orswot_entry_t* find_entry(const cauchy_orswot_t* set, u64 h,
+                                         const void* data, usize size) {
+    cauchy_htable_probe_t probe;
+    cauchy_htable_probe_init(&probe, &set->index, h);
+    cauchy_orswot_entry_t* entry;
+    while ((entry = cauchy_htable_probe_next(&probe)) != NULL) {
+        if (entry->hash == h && entry->size == size && memcmp(entry->data, data, size) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static cauchy_result_t insert_entry(cauchy_orswot_t* set, const void* data, usize size, u64 h,
+                                    const cauchy_uid_t* dots, u32 n) {
+    cauchy_orswot_entry_t* entry = cauchy_pool_alloc(set->entry_pool);
+    if (!entry) return CAUCHY_ERR_NOMEM;
+
+    entry->data = size <= CAUCHY_ORSWOT_INLINE_SIZE
+        ? entry->inline_data
+        : cauchy_arena_alloc(&set->payloads, size);
+    if (!entry->data) {
+        cauchy_pool_free(set->entry_pool, entry);
+        return CAUCHY_ERR_NOMEM;
+    }
+    memcpy(entry->data, data, size);
+    entry->size = size;
+    entry->hash = h;
+    entry->dots = &entry->first;
+    entry->dot_count = 0;
+    entry->dot_capacity = 1;
+
+    cauchy_result_t res = entry_set_dots(entry, dots, n);
+    if (res == CAUCHY_OK) res = cauchy_htable_insert(&set->index, h, entry);
+    if (res != CAUCHY_OK) {
+        free_entry(set, entry);
+        return res;
+    }
+    if (n) set_active(set, entry, true);
+    return CAUCHY_OK;
+}
+
+/* Join the other side's view of one element (its dots, judged against
+ * its context) into dst, judging the other side's dots against dst's
+ * context. Contexts are joined afterwards by the caller. Never removes
+ * an entry: whether a dotless one goes is up to the caller. */
+static cauchy_result_t join_element(cauchy_orswot_t* dst, cauchy_orswot_entry_t* mine,
+                                    u64 h, const void* data, usize size,
+                                    const cauchy_uid_t* theirs, u32 n_theirs,
+                                    const cauchy_dot_context_t* their_ctx) {
+    u32 n_mine = mine ? mine->dot_count : 0;
+    u32 cap = n_mine + n_theirs;
+    cauchy_uid_t stack[ORSWOT_STACK_DOTS];
+    cauchy_uid_t* out = cap <= ORSWOT_STACK_DOTS ? stack : malloc(cap * sizeof(cauchy_uid_t));
+    if (!out) return CAUCHY_ERR_NOMEM;
+
+    u32 k = 0;
+    for (u32 i = 0; i < n_mine; i++) {
+        const cauchy_uid_t* d = &mine->dots[i];
+        if (dot_listed(theirs, n_theirs, d) || !ctx_covers(their_ctx, d)) out[k++] = *d;
+    }
+    for (u32 i = 0; i < n_theirs; i++) {
+        const cauchy_uid_t* d = &theirs[i];
+        if (mine && dot_listed(mine->dots, n_mine, d)) continue;
+        if (!ctx_covers(&dst->context, d)) out[k++] = *d;
+    }
+
+    cauchy_result_t res = CAUCHY_OK;
+    if (mine) {
+        bool was_active = n_mine > 0;
+        res = entry_set_dots(mine, out, k);
+        if (res == CAUCHY_OK && was_active != (k > 0)) set_active(dst, mine, k > 0);
+    } else if (k > 0 || dst->is_delta) {
+        res = insert_entry(dst, data, size, h, out, k);
+    }
+    if (out != stack) free(out);
+    return res;
+}
+
+static void drop_entry(cauchy_orswot_t* set, cauchy_orswot_entry_t* entry) {
+    cauchy_htable_remove(&set->index, entry->hash, entry);
+    if (entry->dot_count) set_active(set, entry, false);
+    free_entry(set, entry);
+}
+
+/* ------------------------------------------------------------------------ */
+
+cauchy_result_t cauchy_orswot_init(cauchy_orswot_t* set, usize initial_capacity,
+                                   cauchy_node_id_t node_id) {
+    if (!set) return CAUCHY_ERR_INVALID;
+    if (initial_capacity == 0) initial_capacity = 16;
+
+    cauchy_result_t res = cauchy_htable_init(&set->index, initial_capacity);
+    if (res != CAUCHY_OK) return res;
+
+    cauchy_pool_config_t cfg = {
+        .block_size = sizeof(cauchy_orswot_entry_t) + CAUCHY_ORSWOT_INLINE_SIZE,
+        .initial_blocks = 128,
+        .max_blocks = 0,
+        .alignment = sizeof(void*)
+    };
+    set->entry_pool = cauchy_pool_create(&cfg);
+    if (!set->entry_pool) {
+        cauchy_htable_destroy(&set->index);
+        return CAUCHY_ERR_NOMEM;
+    }
+    cauchy_arena_init(&set->payloads, 0);
+    set->active_count = 0;
+    set->fingerprint = 0;
+    set->node_id = node_id;
+    ctx_init(&set->context);
+    set->is_delta = false;
+    return CAUCHY_OK;
+}
+
+cauchy_orswot_t* cauchy_orswot_create(usize initial_capacity, cauchy_node_id_t node_id) {
+    cauchy_orswot_t* set = malloc(sizeof(cauchy_orswot_t));
+    if (!set) return NULL;
+    if (cauchy_orswot_init(set, initial_capacity, node_id) != CAUCHY_OK) {
+        free(set);
+        return NULL;
+    }
+    return set;
+}
+
+void cauchy_orswot_destroy(cauchy_orswot_t* set) {
+    if (!set) return;
+    cauchy_htable_iter_t iter;
+    cauchy_htable_iter_init(&iter, &set->index);
+    cauchy_orswot_entry_t* entry;
+    while ((entry = cauchy_htable_iter_next(&iter)) != NULL) {
+        if (entry->dots != &entry->first) free(entry->dots);
+    }
+    cauchy_htable_destroy(&set->index);
+    if (set->entry_pool) cauchy_pool_destroy(set->entry_pool);
+    cauchy_arena_destroy(&set->payloads);
+    ctx_fini(&set->context);
+    free(set);
+}
+
+/* Replace the element's dots with a fresh one of ours */
+static cauchy_result_t add_hashed(cauchy_orswot_t* set, const void* data, usize size, u64 h,
+                                  cauchy_uid_t* dot) {
+    *dot = cauchy_uid_create(set->node_id,
+                             cauchy_vclock_get(&set->context.cc, set->node_id) + 1);
+    cauchy_orswot_entry_t* entry = find_entry(set, h, data, size);
+    cauchy_result_t res;
+    if (entry) {
+        bool was_active = entry->dot_count > 0;
+        res = entry_set_dots(entry, dot, 1);
+        if (res == CAUCHY_OK && !was_active) set_active(set, entry, true);
+    } else {
+        res = insert_entry(set, data, size, h, dot, 1);
+    }
+    if (res != CAUCHY_OK) return res;
+    return ctx_add(&set->context, dot);
+}
+
+cauchy_result_t cauchy_orswot_add(cauchy_orswot_t* set, const void* data, usize size) {
+    if (!set || !data || size == 0) return CAUCHY_ERR_INVALID;
+    cauchy_uid_t dot;
+    return add_hashed(set, data, size, cauchy_hash_bytes(data, size), &dot);
+}
+
+cauchy_result_t cauchy_orswot_remove(cauchy_orswot_t* set, const void* data, usize size) {
+    if (!set || !data || size == 0) return CAUCHY_ERR_INVALID;
+    cauchy_orswot_entry_t* entry = find_entry(set, cauchy_hash_bytes(data, size), data, size);
+    if (!entry || entry->dot_count == 0) return CAUCHY_ERR_NOTFOUND;
+    drop_entry(set, entry);
+    return CAUCHY_OK;
+}
+
+/* Join one operation, described by the element's surviving dots and the
+ * dots it observed, into a delta */
+static cauchy_result_t join_op(cauchy_orswot_t* delta, const void* data, usize size, u64 h,
+                               const cauchy_uid_t* dots, u32 n, cauchy_uid_t* seen, u32 n_seen) {
+    sort_dots(seen, n_seen);
+    cauchy_dot_context_t op;
+    ctx_init(&op);
+    op.cloud = seen;
+    op.cloud_count = n_seen;
+    op.cloud_capacity = n_seen;
+
+    delta->is_delta = true;
+    cauchy_orswot_entry_t* mine = find_entry(delta, h, data, size);
+    cauchy_result_t res = join_element(delta, mine, h, data, size, dots, n, &op);
+    if (res == CAUCHY_OK) res = ctx_join(&delta->context, &op);
+    return res;
+}
+
+/* Copy of an entry's dots with room for one more */
+static cauchy_uid_t* observed_dots(const cauchy_orswot_entry_t* entry, u32* n,
+                                   cauchy_uid_t* stack) {
+    *n = entry ? entry->dot_count : 0;
+    cauchy_uid_t* seen = *n < ORSWOT_STACK_DOTS ? stack : malloc((*n + 1) * sizeof(cauchy_uid_t));
+    if (seen && *n) memcpy(seen, entry->dots, *n * sizeof(cauchy_uid_t));
+    return seen;
+}
+
+cauchy_result_t cauchy_orswot_add_delta(cauchy_orswot_t* set, const void* data, usize size,
+                                        cauchy_orswot_t* delta) {
+    if (!set || !delta || !data || size == 0) return CAUCHY_ERR_INVALID;
+
+    u64 h = cauchy_hash_bytes(data, size);
+    cauchy_uid_t stack[ORSWOT_STACK_DOTS];
+    u32 n_seen;
+    cauchy_uid_t* seen = observed_dots(find_entry(set, h, data, size), &n_seen, stack);
+    if (!seen) return CAUCHY_ERR_NOMEM;
+
+    cauchy_uid_t dot;
+    cauchy_result_t res = add_hashed(set, data, size, h, &dot);
+    if (res == CAUCHY_OK) {
+        seen[n_seen++] = dot;
+        res = join_op(delta, data, size, h, &dot, 1, seen, n_seen);
+    }
+    if (seen != stack) free(seen);
+    return res;
+}
+
+cauchy_result_t cauchy_orswot_remove_delta(cauchy_orswot_t* set, const void* data, usize size,
+                                           cauchy_orswot_t* delta) {
+    if (!set || !delta || !data || size == 0) return CAUCHY_ERR_INVALID;
+
+    u64 h = cauchy_hash_bytes(data, size);
+    cauchy_orswot_entry_t* entry = find_entry(set, h, data, size);
+    if (!entry || entry->dot_count == 0) return CAUCHY_ERR_NOTFOUND;
+
+    cauchy_uid_t stack[ORSWOT_STACK_DOTS];
+    u32 n_seen;
+    cauchy_uid_t* seen = observed_dots(entry, &n_seen, stack);
+    if (!seen) return CAUCHY_ERR_NOMEM;
+
+    /* The delta names the element with no dots: receivers drop whatever
+     * dots of it the delta's context covers */
+    drop_entry(set, entry);
+    cauchy_result_t res = join_op(delta, data, size, h, NULL, 0, seen, n_seen);
+    if (seen != stack) free(seen);
+    return res;
+}
+
+static bool is_dotless(void* item, void* arg) {
+    cauchy_orswot_entry_t* entry = item;
+    if (entry->dot_count) return false;
+    free_entry(arg, entry);
+    return true;
+}
+
+cauchy_result_t cauchy_orswot_merge(cauchy_orswot_t* dst, const cauchy_orswot_t* src) {
+    if (!dst || !src) return CAUCHY_ERR_INVALID;
+    if (dst == src) return CAUCHY_OK;
+
+    u64 start = CAUCHY_STAT_NOW();
+    /* Our elements against their dots and context */
+    bool emptied = false;
+    cauchy_htable_iter_t iter;
+    cauchy_htable_iter_init(&iter, &dst->index);
+    cauchy_orswot_entry_t* mine;
+    while ((mine = cauchy_htable_iter_next(&iter)) != NULL) {
+        const cauchy_orswot_entry_t* theirs = find_entry(src, mine->hash, mine->data, mine->size);
+        bool was_active = mine->dot_count > 0;
+        cauchy_result_t res = join_element(dst, mine, mine->hash, mine->data, mine->size,
+                                           theirs ? theirs->dots : NULL,
+                                           theirs ? theirs->dot_count : 0, &src->context);
+        if (res != CAUCHY_OK) return res;
+        if (was_active && mine->dot_count == 0) emptied = true;
+    }
+
+    /* Their elements we lack entirely */
+    cauchy_htable_iter_init(&iter, &src->index);
+    const cauchy_orswot_entry_t* theirs;
+    while ((theirs = cauchy_htable_iter_next(&iter)) != NULL) {
+        if (find_entry(dst, theirs->hash, theirs->data, theirs->size)) continue;
+        cauchy_result_t res = join_element(dst, NULL, theirs->hash, theirs->data, theirs->size,
+                                           theirs->dots, theirs->dot_count, &src->context);
+        if (res != CAUCHY_OK) return res;
+    }
+
+    if (emptied && !dst->is_delta) {
+        usize cursor = 0;
+        cauchy_htable_finish_resize(&dst->index);
+        cauchy_htable_sweep(&dst->index, &cursor, SIZE_MAX, is_dotless, dst);
+    }
+    CAUCHY_STAT_MERGE(CAUCHY_STAT_CRDT_ORSWOT,
+                      cauchy_htable_count(&dst->index) + cauchy_htable_count(&src->index),
+                      CAUCHY_STAT_NOW() - start, cauchy_htable_count(&dst->index), 0);
+    return ctx_join(&dst->context, &src->context);
+}
+
+cauchy_result_t cauchy_orswot_merge_delta(cauchy_orswot_t* dst, const cauchy_orswot_t* delta) {
+    if (!dst || !delta) return CAUCHY_ERR_INVALID;
+    if (dst == delta) return CAUCHY_OK;
+    if (!delta->is_delta) return cauchy_orswot_merge(dst, delta);
+
+    /* A delta names every element its context affects */
+    cauchy_htable_iter_t iter;
+    cauchy_htable_iter_init(&iter, &delta->index);
+    const cauchy_orswot_entry_t* theirs;
+    while ((theirs = cauchy_htable_iter_next(&iter)) != NULL) {
+        cauchy_orswot_entry_t* mine = find_entry(dst, theirs->hash, theirs->data, theirs->size);
+        cauchy_result_t res = join_element(dst, mine, theirs->hash, theirs->data, theirs->size,
+                                           theirs->dots, theirs->dot_count, &delta->context);
+        if (res != CAUCHY_OK) return res;
+        if (mine && mine->dot_count == 0 && !dst->is_delta) drop_entry(dst, mine);
+    }
+    return ctx_join(&dst->context, &delta->context);
+}
+
+bool cauchy_orswot_contains(const cauchy_orswot_t* set, const void* data, usize size) {
+    if (!set || !data || size == 0) return false;
+    const cauchy_orswot_entry_t* entry = find_entry(set, cauchy_hash_bytes(data, size), data, size);
+    return entry && entry->dot_count > 0;
+}
+
+usize cauchy_orswot_count(const cauchy_orswot_t* set) {
+    return set ? set->active_count : 0;
+}
+
+bool cauchy_orswot_is_empty(const cauchy_orswot_t* set) {
+    return !set || set->active_count == 0;
+}
+
+u64 cauchy_orswot_fingerprint(const cauchy_orswot_t* set) {
+    return set ? set->fingerprint : 0;
+}
+
+bool cauchy_orswot_equals(const cauchy_orswot_t* a, const cauchy_orswot_t* b) {
+    if (!a || !b) return a == b;
+    if (a->active_count != b->active_count || a->fingerprint != b->fingerprint) return false;
+
+    cauchy_htable_iter_t iter;
+    cauchy_htable_iter_init(&iter, &a->index);
+    const cauchy_orswot_entry_t* entry;
+    while ((entry = cauchy_htable_iter_next(&iter)) != NULL) {
+        if (entry->dot_count == 0) continue;
+        const cauchy_orswot_entry_t* other = find_entry(b, entry->hash, entry->data, entry->size);
+        if (!other || other->dot_count == 0) return false;
+    }
+    return true;
+}
+
+const cauchy_vclock_t* cauchy_orswot_clock(const cauchy_orswot_t* set) {
+    return set ? &set->context.cc : NULL;
+}
+
+void cauchy_orswot_iter_init(cauchy_orswot_iter_t* iter, const cauchy_orswot_t* set) {
+    if (!iter) return;
+    iter->set = set;
+    cauchy_htable_iter_init(&iter->inner, set ? &set->index : NULL);
+}
+
+bool cauchy_orswot_iter_next(cauchy_orswot_iter_t* iter, const void** data, usize* size) {
+    if (!iter || !iter->set) return false;
+
+    const cauchy_orswot_entry_t* entry;
+    while ((entry = cauchy_htable_iter_next(&iter->inner)) != NULL) {
+        if (entry->dot_count == 0) continue;
+        if (data) *data = entry->data;
+        if (size) *size = entry->size;
+        return true;
+    }
+    return false;
+}
+
+cauchy_result_t cauchy_orswot_add_string(cauchy_orswot_t* set, const char* str) {
+    if (!str) return CAUCHY_ERR_INVALID;
+    return cauchy_orswot_add(set, str, strlen(str) + 1);
+}
+
+cauchy_result_t cauchy_orswot_remove_string(cauchy_orswot_t* set, const char* str) {
+    if (!str) return CAUCHY_ERR_INVALID;
+    return cauchy_orswot_remove(set, str, strlen(str) + 1);
+}
+
+bool cauchy_orswot_contains_string(const cauchy_orswot_t* set, const char* str) {
+    if (!str) return false;
+    return cauchy_orswot_contains(set, str, strlen(str) + 1);
+}
+
+/* Section body: delta flag, context vector, cloud, entry count, then
+ * each entry as hash, size, dot count, dots and the bytes. Small enough
+ * per element that loading rebuilds the index. */
+cauchy_result_t cauchy_orswot_snapshot_save(const cauchy_orswot_t* set,
+                                            cauchy_snapshot_writer_t* w, u64 id) {
+    if (!set || !w) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_snapshot_writer_begin(w, CAUCHY_SNAPSHOT_ORSWOT, id);
+    if (res != CAUCHY_OK) return res;
+
+    const cauchy_dot_context_t* ctx = &set->context;
+    res = cauchy_snapshot_writer_put_u64(w, set->is_delta);
+    if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put_vclock(w, &ctx->cc);
+    if (res == CAUCHY_OK) {
+        res = cauchy_snapshot_writer_put_blob(w, ctx->cloud, ctx->cloud_count * sizeof(cauchy_uid_t));
+    }
+    if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put_u64(w, cauchy_htable_count(&set->index));
+
+    cauchy_htable_iter_t iter;
+    cauchy_htable_iter_init(&iter, &set->index);
+    const cauchy_orswot_entry_t* entry;
+    while (res == CAUCHY_OK && (entry = cauchy_htable_iter_next(&iter)) != NULL) {
+        u64 head[3] = { entry->hash, entry->size, entry->dot_count };
+        res = cauchy_snapshot_writer_put(w, head, sizeof(head));
+        if (res == CAUCHY_OK) {
+            res = cauchy_snapshot_writer_put(w, entry->dots, entry->dot_count * sizeof(cauchy_uid_t));
+        }
+        if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put_blob(w, entry->data, entry->size);
+    }
+    cauchy_result_t end = cauchy_snapshot_writer_end(w);
+    return res != CAUCHY_OK ? res : end;
+}
+
+/* Next entry of a section; false if it is malformed or its stored hash
+ * does not match its bytes (it would be filed in the wrong bucket) */
+static bool next_entry(cauchy_snapshot_cursor_t* cur, u64* h, const cauchy_uid_t** dots,
+                       u32* n, const u8** bytes, usize* len) {
+    u64 head[3];
+    if (!cauchy_snapshot_get_u64(cur, &head[0]) || !cauchy_snapshot_get_u64(cur, &head[1]) ||
+        !cauchy_snapshot_get_u64(cur, &head[2]) || head[2] > UINT32_MAX ||
+        head[2] > cur->left / sizeof(cauchy_uid_t)) {
+        return false;
+    }
+    *dots = (const cauchy_uid_t*)cur->pos;
+    cur->pos += head[2] * sizeof(cauchy_uid_t);
+    cur->left -= head[2] * sizeof(cauchy_uid_t);
+    if (!cauchy_snapshot_get_blob(cur, bytes, len) || *len != head[1] || *len == 0 ||
+        cauchy_hash_bytes(*bytes, *len) != head[0]) {
+        return false;
+    }
+    *h = head[0];
+    *n = (u32)head[2];
+    return true;
+}
+
+/* The whole section is validated first; a failure while inserting drops
+ * the entries already inserted */
+cauchy_result_t cauchy_orswot_snapshot_load(cauchy_orswot_t* set, cauchy_snapshot_t* snap, u64 id) {
+    if (!set) return CAUCHY_ERR_INVALID;
+    if (cauchy_htable_count(&set->index)) return CAUCHY_ERR_EXISTS;
+    const u8* data;
+    usize size;
+    cauchy_result_t res = cauchy_snapshot_find(snap, CAUCHY_SNAPSHOT_ORSWOT, id, &data, &size);
+    if (res != CAUCHY_OK) return res;
+
+    cauchy_snapshot_cursor_t cur;
+    cauchy_snapshot_cursor_init(&cur, data, size);
+    u64 is_delta, count;
+    const u8* cloud;
+    usize cloud_size;
+    if (!cauchy_snapshot_get_u64(&cur, &is_delta)) return CAUCHY_ERR_INVALID;
+    cauchy_dot_context_t ctx;
+    ctx_init(&ctx);
+    if (!cauchy_snapshot_get_vclock(&cur, &ctx.cc)) return CAUCHY_ERR_INVALID;
+    if (!cauchy_snapshot_get_blob(&cur, &cloud, &cloud_size) ||
+        cloud_size % sizeof(cauchy_uid_t) != 0 || !cauchy_snapshot_get_u64(&cur, &count)) {
+        ctx_fini(&ctx);
+        return CAUCHY_ERR_INVALID;
+    }
+    cauchy_snapshot_cursor_t entries = cur;
+    u64 h;
+    const cauchy_uid_t* dots;
+    u32 n;
+    const u8* bytes;
+    usize len;
+    for (u64 i = 0; i < count; i++) {
+        if (!next_entry(&cur, &h, &dots, &n, &bytes, &len)) {
+            ctx_fini(&ctx);
+            return CAUCHY_ERR_INVALID;
+        }
+    }
+    for (usize i = 0; i < cloud_size / sizeof(cauchy_uid_t) && res == CAUCHY_OK; i++) {
+        res = ctx_add(&ctx, (const cauchy_uid_t*)cloud + i);
+    }
+
+    u64 inserted = 0;
+    cur = entries;
+    while (res == CAUCHY_OK && inserted < count) {
+        next_entry(&cur, &h, &dots, &n, &bytes, &len);
+        res = find_entry(set, h, bytes, len) ? CAUCHY_ERR_INVALID
+                                             : insert_entry(set, bytes, len, h, dots, n);
+        if (res == CAUCHY_OK) inserted++;
+    }
+    if (res != CAUCHY_OK) {
+        cur = entries;
+        for (u64 i = 0; i < inserted; i++) {
+            next_entry(&cur, &h, &dots, &n, &bytes, &len);
+            drop_entry(set, find_entry(set, h, bytes, len));
+        }
+        ctx_fini(&ctx);
+        return res;
+    }
+    ctx_fini(&set->context);
+    set->context = ctx;
+    set->is_delta = is_delta != 0;
+    return CAUCHY_OK;
+}
+
+void cauchy_orswot_debug_print(const cauchy_orswot_t* set, const char* label) {
+    if (!set) { fprintf(stderr, "%s: (null)\n", label ? label : "orswot"); return; }
+    fprintf(stderr, "%s: entries=%zu active=%zu cloud=%u%s\n",
+            label ? label : "orswot", cauchy_htable_count(&set->index), set->active_count,
+            set->context.cloud_count, set->is_delta ? " (delta)" : "");
+}
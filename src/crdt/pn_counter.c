@@ -22,33 +22,60 @@ cauchy_pncounter_t* cauchy_pncounter_create(u32 num_nodes) {
     return pn;
 }
 
+void cauchy_pncounter_fini(cauchy_pncounter_t* pn) {
+    if (!pn) return;
+    cauchy_gcounter_fini(&pn->positive);
+    cauchy_gcounter_fini(&pn->negative);
+}
+
 void cauchy_pncounter_destroy(cauchy_pncounter_t* pn) {
+    cauchy_pncounter_fini(pn);
     cauchy_aligned_free(pn);
 }
 
-void cauchy_pncounter_increment(cauchy_pncounter_t* pn, cauchy_node_id_t node_id) {
-    if (!pn) return;
-    cauchy_gcounter_increment(&pn->positive, node_id);
+cauchy_result_t cauchy_pncounter_increment(cauchy_pncounter_t* pn, cauchy_node_id_t node_id) {
+    if (!pn) return CAUCHY_ERR_INVALID;
+    return cauchy_gcounter_increment(&pn->positive, node_id);
 }
 
-void cauchy_pncounter_decrement(cauchy_pncounter_t* pn, cauchy_node_id_t node_id) {
-    if (!pn) return;
-    cauchy_gcounter_increment(&pn->negative, node_id);
+cauchy_result_t cauchy_pncounter_decrement(cauchy_pncounter_t* pn, cauchy_node_id_t node_id) {
+    if (!pn) return CAUCHY_ERR_INVALID;
+    return cauchy_gcounter_increment(&pn->negative, node_id);
 }
 
-void cauchy_pncounter_add(cauchy_pncounter_t* pn, cauchy_node_id_t node_id, i64 delta) {
-    if (!pn) return;
+cauchy_result_t cauchy_pncounter_add(cauchy_pncounter_t* pn, cauchy_node_id_t node_id, i64 delta) {
+    if (!pn) return CAUCHY_ERR_INVALID;
     if (delta >= 0) {
-        cauchy_gcounter_add(&pn->positive, node_id, (u64)delta);
-    } else {
-        cauchy_gcounter_add(&pn->negative, node_id, (u64)(-delta));
+        return cauchy_gcounter_add(&pn->positive, node_id, (u64)delta);
     }
+    return cauchy_gcounter_add(&pn->negative, node_id, -(u64)delta);
+}
+
+cauchy_result_t cauchy_pncounter_increment_delta(cauchy_pncounter_t* pn, cauchy_node_id_t node_id,
+                                                 cauchy_pncounter_t* delta) {
+    if (!pn || !delta) return CAUCHY_ERR_INVALID;
+    return cauchy_gcounter_increment_delta(&pn->positive, node_id, &delta->positive);
+}
+
+cauchy_result_t cauchy_pncounter_decrement_delta(cauchy_pncounter_t* pn, cauchy_node_id_t node_id,
+                                                 cauchy_pncounter_t* delta) {
+    if (!pn || !delta) return CAUCHY_ERR_INVALID;
+    return cauchy_gcounter_increment_delta(&pn->negative, node_id, &delta->negative);
+}
+
+cauchy_result_t cauchy_pncounter_add_delta(cauchy_pncounter_t* pn, cauchy_node_id_t node_id,
+                                           i64 amount, cauchy_pncounter_t* delta) {
+    if (!pn || !delta) return CAUCHY_ERR_INVALID;
+    if (amount >= 0) {
+        return cauchy_gcounter_add_delta(&pn->positive, node_id, (u64)amount, &delta->positive);
+    }
+    return cauchy_gcounter_add_delta(&pn->negative, node_id, -(u64)amount, &delta->negative);
 }
 
 i64 cauchy_pncounter_value(const cauchy_pncounter_t* pn) {
     if (!pn) return 0;
-    return (i64)cauchy_gcounter_value(&pn->positive) - 
-           (i64)cauchy_gcounter_value(&pn->negative);
+    return (i64)(cauchy_gcounter_value(&pn->positive) -
+                 cauchy_gcounter_value(&pn->negative));
 }
 
 u64 cauchy_pncounter_positive(const cauchy_pncounter_t* pn) {
@@ -61,10 +88,18 @@ u64 cauchy_pncounter_negative(const cauchy_pncounter_t* pn) {
     return cauchy_gcounter_value(&pn->negative);
 }
 
-void cauchy_pncounter_merge(cauchy_pncounter_t* dst, const cauchy_pncounter_t* src) {
-    if (!dst || !src) return;
-    cauchy_gcounter_merge(&dst->positive, &src->positive);
-    cauchy_gcounter_merge(&dst->negative, &src->negative);
+cauchy_result_t cauchy_pncounter_merge(cauchy_pncounter_t* dst, const cauchy_pncounter_t* src) {
+    if (!dst || !src) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_gcounter_merge(&dst->positive, &src->positive);
+    if (res != CAUCHY_OK) return res;
+    return cauchy_gcounter_merge(&dst->negative, &src->negative);
+}
+
+cauchy_result_t cauchy_pncounter_merge_delta(cauchy_pncounter_t* dst, const cauchy_pncounter_t* delta) {
+    if (!dst || !delta) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_gcounter_merge_delta(&dst->positive, &delta->positive);
+    if (res != CAUCHY_OK) return res;
+    return cauchy_gcounter_merge_delta(&dst->negative, &delta->negative);
 }
 
 bool cauchy_pncounter_equals(const cauchy_pncounter_t* a, const cauchy_pncounter_t* b) {
@@ -73,16 +108,28 @@ bool cauchy_pncounter_equals(const cauchy_pncounter_t* a, const cauchy_pncounter
            cauchy_gcounter_equals(&a->negative, &b->negative);
 }
 
-void cauchy_pncounter_copy(cauchy_pncounter_t* dst, const cauchy_pncounter_t* src) {
-    if (!dst || !src) return;
-    cauchy_gcounter_copy(&dst->positive, &src->positive);
-    cauchy_gcounter_copy(&dst->negative, &src->negative);
+cauchy_result_t cauchy_pncounter_copy(cauchy_pncounter_t* dst, const cauchy_pncounter_t* src) {
+    if (!dst || !src) return CAUCHY_ERR_INVALID;
+    if (dst == src) return CAUCHY_OK;
+    cauchy_result_t res = cauchy_gcounter_copy(&dst->positive, &src->positive);
+    if (res != CAUCHY_OK) {
+        cauchy_gcounter_init(&dst->negative, src->negative.num_nodes);
+        return res;
+    }
+    res = cauchy_gcounter_copy(&dst->negative, &src->negative);
+    if (res != CAUCHY_OK) cauchy_gcounter_fini(&dst->positive);
+    return res;
 }
 
 cauchy_pncounter_t* cauchy_pncounter_clone(const cauchy_pncounter_t* pn) {
     if (!pn) return NULL;
     cauchy_pncounter_t* clone = cauchy_pncounter_create(pn->positive.num_nodes);
-    if (clone) cauchy_pncounter_copy(clone, pn);
+    if (!clone) return NULL;
+    cauchy_pncounter_fini(clone);
+    if (cauchy_pncounter_copy(clone, pn) != CAUCHY_OK) {
+        cauchy_pncounter_destroy(clone);
+        return NULL;
+    }
     return clone;
 }
 
@@ -111,11 +158,166 @@ cauchy_result_t cauchy_pncounter_deserialize(cauchy_pncounter_t* pn,
                                               const u8* buffer, usize size) {
     if (!pn || !buffer || size < sizeof(u32) * 2) return CAUCHY_ERR_INVALID;
     
-    cauchy_result_t res = cauchy_gcounter_deserialize(&pn->positive, buffer, size);
+    cauchy_gcounter_t positive, negative;
+    cauchy_result_t res = cauchy_gcounter_deserialize(&positive, buffer, size);
     if (res != CAUCHY_OK) return res;
     
-    usize pos_size = cauchy_gcounter_serialized_size(&pn->positive);
-    return cauchy_gcounter_deserialize(&pn->negative, buffer + pos_size, size - pos_size);
+    usize pos_size = cauchy_vclock_peek_serialized_size(buffer, size);
+    res = cauchy_gcounter_deserialize(&negative, buffer + pos_size, size - pos_size);
+    if (res != CAUCHY_OK) {
+        cauchy_gcounter_fini(&positive);
+        return res;
+    }
+    pn->positive = positive;
+    pn->negative = negative;
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_pncounter_snapshot_save(const cauchy_pncounter_t* pn,
+                                               cauchy_snapshot_writer_t* w, u64 id) {
+    if (!pn || !w) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_snapshot_writer_begin(w, CAUCHY_SNAPSHOT_PN_COUNTER, id);
+    if (res != CAUCHY_OK) return res;
+    res = cauchy_snapshot_writer_put_vclock(w, &pn->positive);
+    if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put_vclock(w, &pn->negative);
+    cauchy_result_t end = cauchy_snapshot_writer_end(w);
+    return res != CAUCHY_OK ? res : end;
+}
+
+cauchy_result_t cauchy_pncounter_snapshot_load(cauchy_pncounter_t* pn, cauchy_snapshot_t* snap,
+                                               u64 id) {
+    if (!pn) return CAUCHY_ERR_INVALID;
+    const u8* data;
+    usize size;
+    cauchy_result_t res = cauchy_snapshot_find(snap, CAUCHY_SNAPSHOT_PN_COUNTER, id, &data, &size);
+    if (res != CAUCHY_OK) return res;
+
+    cauchy_snapshot_cursor_t cur;
+    cauchy_gcounter_t positive, negative;
+    cauchy_snapshot_cursor_init(&cur, data, size);
+    if (!cauchy_snapshot_get_vclock(&cur, &positive)) return CAUCHY_ERR_INVALID;
+    if (!cauchy_snapshot_get_vclock(&cur, &negative)) {
+        cauchy_gcounter_fini(&positive);
+        return CAUCHY_ERR_INVALID;
+    }
+    cauchy_pncounter_fini(pn);
+    pn->positive = positive;
+    pn->negative = negative;
+    return CAUCHY_OK;
+}
+
+usize cauchy_pncounter_encoded_size(const cauchy_pncounter_t* pn, const cauchy_pncounter_t* base) {
+    if (!pn) return 0;
+    return cauchy_gcounter_encoded_size(&pn->positive, base ? &base->positive : NULL) +
+           cauchy_gcounter_encoded_size(&pn->negative, base ? &base->negative : NULL);
+}
+
+usize cauchy_pncounter_encode(const cauchy_pncounter_t* pn, const cauchy_pncounter_t* base,
+                              u8* buffer, usize size) {
+    if (!pn || !buffer) return 0;
+    if (size < cauchy_pncounter_encoded_size(pn, base)) return 0;
+
+    usize pos_size = cauchy_gcounter_encode(&pn->positive, base ? &base->positive : NULL,
+                                            buffer, size);
+    if (pos_size == 0) return 0;
+
+    usize neg_size = cauchy_gcounter_encode(&pn->negative, base ? &base->negative : NULL,
+                                            buffer + pos_size, size - pos_size);
+    if (neg_size == 0) return 0;
+
+    return pos_size + neg_size;
+}
+
+cauchy_result_t cauchy_pncounter_decode(cauchy_pncounter_t* pn, const cauchy_pncounter_t* base,
+                                        const u8* buffer, usize size, usize* consumed) {
+    if (!pn || !buffer) return CAUCHY_ERR_INVALID;
+
+    /* Decode both halves before touching pn so a bad tail leaves it intact */
+    cauchy_gcounter_t pos, neg;
+    usize pos_size, neg_size;
+    cauchy_result_t res = cauchy_gcounter_decode(&pos, base ? &base->positive : NULL,
+                                                 buffer, size, &pos_size);
+    if (res != CAUCHY_OK) return res;
+
+    res = cauchy_gcounter_decode(&neg, base ? &base->negative : NULL,
+                                 buffer + pos_size, size - pos_size, &neg_size);
+    if (res != CAUCHY_OK) {
+        cauchy_gcounter_fini(&pos);
+        return res;
+    }
+
+    if (pn == base) cauchy_pncounter_fini(pn);
+    pn->positive = pos;
+    pn->negative = neg;
+    if (consumed) *consumed = pos_size + neg_size;
+    return CAUCHY_OK;
+}
+
+/* Striped counters */
+
+cauchy_pncounter_striped_t* cauchy_pncounter_striped_create(u32 num_nodes, cauchy_node_id_t node_id,
+                                                            u32 stripes) {
+    cauchy_pncounter_striped_t* sc = cauchy_aligned_alloc(
+        sizeof(cauchy_pncounter_striped_t), CAUCHY_CACHE_LINE_SIZE);
+    if (!sc) return NULL;
+    if (cauchy_counter_stripes_init(&sc->local, node_id, stripes) != CAUCHY_OK) {
+        cauchy_aligned_free(sc);
+        return NULL;
+    }
+    cauchy_pncounter_init(&sc->counter, num_nodes);
+    return sc;
+}
+
+void cauchy_pncounter_striped_destroy(cauchy_pncounter_striped_t* sc) {
+    if (!sc) return;
+    cauchy_pncounter_fini(&sc->counter);
+    cauchy_counter_stripes_fini(&sc->local);
+    cauchy_aligned_free(sc);
+}
+
+void cauchy_pncounter_striped_add(cauchy_pncounter_striped_t* sc, i64 amount) {
+    if (!sc) return;
+    cauchy_counter_stripe_t* stripe = cauchy_counter_stripes_local(&sc->local);
+    if (amount >= 0) {
+        atomic_fetch_add_explicit(&stripe->added, (u64)amount, memory_order_relaxed);
+    } else {
+        atomic_fetch_add_explicit(&stripe->removed, -(u64)amount, memory_order_relaxed);
+    }
+}
+
+cauchy_result_t cauchy_pncounter_striped_fold(cauchy_pncounter_striped_t* sc,
+                                              cauchy_pncounter_t* delta) {
+    if (!sc) return CAUCHY_ERR_INVALID;
+    cauchy_counter_stripes_t* cs = &sc->local;
+    cauchy_counter_stripes_drain(cs);
+
+    cauchy_result_t res = delta
+        ? cauchy_gcounter_add_delta(&sc->counter.positive, cs->node_id, cs->pending_added,
+                                    &delta->positive)
+        : cauchy_gcounter_add(&sc->counter.positive, cs->node_id, cs->pending_added);
+    if (res != CAUCHY_OK) return res;
+    cs->pending_added = 0;
+
+    res = delta
+        ? cauchy_gcounter_add_delta(&sc->counter.negative, cs->node_id, cs->pending_removed,
+                                    &delta->negative)
+        : cauchy_gcounter_add(&sc->counter.negative, cs->node_id, cs->pending_removed);
+    if (res == CAUCHY_OK) cs->pending_removed = 0;
+    return res;
+}
+
+i64 cauchy_pncounter_striped_value(cauchy_pncounter_striped_t* sc) {
+    if (!sc) return 0;
+    cauchy_pncounter_striped_fold(sc, NULL);
+    return cauchy_pncounter_value(&sc->counter);
+}
+
+cauchy_result_t cauchy_pncounter_striped_merge(cauchy_pncounter_striped_t* sc,
+                                               const cauchy_pncounter_t* src) {
+    if (!sc || !src) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_pncounter_striped_fold(sc, NULL);
+    if (res != CAUCHY_OK) return res;
+    return cauchy_pncounter_merge(&sc->counter, src);
 }
 
 void cauchy_pncounter_debug_print(const cauchy_pncounter_t* pn, const char* label) {
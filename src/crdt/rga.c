@@ -0,0 +1,684 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * RGA Implementation
+ */
+
+#include "cauchy/crdt/rga.h"
+#include "cauchy/wire.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+typedef cauchy_rga_block_t block_t;
+
+static const cauchy_uid_t RGA_START = { 0, 0 };
+
+static u64 next_random(cauchy_rga_t* rga) {
+    rga->rng ^= rga->rng << 13;
+    rga->rng ^= rga->rng >> 7;
+    rga->rng ^= rga->rng << 17;
+    return rga->rng;
+}
+
+CAUCHY_INLINE usize visible_len(const block_t* b) { return b->deleted ? 0 : b->len; }
+
+CAUCHY_INLINE cauchy_uid_t element_id(const block_t* b, usize offset) {
+    return cauchy_uid_create(b->id.node_id, b->id.timestamp + offset);
+}
+
+/* Id treap order: node-major, so one node's blocks are adjacent */
+CAUCHY_INLINE int id_order(const cauchy_uid_t* a, const cauchy_uid_t* b) {
+    if (a->node_id != b->node_id) return a->node_id < b->node_id ? -1 : 1;
+    if (a->timestamp != b->timestamp) return a->timestamp < b->timestamp ? -1 : 1;
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Blocks                                                                    */
+
+/* data NULL creates a tombstone, which keeps no bytes */
+static block_t* block_create(cauchy_rga_t* rga, cauchy_uid_t id, const u8* data, usize len) {
+    block_t* b = cauchy_pool_alloc(rga->block_pool);
+    if (!b) return NULL;
+    memset(b, 0, sizeof(block_t));
+    b->id = id;
+    b->len = len;
+    b->priority = next_random(rga);
+    b->data = b->inline_data;
+    if (!data) {
+        b->deleted = true;
+    } else {
+        b->capacity = CAUCHY_RGA_INLINE_SIZE;
+        if (len > CAUCHY_RGA_INLINE_SIZE) {
+            b->data = malloc(len);
+            if (!b->data) {
+                cauchy_pool_free(rga->block_pool, b);
+                return NULL;
+            }
+            b->capacity = len;
+        }
+        memcpy(b->data, data, len);
+    }
+    b->sub_count = len;
+    b->sub_visible = visible_len(b);
+    return b;
+}
+
+static void block_free(cauchy_rga_t* rga, block_t* b) {
+    if (b->data != b->inline_data) free(b->data);
+    cauchy_pool_free(rga->block_pool, b);
+}
+
+/* Treap depth is logarithmic, so recursion is fine */
+static void free_tree(cauchy_rga_t* rga, block_t* b) {
+    if (!b) return;
+    free_tree(rga, b->left);
+    free_tree(rga, b->right);
+    block_free(rga, b);
+}
+
+static bool block_reserve(block_t* b, usize need) {
+    if (need <= b->capacity) return true;
+    usize cap = b->capacity * 2;
+    if (cap < need) cap = need;
+    bool inline_now = b->data == b->inline_data;
+    u8* data = inline_now ? malloc(cap) : realloc(b->data, cap);
+    if (!data) return false;
+    if (inline_now) memcpy(data, b->inline_data, b->len);
+    b->data = data;
+    b->capacity = cap;
+    return true;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Document order treap                                                      */
+
+static void pull(block_t* b) {
+    b->sub_count = b->len;
+    b->sub_visible = visible_len(b);
+    if (b->left) {
+        b->sub_count += b->left->sub_count;
+        b->sub_visible += b->left->sub_visible;
+    }
+    if (b->right) {
+        b->sub_count += b->right->sub_count;
+        b->sub_visible += b->right->sub_visible;
+    }
+}
+
+static void pull_path(block_t* b) {
+    for (; b; b = b->parent) pull(b);
+}
+
+static block_t* leftmost(block_t* b) {
+    while (b && b->left) b = b->left;
+    return b;
+}
+
+static block_t* next_block(const block_t* b) {
+    if (b->right) return leftmost(b->right);
+    while (b->parent && b->parent->right == b) b = b->parent;
+    return b->parent;
+}
+
+static void rotate_up(cauchy_rga_t* rga, block_t* x) {
+    block_t* p = x->parent;
+    block_t* g = p->parent;
+    if (p->left == x) {
+        p->left = x->right;
+        if (x->right) x->right->parent = p;
+        x->right = p;
+    } else {
+        p->right = x->left;
+        if (x->left) x->left->parent = p;
+        x->left = p;
+    }
+    p->parent = x;
+    x->parent = g;
+    if (!g) rga->root = x;
+    else if (g->left == p) g->left = x;
+    else g->right = x;
+    pull(p);
+    pull(x);
+}
+
+/* Link b right after pos (at the front when pos is NULL) */
+static void rope_insert_after(cauchy_rga_t* rga, block_t* pos, block_t* b) {
+    b->left = b->right = b->parent = NULL;
+    if (!rga->root) {
+        rga->root = b;
+        return;
+    }
+    if (!pos) {
+        pos = leftmost(rga->root);
+        pos->left = b;
+    } else if (!pos->right) {
+        pos->right = b;
+    } else {
+        pos = leftmost(pos->right);
+        pos->left = b;
+    }
+    b->parent = pos;
+    pull_path(pos);
+    while (b->parent && b->priority > b->parent->priority) rotate_up(rga, b);
+}
+
+/* Block holding visible element index, and the element's offset in it */
+static block_t* find_visible(const cauchy_rga_t* rga, usize index, usize* offset) {
+    block_t* b = rga->root;
+    while (b) {
+        usize left = b->left ? b->left->sub_visible : 0;
+        if (index < left) {
+            b = b->left;
+            continue;
+        }
+        index -= left;
+        if (index < visible_len(b)) {
+            *offset = index;
+            return b;
+        }
+        index -= visible_len(b);
+        b = b->right;
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Id treap                                                                  */
+
+static block_t* id_insert(block_t* root, block_t* b) {
+    if (!root) {
+        b->id_left = b->id_right = NULL;
+        return b;
+    }
+    if (id_order(&b->id, &root->id) < 0) {
+        root->id_left = id_insert(root->id_left, b);
+        if (root->id_left->priority > root->priority) {
+            block_t* l = root->id_left;
+            root->id_left = l->id_right;
+            l->id_right = root;
+            return l;
+        }
+    } else {
+        root->id_right = id_insert(root->id_right, b);
+        if (root->id_right->priority > root->priority) {
+            block_t* r = root->id_right;
+            root->id_right = r->id_left;
+            r->id_left = root;
+            return r;
+        }
+    }
+    return root;
+}
+
+/* Last block starting at or before id, of any node */
+static block_t* id_floor(const cauchy_rga_t* rga, const cauchy_uid_t* id) {
+    block_t* best = NULL;
+    for (block_t* b = rga->id_root; b;) {
+        if (id_order(&b->id, id) <= 0) {
+            best = b;
+            b = b->id_right;
+        } else {
+            b = b->id_left;
+        }
+    }
+    return best;
+}
+
+/* Block holding id: the last block of id's node starting at or before it */
+static block_t* find_id(const cauchy_rga_t* rga, const cauchy_uid_t* id) {
+    block_t* best = id_floor(rga, id);
+    if (best && best->id.node_id == id->node_id &&
+        id->timestamp - best->id.timestamp < best->len) {
+        return best;
+    }
+    return NULL;
+}
+
+static void add_block(cauchy_rga_t* rga, block_t* pos, block_t* b) {
+    rope_insert_after(rga, pos, b);
+    rga->id_root = id_insert(rga->id_root, b);
+    rga->block_count++;
+}
+
+/* Keep the first k elements of b and move the rest to a new block right
+ * after it, which is returned */
+static block_t* split(cauchy_rga_t* rga, block_t* b, usize k) {
+    block_t* tail = block_create(rga, element_id(b, k),
+                                 b->deleted ? NULL : b->data + k, b->len - k);
+    if (!tail) return NULL;
+    b->len = k;
+    pull_path(b);
+    add_block(rga, b, tail);
+    rga->cursor = NULL;
+    return tail;
+}
+
+/* Turn n elements of b from offset on into a tombstone block */
+static cauchy_result_t delete_range(cauchy_rga_t* rga, block_t* b, usize offset, usize n) {
+    if (offset > 0) {
+        b = split(rga, b, offset);
+        if (!b) return CAUCHY_ERR_NOMEM;
+    }
+    if (n < b->len && !split(rga, b, n)) return CAUCHY_ERR_NOMEM;
+    b->deleted = true;
+    if (b->data != b->inline_data) free(b->data);
+    b->data = b->inline_data;
+    b->capacity = 0;
+    pull_path(b);
+    rga->cursor = NULL;
+    return CAUCHY_OK;
+}
+
+/* Place a run after the element at offset k of prev (the start when prev
+ * is NULL), past any following elements with greater ids. Those come in
+ * whole blocks: ids grow along a block. Returns the block that now ends
+ * with the run. */
+static block_t* integrate(cauchy_rga_t* rga, block_t* prev, usize k,
+                          const cauchy_uid_t* id, const u8* data, usize len) {
+    block_t* next;
+    usize offset = 0;
+    if (!prev) {
+        next = leftmost(rga->root);
+    } else if (k + 1 < prev->len) {
+        next = prev;
+        offset = k + 1;
+    } else {
+        next = next_block(prev);
+    }
+
+    while (next) {
+        cauchy_uid_t nid = element_id(next, offset);
+        if (cauchy_uid_compare(&nid, id) < 0) break;
+        prev = next;
+        next = next_block(next);
+        offset = 0;
+    }
+    if (next && offset > 0 && !split(rga, next, offset)) return NULL;
+
+    /* Typing: the run continues prev's ids right where prev ends */
+    if (prev && !prev->deleted && prev->id.node_id == id->node_id &&
+        prev->id.timestamp + prev->len == id->timestamp) {
+        if (!block_reserve(prev, prev->len + len)) return NULL;
+        memcpy(prev->data + prev->len, data, len);
+        prev->len += len;
+        pull_path(prev);
+        return prev;
+    }
+
+    block_t* b = block_create(rga, *id, data, len);
+    if (!b) return NULL;
+    add_block(rga, prev, b);
+    return b;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Public API                                                                */
+
+cauchy_rga_t* cauchy_rga_create(cauchy_node_id_t node_id) {
+    if (node_id == 0) return NULL;
+    cauchy_rga_t* rga = calloc(1, sizeof(cauchy_rga_t));
+    if (!rga) return NULL;
+
+    cauchy_pool_config_t cfg = {
+        .block_size = sizeof(block_t),
+        .initial_blocks = 128,
+        .max_blocks = 0,
+        .alignment = sizeof(void*)
+    };
+    rga->block_pool = cauchy_pool_create(&cfg);
+    if (!rga->block_pool) {
+        free(rga);
+        return NULL;
+    }
+    rga->node_id = node_id;
+    rga->rng = 0x9E3779B97F4A7C15ULL ^ ((u64)node_id << 17 | node_id);
+    if (rga->rng == 0) rga->rng = 1;
+    return rga;
+}
+
+void cauchy_rga_destroy(cauchy_rga_t* rga) {
+    if (!rga) return;
+    free_tree(rga, rga->root);
+    cauchy_pool_destroy(rga->block_pool);
+    free(rga);
+}
+
+cauchy_result_t cauchy_rga_insert(cauchy_rga_t* rga, usize index,
+                                  const void* data, usize len,
+                                  cauchy_rga_emit_fn emit, void* arg) {
+    if (!rga || (!data && len)) return CAUCHY_ERR_INVALID;
+    if (index > cauchy_rga_length(rga)) return CAUCHY_ERR_INVALID;
+    if (len == 0) return CAUCHY_OK;
+
+    block_t* prev = NULL;
+    usize k = 0;
+    if (index > 0) {
+        if (rga->cursor && rga->cursor_index == index) {
+            prev = rga->cursor;
+            k = prev->len - 1;
+        } else {
+            prev = find_visible(rga, index - 1, &k);
+        }
+    }
+
+    cauchy_uid_t id = cauchy_uid_create(rga->node_id, rga->clock + 1);
+    cauchy_uid_t ref = prev ? element_id(prev, k) : RGA_START;
+    block_t* b = integrate(rga, prev, k, &id, data, len);
+    if (!b) return CAUCHY_ERR_NOMEM;
+    rga->clock += len;
+    rga->cursor = b;
+    rga->cursor_index = index + len;
+
+    if (emit) {
+        cauchy_rga_op_t op = {
+            .type = CAUCHY_RGA_OP_INSERT,
+            .id = id,
+            .ref = ref,
+            .len = len,
+            .data = data
+        };
+        emit(arg, &op);
+    }
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_rga_delete(cauchy_rga_t* rga, usize index, usize len,
+                                  cauchy_rga_emit_fn emit, void* arg) {
+    if (!rga) return CAUCHY_ERR_INVALID;
+    usize length = cauchy_rga_length(rga);
+    if (index > length || len > length - index) return CAUCHY_ERR_INVALID;
+
+    while (len > 0) {
+        usize k;
+        block_t* b = find_visible(rga, index, &k);
+        usize n = b->len - k;
+        if (n > len) n = len;
+
+        cauchy_rga_op_t op = {
+            .type = CAUCHY_RGA_OP_DELETE,
+            .id = element_id(b, k),
+            .ref = RGA_START,
+            .len = n,
+            .data = NULL
+        };
+        cauchy_result_t res = delete_range(rga, b, k, n);
+        if (res != CAUCHY_OK) return res;
+        if (emit) emit(arg, &op);
+        len -= n;
+    }
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_rga_apply(cauchy_rga_t* rga, const cauchy_rga_op_t* op) {
+    if (!rga || !op || op->len == 0 || op->id.timestamp == 0) return CAUCHY_ERR_INVALID;
+
+    if (op->type == CAUCHY_RGA_OP_DELETE) {
+        cauchy_uid_t id = op->id;
+        usize left = op->len;
+        while (left > 0) {
+            block_t* b = find_id(rga, &id);
+            if (!b) return CAUCHY_ERR_CAUSAL;
+            usize offset = id.timestamp - b->id.timestamp;
+            usize n = b->len - offset;
+            if (n > left) n = left;
+            if (!b->deleted) {
+                cauchy_result_t res = delete_range(rga, b, offset, n);
+                if (res != CAUCHY_OK) return res;
+            }
+            id.timestamp += n;
+            left -= n;
+        }
+        return CAUCHY_OK;
+    }
+
+    if (op->type != CAUCHY_RGA_OP_INSERT || !op->data) return CAUCHY_ERR_INVALID;
+    if (find_id(rga, &op->id)) return CAUCHY_OK;
+
+    block_t* prev = NULL;
+    usize k = 0;
+    if (!cauchy_uid_equals(&op->ref, &RGA_START)) {
+        prev = find_id(rga, &op->ref);
+        if (!prev) return CAUCHY_ERR_CAUSAL;
+        k = op->ref.timestamp - prev->id.timestamp;
+    }
+
+    rga->cursor = NULL;
+    if (!integrate(rga, prev, k, &op->id, op->data, op->len)) return CAUCHY_ERR_NOMEM;
+    cauchy_timestamp_t last = op->id.timestamp + op->len - 1;
+    if (last > rga->clock) rga->clock = last;
+    return CAUCHY_OK;
+}
+
+usize cauchy_rga_length(const cauchy_rga_t* rga) {
+    return (rga && rga->root) ? rga->root->sub_visible : 0;
+}
+
+usize cauchy_rga_read(const cauchy_rga_t* rga, usize index, void* buffer, usize size) {
+    if (!rga || !buffer) return 0;
+    usize k = 0;
+    const block_t* b = find_visible(rga, index, &k);
+    u8* out = buffer;
+    usize copied = 0;
+    for (; b && copied < size; b = next_block(b), k = 0) {
+        if (b->deleted) continue;
+        usize n = b->len - k;
+        if (n > size - copied) n = size - copied;
+        memcpy(out + copied, b->data + k, n);
+        copied += n;
+    }
+    return copied;
+}
+
+cauchy_result_t cauchy_rga_id_at(const cauchy_rga_t* rga, usize index, cauchy_uid_t* out) {
+    if (!rga || !out) return CAUCHY_ERR_INVALID;
+    usize k;
+    const block_t* b = find_visible(rga, index, &k);
+    if (!b) return CAUCHY_ERR_NOTFOUND;
+    *out = element_id(b, k);
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_rga_index_of(const cauchy_rga_t* rga, const cauchy_uid_t* id,
+                                    usize* out) {
+    if (!rga || !id || !out) return CAUCHY_ERR_INVALID;
+    const block_t* b = find_id(rga, id);
+    if (!b) return CAUCHY_ERR_NOTFOUND;
+
+    usize index = b->deleted ? 0 : (usize)(id->timestamp - b->id.timestamp);
+    if (b->left) index += b->left->sub_visible;
+    for (const block_t* x = b; x->parent; x = x->parent) {
+        const block_t* p = x->parent;
+        if (p->right == x) {
+            index += visible_len(p);
+            if (p->left) index += p->left->sub_visible;
+        }
+    }
+    *out = index;
+    return CAUCHY_OK;
+}
+
+/* Next visible block from b on */
+static const block_t* skip_deleted(const block_t* b) {
+    while (b && b->deleted) b = next_block(b);
+    return b;
+}
+
+bool cauchy_rga_equals(const cauchy_rga_t* a, const cauchy_rga_t* b) {
+    if (!a || !b) return a == b;
+    if (cauchy_rga_length(a) != cauchy_rga_length(b)) return false;
+
+    const block_t* x = skip_deleted(leftmost(a->root));
+    const block_t* y = skip_deleted(leftmost(b->root));
+    usize xo = 0, yo = 0;
+    while (x && y) {
+        usize n = x->len - xo;
+        if (y->len - yo < n) n = y->len - yo;
+        if (memcmp(x->data + xo, y->data + yo, n) != 0) return false;
+        xo += n;
+        yo += n;
+        if (xo == x->len) { x = skip_deleted(next_block(x)); xo = 0; }
+        if (yo == y->len) { y = skip_deleted(next_block(y)); yo = 0; }
+    }
+    return true;
+}
+
+usize cauchy_rga_op_encoded_size(const cauchy_rga_op_t* op) {
+    if (!op) return 0;
+    usize size = 1 + cauchy_varint_size(op->id.node_id) +
+                 cauchy_varint_size(op->id.timestamp) + cauchy_varint_size(op->len);
+    if (op->type == CAUCHY_RGA_OP_INSERT) {
+        size += cauchy_varint_size(op->ref.node_id) +
+                cauchy_varint_size(op->ref.timestamp) + op->len;
+    }
+    return size;
+}
+
+usize cauchy_rga_op_encode(const cauchy_rga_op_t* op, u8* buffer, usize size) {
+    if (!op || !buffer) return 0;
+    usize needed = cauchy_rga_op_encoded_size(op);
+    if (size < needed) return 0;
+
+    usize pos = 0;
+    buffer[pos++] = (u8)op->type;
+    cauchy_varint_put(buffer, size, &pos, op->id.node_id);
+    cauchy_varint_put(buffer, size, &pos, op->id.timestamp);
+    cauchy_varint_put(buffer, size, &pos, op->len);
+    if (op->type == CAUCHY_RGA_OP_INSERT) {
+        cauchy_varint_put(buffer, size, &pos, op->ref.node_id);
+        cauchy_varint_put(buffer, size, &pos, op->ref.timestamp);
+        memcpy(buffer + pos, op->data, op->len);
+        pos += op->len;
+    }
+    return pos;
+}
+
+cauchy_result_t cauchy_rga_op_decode(cauchy_rga_op_t* op, const u8* buffer, usize size,
+                                     usize* consumed) {
+    if (!op || !buffer || size < 1) return CAUCHY_ERR_INVALID;
+
+    usize pos = 0;
+    u8 type = buffer[pos++];
+    if (type != CAUCHY_RGA_OP_INSERT && type != CAUCHY_RGA_OP_DELETE) return CAUCHY_ERR_INVALID;
+
+    u64 node, ts, len;
+    if (!cauchy_varint_get(buffer, size, &pos, &node) ||
+        !cauchy_varint_get(buffer, size, &pos, &ts) ||
+        !cauchy_varint_get(buffer, size, &pos, &len)) {
+        return CAUCHY_ERR_INVALID;
+    }
+    op->type = (cauchy_rga_op_type_t)type;
+    op->id = cauchy_uid_create(node, ts);
+    op->ref = RGA_START;
+    op->len = (usize)len;
+    op->data = NULL;
+
+    if (type == CAUCHY_RGA_OP_INSERT) {
+        if (!cauchy_varint_get(buffer, size, &pos, &node) ||
+            !cauchy_varint_get(buffer, size, &pos, &ts) ||
+            len > size - pos) {
+            return CAUCHY_ERR_INVALID;
+        }
+        op->ref = cauchy_uid_create(node, ts);
+        op->data = buffer + pos;
+        pos += (usize)len;
+    }
+    if (consumed) *consumed = pos;
+    return CAUCHY_OK;
+}
+
+/* Section body: clock, block count, then each block in document order
+ * as id, length, tombstone flag and contents (none for tombstones).
+ * Loading appends the blocks as they are: the order already reflects
+ * every integration decision. */
+cauchy_result_t cauchy_rga_snapshot_save(const cauchy_rga_t* rga, cauchy_snapshot_writer_t* w,
+                                         u64 id) {
+    if (!rga || !w) return CAUCHY_ERR_INVALID;
+    cauchy_result_t res = cauchy_snapshot_writer_begin(w, CAUCHY_SNAPSHOT_RGA, id);
+    if (res != CAUCHY_OK) return res;
+
+    u64 head[2] = { rga->clock, rga->block_count };
+    res = cauchy_snapshot_writer_put(w, head, sizeof(head));
+    for (const block_t* b = leftmost(rga->root); b && res == CAUCHY_OK; b = next_block(b)) {
+        u64 meta[4] = { b->id.node_id, b->id.timestamp, b->len, b->deleted };
+        res = cauchy_snapshot_writer_put(w, meta, sizeof(meta));
+        if (res == CAUCHY_OK) res = cauchy_snapshot_writer_put_blob(w, b->data, b->deleted ? 0 : b->len);
+    }
+    cauchy_result_t end = cauchy_snapshot_writer_end(w);
+    return res != CAUCHY_OK ? res : end;
+}
+
+/* True if no block holds any of the len elements from id on. Blocks are
+ * disjoint, so only the last one starting at or before the final
+ * element can reach back into the range. */
+static bool id_range_free(const cauchy_rga_t* rga, cauchy_uid_t id, u64 len) {
+    cauchy_uid_t last = cauchy_uid_create(id.node_id, id.timestamp + len - 1);
+    const block_t* b = id_floor(rga, &last);
+    return !b || b->id.node_id != id.node_id ||
+           b->id.timestamp + b->len - 1 < id.timestamp;
+}
+
+static cauchy_result_t load_blocks(cauchy_rga_t* rga, cauchy_snapshot_cursor_t* cur,
+                                   u64 count, cauchy_timestamp_t* newest) {
+    block_t* last = NULL;
+    for (u64 i = 0; i < count; i++) {
+        u64 meta[4];
+        const u8* bytes;
+        usize len;
+        for (int j = 0; j < 4; j++) {
+            if (!cauchy_snapshot_get_u64(cur, &meta[j])) return CAUCHY_ERR_INVALID;
+        }
+        if (!cauchy_snapshot_get_blob(cur, &bytes, &len) || meta[2] == 0 || meta[1] == 0 ||
+            meta[2] - 1 > UINT64_MAX - meta[1] || len != (meta[3] ? 0 : meta[2])) {
+            return CAUCHY_ERR_INVALID;
+        }
+        cauchy_uid_t bid = cauchy_uid_create(meta[0], meta[1]);
+        if (!id_range_free(rga, bid, meta[2])) return CAUCHY_ERR_INVALID;
+        block_t* b = block_create(rga, bid, meta[3] ? NULL : bytes, (usize)meta[2]);
+        if (!b) return CAUCHY_ERR_NOMEM;
+        add_block(rga, last, b);
+        last = b;
+        if (meta[1] + meta[2] - 1 > *newest) *newest = meta[1] + meta[2] - 1;
+    }
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_rga_snapshot_load(cauchy_rga_t* rga, cauchy_snapshot_t* snap, u64 id) {
+    if (!rga) return CAUCHY_ERR_INVALID;
+    if (rga->root) return CAUCHY_ERR_EXISTS;
+    const u8* data;
+    usize size;
+    cauchy_result_t res = cauchy_snapshot_find(snap, CAUCHY_SNAPSHOT_RGA, id, &data, &size);
+    if (res != CAUCHY_OK) return res;
+
+    cauchy_snapshot_cursor_t cur;
+    cauchy_snapshot_cursor_init(&cur, data, size);
+    u64 clock, count;
+    if (!cauchy_snapshot_get_u64(&cur, &clock) || !cauchy_snapshot_get_u64(&cur, &count)) {
+        return CAUCHY_ERR_INVALID;
+    }
+    /* The saved clock covers every element, or new local ids could
+     * collide with loaded ones */
+    cauchy_timestamp_t newest = 0;
+    res = load_blocks(rga, &cur, count, &newest);
+    if (res == CAUCHY_OK && clock < newest) res = CAUCHY_ERR_INVALID;
+    if (res != CAUCHY_OK) {
+        free_tree(rga, rga->root);
+        rga->root = NULL;
+        rga->id_root = NULL;
+        rga->block_count = 0;
+        rga->cursor = NULL;
+        return res;
+    }
+    if (clock > rga->clock) rga->clock = clock;
+    rga->cursor = NULL;
+    return CAUCHY_OK;
+}
+
+void cauchy_rga_debug_print(const cauchy_rga_t* rga, const char* label) {
+    if (!rga) { fprintf(stderr, "%s: (null)\n", label ? label : "rga"); return; }
+    fprintf(stderr, "%s: length=%zu elements=%zu blocks=%zu clock=%llu\n",
+            label ? label : "rga", cauchy_rga_length(rga),
+            rga->root ? rga->root->sub_count : 0, rga->block_count,
+            (unsigned long long)rga->clock);
+}
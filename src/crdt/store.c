@@ -0,0 +1,432 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Sharded Object Store Implementation
+ */
+
+#include "cauchy/crdt/store.h"
+#include "cauchy/parallel.h"
+#include <stdlib.h>
+#include <string.h>
+
+enum { OP_ADD, OP_SET };
+
+/* A queue cell (Vyukov's bounded queue): seq == pos when free for the
+ * producer at pos, pos + 1 once that producer has filled it. Ops larger
+ * than the inline bytes carry them in heap. */
+typedef struct CAUCHY_CACHE_ALIGNED store_cell {
+    cauchy_atomic_u64_t seq;
+    u8                  kind;
+    u8                  type;
+    u16                 name_size;
+    u32                 value_size;
+    i64                 arg;        /* Delta, or the register timestamp */
+    u8*                 heap;
+    u8                  bytes[CAUCHY_STORE_CELL_INLINE];
+} store_cell_t;
+
+typedef struct CAUCHY_CACHE_ALIGNED store_shard {
+    /* Producers */
+    cauchy_atomic_u64_t tail;
+    cauchy_atomic_u64_t full;
+    /* Holder of the shard */
+    CAUCHY_CACHE_ALIGNED atomic_flag busy;
+    u64                 head;
+    store_cell_t*       cells;
+    u64                 mask;
+    cauchy_htable_t     index;
+    cauchy_pool_t*      objects;
+    cauchy_arena_t      names;
+    cauchy_atomic_u64_t version;
+    cauchy_atomic_u64_t applied;
+    cauchy_atomic_u64_t rejected;
+    cauchy_atomic_u64_t count;
+} store_shard_t;
+
+struct cauchy_store {
+    cauchy_node_id_t node_id;
+    u32              count;
+    store_shard_t*   shards;
+};
+
+/* Holder-only counter bump: a relaxed load/store pair, never an RMW */
+CAUCHY_INLINE void stat_add(cauchy_atomic_u64_t* counter, u64 n) {
+    atomic_store_explicit(counter,
+        atomic_load_explicit(counter, memory_order_relaxed) + n,
+        memory_order_relaxed);
+}
+
+CAUCHY_INLINE u64 stat_get(const cauchy_atomic_u64_t* counter) {
+    return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+static bool shard_try_hold(store_shard_t* shard) {
+    return !atomic_flag_test_and_set_explicit(&shard->busy, memory_order_acquire);
+}
+
+static void shard_hold(store_shard_t* shard) {
+    while (!shard_try_hold(shard)) CAUCHY_CPU_PAUSE();
+}
+
+static void shard_release(store_shard_t* shard) {
+    atomic_flag_clear_explicit(&shard->busy, memory_order_release);
+}
+
+static void object_fini(cauchy_store_object_t* obj) {
+    switch (obj->type) {
+        case CAUCHY_CRDT_G_COUNTER:    cauchy_gcounter_fini(&obj->as.gcounter); break;
+        case CAUCHY_CRDT_PN_COUNTER:   cauchy_pncounter_fini(&obj->as.pncounter); break;
+        case CAUCHY_CRDT_LWW_REGISTER: cauchy_lww_fini(&obj->as.lww); break;
+        default: break;
+    }
+}
+
+static void shard_fini(store_shard_t* shard) {
+    if (shard->cells) {
+        for (u64 pos = shard->head; pos != stat_get(&shard->tail); pos++) {
+            store_cell_t* cell = &shard->cells[pos & shard->mask];
+            if (atomic_load_explicit(&cell->seq, memory_order_acquire) == pos + 1) free(cell->heap);
+        }
+        cauchy_aligned_free(shard->cells);
+    }
+    cauchy_htable_iter_t iter;
+    cauchy_htable_iter_init(&iter, &shard->index);
+    cauchy_store_object_t* obj;
+    while ((obj = cauchy_htable_iter_next(&iter)) != NULL) {
+        object_fini(obj);
+        cauchy_pool_free(shard->objects, obj);
+    }
+    cauchy_htable_destroy(&shard->index);
+    if (shard->objects) cauchy_pool_destroy(shard->objects);
+    cauchy_arena_destroy(&shard->names);
+}
+
+static cauchy_result_t shard_init(store_shard_t* shard, const cauchy_store_config_t* cfg,
+                                  u64 capacity) {
+    memset(shard, 0, sizeof(*shard));
+    atomic_flag_clear(&shard->busy);
+    cauchy_arena_init(&shard->names, 0);
+    cauchy_result_t res = cauchy_htable_init(&shard->index, cfg->initial_objects);
+    if (res != CAUCHY_OK) return res;
+    cauchy_pool_config_t pool_cfg = CAUCHY_POOL_CONFIG_DEFAULT;
+    pool_cfg.block_size = sizeof(cauchy_store_object_t);
+    pool_cfg.initial_blocks = cfg->initial_objects;
+    shard->objects = cauchy_pool_create(&pool_cfg);
+    shard->cells = cauchy_aligned_alloc(capacity * sizeof(store_cell_t), CAUCHY_CACHE_LINE_SIZE);
+    if (!shard->objects || !shard->cells) return CAUCHY_ERR_NOMEM;
+    shard->mask = capacity - 1;
+    for (u64 i = 0; i < capacity; i++) atomic_init(&shard->cells[i].seq, i);
+    return CAUCHY_OK;
+}
+
+cauchy_store_t* cauchy_store_create(const cauchy_context_t* ctx,
+                                    const cauchy_store_config_t* config) {
+    if (!ctx) return NULL;
+    cauchy_store_config_t cfg = CAUCHY_STORE_CONFIG_DEFAULT;
+    if (config) cfg = *config;
+    if (cfg.shards == 0) cfg.shards = cauchy_parallel_default_parts();
+    if (cfg.shards > CAUCHY_STORE_MAX_SHARDS) cfg.shards = CAUCHY_STORE_MAX_SHARDS;
+    if (cfg.initial_objects == 0) cfg.initial_objects = 16;
+    u64 capacity = 2;
+    while (capacity < cfg.queue_capacity) capacity <<= 1;
+
+    cauchy_store_t* store = malloc(sizeof(cauchy_store_t));
+    if (!store) return NULL;
+    store->node_id = ctx->node_id;
+    store->count = cfg.shards;
+    store->shards = cauchy_aligned_alloc(cfg.shards * sizeof(store_shard_t),
+                                         CAUCHY_CACHE_LINE_SIZE);
+    if (!store->shards) {
+        free(store);
+        return NULL;
+    }
+    for (u32 s = 0; s < cfg.shards; s++) {
+        if (shard_init(&store->shards[s], &cfg, capacity) != CAUCHY_OK) {
+            store->count = s + 1;
+            cauchy_store_destroy(store);
+            return NULL;
+        }
+    }
+    return store;
+}
+
+void cauchy_store_destroy(cauchy_store_t* store) {
+    if (!store) return;
+    for (u32 s = 0; s < store->count; s++) shard_fini(&store->shards[s]);
+    cauchy_aligned_free(store->shards);
+    free(store);
+}
+
+u32 cauchy_store_shard_count(const cauchy_store_t* store) {
+    return store ? store->count : 0;
+}
+
+/* High hash bits pick the shard; the shard index probes with its own mix */
+CAUCHY_INLINE u32 shard_for(const cauchy_store_t* store, u64 hash) {
+    return (u32)(((hash >> 32) * store->count) >> 32);
+}
+
+u32 cauchy_store_shard_of(const cauchy_store_t* store, const void* name, usize size) {
+    if (!store || !name) return 0;
+    return shard_for(store, cauchy_hash_bytes(name, size));
+}
+
+/* Claim a cell, fill it and publish it */
+static cauchy_result_t submit(cauchy_store_t* store, u8 kind, cauchy_crdt_type_t type,
+                              const void* name, usize size, const void* value,
+                              usize value_size, i64 arg) {
+    if (size == 0 || size > UINT16_MAX || value_size > UINT32_MAX) return CAUCHY_ERR_INVALID;
+    store_shard_t* shard = &store->shards[shard_for(store, cauchy_hash_bytes(name, size))];
+    u8* heap = NULL;
+    if (size + value_size > CAUCHY_STORE_CELL_INLINE) {
+        heap = malloc(size + value_size);
+        if (!heap) return CAUCHY_ERR_NOMEM;
+    }
+
+    store_cell_t* cell;
+    u64 pos = atomic_load_explicit(&shard->tail, memory_order_relaxed);
+    for (;;) {
+        cell = &shard->cells[pos & shard->mask];
+        u64 seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        i64 dif = (i64)(seq - pos);
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&shard->tail, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            free(heap);
+            cauchy_atomic_fetch_add_u64(&shard->full, 1);
+            return CAUCHY_ERR_FULL;
+        } else {
+            pos = atomic_load_explicit(&shard->tail, memory_order_relaxed);
+        }
+    }
+
+    u8* bytes = heap ? heap : cell->bytes;
+    memcpy(bytes, name, size);
+    if (value_size) memcpy(bytes + size, value, value_size);
+    cell->kind = kind;
+    cell->type = (u8)type;
+    cell->name_size = (u16)size;
+    cell->value_size = (u32)value_size;
+    cell->arg = arg;
+    cell->heap = heap;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_store_add(cauchy_store_t* store, const void* name, usize size,
+                                 cauchy_crdt_type_t type, i64 delta) {
+    if (!store || !name) return CAUCHY_ERR_INVALID;
+    if (type != CAUCHY_CRDT_PN_COUNTER && (type != CAUCHY_CRDT_G_COUNTER || delta < 0)) {
+        return CAUCHY_ERR_INVALID;
+    }
+    return submit(store, OP_ADD, type, name, size, NULL, 0, delta);
+}
+
+cauchy_result_t cauchy_store_set(cauchy_store_t* store, const void* name, usize size,
+                                 const void* value, usize value_size,
+                                 cauchy_timestamp_t timestamp) {
+    if (!store || !name || (value_size && !value)) return CAUCHY_ERR_INVALID;
+    return submit(store, OP_SET, CAUCHY_CRDT_LWW_REGISTER, name, size, value, value_size,
+                  (i64)timestamp);
+}
+
+static cauchy_store_object_t* find(const store_shard_t* shard, u64 hash, const void* name,
+                                   usize size) {
+    cauchy_htable_probe_t probe;
+    cauchy_htable_probe_init(&probe, &shard->index, hash);
+    cauchy_store_object_t* obj;
+    while ((obj = cauchy_htable_probe_next(&probe)) != NULL) {
+        if (obj->hash == hash && obj->name_size == size && memcmp(obj->name, name, size) == 0) {
+            return obj;
+        }
+    }
+    return NULL;
+}
+
+/* The object named, created with the given type if absent.
+ * CAUCHY_ERR_INVALID if the name holds another type. */
+static cauchy_result_t obtain(store_shard_t* shard, u64 hash, const void* name, usize size,
+                              cauchy_crdt_type_t type, cauchy_store_object_t** out) {
+    cauchy_store_object_t* obj = find(shard, hash, name, size);
+    if (obj) {
+        *out = obj;
+        return obj->type == type ? CAUCHY_OK : CAUCHY_ERR_INVALID;
+    }
+
+    obj = cauchy_pool_alloc(shard->objects);
+    if (!obj) return CAUCHY_ERR_NOMEM;
+    u8* copy = cauchy_arena_alloc(&shard->names, size);
+    if (!copy) {
+        cauchy_pool_free(shard->objects, obj);
+        return CAUCHY_ERR_NOMEM;
+    }
+    memcpy(copy, name, size);
+    obj->name = copy;
+    obj->name_size = size;
+    obj->hash = hash;
+    obj->version = 0;
+    obj->type = type;
+    switch (type) {
+        case CAUCHY_CRDT_G_COUNTER:  cauchy_gcounter_init(&obj->as.gcounter, 0); break;
+        case CAUCHY_CRDT_PN_COUNTER: cauchy_pncounter_init(&obj->as.pncounter, 0); break;
+        default:                     cauchy_lww_init(&obj->as.lww); break;
+    }
+    /* A failed insert leaves the name reserved in the arena */
+    cauchy_result_t res = cauchy_htable_insert(&shard->index, hash, obj);
+    if (res != CAUCHY_OK) {
+        object_fini(obj);
+        cauchy_pool_free(shard->objects, obj);
+        return res;
+    }
+    stat_add(&shard->count, 1);
+    *out = obj;
+    return CAUCHY_OK;
+}
+
+CAUCHY_INLINE void touched(store_shard_t* shard, cauchy_store_object_t* obj) {
+    u64 version = stat_get(&shard->version) + 1;
+    atomic_store_explicit(&shard->version, version, memory_order_release);
+    obj->version = version;
+}
+
+static void apply(cauchy_store_t* store, store_shard_t* shard, const store_cell_t* cell) {
+    const u8* bytes = cell->heap ? cell->heap : cell->bytes;
+    u64 hash = cauchy_hash_bytes(bytes, cell->name_size);
+    cauchy_store_object_t* obj;
+    cauchy_result_t res = obtain(shard, hash, bytes, cell->name_size,
+                                 (cauchy_crdt_type_t)cell->type, &obj);
+    if (res == CAUCHY_OK && cell->kind == OP_SET) {
+        res = cauchy_lww_set(&obj->as.lww, bytes + cell->name_size, cell->value_size,
+                             (cauchy_timestamp_t)cell->arg, store->node_id);
+    } else if (res == CAUCHY_OK && cell->type == CAUCHY_CRDT_G_COUNTER) {
+        res = cauchy_gcounter_add(&obj->as.gcounter, store->node_id, (u64)cell->arg);
+    } else if (res == CAUCHY_OK) {
+        res = cauchy_pncounter_add(&obj->as.pncounter, store->node_id, cell->arg);
+    }
+    if (res == CAUCHY_OK) {
+        touched(shard, obj);
+        stat_add(&shard->applied, 1);
+    } else {
+        stat_add(&shard->rejected, 1);
+    }
+}
+
+/* Apply queued ops of a held shard */
+static usize drain(cauchy_store_t* store, store_shard_t* shard, usize budget) {
+    usize done = 0;
+    while (budget == 0 || done < budget) {
+        store_cell_t* cell = &shard->cells[shard->head & shard->mask];
+        if (atomic_load_explicit(&cell->seq, memory_order_acquire) != shard->head + 1) break;
+        apply(store, shard, cell);
+        free(cell->heap);
+        atomic_store_explicit(&cell->seq, shard->head + shard->mask + 1, memory_order_release);
+        shard->head++;
+        done++;
+    }
+    return done;
+}
+
+usize cauchy_store_poll(cauchy_store_t* store, u32 shard_index, usize budget) {
+    if (!store || shard_index >= store->count) return 0;
+    store_shard_t* shard = &store->shards[shard_index];
+    if (!shard_try_hold(shard)) return 0;
+    usize done = drain(store, shard, budget);
+    shard_release(shard);
+    return done;
+}
+
+usize cauchy_store_flush(cauchy_store_t* store) {
+    if (!store) return 0;
+    usize total = 0;
+    for (u32 s = 0; s < store->count; s++) {
+        store_shard_t* shard = &store->shards[s];
+        shard_hold(shard);
+        total += drain(store, shard, 0);
+        shard_release(shard);
+    }
+    return total;
+}
+
+cauchy_result_t cauchy_store_get(cauchy_store_t* store, const void* name, usize size,
+                                 cauchy_store_visit_fn fn, void* arg) {
+    if (!store || !name || !fn) return CAUCHY_ERR_INVALID;
+    u64 hash = cauchy_hash_bytes(name, size);
+    store_shard_t* shard = &store->shards[shard_for(store, hash)];
+    shard_hold(shard);
+    const cauchy_store_object_t* obj = find(shard, hash, name, size);
+    if (obj) fn(arg, obj);
+    shard_release(shard);
+    return obj ? CAUCHY_OK : CAUCHY_ERR_NOTFOUND;
+}
+
+void cauchy_store_visit(cauchy_store_t* store, const cauchy_vclock_t* since,
+                        cauchy_store_visit_fn fn, void* arg) {
+    if (!store || !fn) return;
+    for (u32 s = 0; s < store->count; s++) {
+        store_shard_t* shard = &store->shards[s];
+        u64 after = since ? cauchy_vclock_get(since, (cauchy_node_id_t)s + 1) : 0;
+        shard_hold(shard);
+        if (stat_get(&shard->version) > after) {
+            cauchy_htable_iter_t iter;
+            cauchy_htable_iter_init(&iter, &shard->index);
+            const cauchy_store_object_t* obj;
+            while ((obj = cauchy_htable_iter_next(&iter)) != NULL) {
+                if (obj->version > after) fn(arg, obj);
+            }
+        }
+        shard_release(shard);
+    }
+}
+
+cauchy_result_t cauchy_store_merge(cauchy_store_t* store, const cauchy_store_object_t* remote) {
+    if (!store || !remote || !remote->name || remote->name_size == 0) return CAUCHY_ERR_INVALID;
+    if (remote->type != CAUCHY_CRDT_G_COUNTER && remote->type != CAUCHY_CRDT_PN_COUNTER &&
+        remote->type != CAUCHY_CRDT_LWW_REGISTER) {
+        return CAUCHY_ERR_INVALID;
+    }
+    u64 hash = cauchy_hash_bytes(remote->name, remote->name_size);
+    store_shard_t* shard = &store->shards[shard_for(store, hash)];
+    shard_hold(shard);
+    cauchy_store_object_t* obj;
+    cauchy_result_t res = obtain(shard, hash, remote->name, remote->name_size, remote->type,
+                                 &obj);
+    if (res == CAUCHY_OK && obj->type == CAUCHY_CRDT_G_COUNTER) {
+        res = cauchy_gcounter_merge(&obj->as.gcounter, &remote->as.gcounter);
+    } else if (res == CAUCHY_OK && obj->type == CAUCHY_CRDT_PN_COUNTER) {
+        res = cauchy_pncounter_merge(&obj->as.pncounter, &remote->as.pncounter);
+    } else if (res == CAUCHY_OK) {
+        cauchy_lww_merge(&obj->as.lww, &remote->as.lww);
+    }
+    if (res == CAUCHY_OK) touched(shard, obj);
+    shard_release(shard);
+    return res;
+}
+
+cauchy_result_t cauchy_store_clock(const cauchy_store_t* store, cauchy_vclock_t* out) {
+    if (!store || !out) return CAUCHY_ERR_INVALID;
+    cauchy_vclock_init(out, store->count + 1);
+    for (u32 s = 0; s < store->count; s++) {
+        u64 version = cauchy_atomic_load_u64(&store->shards[s].version);
+        if (!version) continue;
+        cauchy_result_t res = cauchy_vclock_set(out, (cauchy_node_id_t)s + 1, version);
+        if (res != CAUCHY_OK) return res;
+    }
+    return CAUCHY_OK;
+}
+
+cauchy_store_stats_t cauchy_store_get_stats(const cauchy_store_t* store) {
+    cauchy_store_stats_t out = { 0 };
+    if (!store) return out;
+    for (u32 s = 0; s < store->count; s++) {
+        const store_shard_t* shard = &store->shards[s];
+        out.submitted += stat_get(&shard->tail);
+        out.applied += stat_get(&shard->applied);
+        out.rejected += stat_get(&shard->rejected);
+        out.full += stat_get(&shard->full);
+        out.objects += (usize)stat_get(&shard->count);
+    }
+    return out;
+}
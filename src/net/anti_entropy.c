@@ -0,0 +1,168 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Anti-Entropy Reconciliation Implementation
+ */
+
+#include "cauchy/net/anti_entropy.h"
+#include <stdlib.h>
+
+static cauchy_result_t reserve(cauchy_ae_session_t* s, usize need) {
+    if (need <= s->capacity) return CAUCHY_OK;
+    usize cap = s->capacity ? s->capacity : 16;
+    while (cap < need) cap *= 2;
+    u64* grown = realloc(s->pending, cap * sizeof(u64));
+    if (!grown) return CAUCHY_ERR_NOMEM;
+    s->pending = grown;
+    s->capacity = cap;
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_ae_session_init(cauchy_ae_session_t* s, const cauchy_merkle_t* local) {
+    if (!s || !local || !local->nodes) return CAUCHY_ERR_INVALID;
+    s->local = local;
+    s->level = 0;
+    s->started = false;
+    s->pending = NULL;
+    s->count = 0;
+    s->capacity = 0;
+    s->digests_in = 0;
+    return CAUCHY_OK;
+}
+
+void cauchy_ae_session_destroy(cauchy_ae_session_t* s) {
+    if (!s) return;
+    free(s->pending);
+    s->pending = NULL;
+    s->count = 0;
+    s->capacity = 0;
+}
+
+cauchy_result_t cauchy_ae_start(cauchy_ae_session_t* s, u64 remote_root, u32 remote_depth) {
+    if (!s || s->started) return CAUCHY_ERR_INVALID;
+    if (remote_depth != s->local->depth) return CAUCHY_ERR_INVALID;
+
+    cauchy_result_t res = reserve(s, 1);
+    if (res != CAUCHY_OK) return res;
+    s->started = true;
+    s->level = 0;
+    s->digests_in = 1;
+    s->count = 0;
+    if (cauchy_merkle_root(s->local) != remote_root) s->pending[s->count++] = 0;
+    /* In sync: nothing left to descend into */
+    if (s->count == 0) s->level = s->local->depth;
+    return CAUCHY_OK;
+}
+
+const u64* cauchy_ae_pending(const cauchy_ae_session_t* s, usize* count) {
+    if (count) *count = s ? s->count : 0;
+    return s ? s->pending : NULL;
+}
+
+bool cauchy_ae_done(const cauchy_ae_session_t* s) {
+    return s && s->started && s->level == s->local->depth;
+}
+
+cauchy_result_t cauchy_ae_answer(const cauchy_merkle_t* tree, u32 level,
+                                 const u64* nodes, usize count, u64* out) {
+    if (!tree || !tree->nodes || level >= tree->depth) return CAUCHY_ERR_INVALID;
+    if (count && (!nodes || !out)) return CAUCHY_ERR_INVALID;
+
+    for (usize i = 0; i < count; i++) {
+        if (nodes[i] >> level) return CAUCHY_ERR_INVALID;
+        out[2 * i] = cauchy_merkle_node(tree, level + 1, 2 * nodes[i]);
+        out[2 * i + 1] = cauchy_merkle_node(tree, level + 1, 2 * nodes[i] + 1);
+    }
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_ae_descend(cauchy_ae_session_t* s, const u64* children, usize count) {
+    if (!s || !s->started || cauchy_ae_done(s)) return CAUCHY_ERR_INVALID;
+    if (count != 2 * s->count || (count && !children)) return CAUCHY_ERR_INVALID;
+
+    /* Children land after the parents, then slide down; order is kept */
+    usize parents = s->count;
+    cauchy_result_t res = reserve(s, parents + count);
+    if (res != CAUCHY_OK) return res;
+
+    u32 next = s->level + 1;
+    usize n = 0;
+    for (usize i = 0; i < parents; i++) {
+        for (u64 c = 0; c < 2; c++) {
+            u64 child = 2 * s->pending[i] + c;
+            if (cauchy_merkle_node(s->local, next, child) != children[2 * i + c]) {
+                s->pending[parents + n++] = child;
+            }
+        }
+    }
+    for (usize i = 0; i < n; i++) s->pending[i] = s->pending[parents + i];
+    s->count = n;
+    s->level = next;
+    s->digests_in += count;
+    if (n == 0) s->level = s->local->depth;  /* Sums cancelled out: in sync */
+    return CAUCHY_OK;
+}
+
+/* Run a full descent of dst's digest against src's, in process */
+static cauchy_result_t find_buckets(cauchy_ae_session_t* s, const cauchy_merkle_t* local,
+                                    const cauchy_merkle_t* remote) {
+    cauchy_result_t res = cauchy_ae_session_init(s, local);
+    if (res != CAUCHY_OK) return res;
+    res = cauchy_ae_start(s, cauchy_merkle_root(remote), remote->depth);
+
+    u64* answer = NULL;
+    while (res == CAUCHY_OK && !cauchy_ae_done(s)) {
+        usize n;
+        const u64* nodes = cauchy_ae_pending(s, &n);
+        u64* grown = realloc(answer, 2 * n * sizeof(u64));
+        if (!grown) {
+            res = CAUCHY_ERR_NOMEM;
+            break;
+        }
+        answer = grown;
+        res = cauchy_ae_answer(remote, s->level, nodes, n, answer);
+        if (res == CAUCHY_OK) res = cauchy_ae_descend(s, answer, 2 * n);
+    }
+    free(answer);
+    if (res != CAUCHY_OK) cauchy_ae_session_destroy(s);
+    return res;
+}
+
+cauchy_result_t cauchy_ae_sync_gset(cauchy_gset_t* dst, const cauchy_gset_t* src) {
+    if (!dst || !src || !dst->digest || !src->digest) return CAUCHY_ERR_INVALID;
+
+    cauchy_ae_session_t s;
+    cauchy_result_t res = find_buckets(&s, dst->digest, src->digest);
+    if (res != CAUCHY_OK) return res;
+
+    usize n;
+    const u64* buckets = cauchy_ae_pending(&s, &n);
+    if (n > 0) {
+        cauchy_gset_t* delta = cauchy_gset_create(16);
+        res = delta ? cauchy_gset_collect_buckets(src, src->digest->depth, buckets, n, delta)
+                    : CAUCHY_ERR_NOMEM;
+        if (res == CAUCHY_OK) res = cauchy_gset_merge_delta(dst, delta);
+        cauchy_gset_destroy(delta);
+    }
+    cauchy_ae_session_destroy(&s);
+    return res;
+}
+
+cauchy_result_t cauchy_ae_sync_orset(cauchy_orset_t* dst, const cauchy_orset_t* src) {
+    if (!dst || !src || !dst->digest || !src->digest) return CAUCHY_ERR_INVALID;
+
+    cauchy_ae_session_t s;
+    cauchy_result_t res = find_buckets(&s, dst->digest, src->digest);
+    if (res != CAUCHY_OK) return res;
+
+    usize n;
+    const u64* buckets = cauchy_ae_pending(&s, &n);
+    if (n > 0) {
+        cauchy_orset_t* delta = cauchy_orset_create(16, dst->node_id);
+        res = delta ? cauchy_orset_collect_buckets(src, src->digest->depth, buckets, n, delta)
+                    : CAUCHY_ERR_NOMEM;
+        if (res == CAUCHY_OK) res = cauchy_orset_merge_delta(dst, delta);
+        cauchy_orset_destroy(delta);
+    }
+    cauchy_ae_session_destroy(&s);
+    return res;
+}
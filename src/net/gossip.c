@@ -0,0 +1,579 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * Gossip Transport Implementation
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE  /* sendmmsg(2), recvmmsg(2) */
+#endif
+
+#include "cauchy/net/gossip.h"
+#include "cauchy/wire.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#if defined(CAUCHY_OS_LINUX)
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#else
+#include <poll.h>
+#endif
+
+/* Fixed part of the datagram header: magic, version, flags, sender */
+#define GOSSIP_FIXED_HEADER 14
+
+/* Record framing in front of the payload: key varint, type, u16 length */
+#define GOSSIP_RECORD_MAX_HEADER (CAUCHY_VARINT_MAX + 1 + 2)
+
+/* Datagrams handed to the kernel per send or receive call */
+#define GOSSIP_IO_BATCH 64
+#define GOSSIP_RECV_BATCH 16
+
+/* Receive rounds per poll, so a flood cannot starve the send side */
+#define GOSSIP_RECV_ROUNDS 8
+
+typedef struct gossip_peer {
+    cauchy_node_id_t   node_id;
+    struct sockaddr_in addr;
+} gossip_peer_t;
+
+/* One datagram body. Targets are fixed when the batch is sealed so a
+ * partially sent batch resumes with the same peers. */
+typedef struct gossip_batch {
+    u8*                body;
+    u32                len;
+    u32                records;
+    u32                ntargets;
+    u32                sent;
+    u64                opened_ns;
+    struct sockaddr_in targets[CAUCHY_GOSSIP_MAX_FANOUT];
+} gossip_batch_t;
+
+struct cauchy_gossip {
+    cauchy_context_t*        ctx;
+    cauchy_gossip_config_t   cfg;
+    cauchy_gossip_deliver_fn deliver;
+    void*                    deliver_arg;
+    int                      sock;
+    u16                      port;
+#if defined(CAUCHY_OS_LINUX)
+    int                      epfd;
+    int                      timerfd;
+    bool                     want_out;
+#endif
+
+    gossip_peer_t*  peers;
+    usize           peer_count;
+    usize           peer_capacity;
+    u64             rng;
+
+    /* Ring of batch buffers: `sealed` batches from `head` await sending,
+     * the one after them is open for new records */
+    gossip_batch_t* batches;
+    u8*             bodies;
+    u32             body_cap;
+    u32             head;
+    u32             sealed;
+
+    /* Outstanding reservation in the open batch */
+    bool            reserving;
+    u32             rec_len_at;
+    usize           rec_max;
+
+    u8              header[CAUCHY_GOSSIP_HEADER_MAX];
+    usize           header_len;
+    u8*             recv_buf;
+
+    cauchy_gossip_stats_t stats;
+};
+
+static u64 now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + (u64)ts.tv_nsec;
+}
+
+static u64 next_rand(cauchy_gossip_t* g) {
+    g->rng ^= g->rng << 13;
+    g->rng ^= g->rng >> 7;
+    g->rng ^= g->rng << 17;
+    return g->rng;
+}
+
+CAUCHY_INLINE gossip_batch_t* open_batch(cauchy_gossip_t* g) {
+    if (g->sealed == g->cfg.queue_depth) return NULL;
+    return &g->batches[(g->head + g->sealed) % g->cfg.queue_depth];
+}
+
+static void arm_timer(cauchy_gossip_t* g, u64 delay_ns) {
+#if defined(CAUCHY_OS_LINUX)
+    struct itimerspec its = {0};
+    its.it_value.tv_sec = (time_t)(delay_ns / 1000000000ULL);
+    its.it_value.tv_nsec = (long)(delay_ns % 1000000000ULL);
+    if (delay_ns == 0) its.it_value.tv_nsec = 1;
+    timerfd_settime(g->timerfd, 0, &its, NULL);
+#else
+    (void)g;
+    (void)delay_ns;
+#endif
+}
+
+static void watch_writable(cauchy_gossip_t* g, bool on) {
+#if defined(CAUCHY_OS_LINUX)
+    if (g->want_out == on) return;
+    struct epoll_event ev = { .events = EPOLLIN | (on ? EPOLLOUT : 0), .data.fd = g->sock };
+    epoll_ctl(g->epfd, EPOLL_CTL_MOD, g->sock, &ev);
+    g->want_out = on;
+#else
+    (void)g;
+    (void)on;
+#endif
+}
+
+/* The header is shared by every datagram of a send round */
+static void build_header(cauchy_gossip_t* g) {
+    u8* h = g->header;
+    cauchy_wire_put_u32(h, CAUCHY_GOSSIP_MAGIC);
+    h[4] = CAUCHY_GOSSIP_VERSION;
+    h[5] = 0;
+    cauchy_wire_put_u64(h + 6, g->ctx->node_id);
+    g->header_len = GOSSIP_FIXED_HEADER;
+
+    usize n = cauchy_vclock_encode(&g->ctx->local_clock, NULL, h + GOSSIP_FIXED_HEADER,
+                                   CAUCHY_GOSSIP_HEADER_MAX - GOSSIP_FIXED_HEADER);
+    if (n > 0) {
+        h[5] |= CAUCHY_GOSSIP_FLAG_CLOCK;
+        g->header_len += n;
+    }
+}
+
+/* Pick up to fanout distinct peers; with no peers the batch is dropped */
+static void seal(cauchy_gossip_t* g) {
+    gossip_batch_t* b = open_batch(g);
+    if (!b || b->records == 0) return;
+
+    u32 want = g->cfg.fanout < g->peer_count ? g->cfg.fanout : (u32)g->peer_count;
+    for (u32 i = 0; i < want; i++) {
+        usize j = i + (usize)(next_rand(g) % (g->peer_count - i));
+        gossip_peer_t tmp = g->peers[i];
+        g->peers[i] = g->peers[j];
+        g->peers[j] = tmp;
+        b->targets[i] = g->peers[i].addr;
+    }
+    b->ntargets = want;
+    b->sent = 0;
+
+    if (want == 0) {
+        b->len = 0;
+        b->records = 0;
+        return;
+    }
+    g->sealed++;
+
+    gossip_batch_t* next = open_batch(g);
+    if (next) {
+        next->len = 0;
+        next->records = 0;
+    }
+}
+
+static void release_head(cauchy_gossip_t* g) {
+    gossip_batch_t* b = &g->batches[g->head];
+    g->stats.records_sent += b->records;
+    g->head = (g->head + 1) % g->cfg.queue_depth;
+    g->sealed--;
+    if (g->sealed + 1 == g->cfg.queue_depth) {
+        /* The ring was full: the freed slot becomes the open batch */
+        gossip_batch_t* open = open_batch(g);
+        open->len = 0;
+        open->records = 0;
+    }
+}
+
+/* Hand sealed batches to the socket, one gather write per target */
+static void send_due(cauchy_gossip_t* g) {
+    if (g->sealed == 0) {
+        watch_writable(g, false);
+        return;
+    }
+    build_header(g);
+
+    while (g->sealed > 0) {
+        struct iovec iov[GOSSIP_IO_BATCH][2];
+#if defined(CAUCHY_OS_LINUX)
+        struct mmsghdr msgs[GOSSIP_IO_BATCH];
+#else
+        struct msghdr msgs[GOSSIP_IO_BATCH];
+#endif
+        u32 n = 0;
+        for (u32 i = 0; i < g->sealed && n < GOSSIP_IO_BATCH; i++) {
+            gossip_batch_t* b = &g->batches[(g->head + i) % g->cfg.queue_depth];
+            for (u32 t = b->sent; t < b->ntargets && n < GOSSIP_IO_BATCH; t++, n++) {
+                iov[n][0].iov_base = g->header;
+                iov[n][0].iov_len = g->header_len;
+                iov[n][1].iov_base = b->body;
+                iov[n][1].iov_len = b->len;
+#if defined(CAUCHY_OS_LINUX)
+                struct msghdr* m = &msgs[n].msg_hdr;
+                msgs[n].msg_len = 0;
+#else
+                struct msghdr* m = &msgs[n];
+#endif
+                memset(m, 0, sizeof(*m));
+                m->msg_name = &b->targets[t];
+                m->msg_namelen = sizeof(struct sockaddr_in);
+                m->msg_iov = iov[n];
+                m->msg_iovlen = 2;
+            }
+        }
+
+        int done;
+#if defined(CAUCHY_OS_LINUX)
+        done = sendmmsg(g->sock, msgs, n, MSG_DONTWAIT);
+#else
+        done = 0;
+        while ((u32)done < n && sendmsg(g->sock, &msgs[done], MSG_DONTWAIT) >= 0) done++;
+        if (done == 0 && n > 0) done = -1;
+#endif
+        if (done < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                watch_writable(g, true);
+                return;
+            }
+            if (errno == EINTR) continue;
+            done = 1;  /* Per-destination failure: skip it rather than spin */
+        }
+
+        for (u32 k = 0; k < (u32)done; k++) {
+            gossip_batch_t* b = &g->batches[g->head];
+            g->stats.datagrams_sent++;
+            g->stats.bytes_sent += g->header_len + b->len;
+            if (++b->sent == b->ntargets) release_head(g);
+        }
+        if ((u32)done < n) {
+            watch_writable(g, true);
+            return;
+        }
+    }
+    watch_writable(g, false);
+}
+
+cauchy_gossip_t* cauchy_gossip_create(cauchy_context_t* ctx,
+                                      const cauchy_gossip_config_t* cfg,
+                                      cauchy_gossip_deliver_fn deliver, void* arg) {
+    cauchy_gossip_config_t defaults = CAUCHY_GOSSIP_CONFIG_DEFAULT;
+    if (!cfg) cfg = &defaults;
+    if (!ctx || cfg->queue_depth == 0 || cfg->fanout > CAUCHY_GOSSIP_MAX_FANOUT ||
+        cfg->max_datagram > CAUCHY_GOSSIP_MAX_DATAGRAM ||
+        cfg->max_datagram < CAUCHY_GOSSIP_HEADER_MAX + 2 * GOSSIP_RECORD_MAX_HEADER) {
+        return NULL;
+    }
+
+    cauchy_gossip_t* g = calloc(1, sizeof(cauchy_gossip_t));
+    if (!g) return NULL;
+    g->ctx = ctx;
+    g->cfg = *cfg;
+    g->deliver = deliver;
+    g->deliver_arg = arg;
+    g->sock = -1;
+#if defined(CAUCHY_OS_LINUX)
+    g->epfd = -1;
+    g->timerfd = -1;
+#endif
+    g->rng = 0x9E3779B97F4A7C15ULL ^ ctx->node_id ^ now_ns();
+    if (g->rng == 0) g->rng = 1;
+    g->body_cap = cfg->max_datagram - CAUCHY_GOSSIP_HEADER_MAX;
+
+    g->batches = calloc(cfg->queue_depth, sizeof(gossip_batch_t));
+    g->bodies = malloc((usize)cfg->queue_depth * g->body_cap);
+    g->recv_buf = malloc((usize)GOSSIP_RECV_BATCH * CAUCHY_GOSSIP_MAX_DATAGRAM);
+    if (!g->batches || !g->bodies || !g->recv_buf) goto fail;
+    for (u32 i = 0; i < cfg->queue_depth; i++) {
+        g->batches[i].body = g->bodies + (usize)i * g->body_cap;
+    }
+
+    g->sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (g->sock < 0) goto fail;
+    fcntl(g->sock, F_SETFL, fcntl(g->sock, F_GETFL, 0) | O_NONBLOCK);
+
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(cfg->port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (cfg->bind_addr && inet_pton(AF_INET, cfg->bind_addr, &addr.sin_addr) != 1) goto fail;
+    if (bind(g->sock, (struct sockaddr*)&addr, sizeof(addr)) != 0) goto fail;
+
+    socklen_t len = sizeof(addr);
+    if (getsockname(g->sock, (struct sockaddr*)&addr, &len) != 0) goto fail;
+    g->port = ntohs(addr.sin_port);
+
+#if defined(CAUCHY_OS_LINUX)
+    g->epfd = epoll_create1(EPOLL_CLOEXEC);
+    g->timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (g->epfd < 0 || g->timerfd < 0) goto fail;
+    struct epoll_event ev = { .events = EPOLLIN, .data.fd = g->sock };
+    if (epoll_ctl(g->epfd, EPOLL_CTL_ADD, g->sock, &ev) != 0) goto fail;
+    ev.data.fd = g->timerfd;
+    if (epoll_ctl(g->epfd, EPOLL_CTL_ADD, g->timerfd, &ev) != 0) goto fail;
+#endif
+    return g;
+
+fail:
+    cauchy_gossip_destroy(g);
+    return NULL;
+}
+
+void cauchy_gossip_destroy(cauchy_gossip_t* g) {
+    if (!g) return;
+    if (g->sock >= 0) close(g->sock);
+#if defined(CAUCHY_OS_LINUX)
+    if (g->epfd >= 0) close(g->epfd);
+    if (g->timerfd >= 0) close(g->timerfd);
+#endif
+    free(g->peers);
+    free(g->batches);
+    free(g->bodies);
+    free(g->recv_buf);
+    free(g);
+}
+
+u16 cauchy_gossip_port(const cauchy_gossip_t* g) {
+    return g ? g->port : 0;
+}
+
+int cauchy_gossip_fd(const cauchy_gossip_t* g) {
+    if (!g) return -1;
+#if defined(CAUCHY_OS_LINUX)
+    return g->epfd;
+#else
+    return g->sock;
+#endif
+}
+
+cauchy_result_t cauchy_gossip_add_peer(cauchy_gossip_t* g, cauchy_node_id_t node_id,
+                                       const char* host, u16 port) {
+    if (!g || !host) return CAUCHY_ERR_INVALID;
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) return CAUCHY_ERR_INVALID;
+
+    for (usize i = 0; i < g->peer_count; i++) {
+        if (g->peers[i].node_id == node_id) {
+            g->peers[i].addr = addr;
+            return CAUCHY_OK;
+        }
+    }
+    if (g->peer_count == g->peer_capacity) {
+        usize cap = g->peer_capacity ? g->peer_capacity * 2 : 8;
+        gossip_peer_t* grown = realloc(g->peers, cap * sizeof(gossip_peer_t));
+        if (!grown) return CAUCHY_ERR_NOMEM;
+        g->peers = grown;
+        g->peer_capacity = cap;
+    }
+    g->peers[g->peer_count].node_id = node_id;
+    g->peers[g->peer_count].addr = addr;
+    g->peer_count++;
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_gossip_remove_peer(cauchy_gossip_t* g, cauchy_node_id_t node_id) {
+    if (!g) return CAUCHY_ERR_INVALID;
+    for (usize i = 0; i < g->peer_count; i++) {
+        if (g->peers[i].node_id == node_id) {
+            g->peers[i] = g->peers[--g->peer_count];
+            return CAUCHY_OK;
+        }
+    }
+    return CAUCHY_ERR_NOTFOUND;
+}
+
+usize cauchy_gossip_peer_count(const cauchy_gossip_t* g) {
+    return g ? g->peer_count : 0;
+}
+
+cauchy_result_t cauchy_gossip_reserve(cauchy_gossip_t* g, u64 key, u8 type,
+                                      usize max_size, u8** out) {
+    if (!g || !out || g->reserving) return CAUCHY_ERR_INVALID;
+    usize framing = cauchy_varint_size(key) + 1 + 2;
+    if (max_size > UINT16_MAX || framing + max_size > g->body_cap) return CAUCHY_ERR_INVALID;
+
+    gossip_batch_t* b = open_batch(g);
+    if (b && b->len + framing + max_size > g->body_cap) {
+        seal(g);
+        send_due(g);
+        b = open_batch(g);
+    }
+    if (!b) {
+        send_due(g);
+        b = open_batch(g);
+    }
+    if (!b) {
+        g->stats.backpressure++;
+        return CAUCHY_ERR_FULL;
+    }
+
+    usize pos = b->len;
+    cauchy_varint_put(b->body, g->body_cap, &pos, key);
+    b->body[pos++] = type;
+    g->rec_len_at = (u32)pos;
+    g->rec_max = max_size;
+    g->reserving = true;
+    *out = b->body + pos + 2;
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_gossip_commit(cauchy_gossip_t* g, usize size) {
+    if (!g || !g->reserving) return CAUCHY_ERR_INVALID;
+    gossip_batch_t* b = open_batch(g);
+    g->reserving = false;
+    if (size == 0) return CAUCHY_OK;
+    if (!b || size > g->rec_max) return CAUCHY_ERR_INVALID;
+
+    b->body[g->rec_len_at] = (u8)size;
+    b->body[g->rec_len_at + 1] = (u8)(size >> 8);
+    b->len = g->rec_len_at + 2 + (u32)size;
+    if (b->records++ == 0) {
+        b->opened_ns = now_ns();
+        arm_timer(g, (u64)g->cfg.interval_us * 1000);
+    }
+    return CAUCHY_OK;
+}
+
+cauchy_result_t cauchy_gossip_publish(cauchy_gossip_t* g, u64 key, u8 type,
+                                      const void* data, usize size) {
+    if (size && !data) return CAUCHY_ERR_INVALID;
+    u8* dst;
+    cauchy_result_t res = cauchy_gossip_reserve(g, key, type, size, &dst);
+    if (res != CAUCHY_OK) return res;
+    if (size) memcpy(dst, data, size);
+    return cauchy_gossip_commit(g, size);
+}
+
+cauchy_result_t cauchy_gossip_flush(cauchy_gossip_t* g) {
+    if (!g || g->reserving) return CAUCHY_ERR_INVALID;
+    seal(g);
+    send_due(g);
+    return g->sealed ? CAUCHY_ERR_FULL : CAUCHY_OK;
+}
+
+static void handle_datagram(cauchy_gossip_t* g, const u8* buf, usize len) {
+    if (len < GOSSIP_FIXED_HEADER || cauchy_wire_get_u32(buf) != CAUCHY_GOSSIP_MAGIC ||
+        buf[4] != CAUCHY_GOSSIP_VERSION) {
+        g->stats.datagrams_dropped++;
+        return;
+    }
+    u8 flags = buf[5];
+    cauchy_node_id_t from = cauchy_wire_get_u64(buf + 6);
+    usize pos = GOSSIP_FIXED_HEADER;
+
+    if (flags & CAUCHY_GOSSIP_FLAG_CLOCK) {
+        cauchy_vclock_t remote;
+        usize used;
+        if (cauchy_vclock_decode(&remote, NULL, buf + pos, len - pos, &used) != CAUCHY_OK) {
+            g->stats.datagrams_dropped++;
+            return;
+        }
+        cauchy_context_merge_clock(g->ctx, &remote);
+        cauchy_vclock_fini(&remote);
+        pos += used;
+    }
+
+    g->stats.datagrams_received++;
+    while (pos < len) {
+        u64 key;
+        if (!cauchy_varint_get(buf, len, &pos, &key) || len - pos < 3) break;
+        u8 type = buf[pos];
+        usize size = (usize)buf[pos + 1] | (usize)buf[pos + 2] << 8;
+        pos += 3;
+        if (len - pos < size) break;
+        g->stats.records_received++;
+        if (g->deliver) g->deliver(g->deliver_arg, from, key, type, buf + pos, size);
+        pos += size;
+    }
+}
+
+static void receive(cauchy_gossip_t* g) {
+    for (int round = 0; round < GOSSIP_RECV_ROUNDS; round++) {
+#if defined(CAUCHY_OS_LINUX)
+        struct mmsghdr msgs[GOSSIP_RECV_BATCH];
+        struct iovec iov[GOSSIP_RECV_BATCH];
+        memset(msgs, 0, sizeof(msgs));
+        for (int i = 0; i < GOSSIP_RECV_BATCH; i++) {
+            iov[i].iov_base = g->recv_buf + (usize)i * CAUCHY_GOSSIP_MAX_DATAGRAM;
+            iov[i].iov_len = CAUCHY_GOSSIP_MAX_DATAGRAM;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        int n = recvmmsg(g->sock, msgs, GOSSIP_RECV_BATCH, MSG_DONTWAIT, NULL);
+        if (n <= 0) return;
+        for (int i = 0; i < n; i++) handle_datagram(g, iov[i].iov_base, msgs[i].msg_len);
+        if (n < GOSSIP_RECV_BATCH) return;
+#else
+        ssize_t n = recv(g->sock, g->recv_buf, CAUCHY_GOSSIP_MAX_DATAGRAM, MSG_DONTWAIT);
+        if (n <= 0) return;
+        handle_datagram(g, g->recv_buf, (usize)n);
+#endif
+    }
+}
+
+/* Seal the open batch once its oldest record has waited long enough.
+ * Never under a reservation: the record being written is still in it. */
+static u64 check_deadline(cauchy_gossip_t* g) {
+    gossip_batch_t* b = open_batch(g);
+    if (!b || b->records == 0 || g->reserving) return UINT64_MAX;
+    u64 deadline = b->opened_ns + (u64)g->cfg.interval_us * 1000;
+    u64 now = now_ns();
+    if (now < deadline) return deadline - now;
+    seal(g);
+    return UINT64_MAX;
+}
+
+cauchy_result_t cauchy_gossip_poll(cauchy_gossip_t* g, int timeout_ms) {
+    if (!g) return CAUCHY_ERR_INVALID;
+
+    u64 wait_ns = check_deadline(g);
+    send_due(g);
+    if (wait_ns == 0 || g->reserving) timeout_ms = 0;
+
+#if defined(CAUCHY_OS_LINUX)
+    (void)wait_ns;  /* The timerfd wakes us at the batch deadline */
+    struct epoll_event events[4];
+    int n = epoll_wait(g->epfd, events, 4, timeout_ms);
+    if (n < 0 && errno != EINTR) return CAUCHY_ERR_NETWORK;
+    for (int i = 0; i < n; i++) {
+        if (events[i].data.fd == g->timerfd) {
+            u64 expirations;
+            while (read(g->timerfd, &expirations, sizeof(expirations)) > 0) {}
+        } else if (events[i].events & EPOLLIN) {
+            receive(g);
+        }
+    }
+#else
+    if (wait_ns != UINT64_MAX) {
+        int deadline_ms = (int)((wait_ns + 999999) / 1000000);
+        if (timeout_ms < 0 || deadline_ms < timeout_ms) timeout_ms = deadline_ms;
+    }
+    struct pollfd pfd = { .fd = g->sock, .events = POLLIN | (g->sealed ? POLLOUT : 0) };
+    int n = poll(&pfd, 1, timeout_ms);
+    if (n < 0 && errno != EINTR) return CAUCHY_ERR_NETWORK;
+    if (n > 0 && (pfd.revents & POLLIN)) receive(g);
+#endif
+
+    check_deadline(g);
+    send_due(g);
+    return CAUCHY_OK;
+}
+
+void cauchy_gossip_get_stats(const cauchy_gossip_t* g, cauchy_gossip_stats_t* out) {
+    if (!g || !out) return;
+    *out = g->stats;
+}
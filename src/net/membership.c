@@ -0,0 +1,571 @@
+/*
+ * CAUCHY - Lock-Free Distributed State Convergence
+ * SWIM Membership Implementation
+ */
+
+#include "cauchy/net/membership.h"
+#include "cauchy/wire.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Message layout (integers are varints unless noted):
+ *   u32 LE magic, u8 version, u8 type, sender, sender incarnation,
+ *   seq, origin, target, u8 update count,
+ *   per update: node, u8 state, incarnation,
+ *   vclock encoding of the sender's clock.
+ * PING asks the receiver to ACK back to the sender. PING_REQ asks it to
+ * ping target on origin's behalf; the relay keeps no state, the ACK names
+ * origin and is forwarded there. */
+#define SWIM_MAGIC    0x4D575343u  /* "CSWM" */
+#define SWIM_VERSION  1
+
+enum { SWIM_PING = 1, SWIM_ACK = 2, SWIM_PING_REQ = 3 };
+
+#define SWIM_FIXED_MAX   (4 + 2 + 5 * CAUCHY_VARINT_MAX + 1)
+#define SWIM_UPDATE_MAX  (2 * CAUCHY_VARINT_MAX + 1)
+
+typedef struct member {
+    cauchy_node_id_t node;
+    u8               state;
+    bool             has_clock;
+    u64              incarnation;
+    u64              since_ms;     /* When the current state was entered */
+    cauchy_vclock_t  clock;        /* Last clock the member reported */
+} member_t;
+
+typedef struct update {
+    cauchy_node_id_t node;
+    u8               state;
+    u64              incarnation;
+    u32              remaining;    /* Piggyback transmissions left */
+} update_t;
+
+struct cauchy_membership {
+    cauchy_context_t*          ctx;
+    cauchy_membership_config_t cfg;
+    u64                        incarnation;
+    bool                       left;
+
+    member_t*                  members;
+    usize                      member_count;
+    usize                      member_capacity;
+    usize                      probe_cursor;  /* Round-robin over a shuffled order */
+
+    update_t*                  updates;
+    usize                      update_count;
+    usize                      update_capacity;
+
+    /* Probe in flight */
+    bool                       probing;
+    bool                       acked;
+    bool                       indirect_sent;
+    cauchy_node_id_t           probe_target;
+    u64                        probe_seq;
+    u64                        probe_started;
+    u64                        next_probe;
+    u64                        seq;
+
+    cauchy_vclock_t            frontier;
+    cauchy_vclock_t            departed;   /* Stable values of departed members */
+    cauchy_vclock_t**          tracked;
+    usize                      tracked_count;
+    usize                      tracked_capacity;
+
+    u8*                        buf;
+    usize                      buf_capacity;
+    u64                        rng;
+    cauchy_membership_stats_t  stats;
+};
+
+static u64 next_random(cauchy_membership_t* m) {
+    m->rng ^= m->rng << 13;
+    m->rng ^= m->rng >> 7;
+    m->rng ^= m->rng << 17;
+    return m->rng;
+}
+
+static member_t* find_member(const cauchy_membership_t* m, cauchy_node_id_t node) {
+    for (usize i = 0; i < m->member_count; i++) {
+        if (m->members[i].node == node) return &m->members[i];
+    }
+    return NULL;
+}
+
+static bool is_live(u8 state) {
+    return state == CAUCHY_MEMBER_ALIVE || state == CAUCHY_MEMBER_SUSPECT;
+}
+
+static member_t* insert_member(cauchy_membership_t* m, cauchy_node_id_t node,
+                               u8 state, u64 incarnation, u64 now_ms) {
+    if (m->member_count == m->member_capacity) {
+        usize cap = m->member_capacity ? m->member_capacity * 2 : 8;
+        member_t* grown = realloc(m->members, cap * sizeof(member_t));
+        if (!grown) return NULL;
+        m->members = grown;
+        m->member_capacity = cap;
+    }
+    member_t* mb = &m->members[m->member_count++];
+    mb->node = node;
+    mb->state = state;
+    mb->has_clock = false;
+    mb->incarnation = incarnation;
+    mb->since_ms = now_ms;
+    cauchy_vclock_init(&mb->clock, 0);
+    return mb;
+}
+
+static void remove_member(cauchy_membership_t* m, usize index) {
+    cauchy_vclock_fini(&m->members[index].clock);
+    m->members[index] = m->members[--m->member_count];
+    if (m->probe_cursor > m->member_count) m->probe_cursor = m->member_count;
+}
+
+/* ceil(log2(n + 1)) transmissions per unit of retransmit_mult */
+static u32 retransmit_limit(const cauchy_membership_t* m) {
+    u32 rounds = 1;
+    for (usize n = m->member_count + 1; n > 1; n = (n + 1) / 2) rounds++;
+    return m->cfg.retransmit_mult * rounds;
+}
+
+/* Queue an update for piggybacking, replacing any older one for the node */
+static void disseminate(cauchy_membership_t* m, cauchy_node_id_t node, u8 state, u64 incarnation) {
+    update_t* u = NULL;
+    for (usize i = 0; i < m->update_count; i++) {
+        if (m->updates[i].node == node) {
+            u = &m->updates[i];
+            break;
+        }
+    }
+    if (!u) {
+        if (m->update_count == m->update_capacity) {
+            usize cap = m->update_capacity ? m->update_capacity * 2 : 8;
+            update_t* grown = realloc(m->updates, cap * sizeof(update_t));
+            if (!grown) return;  /* Dissemination is best effort; probes repair it */
+            m->updates = grown;
+            m->update_capacity = cap;
+        }
+        u = &m->updates[m->update_count++];
+    }
+    u->node = node;
+    u->state = state;
+    u->incarnation = incarnation;
+    u->remaining = retransmit_limit(m);
+}
+
+static void set_state(cauchy_membership_t* m, member_t* mb, u8 state, u64 incarnation, u64 now_ms) {
+    bool changed = mb->state != state;
+    mb->state = state;
+    mb->incarnation = incarnation;
+    mb->since_ms = now_ms;
+    disseminate(m, mb->node, state, incarnation);
+    if (state == CAUCHY_MEMBER_SUSPECT && changed) m->stats.suspicions++;
+    if (state == CAUCHY_MEMBER_DEAD && changed) m->stats.deaths++;
+    if (changed && m->cfg.on_event) m->cfg.on_event(m->cfg.arg, mb->node, state);
+}
+
+/* SWIM precedence: a higher incarnation wins; at equal incarnations
+ * SUSPECT beats ALIVE; DEAD and LEFT are final */
+static void apply_update(cauchy_membership_t* m, cauchy_node_id_t node, u8 state,
+                         u64 incarnation, u64 now_ms) {
+    if (node == m->ctx->node_id) {
+        if (m->left || state == CAUCHY_MEMBER_ALIVE || incarnation < m->incarnation) return;
+        /* Refute by outliving the accusation */
+        m->incarnation = incarnation + 1;
+        m->stats.refutations++;
+        disseminate(m, node, CAUCHY_MEMBER_ALIVE, m->incarnation);
+        return;
+    }
+
+    member_t* mb = find_member(m, node);
+    if (!mb) {
+        mb = insert_member(m, node, state, incarnation, now_ms);
+        if (!mb) return;
+        disseminate(m, node, state, incarnation);
+        if (m->cfg.on_event) m->cfg.on_event(m->cfg.arg, node, state);
+        return;
+    }
+
+    if (!is_live(mb->state)) return;
+    bool wins;
+    switch (state) {
+    case CAUCHY_MEMBER_ALIVE:
+        wins = incarnation > mb->incarnation;
+        break;
+    case CAUCHY_MEMBER_SUSPECT:
+        wins = incarnation > mb->incarnation ||
+               (incarnation == mb->incarnation && mb->state == CAUCHY_MEMBER_ALIVE);
+        break;
+    default:
+        wins = true;
+        break;
+    }
+    if (wins) set_state(m, mb, state, incarnation, now_ms);
+}
+
+static u8* scratch(cauchy_membership_t* m, usize need) {
+    if (need > m->buf_capacity) {
+        u8* grown = realloc(m->buf, need);
+        if (!grown) return NULL;
+        m->buf = grown;
+        m->buf_capacity = need;
+    }
+    return m->buf;
+}
+
+static void send_message(cauchy_membership_t* m, cauchy_node_id_t to, u8 type,
+                         u64 seq, cauchy_node_id_t origin, cauchy_node_id_t target) {
+    const cauchy_vclock_t* clock = &m->ctx->local_clock;
+    usize clock_size = cauchy_vclock_encoded_size(clock, NULL);
+    usize piggyback = m->update_count < CAUCHY_MEMBERSHIP_MAX_PIGGYBACK
+                    ? m->update_count : CAUCHY_MEMBERSHIP_MAX_PIGGYBACK;
+    usize cap = SWIM_FIXED_MAX + piggyback * SWIM_UPDATE_MAX + clock_size;
+    u8* buf = scratch(m, cap);
+    if (!buf) return;
+
+    usize pos = 0;
+    cauchy_wire_put_u32(buf, SWIM_MAGIC);
+    buf[4] = SWIM_VERSION;
+    buf[5] = type;
+    pos = 6;
+    cauchy_varint_put(buf, cap, &pos, m->ctx->node_id);
+    cauchy_varint_put(buf, cap, &pos, m->incarnation);
+    cauchy_varint_put(buf, cap, &pos, seq);
+    cauchy_varint_put(buf, cap, &pos, origin);
+    cauchy_varint_put(buf, cap, &pos, target);
+
+    /* Updates with the most transmissions left are the freshest; the
+     * queue is short, so a selection pass per slot is enough */
+    buf[pos++] = (u8)piggyback;
+    for (usize k = 0; k < piggyback; k++) {
+        usize best = k;
+        for (usize i = k + 1; i < m->update_count; i++) {
+            if (m->updates[i].remaining > m->updates[best].remaining) best = i;
+        }
+        update_t tmp = m->updates[k];
+        m->updates[k] = m->updates[best];
+        m->updates[best] = tmp;
+
+        update_t* u = &m->updates[k];
+        cauchy_varint_put(buf, cap, &pos, u->node);
+        buf[pos++] = u->state;
+        cauchy_varint_put(buf, cap, &pos, u->incarnation);
+        u->remaining--;
+    }
+    /* Drop exhausted updates */
+    usize kept = 0;
+    for (usize i = 0; i < m->update_count; i++) {
+        if (m->updates[i].remaining) m->updates[kept++] = m->updates[i];
+    }
+    m->update_count = kept;
+
+    pos += cauchy_vclock_encode(clock, NULL, buf + pos, cap - pos);
+    m->cfg.send(m->cfg.arg, to, buf, pos);
+}
+
+/* ------------------------------------------------------------------------ */
+
+cauchy_membership_t* cauchy_membership_create(cauchy_context_t* ctx,
+                                              const cauchy_membership_config_t* cfg) {
+    if (!ctx || !cfg || !cfg->send || cfg->probe_interval_ms == 0) return NULL;
+
+    cauchy_membership_t* m = calloc(1, sizeof(cauchy_membership_t));
+    if (!m) return NULL;
+    m->ctx = ctx;
+    m->cfg = *cfg;
+    if (m->cfg.retransmit_mult == 0) m->cfg.retransmit_mult = 1;
+    if (m->cfg.probe_timeout_ms > m->cfg.probe_interval_ms) {
+        m->cfg.probe_timeout_ms = m->cfg.probe_interval_ms;
+    }
+    cauchy_vclock_init(&m->frontier, 0);
+    cauchy_vclock_init(&m->departed, 0);
+    m->rng = 0x9E3779B97F4A7C15ULL ^ ((u64)ctx->node_id << 17 | ctx->node_id);
+    if (m->rng == 0) m->rng = 1;
+    return m;
+}
+
+void cauchy_membership_destroy(cauchy_membership_t* m) {
+    if (!m) return;
+    for (usize i = 0; i < m->member_count; i++) cauchy_vclock_fini(&m->members[i].clock);
+    free(m->members);
+    free(m->updates);
+    free(m->tracked);
+    free(m->buf);
+    cauchy_vclock_fini(&m->frontier);
+    cauchy_vclock_fini(&m->departed);
+    free(m);
+}
+
+cauchy_result_t cauchy_membership_add(cauchy_membership_t* m, cauchy_node_id_t node) {
+    if (!m || node == m->ctx->node_id) return CAUCHY_ERR_INVALID;
+    if (find_member(m, node)) return CAUCHY_ERR_EXISTS;
+    member_t* mb = insert_member(m, node, CAUCHY_MEMBER_ALIVE, 0, 0);
+    return mb ? CAUCHY_OK : CAUCHY_ERR_NOMEM;
+}
+
+void cauchy_membership_leave(cauchy_membership_t* m) {
+    if (!m || m->left) return;
+    m->left = true;
+    disseminate(m, m->ctx->node_id, CAUCHY_MEMBER_LEFT, m->incarnation);
+    for (usize i = 0; i < m->member_count; i++) {
+        if (is_live(m->members[i].state)) {
+            send_message(m, m->members[i].node, SWIM_PING, 0, m->ctx->node_id,
+                         m->members[i].node);
+        }
+    }
+}
+
+cauchy_result_t cauchy_membership_receive(cauchy_membership_t* m, const u8* data,
+                                          usize size, u64 now_ms) {
+    if (!m || !data) return CAUCHY_ERR_INVALID;
+    if (size < 6 || cauchy_wire_get_u32(data) != SWIM_MAGIC || data[4] != SWIM_VERSION) {
+        return CAUCHY_ERR_INVALID;
+    }
+    u8 type = data[5];
+    usize pos = 6;
+    u64 sender, incarnation, seq, origin, target;
+    if (!cauchy_varint_get(data, size, &pos, &sender) ||
+        !cauchy_varint_get(data, size, &pos, &incarnation) ||
+        !cauchy_varint_get(data, size, &pos, &seq) ||
+        !cauchy_varint_get(data, size, &pos, &origin) ||
+        !cauchy_varint_get(data, size, &pos, &target) ||
+        pos >= size || sender == m->ctx->node_id) {
+        return CAUCHY_ERR_INVALID;
+    }
+    if (type < SWIM_PING || type > SWIM_PING_REQ) return CAUCHY_ERR_INVALID;
+
+    /* Validate the whole datagram before acting on any of it */
+    usize updates = data[pos++];
+    usize update_pos = pos;
+    for (usize i = 0; i < updates; i++) {
+        u64 node, inc;
+        if (!cauchy_varint_get(data, size, &pos, &node) || pos >= size ||
+            data[pos++] > CAUCHY_MEMBER_LEFT ||
+            !cauchy_varint_get(data, size, &pos, &inc)) {
+            return CAUCHY_ERR_INVALID;
+        }
+    }
+    cauchy_vclock_t clock;
+    cauchy_result_t res = cauchy_vclock_decode(&clock, NULL, data + pos, size - pos, NULL);
+    if (res != CAUCHY_OK) return res;
+
+    /* Hearing from a node is first-hand evidence that it is alive */
+    apply_update(m, sender, CAUCHY_MEMBER_ALIVE, incarnation, now_ms);
+    pos = update_pos;
+    for (usize i = 0; i < updates; i++) {
+        u64 node = 0, inc = 0;
+        cauchy_varint_get(data, size, &pos, &node);
+        u8 state = data[pos++];
+        cauchy_varint_get(data, size, &pos, &inc);
+        apply_update(m, node, state, inc, now_ms);
+    }
+
+    member_t* mb = find_member(m, sender);
+    if (mb) {
+        cauchy_vclock_fini(&mb->clock);
+        mb->clock = clock;
+        mb->has_clock = true;
+    } else {
+        cauchy_vclock_fini(&clock);
+    }
+    if (m->left) return CAUCHY_OK;
+
+    switch (type) {
+    case SWIM_PING:
+        send_message(m, sender, SWIM_ACK, seq, origin, m->ctx->node_id);
+        break;
+    case SWIM_PING_REQ:
+        if (target != m->ctx->node_id) send_message(m, target, SWIM_PING, seq, origin, target);
+        break;
+    case SWIM_ACK:
+        if (origin != m->ctx->node_id) {
+            send_message(m, origin, SWIM_ACK, seq, origin, target);  /* Relay */
+        } else if (m->probing && seq == m->probe_seq && target == m->probe_target) {
+            m->acked = true;
+        }
+        break;
+    }
+    return CAUCHY_OK;
+}
+
+/* Minimum over our clock and every live member's, or false while some
+ * live member has not reported yet */
+static bool compute_frontier(cauchy_membership_t* m) {
+    for (usize i = 0; i < m->member_count; i++) {
+        if (is_live(m->members[i].state) && !m->members[i].has_clock) return false;
+    }
+    cauchy_vclock_fini(&m->frontier);
+    if (cauchy_vclock_copy(&m->frontier, &m->ctx->local_clock) != CAUCHY_OK) return false;
+    for (usize i = 0; i < m->member_count; i++) {
+        if (is_live(m->members[i].state)) cauchy_vclock_min(&m->frontier, &m->members[i].clock);
+    }
+
+    /* Departed members will not advance: whatever every live member has
+     * seen of them is final. Remember it, since the entries disappear
+     * from the live clocks once pruned. */
+    for (usize i = 0; i < m->member_count; i++) {
+        const member_t* mb = &m->members[i];
+        if (is_live(mb->state)) continue;
+        u64 v = cauchy_vclock_get(&m->frontier, mb->node);
+        if (v > cauchy_vclock_get(&m->departed, mb->node)) {
+            cauchy_vclock_set(&m->departed, mb->node, v);
+        }
+    }
+    cauchy_vclock_merge(&m->frontier, &m->departed);
+    return true;
+}
+
+static void publish_frontier(cauchy_membership_t* m) {
+    if (!compute_frontier(m)) return;
+    m->stats.frontiers++;
+    if (m->cfg.on_stable) m->cfg.on_stable(m->cfg.arg, &m->frontier, &m->departed);
+    if (cauchy_vclock_is_empty(&m->departed)) return;
+
+    u64 pruned = cauchy_vclock_prune(&m->ctx->local_clock, &m->departed);
+    for (usize i = 0; i < m->tracked_count; i++) {
+        pruned += cauchy_vclock_prune(m->tracked[i], &m->departed);
+    }
+    for (usize i = 0; i < m->member_count; i++) {
+        cauchy_vclock_prune(&m->members[i].clock, &m->departed);
+    }
+    m->stats.pruned_entries += pruned;
+}
+
+/* Next live member in a shuffled round-robin, which bounds the time to
+ * first detection of a failure by the member count (SWIM section 4.3) */
+static member_t* next_target(cauchy_membership_t* m) {
+    for (usize tries = 0; m->member_count && tries <= m->member_count; tries++) {
+        if (m->probe_cursor >= m->member_count) {
+            for (usize i = m->member_count; i > 1; i--) {
+                usize j = next_random(m) % i;
+                member_t tmp = m->members[i - 1];
+                m->members[i - 1] = m->members[j];
+                m->members[j] = tmp;
+            }
+            m->probe_cursor = 0;
+        }
+        member_t* mb = &m->members[m->probe_cursor++];
+        if (is_live(mb->state)) return mb;
+    }
+    return NULL;
+}
+
+static void send_indirect(cauchy_membership_t* m) {
+    usize candidates = 0;
+    for (usize i = 0; i < m->member_count; i++) {
+        if (m->members[i].state == CAUCHY_MEMBER_ALIVE && m->members[i].node != m->probe_target) {
+            candidates++;
+        }
+    }
+    /* Pick k helpers uniformly (selection sampling keeps it one pass) */
+    usize want = m->cfg.indirect_probes < candidates ? m->cfg.indirect_probes : candidates;
+    for (usize i = 0; i < m->member_count && want; i++) {
+        const member_t* mb = &m->members[i];
+        if (mb->state != CAUCHY_MEMBER_ALIVE || mb->node == m->probe_target) continue;
+        if (next_random(m) % candidates < want) {
+            send_message(m, mb->node, SWIM_PING_REQ, m->probe_seq, m->ctx->node_id,
+                         m->probe_target);
+            m->stats.indirect_probes++;
+            want--;
+        }
+        candidates--;
+    }
+}
+
+void cauchy_membership_tick(cauchy_membership_t* m, u64 now_ms) {
+    if (!m || m->left) return;
+
+    if (m->probing && !m->acked) {
+        if (!m->indirect_sent && now_ms >= m->probe_started + m->cfg.probe_timeout_ms) {
+            m->indirect_sent = true;
+            send_indirect(m);
+        }
+        if (now_ms >= m->probe_started + m->cfg.probe_interval_ms) {
+            member_t* mb = find_member(m, m->probe_target);
+            if (mb && mb->state == CAUCHY_MEMBER_ALIVE) {
+                set_state(m, mb, CAUCHY_MEMBER_SUSPECT, mb->incarnation, now_ms);
+            }
+            m->probing = false;
+        }
+    }
+    if (m->acked) m->probing = false;
+
+    for (usize i = 0; i < m->member_count;) {
+        member_t* mb = &m->members[i];
+        if (mb->state == CAUCHY_MEMBER_SUSPECT &&
+            now_ms >= mb->since_ms + m->cfg.suspect_timeout_ms) {
+            set_state(m, mb, CAUCHY_MEMBER_DEAD, mb->incarnation, now_ms);
+        } else if (!is_live(mb->state) && now_ms >= mb->since_ms + m->cfg.dead_retention_ms) {
+            cauchy_vclock_set(&m->departed, mb->node, 0);
+            remove_member(m, i);
+            continue;
+        }
+        i++;
+    }
+
+    if (m->probing || now_ms < m->next_probe) return;
+
+    /* A new protocol period */
+    publish_frontier(m);
+    m->next_probe = now_ms + m->cfg.probe_interval_ms;
+    member_t* mb = next_target(m);
+    if (!mb) return;
+    m->probing = true;
+    m->acked = false;
+    m->indirect_sent = false;
+    m->probe_target = mb->node;
+    m->probe_seq = ++m->seq;
+    m->probe_started = now_ms;
+    m->stats.probes++;
+    send_message(m, mb->node, SWIM_PING, m->probe_seq, m->ctx->node_id, mb->node);
+}
+
+cauchy_result_t cauchy_membership_track_clock(cauchy_membership_t* m, cauchy_vclock_t* clock) {
+    if (!m || !clock) return CAUCHY_ERR_INVALID;
+    for (usize i = 0; i < m->tracked_count; i++) {
+        if (m->tracked[i] == clock) return CAUCHY_ERR_EXISTS;
+    }
+    if (m->tracked_count == m->tracked_capacity) {
+        usize cap = m->tracked_capacity ? m->tracked_capacity * 2 : 4;
+        cauchy_vclock_t** grown = realloc(m->tracked, cap * sizeof(cauchy_vclock_t*));
+        if (!grown) return CAUCHY_ERR_NOMEM;
+        m->tracked = grown;
+        m->tracked_capacity = cap;
+    }
+    m->tracked[m->tracked_count++] = clock;
+    return CAUCHY_OK;
+}
+
+void cauchy_membership_untrack_clock(cauchy_membership_t* m, cauchy_vclock_t* clock) {
+    if (!m) return;
+    for (usize i = 0; i < m->tracked_count; i++) {
+        if (m->tracked[i] == clock) {
+            m->tracked[i] = m->tracked[--m->tracked_count];
+            return;
+        }
+    }
+}
+
+cauchy_member_state_t cauchy_membership_state(const cauchy_membership_t* m, cauchy_node_id_t node) {
+    if (!m) return CAUCHY_MEMBER_UNKNOWN;
+    if (node == m->ctx->node_id) return m->left ? CAUCHY_MEMBER_LEFT : CAUCHY_MEMBER_ALIVE;
+    const member_t* mb = find_member(m, node);
+    return mb ? (cauchy_member_state_t)mb->state : CAUCHY_MEMBER_UNKNOWN;
+}
+
+usize cauchy_membership_alive_count(const cauchy_membership_t* m) {
+    if (!m) return 0;
+    usize n = 0;
+    for (usize i = 0; i < m->member_count; i++) {
+        if (m->members[i].state == CAUCHY_MEMBER_ALIVE) n++;
+    }
+    return n;
+}
+
+const cauchy_vclock_t* cauchy_membership_frontier(const cauchy_membership_t* m) {
+    return m ? &m->frontier : NULL;
+}
+
+void cauchy_membership_get_stats(const cauchy_membership_t* m, cauchy_membership_stats_t* out) {
+    if (!m || !out) return;
+    *out = m->stats;
+}
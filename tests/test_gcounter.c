@@ -4,9 +4,11 @@
 
 #include "cauchy/cauchy.h"
 #include "cauchy/crdt/g_counter.h"
+#include "cauchy/crdt/pn_counter.h"
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
+#include <pthread.h>
 
 #define TEST(name) static void test_##name(void)
 #define RUN(name) do { printf("  %-40s", #name); test_##name(); printf("✓\n"); } while(0)
@@ -109,6 +111,81 @@ TEST(gcounter_serialization) {
     assert(cauchy_gcounter_equals(&gc, &restored));
 }
 
+TEST(counter_delta_groups) {
+    cauchy_gcounter_t a, b, group;
+    cauchy_gcounter_init(&a, 3);
+    cauchy_gcounter_init(&b, 3);
+    cauchy_gcounter_init(&group, 3);
+
+    for (int i = 0; i < 50; i++) cauchy_gcounter_add(&a, (cauchy_node_id_t)i, 10);
+    cauchy_gcounter_merge(&b, &a);
+
+    assert(cauchy_gcounter_increment_delta(&a, 7, &group) == CAUCHY_OK);
+    assert(cauchy_gcounter_add_delta(&a, 7, 5, &group) == CAUCHY_OK);
+    assert(cauchy_gcounter_add_delta(&a, 100, 2, &group) == CAUCHY_OK);
+    assert(cauchy_gcounter_get(&group, 7) == 16);
+    assert(cauchy_gcounter_value(&group) == 18);
+
+    assert(cauchy_gcounter_merge_delta(&b, &group) == CAUCHY_OK);
+    assert(cauchy_gcounter_merge_delta(&b, &group) == CAUCHY_OK);
+    assert(cauchy_gcounter_equals(&a, &b));
+    assert(cauchy_gcounter_value(&b) == 508);
+
+    cauchy_pncounter_t p, q, d;
+    cauchy_pncounter_init(&p, 3);
+    cauchy_pncounter_init(&q, 3);
+    cauchy_pncounter_init(&d, 3);
+    assert(cauchy_pncounter_add_delta(&p, 1, 10, &d) == CAUCHY_OK);
+    assert(cauchy_pncounter_add_delta(&p, 2, -4, &d) == CAUCHY_OK);
+    assert(cauchy_pncounter_decrement_delta(&p, 2, &d) == CAUCHY_OK);
+    assert(cauchy_pncounter_merge_delta(&q, &d) == CAUCHY_OK);
+    assert(cauchy_pncounter_value(&q) == 5);
+    assert(cauchy_pncounter_equals(&p, &q));
+
+    /* Full-state merge and copy of counters that spill to the heap */
+    for (cauchy_node_id_t node = 0; node < 64; node++) {
+        assert(cauchy_pncounter_add(&p, node * 1000, node & 1 ? -1 : 2) == CAUCHY_OK);
+    }
+    cauchy_pncounter_t r;
+    cauchy_pncounter_init(&r, 3);
+    assert(cauchy_pncounter_merge(&r, &p) == CAUCHY_OK);
+    assert(cauchy_pncounter_equals(&r, &p));
+    cauchy_pncounter_fini(&r);
+    assert(cauchy_pncounter_copy(&r, &q) == CAUCHY_OK);
+    assert(cauchy_pncounter_equals(&r, &q));
+    cauchy_pncounter_fini(&r);
+
+    cauchy_gcounter_fini(&a);
+    cauchy_gcounter_fini(&b);
+    cauchy_gcounter_fini(&group);
+    cauchy_pncounter_fini(&p);
+    cauchy_pncounter_fini(&q);
+    cauchy_pncounter_fini(&d);
+}
+
+TEST(pncounter_delta_encoding) {
+    u8 buf[1024];
+    cauchy_pncounter_t pn, pn_base, pn_out;
+    cauchy_pncounter_init(&pn, 4);
+    cauchy_pncounter_init(&pn_base, 4);
+    assert(cauchy_pncounter_add(&pn, 1, 500) == CAUCHY_OK);
+    assert(cauchy_pncounter_add(&pn, 2, -20) == CAUCHY_OK);
+    cauchy_pncounter_fini(&pn_base);
+    assert(cauchy_pncounter_copy(&pn_base, &pn) == CAUCHY_OK);
+    assert(cauchy_pncounter_add(&pn, 3, -1) == CAUCHY_OK);
+    usize n = cauchy_pncounter_encode(&pn, &pn_base, buf, sizeof(buf));
+    assert(n == cauchy_pncounter_encoded_size(&pn, &pn_base));
+    usize used = 0;
+    assert(cauchy_pncounter_decode(&pn_out, &pn_base, buf, n, &used) == CAUCHY_OK);
+    assert(used == n);
+    assert(cauchy_pncounter_value(&pn_out) == 479);
+    assert(cauchy_pncounter_equals(&pn_out, &pn));
+
+    cauchy_pncounter_fini(&pn);
+    cauchy_pncounter_fini(&pn_base);
+    cauchy_pncounter_fini(&pn_out);
+}
+
 TEST(gcounter_convergence) {
     cauchy_gcounter_t node0, node1, node2;
     cauchy_gcounter_init(&node0, 3);
@@ -130,6 +207,84 @@ TEST(gcounter_convergence) {
     assert(cauchy_gcounter_value(&node0) == 225);
 }
 
+#define STRIPED_THREADS 4
+#define STRIPED_EVENTS  100000
+
+typedef struct {
+    cauchy_gcounter_striped_t*  gc;
+    cauchy_pncounter_striped_t* pn;
+    cauchy_atomic_u32_t*        done;
+} striped_worker_t;
+
+static void* striped_worker(void* arg) {
+    striped_worker_t* w = arg;
+    for (int i = 0; i < STRIPED_EVENTS; i++) {
+        cauchy_gcounter_striped_increment(w->gc);
+        cauchy_pncounter_striped_add(w->pn, (i & 3) == 0 ? -1 : 2);
+    }
+    cauchy_atomic_fetch_add_u32(w->done, 1);
+    return NULL;
+}
+
+TEST(striped_counters_concurrent) {
+    cauchy_gcounter_striped_t* gc = cauchy_gcounter_striped_create(4, 1, 0);
+    cauchy_pncounter_striped_t* pn = cauchy_pncounter_striped_create(4, 1, 3);
+    assert(gc && pn && pn->local.mask == 3);
+
+    /* Another replica's counts merge alongside the local stripes */
+    cauchy_gcounter_t remote;
+    cauchy_gcounter_init(&remote, 4);
+    cauchy_gcounter_add(&remote, 2, 500);
+    assert(cauchy_gcounter_striped_merge(gc, &remote) == CAUCHY_OK);
+
+    cauchy_atomic_u32_t done;
+    atomic_init(&done, 0);
+    pthread_t threads[STRIPED_THREADS];
+    striped_worker_t w = { gc, pn, &done };
+    for (int i = 0; i < STRIPED_THREADS; i++) pthread_create(&threads[i], NULL, striped_worker, &w);
+
+    /* The owner folds while the workers count; values only grow, and each
+     * fold's delta carries the local node's new count */
+    cauchy_gcounter_t delta;
+    cauchy_gcounter_init(&delta, 4);
+    u64 last = 0;
+    while (cauchy_atomic_load_u32(&done) < STRIPED_THREADS) {
+        assert(cauchy_gcounter_striped_fold(gc, &delta) == CAUCHY_OK);
+        u64 v = cauchy_gcounter_value(&gc->counter);
+        assert(v >= last);
+        last = v;
+        assert(cauchy_gcounter_get(&delta, 1) == cauchy_gcounter_get(&gc->counter, 1));
+    }
+    for (int i = 0; i < STRIPED_THREADS; i++) pthread_join(threads[i], NULL);
+
+    u64 total = (u64)STRIPED_THREADS * STRIPED_EVENTS;
+    assert(cauchy_gcounter_striped_value(gc) == total + 500);
+    assert(cauchy_gcounter_get(&gc->counter, 1) == total);
+    assert(cauchy_gcounter_striped_value(gc) == total + 500);
+
+    /* Per thread: a quarter of the events subtract 1, the rest add 2 */
+    i64 expect = STRIPED_THREADS * (i64)(STRIPED_EVENTS / 4 * 3 * 2 - STRIPED_EVENTS / 4);
+    assert(cauchy_pncounter_striped_value(pn) == expect);
+
+    /* The folded state is an ordinary counter on the wire */
+    u8 buf[256];
+    usize n = cauchy_pncounter_serialize(&pn->counter, buf, sizeof(buf));
+    assert(n > 0);
+    cauchy_pncounter_t copy;
+    cauchy_pncounter_init(&copy, 4);
+    assert(cauchy_pncounter_deserialize(&copy, buf, n) == CAUCHY_OK);
+    assert(cauchy_pncounter_value(&copy) == expect);
+    /* A truncated negative half leaves the target untouched */
+    assert(cauchy_pncounter_deserialize(&copy, buf, n - 1) == CAUCHY_ERR_INVALID);
+    assert(cauchy_pncounter_value(&copy) == expect);
+
+    cauchy_pncounter_fini(&copy);
+    cauchy_gcounter_fini(&delta);
+    cauchy_gcounter_fini(&remote);
+    cauchy_gcounter_striped_destroy(gc);
+    cauchy_pncounter_striped_destroy(pn);
+}
+
 int main(void) {
     printf("G-Counter Tests:\n");
     
@@ -139,7 +294,10 @@ int main(void) {
     RUN(gcounter_merge_associative);
     RUN(gcounter_merge_idempotent);
     RUN(gcounter_serialization);
+    RUN(counter_delta_groups);
+    RUN(pncounter_delta_encoding);
     RUN(gcounter_convergence);
+    RUN(striped_counters_concurrent);
     
     printf("\nAll G-Counter tests passed!\n");
     return 0;
@@ -0,0 +1,338 @@
+/*
+ * CAUCHY - Map CRDT Tests
+ */
+
+#include "cauchy/cauchy.h"
+#include "cauchy/crdt/lww_map.h"
+#include "cauchy/crdt/store.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { printf("  %-40s", #name); test_##name(); printf("✓\n"); } while(0)
+
+static bool get_string(const cauchy_lww_map_t* map, const char* key, const char* expect) {
+    cauchy_lww_register_t reg;
+    cauchy_lww_init(&reg);
+    bool ok = cauchy_lww_map_get(map, key, strlen(key), &reg) == CAUCHY_OK &&
+              reg.value_size == strlen(expect) &&
+              memcmp(cauchy_lww_get(&reg, NULL), expect, reg.value_size) == 0;
+    cauchy_lww_fini(&reg);
+    return ok;
+}
+
+TEST(lwwmap_last_write_wins) {
+    cauchy_lww_map_t* a = cauchy_lww_map_create(0, NULL);
+    cauchy_lww_map_t* b = cauchy_lww_map_create(0, NULL);
+    cauchy_lww_map_t* delta = cauchy_lww_map_create(0, NULL);
+    assert(a && b && delta);
+
+    assert(cauchy_lww_map_set_string(a, "mode", "fast", 10, 1) == CAUCHY_OK);
+    assert(cauchy_lww_map_set_string(a, "mode", "slow", 5, 1) == CAUCHY_OK);
+    assert(get_string(a, "mode", "fast"));
+
+    /* Equal timestamps: the higher node id wins on every replica */
+    assert(cauchy_lww_map_set_string(b, "mode", "safe", 10, 2) == CAUCHY_OK);
+    assert(cauchy_lww_map_set_string(b, "owner", "bob", 3, 2) == CAUCHY_OK);
+
+    /* A remove is a write: it beats the older set, including one that
+     * only arrives at a replica afterwards */
+    assert(cauchy_lww_map_remove_delta(a, "owner", 5, 4, 1, delta) == CAUCHY_OK);
+    assert(cauchy_lww_map_count(a) == 1);
+    assert(cauchy_lww_map_count(delta) == 0);
+    assert(cauchy_lww_map_merge_delta(b, delta) == CAUCHY_OK);
+    assert(!cauchy_lww_map_contains_string(b, "owner"));
+
+    assert(cauchy_lww_map_merge(a, b) == CAUCHY_OK);
+    assert(cauchy_lww_map_merge(b, a) == CAUCHY_OK);
+    assert(cauchy_lww_map_equals(a, b));
+    assert(get_string(a, "mode", "safe"));
+    assert(!cauchy_lww_map_contains_string(a, "owner"));
+
+    /* Re-adding after the remove takes a newer timestamp */
+    assert(cauchy_lww_map_set_string(a, "owner", "eve", 6, 1) == CAUCHY_OK);
+    assert(!cauchy_lww_map_equals(a, b));
+    assert(cauchy_lww_map_merge(b, a) == CAUCHY_OK);
+    assert(get_string(b, "owner", "eve"));
+    assert(cauchy_lww_map_count(b) == 2);
+
+    usize seen = 0;
+    const void* key;
+    usize key_size;
+    cauchy_lww_register_t reg;
+    cauchy_lww_init(&reg);
+    cauchy_lww_map_iter_t it;
+    cauchy_lww_map_iter_init(&it, b);
+    while (cauchy_lww_map_iter_next(&it, &key, &key_size, &reg)) seen++;
+    assert(seen == 2);
+
+    /* Large values travel by reference through merges and reads */
+    static u8 big[4096];
+    memset(big, 0xAB, sizeof(big));
+    assert(cauchy_lww_map_set(a, "blob", 4, big, sizeof(big), 7, 1) == CAUCHY_OK);
+    assert(cauchy_lww_map_merge(b, a) == CAUCHY_OK);
+    assert(cauchy_lww_map_get(b, "blob", 4, &reg) == CAUCHY_OK);
+    usize size;
+    const u8* got = cauchy_lww_get(&reg, &size);
+    assert(size == sizeof(big) && memcmp(got, big, size) == 0);
+    assert(cauchy_lww_map_remove(a, "blob", 4, 8, 1) == CAUCHY_OK);
+    assert(cauchy_lww_map_merge(b, a) == CAUCHY_OK);
+    assert(!cauchy_lww_map_contains(b, "blob", 4));
+    assert(memcmp(cauchy_lww_get(&reg, NULL), big, size) == 0);
+    cauchy_lww_fini(&reg);
+
+    cauchy_lww_map_destroy(a);
+    cauchy_lww_map_destroy(b);
+    cauchy_lww_map_destroy(delta);
+}
+
+#define MAP_WRITERS 4
+#define MAP_READERS 4
+#define MAP_KEYS    20000
+#define MAP_ROUNDS  4
+
+typedef struct {
+    cauchy_lww_map_t*   map;
+    u32                 id;
+    cauchy_atomic_u32_t* done;
+} map_worker_t;
+
+/* Every writer writes every key with timestamp round * writers + id; the
+ * value is the timestamp, so readers can check what they see */
+static void* map_writer(void* arg) {
+    map_worker_t* w = arg;
+    for (u64 round = 0; round < MAP_ROUNDS; round++) {
+        for (u64 k = 0; k < MAP_KEYS; k++) {
+            u64 ts = round * MAP_WRITERS + w->id + 1;
+            assert(cauchy_lww_map_set(w->map, &k, sizeof(k), &ts, sizeof(ts),
+                                      ts, w->id) == CAUCHY_OK);
+        }
+    }
+    cauchy_atomic_fetch_add_u32(w->done, 1);
+    return NULL;
+}
+
+static void* map_reader(void* arg) {
+    map_worker_t* w = arg;
+    cauchy_lww_register_t reg;
+    cauchy_lww_init(&reg);
+    while (cauchy_atomic_load_u32(w->done) < MAP_WRITERS) {
+        for (u64 k = w->id; k < MAP_KEYS; k += 97) {
+            if (cauchy_lww_map_get(w->map, &k, sizeof(k), &reg) != CAUCHY_OK) continue;
+            u64 ts;
+            assert(reg.value_size == sizeof(ts));
+            memcpy(&ts, cauchy_lww_get(&reg, NULL), sizeof(ts));
+            assert(ts == reg.timestamp);
+        }
+    }
+    cauchy_lww_fini(&reg);
+    return NULL;
+}
+
+TEST(lwwmap_concurrent_readers_writers) {
+    cauchy_lww_map_t* map = cauchy_lww_map_create(16, NULL);
+    assert(map);
+
+    cauchy_atomic_u32_t done;
+    atomic_init(&done, 0);
+    pthread_t threads[MAP_WRITERS + MAP_READERS];
+    map_worker_t workers[MAP_WRITERS + MAP_READERS];
+    for (u32 i = 0; i < MAP_WRITERS + MAP_READERS; i++) {
+        workers[i] = (map_worker_t){ map, i < MAP_WRITERS ? i : i - MAP_WRITERS, &done };
+        pthread_create(&threads[i], NULL, i < MAP_WRITERS ? map_writer : map_reader,
+                       &workers[i]);
+    }
+    for (u32 i = 0; i < MAP_WRITERS + MAP_READERS; i++) pthread_join(threads[i], NULL);
+
+    /* Keys were inserted concurrently and the table grew underneath */
+    assert(cauchy_lww_map_count(map) == MAP_KEYS);
+    assert(cauchy_atomic_load_u64(&map->bucket_count) >= MAP_KEYS / CAUCHY_LWW_MAP_LOAD_FACTOR);
+
+    cauchy_lww_register_t reg;
+    cauchy_lww_init(&reg);
+    for (u64 k = 0; k < MAP_KEYS; k++) {
+        assert(cauchy_lww_map_get(map, &k, sizeof(k), &reg) == CAUCHY_OK);
+        assert(reg.timestamp == (u64)MAP_ROUNDS * MAP_WRITERS);
+        assert(reg.node_id == MAP_WRITERS - 1);
+    }
+    cauchy_lww_fini(&reg);
+
+    cauchy_lww_map_destroy(map);
+}
+
+#define STORE_PRODUCERS 4
+#define STORE_OPS       19200
+#define STORE_NAMES     64
+
+typedef struct store_worker {
+    cauchy_store_t*      store;
+    u32                  id;
+    cauchy_atomic_u32_t* done;
+} store_worker_t;
+
+static void* store_producer(void* arg) {
+    store_worker_t* w = arg;
+    for (u32 i = 0; i < STORE_OPS; i++) {
+        char name[16];
+        int len = snprintf(name, sizeof(name), "hits/%u", i % STORE_NAMES);
+        while (cauchy_store_add(w->store, name, (usize)len, CAUCHY_CRDT_G_COUNTER, 1) ==
+               CAUCHY_ERR_FULL) {
+            CAUCHY_CPU_PAUSE();
+        }
+    }
+    cauchy_atomic_fetch_add_u32(w->done, 1);
+    return NULL;
+}
+
+/* Polls every shard until the producers stop; two of them contend */
+static void* store_poller(void* arg) {
+    store_worker_t* w = arg;
+    while (cauchy_atomic_load_u32(w->done) < STORE_PRODUCERS) {
+        for (u32 s = 0; s < cauchy_store_shard_count(w->store); s++) {
+            cauchy_store_poll(w->store, s, 64);
+        }
+    }
+    return NULL;
+}
+
+static void read_object(void* arg, const cauchy_store_object_t* obj) {
+    *(const cauchy_store_object_t**)arg = obj;
+}
+
+static void sum_object(void* arg, const cauchy_store_object_t* obj) {
+    u64* sum = arg;
+    if (obj->type == CAUCHY_CRDT_G_COUNTER) *sum += cauchy_gcounter_value(&obj->as.gcounter);
+}
+
+static void count_object(void* arg, const cauchy_store_object_t* obj) {
+    (void)obj;
+    (*(usize*)arg)++;
+}
+
+typedef struct store_copy {
+    cauchy_store_t* into;
+    u32             merged;
+} store_copy_t;
+
+static void copy_object(void* arg, const cauchy_store_object_t* obj) {
+    store_copy_t* copy = arg;
+    assert(cauchy_store_merge(copy->into, obj) == CAUCHY_OK);
+    copy->merged++;
+}
+
+TEST(store_sharded_ops) {
+    cauchy_context_t* ctx = cauchy_context_create(3);
+    cauchy_store_config_t cfg = CAUCHY_STORE_CONFIG_DEFAULT;
+    cfg.shards = 4;
+    cfg.queue_capacity = 256;
+    cauchy_store_t* store = cauchy_store_create(ctx, &cfg);
+    assert(store && cauchy_store_shard_count(store) == 4);
+
+    cauchy_atomic_u32_t done;
+    atomic_init(&done, 0);
+    pthread_t threads[STORE_PRODUCERS + 2];
+    store_worker_t workers[STORE_PRODUCERS + 2];
+    for (u32 i = 0; i < STORE_PRODUCERS + 2; i++) {
+        workers[i] = (store_worker_t){ store, i, &done };
+        pthread_create(&threads[i], NULL, i < STORE_PRODUCERS ? store_producer : store_poller,
+                       &workers[i]);
+    }
+    for (u32 i = 0; i < STORE_PRODUCERS + 2; i++) pthread_join(threads[i], NULL);
+    cauchy_store_flush(store);
+
+    cauchy_store_stats_t stats = cauchy_store_get_stats(store);
+    assert(stats.submitted == (u64)STORE_PRODUCERS * STORE_OPS);
+    assert(stats.applied == stats.submitted && stats.rejected == 0);
+    assert(stats.objects == STORE_NAMES);
+
+    const cauchy_store_object_t* obj = NULL;
+    assert(cauchy_store_get(store, "hits/5", 6, read_object, &obj) == CAUCHY_OK);
+    assert(obj->type == CAUCHY_CRDT_G_COUNTER);
+    assert(cauchy_gcounter_value(&obj->as.gcounter) == STORE_PRODUCERS * STORE_OPS / STORE_NAMES);
+    assert(cauchy_store_get(store, "missing", 7, read_object, &obj) == CAUCHY_ERR_NOTFOUND);
+
+    /* A name keeps its first type */
+    assert(cauchy_store_set(store, "hits/5", 6, "x", 1, 10) == CAUCHY_OK);
+    assert(cauchy_store_add(store, "hits/5", 6, CAUCHY_CRDT_G_COUNTER, -1) == CAUCHY_ERR_INVALID);
+    assert(cauchy_store_flush(store) == 1);
+    assert(cauchy_store_get_stats(store).rejected == 1);
+
+    /* A full queue refuses until polled; long ops spill out of the cell */
+    char big[CAUCHY_STORE_CELL_INLINE * 2];
+    memset(big, 'v', sizeof(big));
+    u32 shard = cauchy_store_shard_of(store, "reg", 3);
+    cauchy_result_t res;
+    u32 queued = 0;
+    u64 full = cauchy_store_get_stats(store).full;
+    while ((res = cauchy_store_set(store, "reg", 3, big, sizeof(big), ++queued)) == CAUCHY_OK) {}
+    assert(res == CAUCHY_ERR_FULL && queued - 1 == 256);
+    assert(cauchy_store_get_stats(store).full == full + 1);
+    assert(cauchy_store_poll(store, shard, 100) == 100);
+    assert(cauchy_store_poll(store, shard, 0) == 156);
+    assert(cauchy_store_get(store, "reg", 3, read_object, &obj) == CAUCHY_OK);
+    usize size;
+    assert(obj->as.lww.timestamp == 256 && obj->as.lww.node_id == 3);
+    assert(memcmp(cauchy_lww_get(&obj->as.lww, &size), big, sizeof(big)) == 0);
+    assert(size == sizeof(big));
+
+    /* Only what changed after a clock is visited */
+    cauchy_vclock_t clock;
+    assert(cauchy_store_clock(store, &clock) == CAUCHY_OK);
+    usize changed = 0;
+    cauchy_store_visit(store, &clock, count_object, &changed);
+    assert(changed == 0);
+    assert(cauchy_store_add(store, "hits/7", 6, CAUCHY_CRDT_G_COUNTER, 5) == CAUCHY_OK);
+    assert(cauchy_store_add(store, "pn", 2, CAUCHY_CRDT_PN_COUNTER, -4) == CAUCHY_OK);
+    cauchy_store_flush(store);
+    cauchy_store_visit(store, &clock, count_object, &changed);
+    assert(changed == 2);
+    cauchy_vclock_fini(&clock);
+
+    /* Gossip everything to a peer store with another shard count */
+    cauchy_context_t* peer_ctx = cauchy_context_create(4);
+    cauchy_store_t* peer = cauchy_store_create(peer_ctx, NULL);
+    assert(peer);
+    assert(cauchy_store_add(peer, "hits/5", 6, CAUCHY_CRDT_G_COUNTER, 2) == CAUCHY_OK);
+    cauchy_store_flush(peer);
+    store_copy_t copy = { peer, 0 };
+    cauchy_store_visit(store, NULL, copy_object, &copy);
+    assert(copy.merged == STORE_NAMES + 2);
+    assert(cauchy_store_get_stats(peer).objects == STORE_NAMES + 2);
+
+    u64 sum = 0;
+    cauchy_store_visit(peer, NULL, sum_object, &sum);
+    assert(sum == (u64)STORE_PRODUCERS * STORE_OPS + 5 + 2);
+    assert(cauchy_store_get(peer, "pn", 2, read_object, &obj) == CAUCHY_OK);
+    assert(cauchy_pncounter_value(&obj->as.pncounter) == -4);
+    assert(cauchy_store_get(peer, "reg", 3, read_object, &obj) == CAUCHY_OK);
+    assert(obj->as.lww.timestamp == 256 && obj->as.lww.value_size == sizeof(big));
+
+    cauchy_store_object_t wrong = *obj;
+    wrong.type = CAUCHY_CRDT_G_COUNTER;
+    assert(cauchy_store_merge(peer, &wrong) == CAUCHY_ERR_INVALID);
+
+    /* The most negative delta is a full-range decrement */
+    assert(cauchy_store_add(store, "low", 3, CAUCHY_CRDT_PN_COUNTER, INT64_MIN) == CAUCHY_OK);
+    cauchy_store_flush(store);
+    assert(cauchy_store_get(store, "low", 3, read_object, &obj) == CAUCHY_OK);
+    assert(cauchy_pncounter_negative(&obj->as.pncounter) == (u64)1 << 63);
+    assert(cauchy_pncounter_value(&obj->as.pncounter) == INT64_MIN);
+
+    cauchy_store_destroy(peer);
+    cauchy_store_destroy(store);
+    cauchy_context_destroy(peer_ctx);
+    cauchy_context_destroy(ctx);
+}
+
+int main(void) {
+    printf("Map CRDT Tests:\n");
+
+    RUN(lwwmap_last_write_wins);
+    RUN(lwwmap_concurrent_readers_writers);
+    RUN(store_sharded_ops);
+
+    printf("\nAll map tests passed!\n");
+    return 0;
+}
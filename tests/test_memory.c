@@ -0,0 +1,822 @@
+/*
+ * CAUCHY - Memory Pool and Reclamation Tests
+ */
+
+#include "cauchy/cauchy.h"
+#include "cauchy/numa.h"
+#include "cauchy/crdt/g_counter.h"
+#include "cauchy/crdt/pn_counter.h"
+#include "cauchy/crdt/lww_register.h"
+#include "cauchy/crdt/lww_map.h"
+#include "cauchy/crdt/rga.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { printf("  %-40s", #name); test_##name(); printf("✓\n"); } while(0)
+
+#define STRESS_THREADS 8
+#define STRESS_ROUNDS  2000
+#define STRESS_BATCH   64
+
+TEST(pool_alloc_free) {
+    cauchy_pool_config_t cfg = CAUCHY_POOL_CONFIG_DEFAULT;
+    cfg.block_size = 48;
+    cfg.initial_blocks = 16;
+    cauchy_pool_t* pool = cauchy_pool_create(&cfg);
+    assert(pool);
+
+    void* blocks[100];
+    for (int i = 0; i < 100; i++) {
+        blocks[i] = cauchy_pool_alloc(pool);
+        assert(blocks[i]);
+        memset(blocks[i], i, 48);
+    }
+    for (int i = 0; i < 100; i++) {
+        for (int j = i + 1; j < 100; j++) assert(blocks[i] != blocks[j]);
+    }
+
+    cauchy_pool_stats_t stats = cauchy_pool_get_stats(pool);
+    assert(stats.total_allocs == 100);
+    assert(stats.in_use == 100);
+    assert(stats.allocated >= 100);
+
+    for (int i = 0; i < 100; i++) cauchy_pool_free(pool, blocks[i]);
+    stats = cauchy_pool_get_stats(pool);
+    assert(stats.freed == 100);
+    assert(stats.in_use == 0);
+    assert(stats.peak_use >= 64 && stats.peak_use <= 100);
+
+    cauchy_pool_destroy(pool);
+}
+
+TEST(pool_max_blocks) {
+    cauchy_pool_config_t cfg = CAUCHY_POOL_CONFIG_DEFAULT;
+    cfg.initial_blocks = 0;
+    cfg.max_blocks = 10;
+    cauchy_pool_t* pool = cauchy_pool_create(&cfg);
+    assert(pool);
+
+    void* blocks[10];
+    for (int i = 0; i < 10; i++) {
+        blocks[i] = cauchy_pool_alloc(pool);
+        assert(blocks[i]);
+    }
+    assert(cauchy_pool_alloc(pool) == NULL);
+
+    cauchy_pool_free(pool, blocks[3]);
+    assert(cauchy_pool_alloc(pool) == blocks[3]);
+
+    cauchy_pool_destroy(pool);
+}
+
+typedef struct {
+    cauchy_pool_t* pool;
+    u32            tid;
+    int            allocated;
+} pool_exit_arg_t;
+
+/* Allocate until the pool is exhausted, then free everything */
+static void* pool_exit_worker(void* arg) {
+    pool_exit_arg_t* a = arg;
+    void* blocks[64];
+    a->tid = cauchy_thread_id();
+    a->allocated = 0;
+    while (a->allocated < 64 && (blocks[a->allocated] = cauchy_pool_alloc(a->pool)) != NULL) {
+        a->allocated++;
+    }
+    for (int i = 0; i < a->allocated; i++) cauchy_pool_free(a->pool, blocks[i]);
+    return NULL;
+}
+
+TEST(pool_thread_exit) {
+    /* Blocks an exited thread left in its magazines stay reachable, both
+     * to the next thread on its id and to every other thread */
+    cauchy_pool_config_t cfg = CAUCHY_POOL_CONFIG_DEFAULT;
+    cfg.initial_blocks = 0;
+    cfg.max_blocks = 64;
+    cfg.magazine_size = 16;
+    cfg.slab_blocks = 64;
+    cauchy_pool_t* pool = cauchy_pool_create(&cfg);
+    assert(pool);
+
+    pool_exit_arg_t first = { .pool = pool }, second = { .pool = pool };
+    pthread_t thread;
+    pthread_create(&thread, NULL, pool_exit_worker, &first);
+    pthread_join(thread, NULL);
+    pthread_create(&thread, NULL, pool_exit_worker, &second);
+    pthread_join(thread, NULL);
+    assert(first.allocated == 64);
+    assert(second.tid == first.tid);
+    assert(second.allocated == 64);
+
+    pool_exit_arg_t self = { .pool = pool };
+    pool_exit_worker(&self);
+    assert(self.tid != first.tid);
+    assert(self.allocated == 64);
+    assert(cauchy_pool_get_stats(pool).in_use == 0);
+
+    cauchy_pool_destroy(pool);
+}
+
+static void* pool_stress_worker(void* arg) {
+    cauchy_pool_t* pool = arg;
+    void* batch[STRESS_BATCH];
+    u64 tag = (u64)cauchy_thread_id();
+
+    for (int r = 0; r < STRESS_ROUNDS; r++) {
+        for (int i = 0; i < STRESS_BATCH; i++) {
+            batch[i] = cauchy_pool_alloc(pool);
+            assert(batch[i]);
+            *(u64*)batch[i] = tag;
+        }
+        for (int i = 0; i < STRESS_BATCH; i++) {
+            assert(*(u64*)batch[i] == tag);
+            cauchy_pool_free(pool, batch[i]);
+        }
+    }
+    return NULL;
+}
+
+TEST(pool_concurrent) {
+    cauchy_pool_config_t cfg = CAUCHY_POOL_CONFIG_DEFAULT;
+    cfg.initial_blocks = 0;
+    cauchy_pool_t* pool = cauchy_pool_create(&cfg);
+    assert(pool);
+
+    pthread_t threads[STRESS_THREADS];
+    for (int i = 0; i < STRESS_THREADS; i++) {
+        pthread_create(&threads[i], NULL, pool_stress_worker, pool);
+    }
+    for (int i = 0; i < STRESS_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    cauchy_pool_stats_t stats = cauchy_pool_get_stats(pool);
+    assert(stats.total_allocs == (u64)STRESS_THREADS * STRESS_ROUNDS * STRESS_BATCH);
+    assert(stats.freed == stats.total_allocs);
+    assert(stats.in_use == 0);
+
+    cauchy_pool_destroy(pool);
+}
+
+TEST(pool_depot_aba) {
+    /* Single-block magazines push every free through the shared depot,
+     * and a tiny max_blocks forces the same addresses to recycle. */
+    cauchy_pool_config_t cfg = CAUCHY_POOL_CONFIG_DEFAULT;
+    cfg.initial_blocks = 0;
+    cfg.max_blocks = STRESS_THREADS * STRESS_BATCH * 3;
+    cfg.magazine_size = 1;
+    cfg.slab_blocks = 1;
+    cauchy_pool_t* pool = cauchy_pool_create(&cfg);
+    assert(pool);
+
+    pthread_t threads[STRESS_THREADS];
+    for (int i = 0; i < STRESS_THREADS; i++) {
+        pthread_create(&threads[i], NULL, pool_stress_worker, pool);
+    }
+    for (int i = 0; i < STRESS_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    cauchy_pool_stats_t stats = cauchy_pool_get_stats(pool);
+    assert(stats.in_use == 0);
+    assert(stats.allocated <= cfg.max_blocks);
+
+    cauchy_pool_destroy(pool);
+}
+
+static void* numa_bind_worker(void* arg) {
+    u32 node = *(u32*)arg;
+    /* A memory-only node has no CPUs to run on */
+    cauchy_result_t res = cauchy_numa_bind_thread(node);
+    assert(res == CAUCHY_OK || res == CAUCHY_ERR_INVALID);
+    if (res == CAUCHY_OK) assert(cauchy_numa_current_node() == node);
+    return NULL;
+}
+
+TEST(pool_numa_placement) {
+    u32 nodes = cauchy_numa_node_count();
+    u32 local = cauchy_numa_current_node();
+    assert(nodes >= 1 && local < nodes);
+    assert(cauchy_numa_bind_thread(nodes) == CAUCHY_ERR_INVALID);
+    pthread_t thread;
+    u32 last = nodes - 1;
+    pthread_create(&thread, NULL, numa_bind_worker, &last);
+    pthread_join(thread, NULL);
+
+    /* Bound huge mappings are rounded to whole huge pages and zeroed */
+    usize size = CAUCHY_HUGE_PAGE_SIZE + 4096;
+    assert(cauchy_numa_map_size(size, CAUCHY_NUMA_HUGE) == 2 * (usize)CAUCHY_HUGE_PAGE_SIZE);
+    assert(cauchy_numa_map_size(size, 0) == size);
+    u8* map = cauchy_numa_map(size, 0, CAUCHY_NUMA_HUGE);
+    assert(map && ((uintptr_t)map & 4095) == 0);
+    assert(map[0] == 0 && map[size - 1] == 0);
+    map[0] = 1;
+    i32 node = cauchy_numa_node_of(map);
+    assert(node == -1 || (node >= 0 && (u32)node < nodes));
+    cauchy_numa_unmap(map, size, CAUCHY_NUMA_HUGE);
+
+    cauchy_pool_numa_t modes[] = {
+        CAUCHY_POOL_NUMA_LOCAL, CAUCHY_POOL_NUMA_BIND, CAUCHY_POOL_NUMA_NODE, CAUCHY_POOL_NUMA_OFF
+    };
+    for (usize m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        cauchy_pool_config_t cfg = CAUCHY_POOL_CONFIG_DEFAULT;
+        cfg.numa = modes[m];
+        cfg.numa_node = last;
+        cfg.initial_blocks = 100;
+        cauchy_pool_t* pool = cauchy_pool_create(&cfg);
+        assert(pool);
+        void* blocks[300];
+        for (int i = 0; i < 300; i++) {
+            blocks[i] = cauchy_pool_alloc(pool);
+            assert(blocks[i] && ((uintptr_t)blocks[i] & (CAUCHY_CACHE_LINE_SIZE - 1)) == 0);
+            memset(blocks[i], (int)i, cfg.block_size);
+        }
+        for (int i = 0; i < 300; i++) cauchy_pool_free(pool, blocks[i]);
+        assert(cauchy_pool_get_stats(pool).in_use == 0);
+        cauchy_pool_destroy(pool);
+    }
+
+    /* A node's arena at max_blocks takes the other arenas' free blocks */
+    cauchy_pool_config_t cfg = CAUCHY_POOL_CONFIG_DEFAULT;
+    cfg.numa = CAUCHY_POOL_NUMA_BIND;
+    cfg.initial_blocks = 64;
+    cfg.max_blocks = 64;
+    cfg.slab_blocks = 16;
+    cauchy_pool_t* pool = cauchy_pool_create(&cfg);
+    assert(pool);
+    void* blocks[64];
+    for (int i = 0; i < 64; i++) assert((blocks[i] = cauchy_pool_alloc(pool)) != NULL);
+    assert(cauchy_pool_alloc(pool) == NULL);
+    for (int i = 0; i < 64; i++) cauchy_pool_free(pool, blocks[i]);
+    cauchy_pool_destroy(pool);
+
+    /* Huge-page slabs are grown to fill their pages */
+    cfg = (cauchy_pool_config_t)CAUCHY_POOL_CONFIG_DEFAULT;
+    cfg.huge_pages = true;
+    cfg.initial_blocks = 0;
+    cfg.slab_blocks = CAUCHY_HUGE_PAGE_SIZE / 64;
+    pool = cauchy_pool_create(&cfg);
+    assert(pool);
+    void* block = cauchy_pool_alloc(pool);
+    assert(block);
+    memset(block, 0xab, 64);
+    cauchy_pool_stats_t stats = cauchy_pool_get_stats(pool);
+    assert(stats.allocated > cfg.slab_blocks);
+    assert(stats.allocated * 64 < 2 * (u64)CAUCHY_HUGE_PAGE_SIZE);
+    cauchy_pool_free(pool, block);
+    cauchy_pool_destroy(pool);
+}
+
+static int reclaimed_nodes;
+
+static void count_retire(void* node, void* ctx) {
+    (void)node;
+    (void)ctx;
+    __atomic_fetch_add(&reclaimed_nodes, 1, __ATOMIC_RELAXED);
+}
+
+TEST(hazard_protect_blocks_reclaim) {
+    cauchy_hazard_domain_t* domain = cauchy_hazard_domain_create();
+    assert(domain);
+
+    static int nodes[8];
+    cauchy_atomic_ptr_t slot;
+    atomic_init(&slot, &nodes[0]);
+    assert(cauchy_hazard_protect(domain, 0, &slot) == &nodes[0]);
+
+    reclaimed_nodes = 0;
+    for (int i = 0; i < 8; i++) {
+        cauchy_hazard_retire(domain, &nodes[i], count_retire, NULL);
+    }
+    assert(cauchy_hazard_reclaim(domain) == 7);
+    assert(reclaimed_nodes == 7);
+
+    cauchy_hazard_clear(domain, 0);
+    assert(cauchy_hazard_reclaim(domain) == 1);
+    assert(reclaimed_nodes == 8);
+
+    cauchy_hazard_domain_destroy(domain);
+}
+
+static void* hazard_orphan_worker(void* arg) {
+    cauchy_hazard_domain_t* domain = arg;
+    static int nodes[16];
+    cauchy_atomic_ptr_t slot;
+    atomic_init(&slot, &nodes[0]);
+    /* Exit while still holding a hazard and with nodes left retired */
+    cauchy_hazard_protect(domain, 0, &slot);
+    for (int i = 0; i < 16; i++) {
+        cauchy_hazard_retire(domain, &nodes[i], count_retire, NULL);
+    }
+    return NULL;
+}
+
+TEST(hazard_orphan_handoff) {
+    cauchy_hazard_domain_t* domain = cauchy_hazard_domain_create();
+    assert(domain);
+    reclaimed_nodes = 0;
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, hazard_orphan_worker, domain);
+    pthread_join(thread, NULL);
+    assert(reclaimed_nodes == 0);
+
+    assert(cauchy_hazard_reclaim(domain) == 16);
+    assert(reclaimed_nodes == 16);
+
+    cauchy_hazard_domain_destroy(domain);
+}
+
+TEST(epoch_defers_until_exit) {
+    cauchy_epoch_domain_t* domain = cauchy_epoch_domain_create();
+    assert(domain);
+    reclaimed_nodes = 0;
+
+    static int nodes[4];
+    cauchy_epoch_enter(domain);
+    for (int i = 0; i < 4; i++) {
+        assert(cauchy_epoch_retire(domain, &nodes[i], count_retire, NULL) == CAUCHY_OK);
+    }
+    assert(cauchy_epoch_retire(domain, NULL, count_retire, NULL) == CAUCHY_ERR_INVALID);
+    for (int i = 0; i < 4; i++) cauchy_epoch_reclaim(domain);
+    assert(reclaimed_nodes == 0);
+    cauchy_epoch_exit(domain);
+
+    usize total = 0;
+    for (int i = 0; i < 4; i++) total += cauchy_epoch_reclaim(domain);
+    assert(total == 4);
+    assert(reclaimed_nodes == 4);
+
+    cauchy_epoch_domain_destroy(domain);
+}
+
+TEST(context_reclaim_modes) {
+    cauchy_context_t* hp = cauchy_context_create(1);
+    cauchy_context_t* ebr = cauchy_context_create_ex(2, CAUCHY_RECLAIM_EPOCH);
+    assert(hp && hp->hazard_domain && !hp->epoch_domain);
+    assert(ebr && ebr->epoch_domain && !ebr->hazard_domain);
+
+    static int node;
+    reclaimed_nodes = 0;
+    assert(cauchy_context_retire(ebr, &node, count_retire, NULL) == CAUCHY_OK);
+    while (reclaimed_nodes == 0) cauchy_context_reclaim(ebr);
+
+    cauchy_context_destroy(hp);
+    cauchy_context_destroy(ebr);
+}
+
+TEST(context_stats_snapshot) {
+    cauchy_context_t* ctx = cauchy_context_create(7);
+    assert(ctx);
+    cauchy_context_stats_t before, after;
+    assert(cauchy_context_get_stats(ctx, &before) == CAUCHY_OK);
+    assert(before.node_id == 7 && before.reclaim_pending == 0);
+
+    static int nodes[3];
+    reclaimed_nodes = 0;
+    for (int i = 0; i < 3; i++) {
+        assert(cauchy_context_retire(ctx, &nodes[i], count_retire, NULL) == CAUCHY_OK);
+    }
+    assert(cauchy_context_get_stats(ctx, &after) == CAUCHY_OK);
+    assert(after.reclaim_pending == 3);
+    assert(cauchy_context_reclaim(ctx) == 3);
+    assert(cauchy_context_get_stats(ctx, &after) == CAUCHY_OK);
+    assert(after.reclaim_pending == 0);
+
+#ifdef CAUCHY_STATS
+    const cauchy_stats_t* b = &before.process;
+    const cauchy_stats_t* a = &after.process;
+    assert(a->enabled);
+    assert(a->counters[CAUCHY_STAT_HAZARD_RETIRED] - b->counters[CAUCHY_STAT_HAZARD_RETIRED] >= 3);
+    assert(a->counters[CAUCHY_STAT_HAZARD_RECLAIMED] - b->counters[CAUCHY_STAT_HAZARD_RECLAIMED] >= 3);
+    assert(a->hist[CAUCHY_HIST_HAZARD_RECLAIM_NS].count > b->hist[CAUCHY_HIST_HAZARD_RECLAIM_NS].count);
+    assert(a->hist[CAUCHY_HIST_HAZARD_BACKLOG].max >= 3);
+#else
+    assert(!after.process.enabled);
+#endif
+
+    /* Log2 buckets report the bucket's upper bound, capped at the max */
+    cauchy_histogram_t h = { 0 };
+    h.count = 4;
+    h.max = 1000;
+    h.buckets[1] = 1;   /* 1 */
+    h.buckets[3] = 2;   /* 4..7 */
+    h.buckets[10] = 1;  /* 512..1023 */
+    assert(cauchy_stats_percentile(&h, 0.0) == 1);
+    assert(cauchy_stats_percentile(&h, 0.5) == 7);
+    assert(cauchy_stats_percentile(&h, 1.0) == 1000);
+
+    char text[64];
+    usize need = cauchy_stats_format(&after.process, text, sizeof(text));
+    assert(need > sizeof(text) && strlen(text) == sizeof(text) - 1);
+    assert(strncmp(text, "cauchy_pool_cas_retries ", 24) == 0);
+
+    cauchy_context_destroy(ctx);
+}
+
+TEST(snapshot_restart) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/cauchy-restart-%d.snap", (int)getpid());
+
+    cauchy_context_t* ctx = cauchy_context_create(3);
+    for (int i = 0; i < 5; i++) cauchy_context_gen_uid(ctx);
+    cauchy_context_tick(ctx);
+    cauchy_gcounter_t gc;
+    cauchy_gcounter_init(&gc, 4);
+    for (int i = 0; i < 9; i++) cauchy_gcounter_increment(&gc, (cauchy_node_id_t)(i % 3));
+    cauchy_pncounter_t pn;
+    cauchy_pncounter_init(&pn, 4);
+    assert(cauchy_pncounter_add(&pn, 1, 10) == CAUCHY_OK);
+    assert(cauchy_pncounter_decrement(&pn, 2) == CAUCHY_OK);
+    cauchy_lww_register_t reg;
+    cauchy_lww_init(&reg);
+    assert(cauchy_lww_set_string(&reg, "persisted", 42, 3) == CAUCHY_OK);
+    cauchy_lww_map_t* map = cauchy_lww_map_create(16, NULL);
+    assert(cauchy_lww_map_set_string(map, "a", "alpha", 1, 1) == CAUCHY_OK);
+    assert(cauchy_lww_map_set_string(map, "b", "beta", 2, 1) == CAUCHY_OK);
+    assert(cauchy_lww_map_remove_string(map, "b", 3, 2) == CAUCHY_OK);
+    cauchy_rga_t* rga = cauchy_rga_create(3);
+    assert(cauchy_rga_insert(rga, 0, "hello world", 11, NULL, NULL) == CAUCHY_OK);
+    assert(cauchy_rga_delete(rga, 5, 6, NULL, NULL) == CAUCHY_OK);
+
+    cauchy_snapshot_writer_t* w = cauchy_snapshot_writer_create(path);
+    assert(w);
+    assert(cauchy_context_snapshot_save(ctx, w) == CAUCHY_OK);
+    assert(cauchy_gcounter_snapshot_save(&gc, w, 1) == CAUCHY_OK);
+    assert(cauchy_pncounter_snapshot_save(&pn, w, 1) == CAUCHY_OK);
+    assert(cauchy_lww_snapshot_save(&reg, w, 1) == CAUCHY_OK);
+    assert(cauchy_lww_map_snapshot_save(map, w, 1) == CAUCHY_OK);
+    assert(cauchy_rga_snapshot_save(rga, w, 1) == CAUCHY_OK);
+    assert(cauchy_snapshot_writer_commit(w) == CAUCHY_OK);
+    assert(access(path, F_OK) == 0);
+
+    cauchy_snapshot_t* snap;
+    assert(cauchy_snapshot_open(path, &snap) == CAUCHY_OK);
+    assert(cauchy_snapshot_section_count(snap) == 6);
+    cauchy_snapshot_kind_t kind;
+    u64 id;
+    assert(cauchy_snapshot_section_at(snap, 0, &kind, &id) == CAUCHY_OK);
+    assert(kind == CAUCHY_SNAPSHOT_CONTEXT && id == 3);
+
+    /* The restarted node resumes UIDs and the clock past the saved ones */
+    cauchy_context_t* restarted = cauchy_context_create(3);
+    assert(cauchy_context_snapshot_load(restarted, snap) == CAUCHY_OK);
+    assert(cauchy_vclock_get(&restarted->local_clock, 3) == cauchy_vclock_get(&ctx->local_clock, 3));
+    cauchy_uid_t uid = cauchy_context_gen_uid(restarted);
+    assert(uid.node_id == 3 && uid.timestamp > cauchy_vclock_get(&ctx->local_clock, 3));
+    assert(restarted->op_counter > ctx->op_counter);
+
+    cauchy_gcounter_t lgc;
+    cauchy_gcounter_init(&lgc, 1);
+    assert(cauchy_gcounter_snapshot_load(&lgc, snap, 1) == CAUCHY_OK);
+    assert(cauchy_gcounter_value(&lgc) == 9);
+    cauchy_pncounter_t lpn;
+    cauchy_pncounter_init(&lpn, 1);
+    assert(cauchy_pncounter_snapshot_load(&lpn, snap, 1) == CAUCHY_OK);
+    assert(cauchy_pncounter_value(&lpn) == 9);
+    cauchy_lww_register_t lreg;
+    cauchy_lww_init(&lreg);
+    assert(cauchy_lww_snapshot_load(&lreg, snap, 1) == CAUCHY_OK);
+    assert(strcmp(cauchy_lww_get_string(&lreg), "persisted") == 0 && lreg.timestamp == 42);
+    cauchy_lww_map_t* lmap = cauchy_lww_map_create(16, NULL);
+    assert(cauchy_lww_map_snapshot_load(lmap, snap, 1) == CAUCHY_OK);
+    assert(cauchy_lww_map_contains_string(lmap, "a") && !cauchy_lww_map_contains_string(lmap, "b"));
+    assert(cauchy_lww_map_set_string(lmap, "b", "stale", 2, 9) == CAUCHY_OK);
+    assert(!cauchy_lww_map_contains_string(lmap, "b"));
+    cauchy_rga_t* lrga = cauchy_rga_create(3);
+    assert(cauchy_rga_snapshot_load(lrga, snap, 1) == CAUCHY_OK);
+    char text[16];
+    assert(cauchy_rga_length(lrga) == 5);
+    assert(cauchy_rga_read(lrga, 0, text, sizeof(text)) == 5 && memcmp(text, "hello", 5) == 0);
+    assert(cauchy_rga_insert(lrga, 5, "!", 1, NULL, NULL) == CAUCHY_OK);
+    assert(cauchy_rga_length(lrga) == 6);
+    assert(cauchy_gcounter_snapshot_load(&lgc, snap, 2) == CAUCHY_ERR_NOTFOUND);
+    cauchy_snapshot_release(snap);
+
+    /* Damaged or missing files are refused */
+    FILE* f = fopen(path, "r+b");
+    assert(f && fwrite("X", 1, 1, f) == 1);
+    fclose(f);
+    assert(cauchy_snapshot_open(path, &snap) == CAUCHY_ERR_INVALID);
+    assert(truncate(path, 16) == 0);
+    assert(cauchy_snapshot_open(path, &snap) == CAUCHY_ERR_INVALID);
+    unlink(path);
+    assert(cauchy_snapshot_open(path, &snap) == CAUCHY_ERR_IO);
+
+    cauchy_context_destroy(ctx);
+    cauchy_context_destroy(restarted);
+    cauchy_gcounter_fini(&gc);
+    cauchy_gcounter_fini(&lgc);
+    cauchy_pncounter_fini(&pn);
+    cauchy_pncounter_fini(&lpn);
+    cauchy_lww_fini(&reg);
+    cauchy_lww_fini(&lreg);
+    cauchy_lww_map_destroy(map);
+    cauchy_lww_map_destroy(lmap);
+    cauchy_rga_destroy(rga);
+    cauchy_rga_destroy(lrga);
+}
+
+/* RGA section with a clock and blocks of {timestamp, len} on node 3 */
+static void put_rga_section(cauchy_snapshot_writer_t* w, u64 id, u64 clock,
+                            const u64 (*blocks)[2], u64 count) {
+    assert(cauchy_snapshot_writer_begin(w, CAUCHY_SNAPSHOT_RGA, id) == CAUCHY_OK);
+    u64 head[2] = { clock, count };
+    assert(cauchy_snapshot_writer_put(w, head, sizeof(head)) == CAUCHY_OK);
+    for (u64 i = 0; i < count; i++) {
+        u64 meta[4] = { 3, blocks[i][0], blocks[i][1], 0 };
+        assert(cauchy_snapshot_writer_put(w, meta, sizeof(meta)) == CAUCHY_OK);
+        assert(cauchy_snapshot_writer_put_blob(w, "abcdefgh", blocks[i][1]) == CAUCHY_OK);
+    }
+    assert(cauchy_snapshot_writer_end(w) == CAUCHY_OK);
+}
+
+TEST(rga_snapshot_validation) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/cauchy-rga-%d.snap", (int)getpid());
+
+    const u64 overlap_tail[][2] = { { 1, 5 }, { 3, 2 } };
+    const u64 overlap_span[][2] = { { 3, 1 }, { 1, 5 } };
+    const u64 good[][2] = { { 4, 2 }, { 1, 3 } };
+    cauchy_snapshot_writer_t* w = cauchy_snapshot_writer_create(path);
+    assert(w);
+    put_rga_section(w, 1, 9, overlap_tail, 2);
+    put_rga_section(w, 2, 9, overlap_span, 2);
+    put_rga_section(w, 3, 4, good, 2);
+    put_rga_section(w, 4, 5, good, 2);
+    assert(cauchy_snapshot_writer_commit(w) == CAUCHY_OK);
+
+    /* Overlapping ids and a stale clock are refused and leave the
+     * sequence empty, so a good section still loads afterwards */
+    cauchy_snapshot_t* snap;
+    assert(cauchy_snapshot_open(path, &snap) == CAUCHY_OK);
+    cauchy_rga_t* rga = cauchy_rga_create(3);
+    for (u64 id = 1; id <= 3; id++) {
+        assert(cauchy_rga_snapshot_load(rga, snap, id) == CAUCHY_ERR_INVALID);
+        assert(rga->root == NULL && rga->block_count == 0 && rga->clock == 0);
+    }
+    assert(cauchy_rga_snapshot_load(rga, snap, 4) == CAUCHY_OK);
+    char text[8];
+    assert(cauchy_rga_read(rga, 0, text, sizeof(text)) == 5 && memcmp(text, "ababc", 5) == 0);
+    assert(rga->clock == 5);
+
+    cauchy_snapshot_release(snap);
+    cauchy_rga_destroy(rga);
+    unlink(path);
+}
+
+#define WAL_THREADS 8
+#define WAL_OPS     200
+
+typedef struct wal_worker {
+    cauchy_wal_t* wal;
+    u64           node;
+} wal_worker_t;
+
+static void* wal_worker_run(void* arg) {
+    wal_worker_t* wk = arg;
+    for (u64 i = 1; i <= WAL_OPS; i++) {
+        cauchy_wal_record_t rec = {
+            .kind = CAUCHY_SNAPSHOT_G_COUNTER, .op = 1, .crdt_id = 1,
+            .uid = { .node_id = wk->node, .timestamp = i },
+            .data = &i, .size = sizeof(i)
+        };
+        assert(cauchy_wal_commit(wk->wal, &rec) == CAUCHY_OK);
+    }
+    return NULL;
+}
+
+static cauchy_result_t wal_count_apply(void* arg, const cauchy_wal_record_t* rec) {
+    u64* sums = arg;
+    u64 v;
+    assert(rec->size == sizeof(v) && rec->kind == CAUCHY_SNAPSHOT_G_COUNTER);
+    memcpy(&v, rec->data, sizeof(v));
+    assert(v == rec->uid.timestamp);
+    sums[rec->uid.node_id] += v;
+    return CAUCHY_OK;
+}
+
+TEST(wal_group_commit) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/cauchy-wal-%d.log", (int)getpid());
+    unlink(path);
+
+    cauchy_wal_config_t cfg = CAUCHY_WAL_CONFIG_DEFAULT;
+    cfg.max_delay_us = 200;
+    cauchy_wal_t* wal = cauchy_wal_open(path, &cfg);
+    assert(wal);
+
+    pthread_t threads[WAL_THREADS];
+    wal_worker_t workers[WAL_THREADS];
+    for (int t = 0; t < WAL_THREADS; t++) {
+        workers[t] = (wal_worker_t){ wal, (u64)t };
+        pthread_create(&threads[t], NULL, wal_worker_run, &workers[t]);
+    }
+    for (int t = 0; t < WAL_THREADS; t++) pthread_join(threads[t], NULL);
+
+    /* Every commit returned durable, with far fewer flushes than ops */
+    cauchy_wal_stats_t st;
+    cauchy_wal_get_stats(wal, &st);
+    assert(st.appended == WAL_THREADS * WAL_OPS && st.durable == st.appended);
+    assert(st.batches > 0 && st.batches < st.appended);
+    assert(cauchy_wal_close(wal) == CAUCHY_OK);
+
+    u64 sums[WAL_THREADS] = { 0 };
+    usize replayed;
+    assert(cauchy_wal_replay(path, NULL, wal_count_apply, sums, &replayed) == CAUCHY_OK);
+    assert(replayed == WAL_THREADS * WAL_OPS);
+    for (int t = 0; t < WAL_THREADS; t++) assert(sums[t] == WAL_OPS * (WAL_OPS + 1) / 2);
+
+    /* A torn tail is ignored by replay and cut off when reopened */
+    FILE* f = fopen(path, "ab");
+    assert(f && fwrite("torn record", 1, 11, f) == 11);
+    fclose(f);
+    memset(sums, 0, sizeof(sums));
+    assert(cauchy_wal_replay(path, NULL, wal_count_apply, sums, &replayed) == CAUCHY_OK);
+    assert(replayed == WAL_THREADS * WAL_OPS);
+    wal = cauchy_wal_open(path, NULL);
+    assert(wal);
+    u64 one = 1;
+    cauchy_wal_record_t rec = {
+        .kind = CAUCHY_SNAPSHOT_G_COUNTER, .crdt_id = 1,
+        .uid = { .node_id = 0, .timestamp = 1 }, .data = &one, .size = sizeof(one)
+    };
+    assert(cauchy_wal_commit(wal, &rec) == CAUCHY_OK);
+    assert(cauchy_wal_close(wal) == CAUCHY_OK);
+    assert(cauchy_wal_replay(path, NULL, wal_count_apply, sums, &replayed) == CAUCHY_OK);
+    assert(replayed == WAL_THREADS * WAL_OPS + 1);
+
+    unlink(path);
+    assert(cauchy_wal_replay(path, NULL, wal_count_apply, sums, &replayed) == CAUCHY_OK);
+    assert(replayed == 0);
+
+    /* A header torn on creation is an empty log and rewritten on open;
+     * a short file that is not a header prefix is not a log */
+    f = fopen(path, "wb");
+    assert(f && fwrite("CAUCH", 1, 5, f) == 5);
+    fclose(f);
+    assert(cauchy_wal_replay(path, NULL, wal_count_apply, sums, &replayed) == CAUCHY_OK);
+    assert(replayed == 0);
+    wal = cauchy_wal_open(path, NULL);
+    assert(wal);
+    assert(cauchy_wal_commit(wal, &rec) == CAUCHY_OK);
+    assert(cauchy_wal_close(wal) == CAUCHY_OK);
+    assert(cauchy_wal_replay(path, NULL, wal_count_apply, sums, &replayed) == CAUCHY_OK);
+    assert(replayed == 1);
+
+    f = fopen(path, "wb");
+    assert(f && fwrite("garbage", 1, 7, f) == 7);
+    fclose(f);
+    assert(cauchy_wal_replay(path, NULL, wal_count_apply, sums, &replayed) == CAUCHY_ERR_INVALID);
+    assert(cauchy_wal_open(path, NULL) == NULL);
+    unlink(path);
+}
+
+/* Replica state a node rebuilds from its snapshot and log */
+typedef struct wal_replica {
+    cauchy_gcounter_t counter;
+    cauchy_lww_map_t* map;
+} wal_replica_t;
+
+enum { WAL_OP_COUNTER_DELTA = 1, WAL_OP_MAP_SET = 2 };
+
+static cauchy_result_t wal_replica_apply(void* arg, const cauchy_wal_record_t* rec) {
+    wal_replica_t* r = arg;
+    if (rec->op == WAL_OP_COUNTER_DELTA) {
+        cauchy_gcounter_t delta;
+        cauchy_gcounter_init(&delta, 0);
+        cauchy_result_t res = cauchy_gcounter_decode(&delta, NULL, rec->data, rec->size, NULL);
+        if (res == CAUCHY_OK) res = cauchy_gcounter_merge_delta(&r->counter, &delta);
+        cauchy_gcounter_fini(&delta);
+        return res;
+    }
+    /* key NUL value, stamped with the op's uid */
+    const char* key = rec->data;
+    usize key_size = strlen(key);
+    return cauchy_lww_map_set(r->map, key, key_size, key + key_size + 1,
+                              rec->size - key_size - 1, rec->uid.timestamp, rec->uid.node_id);
+}
+
+static void wal_log_increment(cauchy_wal_t* wal, cauchy_context_t* ctx, wal_replica_t* r) {
+    cauchy_uid_t uid = cauchy_context_gen_uid(ctx);
+    cauchy_gcounter_t delta;
+    cauchy_gcounter_init(&delta, 0);
+    assert(cauchy_gcounter_increment_delta(&r->counter, ctx->node_id, &delta) == CAUCHY_OK);
+    u8 buf[64];
+    usize n = cauchy_gcounter_encode(&delta, NULL, buf, sizeof(buf));
+    assert(n > 0);
+    cauchy_wal_record_t rec = {
+        .kind = CAUCHY_SNAPSHOT_G_COUNTER, .op = WAL_OP_COUNTER_DELTA, .crdt_id = 1,
+        .uid = uid, .data = buf, .size = n
+    };
+    assert(cauchy_wal_append(wal, &rec, NULL) == CAUCHY_OK);
+    cauchy_gcounter_fini(&delta);
+}
+
+static void wal_log_set(cauchy_wal_t* wal, cauchy_context_t* ctx, wal_replica_t* r,
+                        const char* key, const char* value) {
+    cauchy_uid_t uid = cauchy_context_gen_uid(ctx);
+    char buf[64];
+    usize n = (usize)snprintf(buf, sizeof(buf), "%s%c%s", key, '\0', value);
+    cauchy_wal_record_t rec = {
+        .kind = CAUCHY_SNAPSHOT_LWW_MAP, .op = WAL_OP_MAP_SET, .crdt_id = 1,
+        .uid = uid, .data = buf, .size = n
+    };
+    assert(wal_replica_apply(r, &rec) == CAUCHY_OK);
+    assert(cauchy_wal_append(wal, &rec, NULL) == CAUCHY_OK);
+}
+
+TEST(wal_replay_over_snapshot) {
+    char log_path[64], snap_path[64];
+    snprintf(log_path, sizeof(log_path), "/tmp/cauchy-oplog-%d.log", (int)getpid());
+    snprintf(snap_path, sizeof(snap_path), "/tmp/cauchy-oplog-%d.snap", (int)getpid());
+    unlink(log_path);
+
+    cauchy_context_t* ctx = cauchy_context_create(2);
+    wal_replica_t live = { .map = cauchy_lww_map_create(16, NULL) };
+    cauchy_gcounter_init(&live.counter, 4);
+    cauchy_wal_t* wal = cauchy_wal_open(log_path, NULL);
+    assert(wal);
+
+    for (int i = 0; i < 10; i++) wal_log_increment(wal, ctx, &live);
+    wal_log_set(wal, ctx, &live, "k", "before");
+
+    /* Snapshot mid-stream; the log keeps the ops it already covers */
+    cauchy_snapshot_writer_t* w = cauchy_snapshot_writer_create(snap_path);
+    assert(cauchy_context_snapshot_save(ctx, w) == CAUCHY_OK);
+    assert(cauchy_gcounter_snapshot_save(&live.counter, w, 1) == CAUCHY_OK);
+    assert(cauchy_lww_map_snapshot_save(live.map, w, 1) == CAUCHY_OK);
+    assert(cauchy_snapshot_writer_commit(w) == CAUCHY_OK);
+
+    for (int i = 0; i < 5; i++) wal_log_increment(wal, ctx, &live);
+    wal_log_set(wal, ctx, &live, "k", "after");
+    assert(cauchy_wal_sync(wal, 0) == CAUCHY_OK);
+    assert(cauchy_wal_close(wal) == CAUCHY_OK);
+
+    /* Restart: snapshot first, then only the ops it does not cover */
+    cauchy_context_t* restarted = cauchy_context_create(2);
+    wal_replica_t back = { .map = cauchy_lww_map_create(16, NULL) };
+    cauchy_gcounter_init(&back.counter, 4);
+    cauchy_snapshot_t* snap;
+    assert(cauchy_snapshot_open(snap_path, &snap) == CAUCHY_OK);
+    assert(cauchy_context_snapshot_load(restarted, snap) == CAUCHY_OK);
+    assert(cauchy_gcounter_snapshot_load(&back.counter, snap, 1) == CAUCHY_OK);
+    assert(cauchy_lww_map_snapshot_load(back.map, snap, 1) == CAUCHY_OK);
+    cauchy_snapshot_release(snap);
+
+    cauchy_vclock_t applied;
+    assert(cauchy_vclock_copy(&applied, &restarted->local_clock) == CAUCHY_OK);
+    usize replayed;
+    assert(cauchy_wal_replay(log_path, &applied, wal_replica_apply, &back, &replayed) == CAUCHY_OK);
+    assert(replayed == 6);
+    assert(cauchy_gcounter_value(&back.counter) == 15);
+    cauchy_lww_register_t reg;
+    cauchy_lww_init(&reg);
+    assert(cauchy_lww_map_get(back.map, "k", 1, &reg) == CAUCHY_OK);
+    assert(reg.value_size == 5 && memcmp(cauchy_lww_get(&reg, NULL), "after", 5) == 0);
+    cauchy_lww_fini(&reg);
+
+    /* Replaying again changes nothing, and new uids follow the log */
+    assert(cauchy_wal_replay(log_path, &applied, wal_replica_apply, &back, &replayed) == CAUCHY_OK);
+    assert(replayed == 0 && cauchy_gcounter_value(&back.counter) == 15);
+    cauchy_context_merge_clock(restarted, &applied);
+    assert(cauchy_context_gen_uid(restarted).timestamp > cauchy_vclock_get(&ctx->local_clock, 2));
+
+    cauchy_vclock_fini(&applied);
+    cauchy_gcounter_fini(&live.counter);
+    cauchy_gcounter_fini(&back.counter);
+    cauchy_lww_map_destroy(live.map);
+    cauchy_lww_map_destroy(back.map);
+    cauchy_context_destroy(ctx);
+    cauchy_context_destroy(restarted);
+    unlink(log_path);
+    unlink(snap_path);
+}
+
+int main(void) {
+    printf("Memory Tests:\n");
+
+    RUN(pool_alloc_free);
+    RUN(pool_max_blocks);
+    RUN(pool_thread_exit);
+    RUN(pool_concurrent);
+    RUN(pool_depot_aba);
+    RUN(pool_numa_placement);
+    RUN(hazard_protect_blocks_reclaim);
+    RUN(hazard_orphan_handoff);
+    RUN(epoch_defers_until_exit);
+    RUN(context_reclaim_modes);
+    RUN(context_stats_snapshot);
+    RUN(snapshot_restart);
+    RUN(rga_snapshot_validation);
+    RUN(wal_group_commit);
+    RUN(wal_replay_over_snapshot);
+
+    printf("\nAll memory tests passed!\n");
+    return 0;
+}
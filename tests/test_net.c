@@ -0,0 +1,451 @@
+/*
+ * CAUCHY - Networking Tests
+ */
+
+#include "cauchy/cauchy.h"
+#include "cauchy/net/anti_entropy.h"
+#include "cauchy/net/gossip.h"
+#include "cauchy/net/membership.h"
+#include "cauchy/crdt/g_counter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { printf("  %-40s", #name); test_##name(); printf("✓\n"); } while(0)
+
+/* Digests depend only on contents, not on insertion order or history */
+TEST(merkle_order_independent) {
+    cauchy_merkle_t a, b;
+    assert(cauchy_merkle_init(&a, 8) == CAUCHY_OK);
+    assert(cauchy_merkle_init(&b, 8) == CAUCHY_OK);
+
+    for (u64 i = 0; i < 1000; i++) cauchy_merkle_add(&a, i * 0x9E3779B97F4A7C15ULL, i);
+    for (u64 i = 1000; i-- > 0;) cauchy_merkle_add(&b, i * 0x9E3779B97F4A7C15ULL, i);
+    assert(cauchy_merkle_root(&a) == cauchy_merkle_root(&b));
+
+    cauchy_merkle_add(&b, 12345, 12345);
+    assert(cauchy_merkle_root(&a) != cauchy_merkle_root(&b));
+    cauchy_merkle_remove(&b, 12345, 12345);
+    assert(cauchy_merkle_root(&a) == cauchy_merkle_root(&b));
+
+    assert(cauchy_merkle_init(&a, CAUCHY_MERKLE_MAX_DEPTH + 1) == CAUCHY_ERR_INVALID);
+    cauchy_merkle_destroy(&a);
+    cauchy_merkle_destroy(&b);
+}
+
+TEST(ae_gset_traffic_scales_with_difference) {
+    cauchy_gset_t* a = cauchy_gset_create(16);
+    cauchy_gset_t* b = cauchy_gset_create(16);
+    assert(cauchy_gset_enable_digest(a, 0) == CAUCHY_OK);
+    char buf[32];
+
+    for (int i = 0; i < 50000; i++) {
+        snprintf(buf, sizeof(buf), "elem-%d", i);
+        cauchy_gset_add_string(a, buf);
+        cauchy_gset_add_string(b, buf);
+    }
+    /* Enabling late folds the existing elements in */
+    assert(cauchy_gset_enable_digest(b, 0) == CAUCHY_OK);
+    assert(cauchy_gset_enable_digest(b, 0) == CAUCHY_ERR_EXISTS);
+    assert(cauchy_merkle_root(cauchy_gset_digest(a)) == cauchy_merkle_root(cauchy_gset_digest(b)));
+
+    cauchy_gset_add_string(b, "only-b-1");
+    cauchy_gset_add_string(b, "only-b-2");
+    cauchy_gset_add_string(a, "only-a");
+
+    /* Manual session: a is the initiator, b answers */
+    const cauchy_merkle_t* da = cauchy_gset_digest(a);
+    const cauchy_merkle_t* db = cauchy_gset_digest(b);
+    cauchy_ae_session_t s;
+    assert(cauchy_ae_session_init(&s, da) == CAUCHY_OK);
+    assert(cauchy_ae_start(&s, cauchy_merkle_root(db), db->depth) == CAUCHY_OK);
+    u64 answer[16];
+    while (!cauchy_ae_done(&s)) {
+        usize n;
+        const u64* nodes = cauchy_ae_pending(&s, &n);
+        assert(n > 0 && n <= 3);
+        assert(cauchy_ae_answer(db, s.level, nodes, n, answer) == CAUCHY_OK);
+        assert(cauchy_ae_descend(&s, answer, 2 * n) == CAUCHY_OK);
+    }
+    usize buckets;
+    cauchy_ae_pending(&s, &buckets);
+    assert(buckets >= 1 && buckets <= 3);
+    assert(s.digests_in <= 1 + 2 * 3 * CAUCHY_MERKLE_DEFAULT_DEPTH);
+    cauchy_ae_session_destroy(&s);
+
+    assert(cauchy_ae_sync_gset(a, b) == CAUCHY_OK);
+    assert(cauchy_ae_sync_gset(b, a) == CAUCHY_OK);
+    assert(cauchy_gset_equals(a, b));
+    assert(cauchy_gset_contains_string(a, "only-b-2"));
+    assert(cauchy_merkle_root(da) == cauchy_merkle_root(db));
+
+    cauchy_gset_destroy(a);
+    cauchy_gset_destroy(b);
+}
+
+TEST(ae_orset_sees_tombstones) {
+    cauchy_orset_t* a = cauchy_orset_create(16, 1);
+    cauchy_orset_t* b = cauchy_orset_create(16, 2);
+    assert(cauchy_orset_enable_digest(a, 10) == CAUCHY_OK);
+    assert(cauchy_orset_enable_digest(b, 10) == CAUCHY_OK);
+    char buf[32];
+
+    for (int i = 0; i < 5000; i++) {
+        snprintf(buf, sizeof(buf), "item-%d", i);
+        cauchy_orset_add_string(a, buf);
+    }
+    assert(cauchy_ae_sync_orset(b, a) == CAUCHY_OK);
+    assert(cauchy_orset_equals(a, b));
+    assert(cauchy_merkle_root(cauchy_orset_digest(a)) == cauchy_merkle_root(cauchy_orset_digest(b)));
+
+    /* Same active elements, but only a holds the tombstone */
+    cauchy_orset_remove_string(a, "item-42");
+    cauchy_orset_add_string(b, "item-42");
+    assert(cauchy_merkle_root(cauchy_orset_digest(a)) != cauchy_merkle_root(cauchy_orset_digest(b)));
+
+    assert(cauchy_ae_sync_orset(b, a) == CAUCHY_OK);
+    assert(cauchy_ae_sync_orset(a, b) == CAUCHY_OK);
+    assert(cauchy_orset_contains_string(a, "item-42"));
+    assert(cauchy_orset_equals(a, b));
+    assert(a->entry_count == b->entry_count);
+    assert(cauchy_merkle_root(cauchy_orset_digest(a)) == cauchy_merkle_root(cauchy_orset_digest(b)));
+
+    cauchy_orset_destroy(a);
+    cauchy_orset_destroy(b);
+}
+
+typedef struct gossip_sink {
+    u64               records;
+    u64               checksum;
+    cauchy_node_id_t  last_from;
+    cauchy_gcounter_t counter;
+} gossip_sink_t;
+
+static void sink_deliver(void* arg, cauchy_node_id_t from, u64 key, u8 type,
+                         const u8* data, usize size) {
+    gossip_sink_t* sink = arg;
+    sink->records++;
+    sink->last_from = from;
+    if (type == 1) {
+        u64 v;
+        assert(size == sizeof(v));
+        memcpy(&v, data, sizeof(v));
+        sink->checksum += key ^ v;
+    } else if (type == 2) {
+        cauchy_gcounter_t delta;
+        assert(cauchy_gcounter_decode(&delta, NULL, data, size, NULL) == CAUCHY_OK);
+        cauchy_gcounter_merge_delta(&sink->counter, &delta);
+        cauchy_gcounter_fini(&delta);
+    }
+}
+
+TEST(gossip_batches_over_loopback) {
+    cauchy_context_t* ca = cauchy_context_create(1);
+    cauchy_context_t* cb = cauchy_context_create(2);
+    gossip_sink_t sink = {0};
+    cauchy_gcounter_init(&sink.counter, 4);
+
+    cauchy_gossip_config_t cfg = CAUCHY_GOSSIP_CONFIG_DEFAULT;
+    cfg.bind_addr = "127.0.0.1";
+    cauchy_gossip_t* a = cauchy_gossip_create(ca, &cfg, NULL, NULL);
+    cauchy_gossip_t* b = cauchy_gossip_create(cb, &cfg, sink_deliver, &sink);
+    assert(a && b);
+    assert(cauchy_gossip_port(b) != 0);
+    assert(cauchy_gossip_add_peer(a, 2, "127.0.0.1", cauchy_gossip_port(b)) == CAUCHY_OK);
+    assert(cauchy_gossip_add_peer(a, 3, "not-an-ip", 1) == CAUCHY_ERR_INVALID);
+    assert(cauchy_gossip_peer_count(a) == 1);
+
+    cauchy_context_tick(ca);
+    const u64 total = 5000;
+    u64 expect = 0;
+    for (u64 i = 0; i < total; i++) {
+        u8* p;
+        cauchy_result_t res;
+        while ((res = cauchy_gossip_reserve(a, i, 1, sizeof(u64), &p)) == CAUCHY_ERR_FULL) {
+            cauchy_gossip_poll(a, 1);
+        }
+        assert(res == CAUCHY_OK);
+        u64 v = i * 7;
+        memcpy(p, &v, sizeof(v));
+        assert(cauchy_gossip_commit(a, sizeof(v)) == CAUCHY_OK);
+        expect += i ^ v;
+        if (i % 256 == 0) cauchy_gossip_poll(b, 0);
+    }
+
+    /* Serialize a counter straight into the batch buffer */
+    cauchy_gcounter_t gc;
+    cauchy_gcounter_init(&gc, 4);
+    cauchy_gcounter_add(&gc, 1, 41);
+    u8* p;
+    assert(cauchy_gossip_reserve(a, 99, 2, 64, &p) == CAUCHY_OK);
+    assert(cauchy_gossip_commit(a, cauchy_gcounter_encode(&gc, NULL, p, 64)) == CAUCHY_OK);
+    /* The open batch goes out once its interval expires */
+    cauchy_gossip_poll(a, 1);
+    for (int spin = 0; spin < 2000 && sink.records < total + 1; spin++) {
+        cauchy_gossip_poll(a, 0);
+        cauchy_gossip_poll(b, 1);
+    }
+
+    cauchy_gossip_stats_t sa, sb;
+    cauchy_gossip_get_stats(a, &sa);
+    cauchy_gossip_get_stats(b, &sb);
+    assert(sink.records == total + 1);
+    assert(sink.checksum == expect);
+    assert(sink.last_from == 1);
+    assert(cauchy_gcounter_value(&sink.counter) == 41);
+    assert(sa.records_sent == total + 1);
+    assert(sb.datagrams_received * 50 < total);  /* Coalesced, not one per record */
+    assert(sb.datagrams_dropped == 0);
+    /* The sender's clock rode along in the header */
+    assert(cauchy_vclock_get(&cb->local_clock, 1) >= 1);
+
+    assert(cauchy_gossip_reserve(a, 0, 1, 70000, &p) == CAUCHY_ERR_INVALID);
+
+    cauchy_gcounter_fini(&gc);
+    cauchy_gcounter_fini(&sink.counter);
+    cauchy_gossip_destroy(a);
+    cauchy_gossip_destroy(b);
+    cauchy_context_destroy(ca);
+    cauchy_context_destroy(cb);
+}
+
+TEST(gossip_poll_during_reservation) {
+    cauchy_context_t* ca = cauchy_context_create(1);
+    cauchy_context_t* cb = cauchy_context_create(2);
+    gossip_sink_t sink = {0};
+    cauchy_gcounter_init(&sink.counter, 4);
+
+    cauchy_gossip_config_t cfg = CAUCHY_GOSSIP_CONFIG_DEFAULT;
+    cfg.bind_addr = "127.0.0.1";
+    cauchy_gossip_t* a = cauchy_gossip_create(ca, &cfg, NULL, NULL);
+    cauchy_gossip_t* b = cauchy_gossip_create(cb, &cfg, sink_deliver, &sink);
+    assert(a && b);
+    assert(cauchy_gossip_add_peer(a, 2, "127.0.0.1", cauchy_gossip_port(b)) == CAUCHY_OK);
+
+    /* Polling past the interval must not seal the batch under the record */
+    u64 v = 7;
+    assert(cauchy_gossip_publish(a, 1, 1, &v, sizeof(v)) == CAUCHY_OK);
+    u8* p;
+    assert(cauchy_gossip_reserve(a, 2, 1, sizeof(u64), &p) == CAUCHY_OK);
+    struct timespec pause = { 0, 2 * 1000000 };
+    nanosleep(&pause, NULL);
+    assert(cauchy_gossip_poll(a, 0) == CAUCHY_OK);
+    v = 9;
+    memcpy(p, &v, sizeof(v));
+    assert(cauchy_gossip_commit(a, sizeof(v)) == CAUCHY_OK);
+    assert(cauchy_gossip_flush(a) == CAUCHY_OK);
+    for (int spin = 0; spin < 2000 && sink.records < 2; spin++) cauchy_gossip_poll(b, 1);
+
+    cauchy_gossip_stats_t sb;
+    cauchy_gossip_get_stats(b, &sb);
+    assert(sink.records == 2);
+    assert(sink.checksum == (1 ^ 7) + (2 ^ 9));
+    assert(sb.datagrams_received == 1);
+
+    cauchy_gcounter_fini(&sink.counter);
+    cauchy_gossip_destroy(a);
+    cauchy_gossip_destroy(b);
+    cauchy_context_destroy(ca);
+    cauchy_context_destroy(cb);
+}
+
+/* Deterministic in-process network for the membership tests */
+#define SIM_NODES 4
+#define SIM_QUEUE 4096
+
+typedef struct sim_msg {
+    cauchy_node_id_t to;
+    usize            size;
+    u8*              data;
+} sim_msg_t;
+
+typedef struct sim {
+    cauchy_context_t*    ctx[SIM_NODES + 1];
+    cauchy_membership_t* m[SIM_NODES + 1];
+    bool                 down[SIM_NODES + 1];
+    sim_msg_t            queue[SIM_QUEUE];
+    usize                head, tail;
+    u64                  now;
+    u64                  stable_calls;
+} sim_t;
+
+typedef struct sim_port {
+    sim_t*           sim;
+    cauchy_node_id_t self;
+} sim_port_t;
+
+static sim_port_t sim_ports[SIM_NODES + 1];
+
+static void sim_send(void* arg, cauchy_node_id_t to, const u8* data, usize size) {
+    sim_port_t* port = arg;
+    sim_t* sim = port->sim;
+    if (sim->down[port->self] || to > SIM_NODES) return;
+    assert(sim->tail - sim->head < SIM_QUEUE);
+    sim_msg_t* msg = &sim->queue[sim->tail++ % SIM_QUEUE];
+    msg->to = to;
+    msg->size = size;
+    msg->data = malloc(size);
+    memcpy(msg->data, data, size);
+}
+
+static void sim_stable(void* arg, const cauchy_vclock_t* frontier,
+                       const cauchy_vclock_t* departed) {
+    sim_port_t* port = arg;
+    const cauchy_vclock_t* local = &port->sim->ctx[port->self]->local_clock;
+    /* Nothing this node has not seen can be stable, departed nodes aside */
+    cauchy_vclock_iter_t it;
+    cauchy_node_id_t node;
+    u64 value;
+    cauchy_vclock_iter_init(&it, frontier);
+    while (cauchy_vclock_iter_next(&it, &node, &value)) {
+        assert(value <= cauchy_vclock_get(local, node) || cauchy_vclock_get(departed, node) == value);
+    }
+    port->sim->stable_calls++;
+}
+
+static void sim_init(sim_t* sim) {
+    memset(sim, 0, sizeof(*sim));
+    for (cauchy_node_id_t i = 1; i <= SIM_NODES; i++) {
+        sim_ports[i].sim = sim;
+        sim_ports[i].self = i;
+        cauchy_membership_config_t cfg = CAUCHY_MEMBERSHIP_CONFIG_DEFAULT;
+        cfg.send = sim_send;
+        cfg.on_stable = sim_stable;
+        cfg.arg = &sim_ports[i];
+        sim->ctx[i] = cauchy_context_create(i);
+        sim->m[i] = cauchy_membership_create(sim->ctx[i], &cfg);
+        assert(sim->m[i]);
+    }
+    /* Everyone starts from one seed; the rest is learned by gossip */
+    for (cauchy_node_id_t i = 2; i <= SIM_NODES; i++) {
+        assert(cauchy_membership_add(sim->m[i], 1) == CAUCHY_OK);
+    }
+    assert(cauchy_membership_add(sim->m[2], 1) == CAUCHY_ERR_EXISTS);
+    assert(cauchy_membership_add(sim->m[2], 2) == CAUCHY_ERR_INVALID);
+}
+
+static void sim_run(sim_t* sim, u64 ms) {
+    for (u64 end = sim->now + ms; sim->now < end; sim->now += 50) {
+        for (cauchy_node_id_t i = 1; i <= SIM_NODES; i++) {
+            if (!sim->down[i]) cauchy_membership_tick(sim->m[i], sim->now);
+        }
+        while (sim->head != sim->tail) {
+            sim_msg_t msg = sim->queue[sim->head++ % SIM_QUEUE];
+            if (!sim->down[msg.to]) {
+                assert(cauchy_membership_receive(sim->m[msg.to], msg.data, msg.size,
+                                                 sim->now) == CAUCHY_OK);
+            }
+            free(msg.data);
+        }
+    }
+}
+
+static void sim_destroy(sim_t* sim) {
+    for (cauchy_node_id_t i = 1; i <= SIM_NODES; i++) {
+        cauchy_membership_destroy(sim->m[i]);
+        cauchy_context_destroy(sim->ctx[i]);
+    }
+}
+
+TEST(swim_detects_failure_and_prunes) {
+    sim_t* sim = malloc(sizeof(sim_t));
+    sim_init(sim);
+    sim_run(sim, 5000);
+    for (cauchy_node_id_t i = 1; i <= SIM_NODES; i++) {
+        assert(cauchy_membership_alive_count(sim->m[i]) == SIM_NODES - 1);
+    }
+
+    /* Node 4 does some work that everyone sees, then crashes */
+    for (int k = 0; k < 5; k++) cauchy_context_tick(sim->ctx[4]);
+    for (cauchy_node_id_t i = 1; i < SIM_NODES; i++) {
+        cauchy_context_merge_clock(sim->ctx[i], &sim->ctx[4]->local_clock);
+    }
+    u64 final4 = cauchy_vclock_get(&sim->ctx[4]->local_clock, 4);
+    /* Reports lag by up to one probe round per member */
+    sim_run(sim, 5000);
+    assert(cauchy_vclock_get(cauchy_membership_frontier(sim->m[1]), 4) == final4);
+
+    cauchy_vclock_t tracked;
+    cauchy_vclock_init(&tracked, 0);
+    cauchy_vclock_set(&tracked, 4, final4);
+    cauchy_vclock_set(&tracked, 2, 1);
+    assert(cauchy_membership_track_clock(sim->m[1], &tracked) == CAUCHY_OK);
+    assert(cauchy_membership_track_clock(sim->m[1], &tracked) == CAUCHY_ERR_EXISTS);
+
+    sim->down[4] = true;
+    sim_run(sim, 12000);
+    for (cauchy_node_id_t i = 1; i < SIM_NODES; i++) {
+        assert(cauchy_membership_state(sim->m[i], 4) == CAUCHY_MEMBER_DEAD);
+        assert(cauchy_membership_alive_count(sim->m[i]) == SIM_NODES - 2);
+        /* The departed node's entry is gone from every live clock... */
+        assert(cauchy_vclock_get(&sim->ctx[i]->local_clock, 4) == 0);
+        /* ...but the frontier still remembers it as stable */
+        assert(cauchy_vclock_get(cauchy_membership_frontier(sim->m[i]), 4) == final4);
+    }
+    assert(cauchy_vclock_get(&tracked, 4) == 0);
+    assert(cauchy_vclock_get(&tracked, 2) == 1);
+
+    cauchy_membership_stats_t st = {0};
+    cauchy_membership_get_stats(sim->m[1], &st);
+    assert(st.probes > 0 && st.frontiers > 0 && st.pruned_entries >= 2);
+    assert(sim->stable_calls > 0);
+
+    cauchy_membership_untrack_clock(sim->m[1], &tracked);
+    cauchy_vclock_fini(&tracked);
+    sim_destroy(sim);
+    free(sim);
+}
+
+TEST(swim_suspect_refutes) {
+    sim_t* sim = malloc(sizeof(sim_t));
+    sim_init(sim);
+    sim_run(sim, 5000);
+
+    /* Silent for a few probe periods, but back well within the timeout */
+    sim->down[2] = true;
+    sim_run(sim, 3000);
+    bool suspected = false;
+    for (cauchy_node_id_t i = 1; i <= SIM_NODES; i++) {
+        if (i != 2) suspected |= cauchy_membership_state(sim->m[i], 2) == CAUCHY_MEMBER_SUSPECT;
+    }
+    assert(suspected);
+    sim->down[2] = false;
+    sim_run(sim, 4000);
+
+    cauchy_membership_stats_t st = {0};
+    cauchy_membership_get_stats(sim->m[2], &st);
+    assert(st.refutations >= 1);
+    for (cauchy_node_id_t i = 1; i <= SIM_NODES; i++) {
+        assert(cauchy_membership_alive_count(sim->m[i]) == SIM_NODES - 1);
+    }
+
+    /* A graceful leave is final and needs no timeout */
+    cauchy_membership_leave(sim->m[3]);
+    sim_run(sim, 2000);
+    assert(cauchy_membership_state(sim->m[1], 3) == CAUCHY_MEMBER_LEFT);
+    assert(cauchy_membership_state(sim->m[3], 3) == CAUCHY_MEMBER_LEFT);
+
+    static const u8 junk[] = "not a swim datagram";
+    assert(cauchy_membership_receive(sim->m[1], junk, sizeof(junk), sim->now) == CAUCHY_ERR_INVALID);
+
+    sim_destroy(sim);
+    free(sim);
+}
+
+int main(void) {
+    printf("Networking Tests:\n");
+
+    RUN(merkle_order_independent);
+    RUN(ae_gset_traffic_scales_with_difference);
+    RUN(ae_orset_sees_tombstones);
+    RUN(gossip_batches_over_loopback);
+    RUN(gossip_poll_during_reservation);
+    RUN(swim_detects_failure_and_prunes);
+    RUN(swim_suspect_refutes);
+
+    printf("\nAll networking tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * CAUCHY - Register CRDT Tests
+ */
+
+#include "cauchy/cauchy.h"
+#include "cauchy/crdt/lww_register.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { printf("  %-40s", #name); test_##name(); printf("✓\n"); } while(0)
+
+TEST(lww_inline_and_blob_values) {
+    cauchy_lww_register_t a, b, c;
+    cauchy_lww_init(&a);
+    cauchy_lww_init(&b);
+    cauchy_lww_init(&c);
+    assert(sizeof(cauchy_lww_register_t) == CAUCHY_CACHE_LINE_SIZE);
+    assert(cauchy_lww_equals(&a, &b));  /* Both empty */
+
+    assert(cauchy_lww_set_string(&a, "small", 1, 1) == CAUCHY_OK);
+    assert(a.blob == NULL);
+    assert(strcmp(cauchy_lww_get_string(&a), "small") == 0);
+
+    static u8 big[64 * 1024];
+    for (usize i = 0; i < sizeof(big); i++) big[i] = (u8)(i * 7);
+    assert(cauchy_lww_set(&b, big, sizeof(big), 2, 1) == CAUCHY_OK);
+    assert(b.blob != NULL);
+
+    /* Merge and copy share the blob */
+    cauchy_lww_merge(&a, &b);
+    assert(a.blob == b.blob && cauchy_lww_equals(&a, &b));
+    cauchy_lww_copy(&c, &a);
+    cauchy_lww_fini(&b);
+    usize size;
+    const u8* v = cauchy_lww_get(&c, &size);
+    assert(size == sizeof(big) && memcmp(v, big, size) == 0);
+
+    /* A newer small value replaces the blob by value again */
+    assert(cauchy_lww_set_u64(&a, 42, 3, 1) == CAUCHY_OK);
+    assert(a.blob == NULL && cauchy_lww_get_u64(&a) == 42);
+    assert(cauchy_lww_get(&c, NULL) == v);
+
+    static u8 wire[sizeof(big) + 64];
+    usize n = cauchy_lww_serialize(&c, wire, sizeof(wire));
+    assert(n == cauchy_lww_serialized_size(&c));
+    assert(cauchy_lww_deserialize(&a, wire, n) == CAUCHY_OK);
+    assert(cauchy_lww_equals(&a, &c) && a.blob != c.blob);
+
+    assert(cauchy_lww_set(&a, big, (usize)CAUCHY_LWW_MAX_VALUE_SIZE + 1, 9, 1) == CAUCHY_ERR_FULL);
+
+    cauchy_lww_fini(&a);
+    cauchy_lww_fini(&c);
+}
+
+#define SHARED_WRITERS 3
+#define SHARED_READERS 3
+#define SHARED_WRITES  3000
+#define SHARED_VALUE   200
+
+typedef struct {
+    cauchy_lww_shared_t* shared;
+    u32                  id;
+    cauchy_atomic_u32_t* done;
+} shared_worker_t;
+
+/* Values fill every byte with the timestamp's low byte, so a torn
+ * snapshot would show up as mixed bytes */
+static void* shared_writer(void* arg) {
+    shared_worker_t* w = arg;
+    u8 value[SHARED_VALUE];
+    for (u64 i = 1; i <= SHARED_WRITES; i++) {
+        u64 ts = i * SHARED_WRITERS + w->id;
+        memset(value, (int)(ts & 0xFF), sizeof(value));
+        assert(cauchy_lww_shared_set(w->shared, value, sizeof(value) - w->id, ts, w->id + 1)
+               == CAUCHY_OK);
+    }
+    cauchy_atomic_fetch_add_u32(w->done, 1);
+    return NULL;
+}
+
+static void* shared_reader(void* arg) {
+    shared_worker_t* w = arg;
+    cauchy_lww_register_t snap;
+    cauchy_lww_init(&snap);
+    cauchy_timestamp_t last = 0;
+    while (cauchy_atomic_load_u32(w->done) < SHARED_WRITERS) {
+        cauchy_lww_shared_read(w->shared, &snap);
+        assert(snap.timestamp >= last);
+        last = snap.timestamp;
+        usize size;
+        const u8* v = cauchy_lww_get(&snap, &size);
+        if (!v) continue;
+        assert(size == SHARED_VALUE - (snap.node_id - 1));
+        for (usize i = 0; i < size; i++) assert(v[i] == (u8)(snap.timestamp & 0xFF));
+    }
+    cauchy_lww_fini(&snap);
+    return NULL;
+}
+
+TEST(lww_shared_snapshot_readers) {
+    cauchy_hazard_domain_t* domain = cauchy_hazard_domain_create();
+    cauchy_lww_shared_t shared;
+    assert(domain && cauchy_lww_shared_init(&shared, domain) == CAUCHY_OK);
+
+    cauchy_atomic_u32_t done;
+    atomic_init(&done, 0);
+    pthread_t threads[SHARED_WRITERS + SHARED_READERS];
+    shared_worker_t workers[SHARED_WRITERS + SHARED_READERS];
+    for (u32 i = 0; i < SHARED_WRITERS + SHARED_READERS; i++) {
+        bool writer = i < SHARED_WRITERS;
+        workers[i] = (shared_worker_t){ &shared, writer ? i : i - SHARED_WRITERS, &done };
+        pthread_create(&threads[i], NULL, writer ? shared_writer : shared_reader, &workers[i]);
+    }
+    for (u32 i = 0; i < SHARED_WRITERS + SHARED_READERS; i++) pthread_join(threads[i], NULL);
+
+    cauchy_lww_register_t final, older;
+    cauchy_lww_init(&final);
+    cauchy_lww_init(&older);
+    cauchy_lww_shared_read(&shared, &final);
+    assert(final.timestamp == (u64)SHARED_WRITES * SHARED_WRITERS + SHARED_WRITERS - 1);
+
+    /* Merging a stale state publishes nothing */
+    assert(cauchy_lww_set_string(&older, "stale", 1, 1) == CAUCHY_OK);
+    assert(cauchy_lww_shared_merge(&shared, &older) == CAUCHY_OK);
+    cauchy_lww_shared_read(&shared, &older);
+    assert(cauchy_lww_equals(&older, &final));
+
+    cauchy_lww_fini(&final);
+    cauchy_lww_fini(&older);
+    cauchy_lww_shared_fini(&shared);
+    cauchy_hazard_domain_destroy(domain);
+}
+
+int main(void) {
+    printf("Register CRDT Tests:\n");
+
+    RUN(lww_inline_and_blob_values);
+    RUN(lww_shared_snapshot_readers);
+
+    printf("\nAll register tests passed!\n");
+    return 0;
+}
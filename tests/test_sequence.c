@@ -0,0 +1,181 @@
+/*
+ * CAUCHY - Sequence CRDT Tests
+ */
+
+#include "cauchy/cauchy.h"
+#include "cauchy/crdt/rga.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { printf("  %-40s", #name); test_##name(); printf("✓\n"); } while(0)
+
+/* Ops emitted by a replica, as encoded bytes */
+typedef struct {
+    u8*   buf;
+    usize size;
+    usize capacity;
+    usize count;
+} op_log_t;
+
+static void log_op(void* arg, const cauchy_rga_op_t* op) {
+    op_log_t* log = arg;
+    usize need = cauchy_rga_op_encoded_size(op);
+    if (log->size + need > log->capacity) {
+        log->capacity = (log->size + need) * 2;
+        log->buf = realloc(log->buf, log->capacity);
+        assert(log->buf);
+    }
+    assert(cauchy_rga_op_encode(op, log->buf + log->size, need) == need);
+    log->size += need;
+    log->count++;
+}
+
+/* Apply every op in log from byte offset from on */
+static void replay(cauchy_rga_t* rga, const op_log_t* log, usize from) {
+    while (from < log->size) {
+        cauchy_rga_op_t op;
+        usize used;
+        assert(cauchy_rga_op_decode(&op, log->buf + from, log->size - from, &used) == CAUCHY_OK);
+        assert(cauchy_rga_apply(rga, &op) == CAUCHY_OK);
+        from += used;
+    }
+}
+
+static bool text_is(const cauchy_rga_t* rga, const char* expect) {
+    char buf[256];
+    usize n = cauchy_rga_read(rga, 0, buf, sizeof(buf));
+    return n == strlen(expect) && memcmp(buf, expect, n) == 0;
+}
+
+TEST(rga_concurrent_edits_converge) {
+    cauchy_rga_t* a = cauchy_rga_create(1);
+    cauchy_rga_t* b = cauchy_rga_create(2);
+    op_log_t la = {0}, lb = {0};
+    assert(a && b);
+
+    /* Typing appends to one block */
+    const char* hello = "hello world";
+    for (usize i = 0; i < strlen(hello); i++) {
+        assert(cauchy_rga_insert(a, i, &hello[i], 1, log_op, &la) == CAUCHY_OK);
+    }
+    assert(a->block_count == 1);
+    replay(b, &la, 0);
+    assert(text_is(b, "hello world"));
+    usize synced = la.size;
+
+    /* Concurrent inserts at the same spot: the greater id goes first
+     * (equal timestamps, so b's higher node id) */
+    assert(cauchy_rga_insert(a, 5, ",", 1, log_op, &la) == CAUCHY_OK);
+    assert(cauchy_rga_insert(b, 5, " there", 6, log_op, &lb) == CAUCHY_OK);
+    assert(cauchy_rga_delete(b, 0, 1, log_op, &lb) == CAUCHY_OK);
+    assert(cauchy_rga_insert(b, 0, "H", 1, log_op, &lb) == CAUCHY_OK);
+    replay(a, &lb, 0);
+    replay(b, &la, synced);
+    assert(cauchy_rga_equals(a, b));
+    assert(text_is(a, "Hello there, world"));
+
+    /* Old ops again change nothing; an op before its cause is refused */
+    replay(a, &lb, 0);
+    assert(cauchy_rga_equals(a, b));
+    cauchy_rga_op_t early = {
+        .type = CAUCHY_RGA_OP_INSERT,
+        .id = cauchy_uid_create(3, 100),
+        .ref = cauchy_uid_create(3, 99),
+        .len = 1,
+        .data = (const u8*)"x"
+    };
+    assert(cauchy_rga_apply(a, &early) == CAUCHY_ERR_CAUSAL);
+
+    /* Ids keep pointing at their element as text moves around them */
+    cauchy_uid_t w;
+    usize idx;
+    assert(cauchy_rga_id_at(a, 13, &w) == CAUCHY_OK);
+    assert(cauchy_rga_insert(a, 0, ">> ", 3, NULL, NULL) == CAUCHY_OK);
+    assert(cauchy_rga_index_of(a, &w, &idx) == CAUCHY_OK && idx == 16);
+
+    cauchy_rga_destroy(a);
+    cauchy_rga_destroy(b);
+    free(la.buf);
+    free(lb.buf);
+}
+
+/* Random edits on two replicas at once, checked against a flat buffer
+ * for the local side and against each other after exchanging ops */
+TEST(rga_random_edits_large_document) {
+    enum { ROUNDS = 40, EDITS = 500, DOC_MAX = 1 << 20 };
+    cauchy_rga_t* r[2] = { cauchy_rga_create(7), cauchy_rga_create(9) };
+    op_log_t logs[2] = {{0}};
+    usize synced[2] = { 0, 0 };
+    char* model = malloc(DOC_MAX);
+    char* text = malloc(DOC_MAX);
+    assert(r[0] && r[1] && model && text);
+
+    u64 rng = 12345;
+    for (int round = 0; round < ROUNDS; round++) {
+        usize model_len = cauchy_rga_length(r[0]);
+        assert(cauchy_rga_read(r[0], 0, model, DOC_MAX) == model_len);
+
+        for (int side = 0; side < 2; side++) {
+            for (int e = 0; e < EDITS; e++) {
+                rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+                usize len = cauchy_rga_length(r[side]);
+                usize pos = len ? (usize)(rng >> 33) % (len + 1) : 0;
+                if ((rng >> 20) % 4 == 0 && len > 0) {
+                    if (pos == len) pos--;
+                    usize n = (usize)((rng >> 8) % 16) + 1;
+                    if (n > len - pos) n = len - pos;
+                    assert(cauchy_rga_delete(r[side], pos, n, log_op, &logs[side]) == CAUCHY_OK);
+                    if (side == 0) {
+                        memmove(model + pos, model + pos + n, model_len - pos - n);
+                        model_len -= n;
+                    }
+                } else {
+                    char run[32];
+                    usize n = (usize)((rng >> 8) % sizeof(run)) + 1;
+                    for (usize i = 0; i < n; i++) run[i] = (char)('a' + (rng >> (i % 40)) % 26);
+                    assert(cauchy_rga_insert(r[side], pos, run, n, log_op, &logs[side]) == CAUCHY_OK);
+                    if (side == 0) {
+                        memmove(model + pos + n, model + pos, model_len - pos);
+                        memcpy(model + pos, run, n);
+                        model_len += n;
+                    }
+                }
+            }
+        }
+        assert(cauchy_rga_length(r[0]) == model_len);
+        assert(cauchy_rga_read(r[0], 0, text, DOC_MAX) == model_len);
+        assert(memcmp(text, model, model_len) == 0);
+
+        /* Exchange this round's ops */
+        usize ends[2] = { logs[0].size, logs[1].size };
+        replay(r[1], &logs[0], synced[0]);
+        replay(r[0], &logs[1], synced[1]);
+        synced[0] = ends[0];
+        synced[1] = ends[1];
+        assert(cauchy_rga_equals(r[0], r[1]));
+    }
+
+    /* Grew well past a toy size without one block per byte */
+    assert(cauchy_rga_length(r[0]) > 100000);
+    assert(r[0]->block_count < cauchy_rga_length(r[0]) / 4);
+
+    cauchy_rga_destroy(r[0]);
+    cauchy_rga_destroy(r[1]);
+    free(logs[0].buf);
+    free(logs[1].buf);
+    free(model);
+    free(text);
+}
+
+int main(void) {
+    printf("Sequence CRDT Tests:\n");
+
+    RUN(rga_concurrent_edits_converge);
+    RUN(rga_random_edits_large_document);
+
+    printf("\nAll sequence tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,1386 @@
+/*
+ * CAUCHY - Set CRDT Tests
+ */
+
+#include "cauchy/cauchy.h"
+#include "cauchy/htable.h"
+#include "cauchy/crdt/g_set.h"
+#include "cauchy/crdt/2p_set.h"
+#include "cauchy/crdt/or_set.h"
+#include "cauchy/crdt/orswot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { printf("  %-40s", #name); test_##name(); printf("✓\n"); } while(0)
+
+TEST(htable_incremental_resize) {
+    cauchy_htable_t table;
+    assert(cauchy_htable_init(&table, 4) == CAUCHY_OK);
+
+    static u64 items[4096];
+    bool saw_resize = false;
+    for (u64 i = 0; i < 4096; i++) {
+        items[i] = i;
+        /* Hashes 0 and 1 collide with the reserved slot values */
+        assert(cauchy_htable_insert(&table, i % 512, &items[i]) == CAUCHY_OK);
+        if (table.old.slots) {
+            saw_resize = true;
+            /* Items still waiting in the old array stay reachable */
+            cauchy_htable_probe_t probe;
+            cauchy_htable_probe_init(&probe, &table, 5);
+            usize hits = 0;
+            while (cauchy_htable_probe_next(&probe)) hits++;
+            assert(hits == (i < 5 ? 0 : (i - 5) / 512 + 1));
+        }
+    }
+    assert(saw_resize);
+    assert(cauchy_htable_count(&table) == 4096);
+
+    for (u64 i = 0; i < 4096; i += 2) {
+        assert(cauchy_htable_remove(&table, i % 512, &items[i]));
+    }
+    assert(!cauchy_htable_remove(&table, 0, &items[0]));
+    assert(cauchy_htable_count(&table) == 2048);
+
+    cauchy_htable_iter_t iter;
+    cauchy_htable_iter_init(&iter, &table);
+    usize seen = 0;
+    u64* item;
+    while ((item = cauchy_htable_iter_next(&iter)) != NULL) {
+        assert(*item % 2 == 1);
+        seen++;
+    }
+    assert(seen == 2048);
+
+    cauchy_htable_destroy(&table);
+}
+
+TEST(gset_grow_and_merge) {
+    cauchy_gset_t* a = cauchy_gset_create(4);
+    cauchy_gset_t* b = cauchy_gset_create(4);
+    char buf[32];
+
+    for (int i = 0; i < 1000; i++) {
+        snprintf(buf, sizeof(buf), "elem-%d", i);
+        assert(cauchy_gset_add_string(i % 2 ? a : b, buf) == CAUCHY_OK);
+        assert(cauchy_gset_add_string(i % 2 ? a : b, buf) == CAUCHY_OK);
+    }
+    assert(cauchy_gset_count(a) == 500);
+    assert(cauchy_gset_count(b) == 500);
+
+    assert(cauchy_gset_merge(a, b) == CAUCHY_OK);
+    assert(cauchy_gset_count(a) == 1000);
+    assert(cauchy_gset_subset(b, a));
+    assert(!cauchy_gset_subset(a, b));
+
+    assert(cauchy_gset_merge(b, a) == CAUCHY_OK);
+    assert(cauchy_gset_equals(a, b));
+
+    usize n = 0;
+    cauchy_gset_iter_t iter;
+    cauchy_gset_iter_init(&iter, a);
+    const void* data;
+    usize size;
+    while (cauchy_gset_iter_next(&iter, &data, &size)) {
+        assert(cauchy_gset_contains(b, data, size));
+        n++;
+    }
+    assert(n == 1000);
+
+    cauchy_gset_destroy(a);
+    cauchy_gset_destroy(b);
+}
+
+TEST(gset_inline_and_arena_payloads) {
+    cauchy_gset_t* set = cauchy_gset_create(8);
+    u8 small[CAUCHY_GSET_INLINE_SIZE];
+    u8 large[3000];
+    memset(small, 0xAB, sizeof(small));
+
+    for (int i = 0; i < 64; i++) {
+        memset(large, i, sizeof(large));
+        assert(cauchy_gset_add(set, large, (usize)(100 + i * 40)) == CAUCHY_OK);
+    }
+    assert(cauchy_gset_add(set, small, sizeof(small)) == CAUCHY_OK);
+    assert(set->payloads.reserved > 0);
+
+    for (int i = 0; i < 64; i++) {
+        memset(large, i, sizeof(large));
+        assert(cauchy_gset_contains(set, large, (usize)(100 + i * 40)));
+    }
+    assert(cauchy_gset_contains(set, small, sizeof(small)));
+    assert(cauchy_gset_count(set) == 65);
+
+    cauchy_gset_destroy(set);
+}
+
+TEST(twopset_remove_wins) {
+    cauchy_2pset_t* a = cauchy_2pset_create(8);
+    cauchy_2pset_t* b = cauchy_2pset_create(8);
+
+    assert(cauchy_2pset_add_string(a, "x") == CAUCHY_OK);
+    assert(cauchy_2pset_add_string(a, "y") == CAUCHY_OK);
+    assert(cauchy_2pset_merge(b, a) == CAUCHY_OK);
+    assert(cauchy_2pset_remove_string(b, "x") == CAUCHY_OK);
+
+    assert(cauchy_2pset_merge(a, b) == CAUCHY_OK);
+    assert(!cauchy_2pset_contains_string(a, "x"));
+    assert(cauchy_2pset_contains_string(a, "y"));
+    assert(cauchy_2pset_count(a) == 1);
+    assert(cauchy_2pset_equals(a, b));
+
+    cauchy_2pset_destroy(a);
+    cauchy_2pset_destroy(b);
+}
+
+TEST(orset_add_wins) {
+    cauchy_orset_t* a = cauchy_orset_create(4, 1);
+    cauchy_orset_t* b = cauchy_orset_create(4, 2);
+    char buf[32];
+
+    for (int i = 0; i < 300; i++) {
+        snprintf(buf, sizeof(buf), "item-%d", i);
+        assert(cauchy_orset_add_string(a, buf) == CAUCHY_OK);
+    }
+    assert(cauchy_orset_merge(b, a) == CAUCHY_OK);
+    assert(cauchy_orset_contains_string(b, "item-299"));
+
+    /* Concurrent remove on a, re-add on b: the new tag survives */
+    assert(cauchy_orset_remove_string(a, "item-7") == CAUCHY_OK);
+    assert(cauchy_orset_add_string(b, "item-7") == CAUCHY_OK);
+    assert(cauchy_orset_remove_string(a, "missing") == CAUCHY_ERR_NOTFOUND);
+
+    assert(cauchy_orset_merge(a, b) == CAUCHY_OK);
+    assert(cauchy_orset_merge(b, a) == CAUCHY_OK);
+    assert(cauchy_orset_contains_string(a, "item-7"));
+    assert(cauchy_orset_contains_string(b, "item-7"));
+    assert(cauchy_orset_equals(a, b));
+    assert(a->entry_count == 301);
+
+    cauchy_orset_destroy(a);
+    cauchy_orset_destroy(b);
+}
+
+/* Replicas that exchange only delta-groups end up equal to a full merge */
+TEST(orset_delta_sync) {
+    cauchy_orset_t* a = cauchy_orset_create(4, 1);
+    cauchy_orset_t* b = cauchy_orset_create(4, 2);
+    cauchy_orset_t* group = cauchy_orset_create(4, 1);
+    char buf[32];
+
+    for (int i = 0; i < 1000; i++) {
+        snprintf(buf, sizeof(buf), "item-%d", i);
+        assert(cauchy_orset_add_string(a, buf) == CAUCHY_OK);
+    }
+    assert(cauchy_orset_merge(b, a) == CAUCHY_OK);
+
+    /* A handful of updates after the sync: the group stays that small */
+    assert(cauchy_orset_add_delta(a, "new", 4, group) == CAUCHY_OK);
+    assert(cauchy_orset_remove_delta(a, "item-3", 7, group) == CAUCHY_OK);
+    assert(cauchy_orset_remove_delta(a, "new", 4, group) == CAUCHY_OK);
+    assert(cauchy_orset_remove_delta(a, "missing", 8, group) == CAUCHY_ERR_NOTFOUND);
+    assert(group->entry_count == 2);
+    assert(group->active_count == 0);
+
+    assert(cauchy_orset_merge_delta(b, group) == CAUCHY_OK);
+    assert(!cauchy_orset_contains_string(b, "item-3"));
+    assert(!cauchy_orset_contains_string(b, "new"));
+    assert(cauchy_orset_equals(a, b));
+
+    /* Redelivery is harmless */
+    assert(cauchy_orset_merge_delta(b, group) == CAUCHY_OK);
+    assert(cauchy_orset_equals(a, b));
+
+    cauchy_orset_destroy(a);
+    cauchy_orset_destroy(b);
+    cauchy_orset_destroy(group);
+}
+
+TEST(twopset_delta_sync) {
+    cauchy_2pset_t* a = cauchy_2pset_create(4);
+    cauchy_2pset_t* b = cauchy_2pset_create(4);
+    cauchy_2pset_t* d1 = cauchy_2pset_create(4);
+    cauchy_2pset_t* d2 = cauchy_2pset_create(4);
+
+    assert(cauchy_2pset_add_delta(a, "x", 2, d1) == CAUCHY_OK);
+    assert(cauchy_2pset_add_delta(a, "y", 2, d1) == CAUCHY_OK);
+    assert(cauchy_2pset_add_delta(a, "x", 2, d1) == CAUCHY_OK);
+    assert(cauchy_gset_count(d1->added) == 2);
+    assert(cauchy_2pset_remove_delta(a, "x", 2, d2) == CAUCHY_OK);
+    assert(cauchy_2pset_remove_delta(a, "z", 2, d2) == CAUCHY_ERR_NOTFOUND);
+    assert(cauchy_gset_count(d2->added) == 0);
+
+    /* Deltas may arrive out of order and be joined into one group */
+    assert(cauchy_2pset_merge_delta(b, d2) == CAUCHY_OK);
+    assert(cauchy_2pset_merge_delta(d2, d1) == CAUCHY_OK);
+    assert(cauchy_2pset_merge_delta(b, d2) == CAUCHY_OK);
+    assert(cauchy_2pset_equals(a, b));
+    assert(!cauchy_2pset_contains(b, "x", 2));
+    assert(cauchy_2pset_contains(b, "y", 2));
+
+    cauchy_2pset_destroy(a);
+    cauchy_2pset_destroy(b);
+    cauchy_2pset_destroy(d1);
+    cauchy_2pset_destroy(d2);
+}
+
+/* Shopping-cart churn: tombstones vanish once every replica has them */
+TEST(orset_stable_tombstone_gc) {
+    cauchy_orset_t* r[3];
+    for (int i = 0; i < 3; i++) {
+        r[i] = cauchy_orset_create(16, (cauchy_node_id_t)(i + 1));
+        assert(cauchy_orset_enable_digest(r[i], 8) == CAUCHY_OK);
+    }
+    char buf[32];
+    for (int round = 0; round < 20; round++) {
+        for (int i = 0; i < 100; i++) {
+            snprintf(buf, sizeof(buf), "sku-%d", i);
+            cauchy_orset_t* s = r[(round + i) % 3];
+            assert(cauchy_orset_add_string(s, buf) == CAUCHY_OK);
+            if (round < 19 || i % 2) assert(cauchy_orset_remove_string(s, buf) == CAUCHY_OK);
+        }
+    }
+    /* A stale full-state copy of replica 2, taken once it had everything */
+    cauchy_orset_t* stale = cauchy_orset_create(16, 3);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) cauchy_orset_merge(r[i], r[j]);
+    }
+    cauchy_orset_merge(stale, r[2]);
+    assert(r[0]->entry_count == 2000 && r[0]->active_count == 50);
+
+    cauchy_vclock_t stable;
+    assert(cauchy_vclock_copy(&stable, cauchy_orset_clock(r[0])) == CAUCHY_OK);
+    for (int i = 1; i < 3; i++) cauchy_vclock_min(&stable, cauchy_orset_clock(r[i]));
+
+    /* Incremental passes with a small slot budget add up to a full one */
+    usize dropped = 0, calls = 0;
+    do {
+        dropped += cauchy_orset_gc(r[0], &stable, 64);
+        calls++;
+    } while (r[0]->gc_cursor != 0);
+    assert(calls > 1);
+    assert(dropped == 1950);
+    assert(r[0]->entry_count == 50 && r[0]->active_count == 50);
+    assert(cauchy_orset_gc(r[1], &stable, 0) == 1950);
+    assert(cauchy_orset_gc(r[1], &stable, 0) == 0);
+
+    /* Old tombstones and live copies of collected tags stay out */
+    assert(cauchy_orset_merge(r[0], stale) == CAUCHY_OK);
+    assert(cauchy_orset_merge(r[0], r[2]) == CAUCHY_OK);
+    assert(r[0]->entry_count == 50);
+    assert(cauchy_merkle_root(cauchy_orset_digest(r[0])) ==
+           cauchy_merkle_root(cauchy_orset_digest(r[1])));
+    assert(cauchy_orset_contains_string(r[0], "sku-2"));
+    assert(!cauchy_orset_contains_string(r[0], "sku-1"));
+
+    /* New operations above the frontier still replicate */
+    assert(cauchy_orset_add_string(r[2], "sku-1") == CAUCHY_OK);
+    assert(cauchy_orset_remove_string(r[2], "sku-2") == CAUCHY_OK);
+    assert(cauchy_orset_merge(r[0], r[2]) == CAUCHY_OK);
+    assert(cauchy_orset_contains_string(r[0], "sku-1"));
+    assert(!cauchy_orset_contains_string(r[0], "sku-2"));
+
+    cauchy_vclock_fini(&stable);
+    cauchy_orset_destroy(stale);
+    for (int i = 0; i < 3; i++) cauchy_orset_destroy(r[i]);
+}
+
+TEST(twopset_compaction) {
+    cauchy_2pset_t* a = cauchy_2pset_create(8);
+    cauchy_2pset_t* b = cauchy_2pset_create(8);
+    char buf[32];
+
+    for (int i = 0; i < 1000; i++) {
+        snprintf(buf, sizeof(buf), "e-%d", i);
+        assert(cauchy_2pset_add_string(a, buf) == CAUCHY_OK);
+        if (i % 10) assert(cauchy_2pset_remove_string(a, buf) == CAUCHY_OK);
+    }
+    /* Tombstones merge first, so the receiving side never copies them */
+    assert(cauchy_2pset_merge(b, a) == CAUCHY_OK);
+    assert(cauchy_gset_count(b->added) == 100);
+
+    usize dropped = 0;
+    do {
+        dropped += cauchy_2pset_compact(a, 128);
+    } while (a->gc_cursor != 0);
+    assert(dropped == 900);
+    assert(cauchy_gset_count(a->added) == 100);
+    assert(cauchy_2pset_count(a) == 100);
+    assert(cauchy_2pset_equals(a, b));
+
+    /* Removal still reads as removed, and the element stays out */
+    assert(cauchy_2pset_was_added(a, "e-1", 4));
+    assert(cauchy_2pset_was_removed(a, "e-1", 4));
+    assert(cauchy_2pset_remove_string(a, "e-1") == CAUCHY_OK);
+    assert(cauchy_2pset_add_string(a, "e-1") == CAUCHY_OK);
+    assert(!cauchy_2pset_contains_string(a, "e-1"));
+
+    /* Merging a replica that still holds the copies does not bring them back */
+    cauchy_2pset_t* old = cauchy_2pset_create(8);
+    assert(cauchy_gset_merge(old->added, b->removed) == CAUCHY_OK);
+    assert(cauchy_gset_merge(old->removed, b->removed) == CAUCHY_OK);
+    assert(cauchy_2pset_merge(a, old) == CAUCHY_OK);
+    assert(cauchy_gset_count(a->added) == 100);
+    assert(cauchy_2pset_compact(old, 0) == 900);
+    assert(cauchy_2pset_equals(a, b));
+    cauchy_2pset_destroy(old);
+
+    cauchy_2pset_destroy(a);
+    cauchy_2pset_destroy(b);
+}
+
+/* Re-adds replace dots instead of piling up entries; removes leave nothing */
+TEST(orswot_one_entry_per_element) {
+    cauchy_orswot_t* a = cauchy_orswot_create(16, 1);
+    cauchy_orswot_t* b = cauchy_orswot_create(16, 2);
+
+    for (int i = 0; i < 1000; i++) assert(cauchy_orswot_add_string(a, "cart") == CAUCHY_OK);
+    assert(cauchy_htable_count(&a->index) == 1);
+    assert(cauchy_vclock_get(cauchy_orswot_clock(a), 1) == 1000);
+    assert(cauchy_orswot_remove_string(a, "cart") == CAUCHY_OK);
+    assert(cauchy_orswot_remove_string(a, "cart") == CAUCHY_ERR_NOTFOUND);
+    assert(cauchy_htable_count(&a->index) == 0);
+
+    /* Concurrent remove and re-add: the unseen dot survives */
+    assert(cauchy_orswot_add_string(a, "x") == CAUCHY_OK);
+    assert(cauchy_orswot_add_string(a, "y") == CAUCHY_OK);
+    assert(cauchy_orswot_merge(b, a) == CAUCHY_OK);
+    assert(cauchy_orswot_remove_string(a, "x") == CAUCHY_OK);
+    assert(cauchy_orswot_remove_string(a, "y") == CAUCHY_OK);
+    assert(cauchy_orswot_add_string(b, "x") == CAUCHY_OK);
+    assert(cauchy_orswot_merge(a, b) == CAUCHY_OK);
+    assert(cauchy_orswot_merge(b, a) == CAUCHY_OK);
+    assert(cauchy_orswot_contains_string(a, "x") && cauchy_orswot_contains_string(b, "x"));
+    assert(!cauchy_orswot_contains_string(a, "y") && !cauchy_orswot_contains_string(b, "y"));
+    assert(cauchy_orswot_equals(a, b));
+    assert(cauchy_htable_count(&b->index) == 1);
+
+    /* Concurrent adds keep both dots until one side removes both */
+    assert(cauchy_orswot_add_string(a, "z") == CAUCHY_OK);
+    assert(cauchy_orswot_add_string(b, "z") == CAUCHY_OK);
+    assert(cauchy_orswot_merge(a, b) == CAUCHY_OK);
+    const char z[] = "z";
+    assert(a->active_count == 2);
+    assert(cauchy_orswot_remove(a, z, sizeof(z)) == CAUCHY_OK);
+    assert(cauchy_orswot_merge(b, a) == CAUCHY_OK);
+    assert(!cauchy_orswot_contains_string(b, "z"));
+    assert(cauchy_orswot_count(b) == 1);
+
+    cauchy_orswot_destroy(a);
+    cauchy_orswot_destroy(b);
+}
+
+TEST(orswot_delta_sync) {
+    cauchy_orswot_t* a = cauchy_orswot_create(4, 1);
+    cauchy_orswot_t* b = cauchy_orswot_create(4, 2);
+    cauchy_orswot_t* group = cauchy_orswot_create(4, 1);
+    char buf[32];
+
+    for (int i = 0; i < 1000; i++) {
+        snprintf(buf, sizeof(buf), "item-%d", i);
+        assert(cauchy_orswot_add_string(a, buf) == CAUCHY_OK);
+    }
+    assert(cauchy_orswot_merge(b, a) == CAUCHY_OK);
+    assert(cauchy_orswot_equals(a, b));
+
+    assert(cauchy_orswot_add_delta(a, "new", 4, group) == CAUCHY_OK);
+    assert(cauchy_orswot_add_delta(a, "item-5", 7, group) == CAUCHY_OK);
+    assert(cauchy_orswot_remove_delta(a, "item-3", 7, group) == CAUCHY_OK);
+    assert(cauchy_orswot_remove_delta(a, "new", 4, group) == CAUCHY_OK);
+    assert(cauchy_orswot_remove_delta(a, "missing", 8, group) == CAUCHY_ERR_NOTFOUND);
+    /* Three elements named, one of them still present */
+    assert(cauchy_htable_count(&group->index) == 3);
+    assert(cauchy_orswot_count(group) == 1);
+
+    assert(cauchy_orswot_merge_delta(b, group) == CAUCHY_OK);
+    assert(!cauchy_orswot_contains_string(b, "item-3"));
+    assert(!cauchy_orswot_contains_string(b, "new"));
+    assert(cauchy_orswot_contains_string(b, "item-5"));
+    assert(cauchy_orswot_equals(a, b));
+    assert(cauchy_htable_count(&b->index) == 999);
+    assert(b->context.cloud_count == 0);
+
+    /* Redelivery is harmless, and a full merge agrees */
+    assert(cauchy_orswot_merge_delta(b, group) == CAUCHY_OK);
+    assert(cauchy_orswot_merge(b, a) == CAUCHY_OK);
+    assert(cauchy_orswot_equals(a, b));
+
+    /* A replica that missed the earlier adds holds the delta's dots as a cloud */
+    cauchy_orswot_t* c = cauchy_orswot_create(4, 3);
+    assert(cauchy_orswot_merge_delta(c, group) == CAUCHY_OK);
+    assert(cauchy_orswot_count(c) == 1 && c->context.cloud_count > 0);
+    assert(cauchy_orswot_merge(c, a) == CAUCHY_OK);
+    assert(cauchy_orswot_equals(a, c));
+    assert(c->context.cloud_count == 0);
+
+    cauchy_orswot_destroy(a);
+    cauchy_orswot_destroy(b);
+    cauchy_orswot_destroy(c);
+    cauchy_orswot_destroy(group);
+}
+
+TEST(set_batch_operations) {
+    enum { N = 1000 };
+    static char keys[N][24];
+    static cauchy_bytes_t items[N];
+    static cauchy_result_t results[N];
+    static bool found[N];
+    static u64 hashes[N];
+    for (int i = 0; i < N; i++) {
+        /* Lengths vary so lockstep hashing runs ragged tails */
+        int len = snprintf(keys[i], sizeof(keys[i]), "key-%0*d", 1 + i % 9, i);
+        items[i] = (cauchy_bytes_t){ keys[i], (usize)len };
+    }
+    cauchy_hash_batch(items, N, hashes);
+    for (int i = 0; i < N; i++) assert(hashes[i] == cauchy_hash_bytes(keys[i], items[i].size));
+
+    /* Load every even key; a batch may repeat itself and hold bad items */
+    cauchy_bytes_t half[N / 2 + 2];
+    for (int i = 0; i < N / 2; i++) half[i] = items[2 * i];
+    half[N / 2] = items[0];
+    half[N / 2 + 1] = (cauchy_bytes_t){ NULL, 0 };
+
+    cauchy_gset_t* g = cauchy_gset_create(0);
+    assert(cauchy_gset_add_batch(g, half, N / 2 + 2, results) == CAUCHY_ERR_INVALID);
+    assert(results[N / 2] == CAUCHY_OK && results[N / 2 + 1] == CAUCHY_ERR_INVALID);
+    assert(cauchy_gset_count(g) == N / 2);
+    assert(cauchy_gset_contains_batch(g, items, N, found) == N / 2);
+    for (int i = 0; i < N; i++) assert(found[i] == (i % 2 == 0));
+    cauchy_gset_destroy(g);
+
+    cauchy_orset_t* o = cauchy_orset_create(0, 1);
+    assert(cauchy_orset_add_batch(o, items, N, NULL) == CAUCHY_OK);
+    assert(cauchy_orset_remove_batch(o, half, N / 2, results) == CAUCHY_OK);
+    assert(cauchy_orset_remove_batch(o, half, 2, results) == CAUCHY_ERR_NOTFOUND);
+    assert(cauchy_orset_count(o) == N / 2);
+    assert(cauchy_orset_contains_batch(o, items, N, found) == N / 2);
+    for (int i = 0; i < N; i++) assert(found[i] == (i % 2 == 1));
+    cauchy_orset_destroy(o);
+
+    /* Removed items stay out of a 2P-Set, even when added again */
+    cauchy_2pset_t* t = cauchy_2pset_create(0);
+    assert(cauchy_2pset_remove_batch(t, items, 1, results) == CAUCHY_ERR_NOTFOUND);
+    assert(cauchy_2pset_add_batch(t, items, N, NULL) == CAUCHY_OK);
+    assert(cauchy_2pset_remove_batch(t, half, N / 2, NULL) == CAUCHY_OK);
+    assert(cauchy_2pset_add_batch(t, half, N / 2, NULL) == CAUCHY_OK);
+    assert(cauchy_2pset_contains_batch(t, items, N, found) == N / 2);
+    for (int i = 0; i < N; i++) assert(found[i] == cauchy_2pset_contains(t, keys[i], items[i].size));
+    assert(cauchy_2pset_count(t) == N / 2);
+    cauchy_2pset_destroy(t);
+}
+
+/* Merges are accounted per CRDT type, with the tombstones they carry */
+TEST(set_merge_stats) {
+    cauchy_2pset_t* a = cauchy_2pset_create(4);
+    cauchy_2pset_t* b = cauchy_2pset_create(4);
+    assert(cauchy_2pset_add(a, "x", 2) == CAUCHY_OK);
+    assert(cauchy_2pset_add(a, "y", 2) == CAUCHY_OK);
+    assert(cauchy_2pset_remove(a, "x", 2) == CAUCHY_OK);
+
+    cauchy_stats_t before, after;
+    cauchy_stats_snapshot(&before);
+    assert(cauchy_2pset_merge(b, a) == CAUCHY_OK);
+    cauchy_stats_snapshot(&after);
+
+#ifdef CAUCHY_STATS
+    const cauchy_merge_stats_t* m0 = &before.merge[CAUCHY_STAT_CRDT_2PSET];
+    const cauchy_merge_stats_t* m1 = &after.merge[CAUCHY_STAT_CRDT_2PSET];
+    assert(m1->merges == m0->merges + 1);
+    assert(m1->tombstones == m0->tombstones + 1);
+    assert(m1->entries == m0->entries + 2);
+    assert(after.merge[CAUCHY_STAT_CRDT_GSET].merges == before.merge[CAUCHY_STAT_CRDT_GSET].merges);
+    cauchy_merge_stats_t delta = { 1, 0, 0, m1->entries - m0->entries,
+                                   m1->tombstones - m0->tombstones };
+    assert(cauchy_stats_tombstone_ratio(&delta) == 0.5);
+#else
+    assert(after.merge[CAUCHY_STAT_CRDT_2PSET].merges == 0);
+#endif
+
+    cauchy_2pset_destroy(a);
+    cauchy_2pset_destroy(b);
+}
+
+static void snapshot_path(char* buf, usize size, const char* name) {
+    snprintf(buf, size, "/tmp/cauchy-%s-%d.snap", name, (int)getpid());
+}
+
+TEST(gset_snapshot_mapped) {
+    char path[64];
+    snapshot_path(path, sizeof(path), "gset");
+
+    cauchy_gset_t* g = cauchy_gset_create(16);
+    cauchy_2pset_t* tp = cauchy_2pset_create(16);
+    char buf[96];
+    for (int i = 0; i < 500; i++) {
+        /* Every tenth element is too large to store inline */
+        int len = snprintf(buf, sizeof(buf), i % 10 ? "e%d" : "%064d", i);
+        assert(cauchy_gset_add(g, buf, (usize)len) == CAUCHY_OK);
+        assert(cauchy_2pset_add(tp, buf, (usize)len) == CAUCHY_OK);
+        if (i % 2 == 0) assert(cauchy_2pset_remove(tp, buf, (usize)len) == CAUCHY_OK);
+    }
+    cauchy_snapshot_writer_t* w = cauchy_snapshot_writer_create(path);
+    assert(w);
+    assert(cauchy_gset_snapshot_save(g, w, 1) == CAUCHY_OK);
+    assert(cauchy_gset_snapshot_save(g, w, 1) == CAUCHY_ERR_EXISTS);
+    assert(cauchy_2pset_snapshot_save(tp, w, 1) == CAUCHY_OK);
+    /* A 2P-Set section covering more elements than it holds */
+    assert(cauchy_snapshot_writer_begin(w, CAUCHY_SNAPSHOT_2P_SET, 2) == CAUCHY_OK);
+    assert(cauchy_gset_snapshot_put(tp->added, w) == CAUCHY_OK);
+    u64 removed_at = cauchy_snapshot_writer_offset(w);
+    assert(cauchy_gset_snapshot_put(tp->removed, w) == CAUCHY_OK);
+    assert(cauchy_snapshot_writer_put_u64(w, 100000) == CAUCHY_OK);
+    assert(cauchy_snapshot_writer_put_u64(w, 0) == CAUCHY_OK);
+    assert(cauchy_snapshot_writer_put_u64(w, removed_at) == CAUCHY_OK);
+    assert(cauchy_snapshot_writer_end(w) == CAUCHY_OK);
+    assert(cauchy_snapshot_writer_commit(w) == CAUCHY_OK);
+
+    cauchy_snapshot_t* snap;
+    assert(cauchy_snapshot_open(path, &snap) == CAUCHY_OK);
+    assert(cauchy_snapshot_section_count(snap) == 3);
+
+    /* Served from the mapping: nothing lands in the heap index */
+    cauchy_gset_t* lg = cauchy_gset_create(16);
+    assert(cauchy_gset_snapshot_load(lg, snap, 2) == CAUCHY_ERR_NOTFOUND);
+    assert(cauchy_gset_snapshot_load(lg, snap, 1) == CAUCHY_OK);
+    assert(cauchy_gset_snapshot_load(lg, snap, 1) == CAUCHY_ERR_EXISTS);
+    assert(cauchy_htable_count(&lg->index) == 0);
+    assert(cauchy_gset_count(lg) == 500);
+    assert(cauchy_gset_equals(lg, g) && cauchy_gset_equals(g, lg));
+    assert(cauchy_gset_contains(lg, "e7", 2));
+    int len = snprintf(buf, sizeof(buf), "%064d", 30);
+    assert(cauchy_gset_contains(lg, buf, (usize)len));
+    assert(!cauchy_gset_contains(lg, "e10", 3));
+
+    /* Re-adding a mapped element is a no-op; new ones go to the heap */
+    assert(cauchy_gset_add(lg, "e7", 2) == CAUCHY_OK);
+    assert(cauchy_gset_add(lg, "fresh", 5) == CAUCHY_OK);
+    assert(cauchy_htable_count(&lg->index) == 1);
+    assert(cauchy_gset_count(lg) == 501);
+
+    usize seen = 0;
+    cauchy_gset_iter_t it;
+    cauchy_gset_iter_init(&it, lg);
+    const void* data;
+    usize size;
+    while (cauchy_gset_iter_next(&it, &data, &size)) {
+        assert(cauchy_gset_contains(lg, data, size));
+        seen++;
+    }
+    assert(seen == 501);
+
+    cauchy_gset_t* copy = cauchy_gset_create(16);
+    assert(cauchy_gset_merge(copy, lg) == CAUCHY_OK);
+    assert(cauchy_gset_equals(copy, lg));
+    usize wire = cauchy_gset_serialized_size(lg);
+    u8* bytes = malloc(wire);
+    assert(cauchy_gset_serialize(lg, bytes, wire) == wire);
+    cauchy_gset_t* decoded = cauchy_gset_create(16);
+    assert(cauchy_gset_deserialize(decoded, bytes, wire) == CAUCHY_OK);
+    assert(cauchy_gset_equals(decoded, lg));
+    free(bytes);
+
+    /* 2P-Set halves both map; compaction drops mapped copies */
+    cauchy_2pset_t* ltp = cauchy_2pset_create(16);
+    assert(cauchy_2pset_snapshot_load(ltp, snap, 2) == CAUCHY_ERR_INVALID);
+    assert(ltp->added->snapshot == NULL && ltp->removed->snapshot == NULL);
+    assert(cauchy_2pset_snapshot_load(ltp, snap, 1) == CAUCHY_OK);
+    assert(cauchy_2pset_equals(ltp, tp));
+    assert(cauchy_2pset_count(ltp) == 250);
+    assert(!cauchy_2pset_contains_string(ltp, "e2") && !cauchy_gset_contains(ltp->removed, "e3", 2));
+    assert(cauchy_2pset_contains(ltp, "e3", 2));
+    assert(cauchy_2pset_add(ltp, "e2", 2) == CAUCHY_OK);
+    assert(!cauchy_2pset_contains(ltp, "e2", 2));
+    assert(cauchy_2pset_compact(ltp, 0) == 250);
+    assert(cauchy_gset_count(ltp->added) == 250);
+    assert(cauchy_2pset_contains(ltp, "e3", 2) && !cauchy_2pset_contains(ltp, "e2", 2));
+
+    /* Loaded sets keep the mapping alive after the caller's reference */
+    cauchy_snapshot_release(snap);
+    assert(cauchy_gset_contains(lg, "e9", 2));
+    cauchy_gset_destroy(lg);
+    cauchy_2pset_destroy(ltp);
+    cauchy_gset_destroy(copy);
+    cauchy_gset_destroy(decoded);
+    cauchy_gset_destroy(g);
+    cauchy_2pset_destroy(tp);
+    unlink(path);
+}
+
+TEST(orset_snapshot_copy_on_write) {
+    char path[64];
+    snapshot_path(path, sizeof(path), "orset");
+
+    cauchy_orset_t* a = cauchy_orset_create(16, 1);
+    cauchy_orset_t* b = cauchy_orset_create(16, 2);
+    char buf[96];
+    for (int i = 0; i < 200; i++) {
+        int len = snprintf(buf, sizeof(buf), i % 10 ? "x%d" : "%060d", i);
+        assert(cauchy_orset_add(a, buf, (usize)len) == CAUCHY_OK);
+    }
+    for (int i = 0; i < 200; i += 4) {
+        int len = snprintf(buf, sizeof(buf), i % 10 ? "x%d" : "%060d", i);
+        assert(cauchy_orset_remove(a, buf, (usize)len) == CAUCHY_OK);
+    }
+    cauchy_orswot_t* sw = cauchy_orswot_create(16, 1);
+    assert(cauchy_orswot_add_string(sw, "kept") == CAUCHY_OK);
+    assert(cauchy_orswot_add_string(sw, "dropped") == CAUCHY_OK);
+    assert(cauchy_orswot_remove_string(sw, "dropped") == CAUCHY_OK);
+
+    cauchy_snapshot_writer_t* w = cauchy_snapshot_writer_create(path);
+    assert(cauchy_orset_snapshot_save(a, w, 7) == CAUCHY_OK);
+    assert(cauchy_orswot_snapshot_save(sw, w, 7) == CAUCHY_OK);
+    /* ORSWOT sections whose second entry has the wrong stored hash (8)
+     * or repeats the first (9) */
+    cauchy_vclock_t cc;
+    cauchy_vclock_init(&cc, 4);
+    assert(cauchy_vclock_set(&cc, 3, 9) == CAUCHY_OK);
+    for (u64 bad = 8; bad <= 9; bad++) {
+        assert(cauchy_snapshot_writer_begin(w, CAUCHY_SNAPSHOT_ORSWOT, bad) == CAUCHY_OK);
+        assert(cauchy_snapshot_writer_put_u64(w, 0) == CAUCHY_OK);
+        assert(cauchy_snapshot_writer_put_vclock(w, &cc) == CAUCHY_OK);
+        assert(cauchy_snapshot_writer_put_blob(w, NULL, 0) == CAUCHY_OK);
+        assert(cauchy_snapshot_writer_put_u64(w, 2) == CAUCHY_OK);
+        for (u64 i = 0; i < 2; i++) {
+            cauchy_uid_t dot = cauchy_uid_create(3, i + 1);
+            u64 head[3] = { cauchy_hash_bytes("ab", 2) + (bad == 8 ? i : 0), 2, 1 };
+            assert(cauchy_snapshot_writer_put(w, head, sizeof(head)) == CAUCHY_OK);
+            assert(cauchy_snapshot_writer_put(w, &dot, sizeof(dot)) == CAUCHY_OK);
+            assert(cauchy_snapshot_writer_put_blob(w, bad == 8 && i ? "cd" : "ab", 2) == CAUCHY_OK);
+        }
+        assert(cauchy_snapshot_writer_end(w) == CAUCHY_OK);
+    }
+    cauchy_vclock_fini(&cc);
+    assert(cauchy_snapshot_writer_commit(w) == CAUCHY_OK);
+
+    cauchy_snapshot_t* snap;
+    assert(cauchy_snapshot_open(path, &snap) == CAUCHY_OK);
+    cauchy_orset_t* la = cauchy_orset_create(16, 1);
+    assert(cauchy_orset_snapshot_load(la, snap, 7) == CAUCHY_OK);
+    assert(cauchy_htable_count(&la->index) == 0);
+    assert(la->entry_count == 200 && cauchy_orset_count(la) == 150);
+    assert(cauchy_orset_equals(la, a) && cauchy_orset_equals(a, la));
+    assert(cauchy_orset_contains(la, "x1", 2) && !cauchy_orset_contains(la, "x4", 2));
+    assert(cauchy_vclock_compare(cauchy_orset_clock(la), cauchy_orset_clock(a)) == CAUCHY_EQUAL);
+
+    /* A remove copies just the touched entry out of the mapping */
+    assert(cauchy_orset_remove(la, "x1", 2) == CAUCHY_OK);
+    assert(cauchy_htable_count(&la->index) == 1);
+    assert(!cauchy_orset_contains(la, "x1", 2));
+    assert(cauchy_orset_remove(la, "x1", 2) == CAUCHY_ERR_NOTFOUND);
+    int len = snprintf(buf, sizeof(buf), "%060d", 10);
+    assert(cauchy_orset_remove(la, buf, (usize)len) == CAUCHY_OK);
+    assert(cauchy_htable_count(&la->index) == 2 && cauchy_orset_count(la) == 148);
+
+    /* New tags continue past the saved counter */
+    assert(cauchy_orset_add(la, "x1", 2) == CAUCHY_OK);
+    assert(cauchy_orset_contains(la, "x1", 2));
+
+    /* Merges both ways: mapped entries as sources, and as targets */
+    assert(cauchy_orset_merge(b, la) == CAUCHY_OK);
+    assert(cauchy_orset_equals(b, la));
+    assert(cauchy_orset_remove(b, "x3", 2) == CAUCHY_OK);
+    assert(cauchy_orset_merge(la, b) == CAUCHY_OK);
+    assert(!cauchy_orset_contains(la, "x3", 2));
+    assert(cauchy_orset_equals(b, la));
+
+    /* Stable base tombstones are collected without being copied */
+    usize heap = cauchy_htable_count(&la->index);
+    usize entries = la->entry_count;
+    assert(cauchy_orset_gc(la, cauchy_orset_clock(la), 0) == entries - cauchy_orset_count(la));
+    assert(la->entry_count == cauchy_orset_count(la));
+    assert(cauchy_htable_count(&la->index) <= heap);
+    assert(cauchy_orset_equals(la, b));
+
+    cauchy_orswot_t* lsw = cauchy_orswot_create(16, 1);
+    for (u64 bad = 8; bad <= 9; bad++) {
+        assert(cauchy_orswot_snapshot_load(lsw, snap, bad) == CAUCHY_ERR_INVALID);
+        assert(cauchy_htable_count(&lsw->index) == 0 && lsw->active_count == 0);
+        assert(lsw->fingerprint == 0 && cauchy_vclock_get(&lsw->context.cc, 3) == 0);
+    }
+    assert(cauchy_orswot_snapshot_load(lsw, snap, 7) == CAUCHY_OK);
+    assert(cauchy_orswot_equals(lsw, sw));
+    assert(cauchy_orswot_contains_string(lsw, "kept") && !cauchy_orswot_contains_string(lsw, "dropped"));
+    cauchy_orswot_t* stale = cauchy_orswot_create(16, 2);
+    assert(cauchy_orswot_add_string(stale, "kept") == CAUCHY_OK);
+    assert(cauchy_orswot_merge(lsw, sw) == CAUCHY_OK);
+    assert(cauchy_orswot_count(lsw) == 1);
+
+    cauchy_snapshot_release(snap);
+    cauchy_orset_destroy(la);
+    cauchy_orset_destroy(a);
+    cauchy_orset_destroy(b);
+    cauchy_orswot_destroy(sw);
+    cauchy_orswot_destroy(lsw);
+    cauchy_orswot_destroy(stale);
+    unlink(path);
+}
+
+/* Runs every task on the caller, last first */
+static void reverse_run(void* ctx, u32 count, cauchy_task_fn task, void* arg) {
+    (*(u32*)ctx)++;
+    while (count--) task(arg, count);
+}
+
+static int element(char* buf, usize size, int i) {
+    return snprintf(buf, size, i % 10 ? "p%d" : "%056d", i);
+}
+
+TEST(parallel_merge_matches_serial) {
+    enum { N = 3 * CAUCHY_PARALLEL_MIN_ITEMS };
+    char buf[96];
+
+    /* G-Set: dst overlaps a third of the source and keeps a digest */
+    cauchy_gset_t* src = cauchy_gset_create(16);
+    cauchy_gset_t* ref = cauchy_gset_create(16);
+    cauchy_gset_t* par = cauchy_gset_create(16);
+    assert(cauchy_gset_enable_digest(ref, 0) == CAUCHY_OK);
+    assert(cauchy_gset_enable_digest(par, 0) == CAUCHY_OK);
+    for (int i = 0; i < N; i++) {
+        int len = element(buf, sizeof(buf), i);
+        assert(cauchy_gset_add(src, buf, (usize)len) == CAUCHY_OK);
+    }
+    for (int i = 2 * N / 3; i < N + N / 3; i++) {
+        int len = element(buf, sizeof(buf), i);
+        assert(cauchy_gset_add(ref, buf, (usize)len) == CAUCHY_OK);
+        assert(cauchy_gset_add(par, buf, (usize)len) == CAUCHY_OK);
+    }
+    assert(cauchy_gset_merge(ref, src) == CAUCHY_OK);
+    assert(cauchy_gset_merge_parallel(par, src, 7, NULL) == CAUCHY_OK);
+    assert(cauchy_gset_count(par) == N + N / 3);
+    assert(cauchy_gset_equals(par, ref) && cauchy_gset_equals(ref, par));
+    assert(cauchy_merkle_root(cauchy_gset_digest(par)) ==
+           cauchy_merkle_root(cauchy_gset_digest(ref)));
+    assert(cauchy_gset_fingerprint(par) == cauchy_merkle_root(cauchy_gset_digest(par)));
+
+    /* Idempotent, through a caller-supplied executor */
+    u32 runs = 0;
+    cauchy_executor_t exec = { reverse_run, &runs };
+    assert(cauchy_gset_merge_parallel(par, src, 4, &exec) == CAUCHY_OK);
+    assert(runs == 2 && cauchy_gset_count(par) == N + N / 3);
+
+    /* Small sources take the serial path */
+    cauchy_gset_t* small = cauchy_gset_create(16);
+    assert(cauchy_gset_add(small, "tiny", 4) == CAUCHY_OK);
+    assert(cauchy_gset_merge_parallel(par, small, 4, &exec) == CAUCHY_OK);
+    assert(runs == 2 && cauchy_gset_contains(par, "tiny", 4));
+
+    /* 2P-Set: tombstoned additions stay until compaction */
+    cauchy_2pset_t* tsrc = cauchy_2pset_create(16);
+    cauchy_2pset_t* tdst = cauchy_2pset_create(16);
+    for (int i = 0; i < N; i++) {
+        int len = element(buf, sizeof(buf), i);
+        assert(cauchy_2pset_add(tsrc, buf, (usize)len) == CAUCHY_OK);
+        if (i % 4 == 0) assert(cauchy_2pset_remove(tsrc, buf, (usize)len) == CAUCHY_OK);
+    }
+    assert(cauchy_2pset_add_string(tdst, "local") == CAUCHY_OK);
+    assert(cauchy_2pset_merge_parallel(tdst, tsrc, 3, NULL) == CAUCHY_OK);
+    assert(cauchy_2pset_count(tdst) == cauchy_2pset_count(tsrc) + 1);
+    assert(!cauchy_2pset_contains(tdst, "p4", 2) && cauchy_2pset_contains(tdst, "p5", 2));
+    u64 fingerprint = cauchy_2pset_fingerprint(tdst);
+    cauchy_2pset_compact(tdst, 0);
+    assert(cauchy_2pset_count(tdst) == cauchy_2pset_count(tsrc) + 1);
+    assert(cauchy_2pset_fingerprint(tdst) == fingerprint);
+
+    /* OR-Set: the replicas share tags and remove different ones */
+    cauchy_orset_t* a = cauchy_orset_create(16, 1);
+    cauchy_orset_t* b = cauchy_orset_create(16, 2);
+    for (int i = 0; i < N; i++) {
+        int len = element(buf, sizeof(buf), i);
+        assert(cauchy_orset_add(a, buf, (usize)len) == CAUCHY_OK);
+    }
+    assert(cauchy_orset_merge(b, a) == CAUCHY_OK);
+    for (int i = 0; i < N; i += 3) {
+        int len = element(buf, sizeof(buf), i);
+        assert(cauchy_orset_remove(b, buf, (usize)len) == CAUCHY_OK);
+    }
+    for (int i = N; i < N + N / 2; i++) {
+        int len = element(buf, sizeof(buf), i);
+        assert(cauchy_orset_add(b, buf, (usize)len) == CAUCHY_OK);
+    }
+    for (int i = 0; i < N; i += 5) {
+        int len = element(buf, sizeof(buf), i);
+        assert(cauchy_orset_remove(a, buf, (usize)len) == CAUCHY_OK);
+    }
+    assert(cauchy_orset_enable_digest(a, 0) == CAUCHY_OK);
+
+    char path[64];
+    snapshot_path(path, sizeof(path), "parallel");
+    cauchy_snapshot_writer_t* w = cauchy_snapshot_writer_create(path);
+    assert(cauchy_orset_snapshot_save(a, w, 1) == CAUCHY_OK);
+    assert(cauchy_snapshot_writer_commit(w) == CAUCHY_OK);
+    cauchy_snapshot_t* snap;
+    assert(cauchy_snapshot_open(path, &snap) == CAUCHY_OK);
+    cauchy_orset_t* la = cauchy_orset_create(16, 1);
+    assert(cauchy_orset_enable_digest(la, 0) == CAUCHY_OK);
+    assert(cauchy_orset_snapshot_load(la, snap, 1) == CAUCHY_OK);
+
+    cauchy_orset_t* oref = cauchy_orset_create(16, 1);
+    assert(cauchy_orset_enable_digest(oref, 0) == CAUCHY_OK);
+    assert(cauchy_orset_merge(oref, a) == CAUCHY_OK);
+    assert(cauchy_orset_merge(oref, b) == CAUCHY_OK);
+
+    /* Into heap entries, then into a mapped base that must be promoted */
+    cauchy_orset_t* targets[2] = { a, la };
+    for (int t = 0; t < 2; t++) {
+        cauchy_orset_t* o = targets[t];
+        assert(cauchy_orset_merge_parallel(o, b, 0, NULL) == CAUCHY_OK);
+        assert(o->entry_count == oref->entry_count);
+        assert(cauchy_orset_count(o) == cauchy_orset_count(oref));
+        assert(cauchy_orset_equals(o, oref) && cauchy_orset_equals(oref, o));
+        assert(cauchy_vclock_compare(cauchy_orset_clock(o), cauchy_orset_clock(oref)) ==
+               CAUCHY_EQUAL);
+        assert(cauchy_merkle_root(cauchy_orset_digest(o)) ==
+               cauchy_merkle_root(cauchy_orset_digest(oref)));
+        assert(cauchy_orset_fingerprint(o) == cauchy_merkle_root(cauchy_orset_digest(o)));
+    }
+    assert(!cauchy_orset_contains(la, "p3", 2) && !cauchy_orset_contains(la, "p5", 2));
+    assert(cauchy_orset_contains(la, "p7", 2));
+
+    cauchy_snapshot_release(snap);
+    cauchy_gset_destroy(src);
+    cauchy_gset_destroy(ref);
+    cauchy_gset_destroy(par);
+    cauchy_gset_destroy(small);
+    cauchy_2pset_destroy(tsrc);
+    cauchy_2pset_destroy(tdst);
+    cauchy_orset_destroy(a);
+    cauchy_orset_destroy(b);
+    cauchy_orset_destroy(la);
+    cauchy_orset_destroy(oref);
+    unlink(path);
+}
+
+TEST(set_fingerprints) {
+    char buf[64];
+
+    /* G-Set: insertion order does not matter; a digest agrees */
+    cauchy_gset_t* g1 = cauchy_gset_create(16);
+    cauchy_gset_t* g2 = cauchy_gset_create(4);
+    assert(cauchy_gset_enable_digest(g2, 4) == CAUCHY_OK);
+    assert(cauchy_gset_fingerprint(g1) == 0);
+    for (int i = 0; i < 200; i++) {
+        int len = snprintf(buf, sizeof(buf), "e%d", i);
+        assert(cauchy_gset_add(g1, buf, (usize)len) == CAUCHY_OK);
+        len = snprintf(buf, sizeof(buf), "e%d", 199 - i);
+        assert(cauchy_gset_add(g2, buf, (usize)len) == CAUCHY_OK);
+    }
+    assert(cauchy_gset_add(g1, "e7", 2) == CAUCHY_OK);
+    assert(cauchy_gset_fingerprint(g1) == cauchy_gset_fingerprint(g2));
+    assert(cauchy_gset_fingerprint(g2) == cauchy_merkle_root(cauchy_gset_digest(g2)));
+    assert(cauchy_gset_equals(g1, g2) && cauchy_gset_subset(g1, g2));
+    assert(cauchy_gset_add_string(g2, "extra") == CAUCHY_OK);
+    assert(cauchy_gset_fingerprint(g1) != cauchy_gset_fingerprint(g2));
+    assert(!cauchy_gset_equals(g1, g2) && cauchy_gset_subset(g1, g2));
+
+    /* Pruning takes elements back out */
+    usize cursor = 0, pruned = 0;
+    for (int pass = 0; pass < 64 && cauchy_gset_count(g2) > 1; pass++) {
+        pruned += cauchy_gset_prune(g2, g1, &cursor, 0);
+    }
+    assert(pruned == 200 && cauchy_gset_count(g2) == 1);
+    cauchy_gset_t* only = cauchy_gset_create(16);
+    assert(cauchy_gset_add_string(only, "extra") == CAUCHY_OK);
+    assert(cauchy_gset_fingerprint(g2) == cauchy_gset_fingerprint(only));
+    assert(cauchy_gset_fingerprint(g2) == cauchy_merkle_root(cauchy_gset_digest(g2)));
+
+    /* 2P-Set: the count follows tombstones that arrive before or after
+     * the add, through deltas and merges */
+    cauchy_2pset_t* a = cauchy_2pset_create(16);
+    cauchy_2pset_t* b = cauchy_2pset_create(16);
+    cauchy_2pset_t* delta = cauchy_2pset_create(16);
+    for (int i = 0; i < 100; i++) {
+        int len = snprintf(buf, sizeof(buf), "t%d", i);
+        assert(cauchy_2pset_add_delta(a, buf, (usize)len, delta) == CAUCHY_OK);
+        if (i % 3 == 0) assert(cauchy_2pset_remove_delta(a, buf, (usize)len, delta) == CAUCHY_OK);
+    }
+    assert(cauchy_2pset_remove(a, "t0", 2) == CAUCHY_OK);
+    assert(cauchy_2pset_count(a) == 66 && cauchy_2pset_count(delta) == 66);
+    assert(cauchy_2pset_fingerprint(a) == cauchy_2pset_fingerprint(delta));
+    assert(cauchy_2pset_add(b, "t1", 2) == CAUCHY_OK);
+    assert(cauchy_2pset_remove(b, "t1", 2) == CAUCHY_OK);
+    assert(cauchy_2pset_add(b, "t3", 2) == CAUCHY_OK);
+    assert(cauchy_2pset_count(b) == 1 && !cauchy_2pset_is_empty(b));
+    assert(cauchy_2pset_merge(b, a) == CAUCHY_OK);
+    assert(cauchy_2pset_count(b) == 65);
+    assert(cauchy_2pset_merge_delta(a, b) == CAUCHY_OK);
+    assert(cauchy_2pset_count(a) == 65);
+    assert(cauchy_2pset_fingerprint(a) == cauchy_2pset_fingerprint(b));
+    assert(cauchy_2pset_equals(a, b));
+    u64 fingerprint = cauchy_2pset_fingerprint(a);
+    usize compacted = 0;
+    for (int pass = 0; pass < 64 && a->covered; pass++) compacted += cauchy_2pset_compact(a, 0);
+    assert(compacted == 35);
+    assert(cauchy_2pset_count(a) == 65 && cauchy_2pset_fingerprint(a) == fingerprint);
+    assert(cauchy_2pset_equals(a, b));
+    assert(cauchy_2pset_remove(b, "t2", 2) == CAUCHY_OK);
+    assert(cauchy_2pset_count(b) == 64 && !cauchy_2pset_equals(a, b));
+
+    /* OR-Set: the fingerprint is the digest root; live elements decide
+     * equality */
+    cauchy_orset_t* x = cauchy_orset_create(16, 1);
+    cauchy_orset_t* y = cauchy_orset_create(16, 2);
+    assert(cauchy_orset_enable_digest(x, 4) == CAUCHY_OK);
+    assert(cauchy_orset_add_string(x, "apple") == CAUCHY_OK);
+    assert(cauchy_orset_add_string(x, "pear") == CAUCHY_OK);
+    assert(cauchy_orset_add_string(y, "pear") == CAUCHY_OK);
+    assert(cauchy_orset_add_string(y, "plum") == CAUCHY_OK);
+    assert(!cauchy_orset_equals(x, y));
+    assert(cauchy_orset_remove_string(x, "pear") == CAUCHY_OK);
+    assert(cauchy_orset_remove_string(y, "plum") == CAUCHY_OK);
+    assert(cauchy_orset_merge(x, y) == CAUCHY_OK);
+    assert(cauchy_orset_merge(y, x) == CAUCHY_OK);
+    assert(cauchy_orset_fingerprint(x) == cauchy_orset_fingerprint(y));
+    assert(cauchy_orset_fingerprint(x) == cauchy_merkle_root(cauchy_orset_digest(x)));
+    assert(cauchy_orset_equals(x, y));
+    cauchy_vclock_t stable;
+    cauchy_vclock_init(&stable, 0);
+    assert(cauchy_vclock_merge(&stable, cauchy_orset_clock(x)) == CAUCHY_OK);
+    assert(cauchy_orset_gc(x, &stable, 0) == 2);
+    assert(cauchy_orset_fingerprint(x) == cauchy_merkle_root(cauchy_orset_digest(x)));
+    assert(cauchy_orset_fingerprint(x) != cauchy_orset_fingerprint(y));
+    assert(cauchy_orset_equals(x, y));
+    cauchy_vclock_fini(&stable);
+
+    /* ORSWOT: elements only */
+    cauchy_orswot_t* s1 = cauchy_orswot_create(16, 1);
+    cauchy_orswot_t* s2 = cauchy_orswot_create(16, 2);
+    assert(cauchy_orswot_add_string(s1, "a") == CAUCHY_OK);
+    assert(cauchy_orswot_add_string(s1, "b") == CAUCHY_OK);
+    assert(cauchy_orswot_add_string(s2, "b") == CAUCHY_OK);
+    assert(cauchy_orswot_fingerprint(s1) != cauchy_orswot_fingerprint(s2));
+    assert(cauchy_orswot_remove_string(s1, "a") == CAUCHY_OK);
+    assert(cauchy_orswot_fingerprint(s1) == cauchy_orswot_fingerprint(s2));
+    assert(cauchy_orswot_equals(s1, s2));
+    assert(cauchy_orswot_merge(s2, s1) == CAUCHY_OK);
+    assert(cauchy_orswot_fingerprint(s1) == cauchy_orswot_fingerprint(s2));
+
+    /* Snapshots keep fingerprints and the 2P-Set count */
+    char path[64];
+    snapshot_path(path, sizeof(path), "fingerprint");
+    cauchy_snapshot_writer_t* w = cauchy_snapshot_writer_create(path);
+    assert(cauchy_gset_snapshot_save(g1, w, 1) == CAUCHY_OK);
+    assert(cauchy_2pset_snapshot_save(b, w, 1) == CAUCHY_OK);
+    assert(cauchy_orset_snapshot_save(y, w, 1) == CAUCHY_OK);
+    assert(cauchy_snapshot_writer_commit(w) == CAUCHY_OK);
+    cauchy_snapshot_t* snap;
+    assert(cauchy_snapshot_open(path, &snap) == CAUCHY_OK);
+    cauchy_gset_t* lg = cauchy_gset_create(16);
+    cauchy_2pset_t* lb = cauchy_2pset_create(16);
+    cauchy_orset_t* ly = cauchy_orset_create(16, 2);
+    assert(cauchy_gset_snapshot_load(lg, snap, 1) == CAUCHY_OK);
+    assert(cauchy_2pset_snapshot_load(lb, snap, 1) == CAUCHY_OK);
+    assert(cauchy_orset_snapshot_load(ly, snap, 1) == CAUCHY_OK);
+    assert(cauchy_gset_fingerprint(lg) == cauchy_gset_fingerprint(g1));
+    assert(cauchy_2pset_count(lb) == 64);
+    assert(cauchy_2pset_fingerprint(lb) == cauchy_2pset_fingerprint(b));
+    assert(cauchy_orset_fingerprint(ly) == cauchy_orset_fingerprint(y));
+    assert(cauchy_orset_equals(ly, x));
+    cauchy_snapshot_release(snap);
+    unlink(path);
+
+    cauchy_gset_destroy(g1);
+    cauchy_gset_destroy(g2);
+    cauchy_gset_destroy(only);
+    cauchy_gset_destroy(lg);
+    cauchy_2pset_destroy(a);
+    cauchy_2pset_destroy(b);
+    cauchy_2pset_destroy(delta);
+    cauchy_2pset_destroy(lb);
+    cauchy_orset_destroy(x);
+    cauchy_orset_destroy(y);
+    cauchy_orset_destroy(ly);
+    cauchy_orswot_destroy(s1);
+    cauchy_orswot_destroy(s2);
+}
+
+/* Everything a view yields must add up to the count and fingerprint it
+ * was published with */
+static usize gset_view_check(cauchy_gset_view_t* v) {
+    usize n = 0;
+    u64 fp = 0;
+    const void* data;
+    usize size;
+    while (cauchy_gset_view_next(v, &data, &size)) {
+        fp += cauchy_merkle_item(cauchy_hash_bytes(data, size));
+        n++;
+    }
+    assert(n == cauchy_gset_view_count(v) && fp == cauchy_gset_view_fingerprint(v));
+    cauchy_gset_view_rewind(v);
+    return n;
+}
+
+static usize orset_view_check(cauchy_orset_view_t* v) {
+    usize n = 0;
+    u64 fp = 0;
+    const void* data;
+    usize size;
+    while (cauchy_orset_view_next(v, &data, &size)) {
+        fp += cauchy_merkle_item(cauchy_hash_bytes(data, size));
+        n++;
+    }
+    assert(n == cauchy_orset_view_count(v) && fp == cauchy_orset_view_fingerprint(v));
+    cauchy_orset_view_rewind(v);
+    return n;
+}
+
+typedef struct view_reader {
+    const cauchy_gset_t*  gset;
+    const cauchy_orset_t* orset;
+    cauchy_atomic_u32_t   stop;
+    usize                 views;
+} view_reader_t;
+
+static void* view_reader(void* arg) {
+    view_reader_t* r = arg;
+    while (!cauchy_atomic_load_u32(&r->stop)) {
+        if (r->gset) {
+            cauchy_gset_view_t v;
+            assert(cauchy_gset_view_open(r->gset, &v) == CAUCHY_OK);
+            gset_view_check(&v);
+            cauchy_gset_view_close(&v);
+        } else {
+            cauchy_orset_view_t v;
+            assert(cauchy_orset_view_open(r->orset, &v) == CAUCHY_OK);
+            orset_view_check(&v);
+            cauchy_orset_view_close(&v);
+        }
+        r->views++;
+    }
+    return NULL;
+}
+
+TEST(gset_versioned_views) {
+    char path[64];
+    snapshot_path(path, sizeof(path), "views");
+    char buf[96];
+
+    /* A view keeps the state it opened on while the set moves on */
+    cauchy_gset_t* g = cauchy_gset_create(16);
+    cauchy_gset_view_t v1, v2, v3;
+    assert(cauchy_gset_view_open(g, &v1) == CAUCHY_ERR_INVALID);
+    for (int i = 0; i < 100; i++) {
+        int len = snprintf(buf, sizeof(buf), i % 10 ? "v%d" : "%064d", i);
+        assert(cauchy_gset_add(g, buf, (usize)len) == CAUCHY_OK);
+    }
+    assert(cauchy_gset_enable_views(g) == CAUCHY_OK);
+    assert(cauchy_gset_enable_views(g) == CAUCHY_ERR_EXISTS);
+    assert(cauchy_gset_view_open(g, &v1) == CAUCHY_OK);
+    for (int i = 100; i < 200; i++) {
+        int len = snprintf(buf, sizeof(buf), i % 10 ? "v%d" : "%064d", i);
+        assert(cauchy_gset_add(g, buf, (usize)len) == CAUCHY_OK);
+    }
+    assert(gset_view_check(&v1) == 100);
+    assert(cauchy_gset_view_open(g, &v2) == CAUCHY_OK);
+    assert(gset_view_check(&v2) == 200);
+
+    /* Pruned elements stay readable from older views */
+    cauchy_gset_t* covered = cauchy_gset_create(16);
+    for (int i = 0; i < 200; i += 2) {
+        int len = snprintf(buf, sizeof(buf), i % 10 ? "v%d" : "%064d", i);
+        assert(cauchy_gset_add(covered, buf, (usize)len) == CAUCHY_OK);
+    }
+    usize cursor = 0, pruned = 0;
+    for (int pass = 0; pass < 64 && cauchy_gset_count(g) > 100; pass++) {
+        pruned += cauchy_gset_prune(g, covered, &cursor, 7);
+    }
+    assert(pruned == 100 && cauchy_gset_count(g) == 100);
+    assert(gset_view_check(&v1) == 100 && gset_view_check(&v2) == 200);
+    assert(cauchy_gset_view_open(g, &v3) == CAUCHY_OK);
+    assert(gset_view_check(&v3) == 100);
+    assert(cauchy_gset_view_fingerprint(&v3) == cauchy_gset_fingerprint(g));
+
+    /* Serialization and digests read the view, not the set */
+    usize wire = cauchy_gset_view_serialized_size(&v1);
+    u8* bytes = malloc(wire);
+    assert(cauchy_gset_view_serialize(&v1, bytes, wire - 1) == 0);
+    assert(cauchy_gset_view_serialize(&v1, bytes, wire) == wire);
+    cauchy_gset_t* decoded = cauchy_gset_create(16);
+    assert(cauchy_gset_deserialize(decoded, bytes, wire) == CAUCHY_OK);
+    assert(cauchy_gset_count(decoded) == 100);
+    assert(cauchy_gset_fingerprint(decoded) == cauchy_gset_view_fingerprint(&v1));
+    free(bytes);
+    cauchy_merkle_t tree;
+    assert(cauchy_gset_view_digest(&v2, 4, &tree) == CAUCHY_OK);
+    assert(cauchy_merkle_root(&tree) == cauchy_gset_view_fingerprint(&v2));
+    cauchy_merkle_destroy(&tree);
+
+    /* Views are pinned in a fixed number of slots */
+    cauchy_gset_view_t more[CAUCHY_MVCC_MAX_VIEWS];
+    usize opened = 0;
+    while (opened < CAUCHY_MVCC_MAX_VIEWS && cauchy_gset_view_open(g, &more[opened]) == CAUCHY_OK) {
+        opened++;
+    }
+    assert(opened == CAUCHY_MVCC_MAX_VIEWS - 3);
+    assert(cauchy_gset_view_open(g, &more[0]) == CAUCHY_ERR_FULL);
+    for (usize i = 0; i < opened; i++) cauchy_gset_view_close(&more[i]);
+    cauchy_gset_view_close(&v1);
+    cauchy_gset_view_close(&v2);
+    cauchy_gset_view_close(&v3);
+
+    /* Once nothing pins them, retirements are freed and a log that is
+     * mostly dead is compacted */
+    cauchy_gset_t* bulk = cauchy_gset_create(16);
+    for (int i = 0; i < 4000; i++) {
+        int len = snprintf(buf, sizeof(buf), "b%d", i);
+        assert(cauchy_gset_add(g, buf, (usize)len) == CAUCHY_OK);
+        assert(cauchy_gset_add(bulk, buf, (usize)len) == CAUCHY_OK);
+    }
+    for (int pass = 0; pass < 64 && cauchy_gset_count(g) > 100; pass++) {
+        cauchy_gset_prune(g, bulk, &cursor, 512);
+    }
+    assert(cauchy_gset_count(g) == 100);
+    assert(cauchy_gset_add_string(g, "last") == CAUCHY_OK);
+    assert(cauchy_mvcc_length(g->views) < 1024);
+    assert(g->views->retired_count < 64);
+    assert(cauchy_gset_view_open(g, &v1) == CAUCHY_OK);
+    assert(gset_view_check(&v1) == 101);
+    cauchy_gset_view_close(&v1);
+
+    /* Snapshot bases: dropped slots go out of newer views only */
+    cauchy_snapshot_writer_t* w = cauchy_snapshot_writer_create(path);
+    assert(w);
+    assert(cauchy_gset_snapshot_save(covered, w, 1) == CAUCHY_OK);
+    assert(cauchy_snapshot_writer_commit(w) == CAUCHY_OK);
+    cauchy_snapshot_t* snap;
+    assert(cauchy_snapshot_open(path, &snap) == CAUCHY_OK);
+    cauchy_gset_t* lg = cauchy_gset_create(16);
+    assert(cauchy_gset_snapshot_load(lg, snap, 1) == CAUCHY_OK);
+    cauchy_snapshot_release(snap);
+    assert(cauchy_gset_enable_views(lg) == CAUCHY_OK);
+    assert(cauchy_gset_add_string(lg, "heap") == CAUCHY_OK);
+    assert(cauchy_gset_view_open(lg, &v1) == CAUCHY_OK);
+    assert(gset_view_check(&v1) == 101);
+    cauchy_gset_t* copy = cauchy_gset_create(16);
+    assert(cauchy_gset_merge(copy, covered) == CAUCHY_OK);
+    for (int pass = 0; pass < 64 && cauchy_gset_count(lg) > 1; pass++) {
+        cauchy_gset_prune(lg, copy, &cursor, 0);
+    }
+    assert(cauchy_gset_count(lg) == 1);
+    assert(gset_view_check(&v1) == 101);
+    assert(cauchy_gset_view_open(lg, &v2) == CAUCHY_OK);
+    assert(gset_view_check(&v2) == 1);
+    cauchy_gset_view_close(&v1);
+    cauchy_gset_view_close(&v2);
+
+    /* A reader on another thread never sees a half-applied change */
+    cauchy_gset_t* src = cauchy_gset_create(16);
+    for (int i = 0; i < CAUCHY_PARALLEL_MIN_ITEMS; i++) {
+        int len = snprintf(buf, sizeof(buf), "p%d", i);
+        assert(cauchy_gset_add(src, buf, (usize)len) == CAUCHY_OK);
+    }
+    view_reader_t reader = { .gset = g };
+    pthread_t thread;
+    pthread_create(&thread, NULL, view_reader, &reader);
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < 2000; i++) {
+            int len = snprintf(buf, sizeof(buf), "r%d-%d", round, i);
+            assert(cauchy_gset_add(g, buf, (usize)len) == CAUCHY_OK);
+        }
+        assert(cauchy_gset_merge_parallel(g, src, 4, NULL) == CAUCHY_OK);
+        for (int pass = 0; pass < 64 && cauchy_gset_count(g) > 2101; pass++) {
+            cauchy_gset_prune(g, src, &cursor, 1000);
+        }
+        assert(cauchy_gset_count(g) == 2101);
+        cauchy_gset_t* fresh = cauchy_gset_create(16);
+        for (int i = 0; i < 2000; i++) {
+            int len = snprintf(buf, sizeof(buf), "r%d-%d", round, i);
+            assert(cauchy_gset_add(fresh, buf, (usize)len) == CAUCHY_OK);
+        }
+        for (int pass = 0; pass < 64 && cauchy_gset_count(g) > 101; pass++) {
+            cauchy_gset_prune(g, fresh, &cursor, 0);
+        }
+        assert(cauchy_gset_count(g) == 101);
+        cauchy_gset_destroy(fresh);
+    }
+    cauchy_atomic_store_u32(&reader.stop, 1);
+    pthread_join(thread, NULL);
+    assert(reader.views > 0);
+
+    cauchy_gset_destroy(src);
+    cauchy_gset_destroy(copy);
+    cauchy_gset_destroy(lg);
+    cauchy_gset_destroy(bulk);
+    cauchy_gset_destroy(decoded);
+    cauchy_gset_destroy(covered);
+    cauchy_gset_destroy(g);
+    unlink(path);
+}
+
+TEST(orset_versioned_views) {
+    char path[64];
+    snapshot_path(path, sizeof(path), "orviews");
+    char buf[96];
+
+    cauchy_orset_t* a = cauchy_orset_create(16, 1);
+    for (int i = 0; i < 200; i++) {
+        int len = snprintf(buf, sizeof(buf), i % 10 ? "o%d" : "%060d", i);
+        assert(cauchy_orset_add(a, buf, (usize)len) == CAUCHY_OK);
+    }
+    for (int i = 0; i < 200; i += 4) {
+        int len = snprintf(buf, sizeof(buf), i % 10 ? "o%d" : "%060d", i);
+        assert(cauchy_orset_remove(a, buf, (usize)len) == CAUCHY_OK);
+    }
+    cauchy_snapshot_writer_t* w = cauchy_snapshot_writer_create(path);
+    assert(w);
+    assert(cauchy_orset_snapshot_save(a, w, 1) == CAUCHY_OK);
+    assert(cauchy_snapshot_writer_commit(w) == CAUCHY_OK);
+    cauchy_snapshot_t* snap;
+    assert(cauchy_snapshot_open(path, &snap) == CAUCHY_OK);
+
+    /* Removes of base and heap entries are invisible to older views */
+    cauchy_orset_t* b = cauchy_orset_create(16, 2);
+    assert(cauchy_orset_snapshot_load(b, snap, 1) == CAUCHY_OK);
+    cauchy_snapshot_release(snap);
+    assert(cauchy_orset_add_string(b, "heap") == CAUCHY_OK);
+    assert(cauchy_orset_enable_views(b) == CAUCHY_OK);
+    cauchy_orset_view_t v1, v2;
+    assert(cauchy_orset_view_open(b, &v1) == CAUCHY_OK);
+    assert(orset_view_check(&v1) == 151);
+    assert(cauchy_orset_remove(b, "o1", 2) == CAUCHY_OK);
+    assert(cauchy_orset_remove_string(b, "heap") == CAUCHY_OK);
+    assert(cauchy_orset_add(b, "o2", 2) == CAUCHY_OK);
+    assert(orset_view_check(&v1) == 151);
+    assert(cauchy_orset_view_open(b, &v2) == CAUCHY_OK);
+    assert(orset_view_check(&v2) == 150);
+    cauchy_orset_view_close(&v2);
+
+    /* Collected tombstones outlive the views that can reach them */
+    cauchy_vclock_t stable;
+    cauchy_vclock_init(&stable, 0);
+    assert(cauchy_vclock_copy(&stable, cauchy_orset_clock(b)) == CAUCHY_OK);
+    usize collected = 0;
+    for (int pass = 0; pass < 64 && collected < 52; pass++) {
+        collected += cauchy_orset_gc(b, &stable, 0);
+    }
+    assert(collected == 52);
+    assert(orset_view_check(&v1) == 151);
+    cauchy_orset_view_close(&v1);
+
+    /* A reader on another thread while the owner adds, removes, merges
+     * in parallel and collects */
+    cauchy_orset_t* src = cauchy_orset_create(16, 3);
+    for (int i = 0; i < CAUCHY_PARALLEL_MIN_ITEMS; i++) {
+        int len = snprintf(buf, sizeof(buf), "p%d", i);
+        assert(cauchy_orset_add(src, buf, (usize)len) == CAUCHY_OK);
+    }
+    view_reader_t reader = { .orset = b };
+    pthread_t thread;
+    pthread_create(&thread, NULL, view_reader, &reader);
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 2000; i++) {
+            int len = snprintf(buf, sizeof(buf), "r%d-%d", round, i);
+            assert(cauchy_orset_add(b, buf, (usize)len) == CAUCHY_OK);
+            if (i % 2) assert(cauchy_orset_remove(b, buf, (usize)len) == CAUCHY_OK);
+        }
+        assert(cauchy_orset_merge_parallel(b, src, 4, NULL) == CAUCHY_OK);
+        for (int i = 0; i < CAUCHY_PARALLEL_MIN_ITEMS; i += 3) {
+            int len = snprintf(buf, sizeof(buf), "p%d", i);
+            cauchy_orset_remove(src, buf, (usize)len);
+        }
+        assert(cauchy_orset_merge_parallel(b, src, 4, NULL) == CAUCHY_OK);
+        cauchy_vclock_fini(&stable);
+        assert(cauchy_vclock_copy(&stable, cauchy_orset_clock(b)) == CAUCHY_OK);
+        cauchy_orset_gc(b, &stable, 0);
+    }
+    cauchy_atomic_store_u32(&reader.stop, 1);
+    pthread_join(thread, NULL);
+    assert(reader.views > 0);
+    assert(cauchy_orset_view_open(b, &v1) == CAUCHY_OK);
+    assert(orset_view_check(&v1) == cauchy_orset_count(b));
+    cauchy_orset_view_close(&v1);
+
+    cauchy_vclock_fini(&stable);
+    cauchy_orset_destroy(src);
+    cauchy_orset_destroy(b);
+    cauchy_orset_destroy(a);
+    unlink(path);
+}
+
+/* A merge is one version, however many elements it brings */
+TEST(set_views_publish_per_merge) {
+    char buf[32];
+    cauchy_gset_t* gsrc = cauchy_gset_create(16);
+    cauchy_orset_t* osrc = cauchy_orset_create(16, 2);
+    for (int i = 0; i < CAUCHY_PARALLEL_MIN_ITEMS; i++) {
+        int len = snprintf(buf, sizeof(buf), "m%d", i);
+        assert(cauchy_gset_add(gsrc, buf, (usize)len) == CAUCHY_OK);
+        assert(cauchy_orset_add(osrc, buf, (usize)len) == CAUCHY_OK);
+    }
+    cauchy_gset_t* small = cauchy_gset_create(16);
+    cauchy_orset_t* osmall = cauchy_orset_create(16, 3);
+    for (int i = 0; i < 100; i++) {
+        int len = snprintf(buf, sizeof(buf), "s%d", i);
+        assert(cauchy_gset_add(small, buf, (usize)len) == CAUCHY_OK);
+        assert(cauchy_orset_add(osmall, buf, (usize)len) == CAUCHY_OK);
+    }
+
+    cauchy_gset_t* g = cauchy_gset_create(16);
+    assert(cauchy_gset_enable_views(g) == CAUCHY_OK);
+    u64 version = atomic_load(&g->views->version);
+    assert(cauchy_gset_merge(g, small) == CAUCHY_OK);
+    assert(atomic_load(&g->views->version) == version + 1);
+    assert(cauchy_gset_merge_parallel(g, gsrc, 4, NULL) == CAUCHY_OK);
+    assert(atomic_load(&g->views->version) == version + 2);
+    cauchy_gset_view_t gv;
+    assert(cauchy_gset_view_open(g, &gv) == CAUCHY_OK);
+    assert(gset_view_check(&gv) == CAUCHY_PARALLEL_MIN_ITEMS + 100);
+    cauchy_gset_view_close(&gv);
+
+    cauchy_orset_t* o = cauchy_orset_create(16, 1);
+    assert(cauchy_orset_enable_views(o) == CAUCHY_OK);
+    version = atomic_load(&o->views->version);
+    assert(cauchy_orset_merge(o, osmall) == CAUCHY_OK);
+    assert(atomic_load(&o->views->version) == version + 1);
+    for (int i = 0; i < 100; i += 2) {
+        int len = snprintf(buf, sizeof(buf), "s%d", i);
+        assert(cauchy_orset_remove(osmall, buf, (usize)len) == CAUCHY_OK);
+    }
+    assert(cauchy_orset_merge(o, osmall) == CAUCHY_OK);
+    assert(atomic_load(&o->views->version) == version + 2);
+    assert(cauchy_orset_merge_parallel(o, osrc, 4, NULL) == CAUCHY_OK);
+    assert(atomic_load(&o->views->version) == version + 3);
+    cauchy_orset_view_t ov;
+    assert(cauchy_orset_view_open(o, &ov) == CAUCHY_OK);
+    assert(orset_view_check(&ov) == CAUCHY_PARALLEL_MIN_ITEMS + 50);
+    cauchy_orset_view_close(&ov);
+
+    cauchy_gset_destroy(g);
+    cauchy_gset_destroy(small);
+    cauchy_gset_destroy(gsrc);
+    cauchy_orset_destroy(o);
+    cauchy_orset_destroy(osmall);
+    cauchy_orset_destroy(osrc);
+}
+
+int main(void) {
+    printf("Set CRDT Tests:\n");
+
+    RUN(htable_incremental_resize);
+    RUN(gset_grow_and_merge);
+    RUN(gset_inline_and_arena_payloads);
+    RUN(twopset_remove_wins);
+    RUN(orset_add_wins);
+    RUN(orset_delta_sync);
+    RUN(twopset_delta_sync);
+    RUN(orset_stable_tombstone_gc);
+    RUN(twopset_compaction);
+    RUN(orswot_one_entry_per_element);
+    RUN(orswot_delta_sync);
+    RUN(set_batch_operations);
+    RUN(set_merge_stats);
+    RUN(gset_snapshot_mapped);
+    RUN(orset_snapshot_copy_on_write);
+    RUN(parallel_merge_matches_serial);
+    RUN(set_fingerprints);
+    RUN(gset_versioned_views);
+    RUN(orset_versioned_views);
+    RUN(set_views_publish_per_merge);
+
+    printf("\nAll set tests passed!\n");
+    return 0;
+}
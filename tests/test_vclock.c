@@ -0,0 +1,406 @@
+/*
+ * CAUCHY - Vector Clock Tests
+ */
+
+#include "cauchy/cauchy.h"
+#include "cauchy/simd.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { printf("  %-40s", #name); test_##name(); printf("✓\n"); } while(0)
+
+static u64 rng_state = 0x2545F4914F6CDD1DULL;
+
+static u64 next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+TEST(vclock_compare) {
+    cauchy_vclock_t a, b;
+    cauchy_vclock_init(&a, 3);
+    cauchy_vclock_init(&b, 3);
+    assert(cauchy_vclock_compare(&a, &b) == CAUCHY_EQUAL);
+
+    cauchy_vclock_increment(&a, 0);
+    assert(cauchy_vclock_compare(&a, &b) == CAUCHY_HAPPENS_AFTER);
+    assert(cauchy_vclock_happens_before(&b, &a));
+
+    cauchy_vclock_increment(&b, 2);
+    assert(cauchy_vclock_concurrent(&a, &b));
+
+    cauchy_vclock_merge(&b, &a);
+    assert(cauchy_vclock_happens_before(&a, &b));
+    assert(cauchy_vclock_sum(&b) == 2);
+
+    cauchy_vclock_min(&b, &a);
+    assert(cauchy_vclock_equals(&a, &b));
+}
+
+TEST(vclock_sparse_large_ids) {
+    cauchy_vclock_t a, b;
+    cauchy_vclock_init(&a, 3);
+    cauchy_vclock_init(&b, 3);
+
+    /* Ephemeral edge nodes with arbitrary 64-bit ids stay sparse */
+    for (u64 i = 0; i < 2000; i++) {
+        assert(cauchy_vclock_set(&a, 0x9E3779B97F4A7C15ULL * (i + 1), i + 1) == CAUCHY_OK);
+    }
+    assert(!cauchy_vclock_is_dense(&a));
+    assert(cauchy_vclock_get(&a, 0x9E3779B97F4A7C15ULL * 7) == 7);
+    assert(cauchy_vclock_get(&a, 12345) == 0);
+
+    cauchy_vclock_increment(&b, 0x9E3779B97F4A7C15ULL * 7);
+    assert(cauchy_vclock_happens_before(&b, &a));
+    cauchy_vclock_increment(&b, 42);
+    assert(cauchy_vclock_concurrent(&a, &b));
+
+    assert(cauchy_vclock_merge(&b, &a) == CAUCHY_OK);
+    assert(cauchy_vclock_happens_before(&a, &b));
+    assert(cauchy_vclock_sum(&b) == 2000 * 2001 / 2 + 1);
+
+    cauchy_vclock_min(&b, &a);
+    assert(cauchy_vclock_equals(&a, &b));
+
+    u8 buf[64 * 1024];
+    usize n = cauchy_vclock_serialize(&a, buf, sizeof(buf));
+    assert(n == cauchy_vclock_serialized_size(&a));
+    assert(n == cauchy_vclock_peek_serialized_size(buf, n));
+    cauchy_vclock_t restored;
+    assert(cauchy_vclock_deserialize(&restored, buf, n) == CAUCHY_OK);
+    assert(cauchy_vclock_equals(&a, &restored));
+
+    cauchy_vclock_fini(&a);
+    cauchy_vclock_fini(&b);
+    cauchy_vclock_fini(&restored);
+}
+
+TEST(vclock_switches_to_dense) {
+    cauchy_vclock_t a, sparse;
+    cauchy_vclock_init(&a, 3);
+    cauchy_vclock_init(&sparse, 3);
+
+    for (u64 i = 0; i < 3; i++) cauchy_vclock_increment(&a, i);
+    assert(!cauchy_vclock_is_dense(&a));
+    assert(a.heap == NULL);  /* Small clusters never allocate */
+
+    for (u64 i = 0; i < 200; i++) cauchy_vclock_increment(&a, i);
+    assert(cauchy_vclock_is_dense(&a));
+    assert(a.num_nodes == 200);
+    assert(cauchy_vclock_sum(&a) == 203);
+
+    /* Dense and sparse clocks with the same entries are interchangeable */
+    for (u64 i = 0; i < 200; i++) cauchy_vclock_set(&sparse, 199 - i, i < 197 ? 1 : 2);
+    assert(cauchy_vclock_equals(&a, &sparse));
+
+    u8 buf_a[4096], buf_s[4096];
+    usize na = cauchy_vclock_serialize(&a, buf_a, sizeof(buf_a));
+    usize ns = cauchy_vclock_serialize(&sparse, buf_s, sizeof(buf_s));
+    assert(na == ns && memcmp(buf_a, buf_s, na) == 0);
+    assert(na == sizeof(u32) + 200 * sizeof(u64));
+
+    /* A far id moves the dense clock back to pairs */
+    assert(cauchy_vclock_set(&a, 1ULL << 40, 9) == CAUCHY_OK);
+    assert(!cauchy_vclock_is_dense(&a));
+    assert(cauchy_vclock_happens_before(&sparse, &a));
+
+    cauchy_vclock_t copy;
+    assert(cauchy_vclock_copy(&copy, &a) == CAUCHY_OK);
+    cauchy_vclock_increment(&a, 5);
+    assert(cauchy_vclock_happens_before(&copy, &a));
+
+    cauchy_vclock_fini(&a);
+    cauchy_vclock_fini(&sparse);
+    cauchy_vclock_fini(&copy);
+}
+
+TEST(vclock_compact_encoding) {
+    cauchy_vclock_t a, restored;
+    cauchy_vclock_init(&a, 3);
+    for (u64 i = 0; i < 100; i++) cauchy_vclock_set(&a, i * 3, i + 1);
+    cauchy_vclock_set(&a, 1ULL << 50, 7);
+
+    u8 raw[8192], buf[8192];
+    usize n = cauchy_vclock_encode(&a, NULL, buf, sizeof(buf));
+    assert(n == cauchy_vclock_encoded_size(&a, NULL));
+    assert(buf[0] == CAUCHY_VCLOCK_WIRE_VERSION);
+    assert(n * 4 < cauchy_vclock_serialize(&a, raw, sizeof(raw)));
+    assert(cauchy_vclock_encode(&a, NULL, buf, n - 1) == 0);
+
+    usize used = 0;
+    assert(cauchy_vclock_decode(&restored, NULL, buf, n, &used) == CAUCHY_OK);
+    assert(used == n);
+    assert(cauchy_vclock_equals(&a, &restored));
+    cauchy_vclock_fini(&restored);
+
+    /* Every truncation is rejected rather than misread */
+    for (usize cut = 0; cut < n; cut++) {
+        assert(cauchy_vclock_decode(&restored, NULL, buf, cut, NULL) == CAUCHY_ERR_INVALID);
+    }
+    buf[0] = CAUCHY_VCLOCK_WIRE_VERSION + 1;
+    assert(cauchy_vclock_decode(&restored, NULL, buf, n, NULL) == CAUCHY_ERR_INVALID);
+
+    cauchy_vclock_t empty;
+    cauchy_vclock_init(&empty, 3);
+    n = cauchy_vclock_encode(&empty, NULL, buf, sizeof(buf));
+    assert(n == 4);
+    assert(cauchy_vclock_decode(&restored, NULL, buf, n, NULL) == CAUCHY_OK);
+    assert(cauchy_vclock_is_empty(&restored));
+
+    cauchy_vclock_fini(&a);
+    cauchy_vclock_fini(&restored);
+}
+
+TEST(vclock_delta_encoding) {
+    cauchy_vclock_t base, next, restored, other;
+    cauchy_vclock_init(&base, 3);
+    for (u64 i = 0; i < 300; i++) cauchy_vclock_set(&base, i, 1000000 + i);
+    assert(cauchy_vclock_copy(&next, &base) == CAUCHY_OK);
+    cauchy_vclock_increment(&next, 17);
+    cauchy_vclock_set(&next, 42, 5);       /* Values may move down too */
+    cauchy_vclock_set(&next, 99, 0);
+    cauchy_vclock_set(&next, 5000, 1);
+
+    u8 buf[8192];
+    usize n = cauchy_vclock_encode(&next, &base, buf, sizeof(buf));
+    assert(n == cauchy_vclock_encoded_size(&next, &base));
+    assert(n < 32);
+    assert(n * 8 < cauchy_vclock_encoded_size(&next, NULL));
+
+    assert(cauchy_vclock_decode(&restored, NULL, buf, n, NULL) == CAUCHY_ERR_CAUSAL);
+    assert(cauchy_vclock_copy(&other, &base) == CAUCHY_OK);
+    cauchy_vclock_increment(&other, 0);
+    assert(cauchy_vclock_decode(&restored, &other, buf, n, NULL) == CAUCHY_ERR_CAUSAL);
+
+    assert(cauchy_vclock_decode(&restored, &base, buf, n, NULL) == CAUCHY_OK);
+    assert(cauchy_vclock_equals(&restored, &next));
+    cauchy_vclock_fini(&restored);
+
+    /* Applying in place advances the base itself */
+    assert(cauchy_vclock_decode(&base, &base, buf, n, NULL) == CAUCHY_OK);
+    assert(cauchy_vclock_equals(&base, &next));
+
+    cauchy_vclock_fini(&base);
+    cauchy_vclock_fini(&next);
+    cauchy_vclock_fini(&other);
+}
+
+/* Every kernel level must agree with the scalar reference, including
+ * tails that do not fill a whole vector and values above INT64_MAX. */
+TEST(vclock_prune_departed) {
+    cauchy_vclock_t vc, departed;
+    cauchy_vclock_init(&vc, 0);
+    cauchy_vclock_init(&departed, 0);
+    cauchy_vclock_set(&vc, 1, 4);
+    cauchy_vclock_set(&vc, 2, 7);
+    cauchy_vclock_set(&vc, 3, 9);
+    cauchy_vclock_set(&departed, 2, 7);
+    cauchy_vclock_set(&departed, 3, 8);  /* vc saw more of 3 than is stable */
+
+    assert(cauchy_vclock_prune(&vc, &departed) == 1);
+    assert(cauchy_vclock_get(&vc, 2) == 0);
+    assert(cauchy_vclock_get(&vc, 1) == 4 && cauchy_vclock_get(&vc, 3) == 9);
+    assert(cauchy_vclock_prune(&vc, &departed) == 0);
+
+    /* A dense clock that loses most of its entries goes back to pairs */
+    for (u64 i = 0; i < 200; i++) cauchy_vclock_set(&vc, i, i + 1);
+    assert(cauchy_vclock_is_dense(&vc));
+    for (u64 i = 0; i < 198; i++) cauchy_vclock_set(&departed, i, 1000);
+    assert(cauchy_vclock_prune(&vc, &departed) == 198);
+    assert(!cauchy_vclock_is_dense(&vc));
+    assert(cauchy_vclock_get(&vc, 199) == 200 && cauchy_vclock_sum(&vc) == 399);
+
+    cauchy_vclock_fini(&vc);
+    cauchy_vclock_fini(&departed);
+}
+
+TEST(simd_levels_agree) {
+    cauchy_simd_level_t levels[] = {
+        CAUCHY_SIMD_SCALAR, CAUCHY_SIMD_NEON, CAUCHY_SIMD_AVX2, CAUCHY_SIMD_AVX512
+    };
+    cauchy_simd_level_t initial = cauchy_simd_level();
+
+    for (usize n = 0; n <= CAUCHY_MAX_NODES; n++) {
+        for (int round = 0; round < 8; round++) {
+            u64 a[CAUCHY_MAX_NODES], b[CAUCHY_MAX_NODES];
+            for (usize i = 0; i < n; i++) {
+                a[i] = next_rand() >> (round & 1 ? 0 : 60);
+                b[i] = round >= 6 ? a[i] : next_rand() >> (round & 1 ? 0 : 60);
+            }
+            if (round == 7 && n > 0) b[n / 2] = a[n / 2] + 1;
+
+            u64 ref_max[CAUCHY_MAX_NODES], ref_min[CAUCHY_MAX_NODES];
+            memcpy(ref_max, a, sizeof(a));
+            memcpy(ref_min, a, sizeof(a));
+            cauchy_simd_select(CAUCHY_SIMD_SCALAR);
+            cauchy_simd_max_u64(ref_max, b, n);
+            cauchy_simd_min_u64(ref_min, b, n);
+            u32 ref_cmp = cauchy_simd_cmp_u64(a, b, n);
+            u64 ref_sum = cauchy_simd_sum_u64(a, n);
+
+            for (usize l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+                cauchy_simd_select(levels[l]);
+                u64 mx[CAUCHY_MAX_NODES], mn[CAUCHY_MAX_NODES];
+                memcpy(mx, a, sizeof(a));
+                memcpy(mn, a, sizeof(a));
+                cauchy_simd_max_u64(mx, b, n);
+                cauchy_simd_min_u64(mn, b, n);
+                assert(memcmp(mx, ref_max, n * sizeof(u64)) == 0);
+                assert(memcmp(mn, ref_min, n * sizeof(u64)) == 0);
+                assert(cauchy_simd_cmp_u64(a, b, n) == ref_cmp);
+                assert(cauchy_simd_sum_u64(a, n) == ref_sum);
+            }
+        }
+    }
+
+    cauchy_simd_select(initial);
+}
+
+/* Delivery callback: checks causal order against what it has applied */
+typedef struct causal_sink {
+    cauchy_vclock_t applied;
+    const cauchy_vclock_t* const* deps;   /* Indexed by op payload */
+    usize count;
+    int   fail_at;                        /* Payload to refuse once, or -1 */
+} causal_sink_t;
+
+static cauchy_result_t causal_apply(void* arg, const cauchy_causal_op_t* op) {
+    causal_sink_t* sink = arg;
+    u32 id;
+    assert(op->size == sizeof(id));
+    memcpy(&id, op->data, sizeof(id));
+    if ((int)id == sink->fail_at) {
+        sink->fail_at = -1;
+        return CAUCHY_ERR_NOMEM;
+    }
+    assert(op->dot.timestamp == cauchy_vclock_get(&sink->applied, op->dot.node_id) + 1);
+    cauchy_vclock_iter_t iter;
+    cauchy_node_id_t node;
+    u64 value;
+    cauchy_vclock_iter_init(&iter, sink->deps[id]);
+    while (cauchy_vclock_iter_next(&iter, &node, &value)) {
+        assert(value <= cauchy_vclock_get(&sink->applied, node));
+    }
+    cauchy_vclock_set(&sink->applied, op->dot.node_id, op->dot.timestamp);
+    sink->count++;
+    return CAUCHY_OK;
+}
+
+TEST(causal_delivery_out_of_order) {
+    enum { NODES = 4, OPS = 600 };
+
+    /* A random causal history: nodes make ops and learn each other's */
+    cauchy_causal_t nodes[NODES];
+    for (int n = 0; n < NODES; n++) {
+        assert(cauchy_causal_init(&nodes[n], NULL, causal_apply, NULL) == CAUCHY_OK);
+    }
+    cauchy_vclock_t deps[OPS];
+    const cauchy_vclock_t* dep_ptrs[OPS];
+    cauchy_uid_t dots[OPS];
+    for (u32 i = 0; i < OPS; i++) {
+        int n = (int)(next_rand() % NODES);
+        if (next_rand() % 3 == 0) {
+            int m = (int)(next_rand() % NODES);
+            assert(cauchy_causal_advance(&nodes[n], cauchy_causal_clock(&nodes[m]), NULL) ==
+                   CAUCHY_OK);
+        }
+        assert(cauchy_vclock_copy(&deps[i], cauchy_causal_clock(&nodes[n])) == CAUCHY_OK);
+        dots[i] = cauchy_causal_local(&nodes[n], (cauchy_node_id_t)n + 1);
+        dep_ptrs[i] = &deps[i];
+    }
+
+    /* Deliver a shuffled copy with every op sent twice */
+    u32 order[2 * OPS];
+    for (u32 i = 0; i < 2 * OPS; i++) order[i] = i % OPS;
+    for (u32 i = 2 * OPS - 1; i > 0; i--) {
+        u32 j = (u32)(next_rand() % (i + 1));
+        u32 t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+    causal_sink_t sink = { .deps = dep_ptrs, .fail_at = -1 };
+    cauchy_vclock_init(&sink.applied, 0);
+    cauchy_causal_t rx;
+    assert(cauchy_causal_init(&rx, NULL, causal_apply, &sink) == CAUCHY_OK);
+    usize total = 0;
+    for (u32 k = 0; k < 2 * OPS; k++) {
+        u32 id = order[k];
+        cauchy_causal_op_t op = { dots[id], &deps[id], &id, sizeof(id) };
+        usize n;
+        assert(cauchy_causal_receive(&rx, &op, &n) == CAUCHY_OK);
+        total += n;
+    }
+    cauchy_causal_stats_t st = cauchy_causal_get_stats(&rx);
+    assert(total == OPS && sink.count == OPS && st.delivered == OPS);
+    assert(st.held == 0 && st.held_bytes == 0 && st.duplicates == OPS && st.deferred > 0);
+    for (int n = 0; n < NODES; n++) {
+        assert(cauchy_vclock_get(cauchy_causal_clock(&rx), (cauchy_node_id_t)n + 1) ==
+               cauchy_vclock_get(cauchy_causal_clock(&nodes[n]), (cauchy_node_id_t)n + 1));
+    }
+    cauchy_causal_fini(&rx);
+
+    /* Limits refuse instead of growing; a failed delivery can be resent */
+    cauchy_causal_config_t cfg = { .max_ops = 2, .max_bytes = 1 << 20 };
+    cauchy_vclock_fini(&sink.applied);
+    cauchy_vclock_init(&sink.applied, 0);
+    sink.count = 0;
+    assert(cauchy_causal_init(&rx, &cfg, causal_apply, &sink) == CAUCHY_OK);
+    u32 first = OPS, held = 0;
+    for (u32 i = 0; i < OPS && held < 3; i++) {
+        if (dots[i].node_id != 1 || dots[i].timestamp == 1) continue;
+        cauchy_causal_op_t op = { dots[i], NULL, &i, sizeof(i) };
+        cauchy_result_t res = cauchy_causal_receive(&rx, &op, NULL);
+        assert(res == (held < 2 ? CAUCHY_OK : CAUCHY_ERR_FULL));
+        held++;
+    }
+    for (u32 i = 0; i < OPS && first == OPS; i++) {
+        if (dots[i].node_id == 1 && dots[i].timestamp == 1) first = i;
+    }
+    static const cauchy_vclock_t none;
+    for (u32 i = 0; i < OPS; i++) dep_ptrs[i] = &none;
+    sink.fail_at = (int)first;
+    cauchy_causal_op_t op = { dots[first], NULL, &first, sizeof(first) };
+    usize n;
+    assert(cauchy_causal_receive(&rx, &op, &n) == CAUCHY_ERR_NOMEM && n == 0);
+    assert(cauchy_causal_receive(&rx, &op, &n) == CAUCHY_OK && n == 3);
+    assert(cauchy_causal_get_stats(&rx).refused == 1 && cauchy_causal_get_stats(&rx).held == 0);
+
+    /* Advancing past held ops drops them unseen */
+    cauchy_uid_t far = cauchy_uid_create(2, 50);
+    u32 id = 0;
+    cauchy_causal_op_t late = { far, NULL, &id, sizeof(id) };
+    assert(cauchy_causal_receive(&rx, &late, NULL) == CAUCHY_OK);
+    assert(cauchy_causal_get_stats(&rx).held == 1);
+    cauchy_vclock_t jump;
+    cauchy_vclock_init(&jump, 0);
+    cauchy_vclock_set(&jump, 2, 60);
+    assert(cauchy_causal_advance(&rx, &jump, &n) == CAUCHY_OK && n == 0);
+    assert(cauchy_causal_get_stats(&rx).held == 0);
+    cauchy_vclock_fini(&jump);
+
+    cauchy_causal_fini(&rx);
+    cauchy_vclock_fini(&sink.applied);
+    for (u32 i = 0; i < OPS; i++) cauchy_vclock_fini(&deps[i]);
+    for (int k = 0; k < NODES; k++) cauchy_causal_fini(&nodes[k]);
+}
+
+int main(void) {
+    printf("Vector Clock Tests (kernels: %s):\n",
+           cauchy_simd_level_name(cauchy_simd_level()));
+
+    RUN(vclock_compare);
+    RUN(vclock_sparse_large_ids);
+    RUN(vclock_switches_to_dense);
+    RUN(vclock_compact_encoding);
+    RUN(vclock_delta_encoding);
+    RUN(vclock_prune_departed);
+    RUN(simd_levels_agree);
+    RUN(causal_delivery_out_of_order);
+
+    printf("\nAll vector clock tests passed!\n");
+    return 0;
+}